@@ -40,6 +40,10 @@ public:
   virtual CoordTransform *clone() const = 0;
   virtual std::string id() const = 0;
 
+  /// Apply the transformation to a batch of contiguous vectors
+  virtual void applyToBatch(const coord_t *inputVectors, coord_t *outVectors,
+                            size_t numVectors) const;
+
   /// Wrapper for VMD
   Mantid::Kernel::VMD applyVMD(const Mantid::Kernel::VMD &inputVector) const;
 
@@ -39,6 +39,22 @@ CoordTransform::CoordTransform(const size_t inD, const size_t outD)
         "CoordTransform: invalid number of input dimensions!");
 }
 
+//----------------------------------------------------------------------------------------------
+/** Apply the transformation to a batch of input vectors, stored one after the
+ * other. Subclasses override this to transform the whole batch without a
+ * virtual call per vector.
+ *
+ * @param inputVectors :: numVectors inD-length vectors
+ * @param outVectors :: space for numVectors outD-length vectors
+ * @param numVectors :: the number of vectors to transform
+ */
+void CoordTransform::applyToBatch(const coord_t *inputVectors,
+                                  coord_t *outVectors,
+                                  size_t numVectors) const {
+  for (size_t i = 0; i < numVectors; ++i)
+    this->apply(inputVectors + i * inD, outVectors + i * outD);
+}
+
 //----------------------------------------------------------------------------------------------
 /** Apply the transformation to an input vector (as a VMD type).
  * This wraps the apply(in,out) method (and will be slower!)
@@ -10,6 +10,7 @@
 #include "MantidAPI/Algorithm.h"
 #include "MantidAPI/ISplittersWorkspace.h"
 #include "MantidAPI/ITableWorkspace_fwd.h"
+#include "MantidDataObjects/EventSplitter.h"
 #include "MantidDataObjects/EventWorkspace.h"
 #include "MantidDataObjects/SplittersWorkspace.h"
 #include "MantidDataObjects/TableWorkspace.h"
@@ -112,6 +113,10 @@ private:
   /// Filter events by splitters in format of vector
   void filterEventsByVectorSplitters(double progressamount);
 
+  /// Split the events of all spectra between the output workspaces
+  void splitEvents(const DataObjects::EventSplitter &splitter,
+                   const bool pulseTimeOnly);
+
   /// Examine workspace
   void examineAndSortEventWS();
 
@@ -31,6 +31,7 @@
 #include "MantidKernel/TimeSeriesProperty.h"
 #include "MantidKernel/VisibleWhenProperty.h"
 
+#include <limits>
 #include <memory>
 #include <sstream>
 
@@ -1640,40 +1641,9 @@ void FilterEvents::filterEventsBySplitters(double progressamount) {
   g_log.debug() << "Number of spectra in input/source EventWorkspace = "
                 << numberOfSpectra << ".\n";
 
-  // FIXME - Turn on parallel:
-  PARALLEL_FOR_NO_WSP_CHECK()
-  for (int64_t iws = 0; iws < int64_t(numberOfSpectra); ++iws) {
-    PARALLEL_START_INTERUPT_REGION
-
-    // Filter the non-skipped
-    if (!m_vecSkip[iws]) {
-      // Get the output event lists (should be empty) to be a map
-      std::map<int, DataObjects::EventList *> outputs;
-      PARALLEL_CRITICAL(build_elist) {
-        for (auto &ws : m_outputWorkspacesMap) {
-          int index = ws.first;
-          auto &output_el = ws.second->getSpectrum(iws);
-          outputs.emplace(index, &output_el);
-        }
-      }
-      // Get a holder on input workspace's event list of this spectrum
-      const DataObjects::EventList &input_el = m_eventWS->getSpectrum(iws);
-
-      // Perform the filtering (using the splitting function and just one
-      // output)
-      if (m_filterByPulseTime) {
-        input_el.splitByPulseTime(m_splitters, outputs);
-      } else if (m_tofCorrType != NoneCorrect) {
-        input_el.splitByFullTime(m_splitters, outputs, true,
-                                 m_detTofFactors[iws], m_detTofOffsets[iws]);
-      } else {
-        input_el.splitByFullTime(m_splitters, outputs, false, 1.0, 0.0);
-      }
-    }
-
-    PARALLEL_END_INTERUPT_REGION
-  } // END FOR i = 0
-  PARALLEL_CHECK_INTERUPT_REGION
+  // Index the splitters once for all spectra
+  const EventSplitter splitter(m_splitters);
+  splitEvents(splitter, m_filterByPulseTime);
 
   // Split the sample logs in each target workspace.
   progress(0.1 + progressamount, "Splitting logs");
@@ -1713,48 +1683,32 @@ void FilterEvents::filterEventsByVectorSplitters(double progressamount) {
                     "by pulse time.");
   }
 
-  PARALLEL_FOR_NO_WSP_CHECK()
-  for (int64_t iws = 0; iws < int64_t(numberOfSpectra); ++iws) {
-    PARALLEL_START_INTERUPT_REGION
-
-    // Filter the non-skipped spectrum
-    if (!m_vecSkip[iws]) {
-      // Get the output event lists (should be empty) to be a map
-      map<int, DataObjects::EventList *> outputs;
-      PARALLEL_CRITICAL(build_elist) {
-        for (auto &ws : m_outputWorkspacesMap) {
-          int index = ws.first;
-          auto &output_el = ws.second->getSpectrum(iws);
-          outputs.emplace(index, &output_el);
-        }
-      }
-
-      // Get a holder on input workspace's event list of this spectrum
-      const DataObjects::EventList &input_el = m_eventWS->getSpectrum(iws);
-
-      bool printdetail = false;
-      if (m_useDBSpectrum)
-        printdetail = (iws == static_cast<int64_t>(m_dbWSIndex));
-
-      // Perform the filtering (using the splitting function and just one
-      // output)
-      std::string logmessage;
-      if (m_tofCorrType != NoneCorrect) {
-        logmessage = input_el.splitByFullTimeMatrixSplitter(
-            m_vecSplitterTime, m_vecSplitterGroup, outputs, true,
-            m_detTofFactors[iws], m_detTofOffsets[iws]);
-      } else {
-        logmessage = input_el.splitByFullTimeMatrixSplitter(
-            m_vecSplitterTime, m_vecSplitterGroup, outputs, false, 1.0, 0.0);
-      }
-
-      if (printdetail)
-        g_log.notice(logmessage);
-    }
-
-    PARALLEL_END_INTERUPT_REGION
-  } // END FOR i = 0
-  PARALLEL_CHECK_INTERUPT_REGION
+  // Index the splitters once for all spectra. Splitter i covers
+  // [time[i], time[i+1]). The events before the first and from the last time
+  // on are not inside any splitter: like those in the gaps between splitters
+  // they go to the unfiltered workspace, if there is one.
+  const auto unfiltered = static_cast<int>(UNDEFINED_SPLITTING_TARGET);
+  std::vector<int64_t> times{std::numeric_limits<int64_t>::lowest()};
+  std::vector<int> targets{unfiltered};
+  if (!m_vecSplitterGroup.empty()) {
+    times.insert(times.end(), m_vecSplitterTime.cbegin(),
+                 m_vecSplitterTime.cend());
+    targets.insert(targets.end(), m_vecSplitterGroup.cbegin(),
+                   m_vecSplitterGroup.cend());
+    targets.push_back(unfiltered);
+  }
+  times.push_back(std::numeric_limits<int64_t>::max());
+  const EventSplitter splitter(std::move(times), targets);
+  splitEvents(splitter, false);
+
+  if (m_useDBSpectrum) {
+    g_log.notice() << "Spectrum " << m_dbWSIndex << " is split into:";
+    for (const auto &ws : m_outputWorkspacesMap)
+      g_log.notice() << " " << ws.first << ": "
+                     << ws.second->getSpectrum(m_dbWSIndex).getNumberEvents()
+                     << " events;";
+    g_log.notice() << "\n";
+  }
 
   // Finish (1) adding events and splitting the sample logs in each target
   // workspace.
@@ -1777,6 +1731,58 @@ void FilterEvents::filterEventsByVectorSplitters(double progressamount) {
   return;
 }
 
+//----------------------------------------------------------------------------------------------
+/** Split the events of every spectrum that is not skipped between the output
+ * workspaces. The output event lists of each spectrum are looked up by the
+ * slot of their target, so no map is built per spectrum and no lock is
+ * needed: each thread only touches its own spectra.
+ * @param splitter :: the indexed splitting intervals
+ * @param pulseTimeOnly :: compare the pulse times rather than the full times
+ * of the events with the intervals
+ */
+void FilterEvents::splitEvents(const EventSplitter &splitter,
+                               const bool pulseTimeOnly) {
+  // Output workspace of each target slot
+  const auto &targets = splitter.targets();
+  std::vector<EventWorkspace *> outputWorkspaces(targets.size(), nullptr);
+  for (size_t slot = 0; slot < targets.size(); ++slot) {
+    const auto found = m_outputWorkspacesMap.find(targets[slot]);
+    if (found != m_outputWorkspacesMap.end())
+      outputWorkspaces[slot] = found->second.get();
+    else
+      g_log.debug() << "Events of target " << targets[slot]
+                    << " have no output workspace and are discarded.\n";
+  }
+
+  const size_t numberOfSpectra = m_eventWS->getNumberHistograms();
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t iws = 0; iws < int64_t(numberOfSpectra); ++iws) {
+    PARALLEL_START_INTERUPT_REGION
+
+    // Filter the non-skipped spectrum
+    if (!m_vecSkip[iws]) {
+      std::vector<EventList *> outputs(outputWorkspaces.size(), nullptr);
+      for (size_t slot = 0; slot < outputWorkspaces.size(); ++slot)
+        if (outputWorkspaces[slot])
+          outputs[slot] = &outputWorkspaces[slot]->getSpectrum(iws);
+
+      EventSplitter::EventTime eventTime;
+      eventTime.pulseTimeOnly = pulseTimeOnly;
+      if (m_tofCorrType != NoneCorrect) {
+        eventTime.correctTof = true;
+        eventTime.tofFactor = m_detTofFactors[iws];
+        eventTime.tofShift = m_detTofOffsets[iws];
+      }
+
+      const DataObjects::EventList &input_el = m_eventWS->getSpectrum(iws);
+      input_el.splitByIndex(splitter, outputs, eventTime);
+    }
+
+    PARALLEL_END_INTERUPT_REGION
+  } // END FOR i = 0
+  PARALLEL_CHECK_INTERUPT_REGION
+}
+
 //----------------------------------------------------------------------------------------------
 /** Generate a vector of integer time series property for each splitter
  * corresponding to each target (in integer)
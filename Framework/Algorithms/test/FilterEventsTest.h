@@ -816,6 +816,69 @@ public:
     return;
   }
 
+  //----------------------------------------------------------------------------------------------
+  /** Filter events with splitters in a MatrixWorkspace, checking where the
+   * events on the splitter boundaries and outside all splitters go.
+   * Events at 0, 1, ..., 9 times tofdt after the run start, splitters:
+   * 0: 1.5 ~ 4, -1: 4 ~ 6.5, 1: 6.5 ~ 8
+   */
+  void test_FilterMatrixSplitterBoundaries() {
+    const int64_t runstart_i64 = 20000000000;
+    const int64_t pulsedt = 100 * 1000 * 1000;
+    const int64_t tofdt = 10 * 1000 * 1000;
+    EventWorkspace_sptr inpWS =
+        createEventWorkspace(runstart_i64, pulsedt, tofdt, 1);
+    AnalysisDataService::Instance().addOrReplace("Test11", inpWS);
+
+    MatrixWorkspace_sptr splws =
+        WorkspaceFactory::Instance().create("Workspace2D", 1, 4, 3);
+    const std::vector<double> times{1.5, 4., 6.5, 8.};
+    for (size_t i = 0; i < times.size(); ++i)
+      splws->mutableX(0)[i] = times[i] * static_cast<double>(tofdt) * 1.E-9;
+    splws->mutableY(0)[0] = 0.;
+    splws->mutableY(0)[1] = -1.;
+    splws->mutableY(0)[2] = 1.;
+    AnalysisDataService::Instance().addOrReplace("Splitter11", splws);
+
+    FilterEvents filter;
+    filter.initialize();
+    filter.setProperty("InputWorkspace", "Test11");
+    filter.setProperty("OutputWorkspaceBaseName", "FilteredWS11");
+    filter.setProperty("SplitterWorkspace", "Splitter11");
+    filter.setProperty("RelativeTime", true);
+    filter.setProperty("OutputWorkspaceIndexedFrom1", false);
+    TS_ASSERT_THROWS_NOTHING(filter.execute());
+    TS_ASSERT(filter.isExecuted());
+
+    // A splitter starts at its first time and stops before its last one
+    auto filteredws0 =
+        AnalysisDataService::Instance().retrieveWS<EventWorkspace>(
+            "FilteredWS11_0");
+    TS_ASSERT_EQUALS(filteredws0->getSpectrum(0).getNumberEvents(), 2);
+    auto filteredws1 =
+        AnalysisDataService::Instance().retrieveWS<EventWorkspace>(
+            "FilteredWS11_1");
+    TS_ASSERT_EQUALS(filteredws1->getSpectrum(0).getNumberEvents(), 1);
+    // The events before the first splitter, in the gap and from the end of
+    // the last splitter are not filtered
+    auto unfilteredws =
+        AnalysisDataService::Instance().retrieveWS<EventWorkspace>(
+            "FilteredWS11_unfiltered");
+    TS_ASSERT_EQUALS(unfilteredws->getSpectrum(0).getNumberEvents(), 7);
+    TS_ASSERT_EQUALS(filteredws0->getNumberEvents() +
+                         filteredws1->getNumberEvents() +
+                         unfilteredws->getNumberEvents(),
+                     inpWS->getNumberEvents());
+
+    // clean up all the workspaces generated
+    AnalysisDataService::Instance().remove("Test11");
+    AnalysisDataService::Instance().remove("Splitter11");
+    std::vector<std::string> outputwsnames =
+        filter.getProperty("OutputWorkspaceNames");
+    for (const auto &outputwsname : outputwsnames)
+      AnalysisDataService::Instance().remove(outputwsname);
+  }
+
   //----------------------------------------------------------------------------------------------
   /**  Filter events without any correction and test for splitters in
    *    TableWorkspace filter format
@@ -29,6 +29,10 @@ public:
   /// Constructor with vector of DateAndTime
   BankPulseTimes(const std::vector<Mantid::Types::Core::DateAndTime> &times);
 
+  /// Constructor with the offset and absolute times of event_time_zero
+  BankPulseTimes(const std::string &start, const std::vector<int64_t> &times,
+                 const std::vector<int> &pNumbers);
+
   /// Destructor
   ~BankPulseTimes();
 
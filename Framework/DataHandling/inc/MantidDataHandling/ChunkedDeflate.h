@@ -0,0 +1,61 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAHANDLING_CHUNKEDDEFLATE_H_
+#define MANTID_DATAHANDLING_CHUNKEDDEFLATE_H_
+
+#include "MantidDataHandling/DllConfig.h"
+
+#include <cstddef>
+#include <string>
+
+// forward declarations
+namespace H5 {
+class DataSet;
+class Group;
+} // namespace H5
+
+namespace Mantid {
+namespace DataHandling {
+/** ChunkedDeflate : Reads and writes large 1D arrays as chunked HDF5 datasets
+  compressed with the standard deflate filter, doing the compression on all
+  the cores instead of in the HDF5 filter pipeline.
+
+  The array is cut into chunks that are compressed with zlib by OpenMP threads
+  and stored as they are by a single thread, while the next chunks are being
+  compressed. Reading does the reverse: one thread reads the stored chunks and
+  the others inflate them. The files are ordinary HDF5 files that any reader
+  can open.
+
+  Writing and reading chunks directly needs HDF5 1.10.3 or later. isAvailable()
+  is false with older versions, in which case the callers keep using the
+  NeXus API.
+*/
+namespace ChunkedDeflate {
+
+/// Size of the uncompressed chunks, in bytes
+constexpr size_t CHUNK_BYTES = 1024 * 1024;
+
+/// Deflate level used by default. Level 1 is the fastest.
+constexpr int DEFAULT_LEVEL = 1;
+
+MANTID_DATAHANDLING_DLL bool isAvailable();
+
+template <typename NumT>
+void writeArray1D(H5::Group &group, const std::string &name,
+                  const NumT *values, const size_t length,
+                  const int deflateLevel = DEFAULT_LEVEL);
+
+MANTID_DATAHANDLING_DLL bool isChunkedDeflate(H5::DataSet &dataset);
+
+template <typename NumT>
+void readArray1D(H5::DataSet &dataset, NumT *values, const size_t length);
+
+} // namespace ChunkedDeflate
+} // namespace DataHandling
+} // namespace Mantid
+
+#endif /* MANTID_DATAHANDLING_CHUNKEDDEFLATE_H_ */
@@ -11,10 +11,20 @@
 #include "MantidDataHandling/DllConfig.h"
 #include "MantidDataHandling/EventWorkspaceCollection.h"
 
+namespace Mantid {
+namespace API {
+class Progress;
+}
+namespace Kernel {
+class ThreadScheduler;
+}
+} // namespace Mantid
+
 class BankPulseTimes;
 
 namespace Mantid {
 namespace DataHandling {
+class EventBufferPool;
 class LoadEventNexus;
 
 /** Helper class for LoadEventNexus that is specific to the current default
@@ -39,6 +49,10 @@ public:
   /// whether or not to launch multiple ProcessBankData jobs per bank
   bool splitProcessing;
 
+  /// Number of events of the ranges of pulses that banks with at least twice
+  /// as many events are split into. Zero if banks are never split.
+  size_t eventsPerTask{0};
+
   /// Do we pre-count the # of events in each pixel ID?
   bool precount;
 
@@ -77,6 +91,10 @@ public:
   /// One entry of pulse times for each preprocessor
   std::vector<boost::shared_ptr<BankPulseTimes>> m_bankPulseTimes;
 
+  /// Time spent processing the banks, summed over all threads, in seconds.
+  /// Guarded by LoadEventNexus::m_tofMutex.
+  double m_processTime{0.};
+
 private:
   DefaultEventLoader(LoadEventNexus *alg, EventWorkspaceCollection &ws,
                      bool haveWeights, bool event_id_is_spec,
@@ -85,6 +103,18 @@ private:
   std::pair<size_t, size_t>
   setupChunking(std::vector<std::string> &bankNames,
                 std::vector<std::size_t> &bankNumEvents);
+  void skipUnselectedBanks(const std::vector<std::string> &bankNames,
+                           std::vector<std::size_t> &bankNumEvents,
+                           const std::pair<size_t, size_t> &bankRange);
+  void setupTaskSize(const std::vector<std::size_t> &bankNumEvents,
+                     const std::pair<size_t, size_t> &bankRange);
+  size_t readBanks(const std::vector<std::string> &bankNames,
+                   const std::vector<std::size_t> &bankNumEvents,
+                   const std::pair<size_t, size_t> &bankRange,
+                   const std::vector<int> &periodLog,
+                   const std::string &classType, const bool oldNeXusFileNames,
+                   EventBufferPool &buffers, API::Progress *prog,
+                   Kernel::ThreadScheduler &scheduler, double &readTime);
   /// Map detector IDs to event lists.
   template <class T>
   void makeMapToEventLists(std::vector<std::vector<T>> &vectors);
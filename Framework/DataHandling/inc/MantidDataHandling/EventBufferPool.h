@@ -0,0 +1,76 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAHANDLING_EVENTBUFFERPOOL_H_
+#define MANTID_DATAHANDLING_EVENTBUFFERPOOL_H_
+
+#include "MantidDataHandling/DllConfig.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Mantid {
+namespace DataHandling {
+
+/// The raw event fields of a bank read from an event NeXus file
+struct EventBuffers {
+  /// Pixel ID of each event
+  std::vector<uint32_t> eventId;
+  /// Time-of-flight of each event, in microseconds
+  std::vector<float> timeOfFlight;
+  /// Weight of each event, if the file has weights
+  std::vector<float> weight;
+};
+
+/** EventBufferPool : A bounded pool of reusable EventBuffers.
+
+  The pool bounds the number of banks read ahead of their processing: at most
+  capacity() buffers are handed out at any time and acquire() blocks until one
+  is returned. A buffer is returned to the pool, with its memory kept for the
+  next bank, when the last copy of the pointer given by acquire() is released,
+  which may happen in any thread and after the pool itself is destroyed.
+*/
+class MANTID_DATAHANDLING_DLL EventBufferPool {
+public:
+  explicit EventBufferPool(const size_t capacity);
+
+  boost::shared_ptr<EventBuffers> acquire();
+  boost::shared_ptr<EventBuffers> tryAcquire();
+
+  /// @return the maximum number of buffers in use at the same time
+  size_t capacity() const { return m_state->capacity; }
+  size_t available() const;
+  double waitTime() const;
+
+private:
+  /// State shared with the buffers handed out
+  struct State {
+    size_t capacity{0};
+    /// Number of buffers handed out
+    size_t inUse{0};
+    /// Buffers returned to the pool
+    std::vector<std::unique_ptr<EventBuffers>> free;
+    /// Total time spent waiting in acquire(), in seconds
+    double waitTime{0.};
+    mutable std::mutex mutex;
+    std::condition_variable returned;
+  };
+
+  static boost::shared_ptr<EventBuffers>
+  handOut(const boost::shared_ptr<State> &state);
+
+  boost::shared_ptr<State> m_state;
+};
+
+} // namespace DataHandling
+} // namespace Mantid
+
+#endif /* MANTID_DATAHANDLING_EVENTBUFFERPOOL_H_ */
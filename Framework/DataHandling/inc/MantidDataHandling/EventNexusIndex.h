@@ -0,0 +1,137 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAHANDLING_EVENTNEXUSINDEX_H_
+#define MANTID_DATAHANDLING_EVENTNEXUSINDEX_H_
+
+#include "MantidDataHandling/DllConfig.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Mantid {
+namespace DataHandling {
+
+/** EventNexusIndex : What the loaders of an event NeXus file find out about it
+  before reading the events, kept in a sidecar file so that repeated loads of
+  the same file skip the discovery.
+
+  For each NXevent_data bank of one NXentry it holds the number of events,
+  whether the events are weighted, the event_index field, the pulse times and,
+  once a load has read every event of the bank, the range of its event IDs.
+  Banks sharing the same event_time_zero share one pulse table. It also holds
+  a summary of what LoadNexusLogs derives from the whole set of logs.
+
+  The sidecar is only used while the size and modification time of the event
+  file are the ones it was built from. Where it is kept is given by the
+  EventNexusIndex.Location key of the configuration: empty or "Off" disables
+  the index, "NextToFile" puts it next to the event file and anything else is
+  a directory holding the indexes of all files.
+*/
+class MANTID_DATAHANDLING_DLL EventNexusIndex {
+public:
+  /// Value of Bank::pulseTable for a bank without event_time_zero
+  static constexpr int64_t NO_PULSE_TABLE = -1;
+
+  /// The pulse times of one or more banks
+  struct PulseTable {
+    /// The "offset" attribute of event_time_zero
+    std::string offset;
+    /// The absolute pulse times, in nanoseconds since the DateAndTime epoch
+    std::vector<int64_t> times;
+  };
+
+  /// What is known about one NXevent_data bank
+  struct Bank {
+    std::string name;
+    uint64_t numEvents{0};
+    bool hasWeights{false};
+    /// Index of the first event of each pulse
+    std::vector<uint64_t> eventIndex;
+    /// Index of the pulse times in pulseTables(), or NO_PULSE_TABLE
+    int64_t pulseTable{NO_PULSE_TABLE};
+    /// True once minId and maxId have been found by reading all the events
+    bool hasIdRange{false};
+    uint32_t minId{0};
+    uint32_t maxId{0};
+  };
+
+  /// What LoadNexusLogs derives from the whole set of logs
+  struct LogSummary {
+    /// True once the summary has been filled
+    bool known{false};
+    /// The NXentry the logs were read from
+    std::string entryName;
+    /// Start of DASlogs/frequency/time, empty if there is none
+    std::string frequencyStart;
+    /// True if protonCharge holds the charge of the whole run
+    bool hasProtonCharge{false};
+    double protonCharge{0.};
+  };
+
+  explicit EventNexusIndex(const std::string &filename);
+
+  static std::string location(const std::string &filename);
+  static std::unique_ptr<EventNexusIndex> open(const std::string &filename);
+  static std::unique_ptr<EventNexusIndex> load(const std::string &indexPath,
+                                               const std::string &filename);
+  bool save() const;
+  void saveAs(const std::string &indexPath) const;
+
+  /// @return the name of the NXentry the banks belong to
+  const std::string &entryName() const { return m_entryName; }
+  bool hasBanks(const std::string &entryName) const;
+  /// @return all the banks, in the order of the file
+  const std::vector<Bank> &banks() const { return m_banks; }
+  const Bank *bank(const std::string &name) const;
+  /// @return the pulse times shared by the banks
+  const std::vector<PulseTable> &pulseTables() const { return m_pulseTables; }
+  /// @return true if the banks use the field names of the files written
+  /// before November 2010
+  bool oldFieldNames() const { return m_oldFieldNames; }
+  void setBanks(const std::string &entryName, std::vector<Bank> banks,
+                std::vector<PulseTable> pulseTables, const bool oldFieldNames);
+  void setIdRange(const std::string &bankName, const uint32_t minId,
+                  const uint32_t maxId);
+
+  /// @return the summary of the logs
+  const LogSummary &logs() const { return m_logs; }
+  void setLogs(const LogSummary &logs);
+
+  /// @return true if the index changed since it was built or loaded
+  bool isModified() const { return m_modified; }
+
+private:
+  void write(std::ostream &stream) const;
+  bool read(std::istream &stream);
+
+  /// The event file
+  std::string m_filename;
+  /// Size of the event file, in bytes
+  uint64_t m_fileSize{0};
+  /// Modification time of the event file, in microseconds since 1970
+  int64_t m_fileTime{0};
+  std::string m_entryName;
+  bool m_oldFieldNames{false};
+  std::vector<Bank> m_banks;
+  /// Position of each bank in m_banks
+  std::unordered_map<std::string, size_t> m_bankPositions;
+  std::vector<PulseTable> m_pulseTables;
+  LogSummary m_logs;
+  bool m_modified{false};
+  /// Guards the ID ranges, which are set by the threads loading the banks
+  mutable std::mutex m_mutex;
+};
+
+} // namespace DataHandling
+} // namespace Mantid
+
+#endif /* MANTID_DATAHANDLING_EVENTNEXUSINDEX_H_ */
@@ -39,6 +39,10 @@ H5::DataSpace getDataSpace(const std::vector<NumT> &data);
 /// Convert a primitive type to the appropriate H5::DataType.
 template <typename NumT> H5::DataType getType();
 
+/// Open a file which may also be open through the NeXus API
+MANTID_DATAHANDLING_DLL H5::H5File openFile(const std::string &filename,
+                                            const unsigned int flags);
+
 MANTID_DATAHANDLING_DLL H5::Group createGroupNXS(H5::H5File &file,
                                                  const std::string &name,
                                                  const std::string &nxtype);
@@ -106,6 +106,10 @@ private:
   size_t m_lineNo;
   std::vector<DataObjects::Histogram1D> m_spectra;
   std::unique_ptr<DataObjects::Histogram1D> m_curSpectra;
+  /// The values of the current spectrum read so far
+  std::vector<double> m_curX;
+  std::vector<double> m_curY;
+  std::vector<double> m_curE;
   std::vector<double> m_curDx;
 };
 
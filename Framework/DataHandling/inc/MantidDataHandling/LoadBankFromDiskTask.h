@@ -9,6 +9,8 @@
 
 #include "MantidAPI/Progress.h"
 #include "MantidDataHandling/DllConfig.h"
+#include "MantidDataHandling/EventBufferPool.h"
+#include "MantidDataHandling/EventNexusIndex.h"
 #include "MantidKernel/Task.h"
 #include "MantidKernel/ThreadScheduler.h"
 
@@ -21,7 +23,9 @@ namespace DataHandling {
 class DefaultEventLoader;
 
 /** This task does the disk IO from loading the NXS file, and so will be on a
-  disk IO mutex
+  disk IO mutex. The reading and the scheduling of the ProcessBankData tasks
+  can also be called separately, with a file that is already open, by a
+  dedicated I/O stage that reads the banks one after the other.
 */
 class MANTID_DATAHANDLING_DLL LoadBankFromDiskTask : public Kernel::Task {
 
@@ -37,16 +41,21 @@ public:
 
   void run() override;
 
+  bool readBank(::NeXus::File &file, boost::shared_ptr<EventBuffers> buffers);
+  void scheduleProcessing();
+
 private:
+  const EventNexusIndex::Bank *indexedBank() const;
   void loadPulseTimes(::NeXus::File &file);
   std::vector<uint64_t> loadEventIndex(::NeXus::File &file);
   void prepareEventId(::NeXus::File &file, int64_t &start_event,
                       int64_t &stop_event,
                       const std::vector<uint64_t> &event_index);
-  std::unique_ptr<uint32_t[]> loadEventId(::NeXus::File &file);
-  std::unique_ptr<float[]> loadTof(::NeXus::File &file);
-  std::unique_ptr<float[]> loadEventWeights(::NeXus::File &file);
+  void loadEventId(::NeXus::File &file);
+  void loadTof(::NeXus::File &file);
+  void loadEventWeights(::NeXus::File &file);
   int64_t recalculateDataSize(const int64_t &size);
+  bool isTimeFiltered() const;
 
   /// Algorithm being run
   DefaultEventLoader &m_loader;
@@ -76,6 +85,12 @@ private:
   bool m_have_weight;
   /// Frame period numbers
   const std::vector<int> m_framePeriodNumbers;
+  /// Buffers the events of the bank are read into
+  boost::shared_ptr<EventBuffers> m_buffers;
+  /// The event_index field of the bank
+  std::vector<uint64_t> m_eventIndex;
+  /// Number of pulses read by now, when resuming
+  size_t m_resumePulse{0};
 }; // END-DEF-CLASS LoadBankFromDiskTask
 
 } // namespace DataHandling
@@ -10,6 +10,7 @@
 #include "MantidAPI/IFileLoader.h"
 #include "MantidAPI/WorkspaceGroup.h"
 #include "MantidDataHandling/BankPulseTimes.h"
+#include "MantidDataHandling/EventNexusIndex.h"
 #include "MantidDataHandling/EventWorkspaceCollection.h"
 #include "MantidDataHandling/LoadGeometry.h"
 #include "MantidDataObjects/EventWorkspace.h"
@@ -32,6 +33,7 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/scoped_array.hpp>
 #include <functional>
+#include <map>
 #include <random>
 #include <memory>
 #include <mutex>
@@ -151,13 +153,28 @@ public:
   /// A count of events discarded because they came from a pixel that's not in
   /// the IDF
   size_t discarded_events;
+  /// Number of events read from the file, before any filtering
+  size_t events_read;
 
   /// Tolerance for CompressEvents; use -1 to mean don't compress.
   double compressTolerance;
 
+  /// Keep the time-of-flight of the events in single precision
+  bool singlePrecisionTof;
+
+  /// Only read the pulses written since the previous load of the file
+  bool m_resume;
+  /// Resuming, read the last pulse of each bank too
+  bool m_fileComplete;
+  /// Number of pulses of each bank read by now, when resuming
+  std::map<std::string, size_t> m_loadedPulses;
+
   /// Pulse times for ALL banks, taken from proton_charge log.
   boost::shared_ptr<BankPulseTimes> m_allBanksPulseTimes;
 
+  /// Index of the file kept from previous loads, null if it is disabled
+  boost::shared_ptr<EventNexusIndex> m_index;
+
   /// name of top level NXentry to use
   std::string m_top_entry_name;
   std::unique_ptr<::NeXus::File> m_file;
@@ -184,6 +201,9 @@ private:
   DataObjects::EventWorkspace_sptr createEmptyEventWorkspace();
 
   void loadEvents(API::Progress *const prog, const bool monitors);
+  DataObjects::EventWorkspace_sptr workspaceToResume();
+  void appendEvents(DataObjects::EventWorkspace &previous);
+  void useSinglePrecisionTof();
   void createSpectraMapping(
       const std::string &nxsfile, const bool monitorsOnly,
       const std::vector<std::string> &bankNames = std::vector<std::string>());
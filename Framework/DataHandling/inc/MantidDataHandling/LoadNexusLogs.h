@@ -60,6 +60,8 @@ private:
   void init() override;
   /// Overwrites Algorithm method
   void exec() override;
+  /// Read the start of DASlogs/frequency
+  void readFrequencyStart(::NeXus::File &file);
   /// Load log data from a group
   void loadLogs(::NeXus::File &file, const std::string &entry_name,
                 const std::string &entry_class,
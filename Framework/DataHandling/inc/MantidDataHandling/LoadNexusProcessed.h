@@ -131,6 +131,9 @@ private:
                     const double &progressRange,
                     const Mantid::NeXus::NXEntry &mtd_entry, const int xlength,
                     std::string &workspaceType);
+  API::MatrixWorkspace_sptr
+  createLazyWorkspace(Mantid::NeXus::NXData &wksp_cls, const int xlength,
+                      const int nchannels);
 
   /// Read the data from the sample group
   void readSampleGroup(Mantid::NeXus::NXEntry &mtd_entry,
@@ -216,7 +219,7 @@ private:
   /// The value of the spectrum_list property
   std::vector<int> m_spec_list;
   /// list of spectra filtered by min/max/list, currently
-  /// used only when loading data into event_workspace
+  /// used only when loading data into event_workspace or lazily
   std::vector<int> m_filtered_spec_idxs;
 
   // C++ interface to the NXS file
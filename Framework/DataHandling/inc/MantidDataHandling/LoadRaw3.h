@@ -65,24 +65,28 @@ private:
                               const int64_t normalwsSpecs,
                               const int64_t monitorwsSpecs);
 
-  /// creates output workspace, monitors excluded from this workspace
-  void excludeMonitors(FILE *file, const int &period,
-                       const std::vector<specnum_t> &monitorList,
-                       DataObjects::Workspace2D_sptr ws_sptr);
-
-  /// creates output workspace whcih includes monitors
-  void includeMonitors(FILE *file, const int64_t &period,
-                       DataObjects::Workspace2D_sptr ws_sptr);
-
-  /// creates two output workspaces none normal workspace and separate one for
-  /// monitors
-  void separateMonitors(FILE *file, const int64_t &period,
-                        const std::vector<specnum_t> &monitorList,
-                        DataObjects::Workspace2D_sptr ws_sptr,
-                        DataObjects::Workspace2D_sptr mws_sptr);
-
-  /// skip all spectra in a period
-  void skipPeriod(FILE *file, const int64_t &period);
+  /// Where the counts of a spectrum of the file go
+  struct SpectrumTarget {
+    /// Index of the spectrum in the file, counting all the periods
+    int hist;
+    /// Spectrum number
+    specnum_t specNo;
+    /// Workspace filled with the counts
+    DataObjects::Workspace2D_sptr ws;
+    /// Workspace index of the spectrum
+    int64_t wsIndex;
+  };
+
+  /// adds the spectra of a period to read to the list of targets
+  void addTargets(const int period, const std::vector<specnum_t> &monitorList,
+                  const bool separateMonitors,
+                  DataObjects::Workspace2D_sptr ws_sptr,
+                  DataObjects::Workspace2D_sptr mws_sptr,
+                  std::vector<SpectrumTarget> &targets);
+
+  /// reads the spectra of the targets and sets their data
+  void readSpectra(FILE *file, const std::vector<SpectrumTarget> &targets);
+
   /// return true if loading a selection of periods
   bool isSelectedPeriods() const { return !m_periodList.empty(); }
   /// check if a period should be loaded
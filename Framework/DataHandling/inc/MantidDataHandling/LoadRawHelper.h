@@ -162,6 +162,13 @@ protected:
           &timeChannelsVec,
       int64_t wsIndex, specnum_t nspecNum, int64_t noTimeRegimes,
       int64_t lengthIn, int64_t binStart);
+  /// This method sets counts read from the raw file to workspace vectors
+  void setWorkspaceData(
+      DataObjects::Workspace2D_sptr newWorkspace,
+      const std::vector<boost::shared_ptr<HistogramData::HistogramX>>
+          &timeChannelsVec,
+      int64_t wsIndex, specnum_t nspecNum, int64_t noTimeRegimes,
+      int64_t lengthIn, int64_t binStart, const uint32_t *counts);
 
   /// get proton charge from raw file
   float getProtonCharge() const;
@@ -0,0 +1,68 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAHANDLING_NEXUSHISTOGRAMSOURCE_H_
+#define MANTID_DATAHANDLING_NEXUSHISTOGRAMSOURCE_H_
+
+#include "MantidDataHandling/DllConfig.h"
+#include "MantidDataObjects/HistogramSource.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// forward declarations
+namespace H5 {
+class DataSet;
+class H5File;
+} // namespace H5
+
+namespace Mantid {
+namespace DataHandling {
+
+/** NexusHistogramSource : Reads single histograms of the workspace group of a
+  processed NeXus file, as written by SaveNexusProcessed, for a
+  LazyWorkspace2D.
+
+  The file is kept open, read-only, for as long as the source exists. Each
+  histogram is read with a hyperslab of one row of the "values", "errors",
+  "axis1" and "xerrors" datasets. Bin edges common to all the histograms are
+  read once and shared.
+*/
+class MANTID_DATAHANDLING_DLL NexusHistogramSource
+    : public DataObjects::HistogramSource {
+public:
+  NexusHistogramSource(const std::string &filename,
+                       const std::string &groupPath, std::vector<size_t> rows);
+  ~NexusHistogramSource() override;
+
+  size_t size() const override { return m_rows.size(); }
+  size_t blocksize() const override { return m_blocksize; }
+  size_t xLength() const override { return m_xLength; }
+  HistogramData::Histogram::YMode yMode() const override { return m_yMode; }
+
+  HistogramData::Histogram histogram(const size_t index) override;
+
+private:
+  std::unique_ptr<H5::H5File> m_file;
+  std::unique_ptr<H5::DataSet> m_values;
+  std::unique_ptr<H5::DataSet> m_errors;
+  std::unique_ptr<H5::DataSet> m_x;
+  std::unique_ptr<H5::DataSet> m_dx;
+  /// Row in the file of each histogram
+  std::vector<size_t> m_rows;
+  size_t m_blocksize;
+  size_t m_xLength;
+  HistogramData::Histogram::XMode m_xMode;
+  HistogramData::Histogram::YMode m_yMode;
+  /// X values of all the histograms if the file has a single axis1 row
+  Kernel::cow_ptr<HistogramData::HistogramX> m_sharedX{nullptr};
+};
+
+} // namespace DataHandling
+} // namespace Mantid
+
+#endif /* MANTID_DATAHANDLING_NEXUSHISTOGRAMSOURCE_H_ */
@@ -0,0 +1,81 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAHANDLING_PARTIALBANKEVENTS_H_
+#define MANTID_DATAHANDLING_PARTIALBANKEVENTS_H_
+
+#include "MantidDataHandling/DllConfig.h"
+#include "MantidDataObjects/Events.h"
+#include "MantidGeometry/IDTypes.h"
+
+#include <boost/enable_shared_from_this.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace Mantid {
+namespace Kernel {
+class ThreadScheduler;
+}
+namespace DataHandling {
+class DefaultEventLoader;
+
+/** PartialBankEvents : The events of a bank with too many events for a
+  single ProcessBankData task. The events are split into ranges of pulses,
+  each one processed by its own task into separate event lists. Once the
+  last range is done, the partial lists are appended to the event lists of
+  the workspace in pulse order, by tasks that each merge a range of pixels.
+  The result is the same as processing the bank in a single task.
+*/
+class MANTID_DATAHANDLING_DLL PartialBankEvents
+    : public boost::enable_shared_from_this<PartialBankEvents> {
+public:
+  PartialBankEvents(DefaultEventLoader &loader, std::string bankName,
+                    const size_t numParts, const detid_t minId,
+                    const detid_t maxId, const bool weighted,
+                    Kernel::ThreadScheduler &scheduler);
+
+  /// @return the number of ranges of pulses the bank is split into
+  size_t numParts() const { return m_numParts; }
+
+  std::vector<Types::Event::TofEvent> *
+  eventVector(const size_t part, const int periodIndex, const detid_t id);
+  std::vector<DataObjects::WeightedEvent> *
+  weightedEventVector(const size_t part, const int periodIndex,
+                      const detid_t id);
+
+  void partDone();
+  void merge(const detid_t first, const detid_t last);
+
+private:
+  size_t index(const size_t part, const int periodIndex,
+               const detid_t id) const;
+  template <class T>
+  size_t
+  mergeVectors(std::vector<std::vector<T>> &parts,
+               const std::vector<std::vector<std::vector<T> *>> &targets,
+               const detid_t id);
+
+  DefaultEventLoader &m_loader;
+  std::string m_bankName;
+  size_t m_numParts;
+  size_t m_numPeriods;
+  detid_t m_minId;
+  detid_t m_maxId;
+  bool m_weighted;
+  Kernel::ThreadScheduler &m_scheduler;
+  /// Partial event lists by part, period and pixel
+  std::vector<std::vector<Types::Event::TofEvent>> m_events;
+  std::vector<std::vector<DataObjects::WeightedEvent>> m_weightedEvents;
+  /// Number of parts still being processed
+  std::atomic<size_t> m_partsLeft;
+};
+
+} // namespace DataHandling
+} // namespace Mantid
+
+#endif /* MANTID_DATAHANDLING_PARTIALBANKEVENTS_H_ */
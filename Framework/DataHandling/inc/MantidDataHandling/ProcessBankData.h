@@ -20,6 +20,7 @@ class Progress;
 }
 namespace DataHandling {
 class DefaultEventLoader;
+class PartialBankEvents;
 
 /** This task does the disk IO from loading the NXS file,
  * and so will be on a disk IO mutex */
@@ -41,6 +42,10 @@ public:
   * @param event_weight :: array with weights for events
   * @param min_event_id ;: minimum detector ID to load
   * @param max_event_id :: maximum detector ID to load
+  * @param partials :: if set, the events are a range of pulses of a bank
+  *that is split, and go to its partial event lists
+  * @param part :: the index of the range of pulses in partials
+  * @param firstPulse :: index of the pulse of the first event, if known
   * @return
   */ // API::IFileLoader<Kernel::NexusDescriptor>
   ProcessBankData(DefaultEventLoader &loader, std::string entry_name,
@@ -50,12 +55,15 @@ public:
                   boost::shared_ptr<std::vector<uint64_t>> event_index,
                   boost::shared_ptr<BankPulseTimes> thisBankPulseTimes,
                   bool have_weight, boost::shared_array<float> event_weight,
-                  detid_t min_event_id, detid_t max_event_id);
+                  detid_t min_event_id, detid_t max_event_id,
+                  boost::shared_ptr<PartialBankEvents> partials = nullptr,
+                  size_t part = 0, int firstPulse = 0);
 
   void run() override;
 
 private:
   size_t getWorkspaceIndexFromPixelID(const detid_t pixID);
+  void reportProgress(const std::string &message);
 
   /// Algorithm being run
   DefaultEventLoader &m_loader;
@@ -88,6 +96,12 @@ private:
   detid_t m_min_id;
   /// Maximum pixel id
   detid_t m_max_id;
+  /// Partial event lists of a bank that is split, or null
+  boost::shared_ptr<PartialBankEvents> m_partials;
+  /// Index of the range of pulses in m_partials
+  size_t m_part;
+  /// Index of the pulse of the first event
+  int m_firstPulse;
   /// timer for performance
   Mantid::Kernel::Timer m_timer;
 }; // ENDDEF-CLASS ProcessBankData
@@ -12,6 +12,7 @@
 //----------------------------------------------------------------------
 #include "MantidAPI/Algorithm.h"
 #include "MantidAPI/MatrixWorkspace_fwd.h"
+#include "MantidKernel/CharConv.h"
 
 namespace Mantid {
 namespace DataHandling {
@@ -52,8 +53,8 @@ private:
   void init() override;
   /// Overwrites Algorithm method
   void exec() override;
-  /// Writes a spectrum to the file using a workspace index
-  void writeSpectrum(const int &wsIndex, std::ofstream &file);
+  /// Formats a spectrum for the file using a workspace index
+  void writeSpectrum(const int &wsIndex, std::string &out) const;
   std::vector<std::string> stringListToVector(std::string &inputString);
   void populateQMetaData();
   void populateSpectrumNumberMetaData();
@@ -71,6 +72,9 @@ private:
   bool m_writeDX;
   bool m_writeID;
   bool m_isCommonBins;
+  /// The number format, as the precision and flags of a stream
+  int m_precision;
+  Kernel::CharConv::FloatFormat m_floatFormat;
   API::MatrixWorkspace_const_sptr m_ws;
   std::vector<std::string> m_metaData;
   std::map<std::string, std::vector<std::string>> m_metaDataMap;
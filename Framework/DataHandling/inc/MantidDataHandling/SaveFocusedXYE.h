@@ -93,6 +93,9 @@ private:
   void writeMAUDSpectraHeader(std::ostream &os, size_t index1, size_t index2,
                               double flightPath, double tth,
                               const std::string &caption);
+  /// Format the data of a range of spectra
+  void formatData(const API::MatrixWorkspace &workspace, size_t first,
+                  size_t last, std::vector<std::string> &data);
   /// sets non workspace properties for the algorithm
   void setOtherProperties(IAlgorithm *alg, const std::string &propertyName,
                           const std::string &propertyValue,
@@ -85,6 +85,30 @@ BankPulseTimes::BankPulseTimes(
     pulseTimes[i] = times[i];
 }
 
+//----------------------------------------------------------------------------------------------
+/** Constructor. Build from pulse times read from event_time_zero before,
+ * e.g. kept in an EventNexusIndex.
+ *
+ * @param start :: the "offset" attribute of event_time_zero
+ * @param times :: the absolute pulse times, in nanoseconds
+ * @param pNumbers :: Period numbers to index into. Index via frame/pulse
+ */
+BankPulseTimes::BankPulseTimes(const std::string &start,
+                               const std::vector<int64_t> &times,
+                               const std::vector<int> &pNumbers)
+    : startTime(start), numPulses(times.size()), pulseTimes(nullptr),
+      periodNumbers(pNumbers) {
+  if (numPulses == 0)
+    throw std::runtime_error("event_time_zero field has no data!");
+  pulseTimes = new Mantid::Types::Core::DateAndTime[numPulses];
+  for (size_t i = 0; i < numPulses; i++)
+    pulseTimes[i] = Mantid::Types::Core::DateAndTime(times[i]);
+  // Ensure that we always have a consistency between nPulses and
+  // periodNumbers containers
+  if (numPulses != pNumbers.size())
+    periodNumbers = std::vector<int>(numPulses, FirstPeriod);
+}
+
 //----------------------------------------------------------------------------------------------
 /** Destructor */
 BankPulseTimes::~BankPulseTimes() { delete[] this->pulseTimes; }
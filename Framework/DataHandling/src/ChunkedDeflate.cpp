@@ -0,0 +1,315 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataHandling/ChunkedDeflate.h"
+#include "MantidDataHandling/H5Util.h"
+#include "MantidKernel/MultiThreaded.h"
+#include "MantidKernel/System.h"
+
+#include <H5Cpp.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+// H5Dwrite_chunk and H5Dread_chunk appeared in HDF5 1.10.3
+#define CHUNKED_DEFLATE_AVAILABLE H5_VERSION_GE(1, 10, 3)
+
+using namespace H5;
+
+namespace Mantid {
+namespace DataHandling {
+namespace ChunkedDeflate {
+
+namespace {
+/// A chunk as it is stored in the file
+struct StoredChunk {
+  std::vector<unsigned char> bytes;
+  /// The filters that were skipped when the chunk was stored
+  uint32_t filterMask{0};
+};
+
+/// Number of chunks compressed or inflated at once, while the previous ones
+/// are written or the next ones are read
+size_t windowSize() {
+  return 2 * static_cast<size_t>(std::max(PARALLEL_GET_MAX_THREADS, 1));
+}
+
+/// Run body(i) for every i in [0, count) on all the threads and rethrow the
+/// first exception thrown by any of them
+template <typename Body> void parallelFor(const size_t count, Body body) {
+  std::exception_ptr error;
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < static_cast<int64_t>(count); ++i) {
+    try {
+      body(static_cast<size_t>(i));
+    } catch (...) {
+      PARALLEL_CRITICAL(ChunkedDeflate_error)
+      if (!error)
+        error = std::current_exception();
+    }
+  }
+  if (error)
+    std::rethrow_exception(error);
+}
+
+/** Compress one chunk the way the HDF5 deflate filter does.
+ * @param data :: the values of the chunk
+ * @param size :: size of data in bytes, less than chunkBytes for the last chunk
+ * @param chunkBytes :: size of a whole chunk in bytes
+ * @param level :: deflate level
+ * @param chunk :: receives the compressed chunk
+ */
+void compressChunk(const unsigned char *data, const size_t size,
+                   const size_t chunkBytes, const int level,
+                   StoredChunk &chunk) {
+  // HDF5 stores the last chunk whole, padded after the end of the data
+  std::vector<unsigned char> padded;
+  if (size < chunkBytes) {
+    padded.resize(chunkBytes, 0);
+    std::copy(data, data + size, padded.begin());
+    data = padded.data();
+  }
+  uLongf length = compressBound(static_cast<uLong>(chunkBytes));
+  chunk.bytes.resize(length);
+  if (compress2(chunk.bytes.data(), &length, data,
+                static_cast<uLong>(chunkBytes), level) != Z_OK)
+    throw std::runtime_error("ChunkedDeflate: failed to compress a chunk");
+  chunk.bytes.resize(length);
+  chunk.filterMask = 0;
+}
+
+/** Inflate one stored chunk.
+ * @param chunk :: the chunk as it is stored in the file
+ * @param data :: receives the values of the chunk
+ * @param size :: size of data in bytes, less than chunkBytes for the last chunk
+ * @param chunkBytes :: size of a whole chunk in bytes
+ */
+void inflateChunk(const StoredChunk &chunk, unsigned char *data,
+                  const size_t size, const size_t chunkBytes) {
+  if (chunk.bytes.empty()) {
+    // Never written: the chunk holds the default fill value
+    std::fill(data, data + size, 0);
+    return;
+  }
+  if (chunk.filterMask & 1u) {
+    // The deflate filter was skipped for this chunk
+    if (chunk.bytes.size() < size)
+      throw std::runtime_error("ChunkedDeflate: truncated chunk");
+    std::copy(chunk.bytes.begin(), chunk.bytes.begin() + size, data);
+    return;
+  }
+  std::vector<unsigned char> padded;
+  unsigned char *output = data;
+  if (size < chunkBytes) {
+    padded.resize(chunkBytes);
+    output = padded.data();
+  }
+  uLongf length = static_cast<uLongf>(chunkBytes);
+  if (uncompress(output, &length, chunk.bytes.data(),
+                 static_cast<uLong>(chunk.bytes.size())) != Z_OK ||
+      length != chunkBytes)
+    throw std::runtime_error("ChunkedDeflate: failed to inflate a chunk");
+  if (output != data)
+    std::copy(output, output + size, data);
+}
+} // namespace
+
+/// @return true if this build of HDF5 can read and write chunks directly
+bool isAvailable() { return CHUNKED_DEFLATE_AVAILABLE; }
+
+/** Write a 1D array as a chunked dataset compressed with deflate.
+ * @param group :: the group holding the new dataset
+ * @param name :: name of the new dataset
+ * @param values :: the array
+ * @param length :: number of values in the array
+ * @param deflateLevel :: from 1 (fastest) to 9 (smallest)
+ * @throw std::runtime_error if HDF5 is too old or a chunk cannot be written
+ */
+template <typename NumT>
+void writeArray1D(Group &group, const std::string &name, const NumT *values,
+                  const size_t length, const int deflateLevel) {
+#if CHUNKED_DEFLATE_AVAILABLE
+  const auto dataType = H5Util::getType<NumT>();
+  const auto dataSpace = H5Util::getDataSpace(length);
+  if (length == 0) {
+    group.createDataSet(name, dataType, dataSpace);
+    return;
+  }
+  const size_t chunkLength =
+      std::min(length, std::max<size_t>(CHUNK_BYTES / sizeof(NumT), 1));
+  const auto propList =
+      H5Util::setCompressionAttributes(chunkLength, deflateLevel);
+  auto dataSet = group.createDataSet(name, dataType, dataSpace, propList);
+
+  const auto *bytes = reinterpret_cast<const unsigned char *>(values);
+  const size_t totalBytes = length * sizeof(NumT);
+  const size_t chunkBytes = chunkLength * sizeof(NumT);
+  const size_t numChunks = (length + chunkLength - 1) / chunkLength;
+  const size_t window = windowSize();
+
+  // One set of chunks is stored while the other is being compressed
+  std::vector<std::vector<StoredChunk>> buffers(
+      2, std::vector<StoredChunk>(window));
+  std::future<void> writing;
+  for (size_t first = 0, turn = 0; first < numChunks;
+       first += window, turn ^= 1) {
+    const size_t count = std::min(window, numChunks - first);
+    auto &chunks = buffers[turn];
+    parallelFor(count, [&](const size_t i) {
+      const size_t start = (first + i) * chunkBytes;
+      compressChunk(bytes + start, std::min(chunkBytes, totalBytes - start),
+                    chunkBytes, deflateLevel, chunks[i]);
+    });
+
+    if (writing.valid())
+      writing.get();
+    writing = std::async(std::launch::async, [&dataSet, &chunks, &name, first,
+                                              count, chunkLength] {
+      for (size_t i = 0; i < count; ++i) {
+        const hsize_t offset[1] = {(first + i) * chunkLength};
+        if (H5Dwrite_chunk(dataSet.getId(), H5P_DEFAULT, chunks[i].filterMask,
+                           offset, chunks[i].bytes.size(),
+                           chunks[i].bytes.data()) < 0)
+          throw std::runtime_error("ChunkedDeflate: failed to write a chunk "
+                                   "of " +
+                                   name);
+      }
+    });
+  }
+  if (writing.valid())
+    writing.get();
+#else
+  UNUSED_ARG(group);
+  UNUSED_ARG(name);
+  UNUSED_ARG(values);
+  UNUSED_ARG(length);
+  UNUSED_ARG(deflateLevel);
+  throw std::runtime_error("ChunkedDeflate needs HDF5 1.10.3 or later");
+#endif
+}
+
+/**
+ * @param dataset :: an open dataset
+ * @return true if readArray1D() can inflate the chunks of dataset in parallel
+ */
+bool isChunkedDeflate(DataSet &dataset) {
+#if CHUNKED_DEFLATE_AVAILABLE
+  const auto propList = dataset.getCreatePlist();
+  const hid_t id = propList.getId();
+  if (H5Pget_layout(id) != H5D_CHUNKED || H5Pget_nfilters(id) != 1 ||
+      dataset.getSpace().getSimpleExtentNdims() != 1)
+    return false;
+  unsigned int flags = 0;
+  unsigned int config = 0;
+  size_t numValues = 0;
+  if (H5Pget_filter2(id, 0, &flags, &numValues, nullptr, 0, nullptr,
+                     &config) != H5Z_FILTER_DEFLATE)
+    return false;
+  H5D_fill_value_t fillValue;
+  return H5Pfill_value_defined(id, &fillValue) >= 0 &&
+         fillValue == H5D_FILL_VALUE_DEFAULT;
+#else
+  UNUSED_ARG(dataset);
+  return false;
+#endif
+}
+
+/** Read a whole 1D dataset. Chunked deflate datasets of the requested type
+ * are inflated on all the threads, other datasets are read by HDF5.
+ * @param dataset :: an open 1D dataset
+ * @param values :: receives the values
+ * @param length :: size of values, which must be the size of the dataset
+ * @throw std::invalid_argument if length is not the size of the dataset
+ */
+template <typename NumT>
+void readArray1D(DataSet &dataset, NumT *values, const size_t length) {
+  const auto dataType = H5Util::getType<NumT>();
+  if (static_cast<size_t>(dataset.getSpace().getSimpleExtentNpoints()) !=
+      length)
+    throw std::invalid_argument(
+        "ChunkedDeflate: the dataset does not have the requested length");
+  if (length == 0)
+    return;
+#if CHUNKED_DEFLATE_AVAILABLE
+  if (isChunkedDeflate(dataset) && dataset.getDataType() == dataType) {
+    hsize_t chunkLength = 0;
+    dataset.getCreatePlist().getChunk(1, &chunkLength);
+    auto *bytes = reinterpret_cast<unsigned char *>(values);
+    const size_t totalBytes = length * sizeof(NumT);
+    const size_t chunkBytes = static_cast<size_t>(chunkLength) * sizeof(NumT);
+    const size_t numChunks =
+        (length + static_cast<size_t>(chunkLength) - 1) / chunkLength;
+    const size_t window = windowSize();
+
+    // The next set of chunks is read while the other is being inflated
+    std::vector<std::vector<StoredChunk>> buffers(
+        2, std::vector<StoredChunk>(window));
+    const hid_t id = dataset.getId();
+    auto readChunks = [&buffers, id, chunkLength, numChunks,
+                       window](const size_t turn, const size_t first) {
+      const size_t count = std::min(window, numChunks - first);
+      for (size_t i = 0; i < count; ++i) {
+        auto &chunk = buffers[turn][i];
+        const hsize_t offset[1] = {(first + i) * chunkLength};
+        hsize_t size = 0;
+        if (H5Dget_chunk_storage_size(id, offset, &size) < 0)
+          throw std::runtime_error("ChunkedDeflate: failed to find a chunk");
+        chunk.bytes.resize(static_cast<size_t>(size));
+        chunk.filterMask = 0;
+        if (size > 0 && H5Dread_chunk(id, H5P_DEFAULT, offset,
+                                      &chunk.filterMask,
+                                      chunk.bytes.data()) < 0)
+          throw std::runtime_error("ChunkedDeflate: failed to read a chunk");
+      }
+    };
+
+    std::future<void> reading =
+        std::async(std::launch::async, readChunks, 0, 0);
+    for (size_t first = 0, turn = 0; first < numChunks;
+         first += window, turn ^= 1) {
+      reading.get();
+      if (first + window < numChunks)
+        reading = std::async(std::launch::async, readChunks, turn ^ 1,
+                             first + window);
+      const auto &chunks = buffers[turn];
+      parallelFor(std::min(window, numChunks - first), [&](const size_t i) {
+        const size_t start = (first + i) * chunkBytes;
+        inflateChunk(chunks[i], bytes + start,
+                     std::min(chunkBytes, totalBytes - start), chunkBytes);
+      });
+    }
+    return;
+  }
+#endif
+  dataset.read(values, dataType);
+}
+
+// -------------------------------------------------------------------
+// instantiations for writeArray1D and readArray1D
+// -------------------------------------------------------------------
+
+#define INSTANTIATE(NumT)                                                      \
+  template MANTID_DATAHANDLING_DLL void writeArray1D(                          \
+      H5::Group & group, const std::string &name, const NumT *values,          \
+      const size_t length, const int deflateLevel);                            \
+  template MANTID_DATAHANDLING_DLL void readArray1D(                           \
+      H5::DataSet & dataset, NumT * values, const size_t length);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(int32_t)
+INSTANTIATE(uint32_t)
+INSTANTIATE(int64_t)
+INSTANTIATE(uint64_t)
+
+} // namespace ChunkedDeflate
+} // namespace DataHandling
+} // namespace Mantid
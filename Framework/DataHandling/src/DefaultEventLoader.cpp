@@ -6,17 +6,64 @@
 // SPDX - License - Identifier: GPL - 3.0 +
 #include "MantidDataHandling/DefaultEventLoader.h"
 #include "MantidAPI/Progress.h"
+#include "MantidDataHandling/EventBufferPool.h"
 #include "MantidDataHandling/LoadBankFromDiskTask.h"
 #include "MantidDataHandling/LoadEventNexus.h"
+#include "MantidGeometry/Instrument/ComponentInfo.h"
+#include "MantidGeometry/Instrument/DetectorInfo.h"
+#include "MantidKernel/ConfigService.h"
 #include "MantidKernel/ThreadPool.h"
 #include "MantidKernel/ThreadSchedulerMutexes.h"
+#include "MantidKernel/ThreadSchedulerWorkStealing.h"
+#include "MantidKernel/Timer.h"
 #include "MantidKernel/make_unique.h"
 
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
 using namespace Mantid::Kernel;
 
 namespace Mantid {
 namespace DataHandling {
 
+namespace {
+/// Number of banks read ahead of their processing if none is configured
+constexpr int DEFAULT_PREFETCH_BANKS = 4;
+
+/// @return the number of banks that may be read ahead of their processing,
+/// given by LoadEventNexus.PrefetchBanks. Zero disables the I/O stage.
+size_t prefetchBanks() {
+  const int banks = ConfigService::Instance()
+                        .getValue<int>("LoadEventNexus.PrefetchBanks")
+                        .get_value_or(DEFAULT_PREFETCH_BANKS);
+  return banks > 0 ? static_cast<size_t>(banks) : 0;
+}
+
+/// Smallest number of events of a task if none is configured
+constexpr int DEFAULT_MIN_TASK_EVENTS = 1000000;
+/// Number of tasks per thread the events are split into, for load balancing
+constexpr size_t TASKS_PER_THREAD = 4;
+
+/** A work-stealing scheduler that the threads of a ThreadPool do not see as
+ * empty while tasks are still being produced outside of the pool. Otherwise
+ * the threads exit as soon as they have processed the banks read so far.
+ */
+class ProducerScheduler : public ThreadSchedulerWorkStealing {
+public:
+  ProducerScheduler()
+      : ThreadSchedulerWorkStealing(ThreadPool::getNumPhysicalCores()) {}
+  bool empty() override {
+    return !m_producing && ThreadSchedulerWorkStealing::empty();
+  }
+  /// Signal that no more tasks will be pushed
+  void finishProducing() { m_producing = false; }
+
+private:
+  std::atomic<bool> m_producing{true};
+};
+} // namespace
+
 void DefaultEventLoader::load(LoadEventNexus *alg, EventWorkspaceCollection &ws,
                               bool haveWeights, bool event_id_is_spec,
                               std::vector<std::string> bankNames,
@@ -29,11 +76,8 @@ void DefaultEventLoader::load(LoadEventNexus *alg, EventWorkspaceCollection &ws,
                             bankNames.size(), precount, chunk, totalChunks);
 
   auto bankRange = loader.setupChunking(bankNames, bankNumEvents);
-
-  // Make the thread pool
-  auto scheduler = new ThreadSchedulerMutexes;
-  ThreadPool pool(scheduler);
-  auto diskIOMutex = boost::make_shared<std::mutex>();
+  loader.skipUnselectedBanks(bankNames, bankNumEvents, bankRange);
+  loader.setupTaskSize(bankNumEvents, bankRange);
 
   // set up progress bar for the rest of the (multi-threaded) process
   size_t numProg = bankNames.size() * (1 + 3); // 1 = disktask, 3 = proc task
@@ -41,6 +85,42 @@ void DefaultEventLoader::load(LoadEventNexus *alg, EventWorkspaceCollection &ws,
     numProg += bankNames.size() * 3; // 3 = second proc task
   auto prog = Kernel::make_unique<API::Progress>(loader.alg, 0.3, 1.0, numProg);
 
+  Timer timer;
+  const size_t prefetchDepth = prefetchBanks();
+  if (prefetchDepth > 0) {
+    // The calling thread reads the banks one after the other, from a single
+    // open file, while the thread pool processes the banks already read.
+    auto scheduler = new ProducerScheduler;
+    ThreadPool pool(scheduler);
+    pool.start();
+    EventBufferPool buffers(prefetchDepth);
+    double readTime = 0.;
+    size_t numBanksRead = 0;
+    try {
+      numBanksRead = loader.readBanks(
+          bankNames, bankNumEvents, bankRange, periodLog, classType,
+          oldNeXusFileNames, buffers, prog.get(), *scheduler, readTime);
+    } catch (...) {
+      scheduler->finishProducing();
+      pool.joinAll();
+      throw;
+    }
+    scheduler->finishProducing();
+    pool.joinAll();
+    alg->getLogger().information()
+        << "Read " << numBanksRead << " banks in " << readTime
+        << " s, waited " << buffers.waitTime()
+        << " s for buffers to be freed by the processing, processed them in "
+        << loader.m_processTime << " s over all threads. Total "
+        << timer.elapsed() << " s.\n";
+    return;
+  }
+
+  // Make the thread pool
+  auto scheduler = new ThreadSchedulerMutexes;
+  ThreadPool pool(scheduler);
+  auto diskIOMutex = boost::make_shared<std::mutex>();
+
   for (size_t i = bankRange.first; i < bankRange.second; i++) {
     if (bankNumEvents[i] > 0)
       pool.schedule(new LoadBankFromDiskTask(
@@ -50,6 +130,9 @@ void DefaultEventLoader::load(LoadEventNexus *alg, EventWorkspaceCollection &ws,
   // Start and end all threads
   pool.joinAll();
   diskIOMutex.reset();
+  alg->getLogger().information()
+      << "Loaded the banks in " << timer.elapsed() << " s, processed them in "
+      << loader.m_processTime << " s over all threads.\n";
 }
 
 DefaultEventLoader::DefaultEventLoader(LoadEventNexus *alg,
@@ -85,6 +168,172 @@ DefaultEventLoader::DefaultEventLoader(LoadEventNexus *alg,
   splitProcessing = bool(numBanks * 2 < ThreadPool::getNumPhysicalCores());
 }
 
+/** Read the banks one after the other and schedule their processing. At most
+ * buffers.capacity() banks are held in memory, waiting for or being
+ * processed, so the reading runs ahead of the processing by that many banks.
+ *
+ * @param bankNames :: the names of all banks
+ * @param bankNumEvents :: the number of events of each bank
+ * @param bankRange :: the banks to read
+ * @param periodLog :: period numbers corresponding to each frame
+ * @param classType :: the NeXus class of the banks
+ * @param oldNeXusFileNames :: true if the file has the old field names
+ * @param buffers :: the pool of buffers the banks are read into
+ * @param prog :: progress reporting
+ * @param scheduler :: the scheduler the ProcessBankData tasks are pushed to
+ * @param readTime :: incremented by the time spent reading, in seconds
+ * @return the number of banks read without error
+ */
+size_t DefaultEventLoader::readBanks(
+    const std::vector<std::string> &bankNames,
+    const std::vector<std::size_t> &bankNumEvents,
+    const std::pair<size_t, size_t> &bankRange,
+    const std::vector<int> &periodLog, const std::string &classType,
+    const bool oldNeXusFileNames, EventBufferPool &buffers,
+    API::Progress *prog, ThreadScheduler &scheduler, double &readTime) {
+  size_t numBanksRead = 0;
+  ::NeXus::File file(alg->m_filename);
+  try {
+    file.openGroup(alg->m_top_entry_name, "NXentry");
+    for (size_t i = bankRange.first; i < bankRange.second; i++) {
+      if (bankNumEvents[i] == 0)
+        continue;
+      if (alg->getCancel() || scheduler.getAborted())
+        break;
+      // Wait for the processing to free a buffer
+      auto bankBuffers = buffers.acquire();
+      Timer readTimer;
+      LoadBankFromDiskTask task(*this, bankNames[i], classType,
+                                bankNumEvents[i], oldNeXusFileNames, prog,
+                                boost::shared_ptr<std::mutex>(), scheduler,
+                                periodLog);
+      const bool loaded = task.readBank(file, std::move(bankBuffers));
+      readTime += readTimer.elapsed();
+      if (loaded) {
+        task.scheduleProcessing();
+        ++numBanksRead;
+      }
+    }
+  } catch (std::exception &e) {
+    alg->getLogger().error() << "Error while reading the banks of "
+                             << alg->m_filename << ":\n"
+                             << e.what() << '\n';
+  }
+  file.close();
+  return numBanksRead;
+}
+
+/** Mark the banks without any pixel in the workspace as empty, so that they
+ * are not read at all. This only applies when a subset of the spectra is
+ * loaded, e.g. with SpectrumList: the events of pixels without an event list
+ * would be discarded after being read. The pixels of a bank are the range of
+ * its event IDs if the index of the file has it, or else its detectors in the
+ * instrument. Banks that are in neither are always read.
+ *
+ * @param bankNames :: the names of all banks
+ * @param bankNumEvents :: the number of events of each bank, set to zero for
+ * the banks that are skipped
+ * @param bankRange :: the banks to load
+ */
+void DefaultEventLoader::skipUnselectedBanks(
+    const std::vector<std::string> &bankNames,
+    std::vector<std::size_t> &bankNumEvents,
+    const std::pair<size_t, size_t> &bankRange) {
+  if (event_id_is_spec)
+    return;
+  const auto ws = m_ws.getSingleHeldWorkspace();
+  const auto &detectorInfo = ws->detectorInfo();
+  size_t numDetectors = 0;
+  for (size_t i = 0; i < detectorInfo.size(); ++i)
+    if (!detectorInfo.isMonitor(i))
+      ++numDetectors;
+  if (m_ws.getNumberHistograms() >= numDetectors)
+    return; // All pixels are loaded
+
+  const auto hasEventList = [this](const detid_t id) {
+    if (id < 0 || id > eventid_max)
+      return false;
+    if (m_haveWeights)
+      return weightedEventVectors[0][id] != nullptr;
+    return eventVectors[0][id] != nullptr;
+  };
+
+  const auto &componentInfo = ws->componentInfo();
+  const auto &detectorIDs = detectorInfo.detectorIDs();
+  const std::string suffix("_events");
+  size_t numSkipped = 0;
+  const auto &index = alg->m_index;
+  for (size_t i = bankRange.first; i < bankRange.second; i++) {
+    if (bankNumEvents[i] == 0)
+      continue;
+    const auto *indexed = index ? index->bank(bankNames[i]) : nullptr;
+    if (indexed && indexed->hasIdRange) {
+      bool selected = false;
+      const auto maxId = std::min(static_cast<int64_t>(indexed->maxId),
+                                  static_cast<int64_t>(eventid_max));
+      for (auto id = static_cast<int64_t>(indexed->minId);
+           id <= maxId && !selected; ++id)
+        selected = hasEventList(static_cast<detid_t>(id));
+      if (selected)
+        continue;
+    } else {
+      std::string name = bankNames[i];
+      if (name.size() > suffix.size() &&
+          name.compare(name.size() - suffix.size(), suffix.size(), suffix) ==
+              0)
+        name.erase(name.size() - suffix.size());
+      size_t bankIndex;
+      try {
+        bankIndex = componentInfo.indexOfAny(name);
+      } catch (std::invalid_argument &) {
+        continue;
+      }
+      const auto detectors = componentInfo.detectorsInSubtree(bankIndex);
+      if (detectors.empty() ||
+          std::any_of(detectors.cbegin(), detectors.cend(),
+                      [&](const size_t detector) {
+                        return hasEventList(detectorIDs[detector]);
+                      }))
+        continue;
+    }
+    bankNumEvents[i] = 0;
+    ++numSkipped;
+    alg->getLogger().debug() << "Bank " << bankNames[i]
+                             << " has no selected pixels and is not read.\n";
+  }
+  if (numSkipped > 0)
+    alg->getLogger().information()
+        << "Skipped " << numSkipped
+        << " banks without any of the selected spectra.\n";
+}
+
+/** Choose the size of the ranges of pulses that big banks are split into, so
+ * that the events are shared evenly between the threads and the load does
+ * not end with a single thread processing a big bank. The ranges have at
+ * least LoadEventNexus.MinTaskEvents events, zero or less disables the
+ * splitting.
+ *
+ * @param bankNumEvents :: the number of events of each bank
+ * @param bankRange :: the banks to load
+ */
+void DefaultEventLoader::setupTaskSize(
+    const std::vector<std::size_t> &bankNumEvents,
+    const std::pair<size_t, size_t> &bankRange) {
+  const int minEvents = ConfigService::Instance()
+                            .getValue<int>("LoadEventNexus.MinTaskEvents")
+                            .get_value_or(DEFAULT_MIN_TASK_EVENTS);
+  if (minEvents <= 0) {
+    eventsPerTask = 0;
+    return;
+  }
+  const size_t totalEvents = std::accumulate(
+      bankNumEvents.cbegin() + bankRange.first,
+      bankNumEvents.cbegin() + bankRange.second, static_cast<size_t>(0));
+  const size_t numTasks = ThreadPool::getNumPhysicalCores() * TASKS_PER_THREAD;
+  eventsPerTask =
+      std::max(static_cast<size_t>(minEvents), totalEvents / numTasks);
+}
+
 std::pair<size_t, size_t>
 DefaultEventLoader::setupChunking(std::vector<std::string> &bankNames,
                                   std::vector<std::size_t> &bankNumEvents) {
@@ -10,6 +10,7 @@
 #include "MantidAPI/ITableWorkspace.h"
 #include "MantidAPI/TableRow.h"
 #include "MantidAPI/WorkspaceFactory.h"
+#include "MantidDataHandling/EventNexusIndex.h"
 #include "MantidDataHandling/LoadEventNexus.h"
 #include "MantidDataHandling/LoadPreNexus.h"
 #include "MantidDataHandling/LoadRawHelper.h"
@@ -166,50 +167,63 @@ void DetermineChunking::exec() {
   }
   // Event Nexus
   else if (fileType == EVENT_NEXUS_FILE) {
-
-    // top level file information
-    ::NeXus::File file(filename);
     std::string m_top_entry_name = setTopEntryName(filename);
-
-    // Start with the base entry
-    file.openGroup(m_top_entry_name, "NXentry");
-
-    // Now we want to go through all the bankN_event entries
-    map<string, string> entries = file.getEntries();
-    map<string, string>::const_iterator it = entries.begin();
-    std::string classType = "NXevent_data";
     size_t total_events = 0;
-    for (; it != entries.end(); ++it) {
-      std::string entry_name(it->first);
-      std::string entry_class(it->second);
-      if (entry_class == classType) {
-        if (!isEmpty(maxChunk)) {
-          try {
-            // Get total number of events for each bank
-            file.openGroup(entry_name, entry_class);
-            file.openData("total_counts");
-            if (file.getInfo().type == NX_UINT64) {
-              std::vector<uint64_t> bank_events;
-              file.getData(bank_events);
-              total_events += bank_events[0];
-            } else {
-              std::vector<int> bank_events;
-              file.getDataCoerce(bank_events);
-              total_events += bank_events[0];
+
+    // The index kept by LoadEventNexus has the number of events of each bank
+    std::unique_ptr<EventNexusIndex> index;
+    try {
+      index = EventNexusIndex::open(filename);
+    } catch (std::exception &e) {
+      g_log.information() << "Not using an index of the file: " << e.what()
+                          << '\n';
+    }
+    if (index && index->hasBanks(m_top_entry_name)) {
+      for (const auto &bank : index->banks())
+        total_events += bank.numEvents;
+    } else {
+      // top level file information
+      ::NeXus::File file(filename);
+
+      // Start with the base entry
+      file.openGroup(m_top_entry_name, "NXentry");
+
+      // Now we want to go through all the bankN_event entries
+      map<string, string> entries = file.getEntries();
+      map<string, string>::const_iterator it = entries.begin();
+      std::string classType = "NXevent_data";
+      for (; it != entries.end(); ++it) {
+        std::string entry_name(it->first);
+        std::string entry_class(it->second);
+        if (entry_class == classType) {
+          if (!isEmpty(maxChunk)) {
+            try {
+              // Get total number of events for each bank
+              file.openGroup(entry_name, entry_class);
+              file.openData("total_counts");
+              if (file.getInfo().type == NX_UINT64) {
+                std::vector<uint64_t> bank_events;
+                file.getData(bank_events);
+                total_events += bank_events[0];
+              } else {
+                std::vector<int> bank_events;
+                file.getDataCoerce(bank_events);
+                total_events += bank_events[0];
+              }
+              file.closeData();
+              file.closeGroup();
+            } catch (::NeXus::Exception &) {
+              g_log.error() << "Unable to find total counts to determine "
+                               "chunking strategy.\n";
             }
-            file.closeData();
-            file.closeGroup();
-          } catch (::NeXus::Exception &) {
-            g_log.error() << "Unable to find total counts to determine "
-                             "chunking strategy.\n";
           }
         }
       }
-    }
 
-    // Close up the file
-    file.closeGroup();
-    file.close();
+      // Close up the file
+      file.closeGroup();
+      file.close();
+    }
     // Factor of 2 for compression
     wkspSizeGiB = static_cast<double>(total_events) * 48.0 * BYTES_TO_GiB;
   } else if (fileType == RAW_FILE) {
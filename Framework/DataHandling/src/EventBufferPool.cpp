@@ -0,0 +1,93 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataHandling/EventBufferPool.h"
+#include "MantidKernel/Timer.h"
+
+#include <boost/make_shared.hpp>
+
+#include <stdexcept>
+
+namespace Mantid {
+namespace DataHandling {
+
+/** Constructor
+ * @param capacity :: maximum number of buffers in use at the same time
+ * @throw std::invalid_argument if the capacity is zero
+ */
+EventBufferPool::EventBufferPool(const size_t capacity)
+    : m_state(boost::make_shared<State>()) {
+  if (capacity == 0)
+    throw std::invalid_argument("EventBufferPool: the capacity must be > 0");
+  m_state->capacity = capacity;
+}
+
+/** Take a buffer from the pool, waiting until one is returned if they are all
+ * in use.
+ * @return the buffer; its vectors keep the size they had when it was last
+ * used
+ */
+boost::shared_ptr<EventBuffers> EventBufferPool::acquire() {
+  std::unique_lock<std::mutex> lock(m_state->mutex);
+  if (m_state->inUse >= m_state->capacity) {
+    Kernel::Timer timer;
+    m_state->returned.wait(
+        lock, [this] { return m_state->inUse < m_state->capacity; });
+    m_state->waitTime += timer.elapsed_no_reset();
+  }
+  return handOut(m_state);
+}
+
+/** Take a buffer from the pool if one is available, without waiting.
+ * @return the buffer, or a null pointer if they are all in use
+ */
+boost::shared_ptr<EventBuffers> EventBufferPool::tryAcquire() {
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  if (m_state->inUse >= m_state->capacity)
+    return boost::shared_ptr<EventBuffers>();
+  return handOut(m_state);
+}
+
+/// @return the number of buffers that can be acquired without waiting
+size_t EventBufferPool::available() const {
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  return m_state->capacity - m_state->inUse;
+}
+
+/// @return the total time spent waiting for a buffer, in seconds
+double EventBufferPool::waitTime() const {
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  return m_state->waitTime;
+}
+
+/** Hand out a free buffer, reusing a returned one if possible.
+ * @param state :: the state of the pool, which must be locked and have a
+ * buffer available
+ * @return the buffer, which goes back to the pool when released
+ */
+boost::shared_ptr<EventBuffers>
+EventBufferPool::handOut(const boost::shared_ptr<State> &state) {
+  std::unique_ptr<EventBuffers> buffers;
+  if (state->free.empty()) {
+    buffers.reset(new EventBuffers);
+  } else {
+    buffers = std::move(state->free.back());
+    state->free.pop_back();
+  }
+  ++state->inUse;
+  return boost::shared_ptr<EventBuffers>(
+      buffers.release(), [state](EventBuffers *released) {
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          state->free.emplace_back(released);
+          --state->inUse;
+        }
+        state->returned.notify_one();
+      });
+}
+
+} // namespace DataHandling
+} // namespace Mantid
@@ -0,0 +1,396 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataHandling/EventNexusIndex.h"
+#include "MantidKernel/ConfigService.h"
+#include "MantidKernel/Logger.h"
+#include "MantidKernel/make_unique.h"
+
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <Poco/TemporaryFile.h>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Mantid {
+namespace DataHandling {
+
+namespace {
+/// static logger
+Kernel::Logger g_log("EventNexusIndex");
+
+/// First bytes of an index file
+const char MAGIC[8] = {'M', 'T', 'D', 'E', 'V', 'I', 'D', 'X'};
+/// Version of the layout of the index files, to increase when it changes
+constexpr uint32_t VERSION = 1;
+/// Extension of the index files
+const std::string EXTENSION(".evindex");
+
+template <typename T> void writeValue(std::ostream &stream, const T &value) {
+  static_assert(std::is_trivially_copyable<T>::value, "Not a plain value");
+  stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> bool readValue(std::istream &stream, T &value) {
+  static_assert(std::is_trivially_copyable<T>::value, "Not a plain value");
+  stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+  return static_cast<bool>(stream);
+}
+
+template <typename T>
+void writeVector(std::ostream &stream, const std::vector<T> &values) {
+  writeValue(stream, static_cast<uint64_t>(values.size()));
+  stream.write(reinterpret_cast<const char *>(values.data()),
+               values.size() * sizeof(T));
+}
+
+template <typename T>
+bool readVector(std::istream &stream, std::vector<T> &values) {
+  uint64_t size;
+  if (!readValue(stream, size))
+    return false;
+  // Read in blocks so that a corrupt size fails at the end of the file
+  // instead of allocating a huge vector first
+  constexpr uint64_t blockSize = 1 << 20;
+  values.clear();
+  for (uint64_t done = 0; done < size;) {
+    const auto block = std::min(blockSize, size - done);
+    values.resize(done + block);
+    stream.read(reinterpret_cast<char *>(values.data() + done),
+                block * sizeof(T));
+    if (!stream)
+      return false;
+    done += block;
+  }
+  return true;
+}
+
+void writeString(std::ostream &stream, const std::string &value) {
+  writeVector(stream, std::vector<char>(value.cbegin(), value.cend()));
+}
+
+bool readString(std::istream &stream, std::string &value) {
+  std::vector<char> chars;
+  if (!readVector(stream, chars))
+    return false;
+  value.assign(chars.cbegin(), chars.cend());
+  return true;
+}
+} // namespace
+
+constexpr int64_t EventNexusIndex::NO_PULSE_TABLE;
+
+/** Constructor: an empty index of the file in its current state
+ * @param filename :: path to the event file
+ * @throw std::runtime_error if the file cannot be found
+ */
+EventNexusIndex::EventNexusIndex(const std::string &filename)
+    : m_filename(filename) {
+  Poco::File file(filename);
+  if (!file.exists())
+    throw std::runtime_error("EventNexusIndex: cannot find " + filename);
+  m_fileSize = static_cast<uint64_t>(file.getSize());
+  m_fileTime = static_cast<int64_t>(file.getLastModified().epochMicroseconds());
+}
+
+/** Where the index of a file is kept, according to EventNexusIndex.Location.
+ * @param filename :: path to the event file
+ * @return the path of the index, or an empty string if indexes are disabled
+ */
+std::string EventNexusIndex::location(const std::string &filename) {
+  const auto setting =
+      Kernel::ConfigService::Instance().getString("EventNexusIndex.Location");
+  if (setting.empty() || setting == "Off")
+    return std::string();
+  Poco::Path path(filename);
+  path.makeAbsolute();
+  if (setting == "NextToFile")
+    return path.toString() + EXTENSION;
+  // Files with the same name in different directories must not share an index
+  std::ostringstream name;
+  name << path.getFileName() << '.' << std::hex << std::setw(16)
+       << std::setfill('0') << std::hash<std::string>{}(path.toString())
+       << EXTENSION;
+  Poco::Path directory(setting);
+  directory.makeDirectory();
+  directory.setFileName(name.str());
+  return directory.toString();
+}
+
+/** Get the index of a file: the one kept for it if it is still valid, or an
+ * empty one to fill otherwise.
+ * @param filename :: path to the event file
+ * @return the index, or a null pointer if indexes are disabled
+ */
+std::unique_ptr<EventNexusIndex>
+EventNexusIndex::open(const std::string &filename) {
+  const auto indexPath = location(filename);
+  if (indexPath.empty())
+    return nullptr;
+  auto index = load(indexPath, filename);
+  if (!index)
+    index = Kernel::make_unique<EventNexusIndex>(filename);
+  return index;
+}
+
+/** Load an index file.
+ * @param indexPath :: path to the index
+ * @param filename :: path to the event file it should be the index of
+ * @return the index, or a null pointer if there is no index at indexPath or
+ * if it was built from another version of the event file
+ */
+std::unique_ptr<EventNexusIndex>
+EventNexusIndex::load(const std::string &indexPath,
+                      const std::string &filename) {
+  std::ifstream stream(indexPath, std::ios::binary);
+  if (!stream)
+    return nullptr;
+  auto index = Kernel::make_unique<EventNexusIndex>(filename);
+  if (!index->read(stream)) {
+    g_log.debug() << "Ignoring the out of date or invalid index " << indexPath
+                  << '\n';
+    return nullptr;
+  }
+  g_log.debug() << "Using the index " << indexPath << '\n';
+  return index;
+}
+
+/** Save the index where location() says it should be kept. Failing to save
+ * is not an error: the file is then indexed again by the next load.
+ * @return true if the index was saved
+ */
+bool EventNexusIndex::save() const {
+  const auto indexPath = location(m_filename);
+  if (indexPath.empty())
+    return false;
+  try {
+    saveAs(indexPath);
+  } catch (std::exception &e) {
+    g_log.information() << "Could not save the index of " << m_filename
+                        << ": " << e.what() << '\n';
+    return false;
+  }
+  return true;
+}
+
+/** Save the index to a file. It is written to a temporary file first so that
+ * other processes never read a partly written index.
+ * @param indexPath :: path to the index
+ * @throw std::runtime_error if the index cannot be written
+ */
+void EventNexusIndex::saveAs(const std::string &indexPath) const {
+  // The first index saved to a directory creates it
+  const auto directory =
+      Poco::Path(indexPath).makeAbsolute().parent().toString();
+  Poco::File(directory).createDirectories();
+  // A unique name, so that processes saving the same index at the same time
+  // do not write to the same temporary file
+  const std::string tempPath = Poco::TemporaryFile::tempName(directory);
+  try {
+    {
+      std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+      if (!stream)
+        throw std::runtime_error("cannot write to " + tempPath);
+      write(stream);
+      stream.close();
+      if (stream.fail())
+        throw std::runtime_error("error while writing " + tempPath);
+    }
+    Poco::File(tempPath).renameTo(indexPath);
+  } catch (...) {
+    if (Poco::File(tempPath).exists())
+      Poco::File(tempPath).remove();
+    throw;
+  }
+}
+
+/** @param entryName :: name of an NXentry
+ * @return true if the index holds the banks of the entry
+ */
+bool EventNexusIndex::hasBanks(const std::string &entryName) const {
+  return !m_banks.empty() && m_entryName == entryName;
+}
+
+/** @param name :: name of a bank
+ * @return the bank, or a null pointer if the index does not know it
+ */
+const EventNexusIndex::Bank *
+EventNexusIndex::bank(const std::string &name) const {
+  const auto position = m_bankPositions.find(name);
+  if (position == m_bankPositions.end())
+    return nullptr;
+  return &m_banks[position->second];
+}
+
+/** Replace the banks of the index.
+ * @param entryName :: name of the NXentry the banks belong to
+ * @param banks :: the banks, in the order of the file
+ * @param pulseTables :: the pulse times the banks refer to
+ * @param oldFieldNames :: true if the banks use the old field names
+ * @throw std::invalid_argument if a bank refers to a missing pulse table
+ */
+void EventNexusIndex::setBanks(const std::string &entryName,
+                               std::vector<Bank> banks,
+                               std::vector<PulseTable> pulseTables,
+                               const bool oldFieldNames) {
+  for (const auto &bank : banks)
+    if (bank.pulseTable != NO_PULSE_TABLE &&
+        (bank.pulseTable < 0 ||
+         bank.pulseTable >= static_cast<int64_t>(pulseTables.size())))
+      throw std::invalid_argument("EventNexusIndex: bank " + bank.name +
+                                  " refers to a missing pulse table");
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entryName = entryName;
+  m_oldFieldNames = oldFieldNames;
+  m_banks = std::move(banks);
+  m_pulseTables = std::move(pulseTables);
+  m_bankPositions.clear();
+  for (size_t i = 0; i < m_banks.size(); ++i)
+    m_bankPositions.emplace(m_banks[i].name, i);
+  m_modified = true;
+}
+
+/** Record the range of the event IDs of a bank, found by reading all of its
+ * events. Can be called from several threads. Unknown banks are ignored.
+ * @param bankName :: name of the bank
+ * @param minId :: smallest event ID of the bank
+ * @param maxId :: largest event ID of the bank
+ */
+void EventNexusIndex::setIdRange(const std::string &bankName,
+                                 const uint32_t minId, const uint32_t maxId) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto position = m_bankPositions.find(bankName);
+  if (position == m_bankPositions.end())
+    return;
+  auto &bank = m_banks[position->second];
+  if (bank.hasIdRange && bank.minId == minId && bank.maxId == maxId)
+    return;
+  bank.hasIdRange = true;
+  bank.minId = minId;
+  bank.maxId = maxId;
+  m_modified = true;
+}
+
+/// @param logs :: the summary of the logs
+void EventNexusIndex::setLogs(const LogSummary &logs) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_logs = logs;
+  m_logs.known = true;
+  m_modified = true;
+}
+
+/// Write the index, in the layout read by read()
+void EventNexusIndex::write(std::ostream &stream) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  stream.write(MAGIC, sizeof(MAGIC));
+  writeValue(stream, VERSION);
+  writeValue(stream, m_fileSize);
+  writeValue(stream, m_fileTime);
+
+  writeString(stream, m_entryName);
+  writeValue(stream, static_cast<uint8_t>(m_oldFieldNames));
+  writeValue(stream, static_cast<uint64_t>(m_pulseTables.size()));
+  for (const auto &table : m_pulseTables) {
+    writeString(stream, table.offset);
+    writeVector(stream, table.times);
+  }
+  writeValue(stream, static_cast<uint64_t>(m_banks.size()));
+  for (const auto &bank : m_banks) {
+    writeString(stream, bank.name);
+    writeValue(stream, bank.numEvents);
+    writeValue(stream, static_cast<uint8_t>(bank.hasWeights));
+    writeVector(stream, bank.eventIndex);
+    writeValue(stream, bank.pulseTable);
+    writeValue(stream, static_cast<uint8_t>(bank.hasIdRange));
+    writeValue(stream, bank.minId);
+    writeValue(stream, bank.maxId);
+  }
+
+  writeValue(stream, static_cast<uint8_t>(m_logs.known));
+  writeString(stream, m_logs.entryName);
+  writeString(stream, m_logs.frequencyStart);
+  writeValue(stream, static_cast<uint8_t>(m_logs.hasProtonCharge));
+  writeValue(stream, m_logs.protonCharge);
+}
+
+/** Read an index written by write().
+ * @param stream :: the index
+ * @return false if the stream is not an index of the current version of the
+ * event file
+ */
+bool EventNexusIndex::read(std::istream &stream) {
+  char magic[sizeof(MAGIC)];
+  stream.read(magic, sizeof(magic));
+  if (!stream || !std::equal(magic, magic + sizeof(magic), MAGIC))
+    return false;
+  uint32_t version;
+  uint64_t fileSize;
+  int64_t fileTime;
+  if (!readValue(stream, version) || version != VERSION ||
+      !readValue(stream, fileSize) || fileSize != m_fileSize ||
+      !readValue(stream, fileTime) || fileTime != m_fileTime)
+    return false;
+
+  std::string entryName;
+  uint8_t oldFieldNames;
+  uint64_t numTables;
+  if (!readString(stream, entryName) || !readValue(stream, oldFieldNames) ||
+      !readValue(stream, numTables))
+    return false;
+  std::vector<PulseTable> pulseTables;
+  for (uint64_t i = 0; i < numTables; ++i) {
+    PulseTable table;
+    if (!readString(stream, table.offset) || !readVector(stream, table.times))
+      return false;
+    pulseTables.push_back(std::move(table));
+  }
+  uint64_t numBanks;
+  if (!readValue(stream, numBanks))
+    return false;
+  std::vector<Bank> banks;
+  for (uint64_t i = 0; i < numBanks; ++i) {
+    Bank bank;
+    uint8_t hasWeights, hasIdRange;
+    if (!readString(stream, bank.name) || !readValue(stream, bank.numEvents) ||
+        !readValue(stream, hasWeights) || !readVector(stream, bank.eventIndex) ||
+        !readValue(stream, bank.pulseTable) ||
+        !readValue(stream, hasIdRange) || !readValue(stream, bank.minId) ||
+        !readValue(stream, bank.maxId))
+      return false;
+    bank.hasWeights = hasWeights != 0;
+    bank.hasIdRange = hasIdRange != 0;
+    banks.push_back(std::move(bank));
+  }
+
+  LogSummary logs;
+  uint8_t known, hasProtonCharge;
+  if (!readValue(stream, known) || !readString(stream, logs.entryName) ||
+      !readString(stream, logs.frequencyStart) ||
+      !readValue(stream, hasProtonCharge) ||
+      !readValue(stream, logs.protonCharge))
+    return false;
+  logs.known = known != 0;
+  logs.hasProtonCharge = hasProtonCharge != 0;
+
+  try {
+    setBanks(entryName, std::move(banks), std::move(pulseTables),
+             oldFieldNames != 0);
+  } catch (std::invalid_argument &) {
+    return false;
+  }
+  m_logs = logs;
+  m_modified = false;
+  return true;
+}
+
+} // namespace DataHandling
+} // namespace Mantid
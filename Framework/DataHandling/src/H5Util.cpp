@@ -99,6 +99,19 @@ H5::DataSet writeScalarDataSet<std::string>(Group &group,
 // write methods
 // -------------------------------------------------------------------
 
+/**
+ * Open a file with the same file close degree as the NeXus API, without
+ * which HDF5 refuses to open a file that NeXus holds open.
+ * @param filename :: path of the file
+ * @param flags :: access flags, e.g. H5F_ACC_RDONLY or H5F_ACC_RDWR
+ * @return the open file
+ */
+H5File openFile(const std::string &filename, const unsigned int flags) {
+  FileAccPropList access;
+  access.setFcloseDegree(H5F_CLOSE_STRONG);
+  return H5File(filename, flags, FileCreatPropList::DEFAULT, access);
+}
+
 Group createGroupNXS(H5File &file, const std::string &name,
                      const std::string &nxtype) {
   auto group = file.createGroup(name);
@@ -13,6 +13,7 @@
 #include "MantidDataObjects/Workspace2D.h"
 #include "MantidHistogramData/HistogramMath.h"
 #include "MantidKernel/BoundedValidator.h"
+#include "MantidKernel/CharConv.h"
 #include "MantidKernel/ListValidator.h"
 #include "MantidKernel/UnitFactory.h"
 #include "MantidKernel/VisibleWhenProperty.h"
@@ -20,10 +21,13 @@
 
 // String utilities
 #include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/regex.hpp>
 #include <boost/tokenizer.hpp>
 
+#include <cctype>
 #include <fstream>
+#include <limits>
 
 namespace Mantid {
 namespace DataHandling {
@@ -439,30 +443,30 @@ void LoadAscii2::addToCurrentSpectra(std::list<std::string> &columns) {
   std::vector<double> values(m_baseCols, 0.);
   m_spectraStart = false;
   fillInputValues(values, columns);
-  // add X and Y
-  auto histo = m_curSpectra->histogram();
-  histo.resize(histo.size() + 1);
-
-  histo.mutableX().back() = values[0];
-  histo.mutableY().back() = values[1];
+  // add X and Y, the histogram is set once the spectrum is complete
+  m_curX.push_back(values[0]);
+  m_curY.push_back(values[1]);
 
   // check for E and DX
   switch (m_baseCols) {
   // if only 2 columns X and Y in file, E = 0 is implicit when constructing
   // workspace, omit DX
+  case 2: {
+    m_curE.push_back(0.);
+    break;
+  }
   case 3: {
     // E in file, include it, omit DX
-    histo.mutableE().back() = values[2];
+    m_curE.push_back(values[2]);
     break;
   }
   case 4: {
     // E and DX in file, include both
-    histo.mutableE().back() = values[2];
+    m_curE.push_back(values[2]);
     m_curDx.push_back(values[3]);
     break;
   }
   }
-  m_curSpectra->setHistogram(histo);
   m_curBins++;
 }
 
@@ -514,8 +518,12 @@ void LoadAscii2::newSpectra() {
     }
 
     if (m_curSpectra) {
-      size_t specSize = m_curSpectra->size();
+      size_t specSize = m_curY.size();
       if (specSize > 0 && specSize == m_lastBins) {
+        m_curSpectra->setHistogram(
+            HistogramData::Points(std::move(m_curX)),
+            HistogramData::Counts(std::move(m_curY)),
+            HistogramData::CountStandardDeviations(std::move(m_curE)));
         if (m_curSpectra->x().size() == m_curDx.size())
           m_curSpectra->setPointStandardDeviations(std::move(m_curDx));
         m_spectra.push_back(*m_curSpectra);
@@ -526,6 +534,9 @@ void LoadAscii2::newSpectra() {
     m_curSpectra = Kernel::make_unique<DataObjects::Histogram1D>(
         HistogramData::Histogram::XMode::Points,
         HistogramData::Histogram::YMode::Counts);
+    m_curX.clear();
+    m_curY.clear();
+    m_curE.clear();
     m_curDx.clear();
     m_spectraStart = true;
   }
@@ -579,16 +590,19 @@ void LoadAscii2::fillInputValues(std::vector<double> &values,
                                  const std::list<std::string> &columns) const {
   values.resize(columns.size());
   int i = 0;
-  for (auto value : columns) {
-    boost::trim(value);
-    boost::to_lower(value);
-    if (value == "nan" || value == "1.#qnan") // ignores nans (not a number) and
-                                              // replaces them with a nan
-    {
-      double nan = std::numeric_limits<double>::quiet_NaN(); //(0.0/0.0);
-      values[i] = nan;
-    } else {
-      values[i] = boost::lexical_cast<double>(value);
+  for (const auto &value : columns) {
+    const char *first = value.data();
+    const char *last = first + value.size();
+    while (first != last && std::isspace(static_cast<unsigned char>(*first)))
+      ++first;
+    while (last != first && std::isspace(static_cast<unsigned char>(last[-1])))
+      --last;
+    if (boost::iequals(boost::make_iterator_range(first, last), "1.#qnan")) {
+      // ignores nans (not a number) and replaces them with a nan
+      values[i] = std::numeric_limits<double>::quiet_NaN();
+    } else if (first == last ||
+               Kernel::CharConv::fromChars(first, last, values[i]) != last) {
+      throw boost::bad_lexical_cast();
     }
     ++i;
   }
@@ -8,11 +8,13 @@
 #include "MantidDataHandling/BankPulseTimes.h"
 #include "MantidDataHandling/DefaultEventLoader.h"
 #include "MantidDataHandling/LoadEventNexus.h"
+#include "MantidDataHandling/PartialBankEvents.h"
 #include "MantidDataHandling/ProcessBankData.h"
 #include "MantidKernel/Unit.h"
-#include "MantidKernel/make_unique.h"
 #include "MantidNexus/NexusIOHelper.h"
 
+#include <algorithm>
+
 namespace Mantid {
 namespace DataHandling {
 
@@ -44,10 +46,35 @@ LoadBankFromDiskTask::LoadBankFromDiskTask(
   m_max_id = 0;
 }
 
+/// @return the bank in the index of the file, or null if it is not indexed
+const EventNexusIndex::Bank *LoadBankFromDiskTask::indexedBank() const {
+  const auto &index = m_loader.alg->m_index;
+  return index ? index->bank(entry_name) : nullptr;
+}
+
 /** Load the pulse times, if needed. This sets
  * thisBankPulseTimes to the right pointer.
  * */
 void LoadBankFromDiskTask::loadPulseTimes(::NeXus::File &file) {
+  if (const auto *bank = indexedBank()) {
+    // The pulse times are known from a previous load of the file
+    if (bank->pulseTable == EventNexusIndex::NO_PULSE_TABLE) {
+      thisBankPulseTimes = m_loader.alg->m_allBanksPulseTimes;
+      return;
+    }
+    const auto &table = m_loader.alg->m_index->pulseTables()[bank->pulseTable];
+    for (auto &bankPulseTime : m_loader.m_bankPulseTimes) {
+      if (bankPulseTime->equals(table.times.size(), table.offset)) {
+        thisBankPulseTimes = bankPulseTime;
+        return;
+      }
+    }
+    thisBankPulseTimes = boost::make_shared<BankPulseTimes>(
+        table.offset, table.times, m_framePeriodNumbers);
+    m_loader.m_bankPulseTimes.push_back(thisBankPulseTimes);
+    return;
+  }
+
   try {
     // First, get info about the event_time_zero field in this bank
     file.openData("event_time_zero");
@@ -90,8 +117,14 @@ LoadBankFromDiskTask::loadEventIndex(::NeXus::File &file) {
   // the event list for that pulse) as a uint64 vector.
   // The Nexus standard does not specify if this is to be 32-bit or 64-bit
   // integers, so we use the NeXusIOHelper to do the conversion on the fly.
-  auto event_index =
-      NeXus::NeXusIOHelper::readNexusVector<uint64_t>(file, "event_index");
+  // It is not read again if the index of the file already has it.
+  std::vector<uint64_t> event_index;
+  const auto *bank = indexedBank();
+  if (bank && !bank->eventIndex.empty())
+    event_index = bank->eventIndex;
+  else
+    event_index =
+        NeXus::NeXusIOHelper::readNexusVector<uint64_t>(file, "event_index");
 
   // Look for the sign that the bank is empty
   if (event_index.size() == 1) {
@@ -130,11 +163,19 @@ void LoadBankFromDiskTask::prepareEventId(
   int64_t dim0 = recalculateDataSize(id_info.dims[0]);
   stop_event = dim0;
 
-  // Handle the time filtering by changing the start/end offsets.
-  for (size_t i = 0; i < thisBankPulseTimes->numPulses; i++) {
-    if (thisBankPulseTimes->pulseTimes[i] >= m_loader.alg->filter_time_start) {
-      start_event = static_cast<int64_t>(event_index[i]);
-      break; // stop looking
+  // Handle the time filtering by changing the start/end offsets, so that
+  // only the pulses in the time window are read.
+  const size_t numPulses =
+      std::min(thisBankPulseTimes->numPulses, event_index.size());
+  const auto &filter_time_start = m_loader.alg->filter_time_start;
+  if (filter_time_start != Types::Core::DateAndTime::minimum()) {
+    // If all the pulses are before the window there is nothing to read
+    start_event = dim0;
+    for (size_t i = 0; i < numPulses; i++) {
+      if (thisBankPulseTimes->pulseTimes[i] >= filter_time_start) {
+        start_event = static_cast<int64_t>(event_index[i]);
+        break; // stop looking
+      }
     }
   }
 
@@ -151,13 +192,35 @@ void LoadBankFromDiskTask::prepareEventId(
     start_event = 0;
     stop_event = dim0;
   } else {
-    for (size_t i = 0; i < thisBankPulseTimes->numPulses; i++) {
+    for (size_t i = 0; i < numPulses; i++) {
       if (thisBankPulseTimes->pulseTimes[i] > m_loader.alg->filter_time_stop) {
         stop_event = event_index[i];
         break;
       }
     }
   }
+  // Resuming, only the complete pulses written since the previous load are
+  // read. The writer of the file may still be adding events to the last one,
+  // unless the file is complete.
+  m_resumePulse = 0;
+  if (m_loader.alg->m_resume) {
+    const auto loaded = m_loader.alg->m_loadedPulses.find(entry_name);
+    const size_t firstPulse =
+        loaded == m_loader.alg->m_loadedPulses.end() ? 0 : loaded->second;
+    m_resumePulse = m_loader.alg->m_fileComplete
+                        ? numPulses
+                        : std::max(numPulses, size_t{1}) - 1;
+    if (firstPulse < m_resumePulse) {
+      start_event = static_cast<int64_t>(event_index[firstPulse]);
+      if (m_resumePulse < numPulses)
+        stop_event = static_cast<int64_t>(event_index[m_resumePulse]);
+    } else {
+      m_resumePulse = firstPulse;
+      start_event = stop_event;
+    }
+    start_event = std::min(start_event, stop_event);
+  }
+
   // We are loading part - work out the event number range
   if (m_loader.chunk != EMPTY_INT()) {
     start_event =
@@ -178,18 +241,17 @@ void LoadBankFromDiskTask::prepareEventId(
       << stop_event << "\n";
 }
 
-/** Load the event_id field, which has been opened
+/** Load the event_id field, which has been opened, into the buffers
  * @param file An NeXus::File object opened at the correct group
- * @returns A new array containing the event Ids for this bank
  */
-std::unique_ptr<uint32_t[]>
-LoadBankFromDiskTask::loadEventId(::NeXus::File &file) {
+void LoadBankFromDiskTask::loadEventId(::NeXus::File &file) {
   // This is the data size
   ::NeXus::Info id_info = file.getInfo();
   int64_t dim0 = recalculateDataSize(id_info.dims[0]);
 
-  // Now we allocate the required arrays
-  auto event_id = Mantid::Kernel::make_unique<uint32_t[]>(m_loadSize[0]);
+  // Now we size the reused array
+  auto &event_id = m_buffers->eventId;
+  event_id.resize(m_loadSize[0]);
 
   // Check that the required space is there in the file.
   if (dim0 < m_loadSize[0] + m_loadStart[0]) {
@@ -206,7 +268,7 @@ LoadBankFromDiskTask::loadEventId(::NeXus::File &file) {
   if (!m_loadError) {
     // Must be uint32
     if (id_info.type == ::NeXus::UINT32)
-      file.getSlab(event_id.get(), m_loadStart, m_loadSize);
+      file.getSlab(event_id.data(), m_loadStart, m_loadSize);
     else {
       m_loader.alg->getLogger().warning()
           << "Entry " << entry_name
@@ -224,6 +286,11 @@ LoadBankFromDiskTask::loadEventId(::NeXus::File &file) {
         m_max_id = id;
     }
 
+    // Keep the range of the whole bank for the next loads of the file
+    if (m_loadStart[0] == 0 && m_loadSize[0] == dim0 && m_loadSize[0] > 0 &&
+        m_loader.alg->m_index)
+      m_loader.alg->m_index->setIdRange(entry_name, m_min_id, m_max_id);
+
     if (m_min_id > static_cast<uint32_t>(m_loader.eventid_max)) {
       // All the detector IDs in the bank are higher than the highest 'known'
       // (from the IDF)
@@ -243,17 +310,13 @@ LoadBankFromDiskTask::loadEventId(::NeXus::File &file) {
     if (m_max_id > static_cast<uint32_t>(m_loader.eventid_max))
       m_max_id = static_cast<uint32_t>(m_loader.eventid_max);
   }
-  return event_id;
 }
 
-/** Open and load the times-of-flight data
+/** Open and load the times-of-flight data into the buffers
  * @param file An NeXus::File object opened at the correct group
- * @returns A new array containing the time of flights for this bank
  */
-std::unique_ptr<float[]> LoadBankFromDiskTask::loadTof(::NeXus::File &file) {
-  // Allocate the array
-  auto event_time_of_flight =
-      Mantid::Kernel::make_unique<float[]>(m_loadSize[0]);
+void LoadBankFromDiskTask::loadTof(::NeXus::File &file) {
+  auto &event_time_of_flight = m_buffers->timeOfFlight;
 
   // Get the list of event_time_of_flight's
   std::string key, tof_unit;
@@ -276,39 +339,41 @@ std::unique_ptr<float[]> LoadBankFromDiskTask::loadTof(::NeXus::File &file) {
 
   // The Nexus standard does not specify if event_time_offset should be float or
   // integer, so we use the NeXusIOHelper to perform the conversion to float on
-  // the fly. If the data field already contains floats, the conversion is
-  // skipped.
-  auto vec = NeXus::NeXusIOHelper::readNexusSlab<float>(file, key, m_loadStart,
-                                                        m_loadSize);
+  // the fly. If the data field already contains floats, they are read straight
+  // into the reused array.
+  if (tof_info.type == ::NeXus::FLOAT32) {
+    event_time_of_flight.resize(m_loadSize[0]);
+    file.getSlab(event_time_of_flight.data(), m_loadStart, m_loadSize);
+  } else {
+    const auto vec = NeXus::NeXusIOHelper::readNexusSlab<float>(
+        file, key, m_loadStart, m_loadSize);
+    event_time_of_flight.assign(vec.cbegin(), vec.cend());
+  }
   file.getAttr("units", tof_unit);
   file.closeData();
   // Convert Tof to microseconds
-  Kernel::Units::timeConversionVector(vec, tof_unit, "microseconds");
-  std::copy(vec.begin(), vec.end(), event_time_of_flight.get());
-
-  return event_time_of_flight;
+  Kernel::Units::timeConversionVector(event_time_of_flight, tof_unit,
+                                      "microseconds");
 }
 
-/** Load weight of weigthed events if they exist
+/** Load weight of weigthed events into the buffers if they exist
  * @param file An NeXus::File object opened at the correct group
- * @returns A new array containing the weights or a nullptr if the weights
- * are not present
  */
-std::unique_ptr<float[]>
-LoadBankFromDiskTask::loadEventWeights(::NeXus::File &file) {
+void LoadBankFromDiskTask::loadEventWeights(::NeXus::File &file) {
   try {
     // First, get info about the event_weight field in this bank
     file.openData("event_weight");
   } catch (::NeXus::Exception &) {
     // Field not found error is most likely.
     m_have_weight = false;
-    return std::unique_ptr<float[]>();
+    return;
   }
   // OK, we've got them
   m_have_weight = true;
 
-  // Allocate the array
-  auto event_weight = Mantid::Kernel::make_unique<float[]>(m_loadSize[0]);
+  // Size the reused array
+  auto &event_weight = m_buffers->weight;
+  event_weight.resize(m_loadSize[0]);
 
   ::NeXus::Info weight_info = file.getInfo();
   int64_t weight_dim0 = recalculateDataSize(weight_info.dims[0]);
@@ -321,7 +386,7 @@ LoadBankFromDiskTask::loadEventWeights(::NeXus::File &file) {
 
   // Check that the type is what it is supposed to be
   if (weight_info.type == ::NeXus::FLOAT32)
-    file.getSlab(event_weight.get(), m_loadStart, m_loadSize);
+    file.getSlab(event_weight.data(), m_loadStart, m_loadSize);
   else {
     m_loader.alg->getLogger().warning()
         << "Entry " << entry_name
@@ -332,10 +397,39 @@ LoadBankFromDiskTask::loadEventWeights(::NeXus::File &file) {
   if (!m_loadError) {
     file.closeData();
   }
-  return event_weight;
 }
 
 void LoadBankFromDiskTask::run() {
+  // Open the file
+  ::NeXus::File file(m_loader.alg->m_filename);
+  bool loaded = false;
+  try {
+    // Navigate into the file
+    file.openGroup(m_loader.alg->m_top_entry_name, "NXentry");
+    loaded = readBank(file, boost::make_shared<EventBuffers>());
+  } catch (std::exception &e) {
+    m_loader.alg->getLogger().error()
+        << "Error while loading bank " << entry_name << ":\n";
+    m_loader.alg->getLogger().error() << e.what() << '\n';
+  }
+
+  // Close up the file even if errors occured.
+  file.close();
+
+  // Abort if anything failed
+  if (loaded)
+    scheduleProcessing();
+}
+
+/** Read the events of the bank into buffers.
+ * @param file :: the NeXus file, with the entry group open. The group of the
+ * bank is opened and closed again.
+ * @param buffers :: the buffers to read the events into
+ * @return true if the events were read without error
+ */
+bool LoadBankFromDiskTask::readBank(::NeXus::File &file,
+                                    boost::shared_ptr<EventBuffers> buffers) {
+  m_buffers = std::move(buffers);
   // These give the limits in each file as to which events we actually load
   // (when filtering by time).
   m_loadStart.resize(1, 0);
@@ -346,22 +440,14 @@ void LoadBankFromDiskTask::run() {
 
   prog->report(entry_name + ": load from disk");
 
-  // arrays to load into
-  std::unique_ptr<uint32_t[]> event_id;
-  std::unique_ptr<float[]> event_time_of_flight;
-  std::unique_ptr<float[]> event_weight;
-  std::vector<uint64_t> event_index;
-
-  // Open the file
-  ::NeXus::File file(m_loader.alg->m_filename);
+  bool groupOpened = false;
   try {
-    // Navigate into the file
-    file.openGroup(m_loader.alg->m_top_entry_name, "NXentry");
     // Open the bankN_event group
     file.openGroup(entry_name, entry_type);
+    groupOpened = true;
 
     // Load the event_index field.
-    event_index = this->loadEventIndex(file);
+    m_eventIndex = this->loadEventIndex(file);
 
     if (!m_loadError) {
       // Load and validate the pulse times
@@ -369,7 +455,7 @@ void LoadBankFromDiskTask::run() {
 
       // The event_index should be the same length as the pulse times from DAS
       // logs.
-      if (event_index.size() != thisBankPulseTimes->numPulses)
+      if (m_eventIndex.size() != thisBankPulseTimes->numPulses)
         m_loader.alg->getLogger().warning()
             << "Bank " << entry_name
             << " has a mismatch between the number of event_index entries "
@@ -378,15 +464,24 @@ void LoadBankFromDiskTask::run() {
       // Open and validate event_id field.
       int64_t start_event = 0;
       int64_t stop_event = 0;
-      this->prepareEventId(file, start_event, stop_event, event_index);
+      this->prepareEventId(file, start_event, stop_event, m_eventIndex);
 
       // These are the arguments to getSlab()
       m_loadStart[0] = start_event;
       m_loadSize[0] = stop_event - start_event;
 
-      if ((m_loadSize[0] > 0) && (m_loadStart[0] >= 0)) {
+      if (m_loadSize[0] == 0 && isTimeFiltered()) {
+        // No pulse of the bank is in the time window
+        m_loader.alg->getLogger().debug()
+            << "Bank " << entry_name << " has no events in the time window.\n";
+        m_loadError = true;
+      } else if (m_loadSize[0] == 0 && m_loader.alg->m_resume) {
+        m_loader.alg->getLogger().debug()
+            << "Bank " << entry_name << " has no new events.\n";
+        m_loadError = true;
+      } else if ((m_loadSize[0] > 0) && (m_loadStart[0] >= 0)) {
         // Load pixel IDs
-        event_id = this->loadEventId(file);
+        this->loadEventId(file);
         if (m_loader.alg->getCancel()) {
           m_loader.alg->getLogger().error()
               << "Loading bank " << entry_name << " is cancelled.\n";
@@ -395,9 +490,9 @@ void LoadBankFromDiskTask::run() {
 
         // And TOF.
         if (!m_loadError) {
-          event_time_of_flight = this->loadTof(file);
+          this->loadTof(file);
           if (m_have_weight) {
-            event_weight = this->loadEventWeights(file);
+            this->loadEventWeights(file);
           }
         }
       } // Size is at least 1
@@ -425,15 +520,27 @@ void LoadBankFromDiskTask::run() {
     m_loadError = true;
   }
 
-  // Close up the file even if errors occured.
-  file.closeGroup();
-  file.close();
-
-  // Abort if anything failed
-  if (m_loadError) {
-    return;
+  // Close the bank even if errors occured, leaving the entry open for the
+  // next bank.
+  if (groupOpened) {
+    if (file.isDataSetOpen())
+      file.closeData();
+    file.closeGroup();
   }
 
+  if (m_loadError)
+    m_buffers.reset();
+  // The next load resumes after the pulses read
+  else if (m_loader.alg->m_resume)
+    m_loader.alg->m_loadedPulses.at(entry_name) = m_resumePulse;
+  return !m_loadError;
+}
+
+/** Launch the ProcessBankData tasks that put the events read by readBank()
+ * into the workspace. They share the buffers, which are released when the
+ * last task finishes.
+ */
+void LoadBankFromDiskTask::scheduleProcessing() {
   const auto bank_size = m_max_id - m_min_id;
   const uint32_t minSpectraToLoad =
       static_cast<uint32_t>(m_loader.alg->m_specMin);
@@ -475,13 +582,74 @@ void LoadBankFromDiskTask::run() {
   size_t numEvents = static_cast<size_t>(m_loadSize[0]);
   size_t startAt = static_cast<size_t>(m_loadStart[0]);
 
-  // convert things to shared_arrays to share between tasks
-  boost::shared_array<uint32_t> event_id_shrd(event_id.release());
+  // convert things to shared_arrays to share between tasks. They hold the
+  // buffers until the last task is done with them.
+  auto buffers = std::move(m_buffers);
+  const auto keepBuffers = [buffers](const void *) {};
+  boost::shared_array<uint32_t> event_id_shrd(buffers->eventId.data(),
+                                              keepBuffers);
   boost::shared_array<float> event_time_of_flight_shrd(
-      event_time_of_flight.release());
-  boost::shared_array<float> event_weight_shrd(event_weight.release());
+      buffers->timeOfFlight.data(), keepBuffers);
+  boost::shared_array<float> event_weight_shrd;
+  if (m_have_weight)
+    event_weight_shrd.reset(buffers->weight.data(), keepBuffers);
   auto event_index_shrd =
-      boost::make_shared<std::vector<uint64_t>>(std::move(event_index));
+      boost::make_shared<std::vector<uint64_t>>(std::move(m_eventIndex));
+
+  // Big banks are processed in ranges of pulses, in parallel
+  if (m_loader.eventsPerTask > 0 &&
+      numEvents >= 2 * m_loader.eventsPerTask) {
+    const auto &eventIndex = *event_index_shrd;
+    const auto pulsesBegin = eventIndex.cbegin();
+    auto pulsesEnd = pulsesBegin + std::min(thisBankPulseTimes->numPulses,
+                                            eventIndex.size());
+    // The pulses can only be searched if the index is sorted
+    if (!std::is_sorted(pulsesBegin, pulsesEnd))
+      pulsesEnd = pulsesBegin;
+
+    // Start the ranges at the first event of a pulse
+    const size_t numParts = numEvents / m_loader.eventsPerTask;
+    std::vector<size_t> bounds{0};
+    for (size_t part = 1; part < numParts; ++part) {
+      size_t bound = part * numEvents / numParts;
+      const auto pulse =
+          std::lower_bound(pulsesBegin, pulsesEnd, startAt + bound);
+      if (pulse != pulsesEnd)
+        bound = static_cast<size_t>(*pulse) - startAt;
+      if (bound > bounds.back() && bound < numEvents)
+        bounds.push_back(bound);
+    }
+    bounds.push_back(numEvents);
+
+    if (bounds.size() > 2) {
+      auto partials = boost::make_shared<PartialBankEvents>(
+          m_loader, entry_name, bounds.size() - 1, m_min_id, m_max_id,
+          m_have_weight, scheduler);
+      for (size_t part = 0; part + 1 < bounds.size(); ++part) {
+        const size_t first = bounds[part];
+        // Pulse of the first event, the one before the first pulse after it
+        int firstPulse = 0;
+        if (part > 0 && pulsesEnd != pulsesBegin) {
+          const auto next =
+              std::upper_bound(pulsesBegin, pulsesEnd, startAt + first);
+          firstPulse = std::max(static_cast<int>(next - pulsesBegin) - 1, 0);
+        }
+        boost::shared_array<float> weights;
+        if (m_have_weight)
+          weights.reset(buffers->weight.data() + first, keepBuffers);
+        scheduler.push(new ProcessBankData(
+            m_loader, entry_name, prog,
+            boost::shared_array<uint32_t>(buffers->eventId.data() + first,
+                                          keepBuffers),
+            boost::shared_array<float>(buffers->timeOfFlight.data() + first,
+                                       keepBuffers),
+            bounds[part + 1] - first, startAt + first, event_index_shrd,
+            thisBankPulseTimes, m_have_weight, weights, m_min_id, m_max_id,
+            partials, part, firstPulse));
+      }
+      return;
+    }
+  }
 
   ProcessBankData *newTask1 = new ProcessBankData(
       m_loader, entry_name, prog, event_id_shrd, event_time_of_flight_shrd,
@@ -497,6 +665,13 @@ void LoadBankFromDiskTask::run() {
   }
 }
 
+/// @return true if the events are filtered by pulse time
+bool LoadBankFromDiskTask::isTimeFiltered() const {
+  return m_loader.alg->filter_time_start !=
+             Types::Core::DateAndTime::minimum() ||
+         m_loader.alg->filter_time_stop != Types::Core::DateAndTime::maximum();
+}
+
 /**
  * Interpret the value describing the number of events. If the number is
  * positive return it unchanged.
@@ -11,6 +11,7 @@
 #include "MantidAPI/Run.h"
 #include "MantidAPI/Sample.h"
 #include "MantidDataHandling/DefaultEventLoader.h"
+#include "MantidDataHandling/EventNexusIndex.h"
 #include "MantidDataHandling/EventWorkspaceCollection.h"
 #include "MantidDataHandling/LoadEventNexusIndexSetup.h"
 #include "MantidDataHandling/ParallelEventLoader.h"
@@ -27,6 +28,7 @@
 #include "MantidKernel/Timer.h"
 #include "MantidKernel/UnitFactory.h"
 #include "MantidKernel/VisibleWhenProperty.h"
+#include "MantidNexus/NexusIOHelper.h"
 
 #include <H5Cpp.h>
 #include <boost/function.hpp>
@@ -51,6 +53,37 @@ using namespace API;
 using namespace DataObjects;
 using Types::Core::DateAndTime;
 
+namespace {
+/// Log of a resumable load holding the number of pulses read of each bank
+const std::string LOADED_PULSES_LOG = "loaded_pulses";
+
+/// @return the pulses read of each bank as "bank:pulses" separated by spaces
+std::string formatLoadedPulses(const std::map<std::string, size_t> &pulses) {
+  std::ostringstream out;
+  for (const auto &bank : pulses) {
+    if (bank.first != pulses.begin()->first)
+      out << ' ';
+    out << bank.first << ':' << bank.second;
+  }
+  return out.str();
+}
+
+/// @return the pulses read of each bank from the value of LOADED_PULSES_LOG
+std::map<std::string, size_t> parseLoadedPulses(const std::string &value) {
+  std::map<std::string, size_t> pulses;
+  std::istringstream in(value);
+  std::string bank;
+  while (in >> bank) {
+    const auto colon = bank.rfind(':');
+    if (colon == std::string::npos)
+      throw std::invalid_argument("Invalid " + LOADED_PULSES_LOG + " log '" +
+                                  value + "'");
+    pulses[bank.substr(0, colon)] = std::stoul(bank.substr(colon + 1));
+  }
+  return pulses;
+}
+} // namespace
+
 /**
  * Based on the current group in the file, does the named sub-entry exist?
  * @param file : File handle. This is not modified, but cannot be const
@@ -68,8 +101,10 @@ bool exists(::NeXus::File &file, const std::string &name) {
 LoadEventNexus::LoadEventNexus()
     : filter_tof_min(0), filter_tof_max(0), m_specMin(0), m_specMax(0),
       longest_tof(0), shortest_tof(0), bad_tofs(0), discarded_events(0),
-      compressTolerance(0), m_instrument_loaded_correctly(false),
-      loadlogs(false), event_id_is_spec(false) {}
+      events_read(0), compressTolerance(0), singlePrecisionTof(false),
+      m_resume(false), m_fileComplete(false),
+      m_instrument_loaded_correctly(false), loadlogs(false),
+      event_id_is_spec(false) {}
 
 //----------------------------------------------------------------------------------------------
 /**
@@ -176,6 +211,18 @@ void LoadEventNexus::init() {
                   "This specified the tolerance to use (in microseconds) when "
                   "compressing.");
 
+  declareProperty(make_unique<PropertyWithValue<bool>>(
+                      "SinglePrecisionTof", false, Direction::Input),
+                  "Keep the time-of-flight of the events in single precision "
+                  "and their pulse times in a table for each spectrum "
+                  "(optional, default False). The output workspace then "
+                  "takes about half the memory; the peak memory of the load "
+                  "is unchanged. The file stores times-of-flight in single "
+                  "precision so loading loses nothing, but unit conversions "
+                  "of the workspace are rounded to single precision. "
+                  "Operations other than histogramming and unit conversions "
+                  "convert the events back to double precision.");
+
   auto mustBePositive = boost::make_shared<BoundedValidator<int>>();
   mustBePositive->setLower(1);
   declareProperty("ChunkNumber", EMPTY_INT(), mustBePositive,
@@ -193,6 +240,7 @@ void LoadEventNexus::init() {
   std::string grp3 = "Reduce Memory Use";
   setPropertyGroup("Precount", grp3);
   setPropertyGroup("CompressTolerance", grp3);
+  setPropertyGroup("SinglePrecisionTof", grp3);
   setPropertyGroup("ChunkNumber", grp3);
   setPropertyGroup("TotalChunks", grp3);
 
@@ -286,6 +334,22 @@ void LoadEventNexus::init() {
                                                        true, Direction::Input),
                   "Reads the embedded Instrument XML from the NeXus file "
                   "(optional, default True). ");
+
+  declareProperty(
+      make_unique<PropertyWithValue<bool>>("Resume", false, Direction::Input),
+      "Follow a file that is still being written (optional, default False). "
+      "If the OutputWorkspace exists and was loaded from the same file with "
+      "Resume, only the pulses written since are read and their events are "
+      "added to it. The last pulse of each bank is left for the next load, "
+      "as it may not be complete yet.");
+  declareProperty(make_unique<PropertyWithValue<bool>>("FileComplete", false,
+                                                       Direction::Input),
+                  "The file is no longer written to (optional, default "
+                  "False). Resuming, the last pulse of each bank is read as "
+                  "well, so all the events of the file are loaded.");
+  setPropertySettings("FileComplete",
+                      make_unique<VisibleWhenProperty>("Resume",
+                                                       IS_NOT_DEFAULT));
 }
 
 //----------------------------------------------------------------------------------------------
@@ -363,6 +427,14 @@ void LoadEventNexus::exec() {
   m_filename = getPropertyValue("Filename");
 
   compressTolerance = getProperty("CompressTolerance");
+  singlePrecisionTof = getProperty("SinglePrecisionTof");
+  m_resume = getProperty("Resume");
+  m_fileComplete = getProperty("FileComplete");
+  if (m_resume && (!isDefault("ChunkNumber") ||
+                   !isDefault("FilterByTimeStart") ||
+                   !isDefault("FilterByTimeStop")))
+    throw std::invalid_argument("Resume cannot be used with ChunkNumber, "
+                                "FilterByTimeStart or FilterByTimeStop");
 
   loadlogs = getProperty("LoadLogs");
 
@@ -381,12 +453,24 @@ void LoadEventNexus::exec() {
     reports++;
   Progress prog(this, 0.0, 0.3, reports);
 
+  // The workspace of a previous load gets the events written since
+  m_loadedPulses.clear();
+  EventWorkspace_sptr previous;
+  if (m_resume)
+    previous = workspaceToResume();
+
   // Load the detector events
   m_ws = boost::make_shared<EventWorkspaceCollection>(); // Algorithm currently
                                                          // relies on an
   // object-level workspace ptr
+  if (previous) {
+    // The instrument does not change, it is not loaded again
+    m_ws->setInstrument(previous->getInstrument());
+    m_instrument_loaded_correctly = true;
+  }
   loadEvents(&prog, false); // Do not load monitor blocks
 
+  g_log.information() << events_read << " events were read from the file.\n";
   if (discarded_events > 0) {
     g_log.information() << discarded_events
                         << " events were encountered coming from pixels which "
@@ -398,10 +482,25 @@ void LoadEventNexus::exec() {
   // think)
   filterDuringPause(m_ws->getSingleHeldWorkspace());
 
+  // Only once all the banks are loaded: the loader fills the event vectors of
+  // a spectrum from several banks. Resumed events are switched when appended.
+  if (singlePrecisionTof && !previous)
+    useSinglePrecisionTof();
+
   // add filename
   m_ws->mutableRun().addProperty("Filename", m_filename);
+  // Where the next load resumes from
+  if (m_resume)
+    m_ws->mutableRun().addProperty(LOADED_PULSES_LOG,
+                                   formatLoadedPulses(m_loadedPulses));
   // Save output
-  this->setProperty("OutputWorkspace", m_ws->combinedWorkspace());
+  if (previous) {
+    appendEvents(*previous);
+    this->setProperty("OutputWorkspace",
+                      boost::static_pointer_cast<Workspace>(previous));
+  } else {
+    this->setProperty("OutputWorkspace", m_ws->combinedWorkspace());
+  }
 
   // close the file since LoadNexusMonitors will take care of its own file
   // handle
@@ -414,6 +513,94 @@ void LoadEventNexus::exec() {
   }
 }
 
+/** The output workspace of a previous resumable load of the same file. The
+ * number of pulses it holds of each bank is taken from its logs.
+ * @return the workspace, or a null pointer if there is none to resume
+ */
+EventWorkspace_sptr LoadEventNexus::workspaceToResume() {
+  const std::string outName = getPropertyValue("OutputWorkspace");
+  auto &ads = AnalysisDataService::Instance();
+  if (!ads.doesExist(outName))
+    return nullptr;
+  auto ws = ads.retrieveWS<EventWorkspace>(outName);
+  if (!ws || !ws->run().hasProperty(LOADED_PULSES_LOG) ||
+      !ws->run().hasProperty("Filename") ||
+      ws->run().getPropertyValueAsType<std::string>("Filename") !=
+          m_filename) {
+    g_log.information() << outName << " was not loaded from " << m_filename
+                        << " with Resume. All the events are loaded.\n";
+    return nullptr;
+  }
+  m_loadedPulses = parseLoadedPulses(
+      ws->run().getPropertyValueAsType<std::string>(LOADED_PULSES_LOG));
+  g_log.information() << "Adding the events written since the last load to "
+                      << outName << ".\n";
+  return ws;
+}
+
+/** Add the events just loaded to the workspace of the previous load, and
+ * replace its logs with the ones just read.
+ * @param previous :: the workspace returned by workspaceToResume()
+ */
+void LoadEventNexus::appendEvents(EventWorkspace &previous) {
+  if (m_ws->nPeriods() != 1 ||
+      m_ws->getNumberHistograms() != previous.getNumberHistograms())
+    throw std::runtime_error("Cannot add the new events of " + m_filename +
+                             " to " + previous.getName() +
+                             ", the spectra do not match.");
+  const auto &added = *m_ws->getSingleHeldWorkspace();
+  const size_t numAdded = added.getNumberEvents();
+  const size_t numPrevious = previous.getNumberEvents();
+
+  const auto numHistograms = static_cast<int64_t>(added.getNumberHistograms());
+  PARALLEL_FOR_IF(Kernel::threadSafe(previous))
+  for (int64_t i = 0; i < numHistograms; ++i) {
+    PARALLEL_START_INTERUPT_REGION
+    const auto &events = added.getSpectrum(i);
+    if (events.getNumberEvents() > 0) {
+      auto &el = previous.getSpectrum(i);
+      // The pulses are read in the order of the file, after the ones before
+      const bool sorted = el.getSortType() == DataObjects::PULSETIME_SORT &&
+                          events.getSortType() == DataObjects::PULSETIME_SORT;
+      el += events;
+      if (sorted)
+        el.setSortOrder(DataObjects::PULSETIME_SORT);
+      if (singlePrecisionTof)
+        el.setStorageLayout(DataObjects::SINGLE_PRECISION_LAYOUT);
+    }
+    PARALLEL_END_INTERUPT_REGION
+  }
+  PARALLEL_CHECK_INTERUPT_REGION
+
+  if (numAdded > 0) {
+    const auto &x = added.x(0);
+    if (numPrevious > 0) {
+      const auto &previousX = previous.x(0);
+      previous.setAllX(
+          HistogramData::BinEdges{std::min(x.front(), previousX.front()),
+                                  std::max(x.back(), previousX.back())});
+    } else {
+      previous.setAllX(HistogramData::BinEdges{x.front(), x.back()});
+    }
+  }
+  previous.setSharedRun(m_ws->getSingleHeldWorkspace()->sharedRun());
+  g_log.information() << "Added " << numAdded << " events to the "
+                      << numPrevious << " of " << previous.getName() << ".\n";
+}
+
+/** Keep the time-of-flight of all the loaded events in single precision, in
+ * every period.
+ */
+void LoadEventNexus::useSinglePrecisionTof() {
+  const auto numHistograms = static_cast<int64_t>(m_ws->getNumberHistograms());
+  for (size_t period = 0; period < m_ws->nPeriods(); ++period) {
+    PARALLEL_FOR_IF(Kernel::threadSafe(*m_ws))
+    for (int64_t i = 0; i < numHistograms; ++i)
+      m_ws->getSpectrum(i, period)
+          .setStorageLayout(DataObjects::SINGLE_PRECISION_LAYOUT);
+  }
+}
+
 std::pair<DateAndTime, DateAndTime>
 firstLastPulseTimes(::NeXus::File &file, Kernel::Logger &logger) {
   file.openData("event_time_zero");
@@ -492,7 +679,7 @@ std::size_t numEvents(::NeXus::File &file, bool &hasTotalCounts,
         file.openData("total_counts");
         auto info = file.getInfo();
         file.closeData();
-        if (info.type == NeXus::UINT64) {
+        if (info.type == ::NeXus::UINT64) {
           uint64_t numEvents;
           file.readData("total_counts", numEvents);
           hasTotalCounts = true;
@@ -525,6 +712,51 @@ std::size_t numEvents(::NeXus::File &file, bool &hasTotalCounts,
   return numEvents;
 }
 
+namespace {
+/**
+ * Read the event_index and the pulse times of the currently opened group
+ * into the index of the file.
+ *
+ * @param file The handle to the nexus file opened to the bank.
+ * @param bank The bank to fill.
+ * @param pulseTables The pulse times of the banks indexed so far. The pulse
+ * times of the bank are added unless another bank has the same ones.
+ */
+void indexBank(::NeXus::File &file, EventNexusIndex::Bank &bank,
+               std::vector<EventNexusIndex::PulseTable> &pulseTables) {
+  if (exists(file, "event_index"))
+    bank.eventIndex =
+        NeXus::NeXusIOHelper::readNexusVector<uint64_t>(file, "event_index");
+  if (!exists(file, "event_time_zero"))
+    return;
+
+  // Banks from the same preprocessor share their pulse times, identified by
+  // the offset and the number of pulses as in LoadBankFromDiskTask
+  file.openData("event_time_zero");
+  std::string offset;
+  file.getAttr("offset", offset);
+  const auto dims = file.getInfo().dims;
+  const size_t numPulses = dims.empty() ? 0 : static_cast<size_t>(dims[0]);
+  file.closeData();
+  for (size_t i = 0; i < pulseTables.size(); ++i) {
+    if (pulseTables[i].offset == offset &&
+        pulseTables[i].times.size() == numPulses) {
+      bank.pulseTable = static_cast<int64_t>(i);
+      return;
+    }
+  }
+
+  const BankPulseTimes pulses(file, std::vector<int>());
+  EventNexusIndex::PulseTable table;
+  table.offset = offset;
+  table.times.reserve(pulses.numPulses);
+  for (size_t i = 0; i < pulses.numPulses; ++i)
+    table.times.push_back(pulses.pulseTimes[i].totalNanoseconds());
+  bank.pulseTable = static_cast<int64_t>(pulseTables.size());
+  pulseTables.push_back(std::move(table));
+}
+} // namespace
+
 /** Load the instrument from the nexus file
  *
  * @param nexusfilename :: The name of the nexus file being loaded
@@ -669,8 +901,9 @@ void LoadEventNexus::loadEvents(API::Progress *const prog,
   // The run_start will be loaded from the pulse times.
   DateAndTime run_start(0, 0);
   bool takeTimesFromEvents = false;
-  // Initialize the counter of bad TOFs
+  // Initialize the counters of bad TOFs and of events read
   bad_tofs = 0;
+  events_read = 0;
   int nPeriods = 1;
   auto periodLog = make_unique<const TimeSeriesProperty<int>>("period_log");
   if (loadlogs) {
@@ -759,7 +992,42 @@ void LoadEventNexus::loadEvents(API::Progress *const prog,
   bool hasTotalCounts(true);
   bool haveWeights = false;
   auto firstPulseT = DateAndTime::maximum();
-  for (; it != entries.end(); ++it) {
+
+  // The index kept from a previous load of the file lists the banks without
+  // opening them
+  if (!monitors) {
+    try {
+      m_index = EventNexusIndex::open(m_filename);
+    } catch (std::exception &e) {
+      g_log.information() << "Not using an index of the file: " << e.what()
+                          << '\n';
+      m_index.reset();
+    }
+  }
+  const bool indexed = m_index && m_index->hasBanks(m_top_entry_name);
+  // Without an index, the one built by listing the banks
+  std::vector<EventNexusIndex::Bank> indexBanks;
+  std::vector<EventNexusIndex::PulseTable> indexPulseTables;
+  bool indexing = m_index && !indexed;
+
+  if (indexed) {
+    g_log.information() << "Taking the banks from the index of the file.\n";
+    oldNeXusFileNames = m_index->oldFieldNames();
+    const auto &pulseTables = m_index->pulseTables();
+    for (const auto &bank : m_index->banks()) {
+      bankNames.push_back(bank.name);
+      bankNumEvents.push_back(bank.numEvents);
+      haveWeights = haveWeights || bank.hasWeights;
+      if (takeTimesFromEvents) {
+        if (bank.pulseTable == EventNexusIndex::NO_PULSE_TABLE)
+          throw std::runtime_error(
+              "No event time zeros. Cannot establish run start or end");
+        const auto &times = pulseTables[bank.pulseTable].times;
+        firstPulseT = std::min(firstPulseT, DateAndTime(times.front()));
+      }
+    }
+  }
+  for (; !indexed && it != entries.end(); ++it) {
     std::string entry_name(it->first);
     std::string entry_class(it->second);
 
@@ -781,15 +1049,40 @@ void LoadEventNexus::loadEvents(API::Progress *const prog,
       bankNumEvents.push_back(num);
 
       // Look for weights in simulated file
+      bool bankHasWeights = false;
       if (exists(*m_file, "event_weight")) {
         m_file->openData("event_weight");
         haveWeights = true;
+        bankHasWeights = true;
         m_file->closeData();
       }
 
+      if (indexing) {
+        EventNexusIndex::Bank bank;
+        bank.name = entry_name;
+        bank.numEvents = num;
+        bank.hasWeights = bankHasWeights;
+        try {
+          indexBank(*m_file, bank, indexPulseTables);
+          indexBanks.push_back(std::move(bank));
+        } catch (std::exception &e) {
+          // The file is loaded as usual, only not indexed
+          g_log.information() << "Cannot index bank " << entry_name << ": "
+                              << e.what() << '\n';
+          indexing = false;
+          if (m_file->isDataSetOpen())
+            m_file->closeData();
+        }
+      }
+
       m_file->closeGroup();
     }
   }
+  if (indexing)
+    m_index->setBanks(m_top_entry_name, std::move(indexBanks),
+                      std::move(indexPulseTables), oldNeXusFileNames);
+  else if (!indexed)
+    m_index.reset();
   if (takeTimesFromEvents)
     run_start = firstPulseT;
 
@@ -850,6 +1143,8 @@ void LoadEventNexus::loadEvents(API::Progress *const prog,
     m_ws->setAllX(axis);
 
     createSpectraMapping(m_filename, monitors, std::vector<std::string>());
+    if (m_index && m_index->isModified())
+      m_index->save();
     return;
   }
 
@@ -914,7 +1209,10 @@ void LoadEventNexus::loadEvents(API::Progress *const prog,
   longest_tof = 0.;
 
   bool loaded{false};
-  auto loaderType = defineLoaderType(haveWeights, oldNeXusFileNames, classType);
+  // Only the default loader can resume
+  auto loaderType =
+      m_resume ? LoaderType::DEFAULT
+               : defineLoaderType(haveWeights, oldNeXusFileNames, classType);
   if (loaderType != LoaderType::DEFAULT) {
     auto ws = m_ws->getSingleHeldWorkspace();
     m_file->close();
@@ -967,11 +1265,17 @@ void LoadEventNexus::loadEvents(API::Progress *const prog,
     bool precount = getProperty("Precount");
     int chunk = getProperty("ChunkNumber");
     int totalChunks = getProperty("TotalChunks");
+    // Banks not read before start at the first pulse
+    for (const auto &bankName : bankNames)
+      m_loadedPulses.emplace(bankName, 0);
     DefaultEventLoader::load(this, *m_ws, haveWeights, event_id_is_spec,
                              bankNames, periodLog->valuesAsVector(), classType,
                              bankNumEvents, oldNeXusFileNames, precount, chunk,
                              totalChunks);
   }
+  // Keep the banks found and the ranges of event IDs read for the next load
+  if (m_index && m_index->isModified())
+    m_index->save();
 
   // Info reporting
   const std::size_t eventsLoaded = m_ws->getNumberEvents();
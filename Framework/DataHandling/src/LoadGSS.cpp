@@ -18,10 +18,14 @@
 #include "MantidGeometry/Instrument/CompAssembly.h"
 #include "MantidGeometry/Instrument/Component.h"
 #include "MantidGeometry/Instrument/Detector.h"
+#include "MantidKernel/CharConv.h"
 #include "MantidKernel/UnitFactory.h"
 
 #include <Poco/File.h>
 #include <boost/regex.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -41,6 +45,37 @@ const boost::regex DET_POS_REG_EXP{"^#.+flight path\\s+([0-9.]+).+"
                                    "tth\\s+([0-9.]+).+"
                                    "DIFC\\s+([0-9.]+)"};
 const boost::regex L1_REG_EXP{"^#.+flight path\\s+([0-9.]+)\\s*m"};
+
+/**
+ * Read a number, after any whitespace, as a stream would
+ * @param first :: where to start reading, moved past the number
+ * @param last :: the end of the text
+ * @return the number, or 0 if there is none
+ */
+double readValue(const char *&first, const char *last) {
+  while (first != last && std::isspace(static_cast<unsigned char>(*first)))
+    ++first;
+  double value = 0.;
+  const char *end = CharConv::fromChars(first, last, value);
+  // Like a stream that failed, nothing more is read from the text
+  first = (end == first) ? last : end;
+  return value;
+}
+
+/**
+ * Read a number from a column of fixed width of a line
+ * @param line :: the line
+ * @param lineEnd :: the end of the line
+ * @param start :: the position of the column
+ * @param width :: the width of the column
+ * @return the number, or 0 if there is none
+ */
+double readColumn(const char *line, const char *lineEnd, const size_t start,
+                  const size_t width) {
+  const auto length = static_cast<size_t>(lineEnd - line);
+  const char *first = line + std::min(start, length);
+  return readValue(first, line + std::min(start + width, length));
+}
 } // end of anonymous namespace
 
 //----------------------------------------------------------------------------------------------
@@ -348,28 +383,20 @@ API::MatrixWorkspace_sptr LoadGSS::loadGSASFile(const std::string &filename,
         // std::setw
         // For this reason we need to read the column values as string and then
         // convert to double
-        {
-          std::string str(currentLine, 15);
-          std::istringstream istr(str);
-          istr >> xValue;
-        }
-        {
-          std::string str(currentLine + 15, 18);
-          std::istringstream istr(str);
-          istr >> yValue;
-        }
-        {
-          std::string str(currentLine + 15 + 18, 18);
-          std::istringstream istr(str);
-          istr >> eValue;
-        }
+        const char *lineEnd = currentLine + std::strlen(currentLine);
+        xValue = readColumn(currentLine, lineEnd, 0, 15);
+        yValue = readColumn(currentLine, lineEnd, 15, 18);
+        eValue = readColumn(currentLine, lineEnd, 15 + 18, 18);
 
         xValue = (2 * xValue) - xPrev;
 
       } else if (filetype == 's') {
         // SLOG
-        std::istringstream inputLine(currentLine, std::ios::in);
-        inputLine >> xValue >> yValue >> eValue;
+        const char *first = currentLine;
+        const char *lineEnd = currentLine + std::strlen(currentLine);
+        xValue = readValue(first, lineEnd);
+        yValue = readValue(first, lineEnd);
+        eValue = readValue(first, lineEnd);
         if (calslogx0) {
           // calculation of x0 must use the x'[0]
           g_log.debug() << "x'_0 = " << xValue << "  bc3 = " << bc3 << '\n';
@@ -24,6 +24,7 @@
 #include "MantidKernel/ListValidator.h"
 //#include "MantidKernel/LogParser.h"
 #include "MantidKernel/LogFilter.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/TimeSeriesProperty.h"
 #include "MantidKernel/UnitFactory.h"
 
@@ -784,6 +785,17 @@ void LoadISISNexus2::checkOverlappingSpectraRange() {
   }
 }
 
+namespace {
+/// Upper limit of the memory used by one slab of detector counts
+constexpr size_t SLAB_MEMORY = 64 * 1024 * 1024;
+
+/// @return the number of spectra read from the file in one go
+int64_t slabSize(const size_t numChannels) {
+  const size_t spectrumSize = std::max(numChannels, size_t{1}) * sizeof(int);
+  return static_cast<int64_t>(std::max(SLAB_MEMORY / spectrumSize, size_t{1}));
+}
+} // namespace
+
 /**
  * Load a given period into the workspace
  * @param period :: The period number to load (starting from 1)
@@ -832,7 +844,7 @@ void LoadISISNexus2::loadPeriodData(
       // When reading in blocks we need to be careful that the range is exactly
       // divisible by the block-size
       // and if not have an extra read of the left overs
-      const int64_t blocksize = 8;
+      const int64_t blocksize = slabSize(m_detBlockInfo.getNumberOfChannels());
       const int64_t rangesize = spectraBlock.last - spectraBlock.first + 1;
       const int64_t fullblocks = rangesize / blocksize;
       int64_t spectra_no = spectraBlock.first;
@@ -895,15 +907,26 @@ void LoadISISNexus2::loadBlock(NXDataSetTyped<int> &data, int64_t blocksize,
                                DataObjects::Workspace2D_sptr &local_workspace) {
   data.load(static_cast<int>(blocksize), static_cast<int>(period),
             static_cast<int>(start)); // TODO this is just wrong
-  int *data_start = data();
-  int *data_end = data_start + m_loadBlockInfo.getNumberOfChannels();
+  const int *const block = data();
+  const auto numChannels =
+      static_cast<int64_t>(m_detBlockInfo.getNumberOfChannels());
+  const auto numCounts =
+      static_cast<int64_t>(m_loadBlockInfo.getNumberOfChannels());
+  const int64_t first(hist);
+  // The spectra of the slab are independent, the bin edges are shared
+  PARALLEL_FOR_IF(Kernel::threadSafe(*local_workspace))
+  for (int64_t i = 0; i < blocksize; ++i) {
+    PARALLEL_START_INTERUPT_REGION
+    const int *const counts = block + i * numChannels;
+    local_workspace->setHistogram(first + i, BinEdges(m_tof_data),
+                                  Counts(counts, counts + numCounts));
+    PARALLEL_END_INTERUPT_REGION
+  }
+  PARALLEL_CHECK_INTERUPT_REGION
+  m_progress->reportIncrement(static_cast<size_t>(blocksize), "Loading data");
+
   int64_t final(hist + blocksize);
   while (hist < final) {
-    m_progress->report("Loading data");
-    local_workspace->setHistogram(hist, BinEdges(m_tof_data),
-                                  Counts(data_start, data_end));
-    data_start += m_detBlockInfo.getNumberOfChannels();
-    data_end += m_detBlockInfo.getNumberOfChannels();
     if (m_load_selected_spectra) {
       // local_workspace->getAxis(1)->setValue(hist,
       // static_cast<specnum_t>(spec_num));
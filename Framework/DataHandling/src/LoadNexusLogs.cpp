@@ -7,6 +7,7 @@
 #include "MantidDataHandling/LoadNexusLogs.h"
 #include "MantidAPI/FileProperty.h"
 #include "MantidAPI/Run.h"
+#include "MantidDataHandling/EventNexusIndex.h"
 #include "MantidKernel/ArrayProperty.h"
 #include "MantidKernel/TimeSeriesProperty.h"
 #include <locale>
@@ -236,40 +237,30 @@ void LoadNexusLogs::exec() {
                                 "' is not a valid NXentry");
   }
 
-  /// Use frequency start for Monitor19 and Special1_19 logs with "No Time" for
-  /// SNAP
-  try {
-    file.openPath("DASlogs");
+  // The index of the file may have the summary of the logs from a previous
+  // load. It only applies if the logs of the file replace the existing ones.
+  std::unique_ptr<EventNexusIndex> index;
+  const bool overwriteLogs = getProperty("OverwriteLogs");
+  if (overwriteLogs) {
     try {
-      file.openGroup("frequency", "NXlog");
-      try {
-        file.openData("time");
-
-        //----- Start time is an ISO8601 string date and time. ------
-        try {
-          file.getAttr("start", freqStart);
-
-        } catch (::NeXus::Exception &) {
-          // Some logs have "offset" instead of start
-          try {
-            file.getAttr("offset", freqStart);
-          } catch (::NeXus::Exception &) {
-            g_log.warning() << "Log entry has no start time indicated.\n";
-            file.closeData();
-            throw;
-          }
-        }
-        file.closeData();
-      } catch (::NeXus::Exception &) {
-        // No time. This is not an SNS SNAP file
-      }
-      file.closeGroup();
-    } catch (::NeXus::Exception &) {
-      // No time. This is not an SNS frequency group
+      index = EventNexusIndex::open(filename);
+    } catch (std::exception &e) {
+      g_log.information() << "Not using an index of the file: " << e.what()
+                          << '\n';
     }
-    file.closeGroup();
-  } catch (::NeXus::Exception &) {
-    // No time. This is not an SNS group
+  }
+  const bool indexed = index && index->logs().known &&
+                       index->logs().entryName == entry_name;
+  EventNexusIndex::LogSummary summary;
+  if (indexed)
+    summary = index->logs();
+
+  /// Use frequency start for Monitor19 and Special1_19 logs with "No Time" for
+  /// SNAP
+  if (indexed) {
+    freqStart = summary.frequencyStart;
+  } else {
+    readFrequencyStart(file);
   }
 
   readStartAndEndTime(file, workspace->mutableRun());
@@ -363,7 +354,10 @@ void LoadNexusLogs::exec() {
     }
   }
 
-  if (!workspace->run().hasProperty("gd_prtn_chrg")) {
+  if (!workspace->run().hasProperty("gd_prtn_chrg") && indexed &&
+      summary.hasProtonCharge) {
+    workspace->mutableRun().setProtonCharge(summary.protonCharge);
+  } else if (!workspace->run().hasProperty("gd_prtn_chrg")) {
     // Try pulling it from the main proton_charge entry first
     try {
       file.openData("proton_charge");
@@ -385,10 +379,62 @@ void LoadNexusLogs::exec() {
         // Ignore not found property error.
       }
     }
+    if (workspace->run().hasProperty("gd_prtn_chrg")) {
+      summary.hasProtonCharge = true;
+      summary.protonCharge = workspace->run().getProtonCharge();
+    }
   }
 
   // Close the file
   file.close();
+
+  if (index && !indexed) {
+    summary.entryName = entry_name;
+    summary.frequencyStart = freqStart;
+    index->setLogs(summary);
+    index->save();
+  }
+}
+
+/** Read the start of the frequency log, used for the Monitor19 and
+ * Special1_19 logs with "No Time" of SNAP.
+ *
+ * @param file :: open nexus file at the NXentry
+ */
+void LoadNexusLogs::readFrequencyStart(::NeXus::File &file) {
+  try {
+    file.openPath("DASlogs");
+    try {
+      file.openGroup("frequency", "NXlog");
+      try {
+        file.openData("time");
+
+        //----- Start time is an ISO8601 string date and time. ------
+        try {
+          file.getAttr("start", freqStart);
+
+        } catch (::NeXus::Exception &) {
+          // Some logs have "offset" instead of start
+          try {
+            file.getAttr("offset", freqStart);
+          } catch (::NeXus::Exception &) {
+            g_log.warning() << "Log entry has no start time indicated.\n";
+            file.closeData();
+            throw;
+          }
+        }
+        file.closeData();
+      } catch (::NeXus::Exception &) {
+        // No time. This is not an SNS SNAP file
+      }
+      file.closeGroup();
+    } catch (::NeXus::Exception &) {
+      // No time. This is not an SNS frequency group
+    }
+    file.closeGroup();
+  } catch (::NeXus::Exception &) {
+    // No time. This is not an SNS group
+  }
 }
 
 /** Try to load the "Veto_pulse" field in DASLogs
@@ -5,6 +5,9 @@
 //     & Institut Laue - Langevin
 // SPDX - License - Identifier: GPL - 3.0 +
 #include "MantidDataHandling/LoadNexusProcessed.h"
+#include "MantidDataHandling/ChunkedDeflate.h"
+#include "MantidDataHandling/H5Util.h"
+#include "MantidDataHandling/NexusHistogramSource.h"
 #include "MantidAPI/AlgorithmFactory.h"
 #include "MantidAPI/AlgorithmManager.h"
 #include "MantidAPI/BinEdgeAxis.h"
@@ -17,6 +20,7 @@
 #include "MantidAPI/WorkspaceGroup.h"
 #include "MantidAPI/WorkspaceHistory.h"
 #include "MantidDataObjects/EventWorkspace.h"
+#include "MantidDataObjects/LazyWorkspace2D.h"
 #include "MantidDataObjects/Peak.h"
 #include "MantidDataObjects/PeakNoShapeFactory.h"
 #include "MantidDataObjects/PeakShapeEllipsoidFactory.h"
@@ -33,6 +37,7 @@
 #include "MantidNexus/NexusClasses.h"
 #include "MantidNexus/NexusFileIO.h"
 
+#include <H5Cpp.h>
 #include <boost/lexical_cast.hpp>
 #include <boost/regex.hpp>
 #include <boost/shared_array.hpp>
@@ -168,6 +173,34 @@ bool isMultiPeriodFile(int nWorkspaceEntries, Workspace_sptr sampleWS,
   }
   return isMultiPeriod;
 }
+
+/**
+ * Load one of the fields holding the events of an event_workspace.
+ * Fields written in compressed chunks are inflated on all the threads.
+ * @param wksp_cls :: the event_workspace group
+ * @param events :: the same group opened with HDF5, or nullptr
+ * @param name :: name of the field
+ * @return the values of the field, or null if there is no such field
+ */
+template <typename NumT>
+boost::shared_array<NumT> loadEventField(NXData &wksp_cls, H5::Group *events,
+                                         const std::string &name) {
+  if (!wksp_cls.isValid(name))
+    return boost::shared_array<NumT>();
+  if (events) {
+    auto dataset = events->openDataSet(name);
+    if (ChunkedDeflate::isChunkedDeflate(dataset)) {
+      const auto length =
+          static_cast<size_t>(dataset.getSpace().getSimpleExtentNpoints());
+      boost::shared_array<NumT> values(new NumT[length]);
+      ChunkedDeflate::readArray1D(dataset, values.get(), length);
+      return values;
+    }
+  }
+  NXDataSetTyped<NumT> data = wksp_cls.openNXDataSet<NumT>(name);
+  data.load();
+  return data.sharedBuffer();
+}
 } // namespace
 
 /// Default constructor
@@ -235,6 +268,15 @@ void LoadNexusProcessed::init() {
       "For multiperiod workspaces. Copy instrument, parameter and x-data "
       "rather than loading it directly for each workspace. Y, E and log "
       "information is always loaded.");
+  declareProperty("LazyLoading", false,
+                  "If true, the histograms of a Workspace2D are read from the "
+                  "file when they are first accessed, and those that were "
+                  "not modified are dropped again when they use more than "
+                  "LazyMemoryBudget. The file must stay available while the "
+                  "workspace exists.");
+  declareProperty("LazyMemoryBudget", 256, mustBePositive,
+                  "Memory in MB that the histograms of a lazily loaded "
+                  "workspace may use, excluding those that were modified.");
 }
 
 /**
@@ -665,34 +707,25 @@ LoadNexusProcessed::loadEventEntry(NXData &wksp_cls, NXDouble &xbins,
 
   // Handle optional fields.
   // TODO: Handle inconsistent sizes
-  boost::shared_array<int64_t> pulsetimes;
-  if (wksp_cls.isValid("pulsetime")) {
-    NXDataSetTyped<int64_t> pulsetime =
-        wksp_cls.openNXDataSet<int64_t>("pulsetime");
-    pulsetime.load();
-    pulsetimes = pulsetime.sharedBuffer();
-  }
-
-  boost::shared_array<double> tofs;
-  if (wksp_cls.isValid("tof")) {
-    NXDouble tof = wksp_cls.openNXDouble("tof");
-    tof.load();
-    tofs = tof.sharedBuffer();
-  }
-
-  boost::shared_array<float> error_squareds;
-  if (wksp_cls.isValid("error_squared")) {
-    NXFloat error_squared = wksp_cls.openNXFloat("error_squared");
-    error_squared.load();
-    error_squareds = error_squared.sharedBuffer();
-  }
-
-  boost::shared_array<float> weights;
-  if (wksp_cls.isValid("weight")) {
-    NXFloat weight = wksp_cls.openNXFloat("weight");
-    weight.load();
-    weights = weight.sharedBuffer();
+  std::unique_ptr<H5::H5File> h5File;
+  std::unique_ptr<H5::Group> events;
+  if (ChunkedDeflate::isAvailable()) {
+    try {
+      H5::Exception::dontPrint();
+      h5File = make_unique<H5::H5File>(
+          H5Util::openFile(getPropertyValue("Filename"), H5F_ACC_RDONLY));
+      events = make_unique<H5::Group>(h5File->openGroup(wksp_cls.path()));
+    } catch (H5::Exception &) {
+      // Not an HDF5 file: everything is read through NeXus
+      events.reset();
+    }
   }
+  auto pulsetimes =
+      loadEventField<int64_t>(wksp_cls, events.get(), "pulsetime");
+  auto tofs = loadEventField<double>(wksp_cls, events.get(), "tof");
+  auto error_squareds =
+      loadEventField<float>(wksp_cls, events.get(), "error_squared");
+  auto weights = loadEventField<float>(wksp_cls, events.get(), "weight");
 
   // What type of event lists?
   EventType type = TOF;
@@ -1244,9 +1277,6 @@ API::MatrixWorkspace_sptr LoadNexusProcessed::loadNonEventEntry(
   size_t nspectra = data.dim0();
   // process optional spectrum parameters, if set
   checkOptionalProperties(nspectra);
-  // Actual number of spectra in output workspace (if only a range was going
-  // to be loaded)
-  size_t total_specs = calculateWorkspaceSize(nspectra);
 
   //// Create the 2D workspace for the output
   bool hasFracArea = false;
@@ -1256,11 +1286,24 @@ API::MatrixWorkspace_sptr LoadNexusProcessed::loadNonEventEntry(
     workspaceType.clear();
     workspaceType = "RebinnedOutput";
   }
+  // Only plain Workspace2Ds are loaded lazily
+  const bool lazyLoading = getProperty("LazyLoading");
+  bool lazy = lazyLoading && workspaceType == "Workspace2D";
+
+  // Actual number of spectra in output workspace (if only a range was going
+  // to be loaded)
+  m_filtered_spec_idxs.clear();
+  size_t total_specs = calculateWorkspaceSize(nspectra, lazy);
 
-  API::MatrixWorkspace_sptr local_workspace =
-      boost::dynamic_pointer_cast<API::MatrixWorkspace>(
-          WorkspaceFactory::Instance().create(workspaceType, total_specs,
-                                              xlength, nchannels));
+  API::MatrixWorkspace_sptr local_workspace;
+  if (lazy)
+    local_workspace = createLazyWorkspace(wksp_cls, xlength, nchannels);
+  if (!local_workspace) {
+    lazy = false;
+    local_workspace = boost::dynamic_pointer_cast<API::MatrixWorkspace>(
+        WorkspaceFactory::Instance().create(workspaceType, total_specs, xlength,
+                                            nchannels));
+  }
   try {
     local_workspace->setTitle(mtd_entry.getString("title"));
   } catch (std::runtime_error &) {
@@ -1276,6 +1319,10 @@ API::MatrixWorkspace_sptr LoadNexusProcessed::loadNonEventEntry(
   local_workspace->setYUnitLabel(unitLabel);
 
   readBinMasking(wksp_cls, local_workspace);
+  // The histograms of a lazy workspace are read when they are accessed
+  if (lazy)
+    return local_workspace;
+
   NXDataSetTyped<double> errors = wksp_cls.openNXDouble("errors");
   NXDataSetTyped<double> fracarea = errors;
   if (hasFracArea) {
@@ -2145,6 +2192,43 @@ void LoadNexusProcessed::checkOptionalProperties(
   }
 }
 
+/**
+ * Create a workspace whose histograms are read from the file when they are
+ * first accessed, for the spectra in m_filtered_spec_idxs.
+ *
+ * @param wksp_cls :: Nexus data for "workspace"
+ * @param xlength :: Number of X values in each spectrum
+ * @param nchannels :: Number of Y values in each spectrum
+ *
+ * @return the workspace, or a null pointer if the file cannot be read with
+ * HDF5
+ */
+API::MatrixWorkspace_sptr
+LoadNexusProcessed::createLazyWorkspace(NXData &wksp_cls, const int xlength,
+                                        const int nchannels) {
+  std::vector<size_t> rows;
+  rows.reserve(m_filtered_spec_idxs.size());
+  for (const auto spectrum : m_filtered_spec_idxs)
+    rows.push_back(static_cast<size_t>(spectrum - 1));
+  const size_t numberOfSpectra = rows.size();
+
+  std::unique_ptr<NexusHistogramSource> source;
+  try {
+    H5::Exception::dontPrint();
+    source = make_unique<NexusHistogramSource>(getPropertyValue("Filename"),
+                                               wksp_cls.path(), std::move(rows));
+  } catch (H5::Exception &) {
+    g_log.warning("LazyLoading needs an HDF5 file. The data is loaded now.\n");
+    return nullptr;
+  }
+
+  const int memoryBudget = getProperty("LazyMemoryBudget");
+  auto workspace = boost::make_shared<LazyWorkspace2D>(
+      std::move(source), static_cast<size_t>(memoryBudget) * 1024 * 1024);
+  workspace->initialize(numberOfSpectra, xlength, nchannels);
+  return workspace;
+}
+
 /**
  * Calculate the size of a workspace
  *
@@ -166,6 +166,41 @@ bool ISISRAW2::readData(FILE *file, int i) {
   return true;
 }
 
+/// Size of the compressed data of a spectrum
+/// @param i :: The index of the spectrum, counting all the periods
+/// @return the number of bytes, 0 if there is no such spectrum
+int ISISRAW2::compressedSize(int i) const {
+  return i < ndes ? 4 * ddes[i].nwords : 0;
+}
+
+/// Read the compressed data of consecutive spectra in one go
+/// @param file :: The file pointer, at the start of the first spectrum
+/// @param first :: The index of the first spectrum
+/// @param count :: The number of spectra to read
+/// @param buffer :: Set to the compressed data of the spectra, one after the
+/// other
+/// @return true on success
+bool ISISRAW2::readCompressedData(FILE *file, int first, int count,
+                                  std::vector<char> &buffer) {
+  if (first + count > ndes)
+    return false;
+  size_t size = 0;
+  for (int i = first; i < first + count; ++i)
+    size += static_cast<size_t>(compressedSize(i));
+  buffer.resize(size);
+  return fread(buffer.data(), sizeof(char), size, file) == size;
+}
+
+/// Expand the compressed data of a spectrum. It does not use the buffers of
+/// this object, so several spectra can be expanded at the same time.
+/// @param compressed :: The compressed data of the spectrum
+/// @param i :: The index of the spectrum
+/// @param counts :: Set to the t_ntc1 + 1 counts of the spectrum
+void ISISRAW2::expandData(char *compressed, int i, uint32_t *counts) const {
+  byte_rel_expn(compressed, compressedSize(i), 0,
+                reinterpret_cast<int *>(counts), t_ntc1 + 1);
+}
+
 ISISRAW2::~ISISRAW2() {
   // fclose(m_file);
   if (outbuff)
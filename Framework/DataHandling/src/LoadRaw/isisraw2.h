@@ -8,6 +8,7 @@
 #define ISISRAW2_H
 
 #include "isisraw.h"
+#include <vector>
 
 /// isis raw file.
 //  isis raw
@@ -20,6 +21,10 @@ public:
 
   void skipData(FILE *file, int i);
   bool readData(FILE *file, int i);
+  int compressedSize(int i) const;
+  bool readCompressedData(FILE *file, int first, int count,
+                          std::vector<char> &buffer);
+  void expandData(char *compressed, int i, uint32_t *counts) const;
   void clear();
 
   int ndes; ///< ndes
@@ -17,6 +17,7 @@
 #include "MantidKernel/BoundedValidator.h"
 #include "MantidKernel/ConfigService.h"
 #include "MantidKernel/ListValidator.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/UnitFactory.h"
 
 #include <Poco/Path.h>
@@ -205,18 +206,20 @@ void LoadRaw3::exec() {
     }
   }
 
-  // Loop over the number of periods in the raw file, putting each period in a
-  // separate workspace
-
+  // Create the workspaces of the periods in the raw file, each period goes in
+  // a separate workspace. Their spectra are read afterwards in a single pass
+  // over the file and are filled in parallel, whatever their period.
+  struct PeriodWorkspaces {
+    int period;
+    DataObjects::Workspace2D_sptr ws;
+    DataObjects::Workspace2D_sptr mws;
+  };
+  std::vector<PeriodWorkspaces> periods;
+  std::vector<SpectrumTarget> targets;
   for (int period = 0; period < m_numberOfPeriods; ++period) {
-    // skipping the first spectra in each period
-    skipData(file, static_cast<int>(period * (m_numberOfSpectra + 1)));
-
     // check for excluded periods
-    if (!isPeriodIncluded(period)) {
-      skipPeriod(file, period);
+    if (!isPeriodIncluded(period))
       continue;
-    }
 
     if (period > firstPeriod) {
       if (localWorkspace) {
@@ -259,16 +262,18 @@ void LoadRaw3::exec() {
       } // end of if loop for loadlogfiles
     }
 
-    if (bexcludeMonitors) {
-      excludeMonitors(file, period, monitorSpecList, localWorkspace);
-    }
-    if (bincludeMonitors) {
-      includeMonitors(file, period, localWorkspace);
-    }
-    if (bseparateMonitors) {
-      separateMonitors(file, period, monitorSpecList, localWorkspace,
-                       monitorWorkspace);
-    }
+    // Monitors are only listed if they are excluded or separated
+    addTargets(period, monitorSpecList, bseparateMonitors, localWorkspace,
+               monitorWorkspace, targets);
+    periods.push_back({period, localWorkspace, monitorWorkspace});
+  }
+
+  readSpectra(file, targets);
+
+  for (auto &periodWorkspaces : periods) {
+    const int period = periodWorkspaces.period;
+    localWorkspace = periodWorkspaces.ws;
+    monitorWorkspace = periodWorkspaces.mws;
 
     // Re-update spectra etc.
     if (localWorkspace)
@@ -292,170 +297,106 @@ void LoadRaw3::exec() {
       } else {
         setWorkspaceProperty(localWorkspace, ws_grp, period, false, this);
       }
-      // progress for workspace groups
-      setProg(static_cast<double>(period) /
-              static_cast<double>(m_numberOfPeriods - 1));
     }
-
   } // loop over periods
   // Clean up
 
   reset();
   fclose(file);
 }
-/** This method creates outputworkspace excluding monitors
- *@param file :: -pointer to file
- *@param period :: period number
- *@param monitorList :: a list containing the spectrum numbers for monitors
- *@param ws_sptr :: shared pointer to workspace
- */
-void LoadRaw3::excludeMonitors(FILE *file, const int &period,
-                               const std::vector<specnum_t> &monitorList,
-                               DataObjects::Workspace2D_sptr ws_sptr) {
-  int64_t histCurrent = -1;
-  int64_t wsIndex = 0;
-  double histTotal = static_cast<double>(m_total_specs * m_numberOfPeriods);
-  // loop through the spectra
-  for (specnum_t i = 1; i <= m_numberOfSpectra; ++i) {
-    specnum_t histToRead = i + period * (m_numberOfSpectra + 1);
-    if ((i >= m_spec_min && i < m_spec_max) ||
-        (m_list && find(m_spec_list.begin(), m_spec_list.end(), i) !=
-                       m_spec_list.end())) {
-      progress(m_prog, "Reading raw file data...");
-      // skip monitor spectrum
-      if (isMonitor(monitorList, i)) {
-        skipData(file, histToRead);
-        continue;
-      }
-
-      // read spectrum
-      if (!readData(file, histToRead)) {
-        throw std::runtime_error("Error reading raw file");
-      }
-      // set the workspace data
-      setWorkspaceData(ws_sptr, m_timeChannelsVec, wsIndex, i, m_noTimeRegimes,
-                       m_lengthIn, 1);
-      // increment workspace index
-      ++wsIndex;
-
-      if (m_numberOfPeriods == 1) {
-        if (++histCurrent % 100 == 0) {
-          setProg(static_cast<double>(histCurrent) / histTotal);
-        }
-        interruption_point();
-      }
-
-    } // end of if loop for spec min,max check
-    else {
-      skipData(file, histToRead);
-    }
-  } // end of for loop
-}
-
-/**This method creates outputworkspace including monitors
- *@param file :: -pointer to file
+/** Adds the spectra of a period to read to the list of targets
  *@param period :: period number
+ *@param monitorList :: a list containing the spectrum numbers for monitors,
+ *empty if the monitors are included in the output workspace
+ *@param separateMonitors :: true if the monitors go to the monitor workspace,
+ *false if they are excluded
  *@param ws_sptr :: shared pointer to workspace
+ *@param mws_sptr :: shared pointer to monitor workspace
+ *@param targets :: the list the spectra are added to
  */
-void LoadRaw3::includeMonitors(FILE *file, const int64_t &period,
-                               DataObjects::Workspace2D_sptr ws_sptr) {
-
-  int64_t histCurrent = -1;
+void LoadRaw3::addTargets(const int period,
+                          const std::vector<specnum_t> &monitorList,
+                          const bool separateMonitors,
+                          DataObjects::Workspace2D_sptr ws_sptr,
+                          DataObjects::Workspace2D_sptr mws_sptr,
+                          std::vector<SpectrumTarget> &targets) {
   int64_t wsIndex = 0;
-  double histTotal = static_cast<double>(m_total_specs * m_numberOfPeriods);
+  int64_t mwsIndex = 0;
   // loop through spectra
   for (specnum_t i = 1; i <= m_numberOfSpectra; ++i) {
-    int64_t histToRead = i + period * (m_numberOfSpectra + 1);
-    if ((i >= m_spec_min && i < m_spec_max) ||
-        (m_list && find(m_spec_list.begin(), m_spec_list.end(), i) !=
-                       m_spec_list.end())) {
-      progress(m_prog, "Reading raw file data...");
-
-      // read spectrum from raw file
-      if (!readData(file, histToRead)) {
-        throw std::runtime_error("Error reading raw file");
-      }
-      // set workspace data
-      setWorkspaceData(ws_sptr, m_timeChannelsVec, wsIndex, i, m_noTimeRegimes,
-                       m_lengthIn, 1);
-      ++wsIndex;
-
-      if (m_numberOfPeriods == 1) {
-        if (++histCurrent % 100 == 0) {
-          setProg(double(histCurrent) / histTotal);
-        }
-        interruption_point();
-      }
-
+    const int histToRead = i + period * (m_numberOfSpectra + 1);
+    if (!((i >= m_spec_min && i < m_spec_max) ||
+          (m_list && find(m_spec_list.begin(), m_spec_list.end(), i) !=
+                         m_spec_list.end())))
+      continue;
+    if (isMonitor(monitorList, i)) {
+      // skip the monitor spectrum unless the monitors are separated
+      if (separateMonitors)
+        targets.push_back({histToRead, i, mws_sptr, mwsIndex++});
     } else {
-      skipData(file, histToRead);
+      targets.push_back({histToRead, i, ws_sptr, wsIndex++});
     }
   }
-  // loadSpectra(file,period,m_total_specs,ws_sptr,m_timeChannelsVec);
 }
 
-/** This method separates monitors and creates two outputworkspaces
- *@param file :: -pointer to file
- *@param period :: period number
- *@param monitorList :: -a list containing the spectrum numbers for monitors
- *@param ws_sptr :: -shared pointer to workspace
- *@param mws_sptr :: -shared pointer to monitor workspace
+/** Reads the spectra of the targets and sets their data. The spectra that
+ * follow each other in the file are read in large chunks, whose spectra are
+ * expanded and set in parallel.
+ *@param file :: -pointer to file, at the start of the first spectrum
+ *@param targets :: the spectra to read, in the order of the file
  */
-
-void LoadRaw3::separateMonitors(FILE *file, const int64_t &period,
-                                const std::vector<specnum_t> &monitorList,
-                                DataObjects::Workspace2D_sptr ws_sptr,
-                                DataObjects::Workspace2D_sptr mws_sptr) {
-  int64_t histCurrent = -1;
-  int64_t wsIndex = 0;
-  int64_t mwsIndex = 0;
-  double histTotal = static_cast<double>(m_total_specs * m_numberOfPeriods);
-  // loop through spectra
-  for (specnum_t i = 1; i <= m_numberOfSpectra; ++i) {
-    int64_t histToRead = i + period * (m_numberOfSpectra + 1);
-    if ((i >= m_spec_min && i < m_spec_max) ||
-        (m_list && find(m_spec_list.begin(), m_spec_list.end(), i) !=
-                       m_spec_list.end())) {
-      progress(m_prog, "Reading raw file data...");
-
-      // read spectrum from raw file
-      if (!readData(file, histToRead)) {
-        throw std::runtime_error("Error reading raw file");
-      }
-      // if this a monitor  store that spectrum to monitor workspace
-      if (isMonitor(monitorList, i)) {
-        setWorkspaceData(mws_sptr, m_timeChannelsVec, mwsIndex, i,
-                         m_noTimeRegimes, m_lengthIn, 1);
-        ++mwsIndex;
-      } else {
-        // not a monitor,store the spectrum to normal output workspace
-        setWorkspaceData(ws_sptr, m_timeChannelsVec, wsIndex, i,
-                         m_noTimeRegimes, m_lengthIn, 1);
-        ++wsIndex;
-      }
-
-      if (m_numberOfPeriods == 1) {
-        if (++histCurrent % 100 == 0) {
-          setProg(static_cast<double>(histCurrent) / histTotal);
-        }
-        interruption_point();
-      }
-
-    } else {
-      skipData(file, histToRead);
+void LoadRaw3::readSpectra(FILE *file,
+                           const std::vector<SpectrumTarget> &targets) {
+  // Compressed bytes read at once
+  const size_t chunkSize = 16 * 1024 * 1024;
+  auto &raw = isisRaw();
+  const double histTotal = static_cast<double>(targets.size());
+  std::vector<char> buffer;
+  std::vector<size_t> offsets;
+  // Index of the spectrum at the position of the file
+  int position = 0;
+  for (size_t first = 0; first < targets.size();) {
+    // Skip the spectra before the first one of the chunk
+    long skip = 0;
+    for (; position < targets[first].hist; ++position)
+      skip += raw.compressedSize(position);
+    if (skip > 0 && fseek(file, skip, SEEK_CUR) != 0)
+      throw std::runtime_error("Error reading raw file");
+
+    // Take the spectra that follow in the file, up to the size of a chunk
+    offsets.assign(1, 0);
+    size_t last = first;
+    do {
+      offsets.push_back(offsets.back() +
+                        raw.compressedSize(targets[last].hist));
+      ++last;
+    } while (last < targets.size() &&
+             targets[last].hist == targets[last - 1].hist + 1 &&
+             offsets.back() < chunkSize);
+
+    const int count = static_cast<int>(last - first);
+    progress(m_prog, "Reading raw file data...");
+    if (!raw.readCompressedData(file, position, count, buffer)) {
+      throw std::runtime_error("Error reading raw file");
     }
-  }
-}
+    position += count;
+
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int i = 0; i < count; ++i) {
+      PARALLEL_START_INTERUPT_REGION
+      const auto &target = targets[first + i];
+      std::vector<uint32_t> counts(m_lengthIn);
+      raw.expandData(buffer.data() + offsets[i], target.hist, counts.data());
+      setWorkspaceData(target.ws, m_timeChannelsVec, target.wsIndex,
+                       target.specNo, m_noTimeRegimes, m_lengthIn, 1,
+                       counts.data());
+      PARALLEL_END_INTERUPT_REGION
+    }
+    PARALLEL_CHECK_INTERUPT_REGION
 
-/**
- * Skip all spectra in a period.
- * @param file :: -pointer to file
- * @param period :: period number
- */
-void LoadRaw3::skipPeriod(FILE *file, const int64_t &period) {
-  for (specnum_t i = 1; i <= m_numberOfSpectra; ++i) {
-    int64_t histToRead = i + period * (m_numberOfSpectra + 1);
-    skipData(file, histToRead);
+    first = last;
+    setProg(static_cast<double>(first) / histTotal);
+    interruption_point();
   }
 }
 
@@ -406,12 +406,34 @@ void LoadRawHelper::setWorkspaceData(
         &timeChannelsVec,
     int64_t wsIndex, specnum_t nspecNum, int64_t noTimeRegimes,
     int64_t lengthIn, int64_t binStart) {
+  setWorkspaceData(newWorkspace, timeChannelsVec, wsIndex, nspecNum,
+                   noTimeRegimes, lengthIn, binStart, isisRaw().dat1);
+}
+
+/** This method sets counts read from the raw file to workspace vectors. It
+ * does not use the buffers of the raw file, so different spectra can be set
+ * at the same time.
+ *  @param newWorkspace ::  shared pointer to the  workspace
+ *  @param timeChannelsVec ::  vector holding the X data
+ *  @param  wsIndex  variable used for indexing the output workspace
+ *  @param  nspecNum  spectrum number
+ *  @param noTimeRegimes ::   regime no.
+ *  @param lengthIn :: length of the workspace
+ *  @param binStart :: start of bin
+ *  @param counts :: the expanded counts of the spectrum
+ */
+void LoadRawHelper::setWorkspaceData(
+    DataObjects::Workspace2D_sptr newWorkspace,
+    const std::vector<boost::shared_ptr<HistogramData::HistogramX>>
+        &timeChannelsVec,
+    int64_t wsIndex, specnum_t nspecNum, int64_t noTimeRegimes,
+    int64_t lengthIn, int64_t binStart, const uint32_t *counts) {
   if (!newWorkspace)
     return;
 
   // But note that the last (overflow) bin is kept
   auto &Y = newWorkspace->mutableY(wsIndex);
-  Y.assign(isisRaw().dat1 + binStart, isisRaw().dat1 + lengthIn);
+  Y.assign(counts + binStart, counts + lengthIn);
   // Fill the vector for the errors, containing sqrt(count)
   newWorkspace->setCountVariances(wsIndex, Y.rawData());
 
@@ -430,10 +452,12 @@ void LoadRawHelper::setWorkspaceData(
   if (noTimeRegimes < 2)
     newWorkspace->setX(wsIndex, timeChannelsVec[0]);
   else {
-
-    // Use std::vector::at just incase spectrum missing from spec array
-    newWorkspace->setX(wsIndex,
-                       timeChannelsVec.at(m_specTimeRegimes[nspecNum] - 1));
+    // Use std::vector::at just incase spectrum missing from spec array. The
+    // map is not changed, as spectra may be set in parallel.
+    const auto regime = m_specTimeRegimes.find(nspecNum);
+    const int64_t regimeNumber =
+        regime == m_specTimeRegimes.end() ? 0 : regime->second;
+    newWorkspace->setX(wsIndex, timeChannelsVec.at(regimeNumber - 1));
   }
 }
 
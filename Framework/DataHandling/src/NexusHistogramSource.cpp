@@ -0,0 +1,104 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataHandling/NexusHistogramSource.h"
+#include "MantidDataHandling/H5Util.h"
+#include "MantidKernel/make_unique.h"
+
+#include <H5Cpp.h>
+
+namespace Mantid {
+namespace DataHandling {
+
+using HistogramData::Histogram;
+using Kernel::make_cow;
+using Kernel::make_unique;
+
+namespace {
+/// @return the dimensions of a dataset of rank 1 or 2
+std::vector<hsize_t> dimensions(H5::DataSet &dataset) {
+  auto space = dataset.getSpace();
+  std::vector<hsize_t> dims(space.getSimpleExtentNdims());
+  space.getSimpleExtentDims(dims.data());
+  return dims;
+}
+
+/// Read the first length values of a row of a 2D dataset
+std::vector<double> readRow(H5::DataSet &dataset, const size_t row,
+                            const size_t length) {
+  std::vector<double> values(length);
+  auto fileSpace = dataset.getSpace();
+  const hsize_t start[2] = {row, 0};
+  const hsize_t count[2] = {1, length};
+  fileSpace.selectHyperslab(H5S_SELECT_SET, count, start);
+  H5::DataSpace memorySpace(1, &count[1]);
+  dataset.read(values.data(), H5::PredType::NATIVE_DOUBLE, memorySpace,
+               fileSpace);
+  return values;
+}
+} // namespace
+
+/**
+ * @param filename :: The processed NeXus file
+ * @param groupPath :: Path of the workspace group, e.g.
+ * "/mantid_workspace_1/workspace"
+ * @param rows :: Row in the file of each histogram, in the order of the
+ * workspace indices
+ * @throws H5::Exception if the file cannot be read
+ */
+NexusHistogramSource::NexusHistogramSource(const std::string &filename,
+                                           const std::string &groupPath,
+                                           std::vector<size_t> rows)
+    : m_file(make_unique<H5::H5File>(
+          H5Util::openFile(filename, H5F_ACC_RDONLY))),
+      m_rows(std::move(rows)) {
+  auto group = m_file->openGroup(groupPath);
+  m_values = make_unique<H5::DataSet>(group.openDataSet("values"));
+  m_errors = make_unique<H5::DataSet>(group.openDataSet("errors"));
+  m_x = make_unique<H5::DataSet>(group.openDataSet("axis1"));
+  if (H5Lexists(group.getId(), "xerrors", H5P_DEFAULT) > 0)
+    m_dx = make_unique<H5::DataSet>(group.openDataSet("xerrors"));
+
+  m_blocksize = static_cast<size_t>(dimensions(*m_values).back());
+  const auto xDims = dimensions(*m_x);
+  m_xLength = static_cast<size_t>(xDims.back());
+  m_xMode = HistogramData::getHistogramXMode(m_xLength, m_blocksize);
+  if (xDims.size() == 1)
+    m_sharedX = make_cow<HistogramData::HistogramX>(
+        H5Util::readArray1DCoerce<double>(*m_x));
+
+  m_yMode = Histogram::YMode::Counts;
+  if (m_x->attrExists("distribution") &&
+      H5Util::readAttributeAsString(*m_x, "distribution") == "1")
+    m_yMode = Histogram::YMode::Frequencies;
+}
+
+NexusHistogramSource::~NexusHistogramSource() = default;
+
+/**
+ * Read a histogram from the file
+ * @param index :: Workspace index of the histogram
+ * @return the histogram
+ */
+Histogram NexusHistogramSource::histogram(const size_t index) {
+  const size_t row = m_rows[index];
+  Histogram histogram(m_xMode, m_yMode);
+  histogram.setX(m_sharedX ? m_sharedX
+                           : make_cow<HistogramData::HistogramX>(
+                                 readRow(*m_x, row, m_xLength)));
+  histogram.setSharedY(make_cow<HistogramData::HistogramY>(
+      readRow(*m_values, row, m_blocksize)));
+  histogram.setSharedE(make_cow<HistogramData::HistogramE>(
+      readRow(*m_errors, row, m_blocksize)));
+  // Legacy files have one X uncertainty per bin edge, the last one is dropped
+  if (m_dx)
+    histogram.setSharedDx(make_cow<HistogramData::HistogramDx>(
+        readRow(*m_dx, row, m_blocksize)));
+  return histogram;
+}
+
+} // namespace DataHandling
+} // namespace Mantid
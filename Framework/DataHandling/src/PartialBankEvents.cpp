@@ -0,0 +1,173 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataHandling/PartialBankEvents.h"
+#include "MantidDataHandling/DefaultEventLoader.h"
+#include "MantidDataHandling/LoadEventNexus.h"
+#include "MantidKernel/Task.h"
+#include "MantidKernel/ThreadScheduler.h"
+
+namespace Mantid {
+namespace DataHandling {
+
+namespace {
+/// Appends the partial event lists of a range of pixels to the workspace
+class MergeTask : public Kernel::Task {
+public:
+  MergeTask(boost::shared_ptr<PartialBankEvents> partials, const detid_t first,
+            const detid_t last, const double cost)
+      : m_partials(std::move(partials)), m_first(first), m_last(last) {
+    m_cost = cost;
+  }
+  void run() override { m_partials->merge(m_first, m_last); }
+
+private:
+  boost::shared_ptr<PartialBankEvents> m_partials;
+  detid_t m_first;
+  detid_t m_last;
+};
+} // namespace
+
+/**
+ * @param loader :: the loader holding the event lists of the workspace
+ * @param bankName :: the name of the bank, for logging
+ * @param numParts :: the number of ranges of pulses the bank is split into
+ * @param minId :: the smallest pixel ID processed
+ * @param maxId :: the largest pixel ID processed
+ * @param weighted :: true if the events have weights
+ * @param scheduler :: the scheduler the merge tasks are pushed to
+ */
+PartialBankEvents::PartialBankEvents(DefaultEventLoader &loader,
+                                     std::string bankName,
+                                     const size_t numParts,
+                                     const detid_t minId, const detid_t maxId,
+                                     const bool weighted,
+                                     Kernel::ThreadScheduler &scheduler)
+    : m_loader(loader), m_bankName(std::move(bankName)), m_numParts(numParts),
+      m_numPeriods(loader.m_ws.nPeriods()), m_minId(minId), m_maxId(maxId),
+      m_weighted(weighted), m_scheduler(scheduler), m_partsLeft(numParts) {
+  const size_t size =
+      m_numParts * m_numPeriods * static_cast<size_t>(m_maxId - m_minId + 1);
+  if (m_weighted)
+    m_weightedEvents.resize(size);
+  else
+    m_events.resize(size);
+}
+
+/// @return the position of the partial event list of a pixel
+size_t PartialBankEvents::index(const size_t part, const int periodIndex,
+                                const detid_t id) const {
+  return (part * m_numPeriods + static_cast<size_t>(periodIndex)) *
+             static_cast<size_t>(m_maxId - m_minId + 1) +
+         static_cast<size_t>(id - m_minId);
+}
+
+/**
+ * @param part :: the range of pulses
+ * @param periodIndex :: the index of the period of the events
+ * @param id :: the pixel ID, between the smallest and largest ID processed
+ * @return the partial list of the events of the pixel, or nullptr if the
+ * workspace has no event list for the pixel
+ */
+std::vector<Types::Event::TofEvent> *
+PartialBankEvents::eventVector(const size_t part, const int periodIndex,
+                               const detid_t id) {
+  if (!m_loader.eventVectors[periodIndex][id])
+    return nullptr;
+  return &m_events[index(part, periodIndex, id)];
+}
+
+/// @copydoc eventVector
+std::vector<DataObjects::WeightedEvent> *
+PartialBankEvents::weightedEventVector(const size_t part,
+                                       const int periodIndex,
+                                       const detid_t id) {
+  if (!m_loader.weightedEventVectors[periodIndex][id])
+    return nullptr;
+  return &m_weightedEvents[index(part, periodIndex, id)];
+}
+
+/** Called by the task of each part when it is done. The last one schedules
+ * the merge of the partial lists, in as many tasks as there are parts.
+ */
+void PartialBankEvents::partDone() {
+  if (--m_partsLeft > 0)
+    return;
+  const auto numIds = static_cast<size_t>(m_maxId - m_minId + 1);
+  const size_t numTasks = std::min(m_numParts, numIds);
+  size_t numEvents = 0;
+  for (const auto &events : m_events)
+    numEvents += events.size();
+  for (const auto &events : m_weightedEvents)
+    numEvents += events.size();
+  const double cost =
+      static_cast<double>(numEvents) / static_cast<double>(numTasks);
+  for (size_t i = 0; i < numTasks; ++i) {
+    const auto first = m_minId + static_cast<detid_t>(i * numIds / numTasks);
+    const auto last =
+        m_minId + static_cast<detid_t>((i + 1) * numIds / numTasks) - 1;
+    m_scheduler.push(new MergeTask(shared_from_this(), first, last, cost));
+  }
+}
+
+/** Append the events of one pixel of all the parts, in order, to the event
+ * list of the workspace, and free the partial lists.
+ * @return the number of events appended
+ */
+template <class T>
+size_t PartialBankEvents::mergeVectors(
+    std::vector<std::vector<T>> &parts,
+    const std::vector<std::vector<std::vector<T> *>> &targets,
+    const detid_t id) {
+  size_t numEvents = 0;
+  for (size_t period = 0; period < m_numPeriods; ++period) {
+    auto *target = targets[period][id];
+    if (!target)
+      continue;
+    size_t size = target->size();
+    for (size_t part = 0; part < m_numParts; ++part)
+      size += parts[index(part, static_cast<int>(period), id)].size();
+    if (size == target->size())
+      continue;
+    numEvents += size - target->size();
+    target->reserve(size);
+    for (size_t part = 0; part < m_numParts; ++part) {
+      auto &events = parts[index(part, static_cast<int>(period), id)];
+      target->insert(target->end(), events.cbegin(), events.cend());
+      std::vector<T>().swap(events);
+    }
+  }
+  return numEvents;
+}
+
+/** Merge the partial event lists of a range of pixels into the workspace,
+ * and compress the events if the algorithm asks for it.
+ * @param first :: the first pixel ID
+ * @param last :: the last pixel ID, inclusive
+ */
+void PartialBankEvents::merge(const detid_t first, const detid_t last) {
+  auto *alg = m_loader.alg;
+  const bool compress = (alg->compressTolerance >= 0);
+  const auto &pixelToIndex = m_loader.pixelID_to_wi_vector;
+  for (detid_t id = first; id <= last; ++id) {
+    const size_t numEvents =
+        m_weighted
+            ? mergeVectors(m_weightedEvents, m_loader.weightedEventVectors, id)
+            : mergeVectors(m_events, m_loader.eventVectors, id);
+    if (!compress || numEvents == 0)
+      continue;
+    const detid_t offsetId = id + m_loader.pixelID_to_wi_offset;
+    if (offsetId < 0 || offsetId >= static_cast<detid_t>(pixelToIndex.size()))
+      throw std::runtime_error("Error finding workspace index; pixelID " +
+                               std::to_string(id) + " of bank " + m_bankName +
+                               " is out of range");
+    auto &el = m_loader.m_ws.getSpectrum(pixelToIndex[offsetId]);
+    el.compressEvents(alg->compressTolerance, &el);
+  }
+}
+
+} // namespace DataHandling
+} // namespace Mantid
@@ -7,6 +7,7 @@
 #include "MantidDataHandling/ProcessBankData.h"
 #include "MantidDataHandling/DefaultEventLoader.h"
 #include "MantidDataHandling/LoadEventNexus.h"
+#include "MantidDataHandling/PartialBankEvents.h"
 
 using namespace Mantid::DataObjects;
 
@@ -20,7 +21,8 @@ ProcessBankData::ProcessBankData(
     size_t startAt, boost::shared_ptr<std::vector<uint64_t>> event_index,
     boost::shared_ptr<BankPulseTimes> thisBankPulseTimes, bool have_weight,
     boost::shared_array<float> event_weight, detid_t min_event_id,
-    detid_t max_event_id)
+    detid_t max_event_id, boost::shared_ptr<PartialBankEvents> partials,
+    size_t part, int firstPulse)
     : Task(), m_loader(m_loader), entry_name(entry_name),
       pixelID_to_wi_vector(m_loader.pixelID_to_wi_vector),
       pixelID_to_wi_offset(m_loader.pixelID_to_wi_offset), prog(prog),
@@ -28,7 +30,8 @@ ProcessBankData::ProcessBankData(
       numEvents(numEvents), startAt(startAt), event_index(event_index),
       thisBankPulseTimes(thisBankPulseTimes), have_weight(have_weight),
       event_weight(event_weight), m_min_id(min_event_id),
-      m_max_id(max_event_id) {
+      m_max_id(max_event_id), m_partials(std::move(partials)), m_part(part),
+      m_firstPulse(firstPulse) {
   // Cost is approximately proportional to the number of events to process.
   m_cost = static_cast<double>(numEvents);
 }
@@ -44,12 +47,14 @@ void ProcessBankData::run() { // override {
   // A count of "bad" TOFs that were too high
   size_t badTofs = 0;
   size_t my_discarded_events(0);
+  Kernel::Timer timer;
 
-  prog->report(entry_name + ": precount");
+  reportProgress(entry_name + ": precount");
   // ---- Pre-counting events per pixel ID ----
+  // The events of a split bank are only counted when they are merged
   auto &outputWS = m_loader.m_ws;
   auto *alg = m_loader.alg;
-  if (m_loader.precount) {
+  if (m_loader.precount && !m_partials) {
 
     std::vector<size_t> counts(m_max_id - m_min_id + 1, 0);
     for (size_t i = 0; i < numEvents; i++) {
@@ -89,7 +94,7 @@ void ProcessBankData::run() { // override {
   bool pulsetimesincreasing = true;
 
   // Index into the pulse array
-  int pulse_i = 0;
+  int pulse_i = m_firstPulse;
 
   // And there are this many pulses
   int numPulses = static_cast<int>(thisBankPulseTimes->numPulses);
@@ -102,11 +107,19 @@ void ProcessBankData::run() { // override {
     // This'll make the code skip looking for any pulse times.
     pulse_i = numPulses + 1;
   }
+  if (pulse_i > 0 && pulse_i < numPulses) {
+    // Events of a later range of pulses of the bank
+    pulsetime = thisBankPulseTimes->pulseTimes[pulse_i];
+    const int logPeriodNumber = thisBankPulseTimes->periodNumbers[pulse_i];
+    periodNumber = logPeriodNumber > 0 ? logPeriodNumber : periodNumber;
+    periodIndex = periodNumber - 1;
+    lastpulsetime = pulsetime;
+  }
 
-  prog->report(entry_name + ": filling events");
+  reportProgress(entry_name + ": filling events");
 
-  // Will we need to compress?
-  bool compress = (alg->compressTolerance >= 0);
+  // Will we need to compress? Split banks are compressed when merged.
+  bool compress = (alg->compressTolerance >= 0) && !m_partials;
 
   // Which detector IDs were touched? - only matters if compress is on
   std::vector<bool> usedDetIds;
@@ -162,7 +175,10 @@ void ProcessBankData::run() { // override {
         if (have_weight) {
           double weight = static_cast<double>(event_weight[i]);
           double errorSq = weight * weight;
-          auto *eventVector = m_loader.weightedEventVectors[periodIndex][detId];
+          auto *eventVector =
+              m_partials
+                  ? m_partials->weightedEventVector(m_part, periodIndex, detId)
+                  : m_loader.weightedEventVectors[periodIndex][detId];
           // NULL eventVector indicates a bad spectrum lookup
           if (eventVector) {
             eventVector->emplace_back(tof, pulsetime, weight, errorSq);
@@ -171,7 +187,9 @@ void ProcessBankData::run() { // override {
           }
         } else {
           // We have cached the vector of events for this detector ID
-          auto *eventVector = m_loader.eventVectors[periodIndex][detId];
+          auto *eventVector =
+              m_partials ? m_partials->eventVector(m_part, periodIndex, detId)
+                         : m_loader.eventVectors[periodIndex][detId];
           // NULL eventVector indicates a bad spectrum lookup
           if (eventVector) {
             eventVector->emplace_back(tof, pulsetime);
@@ -221,7 +239,7 @@ void ProcessBankData::run() { // override {
       }
     }
   }
-  prog->report(entry_name + ": filled events");
+  reportProgress(entry_name + ": filled events");
 
   alg->getLogger().debug() << entry_name
                            << (pulsetimesincreasing ? " had "
@@ -240,14 +258,26 @@ void ProcessBankData::run() { // override {
     }
     alg->bad_tofs += badTofs;
     alg->discarded_events += my_discarded_events;
+    alg->events_read += numEvents;
+    m_loader.m_processTime += timer.elapsed_no_reset();
   }
 
+  // The last range of pulses of a split bank schedules the merge
+  if (m_partials)
+    m_partials->partDone();
+
 #ifndef _WIN32
   alg->getLogger().debug() << "Time to process " << entry_name << " " << m_timer
                            << "\n";
 #endif
 } // END-OF-RUN()
 
+/// Report progress, once per bank for a bank that is split
+void ProcessBankData::reportProgress(const std::string &message) {
+  if (m_part == 0)
+    prog->report(message);
+}
+
 /**
  * Get the workspace index for a given pixel ID. Throws if the pixel ID is
  * not in the expected range.
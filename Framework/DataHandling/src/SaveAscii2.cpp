@@ -4,7 +4,9 @@
 //     NScD Oak Ridge National Laboratory, European Spallation Source
 //     & Institut Laue - Langevin
 // SPDX - License - Identifier: GPL - 3.0 +
+#include <algorithm>
 #include <fstream>
+#include <numeric>
 #include <set>
 
 #include "MantidAPI/FileProperty.h"
@@ -15,6 +17,7 @@
 #include "MantidKernel/ArrayProperty.h"
 #include "MantidKernel/BoundedValidator.h"
 #include "MantidKernel/ListValidator.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/UnitConversion.h"
 #include "MantidKernel/UnitFactory.h"
 #include "MantidKernel/VectorHelper.h"
@@ -31,10 +34,16 @@ DECLARE_ALGORITHM(SaveAscii2)
 using namespace Kernel;
 using namespace API;
 
+namespace {
+/// Number of values formatted in parallel before they are written
+constexpr size_t BATCH_VALUES = 1 << 22;
+} // namespace
+
 /// Empty constructor
 SaveAscii2::SaveAscii2()
     : m_separatorIndex(), m_nBins(0), m_sep(), m_writeDX(false),
-      m_writeID(false), m_isCommonBins(false), m_ws() {}
+      m_writeID(false), m_isCommonBins(false), m_precision(6),
+      m_floatFormat(CharConv::FloatFormat::General), m_ws() {}
 
 /// Initialisation method.
 void SaveAscii2::init() {
@@ -246,13 +255,10 @@ void SaveAscii2::exec() {
   }
   // Set the number precision
   int prec = getProperty("Precision");
-  if (prec != EMPTY_INT()) {
-    file.precision(prec);
-  }
+  m_precision = (prec != EMPTY_INT()) ? prec : 6;
   bool scientific = getProperty("ScientificFormat");
-  if (scientific) {
-    file << std::scientific;
-  }
+  m_floatFormat = scientific ? CharConv::FloatFormat::Scientific
+                             : CharConv::FloatFormat::General;
   if (writeHeader) {
     file << comment << " X " << m_sep << " Y " << m_sep << " E";
     if (m_writeDX) {
@@ -264,60 +270,73 @@ void SaveAscii2::exec() {
   if (!m_metaData.empty()) {
     populateAllMetaData();
   }
+  std::vector<int> indices(idx.begin(), idx.end());
   if (idx.empty()) {
-    Progress progress(this, 0.0, 1.0, nSpectra);
-    for (int i = 0; i < nSpectra; i++) {
-      writeSpectrum(i, file);
-      progress.report();
-    }
-  } else {
-    Progress progress(this, 0.0, 1.0, idx.size());
-    for (int i : idx) {
-      writeSpectrum(i, file);
+    indices.resize(nSpectra);
+    std::iota(indices.begin(), indices.end(), 0);
+  }
+
+  // The spectra are formatted in parallel, a batch at a time, and written in
+  // order
+  const size_t batchSize =
+      std::max(size_t{1}, BATCH_VALUES / static_cast<size_t>(m_nBins));
+  std::vector<std::string> buffers;
+  Progress progress(this, 0.0, 1.0, indices.size());
+  for (size_t start = 0; start < indices.size(); start += batchSize) {
+    const auto end = std::min(start + batchSize, indices.size());
+    buffers.resize(end - start);
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int64_t i = static_cast<int64_t>(start);
+         i < static_cast<int64_t>(end); ++i) {
+      PARALLEL_START_INTERUPT_REGION
+      auto &buffer = buffers[i - start];
+      buffer.clear();
+      writeSpectrum(indices[i], buffer);
       progress.report();
+      PARALLEL_END_INTERUPT_REGION
     }
+    PARALLEL_CHECK_INTERUPT_REGION
+    for (const auto &buffer : buffers)
+      file.write(buffer.data(), buffer.size());
   }
 
-  file.unsetf(std::ios_base::floatfield);
   file.close();
 }
 
-/** Writes a spectrum to the file using a workspace index
+/** Formats a spectrum for the file using a workspace index, as a stream with
+ * the precision and flags of the algorithm would write it
  *
  * @param wsIndex :: an integer relating to a workspace index
- * @param file :: the file writer object
+ * @param out :: the text of the spectrum is appended to it
  */
-void SaveAscii2::writeSpectrum(const int &wsIndex, std::ofstream &file) {
+void SaveAscii2::writeSpectrum(const int &wsIndex, std::string &out) const {
 
   for (auto iter = m_metaData.begin(); iter != m_metaData.end(); ++iter) {
-    auto value = m_metaDataMap[*iter][wsIndex];
-    file << value;
+    out += m_metaDataMap.at(*iter)[wsIndex];
     if (iter != m_metaData.end() - 1) {
-      file << " " << m_sep << " ";
+      out += " " + m_sep + " ";
     }
   }
-  file << '\n';
-
-  auto pointDeltas = m_ws->pointStandardDeviations(0);
-  auto points0 = m_ws->points(0);
-  auto pointsSpec = m_ws->points(wsIndex);
+  out += '\n';
+
+  // checking for ragged workspace
+  const auto points = m_ws->points(m_isCommonBins ? 0 : wsIndex);
+  const auto &y = m_ws->y(wsIndex);
+  const auto &e = m_ws->e(wsIndex);
+  HistogramData::PointStandardDeviations pointDeltas;
+  if (m_writeDX)
+    pointDeltas = m_ws->pointStandardDeviations(0);
   for (int bin = 0; bin < m_nBins; bin++) {
-    if (m_isCommonBins) {
-      file << points0[bin];
-    } else // checking for ragged workspace
-    {
-      file << pointsSpec[bin];
-    }
-    file << m_sep;
-    file << m_ws->y(wsIndex)[bin];
-
-    file << m_sep;
-    file << m_ws->e(wsIndex)[bin];
+    CharConv::append(out, points[bin], m_floatFormat, m_precision);
+    out += m_sep;
+    CharConv::append(out, y[bin], m_floatFormat, m_precision);
+    out += m_sep;
+    CharConv::append(out, e[bin], m_floatFormat, m_precision);
     if (m_writeDX) {
-      file << m_sep;
-      file << pointDeltas[bin];
+      out += m_sep;
+      CharConv::append(out, pointDeltas[bin], m_floatFormat, m_precision);
     }
-    file << '\n';
+    out += '\n';
   }
 }
 
@@ -10,11 +10,14 @@
 #include "MantidAPI/MatrixWorkspace.h"
 #include "MantidGeometry/Instrument.h"
 #include "MantidGeometry/Instrument/DetectorInfo.h"
+#include "MantidKernel/CharConv.h"
 #include "MantidKernel/Exception.h"
 #include "MantidKernel/ListValidator.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/Unit.h"
 #include <Poco/File.h>
 #include <Poco/Path.h>
+#include <algorithm>
 #include <cmath>
 #include <exception>
 #include <fstream>
@@ -24,6 +27,11 @@ using namespace Mantid::DataHandling;
 // Register the algorithm into the AlgorithmFactory
 DECLARE_ALGORITHM(SaveFocusedXYE)
 
+namespace {
+/// Number of values formatted in parallel before they are written
+constexpr size_t BATCH_VALUES = 1 << 22;
+} // namespace
+
 /**
  * Initialise the algorithm
  */
@@ -63,7 +71,6 @@ void SaveFocusedXYE::exec() {
   // Retrieve the input workspace
   MatrixWorkspace_const_sptr inputWS = getProperty("InputWorkspace");
   const size_t nHist = inputWS->getNumberHistograms();
-  const bool isHistogram = inputWS->isHistogramData();
 
   // this would be a subroutine if it were easier to return
   // two strings
@@ -115,11 +122,16 @@ void SaveFocusedXYE::exec() {
 
   const auto &detectorInfo = inputWS->detectorInfo();
 
+  // The data of the spectra is formatted in parallel, a batch at a time
+  const size_t numBins = nHist > 0 ? inputWS->y(0).size() : 0;
+  const size_t batchSize =
+      std::max(size_t{1}, BATCH_VALUES / std::max(numBins, size_t{1}));
+  std::vector<std::string> data;
+
   Progress progress(this, 0.0, 1.0, nHist);
   for (size_t i = 0; i < nHist; i++) {
-    const auto &X = inputWS->x(i);
-    const auto &Y = inputWS->y(i);
-    const auto &E = inputWS->e(i);
+    if (i % batchSize == 0)
+      formatData(*inputWS, i, std::min(i + batchSize, nHist), data);
 
     double l1 = 0;
     double l2 = 0;
@@ -174,18 +186,12 @@ void SaveFocusedXYE::exec() {
                          inputWS->getAxis(1)->unit()->label(),
                          inputWS->getAxis(1)->getValue(i));
     }
-    const size_t datasize = Y.size();
-    for (size_t j = 0; j < datasize; j++) {
-      double xvalue(0.0);
-      if (isHistogram) {
-        xvalue = (X[j] + X[j + 1]) / 2.0;
-      } else {
-        xvalue = X[j];
-      }
-      out << std::fixed << std::setprecision(5) << std::setw(15) << xvalue
-          << std::fixed << std::setprecision(8) << std::setw(18) << Y[j]
-          << std::fixed << std::setprecision(8) << std::setw(18) << E[j]
-          << "\n";
+    const auto &text = data[i % batchSize];
+    out.write(text.data(), text.size());
+    if (!text.empty()) {
+      // The following headers are written as they were when the data went
+      // through the stream
+      out << std::fixed << std::setprecision(8);
     }
     // Close at each iteration
     if (split) {
@@ -199,6 +205,46 @@ void SaveFocusedXYE::exec() {
   }
 }
 
+/**
+ * Format the data lines of a range of spectra, in parallel
+ * @param workspace :: the input workspace
+ * @param first :: the first workspace index
+ * @param last :: one past the last workspace index
+ * @param data :: set to the text of each spectrum
+ */
+void SaveFocusedXYE::formatData(const API::MatrixWorkspace &workspace,
+                                const size_t first, const size_t last,
+                                std::vector<std::string> &data) {
+  using Kernel::CharConv::FloatFormat;
+  const bool isHistogram = workspace.isHistogramData();
+  data.resize(last - first);
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = static_cast<int64_t>(first); i < static_cast<int64_t>(last);
+       ++i) {
+    PARALLEL_START_INTERUPT_REGION
+    const auto &X = workspace.x(i);
+    const auto &Y = workspace.y(i);
+    const auto &E = workspace.e(i);
+    auto &text = data[i - first];
+    text.clear();
+    const size_t datasize = Y.size();
+    for (size_t j = 0; j < datasize; j++) {
+      double xvalue(0.0);
+      if (isHistogram) {
+        xvalue = (X[j] + X[j + 1]) / 2.0;
+      } else {
+        xvalue = X[j];
+      }
+      Kernel::CharConv::append(text, xvalue, FloatFormat::Fixed, 5, 15);
+      Kernel::CharConv::append(text, Y[j], FloatFormat::Fixed, 8, 18);
+      Kernel::CharConv::append(text, E[j], FloatFormat::Fixed, 8, 18);
+      text += '\n';
+    }
+    PARALLEL_END_INTERUPT_REGION
+  }
+  PARALLEL_CHECK_INTERUPT_REGION
+}
+
 /** virtual method to set the non workspace properties for this algorithm
  *  @param alg :: pointer to the algorithm
  *  @param propertyName :: name of the property
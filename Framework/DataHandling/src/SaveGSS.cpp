@@ -14,6 +14,7 @@
 #include "MantidKernel/ArrayBoundedValidator.h"
 #include "MantidKernel/ArrayLengthValidator.h"
 #include "MantidKernel/ArrayProperty.h"
+#include "MantidKernel/CharConv.h"
 #include "MantidKernel/CompositeValidator.h"
 #include "MantidKernel/Exception.h"
 #include "MantidKernel/ListValidator.h"
@@ -32,6 +33,7 @@ namespace DataHandling {
 
 using namespace Mantid::API;
 using namespace Mantid::HistogramData;
+using Mantid::Kernel::CharConv::FloatFormat;
 
 // Register the algorithm into the AlgorithmFactory
 DECLARE_ALGORITHM(SaveGSS)
@@ -402,30 +404,29 @@ void SaveGSS::generateGSASBuffer(size_t numOutFiles, size_t numOutSpectra) {
   // set l1 to 0
   const double l1{m_allDetectorsValid ? spectrumInfo.l1() : 0};
 
-  const auto numOutFilesInt64 = static_cast<int64_t>(numOutFiles);
-
   const std::string outputFormat = getPropertyValue("Format");
 
   std::vector<int> slog_xye_precisions = getProperty("SLOGXYEPrecision");
 
-  // Create the various output files we will need in a loop
-  PARALLEL_FOR_NO_WSP_CHECK()
-  for (int64_t fileIndex = 0; fileIndex < numOutFilesInt64; fileIndex++) {
-    // Add header to new files (e.g. doesn't exist or overwriting)
+  // Add header to new files (e.g. doesn't exist or overwriting)
+  for (size_t fileIndex = 0; fileIndex < numOutFiles; fileIndex++) {
     if (!doesFileExist(m_outFileNames[fileIndex]) || !append) {
       generateInstrumentHeader(*m_outputBuffer[fileIndex], l1);
     }
+  }
 
-    // Then add each spectra to buffer
-    for (size_t specIndex = 0; specIndex < numOutSpectra; specIndex++) {
-      // Determine whether to skip the spectrum due to being masked
-      if (m_allDetectorsValid && spectrumInfo.isMasked(specIndex)) {
-        continue;
-      }
-      // Find the index - this is because we are guaranteed at least
-      // one of these is 0 from the assertion above and the fact
-      // split files is a boolean operator on the input side
-      const int64_t index = specIndex + fileIndex;
+  // Then add each spectra to its own buffer, in parallel whether they go to
+  // separate files or to a single one
+  const auto numOutBuffers = static_cast<int64_t>(numOutFiles * numOutSpectra);
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t index = 0; index < numOutBuffers; index++) {
+    PARALLEL_START_INTERUPT_REGION
+    // The index is the sum of these, of which at least one is 0 from the
+    // assertion above
+    const size_t fileIndex = numOutFiles > 1 ? index : 0;
+    const size_t specIndex = index - fileIndex;
+    // Determine whether to skip the spectrum due to being masked
+    if (!m_allDetectorsValid || !spectrumInfo.isMasked(specIndex)) {
       // Add bank header and details to buffer
       generateBankHeader(*m_outputBuffer[index], spectrumInfo, index);
       // Add data to buffer
@@ -433,7 +434,9 @@ void SaveGSS::generateGSASBuffer(size_t numOutFiles, size_t numOutSpectra) {
                        slog_xye_precisions);
       m_progress->report();
     }
+    PARALLEL_END_INTERUPT_REGION
   }
+  PARALLEL_CHECK_INTERUPT_REGION
 }
 
 /**
@@ -837,13 +840,8 @@ void SaveGSS::writeRALF_ALTdata(std::stringstream &out, const int bank,
   const int64_t numberOfOutLines =
       (datasize + dataEntriesPerLine - 1) / dataEntriesPerLine;
 
-  std::vector<std::unique_ptr<std::stringstream>> outLines;
-  outLines.resize(numberOfOutLines);
-
+  std::string text;
   for (int64_t i = 0; i < numberOfOutLines; i++) {
-    outLines[i] = makeStringStream();
-    auto &outLine = *outLines[i];
-
     size_t dataPosition = i * dataEntriesPerLine;
     const size_t endPosition = dataPosition + dataEntriesPerLine;
 
@@ -855,21 +853,17 @@ void SaveGSS::writeRALF_ALTdata(std::stringstream &out, const int bank,
         const auto epos =
             static_cast<int>(fixErrorValue(eVals[dataPosition] * 1000));
 
-        outLine << std::fixed << std::setw(8)
-                << static_cast<int>(xPointVals[dataPosition] * 32);
-        outLine << std::fixed << std::setw(7)
-                << static_cast<int>(yVals[dataPosition] * 1000);
-        outLine << std::fixed << std::setw(5) << epos;
+        Kernel::CharConv::append(
+            text, int64_t{static_cast<int>(xPointVals[dataPosition] * 32)}, 8);
+        Kernel::CharConv::append(
+            text, int64_t{static_cast<int>(yVals[dataPosition] * 1000)}, 7);
+        Kernel::CharConv::append(text, int64_t{epos}, 5);
       }
     }
     // Append a newline character at the end of each data block
-    outLine << "\n";
-  }
-
-  for (const auto &outLine : outLines) {
-    // Ensure the output order is preserved
-    out << outLine->rdbuf();
+    text += '\n';
   }
+  out << text;
 }
 
 void SaveGSS::writeRALF_XYEdata(const int bank, const bool MultiplyByBinWidth,
@@ -883,30 +877,20 @@ void SaveGSS::writeRALF_XYEdata(const int bank, const bool MultiplyByBinWidth,
 
   writeRALFHeader(out, bank, histo);
 
-  std::vector<std::unique_ptr<std::stringstream>> outLines;
-  outLines.resize(datasize);
-
-  PARALLEL_FOR_NO_WSP_CHECK()
-  for (int64_t i = 0; i < static_cast<int64_t>(datasize); i++) {
-    outLines[i] = makeStringStream();
-    auto &outLine = *outLines[i];
+  std::string text;
+  for (size_t i = 0; i < datasize; i++) {
     const double binWidth = xVals[i + 1] - xVals[i];
     const double outYVal{MultiplyByBinWidth ? yVals[i] * binWidth : yVals[i]};
     const double epos =
         fixErrorValue(MultiplyByBinWidth ? eVals[i] * binWidth : eVals[i]);
 
     // The center of the X bin.
-    outLine << std::fixed << std::setprecision(5) << std::setw(15)
-            << xPointVals[i];
-    outLine << std::fixed << std::setprecision(8) << std::setw(18) << outYVal;
-    outLine << std::fixed << std::setprecision(8) << std::setw(18) << epos
-            << "\n";
-  }
-
-  for (const auto &outLine : outLines) {
-    // Ensure the output order is preserved
-    out << outLine->rdbuf();
+    Kernel::CharConv::append(text, xPointVals[i], FloatFormat::Fixed, 5, 15);
+    Kernel::CharConv::append(text, outYVal, FloatFormat::Fixed, 8, 18);
+    Kernel::CharConv::append(text, epos, FloatFormat::Fixed, 8, 18);
+    text += '\n';
   }
+  out << text;
 }
 
 //----------------------------------------------------------------------------
@@ -970,13 +954,8 @@ void SaveGSS::writeSLOGdata(const size_t ws_index, const int bank,
         << std::fixed << " 0 FXYE\n";
   }
 
-  std::vector<std::unique_ptr<std::stringstream>> outLines;
-  outLines.resize(datasize);
-
-  PARALLEL_FOR_NO_WSP_CHECK()
-  for (int64_t i = 0; i < static_cast<int64_t>(datasize); i++) {
-    outLines[i] = makeStringStream();
-    auto &outLine = *outLines[i];
+  std::string text;
+  for (size_t i = 0; i < datasize; i++) {
     const double binWidth = xVals[i + 1] - xVals[i];
     const double yValue{MultiplyByBinWidth ? yVals[i] * binWidth : yVals[i]};
     const double eValue{
@@ -984,17 +963,19 @@ void SaveGSS::writeSLOGdata(const size_t ws_index, const int bank,
 
     // FIXME - Next step is to make the precision to be flexible from user
     // inputs
-    outLine << "  " << std::fixed << std::setprecision(xye_precision[0])
-            << std::setw(20) << xPoints[i] << "  " << std::fixed
-            << std::setprecision(xye_precision[1]) << std::setw(20) << yValue
-            << "  " << std::fixed << std::setprecision(xye_precision[2])
-            << std::setw(20) << eValue << std::setw(12) << " "
-            << "\n"; // let it flush its own buffer
-  }
-
-  for (const auto &outLine : outLines) {
-    out << outLine->rdbuf();
-  }
+    text += "  ";
+    Kernel::CharConv::append(text, xPoints[i], FloatFormat::Fixed,
+                             xye_precision[0], 20);
+    text += "  ";
+    Kernel::CharConv::append(text, yValue, FloatFormat::Fixed,
+                             xye_precision[1], 20);
+    text += "  ";
+    Kernel::CharConv::append(text, eValue, FloatFormat::Fixed,
+                             xye_precision[2], 20);
+    text.append(12, ' ');
+    text += '\n';
+  }
+  out << text;
 }
 
 } // namespace DataHandling
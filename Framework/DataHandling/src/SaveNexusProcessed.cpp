@@ -7,6 +7,8 @@
 // SaveNexusProcessed
 // @author Ronald Fowler, based on SaveNexus
 #include "MantidDataHandling/SaveNexusProcessed.h"
+#include "MantidDataHandling/ChunkedDeflate.h"
+#include "MantidDataHandling/H5Util.h"
 #include "MantidAPI/EnabledWhenWorkspaceIsType.h"
 #include "MantidAPI/FileProperty.h"
 #include "MantidAPI/IMDEventWorkspace.h"
@@ -20,7 +22,10 @@
 #include "MantidKernel/ArrayProperty.h"
 #include "MantidKernel/BoundedValidator.h"
 #include "MantidNexus/NexusFileIO.h"
+#include <H5Cpp.h>
 #include <Poco/File.h>
+#include <Poco/Path.h>
+#include <Poco/String.h>
 #include <boost/shared_ptr.hpp>
 
 using namespace Mantid::API;
@@ -84,7 +89,7 @@ void SaveNexusProcessed::init() {
   declareProperty(
       "CompressNexus", false,
       "For EventWorkspaces, compress the Nexus data field (default False).\n"
-      "This will make smaller files but takes much longer.");
+      "This will make smaller files but takes longer.");
   setPropertySettings("CompressNexus",
                       make_unique<EnabledWhenWorkspaceIsType<EventWorkspace>>(
                           "InputWorkspace", true));
@@ -464,10 +469,33 @@ void SaveNexusProcessed::execEvent(Mantid::NeXus::NexusFileIO *nexusFile,
   /*Default = DONT compress - much faster*/
   bool CompressNexus = getProperty("CompressNexus");
 
-  // Write out to the NXS file.
-  nexusFile->writeNexusProcessedDataEventCombined(m_eventWorkspace, indices,
-                                                  tofs, weights, errorSquareds,
-                                                  pulsetimes, CompressNexus);
+  const std::string filename = getPropertyValue("Filename");
+  if (CompressNexus && ChunkedDeflate::isAvailable() &&
+      Poco::toLower(Poco::Path(filename).getExtension()) != "xml") {
+    // NeXus would compress the events on a single thread: write the indices
+    // through NeXus and the events with ChunkedDeflate, on all the cores.
+    const std::string eventsPath =
+        ::NeXus::File(nexusFile->fileID).getPath() + "/event_workspace";
+    nexusFile->writeNexusProcessedDataEventCombined(
+        m_eventWorkspace, indices, nullptr, nullptr, nullptr, nullptr, true);
+    H5::H5File file = H5Util::openFile(filename, H5F_ACC_RDWR);
+    H5::Group group = file.openGroup(eventsPath);
+    const auto length = static_cast<size_t>(num);
+    if (tofs)
+      ChunkedDeflate::writeArray1D(group, "tof", tofs, length);
+    if (pulsetimes)
+      ChunkedDeflate::writeArray1D(group, "pulsetime", pulsetimes, length);
+    if (weights)
+      ChunkedDeflate::writeArray1D(group, "weight", weights, length);
+    if (errorSquareds)
+      ChunkedDeflate::writeArray1D(group, "error_squared", errorSquareds,
+                                   length);
+  } else {
+    // Write out to the NXS file.
+    nexusFile->writeNexusProcessedDataEventCombined(
+        m_eventWorkspace, indices, tofs, weights, errorSquareds, pulsetimes,
+        CompressNexus);
+  }
 
   // Free mem.
   delete[] tofs;
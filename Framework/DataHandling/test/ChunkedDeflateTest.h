@@ -0,0 +1,184 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAHANDLING_CHUNKEDDEFLATETEST_H_
+#define MANTID_DATAHANDLING_CHUNKEDDEFLATETEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidDataHandling/ChunkedDeflate.h"
+#include "MantidDataHandling/H5Util.h"
+
+#include <H5Cpp.h>
+#include <Poco/File.h>
+
+#include <numeric>
+#include <vector>
+
+using namespace H5;
+using namespace Mantid::DataHandling;
+
+class ChunkedDeflateTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static ChunkedDeflateTest *createSuite() { return new ChunkedDeflateTest(); }
+  static void destroySuite(ChunkedDeflateTest *suite) { delete suite; }
+
+  void setUp() override {
+    removeFile(FILENAME);
+    m_file = H5File(FILENAME, H5F_ACC_EXCL);
+    m_group = m_file.createGroup("events");
+  }
+
+  void tearDown() override {
+    m_group.close();
+    m_file.close();
+    removeFile(FILENAME);
+  }
+
+  void test_round_trip_over_several_chunks() {
+    if (!ChunkedDeflate::isAvailable())
+      return;
+    // Three whole chunks and a partial one
+    const size_t length = 3 * ChunkedDeflate::CHUNK_BYTES / sizeof(double) + 5;
+    std::vector<double> tofs(length);
+    std::iota(tofs.begin(), tofs.end(), 0.5);
+    ChunkedDeflate::writeArray1D(m_group, "tof", tofs.data(), length);
+
+    auto dataset = m_group.openDataSet("tof");
+    TS_ASSERT(ChunkedDeflate::isChunkedDeflate(dataset));
+    hsize_t chunkLength = 0;
+    dataset.getCreatePlist().getChunk(1, &chunkLength);
+    TS_ASSERT_EQUALS(chunkLength, ChunkedDeflate::CHUNK_BYTES / sizeof(double));
+
+    std::vector<double> values(length);
+    ChunkedDeflate::readArray1D(dataset, values.data(), length);
+    TS_ASSERT_EQUALS(values, tofs);
+  }
+
+  void test_hdf5_reads_what_is_written() {
+    if (!ChunkedDeflate::isAvailable())
+      return;
+    const size_t length = ChunkedDeflate::CHUNK_BYTES / sizeof(float) + 1;
+    std::vector<float> weights(length);
+    for (size_t i = 0; i < length; ++i)
+      weights[i] = static_cast<float>(i % 7) * 0.25f;
+    ChunkedDeflate::writeArray1D(m_group, "weight", weights.data(), length, 6);
+
+    std::vector<float> values(length);
+    m_group.openDataSet("weight").read(values.data(), PredType::NATIVE_FLOAT);
+    TS_ASSERT_EQUALS(values, weights);
+  }
+
+  void test_small_arrays_make_a_single_chunk() {
+    if (!ChunkedDeflate::isAvailable())
+      return;
+    const std::vector<int64_t> pulsetimes{3, 1, 4, 1, 5};
+    ChunkedDeflate::writeArray1D(m_group, "pulsetime", pulsetimes.data(),
+                                 pulsetimes.size());
+
+    auto dataset = m_group.openDataSet("pulsetime");
+    hsize_t chunkLength = 0;
+    dataset.getCreatePlist().getChunk(1, &chunkLength);
+    TS_ASSERT_EQUALS(chunkLength, pulsetimes.size());
+    std::vector<int64_t> values(pulsetimes.size());
+    ChunkedDeflate::readArray1D(dataset, values.data(), values.size());
+    TS_ASSERT_EQUALS(values, pulsetimes);
+  }
+
+  void test_empty_array() {
+    if (!ChunkedDeflate::isAvailable())
+      return;
+    ChunkedDeflate::writeArray1D<double>(m_group, "tof", nullptr, 0);
+    auto dataset = m_group.openDataSet("tof");
+    TS_ASSERT(!ChunkedDeflate::isChunkedDeflate(dataset));
+    TS_ASSERT_THROWS_NOTHING(
+        ChunkedDeflate::readArray1D<double>(dataset, nullptr, 0));
+  }
+
+  void test_other_datasets_are_read_by_hdf5() {
+    const std::vector<double> tofs{1., 2., 3.};
+    H5Util::writeArray1D(m_group, "compressed", tofs);
+    auto dataset = m_group.createDataSet(
+        "contiguous", PredType::NATIVE_DOUBLE, H5Util::getDataSpace(tofs));
+    dataset.write(tofs.data(), PredType::NATIVE_DOUBLE);
+    TS_ASSERT(!ChunkedDeflate::isChunkedDeflate(dataset));
+
+    std::vector<double> values(tofs.size());
+    ChunkedDeflate::readArray1D(dataset, values.data(), values.size());
+    TS_ASSERT_EQUALS(values, tofs);
+
+    // Stored as double, read as float
+    std::vector<float> floats(tofs.size());
+    auto compressed = m_group.openDataSet("compressed");
+    ChunkedDeflate::readArray1D(compressed, floats.data(), floats.size());
+    TS_ASSERT_EQUALS(floats, std::vector<float>({1.f, 2.f, 3.f}));
+  }
+
+  void test_wrong_length_throws() {
+    const std::vector<double> tofs{1., 2., 3.};
+    H5Util::writeArray1D(m_group, "tof", tofs);
+    auto dataset = m_group.openDataSet("tof");
+    std::vector<double> values(2);
+    TS_ASSERT_THROWS(
+        ChunkedDeflate::readArray1D(dataset, values.data(), values.size()),
+        std::invalid_argument);
+  }
+
+private:
+  void removeFile(const std::string &filename) {
+    if (Poco::File(filename).exists())
+      Poco::File(filename).remove();
+  }
+
+  const std::string FILENAME{"ChunkedDeflateTest.h5"};
+  H5File m_file;
+  Group m_group;
+};
+
+class ChunkedDeflateTestPerformance : public CxxTest::TestSuite {
+public:
+  static ChunkedDeflateTestPerformance *createSuite() {
+    return new ChunkedDeflateTestPerformance();
+  }
+  static void destroySuite(ChunkedDeflateTestPerformance *suite) {
+    delete suite;
+  }
+
+  ChunkedDeflateTestPerformance() : m_tofs(20 * 1000 * 1000) {
+    for (size_t i = 0; i < m_tofs.size(); ++i)
+      m_tofs[i] = static_cast<double>((i * 7919) % 20000) + 0.5;
+  }
+
+  void setUp() override {
+    if (Poco::File(FILENAME).exists())
+      Poco::File(FILENAME).remove();
+  }
+
+  void tearDown() override { setUp(); }
+
+  void test_write_and_read() {
+    if (!ChunkedDeflate::isAvailable())
+      return;
+    {
+      H5File file(FILENAME, H5F_ACC_EXCL);
+      auto group = file.createGroup("events");
+      ChunkedDeflate::writeArray1D(group, "tof", m_tofs.data(), m_tofs.size());
+    }
+    H5File file(FILENAME, H5F_ACC_RDONLY);
+    auto dataset = file.openDataSet("events/tof");
+    std::vector<double> values(m_tofs.size());
+    ChunkedDeflate::readArray1D(dataset, values.data(), values.size());
+    TS_ASSERT_EQUALS(values.back(), m_tofs.back());
+  }
+
+private:
+  const std::string FILENAME{"ChunkedDeflateTestPerformance.h5"};
+  std::vector<double> m_tofs;
+};
+
+#endif /* MANTID_DATAHANDLING_CHUNKEDDEFLATETEST_H_ */
@@ -0,0 +1,99 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAHANDLING_EVENTBUFFERPOOLTEST_H_
+#define MANTID_DATAHANDLING_EVENTBUFFERPOOLTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidDataHandling/EventBufferPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using Mantid::DataHandling::EventBufferPool;
+using Mantid::DataHandling::EventBuffers;
+
+class EventBufferPoolTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static EventBufferPoolTest *createSuite() { return new EventBufferPoolTest(); }
+  static void destroySuite(EventBufferPoolTest *suite) { delete suite; }
+
+  void test_zero_capacity_throws() {
+    TS_ASSERT_THROWS(EventBufferPool(0), std::invalid_argument);
+  }
+
+  void test_capacity_bounds_buffers_in_use() {
+    EventBufferPool pool(2);
+    TS_ASSERT_EQUALS(pool.capacity(), 2);
+    auto first = pool.acquire();
+    auto second = pool.acquire();
+    TS_ASSERT(first);
+    TS_ASSERT(second);
+    TS_ASSERT_DIFFERS(first.get(), second.get());
+    TS_ASSERT_EQUALS(pool.available(), 0);
+    TS_ASSERT(!pool.tryAcquire());
+
+    first.reset();
+    TS_ASSERT_EQUALS(pool.available(), 1);
+    TS_ASSERT(pool.tryAcquire());
+  }
+
+  void test_released_buffers_are_reused() {
+    EventBufferPool pool(1);
+    auto buffers = pool.acquire();
+    buffers->eventId.resize(1000);
+    const auto *data = buffers->eventId.data();
+    const auto *address = buffers.get();
+    buffers.reset();
+
+    buffers = pool.acquire();
+    TS_ASSERT_EQUALS(buffers.get(), address);
+    TS_ASSERT_EQUALS(buffers->eventId.data(), data);
+    TS_ASSERT_EQUALS(buffers->eventId.size(), 1000);
+  }
+
+  void test_copies_keep_the_buffer_in_use() {
+    EventBufferPool pool(1);
+    auto buffers = pool.acquire();
+    auto copy = buffers;
+    buffers.reset();
+    TS_ASSERT_EQUALS(pool.available(), 0);
+    copy.reset();
+    TS_ASSERT_EQUALS(pool.available(), 1);
+  }
+
+  void test_buffers_can_outlive_the_pool() {
+    boost::shared_ptr<EventBuffers> buffers;
+    {
+      EventBufferPool pool(1);
+      buffers = pool.acquire();
+    }
+    buffers->timeOfFlight.resize(10);
+    TS_ASSERT_THROWS_NOTHING(buffers.reset());
+  }
+
+  void test_acquire_waits_for_release_in_another_thread() {
+    EventBufferPool pool(1);
+    auto buffers = pool.acquire();
+    std::atomic<bool> released{false};
+    std::thread consumer([&buffers, &released] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      released = true;
+      buffers.reset();
+    });
+    auto next = pool.acquire();
+    TS_ASSERT(released);
+    TS_ASSERT(next);
+    TS_ASSERT_LESS_THAN(0., pool.waitTime());
+    consumer.join();
+  }
+};
+
+#endif /* MANTID_DATAHANDLING_EVENTBUFFERPOOLTEST_H_ */
@@ -0,0 +1,234 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAHANDLING_EVENTNEXUSINDEXTEST_H_
+#define MANTID_DATAHANDLING_EVENTNEXUSINDEXTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidDataHandling/EventNexusIndex.h"
+#include "MantidKernel/ConfigService.h"
+#include "MantidKernel/make_unique.h"
+#include "MantidTestHelpers/ScopedFileHelper.h"
+
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <Poco/TemporaryFile.h>
+
+#include <fstream>
+
+using Mantid::DataHandling::EventNexusIndex;
+using Mantid::Kernel::ConfigService;
+using ScopedFileHelper::ScopedFile;
+
+namespace {
+/// An index of two banks sharing their pulse times and one without any
+std::unique_ptr<EventNexusIndex> makeIndex(const std::string &filename) {
+  auto index = Mantid::Kernel::make_unique<EventNexusIndex>(filename);
+  EventNexusIndex::PulseTable table;
+  table.offset = "2019-01-01T00:00:00";
+  table.times = {1000, 2000, 3000};
+  std::vector<EventNexusIndex::Bank> banks(3);
+  banks[0].name = "bank1_events";
+  banks[0].numEvents = 5;
+  banks[0].eventIndex = {0, 2, 4};
+  banks[0].pulseTable = 0;
+  banks[1].name = "bank2_events";
+  banks[1].numEvents = 7;
+  banks[1].hasWeights = true;
+  banks[1].eventIndex = {0, 0, 3};
+  banks[1].pulseTable = 0;
+  banks[2].name = "bank3_events";
+  index->setBanks("entry", std::move(banks), {table}, false);
+  return index;
+}
+} // namespace
+
+class EventNexusIndexTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static EventNexusIndexTest *createSuite() { return new EventNexusIndexTest(); }
+  static void destroySuite(EventNexusIndexTest *suite) { delete suite; }
+
+  EventNexusIndexTest()
+      : m_location(
+            ConfigService::Instance().getString("EventNexusIndex.Location")) {}
+
+  ~EventNexusIndexTest() override {
+    ConfigService::Instance().setString("EventNexusIndex.Location",
+                                        m_location);
+  }
+
+  void test_missing_file_throws() {
+    TS_ASSERT_THROWS(EventNexusIndex("not_a_file_EventNexusIndexTest.nxs"),
+                     std::runtime_error);
+  }
+
+  void test_banks() {
+    ScopedFile file("events", "EventNexusIndexTest_banks.nxs");
+    auto index = makeIndex(file.getFileName());
+    TS_ASSERT(index->isModified());
+    TS_ASSERT(index->hasBanks("entry"));
+    TS_ASSERT(!index->hasBanks("entry_1"));
+    TS_ASSERT_EQUALS(index->banks().size(), 3);
+    const auto *bank = index->bank("bank2_events");
+    TS_ASSERT(bank);
+    TS_ASSERT_EQUALS(bank->numEvents, 7);
+    TS_ASSERT(bank->hasWeights);
+    TS_ASSERT(!index->bank("bank4_events"));
+    TS_ASSERT_EQUALS(index->bank("bank3_events")->pulseTable,
+                     EventNexusIndex::NO_PULSE_TABLE);
+  }
+
+  void test_setBanks_throws_on_missing_pulse_table() {
+    ScopedFile file("events", "EventNexusIndexTest_tables.nxs");
+    EventNexusIndex index(file.getFileName());
+    std::vector<EventNexusIndex::Bank> banks(1);
+    banks[0].name = "bank1_events";
+    banks[0].pulseTable = 1;
+    TS_ASSERT_THROWS(index.setBanks("entry", banks, {}, false),
+                     std::invalid_argument);
+  }
+
+  void test_setIdRange() {
+    ScopedFile file("events", "EventNexusIndexTest_range.nxs");
+    auto index = makeIndex(file.getFileName());
+    TS_ASSERT(!index->bank("bank1_events")->hasIdRange);
+    index->setIdRange("bank1_events", 10, 20);
+    const auto *bank = index->bank("bank1_events");
+    TS_ASSERT(bank->hasIdRange);
+    TS_ASSERT_EQUALS(bank->minId, 10);
+    TS_ASSERT_EQUALS(bank->maxId, 20);
+    TS_ASSERT_THROWS_NOTHING(index->setIdRange("bank4_events", 1, 2));
+  }
+
+  void test_save_and_load() {
+    ScopedFile file("events", "EventNexusIndexTest_save.nxs");
+    const auto indexPath = file.getFileName() + ".evindex";
+    auto index = makeIndex(file.getFileName());
+    index->setIdRange("bank2_events", 3, 4);
+    EventNexusIndex::LogSummary logs;
+    logs.entryName = "entry";
+    logs.frequencyStart = "2019-01-01T00:00:00";
+    logs.hasProtonCharge = true;
+    logs.protonCharge = 1.5;
+    index->setLogs(logs);
+    index->saveAs(indexPath);
+
+    auto loaded = EventNexusIndex::load(indexPath, file.getFileName());
+    Poco::File(indexPath).remove();
+    TS_ASSERT(loaded);
+    TS_ASSERT(!loaded->isModified());
+    TS_ASSERT_EQUALS(loaded->entryName(), "entry");
+    TS_ASSERT(!loaded->oldFieldNames());
+    TS_ASSERT_EQUALS(loaded->banks().size(), 3);
+    const auto *bank = loaded->bank("bank2_events");
+    TS_ASSERT(bank);
+    TS_ASSERT_EQUALS(bank->numEvents, 7);
+    TS_ASSERT(bank->hasWeights);
+    TS_ASSERT_EQUALS(bank->eventIndex, std::vector<uint64_t>({0, 0, 3}));
+    TS_ASSERT_EQUALS(bank->pulseTable, 0);
+    TS_ASSERT(bank->hasIdRange);
+    TS_ASSERT_EQUALS(bank->minId, 3);
+    TS_ASSERT_EQUALS(bank->maxId, 4);
+    TS_ASSERT(!loaded->bank("bank1_events")->hasIdRange);
+    TS_ASSERT_EQUALS(loaded->pulseTables().size(), 1);
+    TS_ASSERT_EQUALS(loaded->pulseTables()[0].offset, "2019-01-01T00:00:00");
+    TS_ASSERT_EQUALS(loaded->pulseTables()[0].times,
+                     std::vector<int64_t>({1000, 2000, 3000}));
+    TS_ASSERT(loaded->logs().known);
+    TS_ASSERT_EQUALS(loaded->logs().entryName, "entry");
+    TS_ASSERT_EQUALS(loaded->logs().frequencyStart, "2019-01-01T00:00:00");
+    TS_ASSERT(loaded->logs().hasProtonCharge);
+    TS_ASSERT_EQUALS(loaded->logs().protonCharge, 1.5);
+  }
+
+  void test_save_leaves_no_temporary_files() {
+    ScopedFile file("events", "EventNexusIndexTest_temporary.nxs");
+    Poco::TemporaryFile directory;
+    directory.createDirectories();
+    const auto indexPath =
+        Poco::Path(directory.path(), "run.evindex").toString();
+    makeIndex(file.getFileName())->saveAs(indexPath);
+    makeIndex(file.getFileName())->saveAs(indexPath);
+    std::vector<std::string> files;
+    directory.list(files);
+    TS_ASSERT_EQUALS(files, std::vector<std::string>{"run.evindex"});
+
+    // The index cannot replace a directory: the temporary file is removed
+    const auto blockedPath = Poco::Path(directory.path(), "blocked").toString();
+    Poco::File(blockedPath).createDirectory();
+    TS_ASSERT_THROWS_ANYTHING(
+        makeIndex(file.getFileName())->saveAs(blockedPath));
+    files.clear();
+    directory.list(files);
+    TS_ASSERT_EQUALS(files.size(), 2);
+  }
+
+  void test_load_ignores_the_index_of_a_changed_file() {
+    ScopedFile file("events", "EventNexusIndexTest_changed.nxs");
+    const auto indexPath = file.getFileName() + ".evindex";
+    makeIndex(file.getFileName())->saveAs(indexPath);
+    {
+      std::ofstream events(file.getFileName(), std::ios::app);
+      events << " and more events";
+    }
+    TS_ASSERT(!EventNexusIndex::load(indexPath, file.getFileName()));
+    Poco::File(indexPath).remove();
+  }
+
+  void test_load_ignores_invalid_indexes() {
+    ScopedFile file("events", "EventNexusIndexTest_invalid.nxs");
+    ScopedFile notAnIndex("not an index", "EventNexusIndexTest_invalid.idx");
+    TS_ASSERT(!EventNexusIndex::load(notAnIndex.getFileName(),
+                                     file.getFileName()));
+    TS_ASSERT(!EventNexusIndex::load(file.getFileName() + ".missing",
+                                     file.getFileName()));
+  }
+
+  void test_location() {
+    ScopedFile file("events", "EventNexusIndexTest_location.nxs");
+    auto &config = ConfigService::Instance();
+    config.setString("EventNexusIndex.Location", "Off");
+    TS_ASSERT(EventNexusIndex::location(file.getFileName()).empty());
+    TS_ASSERT(!EventNexusIndex::open(file.getFileName()));
+
+    config.setString("EventNexusIndex.Location", "NextToFile");
+    TS_ASSERT_EQUALS(EventNexusIndex::location(file.getFileName()),
+                     file.getFileName() + ".evindex");
+
+    // Files in different directories get different names
+    config.setString("EventNexusIndex.Location", "indexes");
+    const auto location = EventNexusIndex::location(file.getFileName());
+    TS_ASSERT_EQUALS(location.find("indexes"), 0);
+    TS_ASSERT_DIFFERS(location.find("EventNexusIndexTest_location.nxs."),
+                      std::string::npos);
+    TS_ASSERT_DIFFERS(EventNexusIndex::location("a/run.nxs"),
+                      EventNexusIndex::location("b/run.nxs"));
+  }
+
+  void test_open_reuses_a_saved_index() {
+    ScopedFile file("events", "EventNexusIndexTest_open.nxs");
+    ConfigService::Instance().setString("EventNexusIndex.Location",
+                                        "NextToFile");
+    auto index = EventNexusIndex::open(file.getFileName());
+    TS_ASSERT(index);
+    TS_ASSERT(!index->hasBanks("entry"));
+    TS_ASSERT(makeIndex(file.getFileName())->save());
+
+    index = EventNexusIndex::open(file.getFileName());
+    Poco::File(EventNexusIndex::location(file.getFileName())).remove();
+    TS_ASSERT(index->hasBanks("entry"));
+    TS_ASSERT(!index->isModified());
+  }
+
+private:
+  /// The configured location, restored at the end
+  std::string m_location;
+};
+
+#endif /* MANTID_DATAHANDLING_EVENTNEXUSINDEXTEST_H_ */
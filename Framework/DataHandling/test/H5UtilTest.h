@@ -16,6 +16,7 @@
 #include <Poco/File.h>
 #include <boost/numeric/conversion/cast.hpp>
 #include <limits>
+#include <nexus/NeXusFile.hpp>
 
 using namespace H5;
 using namespace Mantid::DataHandling;
@@ -216,6 +217,25 @@ public:
     removeFile(filename);
   }
 
+  void test_openFile_while_open_through_nexus() {
+    const std::string FILENAME("H5UtilTest_openFile.h5");
+    removeFile(FILENAME);
+    {
+      H5File file(FILENAME, H5F_ACC_EXCL);
+      H5Util::createGroupNXS(file, "entry", "NXentry");
+    }
+
+    ::NeXus::File nexusFile(FILENAME, NXACC_READ);
+    // NeXus opens files with H5F_CLOSE_STRONG, which HDF5 requires of the
+    // other handles on the file
+    TS_ASSERT_THROWS_ANYTHING(H5File(FILENAME, H5F_ACC_RDONLY));
+    TS_ASSERT_THROWS_NOTHING(H5Util::openFile(FILENAME, H5F_ACC_RDONLY)
+                                 .openGroup("entry"));
+    nexusFile.close();
+
+    removeFile(FILENAME);
+  }
+
 private:
   void do_assert_simple_string_data_set(
       const std::string &filename, const std::string &groupName,
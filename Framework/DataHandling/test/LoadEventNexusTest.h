@@ -19,6 +19,7 @@
 #include "MantidIndexing/IndexInfo.h"
 #include "MantidIndexing/SpectrumIndexSet.h"
 #include "MantidIndexing/SpectrumNumber.h"
+#include "MantidKernel/ConfigService.h"
 #include "MantidKernel/Property.h"
 #include "MantidKernel/TimeSeriesProperty.h"
 #include "MantidNexusGeometry/Hdf5Version.h"
@@ -27,6 +28,8 @@
 #include "MantidTestHelpers/ParallelAlgorithmCreation.h"
 #include "MantidTestHelpers/ParallelRunner.h"
 
+#include <Poco/File.h>
+#include <Poco/Path.h>
 #include <cxxtest/TestSuite.h>
 
 using namespace Mantid;
@@ -568,6 +571,275 @@ public:
     }
   }
 
+  void test_partial_spectra_loading_reads_the_same_events() {
+    // The banks without any of these pixels are not read at all
+    const std::vector<int32_t> specList{13, 16, 1100};
+    LoadEventNexus ld;
+    ld.initialize();
+    ld.setPropertyValue("OutputWorkspace", "partial_spectra_events");
+    ld.setPropertyValue("Filename", "CNCS_7860_event.nxs");
+    ld.setProperty("SpectrumList", specList);
+    ld.setProperty<bool>("LoadLogs", false); // Time-saver
+    TS_ASSERT(ld.execute());
+
+    LoadEventNexus ldAll;
+    ldAll.initialize();
+    ldAll.setPropertyValue("OutputWorkspace", "all_spectra_events");
+    ldAll.setPropertyValue("Filename", "CNCS_7860_event.nxs");
+    ldAll.setProperty<bool>("LoadLogs", false); // Time-saver
+    TS_ASSERT(ldAll.execute());
+
+    auto &ads = AnalysisDataService::Instance();
+    auto partialWs = ads.retrieveWS<EventWorkspace>("partial_spectra_events");
+    auto allWs = ads.retrieveWS<EventWorkspace>("all_spectra_events");
+    TS_ASSERT_EQUALS(partialWs->getNumberHistograms(), specList.size());
+    for (size_t i = 0; i < partialWs->getNumberHistograms(); ++i) {
+      const auto &spectrum = partialWs->getSpectrum(i);
+      const auto index =
+          allWs->getIndexFromSpectrumNumber(spectrum.getSpectrumNo());
+      TS_ASSERT_EQUALS(spectrum.getNumberEvents(),
+                       allWs->getSpectrum(index).getNumberEvents());
+    }
+    ads.remove("partial_spectra_events");
+    ads.remove("all_spectra_events");
+  }
+
+  void test_time_filtered_loading_reads_only_the_window() {
+    const std::string wsName = "time_window_events";
+    LoadEventNexus ld;
+    ld.initialize();
+    ld.setPropertyValue("OutputWorkspace", wsName);
+    ld.setPropertyValue("Filename", "CNCS_7860_event.nxs");
+    ld.setProperty("FilterByTimeStart", 60.);
+    ld.setProperty("FilterByTimeStop", 120.);
+    TS_ASSERT(ld.execute());
+
+    LoadEventNexus ldAll;
+    ldAll.initialize();
+    ldAll.setPropertyValue("OutputWorkspace", "all_time_events");
+    ldAll.setPropertyValue("Filename", "CNCS_7860_event.nxs");
+    TS_ASSERT(ldAll.execute());
+
+    auto &ads = AnalysisDataService::Instance();
+    auto outWs = ads.retrieveWS<EventWorkspace>(wsName);
+    auto allWs = ads.retrieveWS<EventWorkspace>("all_time_events");
+    TS_ASSERT_LESS_THAN(0, outWs->getNumberEvents());
+    const double duration = DateAndTime::secondsFromDuration(
+        outWs->getPulseTimeMax() - outWs->getPulseTimeMin());
+    TS_ASSERT_LESS_THAN_EQUALS(duration, 60.);
+    // Only the pulses in the window are read from the file, not all events
+    TS_ASSERT_LESS_THAN(outWs->getNumberEvents(), allWs->getNumberEvents());
+    TS_ASSERT_LESS_THAN_EQUALS(outWs->getNumberEvents(), ld.events_read);
+    TS_ASSERT_LESS_THAN(ld.events_read, ldAll.events_read);
+    ads.remove(wsName);
+    ads.remove("all_time_events");
+  }
+
+  void test_loading_with_an_index_reads_the_same_events() {
+    auto &config = ConfigService::Instance();
+    const auto location = config.getString("EventNexusIndex.Location");
+    Poco::Path directory(Poco::Path::temp());
+    directory.pushDirectory("LoadEventNexusTest_indexes");
+    config.setString("EventNexusIndex.Location", directory.toString());
+
+    const auto load = [](const std::string &wsName) {
+      LoadEventNexus ld;
+      ld.initialize();
+      ld.setPropertyValue("OutputWorkspace", wsName);
+      ld.setPropertyValue("Filename", "CNCS_7860_event.nxs");
+      ld.setProperty("FilterByTimeStart", 60.);
+      ld.setProperty("FilterByTimeStop", 120.);
+      TS_ASSERT(ld.execute());
+      return AnalysisDataService::Instance().retrieveWS<EventWorkspace>(
+          wsName);
+    };
+    // The first load builds the index and the second one uses it
+    const auto indexingWs = load("indexing_events");
+    const auto indexedWs = load("indexed_events");
+    config.setString("EventNexusIndex.Location", "Off");
+    const auto plainWs = load("not_indexed_events");
+    config.setString("EventNexusIndex.Location", location);
+    Poco::File(directory).remove(true);
+
+    TS_ASSERT_LESS_THAN(0, plainWs->getNumberEvents());
+    TS_ASSERT_EQUALS(indexingWs->getNumberEvents(),
+                     plainWs->getNumberEvents());
+    TS_ASSERT_EQUALS(indexedWs->getNumberEvents(), plainWs->getNumberEvents());
+    for (size_t i = 0; i < plainWs->getNumberHistograms(); i += 97)
+      TS_ASSERT_EQUALS(indexedWs->getSpectrum(i).getNumberEvents(),
+                       plainWs->getSpectrum(i).getNumberEvents());
+    TS_ASSERT_DELTA(indexedWs->run().getProtonCharge(),
+                    plainWs->run().getProtonCharge(), 1e-12);
+    TS_ASSERT_EQUALS(indexedWs->getPulseTimeMin(), plainWs->getPulseTimeMin());
+    AnalysisDataService::Instance().remove("indexing_events");
+    AnalysisDataService::Instance().remove("indexed_events");
+    AnalysisDataService::Instance().remove("not_indexed_events");
+  }
+
+  void test_split_banks_read_the_same_events() {
+    auto &config = ConfigService::Instance();
+    const auto minTaskEvents = config.getString("LoadEventNexus.MinTaskEvents");
+    const auto load = [&config](const std::string &wsName,
+                                const std::string &minEvents) {
+      config.setString("LoadEventNexus.MinTaskEvents", minEvents);
+      LoadEventNexus ld;
+      ld.initialize();
+      ld.setPropertyValue("OutputWorkspace", wsName);
+      ld.setPropertyValue("Filename", "CNCS_7860_event.nxs");
+      ld.setProperty<bool>("LoadLogs", false); // Time-saver
+      TS_ASSERT(ld.execute());
+      return AnalysisDataService::Instance().retrieveWS<EventWorkspace>(
+          wsName);
+    };
+    // Split the banks as much as the number of threads allows
+    const auto splitWs = load("split_bank_events", "1");
+    const auto wholeWs = load("whole_bank_events", "0");
+    config.setString("LoadEventNexus.MinTaskEvents", minTaskEvents);
+
+    TS_ASSERT_EQUALS(splitWs->getNumberEvents(), wholeWs->getNumberEvents());
+    for (size_t i = 0; i < wholeWs->getNumberHistograms(); ++i) {
+      // The ranges of pulses are merged in order
+      TS_ASSERT(splitWs->getSpectrum(i).getEvents() ==
+                wholeWs->getSpectrum(i).getEvents());
+    }
+    AnalysisDataService::Instance().remove("split_bank_events");
+    AnalysisDataService::Instance().remove("whole_bank_events");
+  }
+
+  void test_single_precision_tof_keeps_the_events() {
+    auto &config = ConfigService::Instance();
+    const auto minTaskEvents = config.getString("LoadEventNexus.MinTaskEvents");
+    const auto load = [](const std::string &wsName, const bool single,
+                         const bool resume) {
+      LoadEventNexus ld;
+      ld.initialize();
+      ld.setPropertyValue("OutputWorkspace", wsName);
+      ld.setPropertyValue("Filename", "CNCS_7860_event.nxs");
+      ld.setProperty<bool>("LoadLogs", false); // Time-saver
+      ld.setProperty<bool>("SinglePrecisionTof", single);
+      ld.setProperty<bool>("Resume", resume);
+      TS_ASSERT(ld.execute());
+      return AnalysisDataService::Instance().retrieveWS<EventWorkspace>(
+          wsName);
+    };
+    // Split banks write the same pixels from several tasks
+    config.setString("LoadEventNexus.MinTaskEvents", "1");
+    const auto singleWs = load("single_precision_events", true, false);
+    config.setString("LoadEventNexus.MinTaskEvents", minTaskEvents);
+    const auto doubleWs = load("double_precision_events", false, false);
+
+    TS_ASSERT_EQUALS(singleWs->getNumberEvents(), doubleWs->getNumberEvents());
+    for (size_t i = 0; i < doubleWs->getNumberHistograms(); ++i) {
+      TS_ASSERT_EQUALS(singleWs->getSpectrum(i).getStorageLayout(),
+                       SINGLE_PRECISION_LAYOUT);
+      TS_ASSERT_EQUALS(singleWs->getSpectrum(i).getNumberEvents(),
+                       doubleWs->getSpectrum(i).getNumberEvents());
+    }
+    const size_t index = 1000;
+    TS_ASSERT_EQUALS(singleWs->y(index), doubleWs->y(index));
+    // The file stores the times-of-flight in single precision
+    TS_ASSERT(singleWs->getSpectrum(index).getEvents() ==
+              doubleWs->getSpectrum(index).getEvents());
+
+    // The events of a resumed load are added to the single precision ones
+    const auto resumed = load("resumed_single_precision_events", true, true);
+    const size_t numEvents = resumed->getNumberEvents();
+    TS_ASSERT_EQUALS(resumed->getSpectrum(index).getStorageLayout(),
+                     SINGLE_PRECISION_LAYOUT);
+    std::istringstream banks(
+        resumed->run().getPropertyValueAsType<std::string>("loaded_pulses"));
+    std::string bank, noPulses;
+    while (banks >> bank)
+      noPulses += bank.substr(0, bank.rfind(':')) + ":0 ";
+    resumed->mutableRun().addProperty("loaded_pulses", noPulses, true);
+    TS_ASSERT_EQUALS(load("resumed_single_precision_events", true, true),
+                     resumed);
+    TS_ASSERT_EQUALS(resumed->getNumberEvents(), 2 * numEvents);
+    TS_ASSERT_EQUALS(resumed->getSpectrum(index).getStorageLayout(),
+                     SINGLE_PRECISION_LAYOUT);
+    AnalysisDataService::Instance().remove("single_precision_events");
+    AnalysisDataService::Instance().remove("double_precision_events");
+    AnalysisDataService::Instance().remove("resumed_single_precision_events");
+  }
+
+  void test_resume_adds_the_new_pulses_only() {
+    const std::string wsName = "resumed_events";
+    const auto load = [&wsName](const bool resume) {
+      LoadEventNexus ld;
+      ld.initialize();
+      ld.setPropertyValue("OutputWorkspace", wsName);
+      ld.setPropertyValue("Filename", "CNCS_7860_event.nxs");
+      ld.setProperty<bool>("LoadLogs", false); // Time-saver
+      ld.setProperty<bool>("Resume", resume);
+      TS_ASSERT(ld.execute());
+      return AnalysisDataService::Instance().retrieveWS<EventWorkspace>(
+          wsName);
+    };
+    const size_t allEvents = load(false)->getNumberEvents();
+    // Not loaded with Resume: everything is loaded again, but the last pulse
+    const auto ws = load(true);
+    const size_t numEvents = ws->getNumberEvents();
+    TS_ASSERT_LESS_THAN(0, numEvents);
+    TS_ASSERT_LESS_THAN_EQUALS(numEvents, allEvents);
+    const auto loaded =
+        ws->run().getPropertyValueAsType<std::string>("loaded_pulses");
+    TS_ASSERT_DIFFERS(loaded.find("bank1_events:"), std::string::npos);
+
+    // Nothing was written since
+    TS_ASSERT_EQUALS(load(true), ws);
+    TS_ASSERT_EQUALS(ws->getNumberEvents(), numEvents);
+
+    // As if the file had no pulses at the previous load
+    const size_t index = 1000;
+    const auto events = ws->getSpectrum(index).getEvents();
+    std::istringstream banks(loaded);
+    std::string bank, noPulses;
+    while (banks >> bank)
+      noPulses += bank.substr(0, bank.rfind(':')) + ":0 ";
+    ws->mutableRun().addProperty("loaded_pulses", noPulses, true);
+    TS_ASSERT_EQUALS(load(true), ws);
+    TS_ASSERT_EQUALS(ws->getNumberEvents(), 2 * numEvents);
+    const auto &twice = ws->getSpectrum(index).getEvents();
+    TS_ASSERT_EQUALS(twice.size(), 2 * events.size());
+    TS_ASSERT(std::equal(events.cbegin(), events.cend(),
+                         twice.cbegin() + events.size()));
+    TS_ASSERT_EQUALS(
+        ws->run().getPropertyValueAsType<std::string>("loaded_pulses"),
+        loaded);
+    AnalysisDataService::Instance().remove(wsName);
+  }
+
+  void test_resume_on_a_complete_file_reads_all_the_events() {
+    const auto load = [](const std::string &wsName, const bool resume,
+                         const bool complete) {
+      LoadEventNexus ld;
+      ld.initialize();
+      ld.setPropertyValue("OutputWorkspace", wsName);
+      ld.setPropertyValue("Filename", "CNCS_7860_event.nxs");
+      ld.setProperty<bool>("LoadLogs", false); // Time-saver
+      ld.setProperty<bool>("Resume", resume);
+      ld.setProperty<bool>("FileComplete", complete);
+      TS_ASSERT(ld.execute());
+      return AnalysisDataService::Instance().retrieveWS<EventWorkspace>(
+          wsName);
+    };
+    const auto plain = load("plain_events", false, false);
+    // The last pulse of each bank is left out, then read when complete
+    const auto ws = load("completed_events", true, false);
+    TS_ASSERT_LESS_THAN_EQUALS(ws->getNumberEvents(), plain->getNumberEvents());
+    TS_ASSERT_EQUALS(load("completed_events", true, true), ws);
+    TS_ASSERT_EQUALS(ws->getNumberEvents(), plain->getNumberEvents());
+    for (size_t i = 0; i < plain->getNumberHistograms(); ++i)
+      TS_ASSERT_EQUALS(ws->getSpectrum(i).getNumberEvents(),
+                       plain->getSpectrum(i).getNumberEvents());
+
+    // Nothing is left to read
+    TS_ASSERT_EQUALS(load("completed_events", true, true), ws);
+    TS_ASSERT_EQUALS(ws->getNumberEvents(), plain->getNumberEvents());
+    AnalysisDataService::Instance().remove("plain_events");
+    AnalysisDataService::Instance().remove("completed_events");
+  }
+
   void test_partial_spectra_loading_ISIS() {
     // This is to test a specific bug where if you selected any spectra and had
     // precount on you got double the number of events
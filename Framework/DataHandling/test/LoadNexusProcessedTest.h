@@ -19,6 +19,8 @@
 #include "MantidDataHandling/LoadNexusProcessed.h"
 #include "MantidDataHandling/SaveNexusProcessed.h"
 #include "MantidDataObjects/EventWorkspace.h"
+#include "MantidDataObjects/LazyHistogram1D.h"
+#include "MantidDataObjects/LazyWorkspace2D.h"
 #include "MantidDataObjects/Peak.h"
 #include "MantidDataObjects/PeakShapeSpherical.h"
 #include "MantidDataObjects/PeaksWorkspace.h"
@@ -239,14 +241,14 @@ public:
       Poco::File(filename).remove();
   }
 
-  void dotest_LoadAnEventFile(EventType type) {
+  void dotest_LoadAnEventFile(EventType type, bool compress = false) {
     std::string filename_root = "LoadNexusProcessed_ExecEvent_";
 
     // Call a function that writes out the file
     std::string outputFile;
     EventWorkspace_sptr origWS =
         SaveNexusProcessedTest::do_testExec_EventWorkspaces(
-            filename_root, type, outputFile, false, false);
+            filename_root, type, outputFile, false, false, true, compress);
 
     LoadNexusProcessed alg;
     TS_ASSERT_THROWS_NOTHING(alg.initialize());
@@ -315,6 +317,14 @@ public:
     dotest_LoadAnEventFile(WEIGHTED_NOTIME);
   }
 
+  void test_LoadEventNexus_compressed_TOF() {
+    dotest_LoadAnEventFile(TOF, true);
+  }
+
+  void test_LoadEventNexus_compressed_WEIGHTED() {
+    dotest_LoadAnEventFile(WEIGHTED, true);
+  }
+
   void test_loadEventNexus_Min() {
     writeTmpEventNexus();
 
@@ -933,6 +943,54 @@ public:
 
   void test_SaveAndLoadOnPointLikeWS() { doTestLoadAndSavePointWS(false); }
 
+  void test_lazy_loading() {
+    auto inputWs =
+        WorkspaceCreationHelper::create2DWorkspaceBinned(100, 10, 0., 1.);
+    for (size_t i = 0; i < inputWs->getNumberHistograms(); ++i) {
+      auto &y = inputWs->mutableY(i);
+      for (size_t j = 0; j < y.size(); ++j)
+        y[j] = static_cast<double>(i * 100 + j);
+    }
+    inputWs->setDistribution(true);
+    const std::string filename("TestLazyLoadNexusProcessed.nxs");
+    SaveNexusProcessed save;
+    save.initialize();
+    save.setProperty("InputWorkspace",
+                     boost::static_pointer_cast<MatrixWorkspace>(inputWs));
+    save.setPropertyValue("Filename", filename);
+    TS_ASSERT_THROWS_NOTHING(save.execute());
+
+    LoadNexusProcessed load;
+    load.initialize();
+    load.setChild(true);
+    load.setPropertyValue("Filename", filename);
+    load.setPropertyValue("OutputWorkspace", "unused");
+    load.setPropertyValue("SpectrumMin", "3");
+    load.setPropertyValue("SpectrumMax", "50");
+    load.setProperty("LazyLoading", true);
+    load.setProperty("LazyMemoryBudget", 0);
+    TS_ASSERT_THROWS_NOTHING(load.execute());
+    Workspace_sptr output = load.getProperty("OutputWorkspace");
+    auto outputWs = boost::dynamic_pointer_cast<LazyWorkspace2D>(output);
+    TS_ASSERT(outputWs);
+    if (outputWs) {
+      TS_ASSERT_EQUALS(outputWs->getNumberHistograms(), 48);
+      TS_ASSERT(outputWs->isDistribution());
+      for (size_t i = 0; i < outputWs->getNumberHistograms(); ++i) {
+        TS_ASSERT_EQUALS(outputWs->getSpectrum(i).getSpectrumNo(),
+                         inputWs->getSpectrum(i + 2).getSpectrumNo());
+        TS_ASSERT_EQUALS(outputWs->x(i), inputWs->x(i + 2));
+        TS_ASSERT_EQUALS(outputWs->y(i), inputWs->y(i + 2));
+        TS_ASSERT_EQUALS(outputWs->e(i), inputWs->e(i + 2));
+      }
+      // Nothing was modified while loading
+      TS_ASSERT_EQUALS(outputWs->pager().numberResident(), 48);
+      TS_ASSERT(!dynamic_cast<const LazyHistogram1D &>(outputWs->getSpectrum(0))
+                     .isPinned());
+    }
+    Poco::File(filename).remove();
+  }
+
   void test_SaveAndLoadOnPointLikeWSWithXErrors() {
     doTestLoadAndSavePointWS(true);
   }
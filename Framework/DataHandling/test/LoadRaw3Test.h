@@ -1149,6 +1149,43 @@ public:
     AnalysisDataService::Instance().clear();
   }
 
+  void test_scattered_spectra_of_all_periods_match_the_full_load() {
+    LoadRaw3 loadAll;
+    loadAll.initialize();
+    loadAll.setProperty("Filename", "CSP78173.raw");
+    loadAll.setProperty("OutputWorkspace", "allSpectra");
+    loadAll.execute();
+    auto all = AnalysisDataService::Instance().retrieveWS<WorkspaceGroup>(
+        "allSpectra");
+
+    // Spectra with a gap in between, read in two pieces in each period
+    LoadRaw3 loadSome;
+    loadSome.initialize();
+    loadSome.setProperty("Filename", "CSP78173.raw");
+    loadSome.setProperty("OutputWorkspace", "someSpectra");
+    loadSome.setPropertyValue("SpectrumList", "1,3,4");
+    loadSome.execute();
+    auto some = AnalysisDataService::Instance().retrieveWS<WorkspaceGroup>(
+        "someSpectra");
+    TS_ASSERT_EQUALS(some->getNumberOfEntries(), all->getNumberOfEntries());
+
+    for (size_t period = 0; period < all->size(); ++period) {
+      auto allWs =
+          boost::dynamic_pointer_cast<MatrixWorkspace>(all->getItem(period));
+      auto someWs =
+          boost::dynamic_pointer_cast<MatrixWorkspace>(some->getItem(period));
+      TS_ASSERT_EQUALS(someWs->getNumberHistograms(), 3);
+      for (size_t i = 0; i < someWs->getNumberHistograms(); ++i) {
+        const auto specNo = someWs->getSpectrum(i).getSpectrumNo();
+        const auto index = allWs->getIndexFromSpectrumNumber(specNo);
+        TS_ASSERT_EQUALS(someWs->y(i).rawData(), allWs->y(index).rawData());
+        TS_ASSERT_EQUALS(someWs->x(i).rawData(), allWs->x(index).rawData());
+      }
+    }
+
+    AnalysisDataService::Instance().clear();
+  }
+
 private:
   /// Helper method to run common set of tests on a workspace in a multi-period
   /// group.
@@ -17,6 +17,8 @@
 #include "MantidAPI/TableRow.h"
 #include "MantidAPI/WorkspaceFactory.h"
 #include "MantidAPI/WorkspaceGroup.h"
+#include "MantidDataHandling/ChunkedDeflate.h"
+#include "MantidDataHandling/H5Util.h"
 #include "MantidDataHandling/LoadEmptyInstrument.h"
 #include "MantidDataHandling/LoadInstrument.h"
 #include "MantidDataHandling/LoadMuonNexus.h"
@@ -31,6 +33,7 @@
 #include "MantidKernel/Strings.h"
 #include "MantidKernel/Unit.h"
 #include "MantidKernel/UnitFactory.h"
+#include <H5Cpp.h>
 #include <Poco/File.h>
 #include <Poco/Path.h>
 
@@ -328,6 +331,25 @@ public:
         true /* DONT preserve events */, true /* Compress */);
   }
 
+  void testExec_EventWorkspace_CompressNexus_writes_chunked_deflate() {
+    if (!ChunkedDeflate::isAvailable())
+      return;
+    std::string outputFile;
+    do_testExec_EventWorkspaces("SaveNexusProcessed_ChunkedDeflate", WEIGHTED,
+                                outputFile, false, false, true, true);
+
+    H5::H5File file = H5Util::openFile(outputFile, H5F_ACC_RDONLY);
+    H5::Group events = file.openGroup("mantid_workspace_1/event_workspace");
+    for (const auto &name : {"tof", "pulsetime", "weight", "error_squared"}) {
+      H5::DataSet dataset = events.openDataSet(name);
+      TSM_ASSERT(name, ChunkedDeflate::isChunkedDeflate(dataset));
+    }
+    file.close();
+
+    if (Poco::File(outputFile).exists())
+      Poco::File(outputFile).remove();
+  }
+
   void testExecSaveLabel() {
     SaveNexusProcessed alg;
     if (!alg.isInitialized())
@@ -0,0 +1,210 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_COMPACTEVENTS_H_
+#define MANTID_DATAOBJECTS_COMPACTEVENTS_H_
+
+#include "MantidDataObjects/Events.h"
+#include "MantidKernel/System.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Mantid {
+namespace DataObjects {
+
+/** CompactEvents : Lossless compact storage for the events of one EventList.
+
+  The events are stored column by column, each column in the smallest form
+  that reproduces the original values exactly:
+
+  - The time-of-flight is kept in single precision if every value survives the
+    round trip through a float, as is the case for TOFs read from event NeXus
+    files. Otherwise, if every value lies exactly on a decimal grid (whole
+    microseconds, tenths, ... down to picoseconds), it is kept as a 32-bit
+    offset from the smallest value, in steps of the grid. Only TOFs that fit
+    neither are kept in double precision.
+  - The pulse times are kept in a sorted table of distinct pulse times and each
+    event stores a 16-bit index into the table (32-bit if there are more than
+    65536 pulses). The table is split into blocks of up to 256 pulses; each
+    block keeps its first pulse time and 32-bit offsets from it, as long as a
+    block spans less than about 4 seconds.
+  - Weights and squared errors are dropped when they are all 1, e.g. after
+    converting unweighted events to weighted ones.
+
+  A TofEvent then takes 6 bytes instead of 16 when many events share a pulse,
+  and about 10 bytes (12 with more than 65536 pulses) when every event has a
+  pulse of its own, as for a single pixel. The events are decoded on the
+  fly by the histogramming, integration and filtering methods below; filtering
+  by pulse time selects on the pulse indices and only decodes the events it
+  keeps.
+
+  The time-of-flight can also be rounded to single precision on purpose
+  (roundTof in assign()), which is lossy but keeps it in 4 bytes through unit
+  conversions. Without rounding, converting single precision values widens
+  them to double precision.
+*/
+class DLLExport CompactEvents {
+public:
+  void assign(const std::vector<Types::Event::TofEvent> &events,
+              const bool roundTof = false);
+  void assign(const std::vector<WeightedEvent> &events,
+              const bool roundTof = false);
+  void assign(const std::vector<WeightedEventNoTime> &events,
+              const bool roundTof = false);
+
+  void extract(std::vector<Types::Event::TofEvent> &events) const;
+  void extract(std::vector<WeightedEvent> &events) const;
+  void extract(std::vector<WeightedEventNoTime> &events) const;
+
+  /// @return the number of events
+  size_t size() const { return m_numEvents; }
+  /// @return true if there are no events
+  bool empty() const { return m_numEvents == 0; }
+  void clear();
+  size_t getMemorySize() const;
+
+  /// @return true if pulse times are stored
+  bool hasPulseTimes() const { return m_hasPulseTimes; }
+  /// @return true if weights are stored
+  bool hasWeights() const { return m_hasWeights; }
+  /// @return true if the time-of-flight is stored in single precision
+  bool hasSinglePrecisionTof() const {
+    return m_tofStorage == TofStorage::Single;
+  }
+  /// @return true if the time-of-flight is stored as offsets on a grid
+  bool hasOffsetTof() const { return m_tofStorage == TofStorage::Offset; }
+  /// @return true if the time-of-flight is rounded to single precision
+  bool roundsTof() const { return m_roundTof; }
+  /// @return true if the events are sorted by time-of-flight
+  bool isSortedByTof() const { return m_sortedByTof; }
+  /// @return the number of distinct pulse times
+  size_t getNumberPulseTimes() const { return m_numPulses; }
+
+  /// @return the time-of-flight of an event
+  double tof(const size_t i) const {
+    switch (m_tofStorage) {
+    case TofStorage::Single:
+      return static_cast<double>(m_singleTof[i]);
+    case TofStorage::Offset:
+      return offsetToTof(m_tofOffset[i]);
+    default:
+      return m_doubleTof[i];
+    }
+  }
+  /// @return the pulse time of an event, in nanoseconds
+  int64_t pulseTime(const size_t i) const {
+    return pulseTableEntry(pulseIndex(i));
+  }
+  /// @return the weight of an event
+  float weight(const size_t i) const {
+    return m_weight.empty() ? 1.0f : m_weight[i];
+  }
+  /// @return the squared error of an event
+  float errorSquared(const size_t i) const {
+    return m_errorSquared.empty() ? 1.0f : m_errorSquared[i];
+  }
+
+  void sortTof();
+  void reverse();
+  void convertTof(const double factor, const double offset);
+  void convertTof(const std::function<double(double)> &func);
+  double getTofMin() const;
+  double getTofMax() const;
+  int64_t getPulseTimeMin() const;
+  int64_t getPulseTimeMax() const;
+
+  void histogram(const MantidVec &X, MantidVec &Y, MantidVec &E) const;
+  void integrate(const double minX, const double maxX, const bool entireRange,
+                 double &sum, double &error) const;
+  void filterByPulseTime(const int64_t start, const int64_t stop,
+                         std::vector<Types::Event::TofEvent> &output) const;
+  void filterByPulseTime(const int64_t start, const int64_t stop,
+                         std::vector<WeightedEvent> &output) const;
+
+private:
+  /// How the time-of-flight column is stored
+  enum class TofStorage { Single, Offset, Double };
+
+  /** @return the time-of-flight of an offset. A single division of two exact
+   * values, so it gives back exactly the value checked when encoding. */
+  double offsetToTof(const uint32_t offset) const {
+    return static_cast<double>(m_tofBase + static_cast<int64_t>(offset)) /
+           m_tofScale;
+  }
+  /// @return the pulse time at an index of the table, in nanoseconds
+  int64_t pulseTableEntry(const size_t index) const {
+    if (m_pulseOffset.empty())
+      return m_pulseBase[index];
+    return m_pulseBase[index >> m_pulseBlockShift] + m_pulseOffset[index];
+  }
+  /// @return the index of the pulse time of an event in the table
+  size_t pulseIndex(const size_t i) const {
+    return m_widePulseIndex.empty() ? m_narrowPulseIndex[i]
+                                    : m_widePulseIndex[i];
+  }
+  template <class T>
+  void assignTofs(const std::vector<T> &events, const bool roundTof);
+  template <class T> bool assignOffsetTofs(const std::vector<T> &events);
+  void widenTofs();
+  template <class Func> void transformTofs(const Func &func);
+  template <class T> void assignPulseTimes(const std::vector<T> &events);
+  void assignPulseTable(std::vector<int64_t> &table);
+  size_t lowerPulseIndex(const int64_t pulseTime) const;
+  template <class T> void assignWeights(const std::vector<T> &events);
+  template <class T>
+  void filterByPulseTimeHelper(const int64_t start, const int64_t stop,
+                               std::vector<T> &output) const;
+  void appendEvent(const size_t i,
+                   std::vector<Types::Event::TofEvent> &output) const;
+  void appendEvent(const size_t i, std::vector<WeightedEvent> &output) const;
+
+  /// Number of events
+  size_t m_numEvents{0};
+  /// Time-of-flight when it is exact in single precision
+  std::vector<float> m_singleTof;
+  /// Time-of-flight as offsets from m_tofBase, in steps of 1 / m_tofScale
+  std::vector<uint32_t> m_tofOffset;
+  /// Smallest time-of-flight, in steps of 1 / m_tofScale
+  int64_t m_tofBase{0};
+  /// Number of offset steps per unit of time-of-flight, a power of 10
+  double m_tofScale{1.};
+  /// Time-of-flight otherwise
+  std::vector<double> m_doubleTof;
+  /// Number of distinct pulse times
+  size_t m_numPulses{0};
+  /// First pulse time of each block of the table, in nanoseconds, or the
+  /// whole table if m_pulseOffset is empty
+  std::vector<int64_t> m_pulseBase;
+  /// Offset of each pulse time from the first one of its block
+  std::vector<uint32_t> m_pulseOffset;
+  /// log2 of the number of pulse times in a block
+  unsigned m_pulseBlockShift{0};
+  /// Index of the pulse time of each event when there are few pulses
+  std::vector<uint16_t> m_narrowPulseIndex;
+  /// Index of the pulse time of each event otherwise
+  std::vector<uint32_t> m_widePulseIndex;
+  /// Weight of each event; empty if all are 1
+  std::vector<float> m_weight;
+  /// Squared error of each event; empty if all are 1
+  std::vector<float> m_errorSquared;
+  /// Which of the time-of-flight columns is in use
+  TofStorage m_tofStorage{TofStorage::Single};
+  /// True if the time-of-flight is rounded to single precision
+  bool m_roundTof{false};
+  /// True if pulse times are stored
+  bool m_hasPulseTimes{false};
+  /// True if the events are weighted
+  bool m_hasWeights{false};
+  /// True if the events are sorted by time-of-flight
+  bool m_sortedByTof{true};
+};
+
+} // namespace DataObjects
+} // namespace Mantid
+
+#endif /* MANTID_DATAOBJECTS_COMPACTEVENTS_H_ */
@@ -51,6 +51,8 @@ public:
   std::string toXMLString() const override;
   std::string id() const override;
   void apply(const coord_t *inputVector, coord_t *outVector) const override;
+  void applyToBatch(const coord_t *inputVectors, coord_t *outVectors,
+                    size_t numVectors) const override;
   Mantid::Kernel::Matrix<coord_t> makeAffineMatrix() const override;
 
 protected:
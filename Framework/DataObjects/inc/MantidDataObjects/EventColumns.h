@@ -0,0 +1,94 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_EVENTCOLUMNS_H_
+#define MANTID_DATAOBJECTS_EVENTCOLUMNS_H_
+
+#include "MantidDataObjects/Events.h"
+#include "MantidKernel/System.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Mantid {
+namespace DataObjects {
+
+/** EventColumns : Structure-of-arrays storage for the events of one
+  EventList.
+
+  The time-of-flight, pulse time, weight and squared error of each event are
+  held in separate contiguous arrays instead of the packed TofEvent,
+  WeightedEvent or WeightedEventNoTime structs. Operations that only look at
+  the time-of-flight (histogramming, unit conversion, masking) therefore read
+  8 bytes per event rather than 16 or 24, and the inner loops run over plain
+  arrays of doubles that the compiler can vectorize.
+
+  Which columns are populated depends on the event type that was assigned:
+  pulse times are kept for TofEvent and WeightedEvent, weights and squared
+  errors for WeightedEvent and WeightedEventNoTime.
+*/
+class DLLExport EventColumns {
+public:
+  void assign(const std::vector<Types::Event::TofEvent> &events);
+  void assign(const std::vector<WeightedEvent> &events);
+  void assign(const std::vector<WeightedEventNoTime> &events);
+
+  void extract(std::vector<Types::Event::TofEvent> &events) const;
+  void extract(std::vector<WeightedEvent> &events) const;
+  void extract(std::vector<WeightedEventNoTime> &events) const;
+
+  /// @return the number of events held in the columns
+  size_t size() const { return m_tof.size(); }
+  /// @return true if there are no events
+  bool empty() const { return m_tof.empty(); }
+  void clear();
+  size_t getMemorySize() const;
+
+  /// @return true if the pulse time column is populated
+  bool hasPulseTimes() const { return m_hasPulseTimes; }
+  /// @return true if the weight and error columns are populated
+  bool hasWeights() const { return m_hasWeights; }
+
+  /// @return the time-of-flight column
+  const std::vector<double> &tofs() const { return m_tof; }
+  /// @return the pulse time column, in nanoseconds since the GPS epoch
+  const std::vector<int64_t> &pulseTimes() const { return m_pulseTime; }
+  /// @return the weight column
+  const std::vector<float> &weights() const { return m_weight; }
+  /// @return the squared error column
+  const std::vector<float> &errorSquareds() const { return m_errorSquared; }
+
+  void sortTof();
+  void reverse();
+  void convertTof(const double factor, const double offset);
+  void convertTof(const std::function<double(double)> &func);
+  size_t maskTof(const double tofMin, const double tofMax);
+  void histogram(const MantidVec &X, MantidVec &Y, MantidVec &E) const;
+  void integrate(const double minX, const double maxX, const bool entireRange,
+                 double &sum, double &error) const;
+
+private:
+  void erase(const size_t first, const size_t last);
+
+  /// Time-of-flight (or converted x value) of each event
+  std::vector<double> m_tof;
+  /// Pulse time of each event, in nanoseconds
+  std::vector<int64_t> m_pulseTime;
+  /// Weight of each event
+  std::vector<float> m_weight;
+  /// Squared error of each event
+  std::vector<float> m_errorSquared;
+  /// True if m_pulseTime is in use
+  bool m_hasPulseTimes{false};
+  /// True if m_weight and m_errorSquared are in use
+  bool m_hasWeights{false};
+};
+
+} // namespace DataObjects
+} // namespace Mantid
+
+#endif /* MANTID_DATAOBJECTS_EVENTCOLUMNS_H_ */
@@ -0,0 +1,137 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_EVENTHISTOGRAMCACHE_H_
+#define MANTID_DATAOBJECTS_EVENTHISTOGRAMCACHE_H_
+
+#include "MantidHistogramData/HistogramE.h"
+#include "MantidHistogramData/HistogramY.h"
+#include "MantidKernel/System.h"
+#include "MantidKernel/cow_ptr.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace Mantid {
+namespace DataObjects {
+
+class EventList;
+
+/** EventHistogramCache : Cache of the Y and E histograms generated from the
+  event lists of an EventWorkspace.
+
+  The cache is shared by all threads. It is split into shards, selected from
+  the address of the event list, each with its own mutex and
+  least-recently-used list, so that threads reading different spectra rarely
+  wait for each other.
+
+  Every event list carries a generation number, taken from newGeneration()
+  whenever its X values or events are reset. A cached histogram is only
+  returned if it was generated for the current generation of the list, so
+  invalidating a histogram does not need to touch the cache at all.
+
+  The cache holds at most getMemoryLimit() bytes of histograms, shared evenly
+  between the shards; the least recently used histograms are evicted first.
+  Evicting a histogram only drops the reference held by the cache.
+  EventList::dataY() and dataE() return references into a histogram, so they
+  pin() it: each thread owns the last PINNED_PER_THREAD histograms it read,
+  and a reference stays valid until the same thread has read that many
+  others, however the cache is used by other threads meanwhile.
+
+  The default limit is given in megabytes by the
+  EventWorkspace.HistogramCacheSize configuration key. The hits, misses and
+  evictions are counted and returned by statistics().
+*/
+class DLLExport EventHistogramCache {
+public:
+  using YType = Kernel::cow_ptr<HistogramData::HistogramY>;
+  using EType = Kernel::cow_ptr<HistogramData::HistogramE>;
+
+  /// Usage counters of the cache
+  struct Statistics {
+    /// Number of histograms found in the cache
+    size_t hits{0};
+    /// Number of histograms not found, or found for an older generation
+    size_t misses{0};
+    /// Number of histograms dropped to stay within the memory limit
+    size_t evictions{0};
+    /// Number of histograms currently cached
+    size_t entries{0};
+    /// Memory used by the cached histograms, in bytes
+    size_t memoryUsed{0};
+  };
+
+  EventHistogramCache();
+  explicit EventHistogramCache(const size_t memoryLimit);
+  EventHistogramCache(const EventHistogramCache &) = delete;
+  EventHistogramCache &operator=(const EventHistogramCache &) = delete;
+
+  /// Number of histograms kept alive by each thread after reading them
+  static constexpr size_t PINNED_PER_THREAD = 50;
+
+  static size_t defaultMemoryLimit();
+  static uint64_t newGeneration();
+  static void pin(const YType &y, const EType &e);
+
+  bool find(const EventList *list, const uint64_t generation, YType &y,
+            EType &e);
+  void insert(const EventList *list, const uint64_t generation, YType y,
+              EType e);
+  void erase(const EventList *list);
+  void clear();
+
+  void setMemoryLimit(const size_t memoryLimit);
+  /// @return the maximum memory used by the cached histograms, in bytes
+  size_t getMemoryLimit() const { return m_memoryLimit; }
+
+  size_t size() const;
+  Statistics statistics() const;
+  void resetStatistics();
+
+private:
+  /// Number of bits of the address hash selecting the shard
+  static constexpr int SHARD_BITS = 6;
+  /// Number of shards
+  static constexpr size_t NUM_SHARDS = size_t(1) << SHARD_BITS;
+
+  /// The histograms of one event list
+  struct Entry {
+    const EventList *list;
+    uint64_t generation;
+    YType y;
+    EType e;
+    size_t memory;
+  };
+
+  /// An independently locked part of the cache
+  struct Shard {
+    mutable std::mutex mutex;
+    /// Entries, most recently used first
+    std::list<Entry> entries;
+    /// Position of the entry of each event list
+    std::unordered_map<const EventList *, std::list<Entry>::iterator> index;
+    size_t memoryUsed{0};
+    size_t hits{0};
+    size_t misses{0};
+    size_t evictions{0};
+  };
+
+  Shard &shardOf(const EventList *list);
+  void evict(Shard &shard);
+  static void remove(Shard &shard, std::list<Entry>::iterator entry);
+
+  std::array<Shard, NUM_SHARDS> m_shards;
+  std::atomic<size_t> m_memoryLimit;
+};
+
+} // namespace DataObjects
+} // namespace Mantid
+
+#endif /* MANTID_DATAOBJECTS_EVENTHISTOGRAMCACHE_H_ */
@@ -0,0 +1,88 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_EVENTHISTOGRAMMER_H_
+#define MANTID_DATAOBJECTS_EVENTHISTOGRAMMER_H_
+
+#include "MantidDataObjects/Events.h"
+#include "MantidKernel/System.h"
+
+#include <vector>
+
+namespace Mantid {
+namespace DataObjects {
+
+/** EventHistogrammer : Histograms events into linear or logarithmic bins
+  without searching the bin edges.
+
+  On construction the bin edges are inspected. If they have a constant width
+  (linear binning) or a constant ratio (logarithmic binning), as produced by
+  Rebin, the bin of each event is computed arithmetically from its
+  time-of-flight. The last bin is allowed to be shorter than the others, as is
+  the case when the binning range is not a multiple of the step. The estimate
+  is checked against the actual edges so the result is identical to a search,
+  whatever the rounding of the edges.
+
+  The bin estimates are computed for blocks of events in a tight loop that the
+  compiler can vectorize. Large event lists are split between threads that
+  fill private partial histograms which are summed at the end, unless the call
+  is already made from within a parallel region.
+
+  The events do not need to be sorted.
+
+  Use forEdges to histogram many spectra with the same bin edges: the
+  detection is then only repeated when the edges change.
+*/
+class DLLExport EventHistogrammer {
+public:
+  /// The kind of binning detected from the bin edges
+  enum class BinningType { Irregular, Linear, Logarithmic };
+
+  explicit EventHistogrammer(const MantidVec &X);
+
+  static const EventHistogrammer &forEdges(const MantidVec &X);
+
+  /// @return the kind of binning of the edges
+  BinningType binningType() const { return m_type; }
+  /// @return true if the bins can be found arithmetically
+  bool isRegular() const { return m_type != BinningType::Irregular; }
+
+  size_t findBin(const double x) const;
+
+  void countEvents(const std::vector<Types::Event::TofEvent> &events,
+                   MantidVec &Y) const;
+  void sumWeights(const std::vector<WeightedEvent> &events, MantidVec &Y,
+                  MantidVec &E) const;
+  void sumWeights(const std::vector<WeightedEventNoTime> &events,
+                  MantidVec &Y, MantidVec &E) const;
+
+private:
+  template <class T>
+  void histogram(const std::vector<T> &events, MantidVec &Y,
+                 MantidVec *E) const;
+  template <class T>
+  void fill(const T *first, const T *last, double *Y, double *E) const;
+  template <class T>
+  void estimateBins(const T *events, const size_t numEvents,
+                    double *estimates) const;
+  size_t refineBin(const double x, const double estimate) const;
+
+  /// The bin edges
+  const MantidVec &m_x;
+  /// Number of bins
+  size_t m_numBins;
+  /// The kind of binning
+  BinningType m_type;
+  /// First bin edge, or its inverse for logarithmic binning
+  double m_start;
+  /// Inverse of the bin width, or of the log of the bin ratio
+  double m_inverseStep;
+};
+
+} // namespace DataObjects
+} // namespace Mantid
+
+#endif /* MANTID_DATAOBJECTS_EVENTHISTOGRAMMER_H_ */
@@ -8,10 +8,14 @@
 #define MANTID_DATAOBJECTS_EVENTLIST_H_ 1
 
 #include "MantidAPI/IEventList.h"
+#include "MantidDataObjects/CompactEvents.h"
+#include "MantidDataObjects/EventColumns.h"
+#include "MantidDataObjects/EventSplitter.h"
 #include "MantidDataObjects/Events.h"
 #include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/System.h"
 #include "MantidKernel/cow_ptr.h"
+#include <atomic>
 #include <iosfwd>
 #include <vector>
 
@@ -27,7 +31,7 @@ using TimeSplitterType = std::vector<SplittingInterval>;
 class Unit;
 } // namespace Kernel
 namespace DataObjects {
-class EventWorkspaceMRU;
+class EventHistogramCache;
 
 /// How the event list is sorted.
 enum EventSortType {
@@ -39,6 +43,18 @@ enum EventSortType {
   TIMEATSAMPLE_SORT
 };
 
+/// How the events of an event list are laid out in memory.
+enum EventStorageLayout {
+  /// One packed event struct after the other (array-of-structs)
+  ROW_LAYOUT,
+  /// Separate TOF, pulse-time and weight arrays (structure-of-arrays)
+  COLUMN_LAYOUT,
+  /// Lossless compressed columns (see CompactEvents)
+  COMPACT_LAYOUT,
+  /// Compressed columns with the time-of-flight rounded to single precision
+  SINGLE_PRECISION_LAYOUT
+};
+
 //==========================================================================================
 /** @class Mantid::DataObjects::EventList
 
@@ -51,6 +67,14 @@ enum EventSortType {
     or WeightedEvent (where each neutron can have a non-1 weight).
     This is done transparently.
 
+    The events can also be held in a columnar layout (see EventColumns and
+   setStorageLayout()). Histogramming, TOF conversion, masking and
+   integration then work directly on the TOF column; any other operation,
+   e.g. scaling the weights, shifting the pulse times or splitting, converts
+   the list back to the row layout first. The compact layout
+   (see CompactEvents) encodes the columns losslessly in fewer bytes per
+   event, for workspaces that do not fit in memory otherwise.
+
     @author Janik Zikovsky, SNS ORNL
     @date 4/02/2010
 */
@@ -59,7 +83,7 @@ class DLLExport EventList : public Mantid::API::IEventList {
 public:
   EventList();
 
-  EventList(EventWorkspaceMRU *mru, specnum_t specNo);
+  EventList(EventHistogramCache *histogramCache, specnum_t specNo);
 
   EventList(const EventList &rhs);
 
@@ -105,6 +129,7 @@ public:
    * @param event :: TofEvent to add at the end of the list.
    * */
   inline void addEventQuickly(const Types::Event::TofEvent &event) {
+    ensureRowLayout();
     this->events.push_back(event);
     this->order = UNSORTED;
   }
@@ -115,6 +140,7 @@ public:
    * @param event :: WeightedEvent to add at the end of the list.
    * */
   inline void addEventQuickly(const WeightedEvent &event) {
+    ensureRowLayout();
     this->weightedEvents.push_back(event);
     this->order = UNSORTED;
   }
@@ -125,6 +151,7 @@ public:
    * @param event :: WeightedEventNoTime to add at the end of the list.
    * */
   inline void addEventQuickly(const WeightedEventNoTime &event) {
+    ensureRowLayout();
     this->weightedEventsNoTime.push_back(event);
     this->order = UNSORTED;
   }
@@ -133,6 +160,10 @@ public:
 
   void switchTo(Mantid::API::EventType newType) override;
 
+  void setStorageLayout(const EventStorageLayout layout);
+
+  EventStorageLayout getStorageLayout() const;
+
   WeightedEvent getEvent(size_t event_number);
 
   std::vector<Types::Event::TofEvent> &getEvents();
@@ -147,7 +178,7 @@ public:
   void clear(const bool removeDetIDs = true) override;
   void clearUnused();
 
-  void setMRU(EventWorkspaceMRU *newMRU);
+  void setHistogramCache(EventHistogramCache *histogramCache);
 
   void clearData() override;
 
@@ -168,7 +199,8 @@ public:
 
   EventSortType getSortType() const;
 
-  // X-vector accessors. These reset the MRU for this spectrum
+  // X-vector accessors. These invalidate the cached histograms of this
+  // spectrum
   void setX(const Kernel::cow_ptr<HistogramData::HistogramX> &X) override;
   MantidVec &dataX() override;
   const MantidVec &dataX() const override;
@@ -312,6 +344,11 @@ public:
                                   const std::vector<int> &vec_target,
                                   std::map<int, EventList *> outputs) const;
 
+  /// Split events with a precomputed splitter, one output per target slot
+  void splitByIndex(const EventSplitter &splitter,
+                    const std::vector<EventList *> &outputs,
+                    const EventSplitter::EventTime &eventTime) const;
+
   void multiply(const double value, const double error = 0.0) override;
   EventList &operator*=(const double value);
 
@@ -382,12 +419,45 @@ private:
   /// Last sorting order
   mutable EventSortType order;
 
-  /// MRU lists of the parent EventWorkspace
-  mutable EventWorkspaceMRU *mru;
+  /// Histogram cache of the parent EventWorkspace
+  mutable EventHistogramCache *m_histogramCache;
+
+  /// Generation of the events and X values, compared with the cached
+  /// histograms
+  uint64_t m_cacheGeneration{0};
 
   /// Mutex that is locked while sorting an event list
   mutable std::mutex m_sortMutex;
 
+  /// Events held in columns when the list uses COLUMN_LAYOUT
+  mutable EventColumns m_columns;
+
+  /// Events held in compressed columns when the list uses COMPACT_LAYOUT or
+  /// SINGLE_PRECISION_LAYOUT
+  mutable CompactEvents m_compact;
+
+  /** Current memory layout of the events. Atomic because the const accessors
+   * check it without m_sortMutex. Reading or converting the columns always
+   * takes the mutex, since a const accessor may free them. */
+  mutable std::atomic<EventStorageLayout> m_layout{ROW_LAYOUT};
+
+  /** Make sure the events are held in the row vectors. Cheap if they
+   * already are; otherwise the columns are converted back. */
+  inline void ensureRowLayout() const {
+    if (m_layout != ROW_LAYOUT)
+      switchToRowLayout();
+  }
+  void switchToRowLayout() const;
+  /// @return true if the events are held in m_compact
+  inline bool hasCompactLayout() const {
+    const EventStorageLayout layout = m_layout;
+    return layout == COMPACT_LAYOUT || layout == SINGLE_PRECISION_LAYOUT;
+  }
+  void invalidateHistogramCache();
+  void findOrGenerateHistogram(
+      Kernel::cow_ptr<HistogramData::HistogramY> &yData,
+      Kernel::cow_ptr<HistogramData::HistogramE> &eData) const;
+
   template <class T>
   static typename std::vector<T>::const_iterator
   findFirstPulseEvent(const std::vector<T> &events,
@@ -0,0 +1,106 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_EVENTSPLITTER_H_
+#define MANTID_DATAOBJECTS_EVENTSPLITTER_H_
+
+#include "MantidDataObjects/Events.h"
+#include "MantidKernel/System.h"
+#include "MantidKernel/TimeSplitter.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Mantid {
+namespace DataObjects {
+
+/** EventSplitter : Splits events between targets according to consecutive
+  time intervals.
+
+  The intervals are given once, as sorted boundaries and the target of each
+  interval, and indexed on construction: the targets are numbered by "slots",
+  their position in targets(), so that splitting an event list needs neither
+  maps nor lookups by target. Interval i covers [times[i], times[i+1]); events
+  outside all intervals are dropped.
+
+  The events are assigned to intervals with a cursor that moves forward
+  with the (pulse time sorted) events, falling back to a binary search when
+  the time goes backwards, so that each event costs O(1) on average. The
+  events of each slot are then counted and copied once to their destination,
+  which is allocated at its exact size. Large event lists are split into
+  blocks handled by different threads, unless the call is already made from
+  within a parallel region.
+
+  The result can either be written to one vector per slot, with split(), or
+  to a single vector grouped by slot, with partition(), whose slots are then
+  views given by the offsets.
+*/
+class DLLExport EventSplitter {
+public:
+  /// How the time of an event is compared to the intervals
+  struct EventTime {
+    /// Only use the pulse time, not the time-of-flight
+    bool pulseTimeOnly{false};
+    /// Correct the time-of-flight as tofFactor * tof + tofShift
+    bool correctTof{false};
+    /// Factor applied to the time-of-flight
+    double tofFactor{1.};
+    /// Shift of the time-of-flight, in seconds
+    double tofShift{0.};
+  };
+
+  /// Slot of the events outside all intervals
+  static constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
+  EventSplitter(std::vector<int64_t> times, const std::vector<int> &targets);
+  explicit EventSplitter(const Kernel::TimeSplitterType &splitters);
+
+  /// @return the distinct targets, in increasing order, indexed by slot
+  const std::vector<int> &targets() const { return m_targets; }
+  /// @return the number of targets
+  size_t numberOfTargets() const { return m_targets.size(); }
+  /// @return the number of intervals
+  size_t numberOfIntervals() const { return m_slotOfInterval.size(); }
+
+  uint32_t slotOf(const int target) const;
+  uint32_t findSlot(const int64_t time) const;
+
+  template <class T>
+  void split(const std::vector<T> &events, const EventTime &eventTime,
+             const std::vector<std::vector<T> *> &outputs) const;
+
+  template <class T>
+  void partition(const std::vector<T> &events, const EventTime &eventTime,
+                 std::vector<T> &grouped, std::vector<size_t> &offsets) const;
+
+private:
+  void index(const std::vector<int> &targets);
+  size_t findInterval(const int64_t time) const;
+  size_t numberOfThreads(const size_t numEvents) const;
+
+  template <class T>
+  void assignSlots(const std::vector<T> &events, const EventTime &eventTime,
+                   const size_t numBlocks, std::vector<uint32_t> &slots,
+                   std::vector<std::vector<size_t>> &counts) const;
+  template <class T>
+  void scatter(const std::vector<T> &events,
+               const std::vector<uint32_t> &slots, const size_t numBlocks,
+               std::vector<std::vector<size_t>> &positions,
+               const std::vector<T *> &destinations) const;
+
+  /// Boundaries of the intervals, sorted
+  std::vector<int64_t> m_times;
+  /// Slot of the target of each interval
+  std::vector<uint32_t> m_slotOfInterval;
+  /// Distinct targets, sorted
+  std::vector<int> m_targets;
+};
+
+} // namespace DataObjects
+} // namespace Mantid
+
+#endif /* MANTID_DATAOBJECTS_EVENTSPLITTER_H_ */
@@ -20,7 +20,7 @@ class Progress;
 }
 
 namespace DataObjects {
-class EventWorkspaceMRU;
+class EventHistogramCache;
 
 /** \class EventWorkspace
 
@@ -135,6 +135,9 @@ public:
   // Change the event type
   void switchEventType(const Mantid::API::EventType type);
 
+  // Change the memory layout of the events in all event lists
+  void setStorageLayout(const EventStorageLayout layout);
+
   // Returns true always - an EventWorkspace always represents histogramm-able
   // data
   bool isHistogramData() const override;
@@ -143,6 +146,9 @@ public:
 
   void clearMRU() const override;
 
+  // Cache of the histograms generated from the event lists
+  EventHistogramCache &histogramCache() const;
+
   EventSortType getSortType() const;
 
   // Sort all event lists. Uses a parallelized algorithm
@@ -171,8 +177,8 @@ private:
    */
   std::vector<EventList *> data;
 
-  /// Container for the MRU lists of the event lists contained.
-  mutable EventWorkspaceMRU *mru;
+  /// Cache of the histograms generated from the event lists contained.
+  mutable EventHistogramCache *m_histogramCache;
 };
 
 /// shared pointer to the EventWorkspace class
@@ -0,0 +1,81 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_HISTOGRAMPAGER_H_
+#define MANTID_DATAOBJECTS_HISTOGRAMPAGER_H_
+
+#include "MantidDataObjects/HistogramSource.h"
+#include "MantidKernel/System.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace Mantid {
+namespace DataObjects {
+class LazyHistogram1D;
+
+/** HistogramPager : Reads the histograms of a LazyWorkspace2D from its
+  HistogramSource when they are first accessed, and drops the least recently
+  used ones again when the memory they use exceeds a budget.
+
+  Eviction uses the CLOCK (second chance) approximation of LRU: accessing a
+  resident spectrum only sets a flag, so the common path only takes the lock
+  of the spectrum. A minimum number of spectra is always kept, however small
+  the budget, so that spectra read in turn are not read again at once. Evicted
+  data may be kept alive a little longer by the threads that read it, see
+  LazyHistogram1D.
+
+  Spectra that are modified are pinned: they are loaded if needed, then never
+  evicted and not counted against the budget.
+
+  The lock of the pager is always taken before the lock of a spectrum.
+*/
+class DLLExport HistogramPager {
+public:
+  /// Number of spectra kept resident regardless of the budget
+  static constexpr size_t MIN_RESIDENT = 64;
+
+  HistogramPager(std::unique_ptr<HistogramSource> source,
+                 const size_t memoryBudget,
+                 const size_t minResident = MIN_RESIDENT);
+  HistogramPager(const HistogramPager &) = delete;
+  HistogramPager &operator=(const HistogramPager &) = delete;
+
+  const HistogramSource &source() const { return *m_source; }
+  HistogramData::Histogram::XMode xMode() const { return m_xMode; }
+  /// Memory budget for the resident, unpinned spectra in bytes
+  size_t memoryBudget() const { return m_memoryBudget; }
+  size_t residentMemory() const;
+  size_t numberResident() const;
+  size_t numberLoaded() const;
+
+private:
+  friend class LazyHistogram1D;
+
+  std::shared_ptr<HistogramData::Histogram> pageIn(LazyHistogram1D &spectrum);
+  void pin(LazyHistogram1D &spectrum);
+  void release(LazyHistogram1D &spectrum);
+
+  void load(LazyHistogram1D &spectrum);
+  void evict();
+
+  std::unique_ptr<HistogramSource> m_source;
+  const HistogramData::Histogram::XMode m_xMode;
+  const size_t m_memoryBudget;
+  const size_t m_minResident;
+  /// Spectra that can be evicted, in the order they were loaded
+  std::list<LazyHistogram1D *> m_resident;
+  size_t m_residentMemory{0};
+  /// Number of reads from the source
+  size_t m_loaded{0};
+  mutable std::mutex m_mutex;
+};
+
+} // namespace DataObjects
+} // namespace Mantid
+
+#endif /* MANTID_DATAOBJECTS_HISTOGRAMPAGER_H_ */
@@ -0,0 +1,42 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_HISTOGRAMSOURCE_H_
+#define MANTID_DATAOBJECTS_HISTOGRAMSOURCE_H_
+
+#include "MantidHistogramData/Histogram.h"
+#include "MantidKernel/System.h"
+
+namespace Mantid {
+namespace DataObjects {
+
+/** HistogramSource : Interface for a store, typically a file, from which the
+  histograms of a LazyWorkspace2D are read when they are first accessed.
+
+  All histograms must have the same Y mode and the same numbers of X and Y
+  values. Calls are serialized by HistogramPager, so implementations do not
+  need to be thread-safe.
+*/
+class DLLExport HistogramSource {
+public:
+  virtual ~HistogramSource() = default;
+
+  /// Number of histograms in the source
+  virtual size_t size() const = 0;
+  /// Number of Y values in each histogram
+  virtual size_t blocksize() const = 0;
+  /// Number of X values in each histogram
+  virtual size_t xLength() const = 0;
+  virtual HistogramData::Histogram::YMode yMode() const = 0;
+
+  /// Read the histogram at the given index
+  virtual HistogramData::Histogram histogram(const size_t index) = 0;
+};
+
+} // namespace DataObjects
+} // namespace Mantid
+
+#endif /* MANTID_DATAOBJECTS_HISTOGRAMSOURCE_H_ */
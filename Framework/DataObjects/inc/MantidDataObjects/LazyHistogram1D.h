@@ -0,0 +1,94 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_LAZYHISTOGRAM1D_H_
+#define MANTID_DATAOBJECTS_LAZYHISTOGRAM1D_H_
+
+#include "MantidDataObjects/Histogram1D.h"
+#include "MantidDataObjects/HistogramPager.h"
+
+#include <atomic>
+#include <boost/shared_ptr.hpp>
+#include <memory>
+#include <mutex>
+
+namespace Mantid {
+namespace DataObjects {
+
+/** LazyHistogram1D : A Histogram1D whose data is read by a HistogramPager
+  when it is first accessed, and may be dropped again afterwards.
+
+  Read-only access pages the data in. Any modification pins the spectrum in
+  memory, so that changes are never lost.
+
+  The data is held through a shared pointer, which the pager drops on
+  eviction. Each thread also keeps the data of the last PINNED_PER_THREAD
+  spectra it read alive, so a reference to the data of a spectrum that is not
+  pinned stays valid until the same thread has read as many other lazily
+  loaded spectra, whatever the other threads do.
+*/
+class DLLExport LazyHistogram1D : public Histogram1D {
+public:
+  /// Number of spectra whose data each thread keeps alive after reading it
+  static constexpr size_t PINNED_PER_THREAD = 128;
+
+  LazyHistogram1D(boost::shared_ptr<HistogramPager> pager, const size_t index);
+  LazyHistogram1D(const LazyHistogram1D &other);
+  LazyHistogram1D &operator=(const LazyHistogram1D &) = delete;
+  ~LazyHistogram1D() override;
+
+  /// Index of the histogram in the source
+  size_t sourceIndex() const { return m_index; }
+  /// True if the data is in memory
+  bool isResident() const;
+  /// True if the data has been modified and will stay in memory
+  bool isPinned() const { return m_pinned.load(); }
+
+  void setX(const Kernel::cow_ptr<HistogramData::HistogramX> &X) override;
+  MantidVec &dataX() override;
+  const MantidVec &dataX() const override;
+  const MantidVec &readX() const override;
+  Kernel::cow_ptr<HistogramData::HistogramX> ptrX() const override;
+
+  MantidVec &dataDx() override;
+  const MantidVec &dataDx() const override;
+  const MantidVec &readDx() const override;
+
+  void clearData() override;
+
+  const MantidVec &dataY() const override;
+  const MantidVec &dataE() const override;
+  MantidVec &dataY() override;
+  MantidVec &dataE() override;
+
+  std::size_t size() const override;
+  size_t getMemorySize() const override;
+
+private:
+  friend class HistogramPager;
+
+  const HistogramData::Histogram &histogramRef() const override;
+  HistogramData::Histogram &mutableHistogramRef() override;
+
+  void pin();
+  void pageOut();
+
+  boost::shared_ptr<HistogramPager> m_pager;
+  const size_t m_index;
+  /// The data while it is in memory. Written with the locks of both the
+  /// pager and the spectrum held, read with either of them.
+  std::shared_ptr<HistogramData::Histogram> m_data;
+  mutable std::mutex m_mutex;
+  mutable std::atomic<bool> m_referenced{false};
+  std::atomic<bool> m_pinned{false};
+  /// Position in the resident list of the pager, while resident and unpinned
+  std::list<LazyHistogram1D *>::iterator m_position;
+};
+
+} // namespace DataObjects
+} // namespace Mantid
+
+#endif /* MANTID_DATAOBJECTS_LAZYHISTOGRAM1D_H_ */
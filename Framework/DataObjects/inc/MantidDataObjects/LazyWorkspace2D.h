@@ -0,0 +1,61 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_LAZYWORKSPACE2D_H_
+#define MANTID_DATAOBJECTS_LAZYWORKSPACE2D_H_
+
+#include "MantidDataObjects/HistogramPager.h"
+#include "MantidDataObjects/Workspace2D.h"
+
+namespace Mantid {
+namespace DataObjects {
+
+/** LazyWorkspace2D : A Workspace2D whose histograms are read from a
+  HistogramSource on first access instead of being loaded up front, and
+  evicted again when the memory used exceeds a budget. See HistogramPager.
+
+  The workspace behaves as a Workspace2D, including its id, and spectra
+  that are modified simply stay in memory. Only the metadata is set when it
+  is created: call initialize() with the dimensions of the source.
+*/
+class DLLExport LazyWorkspace2D : public Workspace2D {
+public:
+  LazyWorkspace2D(std::unique_ptr<HistogramSource> source,
+                  const size_t memoryBudget);
+  LazyWorkspace2D &operator=(const LazyWorkspace2D &) = delete;
+
+  /// Returns a clone of the workspace
+  std::unique_ptr<LazyWorkspace2D> clone() const {
+    return std::unique_ptr<LazyWorkspace2D>(doClone());
+  }
+
+  /// The pager shared by the spectra of the workspace and its clones
+  const HistogramPager &pager() const { return *m_pager; }
+
+protected:
+  /// Protected copy constructor. May be used by childs for cloning.
+  LazyWorkspace2D(const LazyWorkspace2D &other);
+
+  /// Called by initialize()
+  void init(const std::size_t &NVectors, const std::size_t &XLength,
+            const std::size_t &YLength) override;
+  void init(const HistogramData::Histogram &histogram) override;
+
+private:
+  LazyWorkspace2D *doClone() const override {
+    return new LazyWorkspace2D(*this);
+  }
+
+  boost::shared_ptr<HistogramPager> m_pager;
+};
+
+/// shared pointer to the LazyWorkspace2D class
+using LazyWorkspace2D_sptr = boost::shared_ptr<LazyWorkspace2D>;
+
+} // namespace DataObjects
+} // namespace Mantid
+
+#endif /* MANTID_DATAOBJECTS_LAZYWORKSPACE2D_H_ */
@@ -16,6 +16,7 @@
 #include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/System.h"
 #include "MantidKernel/ThreadScheduler.h"
+#include <boost/shared_ptr.hpp>
 
 namespace Mantid {
 namespace DataObjects {
@@ -70,6 +71,11 @@ public:
         const std::vector<Mantid::Geometry::MDDimensionExtents<coord_t>>
             &extentsVector,
         EventIterator begin, EventIterator end);
+  MDBox(Mantid::API::BoxController *const bc, const uint32_t depth,
+        const std::vector<Mantid::Geometry::MDDimensionExtents<coord_t>>
+            &extentsVector,
+        boost::shared_ptr<const std::vector<MDE>> flatEvents,
+        EventIterator begin, EventIterator end);
 
   MDBox(const MDBox<MDE, nd> &other, Mantid::API::BoxController *const otherBC);
 
@@ -95,7 +101,9 @@ public:
   void clear() override;
 
   uint64_t getNPoints() const override;
-  size_t getDataInMemorySize() const override { return data.size(); }
+  size_t getDataInMemorySize() const override {
+    return m_flatEvents ? m_flatSize : data.size();
+  }
   uint64_t getTotalDataSize() const override { return getNPoints(); }
 
   size_t getNumDims() const override;
@@ -141,6 +149,21 @@ public:
   const std::vector<MDE> &getEvents() const;
   void releaseEvents();
 
+  /// A contiguous range of constant events
+  struct EventRange {
+    const MDE *first;
+    const MDE *last;
+    const MDE *begin() const { return first; }
+    const MDE *end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+  };
+  /** Get the events without copying them. The same rules as for
+     getConstEvents apply: call releaseEvents when finished using them. */
+  EventRange getConstEventRange() const;
+  /// @return true if the events are a range of a flat event store
+  bool hasFlatEvents() const { return static_cast<bool>(m_flatEvents); }
+
   std::vector<MDE> *getEventsCopy() override;
 
   void getEventsData(std::vector<coord_t> &coordTable,
@@ -230,6 +253,15 @@ protected:
   mutable Kernel::ISaveable *m_Saveable;
   /** Vector of MDEvent's, in no particular order. */
   mutable std::vector<MDE> data;
+  /** The events of all the boxes of a workspace, in one contiguous array, if
+   * the events of this box are a range of it rather than held in data. The
+   * range is copied into data before the events are modified, or when they
+   * are requested as a vector. */
+  mutable boost::shared_ptr<const std::vector<MDE>> m_flatEvents;
+  /// The first event of the box in the flat event store
+  mutable const MDE *m_flatBegin;
+  /// The number of events of the box in the flat event store
+  mutable size_t m_flatSize;
 
   /// Flag indicating that masking has been applied.
   bool m_bIsMasked;
@@ -240,6 +272,10 @@ private:
   MDBox(const MDBox &);
   /// common part of mdBox constructor
   void initMDBox(const size_t nBoxEvents);
+  /// Copy the events of the flat event store into the box
+  void detachFlatEvents() const;
+  /// The events in memory, either in the flat event store or in data
+  EventRange eventsInMemory() const;
 
 public:
   /// Typedef for a shared pointer to a MDBox
@@ -45,7 +45,7 @@ TMDE(MDBox)::~MDBox() {
 TMDE(MDBox)::MDBox(API::BoxController_sptr &splitter, const uint32_t depth,
                    const size_t nBoxEvents, const size_t boxID)
     : MDBoxBase<MDE, nd>(splitter.get(), depth, boxID), m_Saveable(nullptr),
-      m_bIsMasked(false) {
+      m_flatBegin(nullptr), m_flatSize(0), m_bIsMasked(false) {
   initMDBox(nBoxEvents);
 }
 
@@ -59,7 +59,7 @@ TMDE(MDBox)::MDBox(API::BoxController_sptr &splitter, const uint32_t depth,
 TMDE(MDBox)::MDBox(API::BoxController *const splitter, const uint32_t depth,
                    const size_t nBoxEvents, const size_t boxID)
     : MDBoxBase<MDE, nd>(splitter, depth, boxID), m_Saveable(nullptr),
-      m_bIsMasked(false) {
+      m_flatBegin(nullptr), m_flatSize(0), m_bIsMasked(false) {
   initMDBox(nBoxEvents);
 }
 
@@ -78,7 +78,8 @@ TMDE(MDBox)::MDBox(
         extentsVector,
     const size_t nBoxEvents, const size_t boxID)
     : MDBoxBase<MDE, nd>(splitter.get(), depth, boxID, extentsVector),
-      m_Saveable(nullptr), m_bIsMasked(false) {
+      m_Saveable(nullptr), m_flatBegin(nullptr), m_flatSize(0),
+      m_bIsMasked(false) {
   initMDBox(nBoxEvents);
 }
 //-----------------------------------------------------------------------------------------------
@@ -96,7 +97,8 @@ TMDE(MDBox)::MDBox(
         extentsVector,
     const size_t nBoxEvents, const size_t boxID)
     : MDBoxBase<MDE, nd>(splitter, depth, boxID, extentsVector),
-      m_Saveable(nullptr), m_bIsMasked(false) {
+      m_Saveable(nullptr), m_flatBegin(nullptr), m_flatSize(0),
+      m_bIsMasked(false) {
   initMDBox(nBoxEvents);
 }
 
@@ -115,13 +117,42 @@ MDBox<MDE, nd>::MDBox(Mantid::API::BoxController *const bc, const uint32_t depth
       const std::vector<Mantid::Geometry::MDDimensionExtents<coord_t>>
       &extentsVector, EventIterator begin, EventIterator end) :
       MDBoxBase<MDE, nd>(bc, depth, 0, extentsVector), m_Saveable(nullptr),
-      m_bIsMasked(false)  {
+      m_flatBegin(nullptr), m_flatSize(0), m_bIsMasked(false)  {
   data = std::vector<MDE>(begin, end);
   MDBoxBase<MDE, nd>::calcCaches(data.begin(), data.end());
   if (this->m_BoxController->isFileBacked())
     this->setFileBacked();
 }
 
+/**
+ * Constructor for a box whose events are a range of a flat event store
+ * shared by all the boxes of a workspace. The events are not copied until
+ * they are modified. File-backed boxes copy them immediately.
+ * @param bc :: shared pointer to the BoxController, owned by workspace
+ * @param depth :: recursive split depth
+ * @param extentsVector :: size of the box
+ * @param flatEvents :: the flat event store holding the events
+ * @param begin :: iterator to the first event of the box in the store
+ * @param end :: iterator after the last event of the box in the store
+ */
+template <typename MDE, size_t nd>
+MDBox<MDE, nd>::MDBox(
+    Mantid::API::BoxController *const bc, const uint32_t depth,
+    const std::vector<Mantid::Geometry::MDDimensionExtents<coord_t>>
+        &extentsVector,
+    boost::shared_ptr<const std::vector<MDE>> flatEvents, EventIterator begin,
+    EventIterator end)
+    : MDBoxBase<MDE, nd>(bc, depth, 0, extentsVector), m_Saveable(nullptr),
+      m_flatEvents(std::move(flatEvents)), m_flatBegin(nullptr),
+      m_flatSize(static_cast<size_t>(std::distance(begin, end))),
+      m_bIsMasked(false) {
+  if (m_flatSize > 0)
+    m_flatBegin = &(*begin);
+  MDBoxBase<MDE, nd>::calcCaches(m_flatBegin, m_flatBegin + m_flatSize);
+  if (this->m_BoxController->isFileBacked())
+    this->setFileBacked();
+}
+
 /**Common part of MD box constructor */
 TMDE(void MDBox)::initMDBox(const size_t nBoxEvents) {
   if (this->m_BoxController->getNDims() != nd)
@@ -144,7 +175,8 @@ TMDE(void MDBox)::initMDBox(const size_t nBoxEvents) {
 TMDE(MDBox)::MDBox(const MDBox<MDE, nd> &other,
                    Mantid::API::BoxController *const otherBC)
     : MDBoxBase<MDE, nd>(other, otherBC), m_Saveable(nullptr), data(other.data),
-      m_bIsMasked(other.m_bIsMasked) {
+      m_flatEvents(other.m_flatEvents), m_flatBegin(other.m_flatBegin),
+      m_flatSize(other.m_flatSize), m_bIsMasked(other.m_bIsMasked) {
   if (otherBC) // may be absent in some tests but generally have to be present
   {
     if (otherBC->isFileBacked())
@@ -180,6 +212,9 @@ TMDE(Kernel::ISaveable *MDBox)::getISaveable() const { return m_Saveable; }
  * Used to free up the memory in a file-backed workspace without removing the
  * events from disk. */
 TMDE(void MDBox)::clearDataFromMemory() {
+  m_flatEvents.reset();
+  m_flatBegin = nullptr;
+  m_flatSize = 0;
   data.clear();
   vec_t().swap(data); // Linux trick to really free the memory
   // mark data unchanged
@@ -243,7 +278,7 @@ TMDE(void MDBox)::getBoxes(std::vector<API::IMDNode *>& outBoxes, const std::fun
 */
 TMDE(uint64_t MDBox)::getNPoints() const {
   if (!m_Saveable)
-    return data.size();
+    return getDataInMemorySize();
 
   if (m_Saveable->wasSaved()) {
     if (m_Saveable->isLoaded())
@@ -260,6 +295,7 @@ TMDE(uint64_t MDBox)::getNPoints() const {
  * data.
  */
 TMDE(std::vector<MDE> &MDBox)::getEvents() {
+  detachFlatEvents();
   if (!m_Saveable)
     return data;
   else {
@@ -289,6 +325,11 @@ TMDE(const std::vector<MDE> &MDBox)::getEvents() const {
  * data.
  */
 TMDE(const std::vector<MDE> &MDBox)::getConstEvents() const {
+  // The events of the flat event store have to be copied to be returned as a
+  // vector. As for loading the events of a file-backed box, this must not be
+  // done by several threads at the same time for the same box; use
+  // getConstEventRange to read the events without copying them.
+  detachFlatEvents();
   if (!m_Saveable)
     return data;
   else {
@@ -320,6 +361,41 @@ TMDE(void MDBox)::releaseEvents() {
     m_Saveable->setBusy(false);
 }
 
+//-----------------------------------------------------------------------------------------------
+/** Returns the range of the events contained within, without copying them
+ * out of the flat event store if the box has one.
+ * VERY IMPORTANT: call MDBox::releaseEvents() when you are done accessing that
+ * data.
+ */
+template <typename MDE, size_t nd>
+typename MDBox<MDE, nd>::EventRange MDBox<MDE, nd>::getConstEventRange() const {
+  if (m_flatEvents)
+    return eventsInMemory();
+  const std::vector<MDE> &events = getConstEvents();
+  return EventRange{events.data(), events.data() + events.size()};
+}
+
+/** Returns the range of the events in memory, without loading any */
+template <typename MDE, size_t nd>
+typename MDBox<MDE, nd>::EventRange MDBox<MDE, nd>::eventsInMemory() const {
+  if (m_flatEvents)
+    return EventRange{m_flatBegin, m_flatBegin + m_flatSize};
+  return EventRange{data.data(), data.data() + data.size()};
+}
+
+/** Copies the events of the box out of the flat event store, such that they
+ * can be modified or returned as a vector. Does nothing if the box has no
+ * flat event store.
+ */
+TMDE(void MDBox)::detachFlatEvents() const {
+  if (!m_flatEvents)
+    return;
+  data.insert(data.end(), m_flatBegin, m_flatBegin + m_flatSize);
+  m_flatEvents.reset();
+  m_flatBegin = nullptr;
+  m_flatSize = 0;
+}
+
 /** The method to convert events in a box into a table of
  * coordinates/signal/errors casted into coord_t type
   *   Used to save events from plain binary file
@@ -330,7 +406,7 @@ TMDE(void MDBox)::releaseEvents() {
 TMDE(void MDBox)::getEventsData(std::vector<coord_t> &coordTable,
                                 size_t &nColumns) const {
   double signal, errorSq;
-  MDE::eventsToData(this->data, coordTable, nColumns, signal, errorSq);
+  MDE::eventsToData(eventsInMemory(), coordTable, nColumns, signal, errorSq);
   this->m_signal = static_cast<signal_t>(signal);
   this->m_errorSquared = static_cast<signal_t>(errorSq);
 
@@ -345,6 +421,7 @@ TMDE(void MDBox)::getEventsData(std::vector<coord_t> &coordTable,
                            signal error and coordinates
  */
 TMDE(void MDBox)::setEventsData(const std::vector<coord_t> &coordTable) {
+  detachFlatEvents();
   MDE::dataToEvents(coordTable, this->data);
 }
 
@@ -354,9 +431,9 @@ TMDE(void MDBox)::setEventsData(const std::vector<coord_t> &coordTable) {
 TMDE(std::vector<MDE> *MDBox)::getEventsCopy() {
   if (m_Saveable) {
   }
-  auto out = new std::vector<MDE>();
+  const EventRange events = eventsInMemory();
   // Make the copy
-  out->insert(out->begin(), data.begin(), data.end());
+  auto out = new std::vector<MDE>(events.begin(), events.end());
   return out;
 }
 
@@ -399,11 +476,12 @@ TMDE(void MDBox)::refreshCache(Kernel::ThreadScheduler * /*ts*/) {
   }
 
   // calculate all averages from memory
-  signalSum = std::accumulate(data.cbegin(), data.cend(), signalSum,
+  const EventRange events = eventsInMemory();
+  signalSum = std::accumulate(events.begin(), events.end(), signalSum,
                               [](const double &sum, const MDE &event) {
                                 return sum + event.getSignal();
                               });
-  errorSum = std::accumulate(data.cbegin(), data.cend(), errorSum,
+  errorSum = std::accumulate(events.begin(), events.end(), errorSum,
                              [](const double &sum, const MDE &event) {
                                return sum + event.getErrorSquared();
                              });
@@ -425,7 +503,7 @@ TMDE(bool MDBox)::isDataAdded() const {
     if (m_Saveable->isLoaded())
       return data.size() != m_Saveable->getFileSize();
   }
-  return (!data.empty());
+  return getDataInMemorySize() != 0;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -440,7 +518,7 @@ TMDE(void MDBox)::calculateCentroid(coord_t *centroid) const {
   if (this->m_signal == 0)
     return;
 
-  for (const MDE &Evnt : data) {
+  for (const MDE &Evnt : eventsInMemory()) {
     double signal = Evnt.getSignal();
     for (size_t d = 0; d < nd; d++) {
       // Total up the coordinate weighted by the signal.
@@ -470,7 +548,7 @@ TMDE(void MDBox)::calculateCentroid(coord_t *centroid,
   if (this->m_signal == 0)
     return;
 
-  for (const MDE &Evnt : data) {
+  for (const MDE &Evnt : eventsInMemory()) {
     coord_t signal = Evnt.getSignal();
     if (Evnt.getRunIndex() == runindex) {
       for (size_t d = 0; d < nd; d++) {
@@ -494,7 +572,7 @@ TMDE(void MDBox)::calculateCentroid(coord_t *centroid,
  * before!
  */
 TMDE(void MDBox)::calculateDimensionStats(MDDimensionStats *stats) const {
-  for (const MDE &Evnt : data) {
+  for (const MDE &Evnt : eventsInMemory()) {
     for (size_t d = 0; d < nd; d++) {
       stats[d].addPoint(Evnt.getCenter(d));
     }
@@ -527,7 +605,7 @@ TMDE(void MDBox)::centerpointBin(MDBin<MDE, nd> &bin,
   }
 
   // If the box is cached to disk, you need to retrieve it
-  const std::vector<MDE> &events = this->getConstEvents();
+  const EventRange events = this->getConstEventRange();
   // For each MDLeanEvent
   for (const auto &evnt : events) {
     size_t d;
@@ -569,7 +647,7 @@ TMDE(void MDBox)::generalBin(
   UNUSED_ARG(bin);
 
   // For each MDLeanEvent
-  for (const auto &event : data) {
+  for (const auto &event : eventsInMemory()) {
     if (function.isPointContained(event.getCenter())) // HACK
     {
       // Accumulate error and signal
@@ -599,7 +677,7 @@ TMDE(void MDBox)::integrateSphere(Mantid::API::CoordTransform &radiusTransform,
                                   const coord_t innerRadiusSquared,
                                   const bool useOnePercentBackgroundCorrection) const {
   // If the box is cached to disk, you need to retrieve it
-  const std::vector<MDE> &events = this->getConstEvents();
+  const EventRange events = this->getConstEventRange();
   if (innerRadiusSquared == 0.0) {
     // For each MDLeanEvent
     for (const auto &it : events) {
@@ -666,7 +744,7 @@ TMDE(void MDBox)::integrateCylinder(
     const coord_t length, signal_t &signal, signal_t &errorSquared,
     std::vector<signal_t> &signal_fit) const {
   // If the box is cached to disk, you need to retrieve it
-  const std::vector<MDE> &events = this->getConstEvents();
+  const EventRange events = this->getConstEventRange();
   size_t numSteps = signal_fit.size();
   double deltaQ = length / static_cast<double>(numSteps - 1);
 
@@ -713,7 +791,7 @@ TMDE(void MDBox)::centroidSphere(Mantid::API::CoordTransform &radiusTransform,
                                  const coord_t radiusSquared, coord_t *centroid,
                                  signal_t &signal) const {
   // If the box is cached to disk, you need to retrieve it
-  const std::vector<MDE> &events = this->getConstEvents();
+  const EventRange events = this->getConstEventRange();
 
   // For each MDLeanEvent
   for (const auto &evnt : events) {
@@ -774,6 +852,7 @@ TMDE(size_t MDBox)::buildAndAddEvents(const std::vector<signal_t> &sigErrSq,
                                       const std::vector<uint16_t> &runIndex,
                                       const std::vector<uint32_t> &detectorId) {
 
+  detachFlatEvents();
   size_t nEvents = sigErrSq.size() / 2;
   size_t nExisiting = data.size();
   data.reserve(nExisiting + nEvents);
@@ -795,6 +874,7 @@ TMDE(void MDBox)::buildAndAddEvent(const signal_t Signal,
                                    const std::vector<coord_t> &point,
                                    uint16_t runIndex, uint32_t detectorId) {
   std::lock_guard<std::mutex> _lock(this->m_dataMutex);
+  detachFlatEvents();
   this->data.push_back(IF<MDE, nd>::BUILD_EVENT(Signal, errorSq, &point[0],
                                                 runIndex, detectorId));
 }
@@ -815,6 +895,7 @@ TMDE(void MDBox)::buildAndAddEventUnsafe(const signal_t Signal,
                                          const std::vector<coord_t> &point,
                                          uint16_t runIndex,
                                          uint32_t detectorId) {
+  detachFlatEvents();
   this->data.push_back(IF<MDE, nd>::BUILD_EVENT(Signal, errorSq, &point[0],
                                                 runIndex, detectorId));
 }
@@ -826,6 +907,7 @@ TMDE(void MDBox)::buildAndAddEventUnsafe(const signal_t Signal,
  * */
 TMDE(size_t MDBox)::addEvent(const MDE &Evnt) {
   std::lock_guard<std::mutex> _lock(this->m_dataMutex);
+  detachFlatEvents();
   this->data.push_back(Evnt);
   return 1;
 }
@@ -839,6 +921,7 @@ TMDE(size_t MDBox)::addEvent(const MDE &Evnt) {
  * @return Always returns 1
  * */
 TMDE(size_t MDBox)::addEventUnsafe(const MDE &Evnt) {
+  detachFlatEvents();
   this->data.push_back(Evnt);
   return 1;
 }
@@ -852,6 +935,7 @@ TMDE(size_t MDBox)::addEventUnsafe(const MDE &Evnt) {
  */
 TMDE(size_t MDBox)::addEvents(const std::vector<MDE> &events) {
   std::lock_guard<std::mutex> _lock(this->m_dataMutex);
+  detachFlatEvents();
   // Copy all the events
   this->data.insert(this->data.end(), events.cbegin(), events.cend());
   return 0;
@@ -867,6 +951,8 @@ TMDE(size_t MDBox)::addEvents(const std::vector<MDE> &events) {
 */
 TMDE(void MDBox)::setFileBacked(const uint64_t fileLocation,
                                 const size_t fileSize, const bool markSaved) {
+  // File-backed boxes hold their events in data
+  detachFlatEvents();
   if (!m_Saveable)
     m_Saveable = new MDBoxSaveable(this);
 
@@ -888,7 +974,8 @@ TMDE(void MDBox)::setFileBacked() {
 */
 TMDE(void MDBox)::saveAt(API::IBoxControllerIO *const FileSaver,
                          uint64_t position) const {
-  if (data.empty())
+  const EventRange events = eventsInMemory();
+  if (events.empty())
     return;
 
   if (!FileSaver)
@@ -902,7 +989,7 @@ TMDE(void MDBox)::saveAt(API::IBoxControllerIO *const FileSaver,
   size_t nDataColumns;
   double totalSignal, totalErrSq;
 
-  MDE::eventsToData(this->data, TabledData, nDataColumns, totalSignal,
+  MDE::eventsToData(events, TabledData, nDataColumns, totalSignal,
                     totalErrSq);
 
   this->m_signal = static_cast<signal_t>(totalSignal);
@@ -920,6 +1007,7 @@ TMDE(void MDBox)::saveAt(API::IBoxControllerIO *const FileSaver,
  * @param size -- number of events to reserve for
  */
 TMDE(void MDBox)::reserveMemoryForLoad(uint64_t size) {
+  detachFlatEvents();
   this->data.reserve(size);
 }
 
@@ -945,6 +1033,7 @@ TMDE(void MDBox)::loadAndAddFrom(API::IBoxControllerIO *const FileSaver,
         " The data file has to be opened to use box loadAndAddFrom function"));
 
   std::lock_guard<std::mutex> _lock(this->m_dataMutex);
+  detachFlatEvents();
 
   std::vector<coord_t> TableData;
   FileSaver->loadBlock(TableData, filePosition, nEvents);
@@ -187,7 +187,7 @@ public:
 
   /* static method used to convert vector of lean events into vector of their
    coordinates & signal and error
-   @param events    -- vector of events
+   @param events    -- vector (or any other contiguous range) of events
    @return data     -- vector of events data, namely, their signal and error
    casted to coord_t type
    @return ncols    -- the number of colunts  in the data (it is nd+4 here but
@@ -195,7 +195,8 @@ public:
    @return totalSignal -- total signal in the vector of events
    @return totalErr   -- total error corresponting to the vector of events
   */
-  static inline void eventsToData(const std::vector<MDEvent<nd>> &events,
+  template <typename EventContainer>
+  static inline void eventsToData(const EventContainer &events,
                                   std::vector<coord_t> &data, size_t &ncols,
                                   double &totalSignal, double &totalErrSq) {
     ncols = (nd + 4);
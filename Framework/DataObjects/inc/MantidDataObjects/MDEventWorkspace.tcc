@@ -598,6 +598,28 @@ TMDE(size_t MDEventWorkspace)::addEvents(const std::vector<MDE> &events) {
   return data->addEvents(events);
 }
 
+//-----------------------------------------------------------------------------------------------
+/** Add a vector of MDEvents to the workspace, splitting the boxes which get
+ * more events than the split threshold. The boxes are filled and split in
+ * parallel, without locks: see MDGridBox::addEventsAndSplit.
+ *
+ * NOTE: You must call refreshCache() after you are done, to calculate the
+ * nPoints, signal and error.
+ *
+ * @param events :: the events to add. The vector is reordered.
+ * @return the number of events that were rejected (because of being out of
+ *bounds)
+ */
+TMDE(size_t MDEventWorkspace)::addEventsAndSplit(std::vector<MDE> &events) {
+  if (!isGridBox()) {
+    if (!this->m_BoxController->willSplit(data->getNPoints() + events.size(),
+                                          data->getDepth()))
+      return data->addEvents(events);
+    splitBox();
+  }
+  return static_cast<MDGridBox<MDE, nd> *>(data)->addEventsAndSplit(events);
+}
+
 //-----------------------------------------------------------------------------------------------
 /** Split the contained MDBox into a MDGridBox or MDSplitBox, if it is not
  * that already.
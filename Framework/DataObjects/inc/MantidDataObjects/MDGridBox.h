@@ -139,6 +139,7 @@ public:
   //----------------------------------------------------------------------------------------------------------------------
   size_t addEvent(const MDE &event) override;
   size_t addEventUnsafe(const MDE &event) override;
+  size_t addEventsAndSplit(std::vector<MDE> &events);
 
   /*--------------->  EVENTS from event data
    * <-------------------------------------------------------------*/
@@ -225,6 +226,8 @@ public:
 private:
   /// Compute the index of the child box for the given event
   size_t calculateChildIndex(const MDE &event) const;
+  size_t addEventsAndSplit(MDE *events, MDE *buffer, size_t nEvents,
+                           bool checkBounds, bool checkAllChildren);
 
   /// Each dimension is split into this many equally-sized boxes
   size_t split[nd];
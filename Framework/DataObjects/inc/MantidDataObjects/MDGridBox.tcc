@@ -17,7 +17,9 @@
 #include "MantidDataObjects/MDGridBox.h"
 #include <boost/math/special_functions/round.hpp>
 #include <boost/optional.hpp>
+#include <atomic>
 #include <ostream>
+#include <tbb/parallel_for.h>
 #include "MantidKernel/Strings.h"
 
 // These pragmas ignores the warning in the ctor where "d<nd-1" for nd=1.
@@ -1725,6 +1727,140 @@ TMDE(inline size_t MDGridBox)::addEventUnsafe(const MDE &event) {
     return 0;
 }
 
+//-----------------------------------------------------------------------------------------------
+/** Add a batch of events to the grid box, splitting the boxes which get more
+ * events than the split threshold, without locking any box.
+ *
+ * The events are sorted into buckets by the child box they fall in. Every
+ * child is then filled, and split if needed, by a single task, with the
+ * children processed in parallel. Events outside the box are rejected.
+ *
+ * Note! nPoints, signal and error must be re-calculated using refreshCache()
+ * after all events have been added.
+ *
+ * @param events :: the events to add. The vector is reordered.
+ * @return the number of events rejected because they were out of bounds
+ * */
+TMDE(size_t MDGridBox)::addEventsAndSplit(std::vector<MDE> &events) {
+  std::vector<MDE> buffer(events.size());
+  return addEventsAndSplit(events.data(), buffer.data(), events.size(), true,
+                           true);
+}
+
+/** Sort the events into buckets by child box, then add every bucket to its
+ * child in a separate task, splitting the children which get too many events.
+ * The events are sorted into the buffer, which the children in turn use as
+ * their events, while the events array becomes their buffer.
+ *
+ * @param events :: the events to add
+ * @param buffer :: space for nEvents events, to sort the events into
+ * @param nEvents :: the number of events
+ * @param checkBounds :: reject the events outside the box
+ * @param checkAllChildren :: also check whether the children which get no
+ *        events need splitting, as for a box which has just been split
+ * @return the number of events rejected
+ */
+TMDE(size_t MDGridBox)::addEventsAndSplit(MDE *events, MDE *buffer,
+                                          size_t nEvents, bool checkBounds,
+                                          bool checkAllChildren) {
+  // The events outside the box go to an extra bucket, which is dropped
+  const size_t nBuckets = numBoxes + 1;
+  const auto bucketOf = [this, checkBounds](const MDE &event) {
+    if (checkBounds) {
+      for (size_t d = 0; d < nd; ++d) {
+        if (this->extents[d].outside(event.getCenter(d)))
+          return numBoxes;
+      }
+    }
+    const size_t cindex = calculateChildIndex(event);
+    // As in addEvent, the events on the upper boundary go to the last box
+    if (cindex == numBoxes)
+      return numBoxes - 1;
+    return std::min(cindex, numBoxes);
+  };
+
+  // Split the events into one chunk per thread, unless there are only a few
+  const size_t eventsPerTask = std::max(
+      size_t(1), this->m_BoxController->getAddingEvents_eventsPerTask());
+  const size_t nChunks =
+      std::max(size_t(1), std::min(nEvents / eventsPerTask,
+                                   size_t(PARALLEL_GET_MAX_THREADS)));
+  const size_t chunkSize = (nEvents + nChunks - 1) / nChunks;
+
+  // Count the events of every chunk in every bucket
+  std::vector<size_t> offsets(nChunks * nBuckets, 0);
+  const auto countChunk = [&](size_t chunk) {
+    size_t *counts = &offsets[chunk * nBuckets];
+    const size_t end = std::min(nEvents, (chunk + 1) * chunkSize);
+    for (size_t i = chunk * chunkSize; i < end; ++i)
+      ++counts[bucketOf(events[i])];
+  };
+  // The events of a bucket are ordered by chunk, so that every chunk can
+  // write its events into the buffer independently
+  std::vector<size_t> bucketBegin(nBuckets + 1);
+  const auto computeOffsets = [&]() {
+    size_t position = 0;
+    for (size_t bucket = 0; bucket < nBuckets; ++bucket) {
+      bucketBegin[bucket] = position;
+      for (size_t chunk = 0; chunk < nChunks; ++chunk) {
+        size_t &offset = offsets[chunk * nBuckets + bucket];
+        const size_t count = offset;
+        offset = position;
+        position += count;
+      }
+    }
+    bucketBegin[nBuckets] = position;
+  };
+  const auto scatterChunk = [&](size_t chunk) {
+    size_t *next = &offsets[chunk * nBuckets];
+    const size_t end = std::min(nEvents, (chunk + 1) * chunkSize);
+    for (size_t i = chunk * chunkSize; i < end; ++i)
+      buffer[next[bucketOf(events[i])]++] = events[i];
+  };
+
+  std::atomic<size_t> numRejected(0);
+  // Every child is only modified by this task, so it needs no lock
+  const auto addToChild = [&](size_t index) {
+    const size_t begin = bucketBegin[index];
+    const size_t count = bucketBegin[index + 1] - begin;
+    if (count == 0 && !checkAllChildren)
+      return;
+    bool newGridBox = false;
+    auto box = dynamic_cast<MDBox<MDE, nd> *>(m_Children[index]);
+    if (box) {
+      if (!this->m_BoxController->willSplit(box->getNPoints() + count,
+                                           box->getDepth())) {
+        for (size_t i = begin; i < begin + count; ++i)
+          box->addEventUnsafe(buffer[i]);
+        return;
+      }
+      // Track how many MDBoxes there are in the overall workspace
+      this->m_BoxController->trackNumBoxes(box->getDepth());
+      m_Children[index] = new MDGridBox<MDE, nd>(box);
+      delete box;
+      newGridBox = true;
+    }
+    auto gridBox = dynamic_cast<MDGridBox<MDE, nd> *>(m_Children[index]);
+    if (gridBox)
+      numRejected += gridBox->addEventsAndSplit(
+          buffer + begin, events + begin, count, false, newGridBox);
+  };
+
+  if (nChunks == 1) {
+    countChunk(0);
+    computeOffsets();
+    scatterChunk(0);
+    for (size_t index = 0; index < numBoxes; ++index)
+      addToChild(index);
+  } else {
+    tbb::parallel_for(size_t(0), nChunks, countChunk);
+    computeOffsets();
+    tbb::parallel_for(size_t(0), nChunks, scatterChunk);
+    tbb::parallel_for(size_t(0), numBoxes, addToChild);
+  }
+  return numRejected + (bucketBegin[nBuckets] - bucketBegin[numBoxes]);
+}
+
 /**Sets particular child MDgridBox at the index, specified by the input
 *parameters
 *@param index     -- the position of the new child in the list of GridBox
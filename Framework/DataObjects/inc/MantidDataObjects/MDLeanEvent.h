@@ -334,7 +334,7 @@ public:
 
   /* static method used to convert vector of lean events into vector of their
    coordinates & signal and error
-   @param events    -- vector of events
+   @param events    -- vector (or any other contiguous range) of events
    @return data     -- vector of events coordinates, their signal and error
    casted to coord_t type
    @return ncols    -- the number of colunts  in the data (it is nd+2 here but
@@ -342,7 +342,8 @@ public:
    @return totalSignal -- total signal in the vector of events
    @return totalErr   -- total error corresponting to the vector of events
   */
-  static inline void eventsToData(const std::vector<MDLeanEvent<nd>> &events,
+  template <typename EventContainer>
+  static inline void eventsToData(const EventContainer &events,
                                   std::vector<coord_t> &data, size_t &ncols,
                                   double &totalSignal, double &totalErrSq) {
     ncols = nd + 2;
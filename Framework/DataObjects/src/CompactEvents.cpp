@@ -0,0 +1,606 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataObjects/CompactEvents.h"
+#include "MantidDataObjects/EventHistogrammer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace Mantid {
+namespace DataObjects {
+using Types::Core::DateAndTime;
+using Types::Event::TofEvent;
+
+namespace {
+/** Reorder a column according to a permutation.
+ * @param column :: the column to reorder in place
+ * @param order :: new position i takes the value at old position order[i]
+ */
+template <class T>
+void gather(std::vector<T> &column, const std::vector<size_t> &order) {
+  if (column.empty())
+    return;
+  std::vector<T> sorted;
+  sorted.reserve(column.size());
+  for (const auto index : order)
+    sorted.push_back(column[index]);
+  column.swap(sorted);
+}
+
+/// Release the memory of a column that is no longer used
+template <class T> void release(std::vector<T> &column) {
+  std::vector<T>().swap(column);
+}
+
+/// The decimal grids tried for time-of-flight offsets, in steps per unit
+constexpr double OFFSET_SCALES[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6};
+/// Scaled values must be below this to be converted to double exactly
+constexpr double MAX_EXACT_INTEGER = 9007199254740992.; // 2^53
+/// Largest and smallest log2 of the number of pulse times in a block
+constexpr unsigned MAX_PULSE_BLOCK_SHIFT = 8;
+constexpr unsigned MIN_PULSE_BLOCK_SHIFT = 3;
+} // namespace
+
+/** Encode a vector of TofEvent. Any previous content is discarded.
+ * @param events :: the events to copy
+ * @param roundTof :: round the time-of-flight to single precision
+ */
+void CompactEvents::assign(const std::vector<TofEvent> &events,
+                           const bool roundTof) {
+  clear();
+  assignTofs(events, roundTof);
+  assignPulseTimes(events);
+}
+
+/** Encode a vector of WeightedEvent. Any previous content is discarded.
+ * @param events :: the events to copy
+ * @param roundTof :: round the time-of-flight to single precision
+ */
+void CompactEvents::assign(const std::vector<WeightedEvent> &events,
+                           const bool roundTof) {
+  clear();
+  assignTofs(events, roundTof);
+  assignPulseTimes(events);
+  assignWeights(events);
+}
+
+/** Encode a vector of WeightedEventNoTime. Any previous content is discarded.
+ * @param events :: the events to copy
+ * @param roundTof :: round the time-of-flight to single precision
+ */
+void CompactEvents::assign(const std::vector<WeightedEventNoTime> &events,
+                           const bool roundTof) {
+  clear();
+  assignTofs(events, roundTof);
+  assignWeights(events);
+}
+
+/** Rebuild a vector of TofEvent.
+ * @param events :: vector to fill; any previous content is discarded
+ */
+void CompactEvents::extract(std::vector<TofEvent> &events) const {
+  if (!m_hasPulseTimes && m_numEvents > 0)
+    throw std::runtime_error("CompactEvents::extract(): no pulse times are "
+                             "stored, cannot create TofEvent's.");
+  events.clear();
+  events.reserve(m_numEvents);
+  for (size_t i = 0; i < m_numEvents; ++i)
+    appendEvent(i, events);
+}
+
+/** Rebuild a vector of WeightedEvent.
+ * @param events :: vector to fill; any previous content is discarded
+ */
+void CompactEvents::extract(std::vector<WeightedEvent> &events) const {
+  if (!m_hasPulseTimes && m_numEvents > 0)
+    throw std::runtime_error("CompactEvents::extract(): no pulse times are "
+                             "stored, cannot create WeightedEvent's.");
+  events.clear();
+  events.reserve(m_numEvents);
+  for (size_t i = 0; i < m_numEvents; ++i)
+    appendEvent(i, events);
+}
+
+/** Rebuild a vector of WeightedEventNoTime.
+ * @param events :: vector to fill; any previous content is discarded
+ */
+void CompactEvents::extract(std::vector<WeightedEventNoTime> &events) const {
+  events.clear();
+  events.reserve(m_numEvents);
+  for (size_t i = 0; i < m_numEvents; ++i)
+    events.emplace_back(tof(i), weight(i), errorSquared(i));
+}
+
+/// Remove all events and free their memory
+void CompactEvents::clear() {
+  m_numEvents = 0;
+  release(m_singleTof);
+  release(m_tofOffset);
+  release(m_doubleTof);
+  m_numPulses = 0;
+  release(m_pulseBase);
+  release(m_pulseOffset);
+  m_pulseBlockShift = 0;
+  release(m_narrowPulseIndex);
+  release(m_widePulseIndex);
+  release(m_weight);
+  release(m_errorSquared);
+  m_tofBase = 0;
+  m_tofScale = 1.;
+  m_tofStorage = TofStorage::Single;
+  m_roundTof = false;
+  m_hasPulseTimes = false;
+  m_hasWeights = false;
+  m_sortedByTof = true;
+}
+
+/** Memory used by the encoded events, in bytes.
+ * @return :: the memory used, in bytes.
+ */
+size_t CompactEvents::getMemorySize() const {
+  return m_singleTof.capacity() * sizeof(float) +
+         m_tofOffset.capacity() * sizeof(uint32_t) +
+         m_doubleTof.capacity() * sizeof(double) +
+         m_pulseBase.capacity() * sizeof(int64_t) +
+         m_pulseOffset.capacity() * sizeof(uint32_t) +
+         m_narrowPulseIndex.capacity() * sizeof(uint16_t) +
+         m_widePulseIndex.capacity() * sizeof(uint32_t) +
+         (m_weight.capacity() + m_errorSquared.capacity()) * sizeof(float) +
+         sizeof(CompactEvents);
+}
+
+/** Sort the events by time-of-flight. The permutation is computed on the
+ * time-of-flight and then applied to each column; the pulse time table is not
+ * affected.
+ */
+void CompactEvents::sortTof() {
+  if (m_sortedByTof)
+    return;
+  std::vector<size_t> order(m_numEvents);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [this](const size_t lhs, const size_t rhs) {
+                     return tof(lhs) < tof(rhs);
+                   });
+  gather(m_singleTof, order);
+  gather(m_tofOffset, order);
+  gather(m_doubleTof, order);
+  gather(m_narrowPulseIndex, order);
+  gather(m_widePulseIndex, order);
+  gather(m_weight, order);
+  gather(m_errorSquared, order);
+  m_sortedByTof = true;
+}
+
+/// Reverse the order of the events, e.g. after a decreasing unit conversion
+void CompactEvents::reverse() {
+  std::reverse(m_singleTof.begin(), m_singleTof.end());
+  std::reverse(m_tofOffset.begin(), m_tofOffset.end());
+  std::reverse(m_doubleTof.begin(), m_doubleTof.end());
+  std::reverse(m_narrowPulseIndex.begin(), m_narrowPulseIndex.end());
+  std::reverse(m_widePulseIndex.begin(), m_widePulseIndex.end());
+  std::reverse(m_weight.begin(), m_weight.end());
+  std::reverse(m_errorSquared.begin(), m_errorSquared.end());
+  switch (m_tofStorage) {
+  case TofStorage::Single:
+    m_sortedByTof = std::is_sorted(m_singleTof.cbegin(), m_singleTof.cend());
+    break;
+  case TofStorage::Offset:
+    m_sortedByTof = std::is_sorted(m_tofOffset.cbegin(), m_tofOffset.cend());
+    break;
+  case TofStorage::Double:
+    m_sortedByTof = std::is_sorted(m_doubleTof.cbegin(), m_doubleTof.cend());
+    break;
+  }
+}
+
+/** Convert the time-of-flight by tof' = tof * factor + offset.
+ * @param factor :: the value to scale the time-of-flight by
+ * @param offset :: the value to shift the time-of-flight by
+ */
+void CompactEvents::convertTof(const double factor, const double offset) {
+  transformTofs([factor, offset](const double tof) {
+    return tof * factor + offset;
+  });
+}
+
+/** Convert the time-of-flight with an arbitrary function.
+ * @param func :: the function giving the new value of a time-of-flight
+ */
+void CompactEvents::convertTof(const std::function<double(double)> &func) {
+  transformTofs(func);
+}
+
+/** Apply a function to the time-of-flight column. Values held in single
+ * precision or as offsets only because they were exact are widened to double
+ * precision first, since the converted values are not exact in general.
+ * @param func :: the function giving the new value of a time-of-flight
+ */
+template <class Func> void CompactEvents::transformTofs(const Func &func) {
+  if (!m_roundTof)
+    widenTofs();
+  if (m_tofStorage == TofStorage::Single) {
+    for (auto &tof : m_singleTof)
+      tof = static_cast<float>(func(static_cast<double>(tof)));
+    m_sortedByTof = std::is_sorted(m_singleTof.cbegin(), m_singleTof.cend());
+  } else {
+    for (auto &tof : m_doubleTof)
+      tof = func(tof);
+    m_sortedByTof = std::is_sorted(m_doubleTof.cbegin(), m_doubleTof.cend());
+  }
+}
+
+/** Store every time-of-flight in double precision, unless it already is.
+ */
+void CompactEvents::widenTofs() {
+  if (m_tofStorage == TofStorage::Double)
+    return;
+  m_doubleTof.resize(m_numEvents);
+  for (size_t i = 0; i < m_numEvents; ++i)
+    m_doubleTof[i] = tof(i);
+  release(m_singleTof);
+  release(m_tofOffset);
+  m_tofStorage = TofStorage::Double;
+}
+
+/// @return the smallest time-of-flight, or the largest double if empty
+double CompactEvents::getTofMin() const {
+  if (m_numEvents == 0)
+    return std::numeric_limits<double>::max();
+  if (m_sortedByTof)
+    return tof(0);
+  switch (m_tofStorage) {
+  case TofStorage::Single:
+    return *std::min_element(m_singleTof.cbegin(), m_singleTof.cend());
+  case TofStorage::Offset:
+    return offsetToTof(
+        *std::min_element(m_tofOffset.cbegin(), m_tofOffset.cend()));
+  default:
+    return *std::min_element(m_doubleTof.cbegin(), m_doubleTof.cend());
+  }
+}
+
+/// @return the largest time-of-flight, or the lowest double if empty
+double CompactEvents::getTofMax() const {
+  if (m_numEvents == 0)
+    return std::numeric_limits<double>::lowest();
+  if (m_sortedByTof)
+    return tof(m_numEvents - 1);
+  switch (m_tofStorage) {
+  case TofStorage::Single:
+    return *std::max_element(m_singleTof.cbegin(), m_singleTof.cend());
+  case TofStorage::Offset:
+    return offsetToTof(
+        *std::max_element(m_tofOffset.cbegin(), m_tofOffset.cend()));
+  default:
+    return *std::max_element(m_doubleTof.cbegin(), m_doubleTof.cend());
+  }
+}
+
+/// @return the earliest pulse time in nanoseconds, from the pulse table
+int64_t CompactEvents::getPulseTimeMin() const {
+  return m_numPulses == 0 ? std::numeric_limits<int64_t>::max()
+                          : pulseTableEntry(0);
+}
+
+/// @return the latest pulse time in nanoseconds, from the pulse table
+int64_t CompactEvents::getPulseTimeMax() const {
+  return m_numPulses == 0 ? std::numeric_limits<int64_t>::min()
+                          : pulseTableEntry(m_numPulses - 1);
+}
+
+/** Histogram the events by time-of-flight, decoding them on the fly. The
+ * events do not need to be sorted.
+ * @param X :: bin boundaries, sorted in increasing order
+ * @param Y :: counts (or summed weights) returned
+ * @param E :: errors returned
+ */
+void CompactEvents::histogram(const MantidVec &X, MantidVec &Y,
+                              MantidVec &E) const {
+  if (X.size() <= 1) {
+    // X was not set. Return an empty array.
+    Y.clear();
+    E.clear();
+    return;
+  }
+  const size_t numBins = X.size() - 1;
+  Y.assign(numBins, 0.0);
+  E.assign(numBins, 0.0);
+
+  const auto &histogrammer = EventHistogrammer::forEdges(X);
+  for (size_t i = 0; i < m_numEvents; ++i) {
+    const size_t bin = histogrammer.findBin(tof(i));
+    if (bin < numBins) {
+      Y[bin] += static_cast<double>(weight(i));
+      E[bin] += static_cast<double>(errorSquared(i));
+    }
+  }
+  std::transform(E.begin(), E.end(), E.begin(),
+                 static_cast<double (*)(double)>(sqrt));
+}
+
+/** Integrate the events between a range of X values, or all events. The
+ * events do not need to be sorted.
+ * @param minX :: minimum X bin to use in integrating.
+ * @param maxX :: maximum X bin to use in integrating.
+ * @param entireRange :: set to true to use the entire range. minX and maxX are
+ *then ignored!
+ * @param sum :: reference to a double to put the sum in.
+ * @param error :: reference to a double to put the error in.
+ */
+void CompactEvents::integrate(const double minX, const double maxX,
+                              const bool entireRange, double &sum,
+                              double &error) const {
+  sum = 0;
+  error = 0;
+  if (!entireRange && maxX < minX)
+    return;
+  for (size_t i = 0; i < m_numEvents; ++i) {
+    if (!entireRange) {
+      const double x = tof(i);
+      if (x < minX || x > maxX)
+        continue;
+    }
+    sum += static_cast<double>(weight(i));
+    error += static_cast<double>(errorSquared(i));
+  }
+  error = std::sqrt(error);
+}
+
+/** Decode the events with start <= pulse time < stop, keeping their order.
+ * The pulse times are compared through their index in the sorted pulse table
+ * and only the selected events are decoded.
+ * @param start :: start time in nanoseconds
+ * @param stop :: stop time in nanoseconds
+ * @param output :: the events are appended to this
+ */
+void CompactEvents::filterByPulseTime(const int64_t start, const int64_t stop,
+                                      std::vector<TofEvent> &output) const {
+  filterByPulseTimeHelper(start, stop, output);
+}
+
+/** Decode the events with start <= pulse time < stop, keeping their order.
+ * @param start :: start time in nanoseconds
+ * @param stop :: stop time in nanoseconds
+ * @param output :: the events are appended to this
+ */
+void CompactEvents::filterByPulseTime(
+    const int64_t start, const int64_t stop,
+    std::vector<WeightedEvent> &output) const {
+  filterByPulseTimeHelper(start, stop, output);
+}
+
+template <class T>
+void CompactEvents::filterByPulseTimeHelper(const int64_t start,
+                                            const int64_t stop,
+                                            std::vector<T> &output) const {
+  if (!m_hasPulseTimes)
+    throw std::runtime_error("CompactEvents::filterByPulseTime(): no pulse "
+                             "times are stored.");
+  const size_t first = lowerPulseIndex(start);
+  const size_t last = lowerPulseIndex(stop);
+  if (first >= last)
+    return;
+
+  for (size_t i = 0; i < m_numEvents; ++i) {
+    const size_t index = pulseIndex(i);
+    if (index >= first && index < last)
+      appendEvent(i, output);
+  }
+}
+
+/** Decode one event and append it to a vector.
+ * @param i :: index of the event
+ * @param output :: the event is appended to this
+ */
+void CompactEvents::appendEvent(const size_t i,
+                                std::vector<TofEvent> &output) const {
+  output.emplace_back(tof(i), DateAndTime(pulseTime(i)));
+}
+
+/** Decode one event and append it to a vector.
+ * @param i :: index of the event
+ * @param output :: the event is appended to this
+ */
+void CompactEvents::appendEvent(const size_t i,
+                                std::vector<WeightedEvent> &output) const {
+  output.emplace_back(tof(i), DateAndTime(pulseTime(i)), weight(i),
+                      errorSquared(i));
+}
+
+/** Store the time-of-flight, in single precision if that is exact or if
+ * rounding is requested, else as offsets on a decimal grid if that is exact,
+ * else in double precision.
+ * @param events :: the events
+ * @param roundTof :: round the time-of-flight to single precision
+ */
+template <class T>
+void CompactEvents::assignTofs(const std::vector<T> &events,
+                               const bool roundTof) {
+  m_numEvents = events.size();
+  m_roundTof = roundTof;
+  m_sortedByTof = std::is_sorted(
+      events.cbegin(), events.cend(),
+      [](const T &lhs, const T &rhs) { return lhs.tof() < rhs.tof(); });
+  const bool exactAsFloat =
+      roundTof ||
+      std::all_of(events.cbegin(), events.cend(), [](const T &event) {
+        return static_cast<double>(static_cast<float>(event.tof())) ==
+               event.tof();
+      });
+  if (exactAsFloat) {
+    m_tofStorage = TofStorage::Single;
+    m_singleTof.reserve(m_numEvents);
+    for (const auto &event : events)
+      m_singleTof.push_back(static_cast<float>(event.tof()));
+  } else if (assignOffsetTofs(events)) {
+    m_tofStorage = TofStorage::Offset;
+  } else {
+    m_tofStorage = TofStorage::Double;
+    m_doubleTof.reserve(m_numEvents);
+    for (const auto &event : events)
+      m_doubleTof.push_back(event.tof());
+  }
+}
+
+/** Store the time-of-flight as 32-bit offsets from the smallest value, on the
+ * coarsest decimal grid which reproduces every value exactly.
+ * @param events :: the events
+ * @return false, and nothing stored, if no grid reproduces every value or
+ * the values span too many steps of the grid
+ */
+template <class T>
+bool CompactEvents::assignOffsetTofs(const std::vector<T> &events) {
+  if (events.empty())
+    return false;
+  for (const double scale : OFFSET_SCALES) {
+    int64_t minUnits = std::numeric_limits<int64_t>::max();
+    int64_t maxUnits = std::numeric_limits<int64_t>::min();
+    bool onGrid = true;
+    for (const auto &event : events) {
+      const double tof = event.tof();
+      const double scaled = tof * scale;
+      // Rejects NaN and infinities too. -0 would come back as +0.
+      if (!(std::abs(scaled) < MAX_EXACT_INTEGER) ||
+          (tof == 0. && std::signbit(tof))) {
+        onGrid = false;
+        break;
+      }
+      const auto units = static_cast<int64_t>(std::llround(scaled));
+      if (static_cast<double>(units) / scale != tof) {
+        onGrid = false;
+        break;
+      }
+      minUnits = std::min(minUnits, units);
+      maxUnits = std::max(maxUnits, units);
+    }
+    if (!onGrid ||
+        maxUnits - minUnits > std::numeric_limits<uint32_t>::max())
+      continue;
+
+    m_tofBase = minUnits;
+    m_tofScale = scale;
+    m_tofOffset.reserve(events.size());
+    for (const auto &event : events)
+      m_tofOffset.push_back(static_cast<uint32_t>(
+          std::llround(event.tof() * scale) - minUnits));
+    return true;
+  }
+  return false;
+}
+
+/** Store the pulse times as indices into the table of distinct pulse times.
+ * @param events :: the events
+ */
+template <class T>
+void CompactEvents::assignPulseTimes(const std::vector<T> &events) {
+  m_hasPulseTimes = true;
+  std::vector<int64_t> table;
+  table.reserve(events.size());
+  for (const auto &event : events)
+    table.push_back(event.pulseTime().totalNanoseconds());
+  std::sort(table.begin(), table.end());
+  table.erase(std::unique(table.begin(), table.end()), table.end());
+
+  const auto indexOf = [&table](const T &event) {
+    return static_cast<size_t>(
+        std::lower_bound(table.cbegin(), table.cend(),
+                         event.pulseTime().totalNanoseconds()) -
+        table.cbegin());
+  };
+  if (table.size() <= std::numeric_limits<uint16_t>::max() + size_t(1)) {
+    m_narrowPulseIndex.reserve(events.size());
+    for (const auto &event : events)
+      m_narrowPulseIndex.push_back(static_cast<uint16_t>(indexOf(event)));
+  } else {
+    m_widePulseIndex.reserve(events.size());
+    for (const auto &event : events)
+      m_widePulseIndex.push_back(static_cast<uint32_t>(indexOf(event)));
+  }
+  assignPulseTable(table);
+}
+
+/** Store the table of distinct pulse times in blocks of a first pulse time
+ * and 32-bit offsets from it. The largest blocks whose offsets all fit are
+ * used; if even small blocks do not fit, e.g. for pulses several seconds
+ * apart, the table is kept as it is.
+ * @param table :: the sorted distinct pulse times; consumed
+ */
+void CompactEvents::assignPulseTable(std::vector<int64_t> &table) {
+  m_numPulses = table.size();
+  for (unsigned shift = MAX_PULSE_BLOCK_SHIFT; shift >= MIN_PULSE_BLOCK_SHIFT;
+       --shift) {
+    const size_t blockSize = size_t(1) << shift;
+    bool fits = true;
+    for (size_t start = 0; start < m_numPulses && fits; start += blockSize) {
+      const size_t end = std::min(start + blockSize, m_numPulses);
+      fits = static_cast<uint64_t>(table[end - 1]) -
+                 static_cast<uint64_t>(table[start]) <=
+             std::numeric_limits<uint32_t>::max();
+    }
+    if (!fits)
+      continue;
+    m_pulseBlockShift = shift;
+    m_pulseBase.reserve((m_numPulses + blockSize - 1) / blockSize);
+    m_pulseOffset.reserve(m_numPulses);
+    for (size_t i = 0; i < m_numPulses; ++i) {
+      if ((i & (blockSize - 1)) == 0)
+        m_pulseBase.push_back(table[i]);
+      m_pulseOffset.push_back(
+          static_cast<uint32_t>(static_cast<uint64_t>(table[i]) -
+                                static_cast<uint64_t>(m_pulseBase.back())));
+    }
+    return;
+  }
+  table.shrink_to_fit();
+  m_pulseBase.swap(table);
+}
+
+/** @param pulseTime :: a pulse time in nanoseconds
+ * @return the index of the first pulse time in the table that is not before
+ * pulseTime
+ */
+size_t CompactEvents::lowerPulseIndex(const int64_t pulseTime) const {
+  size_t first = 0;
+  size_t count = m_numPulses;
+  while (count > 0) {
+    const size_t step = count / 2;
+    if (pulseTableEntry(first + step) < pulseTime) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
+/** Store the weights and squared errors, unless they are all 1.
+ * @param events :: the events
+ */
+template <class T>
+void CompactEvents::assignWeights(const std::vector<T> &events) {
+  m_hasWeights = true;
+  const bool unitWeights =
+      std::all_of(events.cbegin(), events.cend(), [](const T &event) {
+        return event.m_weight == 1.0f && event.m_errorSquared == 1.0f;
+      });
+  if (unitWeights)
+    return;
+  m_weight.reserve(events.size());
+  m_errorSquared.reserve(events.size());
+  for (const auto &event : events) {
+    m_weight.push_back(event.m_weight);
+    m_errorSquared.push_back(event.m_errorSquared);
+  }
+}
+
+} // namespace DataObjects
+} // namespace Mantid
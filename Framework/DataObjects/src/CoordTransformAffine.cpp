@@ -284,6 +284,36 @@ void CoordTransformAffine::apply(const coord_t *inputVector,
   }
 }
 
+//----------------------------------------------------------------------------------------------
+/** Apply the coordinate transformation to a batch of vectors.
+ *
+ * The matrix is applied one coefficient at a time to the whole batch, so
+ * that the inner loops run over the vectors and can be vectorized.
+ *
+ * @param inputVectors :: numVectors inD-length vectors, one after the other
+ * @param outVectors :: numVectors outD-length vectors, one after the other
+ * @param numVectors :: the number of vectors to transform
+ */
+void CoordTransformAffine::applyToBatch(const coord_t *inputVectors,
+                                        coord_t *outVectors,
+                                        size_t numVectors) const {
+  for (size_t out = 0; out < outD; ++out) {
+    const coord_t *rawMatrixRow = m_rawMatrix[out];
+    for (size_t i = 0; i < numVectors; ++i)
+      outVectors[i * outD + out] = 0.0;
+    for (size_t in = 0; in < inD; ++in) {
+      const coord_t factor = rawMatrixRow[in];
+      for (size_t i = 0; i < numVectors; ++i)
+        outVectors[i * outD + out] += factor * inputVectors[i * inD + in];
+    }
+    // The homogenous coordinate gives the translation, added last as in
+    // apply() so that both round the same way
+    const coord_t translation = rawMatrixRow[inD];
+    for (size_t i = 0; i < numVectors; ++i)
+      outVectors[i * outD + out] += translation;
+  }
+}
+
 //----------------------------------------------------------------------------------------------
 /** Serialize the coordinate transform
  *
@@ -139,6 +139,27 @@ void CoordTransformAligned::apply(const coord_t *inputVector,
   }
 }
 
+//----------------------------------------------------------------------------------------------
+/** Apply the coordinate transformation to a batch of vectors, one output
+ * dimension at a time so that the inner loop runs over the vectors.
+ *
+ * @param inputVectors :: numVectors inD-length vectors, one after the other
+ * @param outVectors :: numVectors outD-length vectors, one after the other
+ * @param numVectors :: the number of vectors to transform
+ */
+void CoordTransformAligned::applyToBatch(const coord_t *inputVectors,
+                                         coord_t *outVectors,
+                                         size_t numVectors) const {
+  for (size_t out = 0; out < outD; ++out) {
+    const size_t in = m_dimensionToBinFrom[out];
+    const coord_t origin = m_origin[out];
+    const coord_t scaling = m_scaling[out];
+    for (size_t i = 0; i < numVectors; ++i)
+      outVectors[i * outD + out] =
+          (inputVectors[i * inD + in] - origin) * scaling;
+  }
+}
+
 //----------------------------------------------------------------------------------------------
 /** Create an equivalent affine transformation matrix out of the
  * parameters of this axis-aligned transformation.
@@ -0,0 +1,338 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataObjects/EventColumns.h"
+
+#ifdef _MSC_VER
+// qualifier applied to function type has no meaning; ignored
+#pragma warning(disable : 4180)
+#endif
+#include "tbb/parallel_sort.h"
+#ifdef _MSC_VER
+#pragma warning(default : 4180)
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace Mantid {
+namespace DataObjects {
+using Types::Core::DateAndTime;
+using Types::Event::TofEvent;
+
+namespace {
+/** Reorder a column according to a permutation.
+ * @param column :: the column to reorder in place
+ * @param order :: new position i takes the value at old position order[i]
+ */
+template <class T>
+void gather(std::vector<T> &column, const std::vector<size_t> &order) {
+  if (column.empty())
+    return;
+  std::vector<T> sorted;
+  sorted.reserve(column.size());
+  for (const auto index : order)
+    sorted.push_back(column[index]);
+  column.swap(sorted);
+}
+
+/// Release the memory of a column that is no longer used
+template <class T> void release(std::vector<T> &column) {
+  std::vector<T>().swap(column);
+}
+} // namespace
+
+/** Fill the columns from a vector of TofEvent. Any previous content is
+ * discarded.
+ * @param events :: the events to copy
+ */
+void EventColumns::assign(const std::vector<TofEvent> &events) {
+  clear();
+  m_hasPulseTimes = true;
+  m_tof.reserve(events.size());
+  m_pulseTime.reserve(events.size());
+  for (const auto &event : events) {
+    m_tof.push_back(event.tof());
+    m_pulseTime.push_back(event.pulseTime().totalNanoseconds());
+  }
+}
+
+/** Fill the columns from a vector of WeightedEvent. Any previous content is
+ * discarded.
+ * @param events :: the events to copy
+ */
+void EventColumns::assign(const std::vector<WeightedEvent> &events) {
+  clear();
+  m_hasPulseTimes = true;
+  m_hasWeights = true;
+  m_tof.reserve(events.size());
+  m_pulseTime.reserve(events.size());
+  m_weight.reserve(events.size());
+  m_errorSquared.reserve(events.size());
+  for (const auto &event : events) {
+    m_tof.push_back(event.tof());
+    m_pulseTime.push_back(event.pulseTime().totalNanoseconds());
+    m_weight.push_back(event.m_weight);
+    m_errorSquared.push_back(event.m_errorSquared);
+  }
+}
+
+/** Fill the columns from a vector of WeightedEventNoTime. Any previous content
+ * is discarded.
+ * @param events :: the events to copy
+ */
+void EventColumns::assign(const std::vector<WeightedEventNoTime> &events) {
+  clear();
+  m_hasWeights = true;
+  m_tof.reserve(events.size());
+  m_weight.reserve(events.size());
+  m_errorSquared.reserve(events.size());
+  for (const auto &event : events) {
+    m_tof.push_back(event.tof());
+    m_weight.push_back(event.m_weight);
+    m_errorSquared.push_back(event.m_errorSquared);
+  }
+}
+
+/** Rebuild a vector of TofEvent from the columns.
+ * @param events :: vector to fill; any previous content is discarded
+ */
+void EventColumns::extract(std::vector<TofEvent> &events) const {
+  if (!m_hasPulseTimes && !m_tof.empty())
+    throw std::runtime_error("EventColumns::extract(): the columns hold no "
+                             "pulse times, cannot create TofEvent's.");
+  events.clear();
+  events.reserve(m_tof.size());
+  for (size_t i = 0; i < m_tof.size(); ++i)
+    events.emplace_back(m_tof[i], DateAndTime(m_pulseTime[i]));
+}
+
+/** Rebuild a vector of WeightedEvent from the columns. Missing weights default
+ * to 1.
+ * @param events :: vector to fill; any previous content is discarded
+ */
+void EventColumns::extract(std::vector<WeightedEvent> &events) const {
+  if (!m_hasPulseTimes && !m_tof.empty())
+    throw std::runtime_error("EventColumns::extract(): the columns hold no "
+                             "pulse times, cannot create WeightedEvent's.");
+  events.clear();
+  events.reserve(m_tof.size());
+  for (size_t i = 0; i < m_tof.size(); ++i) {
+    if (m_hasWeights)
+      events.emplace_back(m_tof[i], DateAndTime(m_pulseTime[i]), m_weight[i],
+                          m_errorSquared[i]);
+    else
+      events.emplace_back(m_tof[i], DateAndTime(m_pulseTime[i]), 1.0f, 1.0f);
+  }
+}
+
+/** Rebuild a vector of WeightedEventNoTime from the columns. Missing weights
+ * default to 1.
+ * @param events :: vector to fill; any previous content is discarded
+ */
+void EventColumns::extract(std::vector<WeightedEventNoTime> &events) const {
+  events.clear();
+  events.reserve(m_tof.size());
+  for (size_t i = 0; i < m_tof.size(); ++i) {
+    if (m_hasWeights)
+      events.emplace_back(m_tof[i], m_weight[i], m_errorSquared[i]);
+    else
+      events.emplace_back(m_tof[i], 1.0f, 1.0f);
+  }
+}
+
+/// Remove all events and free the memory of the columns
+void EventColumns::clear() {
+  release(m_tof);
+  release(m_pulseTime);
+  release(m_weight);
+  release(m_errorSquared);
+  m_hasPulseTimes = false;
+  m_hasWeights = false;
+}
+
+/** Memory used by the columns. As for EventList, this reports the capacity of
+ * the vectors rather than their size.
+ * @return :: the memory used, in bytes.
+ */
+size_t EventColumns::getMemorySize() const {
+  return m_tof.capacity() * sizeof(double) +
+         m_pulseTime.capacity() * sizeof(int64_t) +
+         (m_weight.capacity() + m_errorSquared.capacity()) * sizeof(float) +
+         sizeof(EventColumns);
+}
+
+/** Sort all columns by time-of-flight. The sort permutation is computed on the
+ * time-of-flight column alone and then applied to each populated column.
+ */
+void EventColumns::sortTof() {
+  if (std::is_sorted(m_tof.cbegin(), m_tof.cend()))
+    return;
+
+  std::vector<size_t> order(m_tof.size());
+  std::iota(order.begin(), order.end(), 0);
+  const auto &tof = m_tof;
+  tbb::parallel_sort(order.begin(), order.end(),
+                     [&tof](const size_t lhs, const size_t rhs) {
+                       return tof[lhs] < tof[rhs];
+                     });
+  gather(m_tof, order);
+  gather(m_pulseTime, order);
+  gather(m_weight, order);
+  gather(m_errorSquared, order);
+}
+
+/// Reverse the order of the events in every column
+void EventColumns::reverse() {
+  std::reverse(m_tof.begin(), m_tof.end());
+  std::reverse(m_pulseTime.begin(), m_pulseTime.end());
+  std::reverse(m_weight.begin(), m_weight.end());
+  std::reverse(m_errorSquared.begin(), m_errorSquared.end());
+}
+
+/** Convert the time-of-flight by tof' = tof * factor + offset. Does NOT
+ * reverse the columns if the factor is negative.
+ * @param factor :: multiply by this
+ * @param offset :: add this
+ */
+void EventColumns::convertTof(const double factor, const double offset) {
+  double *tof = m_tof.data();
+  const size_t numEvents = m_tof.size();
+  for (size_t i = 0; i < numEvents; ++i)
+    tof[i] = tof[i] * factor + offset;
+}
+
+/** Convert the time-of-flight of every event with an arbitrary function.
+ * @param func :: the conversion function
+ */
+void EventColumns::convertTof(const std::function<double(double)> &func) {
+  std::transform(m_tof.begin(), m_tof.end(), m_tof.begin(), func);
+}
+
+/** Remove the events with a time-of-flight between tofMin and tofMax
+ * (inclusively). The columns must be sorted by time-of-flight.
+ * @param tofMin :: lower bound of TOF to filter out
+ * @param tofMax :: upper bound of TOF to filter out
+ * @returns The number of events deleted.
+ */
+size_t EventColumns::maskTof(const double tofMin, const double tofMax) {
+  if (m_tof.empty() || tofMin > m_tof.back() || tofMax < m_tof.front())
+    return 0;
+
+  const auto first = std::lower_bound(m_tof.cbegin(), m_tof.cend(), tofMin);
+  if (first == m_tof.cend() || *first >= tofMax)
+    return 0;
+  const auto last = std::upper_bound(first, m_tof.cend(), tofMax);
+
+  const auto firstIndex = static_cast<size_t>(first - m_tof.cbegin());
+  const auto lastIndex = static_cast<size_t>(last - m_tof.cbegin());
+  erase(firstIndex, lastIndex);
+  return lastIndex - firstIndex;
+}
+
+/** Histogram the events. The columns must be sorted by time-of-flight. Bin i
+ * holds the events with X[i] <= tof < X[i+1]; the bin boundaries are found by
+ * binary search so only the weight column is streamed for weighted events, and
+ * nothing but the boundaries is touched for unweighted ones.
+ *
+ * @param X :: bin boundaries, sorted in increasing order
+ * @param Y :: counts (or summed weights) returned
+ * @param E :: errors returned
+ */
+void EventColumns::histogram(const MantidVec &X, MantidVec &Y,
+                             MantidVec &E) const {
+  const size_t x_size = X.size();
+  if (x_size <= 1) {
+    // X was not set. Return an empty array.
+    Y.clear();
+    E.clear();
+    return;
+  }
+  Y.assign(x_size - 1, 0.0);
+  E.assign(x_size - 1, 0.0);
+  if (m_tof.empty())
+    return;
+
+  auto low = std::lower_bound(m_tof.cbegin(), m_tof.cend(), X.front());
+  for (size_t bin = 0; bin < x_size - 1 && low != m_tof.cend(); ++bin) {
+    const auto high = std::lower_bound(low, m_tof.cend(), X[bin + 1]);
+    const auto first = static_cast<size_t>(low - m_tof.cbegin());
+    const auto last = static_cast<size_t>(high - m_tof.cbegin());
+    if (m_hasWeights) {
+      double weight = 0.;
+      double errorSquared = 0.;
+      for (size_t i = first; i < last; ++i) {
+        weight += static_cast<double>(m_weight[i]);
+        errorSquared += static_cast<double>(m_errorSquared[i]);
+      }
+      Y[bin] = weight;
+      E[bin] = std::sqrt(errorSquared);
+    } else {
+      Y[bin] = static_cast<double>(last - first);
+      E[bin] = std::sqrt(Y[bin]);
+    }
+    low = high;
+  }
+}
+
+/** Integrate the events between a range of X values, or all events. The
+ * columns must be sorted by time-of-flight unless the entire range is used.
+ * @param minX :: minimum X bin to use in integrating.
+ * @param maxX :: maximum X bin to use in integrating.
+ * @param entireRange :: set to true to use the entire range. minX and maxX are
+ *then ignored!
+ * @param sum :: reference to a double to put the sum in.
+ * @param error :: reference to a double to put the error in.
+ */
+void EventColumns::integrate(const double minX, const double maxX,
+                             const bool entireRange, double &sum,
+                             double &error) const {
+  sum = 0;
+  error = 0;
+  if (m_tof.empty() || (!entireRange && maxX < minX))
+    return;
+
+  size_t first = 0;
+  size_t last = m_tof.size();
+  if (!entireRange) {
+    first = static_cast<size_t>(
+        std::lower_bound(m_tof.cbegin(), m_tof.cend(), minX) - m_tof.cbegin());
+    last = static_cast<size_t>(
+        std::upper_bound(m_tof.cbegin() + first, m_tof.cend(), maxX) -
+        m_tof.cbegin());
+  }
+
+  if (m_hasWeights) {
+    for (size_t i = first; i < last; ++i) {
+      sum += static_cast<double>(m_weight[i]);
+      error += static_cast<double>(m_errorSquared[i]);
+    }
+  } else {
+    sum = static_cast<double>(last - first);
+    error = sum;
+  }
+  error = std::sqrt(error);
+}
+
+/** Erase the events in the index range [first, last) from every column
+ * @param first :: index of the first event to erase
+ * @param last :: index one past the last event to erase
+ */
+void EventColumns::erase(const size_t first, const size_t last) {
+  m_tof.erase(m_tof.begin() + first, m_tof.begin() + last);
+  if (m_hasPulseTimes)
+    m_pulseTime.erase(m_pulseTime.begin() + first, m_pulseTime.begin() + last);
+  if (m_hasWeights) {
+    m_weight.erase(m_weight.begin() + first, m_weight.begin() + last);
+    m_errorSquared.erase(m_errorSquared.begin() + first,
+                         m_errorSquared.begin() + last);
+  }
+}
+
+} // namespace DataObjects
+} // namespace Mantid
@@ -0,0 +1,235 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataObjects/EventHistogramCache.h"
+#include "MantidKernel/ConfigService.h"
+
+#include <utility>
+#include <vector>
+
+namespace Mantid {
+namespace DataObjects {
+
+namespace {
+/// Cache size used if none is configured, in megabytes
+constexpr int DEFAULT_CACHE_SIZE_MB = 100;
+/// Approximate memory used by an entry besides the histograms
+constexpr size_t ENTRY_OVERHEAD = 128;
+
+/// Source of the generation numbers of all event lists
+std::atomic<uint64_t> g_nextGeneration{1};
+
+/// The histograms most recently read by a thread, kept alive in a ring
+struct PinnedHistograms {
+  std::vector<std::pair<EventHistogramCache::YType, EventHistogramCache::EType>>
+      entries;
+  size_t next{0};
+};
+thread_local PinnedHistograms g_pinned;
+} // namespace
+
+constexpr size_t EventHistogramCache::PINNED_PER_THREAD;
+
+/// Constructor using the memory limit from the configuration
+EventHistogramCache::EventHistogramCache()
+    : EventHistogramCache(defaultMemoryLimit()) {}
+
+/** Constructor
+ * @param memoryLimit :: maximum memory used by the cached histograms, in bytes
+ */
+EventHistogramCache::EventHistogramCache(const size_t memoryLimit)
+    : m_memoryLimit(memoryLimit) {}
+
+/** @return the memory limit given by EventWorkspace.HistogramCacheSize, in
+ * bytes */
+size_t EventHistogramCache::defaultMemoryLimit() {
+  const auto sizeMB = Kernel::ConfigService::Instance().getValue<int>(
+      "EventWorkspace.HistogramCacheSize");
+  const int size = sizeMB.get_value_or(DEFAULT_CACHE_SIZE_MB);
+  return size > 0 ? static_cast<size_t>(size) * 1024 * 1024 : 0;
+}
+
+/** @return a generation number that has never been returned before. Event
+ * lists take a new one each time their histograms become invalid. */
+uint64_t EventHistogramCache::newGeneration() { return g_nextGeneration++; }
+
+/** Keep histograms alive for the calling thread until it has pinned
+ * PINNED_PER_THREAD others, so that references into them stay valid even if
+ * the cache evicts them. Pins are shared by all caches of the thread.
+ * @param y :: Y histogram
+ * @param e :: E histogram
+ */
+void EventHistogramCache::pin(const YType &y, const EType &e) {
+  auto &pinned = g_pinned;
+  if (!pinned.entries.empty()) {
+    // Reading the same histogram repeatedly needs a single pin
+    const auto &last =
+        pinned.entries[(pinned.next + pinned.entries.size() - 1) %
+                       pinned.entries.size()];
+    if (last.first.get() == y.get() && last.second.get() == e.get())
+      return;
+  }
+  if (pinned.entries.size() < PINNED_PER_THREAD) {
+    pinned.entries.emplace_back(y, e);
+  } else {
+    pinned.entries[pinned.next] = std::make_pair(y, e);
+    pinned.next = (pinned.next + 1) % PINNED_PER_THREAD;
+  }
+}
+
+/** Look for the histograms of an event list.
+ *
+ * @param list :: the event list
+ * @param generation :: current generation of the event list
+ * @param y :: set to the cached Y histogram if found
+ * @param e :: set to the cached E histogram if found
+ * @return true if the histograms were found for this generation
+ */
+bool EventHistogramCache::find(const EventList *list,
+                               const uint64_t generation, YType &y, EType &e) {
+  auto &shard = shardOf(list);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  const auto found = shard.index.find(list);
+  if (found == shard.index.end()) {
+    ++shard.misses;
+    return false;
+  }
+  const auto entry = found->second;
+  if (entry->generation != generation) {
+    // The list changed since the histograms were generated
+    remove(shard, entry);
+    ++shard.misses;
+    return false;
+  }
+  ++shard.hits;
+  shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+  y = entry->y;
+  e = entry->e;
+  return true;
+}
+
+/** Add the histograms of an event list, replacing any previous ones, and
+ * evict the least recently used histograms if the memory limit is exceeded.
+ *
+ * @param list :: the event list
+ * @param generation :: generation of the event list the histograms belong to
+ * @param y :: Y histogram
+ * @param e :: E histogram
+ */
+void EventHistogramCache::insert(const EventList *list,
+                                 const uint64_t generation, YType y, EType e) {
+  const size_t memory = ENTRY_OVERHEAD +
+                        ((y ? y->size() : 0) + (e ? e->size() : 0)) *
+                            sizeof(double);
+  auto &shard = shardOf(list);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  const auto found = shard.index.find(list);
+  if (found != shard.index.end())
+    remove(shard, found->second);
+  shard.entries.push_front(
+      Entry{list, generation, std::move(y), std::move(e), memory});
+  shard.index.emplace(list, shard.entries.begin());
+  shard.memoryUsed += memory;
+  evict(shard);
+}
+
+/** Remove the histograms of an event list, e.g. when it is deleted.
+ * @param list :: the event list
+ */
+void EventHistogramCache::erase(const EventList *list) {
+  auto &shard = shardOf(list);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  const auto found = shard.index.find(list);
+  if (found != shard.index.end())
+    remove(shard, found->second);
+}
+
+/// Remove all histograms. The statistics are kept.
+void EventHistogramCache::clear() {
+  for (auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.index.clear();
+    shard.entries.clear();
+    shard.memoryUsed = 0;
+  }
+}
+
+/** Change the memory limit, evicting histograms if needed.
+ * @param memoryLimit :: maximum memory used by the cached histograms, in bytes
+ */
+void EventHistogramCache::setMemoryLimit(const size_t memoryLimit) {
+  m_memoryLimit = memoryLimit;
+  for (auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    evict(shard);
+  }
+}
+
+/// @return the number of cached histograms
+size_t EventHistogramCache::size() const { return statistics().entries; }
+
+/// @return the usage counters summed over all shards
+EventHistogramCache::Statistics EventHistogramCache::statistics() const {
+  Statistics total;
+  for (const auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    total.hits += shard.hits;
+    total.misses += shard.misses;
+    total.evictions += shard.evictions;
+    total.entries += shard.entries.size();
+    total.memoryUsed += shard.memoryUsed;
+  }
+  return total;
+}
+
+/// Reset the hit, miss and eviction counters
+void EventHistogramCache::resetStatistics() {
+  for (auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.hits = 0;
+    shard.misses = 0;
+    shard.evictions = 0;
+  }
+}
+
+/** Select the shard of an event list. The addresses are hashed since event
+ * lists are allocated with a regular stride.
+ * @param list :: the event list
+ * @return the shard holding the histograms of the list
+ */
+EventHistogramCache::Shard &
+EventHistogramCache::shardOf(const EventList *list) {
+  const auto address = reinterpret_cast<std::uintptr_t>(list);
+  const uint64_t hash =
+      static_cast<uint64_t>(address) * UINT64_C(0x9E3779B97F4A7C15);
+  return m_shards[hash >> (64 - SHARD_BITS)];
+}
+
+/** Evict the least recently used entries of a shard until it fits in its part
+ * of the memory limit, always keeping the most recent entry.
+ * @param shard :: the shard, which must be locked
+ */
+void EventHistogramCache::evict(Shard &shard) {
+  const size_t shardLimit = m_memoryLimit / NUM_SHARDS;
+  while (shard.memoryUsed > shardLimit && shard.entries.size() > 1) {
+    remove(shard, std::prev(shard.entries.end()));
+    ++shard.evictions;
+  }
+}
+
+/** Remove an entry from a shard
+ * @param shard :: the shard, which must be locked
+ * @param entry :: the entry to remove
+ */
+void EventHistogramCache::remove(Shard &shard,
+                                 std::list<Entry>::iterator entry) {
+  shard.memoryUsed -= entry->memory;
+  shard.index.erase(entry->list);
+  shard.entries.erase(entry);
+}
+
+} // namespace DataObjects
+} // namespace Mantid
@@ -0,0 +1,286 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataObjects/EventHistogrammer.h"
+#include "MantidKernel/MultiThreaded.h"
+#include "MantidKernel/make_unique.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+namespace Mantid {
+namespace DataObjects {
+using Types::Event::TofEvent;
+
+namespace {
+/// Largest deviation of an edge from the regular grid, in units of the step,
+/// for the binning to be treated as regular.
+constexpr double TOLERANCE = 1e-3;
+/// Number of events whose bins are estimated in one go
+constexpr size_t BLOCK_SIZE = 256;
+/// Minimum number of events given to each thread
+constexpr size_t MIN_EVENTS_PER_THREAD = 250000;
+
+/** Check whether the values are evenly spaced, allowing the last step to be
+ * shorter than the others.
+ * @param values :: the values to check
+ * @param step :: returns the common step
+ * @return true if the values are evenly spaced
+ */
+bool isEvenlySpaced(const std::vector<double> &values, double &step) {
+  const size_t numSteps = values.size() - 1;
+  step = values[1] - values[0];
+  if (!(step > 0.) || !std::isfinite(step))
+    return false;
+  for (size_t i = 1; i < numSteps; ++i) {
+    const double expected = values[0] + static_cast<double>(i) * step;
+    if (std::abs(values[i] - expected) > TOLERANCE * step)
+      return false;
+  }
+  const double lastStep = values[numSteps] - values[numSteps - 1];
+  return lastStep > 0. && lastStep <= step * (1. + TOLERANCE);
+}
+
+/// The histogrammer most recently returned by forEdges on a thread
+struct CachedHistogrammer {
+  /// Copy of the bin edges, referenced by the histogrammer
+  MantidVec edges;
+  std::unique_ptr<EventHistogrammer> histogrammer;
+};
+thread_local CachedHistogrammer g_cached;
+
+/// Add one event to the histogram
+inline void addEvent(const TofEvent &, const size_t bin, double *Y, double *) {
+  Y[bin] += 1.;
+}
+
+/// Add one weighted event to the histogram. E holds the squared errors.
+template <class T>
+inline void addEvent(const T &event, const size_t bin, double *Y, double *E) {
+  Y[bin] += static_cast<double>(event.weight());
+  E[bin] += static_cast<double>(event.errorSquared());
+}
+} // namespace
+
+/** Constructor. Detects the kind of binning from the bin edges.
+ * @param X :: the bin edges. They are referenced, not copied, and must outlive
+ * this object.
+ */
+EventHistogrammer::EventHistogrammer(const MantidVec &X)
+    : m_x(X), m_numBins(X.size() > 1 ? X.size() - 1 : 0),
+      m_type(BinningType::Irregular), m_start(0.), m_inverseStep(0.) {
+  if (m_numBins == 0)
+    return;
+
+  double step(0.);
+  if (isEvenlySpaced(X, step)) {
+    m_type = BinningType::Linear;
+    m_start = X.front();
+    m_inverseStep = 1. / step;
+    return;
+  }
+
+  if (!(X.front() > 0.) || !std::isfinite(X.back()))
+    return;
+  std::vector<double> logX(X.size());
+  std::transform(X.cbegin(), X.cend(), logX.begin(),
+                 static_cast<double (*)(double)>(std::log));
+  if (isEvenlySpaced(logX, step)) {
+    m_type = BinningType::Logarithmic;
+    m_start = 1. / X.front();
+    m_inverseStep = 1. / step;
+  }
+}
+
+/** Get a histogrammer for the bin edges. The binning detected for the
+ * previous call on this thread is reused if the edges are the same, so
+ * histogramming many spectra with common edges inspects them once per thread
+ * instead of once per spectrum.
+ * @param X :: the bin edges
+ * @return a histogrammer, valid until the next call on this thread
+ */
+const EventHistogrammer &EventHistogrammer::forEdges(const MantidVec &X) {
+  if (!g_cached.histogrammer || g_cached.edges != X) {
+    g_cached.histogrammer.reset();
+    g_cached.edges = X;
+    g_cached.histogrammer =
+        Kernel::make_unique<EventHistogrammer>(g_cached.edges);
+  }
+  return *g_cached.histogrammer;
+}
+
+/** Find the bin containing a value.
+ * @param x :: the value
+ * @return the index of the bin with X[i] <= x < X[i+1], or the number of bins
+ * if x is outside the edges
+ */
+size_t EventHistogrammer::findBin(const double x) const {
+  if (m_numBins == 0 || !(x >= m_x.front() && x < m_x.back()))
+    return m_numBins;
+  if (m_type == BinningType::Irregular)
+    return static_cast<size_t>(
+        std::upper_bound(m_x.cbegin(), m_x.cend(), x) - m_x.cbegin() - 1);
+
+  double estimate;
+  const TofEvent event(x);
+  estimateBins(&event, 1, &estimate);
+  return refineBin(x, estimate);
+}
+
+/** Count the events in each bin. The counts are added to Y, which must have
+ * one entry per bin.
+ * @param events :: the events to histogram
+ * @param Y :: the counts
+ */
+void EventHistogrammer::countEvents(const std::vector<TofEvent> &events,
+                                    MantidVec &Y) const {
+  histogram(events, Y, nullptr);
+}
+
+/** Sum the weights and squared errors of the events in each bin. They are
+ * added to Y and E, which must have one entry per bin. The square root of E is
+ * NOT taken.
+ * @param events :: the events to histogram
+ * @param Y :: the summed weights
+ * @param E :: the summed squared errors
+ */
+void EventHistogrammer::sumWeights(const std::vector<WeightedEvent> &events,
+                                   MantidVec &Y, MantidVec &E) const {
+  histogram(events, Y, &E);
+}
+
+/** Sum the weights and squared errors of the events in each bin. They are
+ * added to Y and E, which must have one entry per bin. The square root of E is
+ * NOT taken.
+ * @param events :: the events to histogram
+ * @param Y :: the summed weights
+ * @param E :: the summed squared errors
+ */
+void EventHistogrammer::sumWeights(
+    const std::vector<WeightedEventNoTime> &events, MantidVec &Y,
+    MantidVec &E) const {
+  histogram(events, Y, &E);
+}
+
+/** Histogram the events, splitting them between threads if there are enough
+ * of them and we are not already running in parallel.
+ * @param events :: the events to histogram
+ * @param Y :: the counts or weights are added to this
+ * @param E :: the squared errors are added to this, if not null
+ */
+template <class T>
+void EventHistogrammer::histogram(const std::vector<T> &events, MantidVec &Y,
+                                  MantidVec *E) const {
+  if (!isRegular())
+    throw std::runtime_error("EventHistogrammer: the bins are neither linear "
+                             "nor logarithmic.");
+  if (Y.size() != m_numBins || (E && E->size() != m_numBins))
+    throw std::invalid_argument("EventHistogrammer: the histogram does not "
+                                "have one value per bin.");
+
+  const size_t numEvents = events.size();
+  size_t numThreads = 1;
+  if (PARALLEL_NUMBER_OF_THREADS == 1) {
+    numThreads = std::min(static_cast<size_t>(PARALLEL_GET_MAX_THREADS),
+                          numEvents / MIN_EVENTS_PER_THREAD);
+    // Summing the partial histograms must stay cheap compared to the events
+    numThreads = std::min(numThreads, numEvents / (m_numBins + 1));
+  }
+  if (numThreads <= 1) {
+    fill(events.data(), events.data() + numEvents, Y.data(),
+         E ? E->data() : nullptr);
+    return;
+  }
+
+  std::vector<MantidVec> partialY(numThreads, MantidVec(m_numBins, 0.));
+  std::vector<MantidVec> partialE(E ? numThreads : 0,
+                                  MantidVec(m_numBins, 0.));
+  const int numThreadsRequested = static_cast<int>(numThreads);
+  PRAGMA_OMP(parallel num_threads(numThreadsRequested)) {
+    const auto thread = static_cast<size_t>(PARALLEL_THREAD_NUMBER);
+    const auto threadCount = static_cast<size_t>(PARALLEL_NUMBER_OF_THREADS);
+    const T *first = events.data() + numEvents * thread / threadCount;
+    const T *last = events.data() + numEvents * (thread + 1) / threadCount;
+    fill(first, last, partialY[thread].data(),
+         E ? partialE[thread].data() : nullptr);
+  }
+
+  for (const auto &partial : partialY)
+    std::transform(Y.cbegin(), Y.cend(), partial.cbegin(), Y.begin(),
+                   std::plus<double>());
+  for (const auto &partial : partialE)
+    std::transform(E->cbegin(), E->cend(), partial.cbegin(), E->begin(),
+                   std::plus<double>());
+}
+
+/** Histogram a range of events, block by block: the bin estimates for the
+ * whole block are computed first, then refined and accumulated.
+ * @param first :: the first event
+ * @param last :: one past the last event
+ * @param Y :: counts or weights, one per bin
+ * @param E :: squared errors, one per bin; unused for TofEvent
+ */
+template <class T>
+void EventHistogrammer::fill(const T *first, const T *last, double *Y,
+                             double *E) const {
+  const double xMin = m_x.front();
+  const double xMax = m_x.back();
+  double estimates[BLOCK_SIZE];
+  while (first < last) {
+    const size_t numEvents =
+        std::min(BLOCK_SIZE, static_cast<size_t>(last - first));
+    estimateBins(first, numEvents, estimates);
+    for (size_t i = 0; i < numEvents; ++i) {
+      const double x = first[i].tof();
+      if (x >= xMin && x < xMax)
+        addEvent(first[i], refineBin(x, estimates[i]), Y, E);
+    }
+    first += numEvents;
+  }
+}
+
+/** Estimate the (fractional) bin index of each event. This loop has no
+ * branches in its body so it can be vectorized.
+ * @param events :: the events
+ * @param numEvents :: how many events
+ * @param estimates :: the estimated bin indices
+ */
+template <class T>
+void EventHistogrammer::estimateBins(const T *events, const size_t numEvents,
+                                     double *estimates) const {
+  const double start = m_start;
+  const double inverseStep = m_inverseStep;
+  if (m_type == BinningType::Linear) {
+    for (size_t i = 0; i < numEvents; ++i)
+      estimates[i] = (events[i].tof() - start) * inverseStep;
+  } else {
+    for (size_t i = 0; i < numEvents; ++i)
+      estimates[i] = std::log(events[i].tof() * start) * inverseStep;
+  }
+}
+
+/** Turn a bin estimate into the exact bin by checking it against the edges.
+ * @param x :: a value within the edges
+ * @param estimate :: the estimated bin index of x
+ * @return the index of the bin with X[i] <= x < X[i+1]
+ */
+size_t EventHistogrammer::refineBin(const double x,
+                                    const double estimate) const {
+  const auto lastBin = static_cast<double>(m_numBins - 1);
+  size_t bin =
+      estimate > 0. ? static_cast<size_t>(std::min(estimate, lastBin)) : 0;
+  while (x < m_x[bin])
+    --bin;
+  while (x >= m_x[bin + 1])
+    ++bin;
+  return bin;
+}
+
+} // namespace DataObjects
+} // namespace Mantid
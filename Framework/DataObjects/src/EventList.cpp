@@ -6,12 +6,15 @@
 // SPDX - License - Identifier: GPL - 3.0 +
 #include "MantidDataObjects/EventList.h"
 #include "MantidAPI/MatrixWorkspace.h"
-#include "MantidDataObjects/EventWorkspaceMRU.h"
+#include "MantidDataObjects/EventHistogramCache.h"
+#include "MantidDataObjects/EventHistogrammer.h"
 #include "MantidDataObjects/Histogram1D.h"
+#include "MantidKernel/ConfigService.h"
 #include "MantidKernel/DateAndTime.h"
 #include "MantidKernel/DateAndTimeHelpers.h"
 #include "MantidKernel/Exception.h"
 #include "MantidKernel/Logger.h"
+#include "MantidKernel/RadixSort.h"
 #include "MantidKernel/Unit.h"
 
 #ifdef _MSC_VER
@@ -23,6 +26,8 @@
 #pragma warning(default : 4180)
 #endif
 
+#include <boost/algorithm/string/predicate.hpp>
+
 #include <cfloat>
 #include <cmath>
 #include <functional>
@@ -149,26 +154,92 @@ struct comparePulseTimeTOFDelta {
   int64_t deltaNano;
 };
 
+namespace {
+/// Smallest event list for which the radix sort is used, if selected
+constexpr size_t RADIX_SORT_MIN_EVENTS = 100000;
+
+/**
+ * Whether a list of events should be sorted with the radix sort. This is
+ * selected with the EventList.SortAlgorithm key of the ConfigService and only
+ * applies to large lists.
+ * @param numEvents :: the number of events to sort
+ * @return true to use the radix sort
+ */
+bool useRadixSort(const size_t numEvents) {
+  if (numEvents < RADIX_SORT_MIN_EVENTS)
+    return false;
+  return boost::iequals(Kernel::ConfigService::Instance().getString(
+                            "EventList.SortAlgorithm"),
+                        "Radix");
+}
+
+/// Radix sort key of the time-of-flight of an event
+template <class T> uint64_t tofKey(const T &event) {
+  return Kernel::radixSortKey(event.tof());
+}
+
+/// Radix sort key of the pulse time of an event
+template <class T> uint64_t pulseTimeKey(const T &event) {
+  return Kernel::radixSortKey(event.pulseTime().totalNanoseconds());
+}
+
+/** Sort events by TOF with the configured algorithm.
+ * @param events :: the events to sort
+ */
+template <class T> void sortEventsByTof(std::vector<T> &events) {
+  if (useRadixSort(events.size()))
+    Kernel::radixSort(events, tofKey<T>);
+  else
+    tbb::parallel_sort(events.begin(), events.end());
+}
+
+/** Sort events by pulse time with the configured algorithm.
+ * @param events :: the events to sort
+ */
+template <class T> void sortEventsByPulseTime(std::vector<T> &events) {
+  if (useRadixSort(events.size()))
+    Kernel::radixSort(events, pulseTimeKey<T>);
+  else
+    tbb::parallel_sort(events.begin(), events.end(), compareEventPulseTime);
+}
+
+/** Sort events by pulse time, then TOF, with the configured algorithm.
+ * @param events :: the events to sort
+ */
+template <class T> void sortEventsByPulseTimeTOF(std::vector<T> &events) {
+  if (useRadixSort(events.size())) {
+    // The radix sort is stable: sort by the minor key first
+    Kernel::radixSort(events, tofKey<T>);
+    Kernel::radixSort(events, pulseTimeKey<T>);
+  } else {
+    tbb::parallel_sort(events.begin(), events.end(), compareEventPulseTimeTOF);
+  }
+}
+} // namespace
+
 /// Constructor (empty)
 // EventWorkspace is always histogram data and so is thus EventList
 EventList::EventList()
     : m_histogram(HistogramData::Histogram::XMode::BinEdges,
                   HistogramData::Histogram::YMode::Counts),
-      eventType(TOF), order(UNSORTED), mru(nullptr) {}
+      eventType(TOF), order(UNSORTED), m_histogramCache(nullptr) {}
 
-/** Constructor with a MRU list
- * @param mru :: pointer to the MRU of the parent EventWorkspace
+/** Constructor with a histogram cache
+ * @param histogramCache :: pointer to the histogram cache of the parent
+ * EventWorkspace
  * @param specNo :: the spectrum number for the event list
  */
-EventList::EventList(EventWorkspaceMRU *mru, specnum_t specNo)
+EventList::EventList(EventHistogramCache *histogramCache, specnum_t specNo)
     : IEventList(specNo), m_histogram(HistogramData::Histogram::XMode::BinEdges,
                                       HistogramData::Histogram::YMode::Counts),
-      eventType(TOF), order(UNSORTED), mru(mru) {}
+      eventType(TOF), order(UNSORTED), m_histogramCache(histogramCache),
+      m_cacheGeneration(EventHistogramCache::newGeneration()) {}
 
 /** Constructor copying from an existing event list
  * @param rhs :: EventList object to copy*/
 EventList::EventList(const EventList &rhs)
-    : IEventList(rhs), m_histogram(rhs.m_histogram), mru{nullptr} {
+    : IEventList(rhs), m_histogram(rhs.m_histogram),
+      m_histogramCache{nullptr} {
   // Note that operator= also assigns m_histogram, but the above use of the copy
   // constructor avoid a memory allocation and is thus faster.
   this->operator=(rhs);
@@ -179,7 +250,7 @@ EventList::EventList(const EventList &rhs)
 EventList::EventList(const std::vector<TofEvent> &events)
     : m_histogram(HistogramData::Histogram::XMode::BinEdges,
                   HistogramData::Histogram::YMode::Counts),
-      eventType(TOF), mru(nullptr) {
+      eventType(TOF), m_histogramCache(nullptr) {
   this->events.assign(events.begin(), events.end());
   this->eventType = TOF;
   this->order = UNSORTED;
@@ -190,7 +261,7 @@ EventList::EventList(const std::vector<TofEvent> &events)
 EventList::EventList(const std::vector<WeightedEvent> &events)
     : m_histogram(HistogramData::Histogram::XMode::BinEdges,
                   HistogramData::Histogram::YMode::Counts),
-      mru(nullptr) {
+      m_histogramCache(nullptr) {
   this->weightedEvents.assign(events.begin(), events.end());
   this->eventType = WEIGHTED;
   this->order = UNSORTED;
@@ -201,7 +272,7 @@ EventList::EventList(const std::vector<WeightedEvent> &events)
 EventList::EventList(const std::vector<WeightedEventNoTime> &events)
     : m_histogram(HistogramData::Histogram::XMode::BinEdges,
                   HistogramData::Histogram::YMode::Counts),
-      mru(nullptr) {
+      m_histogramCache(nullptr) {
   this->weightedEventsNoTime.assign(events.begin(), events.end());
   this->eventType = WEIGHTED_NOTIME;
   this->order = UNSORTED;
@@ -214,6 +285,8 @@ EventList::~EventList() {
   //  EventWorkspaces.
   //  Therefore, for performance, they are kept commented:
   clear();
+  if (m_histogramCache)
+    m_histogramCache->erase(this);
 
   // this->events.clear();
   // std::vector<TofEvent>().swap(events); //Trick to release the vector memory.
@@ -226,10 +299,14 @@ void EventList::copyDataFrom(const ISpectrum &source) {
 
 /// Used by copyDataFrom for dynamic dispatch for its `source`.
 void EventList::copyDataInto(EventList &sink) const {
+  sink.invalidateHistogramCache();
   sink.m_histogram = m_histogram;
   sink.events = events;
   sink.weightedEvents = weightedEvents;
   sink.weightedEventsNoTime = weightedEventsNoTime;
+  sink.m_columns = m_columns;
+  sink.m_compact = m_compact;
+  sink.m_layout = m_layout.load();
   sink.eventType = eventType;
   sink.order = order;
 }
@@ -334,12 +411,16 @@ void EventList::createFromHistogram(const ISpectrum *inSpec, bool GenerateZeros,
  * @return reference to this
  * */
 EventList &EventList::operator=(const EventList &rhs) {
-  // Note that we are NOT copying the MRU pointer.
+  // Note that we are NOT copying the histogram cache pointer.
   IEventList::operator=(rhs);
+  invalidateHistogramCache();
   m_histogram = rhs.m_histogram;
   events = rhs.events;
   weightedEvents = rhs.weightedEvents;
   weightedEventsNoTime = rhs.weightedEventsNoTime;
+  m_columns = rhs.m_columns;
+  m_compact = rhs.m_compact;
+  m_layout = rhs.m_layout.load();
   eventType = rhs.eventType;
   order = rhs.order;
   return *this;
@@ -351,6 +432,7 @@ EventList &EventList::operator=(const EventList &rhs) {
  * @return reference to this
  * */
 EventList &EventList::operator+=(const TofEvent &event) {
+  ensureRowLayout();
 
   switch (this->eventType) {
   case TOF:
@@ -379,6 +461,7 @@ EventList &EventList::operator+=(const TofEvent &event) {
  * @return reference to this
  * */
 EventList &EventList::operator+=(const std::vector<TofEvent> &more_events) {
+  ensureRowLayout();
   switch (this->eventType) {
   case TOF:
     // Simply push the events
@@ -419,6 +502,7 @@ EventList &EventList::operator+=(const std::vector<TofEvent> &more_events) {
  * @return reference to this
  * */
 EventList &EventList::operator+=(const WeightedEvent &event) {
+  ensureRowLayout();
   this->switchTo(WEIGHTED);
   this->weightedEvents.push_back(event);
   this->order = UNSORTED;
@@ -435,6 +519,7 @@ EventList &EventList::operator+=(const WeightedEvent &event) {
  * */
 EventList &EventList::
 operator+=(const std::vector<WeightedEvent> &more_events) {
+  ensureRowLayout();
   switch (this->eventType) {
   case TOF:
     // Need to switch to weighted
@@ -472,6 +557,7 @@ operator+=(const std::vector<WeightedEvent> &more_events) {
  * */
 EventList &EventList::
 operator+=(const std::vector<WeightedEventNoTime> &more_events) {
+  ensureRowLayout();
   switch (this->eventType) {
   case TOF:
   case WEIGHTED:
@@ -500,6 +586,7 @@ operator+=(const std::vector<WeightedEventNoTime> &more_events) {
  * @return reference to this
  * */
 EventList &EventList::operator+=(const EventList &more_events) {
+  more_events.ensureRowLayout();
   // We'll let the += operator for the given vector of event lists handle it
   switch (more_events.getEventType()) {
   case TOF:
@@ -568,6 +655,9 @@ EventList &EventList::operator-=(const EventList &more_events) {
     return *this;
   }
 
+  ensureRowLayout();
+  more_events.ensureRowLayout();
+
   // We'll let the -= operator for the given vector of event lists handle it
   switch (this->getEventType()) {
   case TOF:
@@ -621,6 +711,8 @@ bool EventList::operator==(const EventList &rhs) const {
     return false;
   if (this->eventType != rhs.eventType)
     return false;
+  ensureRowLayout();
+  rhs.ensureRowLayout();
   // Check all event lists; The empty ones will compare equal
   if (events != rhs.events)
     return false;
@@ -646,6 +738,8 @@ bool EventList::equals(const EventList &rhs, const double tolTof,
     return false;
   if (this->eventType != rhs.eventType)
     return false;
+  ensureRowLayout();
+  rhs.ensureRowLayout();
 
   // loop over the events
   size_t numEvents = this->getNumberEvents();
@@ -689,6 +783,7 @@ EventType EventList::getEventType() const { return eventType; }
  * WEIGHTED_NOTIME)
  */
 void EventList::switchTo(EventType newType) {
+  ensureRowLayout();
   switch (newType) {
   case TOF:
     if (eventType != TOF)
@@ -769,6 +864,114 @@ void EventList::switchToWeightedEventsNoTime() {
   }
 }
 
+// -----------------------------------------------------------------------------------------------
+/** Change the memory layout of the events. The event type, sort order and
+ * the events themselves are unchanged.
+ *
+ * COLUMN_LAYOUT keeps the time-of-flight, pulse time and weights of the events
+ * in separate arrays (see EventColumns). Histogramming, TOF conversion,
+ * masking by TOF and integration then only stream over the TOF column. All
+ * other operations convert the list back to ROW_LAYOUT before running.
+ *
+ * COMPACT_LAYOUT encodes the events losslessly in fewer bytes (see
+ * CompactEvents). Sorting by TOF, histogramming, integration, filtering by
+ * pulse time and TOF or unit conversions work on the encoded events; other
+ * operations convert the list back to ROW_LAYOUT.
+ *
+ * SINGLE_PRECISION_LAYOUT is COMPACT_LAYOUT with the time-of-flight rounded to
+ * single precision, and kept so through conversions. This loses nothing for
+ * times-of-flight read from event NeXus files and about halves the memory of
+ * unweighted events.
+ *
+ * @param layout :: the layout to switch to
+ */
+void EventList::setStorageLayout(const EventStorageLayout layout) {
+  if (layout == m_layout)
+    return;
+  // Always go through the rows when changing between other layouts
+  switchToRowLayout();
+  if (layout == ROW_LAYOUT)
+    return;
+
+  std::lock_guard<std::mutex> _lock(m_sortMutex);
+  if (layout == COMPACT_LAYOUT || layout == SINGLE_PRECISION_LAYOUT) {
+    const bool roundTof = (layout == SINGLE_PRECISION_LAYOUT);
+    switch (eventType) {
+    case TOF:
+      m_compact.assign(events, roundTof);
+      break;
+    case WEIGHTED:
+      m_compact.assign(weightedEvents, roundTof);
+      break;
+    case WEIGHTED_NOTIME:
+      m_compact.assign(weightedEventsNoTime, roundTof);
+      break;
+    }
+  } else {
+    switch (eventType) {
+    case TOF:
+      m_columns.assign(events);
+      break;
+    case WEIGHTED:
+      m_columns.assign(weightedEvents);
+      break;
+    case WEIGHTED_NOTIME:
+      m_columns.assign(weightedEventsNoTime);
+      break;
+    }
+  }
+  m_layout = layout;
+  events.clear();
+  std::vector<TofEvent>().swap(events);
+  weightedEvents.clear();
+  std::vector<WeightedEvent>().swap(weightedEvents);
+  weightedEventsNoTime.clear();
+  std::vector<WeightedEventNoTime>().swap(weightedEventsNoTime);
+}
+
+/** @return the current memory layout of the events */
+EventStorageLayout EventList::getStorageLayout() const { return m_layout; }
+
+/** Move the events from the columns (or compressed columns) back into the
+ * vector matching the event type. Called implicitly by every operation
+ * without a columnar implementation.
+ */
+void EventList::switchToRowLayout() const {
+  // Avoid converting from multiple threads
+  std::lock_guard<std::mutex> _lock(m_sortMutex);
+  if (m_layout == ROW_LAYOUT)
+    return;
+
+  if (hasCompactLayout()) {
+    switch (eventType) {
+    case TOF:
+      m_compact.extract(events);
+      break;
+    case WEIGHTED:
+      m_compact.extract(weightedEvents);
+      break;
+    case WEIGHTED_NOTIME:
+      m_compact.extract(weightedEventsNoTime);
+      break;
+    }
+    m_compact.clear();
+  } else {
+    switch (eventType) {
+    case TOF:
+      m_columns.extract(events);
+      break;
+    case WEIGHTED:
+      m_columns.extract(weightedEvents);
+      break;
+    case WEIGHTED_NOTIME:
+      m_columns.extract(weightedEventsNoTime);
+      break;
+    }
+    m_columns.clear();
+  }
+  m_layout = ROW_LAYOUT;
+}
+
 // ==============================================================================================
 // --- Testing functions (mostly)
 // ---------------------------------------------------------------
@@ -781,6 +984,7 @@ void EventList::switchToWeightedEventsNoTime() {
  * @return a WeightedEvent
  */
 WeightedEvent EventList::getEvent(size_t event_number) {
+  ensureRowLayout();
   switch (eventType) {
   case TOF:
     return WeightedEvent(events[event_number]);
@@ -807,6 +1011,7 @@ WeightedEvent EventList::getEvent(size_t event_number) {
  * @return a const reference to the list of non-weighted events
  * */
 const std::vector<TofEvent> &EventList::getEvents() const {
+  ensureRowLayout();
   if (eventType != TOF)
     throw std::runtime_error("EventList::getEvents() called for an EventList "
                              "that has weights. Use getWeightedEvents() or "
@@ -822,6 +1027,7 @@ const std::vector<TofEvent> &EventList::getEvents() const {
  * @return a reference to the list of non-weighted events
  * */
 std::vector<TofEvent> &EventList::getEvents() {
+  ensureRowLayout();
   if (eventType != TOF)
     throw std::runtime_error("EventList::getEvents() called for an EventList "
                              "that has weights. Use getWeightedEvents() or "
@@ -837,6 +1043,7 @@ std::vector<TofEvent> &EventList::getEvents() {
  * @return a reference to the list of weighted events
  * */
 std::vector<WeightedEvent> &EventList::getWeightedEvents() {
+  ensureRowLayout();
   if (eventType != WEIGHTED)
     throw std::runtime_error("EventList::getWeightedEvents() called for an "
                              "EventList not of type WeightedEvent. Use "
@@ -852,6 +1059,7 @@ std::vector<WeightedEvent> &EventList::getWeightedEvents() {
  * @return a const reference to the list of weighted events
  * */
 const std::vector<WeightedEvent> &EventList::getWeightedEvents() const {
+  ensureRowLayout();
   if (eventType != WEIGHTED)
     throw std::runtime_error("EventList::getWeightedEvents() called for an "
                              "EventList not of type WeightedEvent. Use "
@@ -865,6 +1073,7 @@ const std::vector<WeightedEvent> &EventList::getWeightedEvents() const {
  * @return a reference to the list of weighted events
  * */
 std::vector<WeightedEventNoTime> &EventList::getWeightedEventsNoTime() {
+  ensureRowLayout();
   if (eventType != WEIGHTED_NOTIME)
     throw std::runtime_error("EventList::getWeightedEvents() called for an "
                              "EventList not of type WeightedEventNoTime. Use "
@@ -879,6 +1088,7 @@ std::vector<WeightedEventNoTime> &EventList::getWeightedEventsNoTime() {
  * */
 const std::vector<WeightedEventNoTime> &
 EventList::getWeightedEventsNoTime() const {
+  ensureRowLayout();
   if (eventType != WEIGHTED_NOTIME)
     throw std::runtime_error("EventList::getWeightedEventsNoTime() called for "
                              "an EventList not of type WeightedEventNoTime. "
@@ -890,8 +1100,7 @@ EventList::getWeightedEventsNoTime() const {
  * associated detector ID's.
  * */
 void EventList::clear(const bool removeDetIDs) {
-  if (mru)
-    mru->deleteIndex(this);
+  invalidateHistogramCache();
   this->events.clear();
   std::vector<TofEvent>().swap(this->events); // STL Trick to release memory
   this->weightedEvents.clear();
@@ -900,6 +1109,8 @@ void EventList::clear(const bool removeDetIDs) {
   this->weightedEventsNoTime.clear();
   std::vector<WeightedEventNoTime>().swap(
       this->weightedEventsNoTime); // STL Trick to release memory
+  m_columns.clear();
+  m_compact.clear();
   if (removeDetIDs)
     this->clearDetectorIDs();
 }
@@ -928,11 +1139,24 @@ void EventList::clearUnused() {
 /// Mask the spectrum to this value. Removes all events.
 void EventList::clearData() { this->clear(false); }
 
-/** Sets the MRU list for this event list
+/** Sets the histogram cache for this event list
  *
- * @param newMRU :: new MRU for the workspace containing this EventList
+ * @param histogramCache :: histogram cache of the workspace containing this
+ * EventList
+ */
+void EventList::setHistogramCache(EventHistogramCache *histogramCache) {
+  m_histogramCache = histogramCache;
+  m_cacheGeneration = EventHistogramCache::newGeneration();
+}
+
+/** Make the cached histograms of this list out of date. Only the generation
+ * of the list changes; the cache drops the old histograms when they are
+ * looked up or evicted.
  */
-void EventList::setMRU(EventWorkspaceMRU *newMRU) { mru = newMRU; }
+void EventList::invalidateHistogramCache() {
+  if (m_histogramCache)
+    m_cacheGeneration = EventHistogramCache::newGeneration();
+}
 
 /** Reserve a certain number of entries in the (NOT-WEIGHTED) event list. Do NOT
  *call
@@ -943,7 +1167,10 @@ void EventList::setMRU(EventWorkspaceMRU *newMRU) { mru = newMRU; }
  *
  * @param num :: number of events that will be in this EventList
  */
-void EventList::reserve(size_t num) { this->events.reserve(num); }
+void EventList::reserve(size_t num) {
+  ensureRowLayout();
+  this->events.reserve(num);
+}
 
 // ==============================================================================================
 // --- Sorting functions -----------------------------------------------------
@@ -995,16 +1222,26 @@ void EventList::sortTof() const {
   if (this->order == TOF_SORT)
     return;
 
+  if (m_layout == COLUMN_LAYOUT) {
+    m_columns.sortTof();
+    this->order = TOF_SORT;
+    return;
+  }
+  if (hasCompactLayout()) {
+    m_compact.sortTof();
+    this->order = TOF_SORT;
+    return;
+  }
+
   switch (eventType) {
   case TOF:
-    tbb::parallel_sort(events.begin(), events.end());
+    sortEventsByTof(events);
     break;
   case WEIGHTED:
-    tbb::parallel_sort(weightedEvents.begin(), weightedEvents.end());
+    sortEventsByTof(weightedEvents);
     break;
   case WEIGHTED_NOTIME:
-    tbb::parallel_sort(weightedEventsNoTime.begin(),
-                       weightedEventsNoTime.end());
+    sortEventsByTof(weightedEventsNoTime);
     break;
   }
   // Save the order to avoid unnecessary re-sorting.
@@ -1023,6 +1260,7 @@ void EventList::sortTof() const {
 void EventList::sortTimeAtSample(const double &tofFactor,
                                  const double &tofShift,
                                  bool forceResort) const {
+  ensureRowLayout();
   // Check pre-cached sort flag.
   if (this->order == TIMEATSAMPLE_SORT && !forceResort)
     return;
@@ -1057,6 +1295,7 @@ void EventList::sortTimeAtSample(const double &tofFactor,
 // --------------------------------------------------------------------------
 /** Sort events by Frame */
 void EventList::sortPulseTime() const {
+  ensureRowLayout();
   if (this->order == PULSETIME_SORT)
     return; // nothing to do
 
@@ -1069,11 +1308,10 @@ void EventList::sortPulseTime() const {
   // Perform sort.
   switch (eventType) {
   case TOF:
-    tbb::parallel_sort(events.begin(), events.end(), compareEventPulseTime);
+    sortEventsByPulseTime(events);
     break;
   case WEIGHTED:
-    tbb::parallel_sort(weightedEvents.begin(), weightedEvents.end(),
-                       compareEventPulseTime);
+    sortEventsByPulseTime(weightedEvents);
     break;
   case WEIGHTED_NOTIME:
     // Do nothing; there is no time to sort
@@ -1088,6 +1326,7 @@ void EventList::sortPulseTime() const {
  * (the absolute time)
  */
 void EventList::sortPulseTimeTOF() const {
+  ensureRowLayout();
   if (this->order == PULSETIMETOF_SORT)
     return; // already ordered.
 
@@ -1099,11 +1338,10 @@ void EventList::sortPulseTimeTOF() const {
 
   switch (eventType) {
   case TOF:
-    tbb::parallel_sort(events.begin(), events.end(), compareEventPulseTimeTOF);
+    sortEventsByPulseTimeTOF(events);
     break;
   case WEIGHTED:
-    tbb::parallel_sort(weightedEvents.begin(), weightedEvents.end(),
-                       compareEventPulseTimeTOF);
+    sortEventsByPulseTimeTOF(weightedEvents);
     break;
   case WEIGHTED_NOTIME:
     // Do nothing; there is no time to sort
@@ -1123,6 +1361,7 @@ void EventList::sortPulseTimeTOF() const {
  */
 void EventList::sortPulseTimeTOFDelta(const Types::Core::DateAndTime &start,
                                       const double seconds) const {
+  ensureRowLayout();
   // Avoid sorting from multiple threads
   std::lock_guard<std::mutex> _lock(m_sortMutex);
 
@@ -1165,7 +1404,12 @@ void EventList::reverse() {
   std::reverse(x.begin(), x.end());
 
   // flip the events if they are tof sorted
-  if (this->isSortedByTof()) {
+  if (this->isSortedByTof() && m_layout == COLUMN_LAYOUT) {
+    m_columns.reverse();
+  } else if (this->isSortedByTof() && hasCompactLayout()) {
+    m_compact.reverse();
+  } else if (this->isSortedByTof()) {
+    ensureRowLayout();
     switch (eventType) {
     case TOF:
       std::reverse(this->events.begin(), this->events.end());
@@ -1192,6 +1436,14 @@ void EventList::reverse() {
  * @return the number of events in the list.
  *  */
 size_t EventList::getNumberEvents() const {
+  if (m_layout != ROW_LAYOUT) {
+    // Keep another thread from moving the columns back into rows
+    std::lock_guard<std::mutex> _lock(m_sortMutex);
+    if (m_layout == COLUMN_LAYOUT)
+      return m_columns.size();
+    if (hasCompactLayout())
+      return m_compact.size();
+  }
   switch (eventType) {
   case TOF:
     return this->events.size();
@@ -1207,6 +1459,13 @@ size_t EventList::getNumberEvents() const {
  * Much like stl containers, returns true if there is nothing in the event list.
  */
 bool EventList::empty() const {
+  if (m_layout != ROW_LAYOUT) {
+    std::lock_guard<std::mutex> _lock(m_sortMutex);
+    if (m_layout == COLUMN_LAYOUT)
+      return m_columns.empty();
+    if (hasCompactLayout())
+      return m_compact.empty();
+  }
   switch (eventType) {
   case TOF:
     return this->events.empty();
@@ -1226,6 +1485,13 @@ bool EventList::empty() const {
  * @return :: the memory used by the EventList, in bytes.
  * */
 size_t EventList::getMemorySize() const {
+  if (m_layout != ROW_LAYOUT) {
+    std::lock_guard<std::mutex> _lock(m_sortMutex);
+    if (m_layout == COLUMN_LAYOUT)
+      return m_columns.getMemorySize() + sizeof(EventList);
+    if (hasCompactLayout())
+      return m_compact.getMemorySize() + sizeof(EventList);
+  }
   switch (eventType) {
   case TOF:
     return this->events.capacity() * sizeof(TofEvent) + sizeof(EventList);
@@ -1261,16 +1527,14 @@ size_t EventList::histogram_size() const {
  */
 void EventList::setX(const Kernel::cow_ptr<HistogramData::HistogramX> &X) {
   m_histogram.setX(X);
-  if (mru)
-    mru->deleteIndex(this);
+  invalidateHistogramCache();
 }
 
 /** Deprecated, use mutableX() instead. Returns a reference to the x data.
  *  @return a reference to the X (bin) vector.
  */
 MantidVec &EventList::dataX() {
-  if (mru)
-    mru->deleteIndex(this);
+  invalidateHistogramCache();
   return m_histogram.dataX();
 }
 
@@ -1355,102 +1619,90 @@ EventList::frequencyStandardDeviations() const {
 }
 
 const HistogramData::HistogramY &EventList::y() const {
-  if (!mru)
-    throw std::runtime_error(
-        "'EventList::y()' called with no MRU set. This is not allowed.");
+  if (!m_histogramCache)
+    throw std::runtime_error("'EventList::y()' called with no histogram cache "
+                             "set. This is not allowed.");
 
   return *sharedY();
 }
 const HistogramData::HistogramE &EventList::e() const {
-  if (!mru)
-    throw std::runtime_error(
-        "'EventList::e()' called with no MRU set. This is not allowed.");
+  if (!m_histogramCache)
+    throw std::runtime_error("'EventList::e()' called with no histogram cache "
+                             "set. This is not allowed.");
 
   return *sharedE();
 }
-Kernel::cow_ptr<HistogramData::HistogramY> EventList::sharedY() const {
-  // This is the thread number from which this function was called.
-  int thread = PARALLEL_THREAD_NUMBER;
 
-  Kernel::cow_ptr<HistogramData::HistogramY> yData(nullptr);
-
-  // Is the data in the mrulist?
-  if (mru) {
-    mru->ensureEnoughBuffersY(thread);
-    yData = mru->findY(thread, this);
-  }
-
-  if (!yData) {
-    MantidVec Y;
-    MantidVec E;
-    this->generateHistogram(readX(), Y, E);
+/** Find the Y and E histograms in the cache of the workspace, or generate
+ * them and add them to the cache.
+ *
+ * @param yData :: the Y histogram returned
+ * @param eData :: the E histogram returned
+ */
+void EventList::findOrGenerateHistogram(
+    Kernel::cow_ptr<HistogramData::HistogramY> &yData,
+    Kernel::cow_ptr<HistogramData::HistogramE> &eData) const {
+  if (m_histogramCache &&
+      m_histogramCache->find(this, m_cacheGeneration, yData, eData))
+    return;
 
-    // Create the MRU object
-    yData = Kernel::make_cow<HistogramData::HistogramY>(std::move(Y));
+  MantidVec Y;
+  MantidVec E;
+  this->generateHistogram(readX(), Y, E);
+  yData = Kernel::make_cow<HistogramData::HistogramY>(std::move(Y));
+  eData = Kernel::make_cow<HistogramData::HistogramE>(std::move(E));
+  if (m_histogramCache)
+    m_histogramCache->insert(this, m_cacheGeneration, yData, eData);
+}
 
-    // Lets save it in the MRU
-    if (mru) {
-      mru->insertY(thread, yData, this);
-      auto eData = Kernel::make_cow<HistogramData::HistogramE>(std::move(E));
-      mru->ensureEnoughBuffersE(thread);
-      mru->insertE(thread, eData, this);
-    }
-  }
+Kernel::cow_ptr<HistogramData::HistogramY> EventList::sharedY() const {
+  Kernel::cow_ptr<HistogramData::HistogramY> yData(nullptr);
+  Kernel::cow_ptr<HistogramData::HistogramE> eData(nullptr);
+  findOrGenerateHistogram(yData, eData);
   return yData;
 }
 Kernel::cow_ptr<HistogramData::HistogramE> EventList::sharedE() const {
-  // This is the thread number from which this function was called.
-  int thread = PARALLEL_THREAD_NUMBER;
-
+  Kernel::cow_ptr<HistogramData::HistogramY> yData(nullptr);
   Kernel::cow_ptr<HistogramData::HistogramE> eData(nullptr);
-
-  // Is the data in the mrulist?
-  if (mru) {
-    mru->ensureEnoughBuffersE(thread);
-    eData = mru->findE(thread, this);
-  }
-
-  if (!eData) {
-    // Now use that to get E -- Y values are generated from another function
-    MantidVec Y_ignored;
-    MantidVec E;
-    this->generateHistogram(readX(), Y_ignored, E);
-    eData = Kernel::make_cow<HistogramData::HistogramE>(std::move(E));
-
-    // Lets save it in the MRU
-    if (mru)
-      mru->insertE(thread, eData, this);
-  }
+  findOrGenerateHistogram(yData, eData);
   return eData;
 }
-/** Look in the MRU to see if the Y histogram has been generated before.
- * If so, return that. If not, calculate, cache and return it.
+/** Look in the histogram cache to see if the Y histogram has been generated
+ * before. If so, return that. If not, calculate, cache and return it.
  *
  * @return reference to the Y vector.
  */
 const MantidVec &EventList::dataY() const {
-  if (!mru)
-    throw std::runtime_error(
-        "'EventList::dataY()' called with no MRU set. This is not allowed.");
+  if (!m_histogramCache)
+    throw std::runtime_error("'EventList::dataY()' called with no histogram "
+                             "cache set. This is not allowed.");
 
-  // WARNING: The Y data of sharedY() is stored in MRU, returning reference fine
-  // as long as it stays there.
-  return sharedY()->rawData();
+  Kernel::cow_ptr<HistogramData::HistogramY> yData(nullptr);
+  Kernel::cow_ptr<HistogramData::HistogramE> eData(nullptr);
+  findOrGenerateHistogram(yData, eData);
+  // Only a reference is returned: keep the histogram alive for this thread
+  // even if another thread evicts it from the cache
+  EventHistogramCache::pin(yData, eData);
+  return yData->rawData();
 }
 
-/** Look in the MRU to see if the E histogram has been generated before.
- * If so, return that. If not, calculate, cache and return it.
+/** Look in the histogram cache to see if the E histogram has been generated
+ * before. If so, return that. If not, calculate, cache and return it.
  *
  * @return reference to the E vector.
  */
 const MantidVec &EventList::dataE() const {
-  if (!mru)
-    throw std::runtime_error(
-        "'EventList::dataE()' called with no MRU set. This is not allowed.");
+  if (!m_histogramCache)
+    throw std::runtime_error("'EventList::dataE()' called with no histogram "
+                             "cache set. This is not allowed.");
 
-  // WARNING: The E data of sharedE() is stored in MRU, returning reference fine
-  // as long as it stays there.
-  return sharedE()->rawData();
+  Kernel::cow_ptr<HistogramData::HistogramY> yData(nullptr);
+  Kernel::cow_ptr<HistogramData::HistogramE> eData(nullptr);
+  findOrGenerateHistogram(yData, eData);
+  // Only a reference is returned: keep the histogram alive for this thread
+  // even if another thread evicts it from the cache
+  EventHistogramCache::pin(yData, eData);
+  return eData->rawData();
 }
 
 namespace {
@@ -1753,6 +2005,8 @@ inline void EventList::compressFatEventsHelper(
  *be == this.
  */
 void EventList::compressEvents(double tolerance, EventList *destination) {
+  ensureRowLayout();
+  destination->ensureRowLayout();
   if (!this->empty()) {
     this->sortTof();
     switch (eventType) {
@@ -1809,6 +2063,8 @@ void EventList::compressEvents(double tolerance, EventList *destination) {
 void EventList::compressFatEvents(
     const double tolerance, const Mantid::Types::Core::DateAndTime &timeStart,
     const double seconds, EventList *destination) {
+  ensureRowLayout();
+  destination->ensureRowLayout();
 
   // only worry about non-empty EventLists
   if (!this->empty()) {
@@ -1977,8 +2233,11 @@ void EventList::histogramForWeightsHelper(const std::vector<T> &events,
   //---------------------- Histogram without weights
   //---------------------------------
 
-  // Do we even have any events to do?
-  if (!events.empty()) {
+  const auto &histogrammer = EventHistogrammer::forEdges(X);
+  if (histogrammer.isRegular()) {
+    // Linear or logarithmic bins: compute the bin of each event directly
+    histogrammer.sumWeights(events, Y, E);
+  } else if (!events.empty()) {
     // Iterate through all events (sorted by tof)
     auto itev = findFirstEvent(events, T(X[0]));
     auto itev_end = events.cend();
@@ -2043,6 +2302,7 @@ void EventList::histogramForWeightsHelper(const std::vector<T> &events,
  */
 void EventList::generateHistogramPulseTime(const MantidVec &X, MantidVec &Y,
                                            MantidVec &E, bool skipError) const {
+  ensureRowLayout();
   // All types of weights need to be sorted by Pulse Time
   this->sortPulseTime();
 
@@ -2080,6 +2340,7 @@ void EventList::generateHistogramTimeAtSample(const MantidVec &X, MantidVec &Y,
                                               const double &tofFactor,
                                               const double &tofOffset,
                                               bool skipError) const {
+  ensureRowLayout();
   // All types of weights need to be sorted by time at sample
   this->sortTimeAtSample(tofFactor, tofOffset);
 
@@ -2117,6 +2378,20 @@ void EventList::generateHistogram(const MantidVec &X, MantidVec &Y,
 
   this->sortTof();
 
+  if (m_layout != ROW_LAYOUT) {
+    // The columns are read under the lock: a const accessor on another
+    // thread may move them back into rows (and free them) at any time.
+    std::lock_guard<std::mutex> _lock(m_sortMutex);
+    if (m_layout == COLUMN_LAYOUT) {
+      m_columns.histogram(X, Y, E);
+      return;
+    }
+    if (hasCompactLayout()) {
+      m_compact.histogram(X, Y, E);
+      return;
+    }
+  }
+
   switch (eventType) {
   case TOF:
     // Make the single ones
@@ -2144,6 +2419,7 @@ void EventList::generateHistogram(const MantidVec &X, MantidVec &Y,
  */
 void EventList::generateCountsHistogramPulseTime(const MantidVec &X,
                                                  MantidVec &Y) const {
+  ensureRowLayout();
   // For slight speed=up.
   size_t x_size = X.size();
 
@@ -2223,6 +2499,7 @@ void EventList::generateCountsHistogramPulseTime(const double &xMin,
                                                  MantidVec &Y,
                                                  const double TOF_min,
                                                  const double TOF_max) const {
+  ensureRowLayout();
 
   if (this->events.empty())
     return;
@@ -2258,6 +2535,7 @@ void EventList::generateCountsHistogramPulseTime(const double &xMin,
 void EventList::generateCountsHistogramTimeAtSample(
     const MantidVec &X, MantidVec &Y, const double &tofFactor,
     const double &tofOffset) const {
+  ensureRowLayout();
   // For slight speed=up.
   const size_t x_size = X.size();
 
@@ -2344,8 +2622,11 @@ void EventList::generateCountsHistogram(const MantidVec &X,
   //---------------------- Histogram without weights
   //---------------------------------
 
-  // Do we even have any events to do?
-  if (!this->events.empty()) {
+  const auto &histogrammer = EventHistogrammer::forEdges(X);
+  if (histogrammer.isRegular()) {
+    // Linear or logarithmic bins: compute the bin of each event directly
+    histogrammer.countEvents(this->events, Y);
+  } else if (!this->events.empty()) {
     // Iterate through all events (sorted by tof) placing them in the correct
     // bin.
     auto itev = findFirstEvent(this->events, TofEvent(X[0]));
@@ -2483,6 +2764,19 @@ void EventList::integrate(const double minX, const double maxX,
     this->sortTof();
   }
 
+  if (m_layout != ROW_LAYOUT) {
+    // See generateHistogram: the columns may be freed without the lock
+    std::lock_guard<std::mutex> _lock(m_sortMutex);
+    if (m_layout == COLUMN_LAYOUT) {
+      m_columns.integrate(minX, maxX, entireRange, sum, error);
+      return;
+    }
+    if (hasCompactLayout()) {
+      m_compact.integrate(minX, maxX, entireRange, sum, error);
+      return;
+    }
+  }
+
   // Convert the list
   switch (eventType) {
   case TOF:
@@ -2527,6 +2821,16 @@ void EventList::convertTof(std::function<double(double)> func,
   if (this->getNumberEvents() <= 0)
     return;
 
+  if (m_layout == COLUMN_LAYOUT) {
+    m_columns.convertTof(func);
+    return;
+  }
+  if (hasCompactLayout()) {
+    m_compact.convertTof(func);
+    return;
+  }
+  ensureRowLayout();
+
   // Convert the list
   switch (eventType) {
   case TOF:
@@ -2571,6 +2875,16 @@ void EventList::convertTof(const double factor, const double offset) {
   if (this->getNumberEvents() <= 0)
     return;
 
+  if (m_layout == COLUMN_LAYOUT) {
+    m_columns.convertTof(factor, offset);
+    return;
+  }
+  if (hasCompactLayout()) {
+    m_compact.convertTof(factor, offset);
+    return;
+  }
+  ensureRowLayout();
+
   // Convert the list
   switch (eventType) {
   case TOF:
@@ -2640,6 +2954,7 @@ void EventList::addPulsetimeHelper(std::vector<T> &events,
  * @param seconds :: The value to shift the pulsetime by, in seconds
  */
 void EventList::addPulsetime(const double seconds) {
+  ensureRowLayout();
   if (this->getNumberEvents() <= 0)
     return;
 
@@ -2720,6 +3035,14 @@ void EventList::maskTof(const double tofMin, const double tofMax) {
   // Convert the list
   size_t numOrig = 0;
   size_t numDel = 0;
+  if (m_layout == COLUMN_LAYOUT) {
+    numOrig = m_columns.size();
+    numDel = m_columns.maskTof(tofMin, tofMax);
+    if (numDel >= numOrig)
+      this->clear(false);
+    return;
+  }
+  ensureRowLayout();
   switch (eventType) {
   case TOF:
     numOrig = this->events.size();
@@ -2777,6 +3100,7 @@ std::size_t EventList::maskConditionHelper(std::vector<T> &events,
  * @param mask :: condition vector
  */
 void EventList::maskCondition(const std::vector<bool> &mask) {
+  ensureRowLayout();
 
   // mask size must match the number of events
   if (this->getNumberEvents() != mask.size())
@@ -2829,6 +3153,20 @@ void EventList::getTofs(std::vector<double> &tofs) const {
   // Set the capacity of the vector to avoid multiple resizes
   tofs.reserve(this->getNumberEvents());
 
+  if (m_layout != ROW_LAYOUT) {
+    std::lock_guard<std::mutex> _lock(m_sortMutex);
+    if (m_layout == COLUMN_LAYOUT) {
+      tofs.assign(m_columns.tofs().cbegin(), m_columns.tofs().cend());
+      return;
+    }
+    if (hasCompactLayout()) {
+      tofs.clear();
+      for (size_t i = 0; i < m_compact.size(); ++i)
+        tofs.push_back(m_compact.tof(i));
+      return;
+    }
+  }
+
   // Convert the list
   switch (eventType) {
   case TOF:
@@ -2872,6 +3210,7 @@ void EventList::getWeightsHelper(const std::vector<T> &events,
  *  @param weights :: A reference to the vector to be filled
  */
 void EventList::getWeights(std::vector<double> &weights) const {
+  ensureRowLayout();
   // Set the capacity of the vector to avoid multiple resizes
   weights.reserve(this->getNumberEvents());
 
@@ -2920,6 +3259,7 @@ void EventList::getWeightErrorsHelper(const std::vector<T> &events,
  *  @param weightErrors :: A reference to the vector to be filled
  */
 void EventList::getWeightErrors(std::vector<double> &weightErrors) const {
+  ensureRowLayout();
   // Set the capacity of the vector to avoid multiple resizes
   weightErrors.reserve(this->getNumberEvents());
 
@@ -2969,6 +3309,7 @@ void EventList::getPulseTimesHelper(
  * @return by copy a vector of DateAndTime times
  */
 std::vector<Mantid::Types::Core::DateAndTime> EventList::getPulseTimes() const {
+  ensureRowLayout();
   std::vector<Mantid::Types::Core::DateAndTime> times;
   // Set the capacity of the vector to avoid multiple resizes
   times.reserve(this->getNumberEvents());
@@ -3000,6 +3341,18 @@ double EventList::getTofMin() const {
   if (this->empty())
     return tMin;
 
+  if (m_layout != ROW_LAYOUT) {
+    std::lock_guard<std::mutex> _lock(m_sortMutex);
+    if (m_layout == COLUMN_LAYOUT) {
+      const auto &tofs = m_columns.tofs();
+      if (this->order == TOF_SORT)
+        return tofs.front();
+      return *std::min_element(tofs.cbegin(), tofs.cend());
+    }
+    if (hasCompactLayout())
+      return m_compact.getTofMin();
+  }
+
   // when events are ordered by tof just need the first value
   if (this->order == TOF_SORT) {
     switch (eventType) {
@@ -3044,6 +3397,18 @@ double EventList::getTofMax() const {
   if (this->empty())
     return tMax;
 
+  if (m_layout != ROW_LAYOUT) {
+    std::lock_guard<std::mutex> _lock(m_sortMutex);
+    if (m_layout == COLUMN_LAYOUT) {
+      const auto &tofs = m_columns.tofs();
+      if (this->order == TOF_SORT)
+        return tofs.back();
+      return *std::max_element(tofs.cbegin(), tofs.cend());
+    }
+    if (hasCompactLayout())
+      return m_compact.getTofMax();
+  }
+
   // when events are ordered by tof just need the first value
   if (this->order == TOF_SORT) {
     switch (eventType) {
@@ -3082,6 +3447,13 @@ double EventList::getTofMax() const {
  * @return The minimum tof value for the list of the events.
  */
 DateAndTime EventList::getPulseTimeMin() const {
+  if (hasCompactLayout()) {
+    std::lock_guard<std::mutex> _lock(m_sortMutex);
+    if (hasCompactLayout() && m_compact.hasPulseTimes())
+      return m_compact.empty() ? DateAndTime::maximum()
+                               : DateAndTime(m_compact.getPulseTimeMin());
+  }
+  ensureRowLayout();
   // set up as the maximum available date time.
   DateAndTime tMin = DateAndTime::maximum();
 
@@ -3126,6 +3498,13 @@ DateAndTime EventList::getPulseTimeMin() const {
  * @return The maximum tof value for the list of events.
  */
 DateAndTime EventList::getPulseTimeMax() const {
+  if (hasCompactLayout()) {
+    std::lock_guard<std::mutex> _lock(m_sortMutex);
+    if (hasCompactLayout() && m_compact.hasPulseTimes())
+      return m_compact.empty() ? DateAndTime::minimum()
+                               : DateAndTime(m_compact.getPulseTimeMax());
+  }
+  ensureRowLayout();
   // set up as the minimum available date time.
   DateAndTime tMax = DateAndTime::minimum();
 
@@ -3169,6 +3548,7 @@ DateAndTime EventList::getPulseTimeMax() const {
 void EventList::getPulseTimeMinMax(
     Mantid::Types::Core::DateAndTime &tMin,
     Mantid::Types::Core::DateAndTime &tMax) const {
+  ensureRowLayout();
   // set up as the minimum available date time.
   tMax = DateAndTime::minimum();
   tMin = DateAndTime::maximum();
@@ -3219,6 +3599,7 @@ void EventList::getPulseTimeMinMax(
 
 DateAndTime EventList::getTimeAtSampleMax(const double &tofFactor,
                                           const double &tofOffset) const {
+  ensureRowLayout();
   // set up as the minimum available date time.
   DateAndTime tMax = DateAndTime::minimum();
 
@@ -3266,6 +3647,7 @@ DateAndTime EventList::getTimeAtSampleMax(const double &tofFactor,
 
 DateAndTime EventList::getTimeAtSampleMin(const double &tofFactor,
                                           const double &tofOffset) const {
+  ensureRowLayout();
   // set up as the minimum available date time.
   DateAndTime tMin = DateAndTime::maximum();
 
@@ -3338,6 +3720,7 @@ void EventList::setTofsHelper(std::vector<T> &events,
  * @param tofs :: The vector of doubles to set the tofs to.
  */
 void EventList::setTofs(const MantidVec &tofs) {
+  ensureRowLayout();
   this->order = UNSORTED;
 
   // Convert the list
@@ -3440,6 +3823,7 @@ EventList &EventList::operator*=(const double value) {
  * @param error: error on 'value'. Can be 0.
  */
 void EventList::multiply(const double value, const double error) {
+  ensureRowLayout();
   // Do nothing if multiplying by exactly one and there is no error
   if ((value == 1.0) && (error == 0.0))
     return;
@@ -3568,6 +3952,7 @@ void EventList::multiplyHistogramHelper(std::vector<T> &events,
  */
 void EventList::multiply(const MantidVec &X, const MantidVec &Y,
                          const MantidVec &E) {
+  ensureRowLayout();
   switch (eventType) {
   case TOF:
     // Switch to weights if needed.
@@ -3708,6 +4093,7 @@ void EventList::divideHistogramHelper(std::vector<T> &events,
  */
 void EventList::divide(const MantidVec &X, const MantidVec &Y,
                        const MantidVec &E) {
+  ensureRowLayout();
   switch (eventType) {
   case TOF:
     // Switch to weights if needed.
@@ -3756,6 +4142,7 @@ EventList &EventList::operator/=(const double value) {
  * @throw std::invalid_argument if value == 0; cannot divide by zero.
  */
 void EventList::divide(const double value, const double error) {
+  ensureRowLayout();
   if (value == 0.0)
     throw std::invalid_argument(
         "EventList::divide() called with value of 0.0. Cannot divide by zero.");
@@ -3845,6 +4232,28 @@ void EventList::filterByPulseTime(DateAndTime start, DateAndTime stop,
     throw std::invalid_argument("In-place filtering is not allowed");
   }
 
+  std::unique_lock<std::mutex> lock(m_sortMutex);
+  if (hasCompactLayout() && eventType != WEIGHTED_NOTIME) {
+    // Select on the pulse time indices without decoding the whole list
+    output.clear();
+    output.switchTo(eventType);
+    output.setDetectorIDs(this->getDetectorIDs());
+    output.setHistogram(m_histogram);
+    if (eventType == TOF)
+      m_compact.filterByPulseTime(start.totalNanoseconds(),
+                                  stop.totalNanoseconds(), output.events);
+    else
+      m_compact.filterByPulseTime(start.totalNanoseconds(),
+                                  stop.totalNanoseconds(),
+                                  output.weightedEvents);
+    lock.unlock();
+    output.setSortOrder(UNSORTED);
+    output.sortPulseTime();
+    return;
+  }
+  lock.unlock();
+  ensureRowLayout();
+
   // Start by sorting the event list by pulse time.
   this->sortPulseTime();
   // Clear the output
@@ -3875,6 +4284,7 @@ void EventList::filterByTimeAtSample(Types::Core::DateAndTime start,
                                      Types::Core::DateAndTime stop,
                                      double tofFactor, double tofOffset,
                                      EventList &output) const {
+  ensureRowLayout();
   if (this == &output) {
     throw std::invalid_argument("In-place filtering is not allowed");
   }
@@ -3990,6 +4400,7 @@ void EventList::filterInPlaceHelper(Kernel::TimeSplitterType &splitter,
  *     that will be kept. Any other events will be deleted.
  */
 void EventList::filterInPlace(Kernel::TimeSplitterType &splitter) {
+  ensureRowLayout();
   // Start by sorting the event list by pulse time.
   this->sortPulseTime();
 
@@ -4081,6 +4492,7 @@ void EventList::splitByTimeHelper(Kernel::TimeSplitterType &splitter,
  */
 void EventList::splitByTime(Kernel::TimeSplitterType &splitter,
                             std::vector<EventList *> outputs) const {
+  ensureRowLayout();
   if (eventType == WEIGHTED_NOTIME)
     throw std::runtime_error("EventList::splitByTime() called on an EventList "
                              "that no longer has time information.");
@@ -4218,6 +4630,7 @@ void EventList::splitByFullTime(Kernel::TimeSplitterType &splitter,
                                 std::map<int, EventList *> outputs,
                                 bool docorrection, double toffactor,
                                 double tofshift) const {
+  ensureRowLayout();
   if (eventType == WEIGHTED_NOTIME)
     throw std::runtime_error("EventList::splitByTime() called on an EventList "
                              "that no longer has time information.");
@@ -4449,6 +4862,7 @@ std::string EventList::splitByFullTimeMatrixSplitter(
     const std::vector<int> &vecgroups,
     std::map<int, EventList *> vec_outputEventList, bool docorrection,
     double toffactor, double tofshift) const {
+  ensureRowLayout();
   // Check validity
   if (eventType == WEIGHTED_NOTIME)
     throw std::runtime_error("EventList::splitByTime() called on an EventList "
@@ -4582,6 +4996,7 @@ void EventList::splitByPulseTimeHelper(Kernel::TimeSplitterType &splitter,
  */
 void EventList::splitByPulseTime(Kernel::TimeSplitterType &splitter,
                                  std::map<int, EventList *> outputs) const {
+  ensureRowLayout();
   // Check for supported event type
   if (eventType == WEIGHTED_NOTIME)
     throw std::runtime_error("EventList::splitByTime() called on an EventList "
@@ -4627,6 +5042,7 @@ void EventList::splitByPulseTime(Kernel::TimeSplitterType &splitter,
 void EventList::splitByPulseTimeWithMatrix(
     const std::vector<int64_t> &vec_times, const std::vector<int> &vec_target,
     std::map<int, EventList *> outputs) const {
+  ensureRowLayout();
   // Check for supported event type
   if (eventType == WEIGHTED_NOTIME)
     throw std::runtime_error("EventList::splitByTime() called on an EventList "
@@ -4667,6 +5083,59 @@ void EventList::splitByPulseTimeWithMatrix(
   }
 }
 
+//----------------------------------------------------------------------------------------------
+/** Split the event list with a splitter whose intervals were indexed once,
+ * e.g. for all the spectra of a workspace. Each output receives the events of
+ * one target in a single allocation, sorted like the input.
+ *
+ * @param splitter :: the splitting intervals
+ * @param outputs :: the output of each target, in the order of
+ * splitter.targets(). Events of targets without output are dropped.
+ * @param eventTime :: how the time of the events is compared to the intervals
+ */
+void EventList::splitByIndex(const EventSplitter &splitter,
+                             const std::vector<EventList *> &outputs,
+                             const EventSplitter::EventTime &eventTime) const {
+  ensureRowLayout();
+  if (eventType == WEIGHTED_NOTIME)
+    throw std::runtime_error("EventList::splitByIndex() called on an EventList "
+                             "that no longer has time information.");
+  if (outputs.size() != splitter.numberOfTargets())
+    throw std::invalid_argument("EventList::splitByIndex() needs one output "
+                                "per target of the splitter.");
+
+  // Events sorted by pulse time keep the splitter close to the last interval
+  sortPulseTimeTOF();
+
+  for (auto output : outputs) {
+    if (!output)
+      continue;
+    output->clear();
+    output->setDetectorIDs(this->getDetectorIDs());
+    output->setHistogram(m_histogram);
+    output->switchTo(eventType);
+  }
+
+  if (eventType == TOF) {
+    std::vector<std::vector<TofEvent> *> destinations(outputs.size(), nullptr);
+    for (size_t slot = 0; slot < outputs.size(); ++slot)
+      if (outputs[slot])
+        destinations[slot] = &outputs[slot]->events;
+    splitter.split(this->events, eventTime, destinations);
+  } else {
+    std::vector<std::vector<WeightedEvent> *> destinations(outputs.size(),
+                                                           nullptr);
+    for (size_t slot = 0; slot < outputs.size(); ++slot)
+      if (outputs[slot])
+        destinations[slot] = &outputs[slot]->weightedEvents;
+    splitter.split(this->weightedEvents, eventTime, destinations);
+  }
+
+  for (auto output : outputs)
+    if (output)
+      output->order = this->order;
+}
+
 template <class T>
 void EventList::splitByPulseTimeWithMatrixHelper(
     const std::vector<int64_t> &vec_split_times,
@@ -4817,6 +5286,14 @@ void EventList::convertUnitsViaTof(Mantid::Kernel::Unit *fromUnit,
     throw std::runtime_error(
         "EventList::convertUnitsViaTof(): toUnit is not initialized!");
 
+  if (hasCompactLayout()) {
+    m_compact.convertTof([fromUnit, toUnit](const double x) {
+      return toUnit->singleFromTOF(fromUnit->singleToTOF(x));
+    });
+    return;
+  }
+  ensureRowLayout();
+
   switch (eventType) {
   case TOF:
     convertUnitsViaTofHelper(this->events, fromUnit, toUnit);
@@ -4854,6 +5331,13 @@ void EventList::convertUnitsQuicklyHelper(typename std::vector<T> &events,
  *  @param power :: the Power b to apply to the conversion
  */
 void EventList::convertUnitsQuickly(const double &factor, const double &power) {
+  if (hasCompactLayout()) {
+    m_compact.convertTof([factor, power](const double x) {
+      return factor * std::pow(x, power);
+    });
+    return;
+  }
+  ensureRowLayout();
   switch (eventType) {
   case TOF:
     convertUnitsQuicklyHelper(this->events, factor, power);
@@ -4868,8 +5352,7 @@ void EventList::convertUnitsQuickly(const double &factor, const double &power) {
 }
 
 HistogramData::Histogram &EventList::mutableHistogramRef() {
-  if (mru)
-    mru->deleteIndex(this);
+  invalidateHistogramCache();
   return m_histogram;
 }
 
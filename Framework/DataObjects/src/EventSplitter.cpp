@@ -0,0 +1,338 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataObjects/EventSplitter.h"
+#include "MantidKernel/MultiThreaded.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using Mantid::Types::Event::TofEvent;
+
+namespace Mantid {
+namespace DataObjects {
+
+namespace {
+/// Do not split lists with fewer events per thread than this
+constexpr size_t MIN_EVENTS_PER_THREAD = 250000;
+
+/// @return the time of an event compared to the interval boundaries
+template <class T>
+inline int64_t timeOf(const T &event,
+                      const EventSplitter::EventTime &eventTime) {
+  const int64_t pulseTime = event.pulseTime().totalNanoseconds();
+  if (eventTime.pulseTimeOnly)
+    return pulseTime;
+  if (eventTime.correctTof)
+    return pulseTime +
+           static_cast<int64_t>(eventTime.tofFactor * event.tof() * 1000 +
+                                eventTime.tofShift * 1.0E9);
+  return pulseTime + static_cast<int64_t>(event.tof() * 1000);
+}
+} // namespace
+
+/** Constructor from interval boundaries
+ * @param times :: boundaries of the intervals, in nanoseconds, sorted. There
+ * must be one more than targets.
+ * @param targets :: target of each interval. If empty, all events go to
+ * target -1.
+ * @throw std::invalid_argument if the sizes do not match or the times are not
+ * sorted
+ */
+EventSplitter::EventSplitter(std::vector<int64_t> times,
+                             const std::vector<int> &targets)
+    : m_times(std::move(times)) {
+  if (targets.empty()) {
+    m_times = {std::numeric_limits<int64_t>::lowest(),
+               std::numeric_limits<int64_t>::max()};
+    index({-1});
+    return;
+  }
+  if (m_times.size() != targets.size() + 1)
+    throw std::invalid_argument(
+        "EventSplitter: there must be one more time than targets");
+  if (!std::is_sorted(m_times.cbegin(), m_times.cend()))
+    throw std::invalid_argument("EventSplitter: the times are not sorted");
+  index(targets);
+}
+
+/** Constructor from splitting intervals, as used by EventList::splitByTime.
+ * Events before the first interval and between intervals go to target -1,
+ * events after the last interval are dropped. Overlapping intervals are
+ * trimmed so that they start at the end of the previous one. Without any
+ * interval, all events go to target -1.
+ * @param splitters :: the intervals, with the target as index
+ */
+EventSplitter::EventSplitter(const Kernel::TimeSplitterType &splitters) {
+  auto sorted = splitters;
+  if (!std::is_sorted(sorted.cbegin(), sorted.cend()))
+    std::sort(sorted.begin(), sorted.end());
+
+  std::vector<int> targets;
+  targets.reserve(2 * sorted.size());
+  m_times.reserve(2 * sorted.size() + 1);
+  m_times.push_back(std::numeric_limits<int64_t>::lowest());
+  for (const auto &splitter : sorted) {
+    const int64_t start =
+        std::max(splitter.start().totalNanoseconds(), m_times.back());
+    const int64_t stop = splitter.stop().totalNanoseconds();
+    if (stop <= start)
+      continue;
+    if (start > m_times.back()) {
+      // Events in the gap are not filtered
+      targets.push_back(-1);
+      m_times.push_back(start);
+    }
+    targets.push_back(splitter.index());
+    m_times.push_back(stop);
+  }
+  if (targets.empty()) {
+    m_times.push_back(std::numeric_limits<int64_t>::max());
+    targets.push_back(-1);
+  }
+  index(targets);
+}
+
+/** Number the targets and store the slot of each interval
+ * @param targets :: target of each interval
+ */
+void EventSplitter::index(const std::vector<int> &targets) {
+  m_targets = targets;
+  std::sort(m_targets.begin(), m_targets.end());
+  m_targets.erase(std::unique(m_targets.begin(), m_targets.end()),
+                  m_targets.end());
+  m_slotOfInterval.resize(targets.size());
+  std::transform(targets.cbegin(), targets.cend(), m_slotOfInterval.begin(),
+                 [this](const int target) { return slotOf(target); });
+}
+
+/** @param target :: a target
+ * @return the slot of the target, or NO_SLOT if it has no interval
+ */
+uint32_t EventSplitter::slotOf(const int target) const {
+  const auto found =
+      std::lower_bound(m_targets.cbegin(), m_targets.cend(), target);
+  if (found == m_targets.cend() || *found != target)
+    return NO_SLOT;
+  return static_cast<uint32_t>(found - m_targets.cbegin());
+}
+
+/** @param time :: a time in nanoseconds
+ * @return the slot of the interval containing the time, or NO_SLOT
+ */
+uint32_t EventSplitter::findSlot(const int64_t time) const {
+  const size_t interval = findInterval(time);
+  return interval < m_slotOfInterval.size() ? m_slotOfInterval[interval]
+                                            : NO_SLOT;
+}
+
+/** @param time :: a time in nanoseconds
+ * @return the interval containing the time, or the number of intervals
+ */
+size_t EventSplitter::findInterval(const int64_t time) const {
+  if (m_times.empty() || time < m_times.front() || time >= m_times.back())
+    return m_slotOfInterval.size();
+  return static_cast<size_t>(
+      std::upper_bound(m_times.cbegin(), m_times.cend(), time) -
+      m_times.cbegin() - 1);
+}
+
+/** @param numEvents :: number of events to split
+ * @return the number of threads to split them with
+ */
+size_t EventSplitter::numberOfThreads(const size_t numEvents) const {
+  size_t numThreads = 1;
+  if (PARALLEL_NUMBER_OF_THREADS == 1)
+    numThreads = std::min(static_cast<size_t>(PARALLEL_GET_MAX_THREADS),
+                          numEvents / MIN_EVENTS_PER_THREAD);
+  return std::max(numThreads, size_t(1));
+}
+
+/** Split events into one vector per slot. Each output is replaced by its
+ * events, in their original order, and allocated at its exact size.
+ * @param events :: the events, preferably sorted by pulse time
+ * @param eventTime :: how the time of the events is computed
+ * @param outputs :: one vector per slot; the events of slots without output
+ * are dropped
+ */
+template <class T>
+void EventSplitter::split(const std::vector<T> &events,
+                          const EventTime &eventTime,
+                          const std::vector<std::vector<T> *> &outputs) const {
+  if (outputs.size() != m_targets.size())
+    throw std::invalid_argument(
+        "EventSplitter: there must be one output per target");
+  const size_t numThreads = numberOfThreads(events.size());
+  std::vector<uint32_t> slots;
+  std::vector<std::vector<size_t>> counts;
+  assignSlots(events, eventTime, numThreads, slots, counts);
+
+  // Each thread writes its events after those of the previous threads
+  std::vector<T *> destinations(m_targets.size(), nullptr);
+  for (size_t slot = 0; slot < m_targets.size(); ++slot) {
+    size_t position = 0;
+    for (auto &threadCounts : counts) {
+      const size_t count = threadCounts[slot];
+      threadCounts[slot] = position;
+      position += count;
+    }
+    if (outputs[slot]) {
+      outputs[slot]->clear();
+      outputs[slot]->resize(position);
+      destinations[slot] = outputs[slot]->data();
+    }
+  }
+  scatter(events, slots, numThreads, counts, destinations);
+}
+
+/** Split events into a single vector where the events of each slot follow
+ * each other, in their original order.
+ * @param events :: the events, preferably sorted by pulse time
+ * @param eventTime :: how the time of the events is computed
+ * @param grouped :: set to the events grouped by slot; events outside all
+ * intervals are not included
+ * @param offsets :: set to the position of the events of each slot in
+ * grouped, with a last entry giving its size, so that the events of a slot
+ * are [offsets[slot], offsets[slot + 1])
+ */
+template <class T>
+void EventSplitter::partition(const std::vector<T> &events,
+                              const EventTime &eventTime,
+                              std::vector<T> &grouped,
+                              std::vector<size_t> &offsets) const {
+  const size_t numThreads = numberOfThreads(events.size());
+  std::vector<uint32_t> slots;
+  std::vector<std::vector<size_t>> counts;
+  assignSlots(events, eventTime, numThreads, slots, counts);
+
+  offsets.assign(m_targets.size() + 1, 0);
+  size_t position = 0;
+  for (size_t slot = 0; slot < m_targets.size(); ++slot) {
+    offsets[slot] = position;
+    for (auto &threadCounts : counts) {
+      const size_t count = threadCounts[slot];
+      threadCounts[slot] = position;
+      position += count;
+    }
+  }
+  offsets.back() = position;
+  grouped.clear();
+  grouped.resize(position);
+  std::vector<T *> destinations(m_targets.size(), grouped.data());
+  scatter(events, slots, numThreads, counts, destinations);
+}
+
+/** Find the slot of every event and count the events of each slot.
+ * @param events :: the events
+ * @param eventTime :: how the time of the events is computed
+ * @param numBlocks :: number of blocks the events are split into
+ * @param slots :: set to the slot of each event
+ * @param counts :: set to the number of events of each slot, per block
+ */
+template <class T>
+void EventSplitter::assignSlots(const std::vector<T> &events,
+                                const EventTime &eventTime,
+                                const size_t numBlocks,
+                                std::vector<uint32_t> &slots,
+                                std::vector<std::vector<size_t>> &counts) const {
+  const size_t numEvents = events.size();
+  const size_t numIntervals = m_slotOfInterval.size();
+  slots.resize(numEvents);
+  counts.assign(numBlocks, std::vector<size_t>(m_targets.size(), 0));
+
+  auto assignBlock = [&](const size_t block) {
+    const size_t first = numEvents * block / numBlocks;
+    const size_t last = numEvents * (block + 1) / numBlocks;
+    auto &blockCounts = counts[block];
+    // The previous interval, which usually contains the next event too
+    size_t cursor = numIntervals;
+    for (size_t i = first; i < last; ++i) {
+      const int64_t time = timeOf(events[i], eventTime);
+      size_t interval;
+      if (cursor < numIntervals && time >= m_times[cursor] &&
+          time < m_times[cursor + 1])
+        interval = cursor;
+      else if (cursor + 1 < numIntervals && time >= m_times[cursor + 1] &&
+               time < m_times[cursor + 2])
+        interval = cursor + 1;
+      else
+        interval = findInterval(time);
+
+      if (interval < numIntervals) {
+        cursor = interval;
+        const uint32_t slot = m_slotOfInterval[interval];
+        slots[i] = slot;
+        ++blockCounts[slot];
+      } else {
+        slots[i] = NO_SLOT;
+      }
+    }
+  };
+
+  if (numBlocks == 1) {
+    assignBlock(0);
+    return;
+  }
+  // Every block is processed whatever the number of threads actually given
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int block = 0; block < static_cast<int>(numBlocks); ++block)
+    assignBlock(static_cast<size_t>(block));
+}
+
+/** Copy the events to their destination
+ * @param events :: the events
+ * @param slots :: the slot of each event
+ * @param numBlocks :: number of blocks the events are split into
+ * @param positions :: position of the first event of each slot, per block.
+ * The positions are advanced as the events are copied.
+ * @param destinations :: where the events of each slot are written
+ */
+template <class T>
+void EventSplitter::scatter(const std::vector<T> &events,
+                            const std::vector<uint32_t> &slots,
+                            const size_t numBlocks,
+                            std::vector<std::vector<size_t>> &positions,
+                            const std::vector<T *> &destinations) const {
+  const size_t numEvents = events.size();
+  auto scatterBlock = [&](const size_t block) {
+    const size_t first = numEvents * block / numBlocks;
+    const size_t last = numEvents * (block + 1) / numBlocks;
+    auto &blockPositions = positions[block];
+    for (size_t i = first; i < last; ++i) {
+      const uint32_t slot = slots[i];
+      if (slot == NO_SLOT || !destinations[slot])
+        continue;
+      destinations[slot][blockPositions[slot]++] = events[i];
+    }
+  };
+
+  if (numBlocks == 1) {
+    scatterBlock(0);
+    return;
+  }
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int block = 0; block < static_cast<int>(numBlocks); ++block)
+    scatterBlock(static_cast<size_t>(block));
+}
+
+template DLLExport void
+EventSplitter::split<TofEvent>(const std::vector<TofEvent> &,
+                               const EventTime &,
+                               const std::vector<std::vector<TofEvent> *> &)
+    const;
+template DLLExport void EventSplitter::split<WeightedEvent>(
+    const std::vector<WeightedEvent> &, const EventTime &,
+    const std::vector<std::vector<WeightedEvent> *> &) const;
+template DLLExport void
+EventSplitter::partition<TofEvent>(const std::vector<TofEvent> &,
+                                   const EventTime &, std::vector<TofEvent> &,
+                                   std::vector<size_t> &) const;
+template DLLExport void EventSplitter::partition<WeightedEvent>(
+    const std::vector<WeightedEvent> &, const EventTime &,
+    std::vector<WeightedEvent> &, std::vector<size_t> &) const;
+
+} // namespace DataObjects
+} // namespace Mantid
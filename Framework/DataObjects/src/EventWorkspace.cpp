@@ -13,7 +13,7 @@
 #include "MantidAPI/SpectraAxis.h"
 #include "MantidAPI/SpectrumInfo.h"
 #include "MantidAPI/WorkspaceFactory.h"
-#include "MantidDataObjects/EventWorkspaceMRU.h"
+#include "MantidDataObjects/EventHistogramCache.h"
 #include "MantidGeometry/IDetector.h"
 #include "MantidGeometry/Instrument.h"
 #include "MantidKernel/CPUTimer.h"
@@ -45,15 +45,18 @@ using std::size_t;
 using namespace Mantid::Kernel;
 
 EventWorkspace::EventWorkspace(const Parallel::StorageMode storageMode)
-    : IEventWorkspace(storageMode), mru(new EventWorkspaceMRU) {}
+    : IEventWorkspace(storageMode),
+      m_histogramCache(new EventHistogramCache) {}
 
 EventWorkspace::EventWorkspace(const EventWorkspace &other)
-    : IEventWorkspace(other), mru(new EventWorkspaceMRU) {
+    : IEventWorkspace(other),
+      m_histogramCache(new EventHistogramCache(
+          other.m_histogramCache->getMemoryLimit())) {
   for (const auto &el : other.data) {
     // Create a new event list, copying over the events
     auto newel = new EventList(*el);
-    // Make sure to update the MRU to point to THIS event workspace.
-    newel->setMRU(this->mru);
+    // Make sure to update the cache to point to THIS event workspace.
+    newel->setHistogramCache(this->m_histogramCache);
     this->data.push_back(newel);
   }
 }
@@ -61,7 +64,7 @@ EventWorkspace::EventWorkspace(const EventWorkspace &other)
 EventWorkspace::~EventWorkspace() {
   for (auto &eventList : data)
     delete eventList;
-  delete mru;
+  delete m_histogramCache;
 }
 
 /** Returns true if the EventWorkspace is safe for multithreaded operations.
@@ -106,7 +109,7 @@ void EventWorkspace::init(const std::size_t &NVectors,
   el.setHistogram(edges);
   for (size_t i = 0; i < NVectors; i++) {
     data[i] = new EventList(el);
-    data[i]->setMRU(mru);
+    data[i]->setHistogramCache(m_histogramCache);
     data[i]->setSpectrumNo(specnum_t(i));
   }
 
@@ -130,7 +133,7 @@ void EventWorkspace::init(const HistogramData::Histogram &histogram) {
   el.setHistogram(histogram);
   for (size_t i = 0; i < data.size(); i++) {
     data[i] = new EventList(el);
-    data[i]->setMRU(mru);
+    data[i]->setHistogramCache(m_histogramCache);
     data[i]->setSpectrumNo(specnum_t(i));
   }
 
@@ -437,29 +440,45 @@ void EventWorkspace::switchEventType(const Mantid::API::EventType type) {
     eventList->switchTo(type);
 }
 
+/** Switch all event lists to the given memory layout
+ *
+ * @param layout :: EventStorageLayout to switch to
+ */
+void EventWorkspace::setStorageLayout(const EventStorageLayout layout) {
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int i = 0; i < static_cast<int>(this->data.size()); ++i)
+    this->data[i]->setStorageLayout(layout);
+}
+
 /// Returns true always - an EventWorkspace always represents histogramm-able
 /// data
 /// @returns If the data is a histogram - always true for an eventWorkspace
 bool EventWorkspace::isHistogramData() const { return true; }
 
-/** Return how many entries in the Y MRU list are used.
- * Only used in tests. It only returns the 0-th MRU list size.
- * @return :: number of entries in the MRU list.
+/** Return how many histograms are held in the histogram cache.
+ * @return :: number of cached histograms.
  */
-size_t EventWorkspace::MRUSize() const { return mru->MRUSize(); }
+size_t EventWorkspace::MRUSize() const { return m_histogramCache->size(); }
+
+/** Clears the histogram cache */
+void EventWorkspace::clearMRU() const { m_histogramCache->clear(); }
 
-/** Clears the MRU lists */
-void EventWorkspace::clearMRU() const { mru->clear(); }
+/** @return the cache of the histograms generated from the event lists, e.g. to
+ * read its statistics or change its memory limit */
+EventHistogramCache &EventWorkspace::histogramCache() const {
+  return *m_histogramCache;
+}
 
 /// Returns the amount of memory used in bytes
 size_t EventWorkspace::getMemorySize() const {
-  // TODO: Add the MRU buffer
+  // Start with the cached histograms
+  size_t total = m_histogramCache->statistics().memoryUsed;
 
   // Add the memory from all the event lists
-  size_t total = std::accumulate(data.begin(), data.end(), size_t{0},
-                                 [](size_t total, EventList *list) {
-                                   return total + list->getMemorySize();
-                                 });
+  total = std::accumulate(data.begin(), data.end(), total,
+                          [](size_t total, EventList *list) {
+                            return total + list->getMemorySize();
+                          });
 
   total += run().getMemorySize();
 
@@ -589,7 +608,7 @@ void EventWorkspace::setAllX(const HistogramData::BinEdges &x) {
   for (auto &eventList : this->data)
     eventList->setHistogram(x);
 
-  // Clear MRU lists now, free up memory
+  // Clear the histogram cache now, free up memory
   this->clearMRU();
 }
 
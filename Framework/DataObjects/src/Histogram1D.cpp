@@ -43,7 +43,8 @@ void Histogram1D::copyDataFrom(const ISpectrum &source) {
 
 /// Used by copyDataFrom for dynamic dispatch for its `source`.
 void Histogram1D::copyDataInto(Histogram1D &sink) const {
-  sink.m_histogram = m_histogram;
+  // Through the accessors, which spectra that page their data in override
+  sink.mutableHistogramRef() = histogramRef();
 }
 
 void Histogram1D::clearData() {
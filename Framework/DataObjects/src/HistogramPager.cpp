@@ -0,0 +1,135 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataObjects/HistogramPager.h"
+#include "MantidDataObjects/LazyHistogram1D.h"
+
+#include <algorithm>
+
+namespace Mantid {
+namespace DataObjects {
+
+namespace {
+/// Memory used by the data of a loaded histogram in bytes
+size_t memorySize(const HistogramData::Histogram &histogram) {
+  size_t length = histogram.x().size() + histogram.y().size() +
+                  histogram.e().size();
+  if (histogram.sharedDx())
+    length += histogram.dx().size();
+  return length * sizeof(double);
+}
+} // namespace
+
+constexpr size_t HistogramPager::MIN_RESIDENT;
+
+/**
+ * @param source :: The source of the histograms
+ * @param memoryBudget :: Memory that the resident, unpinned spectra may use, in
+ * bytes
+ * @param minResident :: Number of spectra kept resident regardless of the
+ * budget
+ */
+HistogramPager::HistogramPager(std::unique_ptr<HistogramSource> source,
+                               const size_t memoryBudget,
+                               const size_t minResident)
+    : m_source(std::move(source)),
+      m_xMode(HistogramData::getHistogramXMode(m_source->xLength(),
+                                               m_source->blocksize())),
+      m_memoryBudget(memoryBudget),
+      m_minResident(std::max<size_t>(minResident, 1)) {}
+
+/// @return the memory used by the resident, unpinned spectra in bytes
+size_t HistogramPager::residentMemory() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_residentMemory;
+}
+
+/// @return the number of resident, unpinned spectra
+size_t HistogramPager::numberResident() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_resident.size();
+}
+
+/// @return the number of histograms read from the source so far
+size_t HistogramPager::numberLoaded() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_loaded;
+}
+
+/**
+ * Read the data of a spectrum, evicting others if the budget is exceeded
+ * @param spectrum :: The spectrum
+ * @return the data of the spectrum
+ */
+std::shared_ptr<HistogramData::Histogram>
+HistogramPager::pageIn(LazyHistogram1D &spectrum) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // Another thread may have loaded it while we were waiting
+  if (spectrum.m_data) {
+    spectrum.m_referenced = true;
+    return spectrum.m_data;
+  }
+  load(spectrum);
+  auto data = spectrum.m_data;
+  spectrum.m_position = m_resident.insert(m_resident.end(), &spectrum);
+  m_residentMemory += memorySize(*data);
+  evict();
+  return data;
+}
+
+/// Keep the data of a spectrum in memory for good, reading it if needed
+void HistogramPager::pin(LazyHistogram1D &spectrum) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (spectrum.m_pinned)
+    return;
+  if (spectrum.m_data) {
+    m_residentMemory -= memorySize(*spectrum.m_data);
+    m_resident.erase(spectrum.m_position);
+  } else {
+    load(spectrum);
+  }
+  spectrum.m_pinned = true;
+}
+
+/// Forget about a spectrum that is being destroyed
+void HistogramPager::release(LazyHistogram1D &spectrum) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (spectrum.m_data && !spectrum.m_pinned) {
+    m_residentMemory -= memorySize(*spectrum.m_data);
+    m_resident.erase(spectrum.m_position);
+  }
+}
+
+/// Read the data of a spectrum from the source. Called with the lock held.
+void HistogramPager::load(LazyHistogram1D &spectrum) {
+  auto data = std::make_shared<HistogramData::Histogram>(
+      m_source->histogram(spectrum.m_index));
+  ++m_loaded;
+  spectrum.m_referenced = true;
+  std::lock_guard<std::mutex> lock(spectrum.m_mutex);
+  spectrum.m_data = std::move(data);
+}
+
+/**
+ * Drop spectra until the resident ones fit in the budget. Spectra that were
+ * accessed since the last pass get a second chance. Called with the lock held.
+ */
+void HistogramPager::evict() {
+  while (m_residentMemory > m_memoryBudget &&
+         m_resident.size() > m_minResident) {
+    auto victim = m_resident.front();
+    if (victim->m_referenced.exchange(false)) {
+      m_resident.splice(m_resident.end(), m_resident, m_resident.begin());
+      continue;
+    }
+    m_residentMemory -= memorySize(*victim->m_data);
+    m_resident.pop_front();
+    victim->pageOut();
+  }
+}
+
+} // namespace DataObjects
+} // namespace Mantid
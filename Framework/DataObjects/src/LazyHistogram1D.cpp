@@ -0,0 +1,177 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataObjects/LazyHistogram1D.h"
+
+#include <vector>
+
+namespace Mantid {
+namespace DataObjects {
+
+namespace {
+/// The data of the spectra most recently read by a thread, kept alive in a
+/// ring
+struct PinnedData {
+  std::vector<std::shared_ptr<HistogramData::Histogram>> entries;
+  size_t next{0};
+};
+thread_local PinnedData g_pinned;
+
+/// Keep data alive for the calling thread until it has read
+/// LazyHistogram1D::PINNED_PER_THREAD other spectra
+void keepAlive(std::shared_ptr<HistogramData::Histogram> data) {
+  auto &pinned = g_pinned;
+  if (!pinned.entries.empty()) {
+    // Reading the same spectrum repeatedly needs a single pin
+    const size_t last =
+        (pinned.next + pinned.entries.size() - 1) % pinned.entries.size();
+    if (pinned.entries[last] == data)
+      return;
+  }
+  if (pinned.entries.size() < LazyHistogram1D::PINNED_PER_THREAD) {
+    pinned.entries.push_back(std::move(data));
+  } else {
+    pinned.entries[pinned.next] = std::move(data);
+    pinned.next = (pinned.next + 1) % LazyHistogram1D::PINNED_PER_THREAD;
+  }
+}
+} // namespace
+
+constexpr size_t LazyHistogram1D::PINNED_PER_THREAD;
+
+/**
+ * Construct a spectrum that is not loaded yet
+ * @param pager :: The pager reading the data from the source
+ * @param index :: Index of the histogram in the source
+ */
+LazyHistogram1D::LazyHistogram1D(boost::shared_ptr<HistogramPager> pager,
+                                 const size_t index)
+    : Histogram1D(pager->xMode(), pager->source().yMode()),
+      m_pager(std::move(pager)), m_index(index) {}
+
+/// Copies of a pinned spectrum own a copy of its data, others start unloaded.
+LazyHistogram1D::LazyHistogram1D(const LazyHistogram1D &other)
+    : Histogram1D(other), m_pager(other.m_pager), m_index(other.m_index) {
+  if (other.isPinned()) {
+    m_data = std::make_shared<HistogramData::Histogram>(*other.m_data);
+    m_pinned = true;
+  }
+}
+
+LazyHistogram1D::~LazyHistogram1D() { m_pager->release(*this); }
+
+bool LazyHistogram1D::isResident() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return static_cast<bool>(m_data);
+}
+
+void LazyHistogram1D::setX(
+    const Kernel::cow_ptr<HistogramData::HistogramX> &X) {
+  mutableHistogramRef().setX(X);
+}
+
+MantidVec &LazyHistogram1D::dataX() { return mutableHistogramRef().dataX(); }
+
+const MantidVec &LazyHistogram1D::dataX() const {
+  return histogramRef().dataX();
+}
+
+const MantidVec &LazyHistogram1D::readX() const {
+  return histogramRef().readX();
+}
+
+Kernel::cow_ptr<HistogramData::HistogramX> LazyHistogram1D::ptrX() const {
+  return histogramRef().ptrX();
+}
+
+MantidVec &LazyHistogram1D::dataDx() { return mutableHistogramRef().dataDx(); }
+
+const MantidVec &LazyHistogram1D::dataDx() const {
+  return histogramRef().dataDx();
+}
+
+const MantidVec &LazyHistogram1D::readDx() const {
+  return histogramRef().readDx();
+}
+
+void LazyHistogram1D::clearData() {
+  pin();
+  Histogram1D::clearData();
+}
+
+const MantidVec &LazyHistogram1D::dataY() const {
+  return histogramRef().dataY();
+}
+
+const MantidVec &LazyHistogram1D::dataE() const {
+  return histogramRef().dataE();
+}
+
+MantidVec &LazyHistogram1D::dataY() { return mutableHistogramRef().dataY(); }
+
+MantidVec &LazyHistogram1D::dataE() { return mutableHistogramRef().dataE(); }
+
+/// The size is known without loading the data
+std::size_t LazyHistogram1D::size() const {
+  return isPinned() ? m_data->y().size() : m_pager->source().blocksize();
+}
+
+/// Spectra that are not resident use no memory for their data
+size_t LazyHistogram1D::getMemorySize() const {
+  std::shared_ptr<HistogramData::Histogram> data;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    data = m_data;
+  }
+  if (!data)
+    return 0;
+  return (data->x().size() + data->y().size() + data->e().size()) *
+         sizeof(double);
+}
+
+/**
+ * The data of the spectrum, read from the source if it is not in memory. The
+ * data of a spectrum that is not pinned is kept alive for the calling thread.
+ */
+const HistogramData::Histogram &LazyHistogram1D::histogramRef() const {
+  // The data of a pinned spectrum is never replaced
+  if (m_pinned.load(std::memory_order_acquire))
+    return *m_data;
+  std::shared_ptr<HistogramData::Histogram> data;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    data = m_data;
+  }
+  if (data)
+    m_referenced.store(true, std::memory_order_relaxed);
+  else
+    data = m_pager->pageIn(const_cast<LazyHistogram1D &>(*this));
+  keepAlive(data);
+  return *data;
+}
+
+HistogramData::Histogram &LazyHistogram1D::mutableHistogramRef() {
+  pin();
+  return *m_data;
+}
+
+/// Make sure the data is in memory and stays there
+void LazyHistogram1D::pin() {
+  if (!m_pinned.load(std::memory_order_acquire))
+    m_pager->pin(*this);
+}
+
+/**
+ * Drop the data. It is freed once no thread keeps it alive any more. Called
+ * by the pager with its lock held.
+ */
+void LazyHistogram1D::pageOut() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_data.reset();
+}
+
+} // namespace DataObjects
+} // namespace Mantid
@@ -0,0 +1,73 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataObjects/LazyWorkspace2D.h"
+#include "MantidAPI/RefAxis.h"
+#include "MantidAPI/SpectraAxis.h"
+#include "MantidDataObjects/LazyHistogram1D.h"
+
+#include <boost/make_shared.hpp>
+
+namespace Mantid {
+namespace DataObjects {
+
+/**
+ * @param source :: The source of the histograms
+ * @param memoryBudget :: Memory that the spectra that were read but not
+ * modified may use, in bytes
+ */
+LazyWorkspace2D::LazyWorkspace2D(std::unique_ptr<HistogramSource> source,
+                                 const size_t memoryBudget)
+    : m_pager(boost::make_shared<HistogramPager>(std::move(source),
+                                                 memoryBudget)) {}
+
+/// The clone shares the pager, and the data of the spectra that are loaded
+LazyWorkspace2D::LazyWorkspace2D(const LazyWorkspace2D &other)
+    : Workspace2D(other), m_pager(other.m_pager) {
+  // The base class made Histogram1D copies of the spectra
+  for (size_t i = 0; i < data.size(); ++i) {
+    delete data[i];
+    data[i] = new LazyHistogram1D(
+        static_cast<const LazyHistogram1D &>(*other.data[i]));
+  }
+}
+
+/**
+ * Create the spectra, without reading them
+ * @param NVectors :: The number of spectra, which must be the size of the
+ * source
+ * @param XLength :: The number of X values in each spectrum
+ * @param YLength :: The number of Y values in each spectrum
+ */
+void LazyWorkspace2D::init(const std::size_t &NVectors,
+                           const std::size_t &XLength,
+                           const std::size_t &YLength) {
+  const auto &source = m_pager->source();
+  if (NVectors != source.size() || XLength != source.xLength() ||
+      YLength != source.blocksize())
+    throw std::invalid_argument(
+        "LazyWorkspace2D: the size does not match the source of the data");
+
+  data.resize(NVectors);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = new LazyHistogram1D(m_pager, i);
+    // Default spectrum number = starts at 1, for workspace index 0.
+    data[i]->setSpectrumNo(specnum_t(i + 1));
+  }
+
+  // Add axes that reference the data
+  m_axes.resize(2);
+  m_axes[0] = new API::RefAxis(this);
+  m_axes[1] = new API::SpectraAxis(this);
+}
+
+void LazyWorkspace2D::init(const HistogramData::Histogram &) {
+  throw std::runtime_error("LazyWorkspace2D: the data is read from its source "
+                           "and cannot be initialized from a histogram");
+}
+
+} // namespace DataObjects
+} // namespace Mantid
@@ -0,0 +1,409 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_COMPACTEVENTSTEST_H_
+#define MANTID_DATAOBJECTS_COMPACTEVENTSTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidDataObjects/CompactEvents.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using Mantid::MantidVec;
+using Mantid::DataObjects::CompactEvents;
+using Mantid::DataObjects::WeightedEvent;
+using Mantid::DataObjects::WeightedEventNoTime;
+using Mantid::Types::Core::DateAndTime;
+using Mantid::Types::Event::TofEvent;
+
+namespace {
+/// Events as loaded from a NeXus file: float TOFs, pulses 1/60 s apart
+std::vector<TofEvent> loadedEvents(const size_t numEvents,
+                                   const size_t numPulses) {
+  std::mt19937 generator(1234);
+  std::uniform_real_distribution<float> tof(0.f, 20000.f);
+  std::uniform_int_distribution<size_t> pulse(0, numPulses - 1);
+  const int64_t start = DateAndTime("2019-03-01T00:00:00").totalNanoseconds();
+  std::vector<TofEvent> events;
+  events.reserve(numEvents);
+  for (size_t i = 0; i < numEvents; ++i)
+    events.emplace_back(
+        static_cast<double>(tof(generator)),
+        DateAndTime(start + static_cast<int64_t>(pulse(generator)) * 16666667));
+  std::sort(events.begin(), events.end(),
+            [](const TofEvent &lhs, const TofEvent &rhs) {
+              return lhs.pulseTime() < rhs.pulseTime();
+            });
+  return events;
+}
+
+/// Events of a single pixel: one per pulse, pulses 1/60 s apart with jitter
+std::vector<TofEvent> onePerPulse(const size_t numEvents,
+                                  const int64_t period = 16666667) {
+  std::mt19937 generator(1234);
+  std::uniform_real_distribution<float> tof(0.f, 20000.f);
+  std::uniform_int_distribution<int64_t> jitter(0, 999);
+  const int64_t start = DateAndTime("2019-03-01T00:00:00").totalNanoseconds();
+  std::vector<TofEvent> events;
+  events.reserve(numEvents);
+  for (size_t i = 0; i < numEvents; ++i)
+    events.emplace_back(static_cast<double>(tof(generator)),
+                        DateAndTime(start + static_cast<int64_t>(i) * period +
+                                    jitter(generator)));
+  return events;
+}
+} // namespace
+
+class CompactEventsTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static CompactEventsTest *createSuite() { return new CompactEventsTest(); }
+  static void destroySuite(CompactEventsTest *suite) { delete suite; }
+
+  void test_default_is_empty() {
+    CompactEvents compact;
+    TS_ASSERT(compact.empty());
+    TS_ASSERT_EQUALS(compact.size(), 0);
+    TS_ASSERT(!compact.hasPulseTimes());
+    TS_ASSERT(!compact.hasWeights());
+  }
+
+  void test_round_trip_TofEvent_single_precision() {
+    const auto events = loadedEvents(10000, 100);
+    CompactEvents compact;
+    compact.assign(events);
+    TS_ASSERT_EQUALS(compact.size(), events.size());
+    TS_ASSERT(compact.hasSinglePrecisionTof());
+    TS_ASSERT(compact.hasPulseTimes());
+    TS_ASSERT(!compact.hasWeights());
+    TS_ASSERT_EQUALS(compact.getNumberPulseTimes(), 100);
+
+    std::vector<TofEvent> out;
+    compact.extract(out);
+    TS_ASSERT_EQUALS(out, events);
+  }
+
+  void test_round_trip_TofEvent_double_precision() {
+    const std::vector<TofEvent> events{{1. / 3., DateAndTime(1000)},
+                                       {1.5, DateAndTime(2000)}};
+    CompactEvents compact;
+    compact.assign(events);
+    TS_ASSERT(!compact.hasSinglePrecisionTof());
+    TS_ASSERT(!compact.hasOffsetTof());
+
+    std::vector<TofEvent> out;
+    compact.extract(out);
+    TS_ASSERT_EQUALS(out[0].tof(), 1. / 3.);
+    TS_ASSERT_EQUALS(out, events);
+  }
+
+  void test_round_trip_TofEvent_offsets() {
+    // Decimal TOFs which are not exact in single precision
+    std::vector<TofEvent> events;
+    for (size_t i = 0; i < 1000; ++i)
+      events.emplace_back(static_cast<double>(199903 - i * 7 % 1000) / 10.,
+                          DateAndTime(static_cast<int64_t>(i / 10)));
+    events.emplace_back(0.1, DateAndTime(1000));
+    CompactEvents compact;
+    compact.assign(events);
+    TS_ASSERT(!compact.hasSinglePrecisionTof());
+    TS_ASSERT(compact.hasOffsetTof());
+    TS_ASSERT_EQUALS(compact.tof(1000), 0.1);
+
+    std::vector<TofEvent> out;
+    compact.extract(out);
+    TS_ASSERT_EQUALS(out, events);
+    // 4 bytes of offset and 2 bytes of pulse index
+    TS_ASSERT_LESS_THAN(compact.getMemorySize(),
+                        events.size() * sizeof(TofEvent) / 2);
+  }
+
+  void test_offsets_are_not_used_when_inexact() {
+    // -0 would come back as +0, and 0.1 + 1 / 3 is on no decimal grid
+    for (const double tof : {-0., 0.1 + 1. / 3.}) {
+      const std::vector<TofEvent> events{{0.1, DateAndTime(0)},
+                                         {tof, DateAndTime(0)}};
+      CompactEvents compact;
+      compact.assign(events);
+      TS_ASSERT(!compact.hasOffsetTof());
+      std::vector<TofEvent> out;
+      compact.extract(out);
+      TS_ASSERT_EQUALS(std::signbit(out[1].tof()), std::signbit(tof));
+      TS_ASSERT_EQUALS(out, events);
+    }
+  }
+
+  void test_offsets_sort_and_min_max() {
+    const std::vector<TofEvent> events{{2.7, DateAndTime(0)},
+                                       {-1.3, DateAndTime(1)},
+                                       {100.1, DateAndTime(2)}};
+    CompactEvents compact;
+    compact.assign(events);
+    TS_ASSERT(compact.hasOffsetTof());
+    TS_ASSERT_EQUALS(compact.getTofMin(), -1.3);
+    TS_ASSERT_EQUALS(compact.getTofMax(), 100.1);
+    compact.sortTof();
+    TS_ASSERT_EQUALS(compact.tof(0), -1.3);
+    TS_ASSERT_EQUALS(compact.tof(1), 2.7);
+    TS_ASSERT_EQUALS(compact.pulseTime(1), 0);
+
+    compact.convertTof(2., 0.);
+    TS_ASSERT(!compact.hasOffsetTof());
+    TS_ASSERT_EQUALS(compact.tof(2), 200.2);
+  }
+
+  void test_round_trip_with_wide_pulse_index() {
+    const auto events = loadedEvents(200000, 100000);
+    CompactEvents compact;
+    compact.assign(events);
+    TS_ASSERT_LESS_THAN(65536, compact.getNumberPulseTimes());
+
+    std::vector<TofEvent> out;
+    compact.extract(out);
+    TS_ASSERT_EQUALS(out, events);
+  }
+
+  void test_round_trip_WeightedEvent() {
+    const std::vector<WeightedEvent> events{{3.0, DateAndTime(200), 2.0, 4.0},
+                                            {1.0, DateAndTime(100), 0.5, 0.25}};
+    CompactEvents compact;
+    compact.assign(events);
+    TS_ASSERT(compact.hasWeights());
+
+    std::vector<WeightedEvent> out;
+    compact.extract(out);
+    TS_ASSERT_EQUALS(out, events);
+  }
+
+  void test_unit_weights_are_not_stored() {
+    const auto tofEvents = loadedEvents(1000, 10);
+    std::vector<WeightedEvent> events(tofEvents.cbegin(), tofEvents.cend());
+    CompactEvents compact;
+    compact.assign(events);
+    TS_ASSERT(compact.hasWeights());
+    TS_ASSERT_EQUALS(compact.weight(0), 1.0f);
+    TS_ASSERT_EQUALS(compact.errorSquared(0), 1.0f);
+
+    CompactEvents unweighted;
+    unweighted.assign(tofEvents);
+    TS_ASSERT_EQUALS(compact.getMemorySize(), unweighted.getMemorySize());
+
+    std::vector<WeightedEvent> out;
+    compact.extract(out);
+    TS_ASSERT_EQUALS(out, events);
+  }
+
+  void test_round_trip_WeightedEventNoTime() {
+    const std::vector<WeightedEventNoTime> events{{3.0, 2.0f, 4.0f},
+                                                  {1.0, 0.5f, 0.25f}};
+    CompactEvents compact;
+    compact.assign(events);
+    TS_ASSERT(!compact.hasPulseTimes());
+
+    std::vector<WeightedEventNoTime> out;
+    compact.extract(out);
+    TS_ASSERT_EQUALS(out, events);
+
+    std::vector<TofEvent> withTimes;
+    TS_ASSERT_THROWS(compact.extract(withTimes), const std::runtime_error &);
+  }
+
+  void test_memory_is_smaller() {
+    const auto events = loadedEvents(100000, 1000);
+    CompactEvents compact;
+    compact.assign(events);
+    // 4 bytes of TOF and 2 bytes of pulse index instead of 16 bytes
+    TS_ASSERT_LESS_THAN(compact.getMemorySize(),
+                        events.size() * sizeof(TofEvent) / 2);
+  }
+
+  void test_memory_with_one_event_per_pulse() {
+    for (const size_t numEvents : {20000, 100000}) {
+      const auto events = onePerPulse(numEvents);
+      CompactEvents compact;
+      compact.assign(events);
+      TS_ASSERT_EQUALS(compact.getNumberPulseTimes(), numEvents);
+      // 4 bytes of TOF, 2 or 4 bytes of pulse index and about 4 bytes of
+      // pulse table per event
+      const size_t indexSize = numEvents > 65536 ? 4 : 2;
+      TS_ASSERT_LESS_THAN(compact.getMemorySize(),
+                          numEvents * (8 + indexSize) + numEvents / 8 + 1000);
+
+      std::vector<TofEvent> out;
+      compact.extract(out);
+      TS_ASSERT_EQUALS(out, events);
+      compact.sortTof();
+      out.clear();
+      compact.filterByPulseTime(events[1000].pulseTime().totalNanoseconds(),
+                                events[2000].pulseTime().totalNanoseconds(),
+                                out);
+      TS_ASSERT_EQUALS(out.size(), 1000);
+    }
+  }
+
+  void test_pulses_seconds_apart() {
+    // Too far apart for 32-bit offsets within a block of the table
+    const auto events = onePerPulse(100, 10000000000);
+    CompactEvents compact;
+    compact.assign(events);
+    TS_ASSERT_EQUALS(compact.getPulseTimeMin(),
+                     events.front().pulseTime().totalNanoseconds());
+    TS_ASSERT_EQUALS(compact.getPulseTimeMax(),
+                     events.back().pulseTime().totalNanoseconds());
+    std::vector<TofEvent> out;
+    compact.extract(out);
+    TS_ASSERT_EQUALS(out, events);
+    out.clear();
+    compact.filterByPulseTime(events[10].pulseTime().totalNanoseconds(),
+                              events[20].pulseTime().totalNanoseconds(), out);
+    TS_ASSERT_EQUALS(out.size(), 10);
+  }
+
+  void test_sortTof() {
+    const auto events = loadedEvents(1000, 10);
+    CompactEvents compact;
+    compact.assign(events);
+    TS_ASSERT(!compact.isSortedByTof());
+    compact.sortTof();
+    TS_ASSERT(compact.isSortedByTof());
+
+    auto expected = events;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const TofEvent &lhs, const TofEvent &rhs) {
+                       return lhs.tof() < rhs.tof();
+                     });
+    std::vector<TofEvent> out;
+    compact.extract(out);
+    TS_ASSERT_EQUALS(out, expected);
+  }
+
+  void test_min_max() {
+    const auto events = loadedEvents(1000, 10);
+    CompactEvents compact;
+    compact.assign(events);
+    const auto tofRange = std::minmax_element(
+        events.cbegin(), events.cend(),
+        [](const TofEvent &lhs, const TofEvent &rhs) {
+          return lhs.tof() < rhs.tof();
+        });
+    TS_ASSERT_EQUALS(compact.getTofMin(), tofRange.first->tof());
+    TS_ASSERT_EQUALS(compact.getTofMax(), tofRange.second->tof());
+    TS_ASSERT_EQUALS(compact.getPulseTimeMin(),
+                     events.front().pulseTime().totalNanoseconds());
+    TS_ASSERT_EQUALS(compact.getPulseTimeMax(),
+                     events.back().pulseTime().totalNanoseconds());
+  }
+
+  void test_histogram_weighted() {
+    const std::vector<WeightedEvent> events{{3.0, DateAndTime(0), 2.0, 4.0},
+                                            {1.0, DateAndTime(0), 0.5, 0.25},
+                                            {1.5, DateAndTime(0), 1.5, 2.25},
+                                            {12.0, DateAndTime(0), 1.0, 1.0}};
+    CompactEvents compact;
+    compact.assign(events);
+    const MantidVec X{0., 2., 4., 10.};
+    MantidVec Y, E;
+    compact.histogram(X, Y, E);
+    TS_ASSERT_EQUALS(Y, MantidVec({2., 2., 0.}));
+    TS_ASSERT_DELTA(E[0], std::sqrt(2.5), 1e-12);
+    TS_ASSERT_DELTA(E[1], 2., 1e-12);
+    TS_ASSERT_EQUALS(E[2], 0.);
+  }
+
+  void test_integrate() {
+    const std::vector<TofEvent> events{{1.0}, {2.0}, {3.0}, {4.0}};
+    CompactEvents compact;
+    compact.assign(events);
+    double sum, error;
+    compact.integrate(2.0, 3.0, false, sum, error);
+    TS_ASSERT_EQUALS(sum, 2.);
+    TS_ASSERT_DELTA(error, std::sqrt(2.), 1e-12);
+    compact.integrate(0., 0., true, sum, error);
+    TS_ASSERT_EQUALS(sum, 4.);
+  }
+
+  void test_filterByPulseTime() {
+    const auto events = loadedEvents(10000, 100);
+    CompactEvents compact;
+    compact.assign(events);
+    const int64_t start = events[2000].pulseTime().totalNanoseconds();
+    const int64_t stop = events[7000].pulseTime().totalNanoseconds();
+
+    std::vector<TofEvent> expected;
+    std::copy_if(events.cbegin(), events.cend(), std::back_inserter(expected),
+                 [start, stop](const TofEvent &event) {
+                   const int64_t pulse = event.pulseTime().totalNanoseconds();
+                   return pulse >= start && pulse < stop;
+                 });
+    std::vector<TofEvent> out;
+    compact.filterByPulseTime(start, stop, out);
+    TS_ASSERT(!out.empty());
+    TS_ASSERT_EQUALS(out, expected);
+
+    out.clear();
+    compact.filterByPulseTime(stop, start, out);
+    TS_ASSERT(out.empty());
+  }
+
+  void test_filterByPulseTime_weighted() {
+    const std::vector<WeightedEvent> events{{3.0, DateAndTime(300), 2.0, 4.0},
+                                            {1.0, DateAndTime(100), 0.5, 0.25},
+                                            {2.0, DateAndTime(200), 1.5, 2.}};
+    CompactEvents compact;
+    compact.assign(events);
+    std::vector<WeightedEvent> out;
+    compact.filterByPulseTime(150, 300, out);
+    TS_ASSERT_EQUALS(out, std::vector<WeightedEvent>({events[2]}));
+  }
+
+  void test_rounded_tof_is_single_precision() {
+    const std::vector<TofEvent> events{{0.1, DateAndTime(1000)},
+                                       {1.5, DateAndTime(2000)}};
+    CompactEvents compact;
+    compact.assign(events, true);
+    TS_ASSERT(compact.roundsTof());
+    TS_ASSERT(compact.hasSinglePrecisionTof());
+    TS_ASSERT_EQUALS(compact.tof(0), static_cast<double>(0.1f));
+    TS_ASSERT_EQUALS(compact.tof(1), 1.5);
+    TS_ASSERT_EQUALS(compact.pulseTime(1), 2000);
+  }
+
+  void test_convertTof_widens_exact_single_precision() {
+    const auto events = loadedEvents(1000, 10);
+    CompactEvents compact;
+    compact.assign(events);
+    compact.convertTof([](const double tof) { return tof / 3.; });
+    TS_ASSERT(!compact.hasSinglePrecisionTof());
+    std::vector<TofEvent> out;
+    compact.extract(out);
+    for (size_t i = 0; i < events.size(); ++i) {
+      TS_ASSERT_EQUALS(out[i].tof(), events[i].tof() / 3.);
+      TS_ASSERT_EQUALS(out[i].pulseTime(), events[i].pulseTime());
+    }
+  }
+
+  void test_convertTof_keeps_rounded_single_precision() {
+    const auto events = loadedEvents(1000, 10);
+    CompactEvents compact;
+    compact.assign(events, true);
+    compact.sortTof();
+    compact.convertTof(-2., 10.);
+    TS_ASSERT(compact.hasSinglePrecisionTof());
+    TS_ASSERT(!compact.isSortedByTof());
+    compact.reverse();
+    TS_ASSERT(compact.isSortedByTof());
+
+    const auto longest = std::max_element(events.cbegin(), events.cend());
+    const auto expected = static_cast<float>(longest->tof() * -2. + 10.);
+    TS_ASSERT_EQUALS(compact.getTofMin(), static_cast<double>(expected));
+  }
+};
+
+#endif /* MANTID_DATAOBJECTS_COMPACTEVENTSTEST_H_ */
@@ -126,6 +126,24 @@ public:
                                ct.applyVMD(VMD(1.0, 2.0, 3.0)));
   }
 
+  void test_applyToBatch_gives_the_same_as_apply() {
+    CoordTransformAffine ct(3, 2);
+    ct.buildOrthogonal(VMD(1.0, 2.0, 3.0),
+                       {VMD(0.6, 0.8, 0.0), VMD(0.0, 0.0, 1.0)},
+                       VMD(2.0, 0.5));
+    const std::vector<coord_t> in = {1.5, 2.5, 3.5, -1.0, 0.0, 4.0,
+                                     0.0, 0.0, 0.0, 7.0,  8.0, -9.0};
+    std::vector<coord_t> out(8);
+    ct.applyToBatch(in.data(), out.data(), 4);
+    for (size_t i = 0; i < 4; ++i) {
+      coord_t expected[2];
+      ct.apply(in.data() + i * 3, expected);
+      // The same operations in the same order
+      TS_ASSERT_EQUALS(out[i * 2], expected[0]);
+      TS_ASSERT_EQUALS(out[i * 2 + 1], expected[1]);
+    }
+  }
+
   /** Test rotation in isolation */
   void test_rotation() {
     using Mantid::Kernel::V3D;
@@ -424,6 +442,18 @@ public:
       ct.apply(in, out);
     }
   }
+  void test_applyToBatch_4D_performance() {
+    CoordTransformAffine ct(4, 4);
+    coord_t translation[4] = {2.0, 3.0, 4.0, 5.0};
+    ct.addTranslation(translation);
+    const size_t batchSize = 1000;
+    std::vector<coord_t> in(batchSize * 4, 1.5);
+    std::vector<coord_t> out(batchSize * 4);
+
+    for (size_t i = 0; i < 1000 * 10; ++i) {
+      ct.applyToBatch(in.data(), out.data(), batchSize);
+    }
+  }
 };
 
 #endif /* MANTID_DATAOBJECTS_COORDTRANSFORMAFFINETEST_H_ */
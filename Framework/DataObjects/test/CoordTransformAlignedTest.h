@@ -77,6 +77,24 @@ public:
     TS_ASSERT_DELTA(output[2], 3.0, 1e-6);
   }
 
+  void test_applyToBatch() {
+    size_t dimToBinFrom[3] = {3, 1, 0};
+    coord_t origin[3] = {5, 10, 15};
+    coord_t scaling[3] = {1, 2, 3};
+    CoordTransformAligned ct(4, 3, dimToBinFrom, origin, scaling);
+
+    coord_t input[8] = {16, 11, 11111111 /*ignored*/, 6,
+                        17, 12, 11111111 /*ignored*/, 7};
+    coord_t output[6] = {0, 0, 0, 0, 0, 0};
+    ct.applyToBatch(input, output, 2);
+    TS_ASSERT_DELTA(output[0], 1.0, 1e-6);
+    TS_ASSERT_DELTA(output[1], 2.0, 1e-6);
+    TS_ASSERT_DELTA(output[2], 3.0, 1e-6);
+    TS_ASSERT_DELTA(output[3], 2.0, 1e-6);
+    TS_ASSERT_DELTA(output[4], 4.0, 1e-6);
+    TS_ASSERT_DELTA(output[5], 6.0, 1e-6);
+  }
+
   /// Clone the transform, check that it still works
   void test_clone() {
     size_t dimToBinFrom[3] = {3, 1, 0};
@@ -180,5 +198,18 @@ public:
       ct.apply(in, out);
     }
   }
+  void test_applyToBatch_4D_performance() {
+    size_t dimToBinFrom[4] = {0, 1, 2, 3};
+    coord_t origin[4] = {5, 10, 15, 20};
+    coord_t scaling[4] = {1, 2, 3, 4};
+    CoordTransformAligned ct(4, 4, dimToBinFrom, origin, scaling);
+    const size_t batchSize = 1000;
+    std::vector<coord_t> in(batchSize * 4, 1.5);
+    std::vector<coord_t> out(batchSize * 4);
+
+    for (size_t i = 0; i < 1000 * 10; ++i) {
+      ct.applyToBatch(in.data(), out.data(), batchSize);
+    }
+  }
 };
 #endif /* MANTID_DATAOBJECTS_COORDTRANSFORMALIGNEDTEST_H_ */
@@ -0,0 +1,179 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_EVENTCOLUMNSTEST_H_
+#define MANTID_DATAOBJECTS_EVENTCOLUMNSTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidDataObjects/EventColumns.h"
+
+#include <cmath>
+
+using Mantid::MantidVec;
+using Mantid::DataObjects::EventColumns;
+using Mantid::DataObjects::WeightedEvent;
+using Mantid::DataObjects::WeightedEventNoTime;
+using Mantid::Types::Event::TofEvent;
+
+class EventColumnsTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static EventColumnsTest *createSuite() { return new EventColumnsTest(); }
+  static void destroySuite(EventColumnsTest *suite) { delete suite; }
+
+  void test_default_is_empty() {
+    EventColumns columns;
+    TS_ASSERT(columns.empty());
+    TS_ASSERT_EQUALS(columns.size(), 0);
+    TS_ASSERT(!columns.hasPulseTimes());
+    TS_ASSERT(!columns.hasWeights());
+  }
+
+  void test_round_trip_TofEvent() {
+    const auto events = tofEvents();
+    EventColumns columns;
+    columns.assign(events);
+    TS_ASSERT_EQUALS(columns.size(), events.size());
+    TS_ASSERT(columns.hasPulseTimes());
+    TS_ASSERT(!columns.hasWeights());
+
+    std::vector<TofEvent> out;
+    columns.extract(out);
+    TS_ASSERT_EQUALS(out, events);
+  }
+
+  void test_round_trip_WeightedEvent() {
+    const auto events = weightedEvents();
+    EventColumns columns;
+    columns.assign(events);
+    TS_ASSERT(columns.hasPulseTimes());
+    TS_ASSERT(columns.hasWeights());
+
+    std::vector<WeightedEvent> out;
+    columns.extract(out);
+    TS_ASSERT_EQUALS(out, events);
+  }
+
+  void test_round_trip_WeightedEventNoTime() {
+    std::vector<WeightedEventNoTime> events{{3.0, 2.0f, 4.0f},
+                                            {1.0, 0.5f, 0.25f}};
+    EventColumns columns;
+    columns.assign(events);
+    TS_ASSERT(!columns.hasPulseTimes());
+    TS_ASSERT(columns.hasWeights());
+
+    std::vector<WeightedEventNoTime> out;
+    columns.extract(out);
+    TS_ASSERT_EQUALS(out, events);
+  }
+
+  void test_extract_with_pulse_times_throws_without_pulse_times() {
+    EventColumns columns;
+    columns.assign(std::vector<WeightedEventNoTime>{{3.0, 2.0f, 4.0f}});
+    std::vector<TofEvent> out;
+    TS_ASSERT_THROWS(columns.extract(out), const std::runtime_error &);
+  }
+
+  void test_sortTof_keeps_columns_together() {
+    EventColumns columns;
+    columns.assign(weightedEvents());
+    columns.sortTof();
+
+    std::vector<WeightedEvent> out;
+    columns.extract(out);
+    TS_ASSERT_EQUALS(out.size(), 4);
+    for (size_t i = 0; i < out.size(); ++i) {
+      TS_ASSERT_DELTA(out[i].tof(), static_cast<double>(i + 1), 1e-12);
+      TS_ASSERT_DELTA(out[i].weight(), 10. * static_cast<double>(i + 1),
+                      1e-6);
+      TS_ASSERT_EQUALS(out[i].pulseTime().totalNanoseconds(),
+                       100 * static_cast<int64_t>(i + 1));
+    }
+  }
+
+  void test_convertTof() {
+    EventColumns columns;
+    columns.assign(tofEvents());
+    columns.convertTof(2.0, 1.0);
+    TS_ASSERT_DELTA(columns.tofs()[0], 9.0, 1e-12);
+    columns.convertTof([](double tof) { return tof - 1.0; });
+    TS_ASSERT_DELTA(columns.tofs()[0], 8.0, 1e-12);
+  }
+
+  void test_maskTof() {
+    EventColumns columns;
+    columns.assign(weightedEvents());
+    columns.sortTof();
+    TS_ASSERT_EQUALS(columns.maskTof(1.5, 3.0), 2);
+    TS_ASSERT_EQUALS(columns.size(), 2);
+    TS_ASSERT_DELTA(columns.tofs()[0], 1.0, 1e-12);
+    TS_ASSERT_DELTA(columns.tofs()[1], 4.0, 1e-12);
+    TS_ASSERT_DELTA(columns.weights()[1], 40.0, 1e-6);
+    TS_ASSERT_EQUALS(columns.pulseTimes()[1], 400);
+    TS_ASSERT_EQUALS(columns.maskTof(5.0, 6.0), 0);
+  }
+
+  void test_histogram_unweighted() {
+    EventColumns columns;
+    columns.assign(tofEvents());
+    columns.sortTof();
+    const MantidVec X{0.0, 2.5, 3.5, 10.0};
+    MantidVec Y, E;
+    columns.histogram(X, Y, E);
+    TS_ASSERT_EQUALS(Y, MantidVec({1.0, 1.0, 2.0}));
+    TS_ASSERT_DELTA(E[2], std::sqrt(2.0), 1e-12);
+  }
+
+  void test_histogram_weighted() {
+    EventColumns columns;
+    columns.assign(weightedEvents());
+    columns.sortTof();
+    const MantidVec X{0.0, 2.0, 3.5};
+    MantidVec Y, E;
+    columns.histogram(X, Y, E);
+    TS_ASSERT_EQUALS(Y.size(), 2);
+    TS_ASSERT_DELTA(Y[0], 10.0, 1e-6);
+    TS_ASSERT_DELTA(Y[1], 50.0, 1e-6);
+    TS_ASSERT_DELTA(E[1], std::sqrt(5.0), 1e-6);
+  }
+
+  void test_histogram_without_bins_is_empty() {
+    EventColumns columns;
+    columns.assign(tofEvents());
+    MantidVec Y{1.0}, E{1.0};
+    columns.histogram(MantidVec{1.0}, Y, E);
+    TS_ASSERT(Y.empty());
+    TS_ASSERT(E.empty());
+  }
+
+  void test_integrate() {
+    EventColumns columns;
+    columns.assign(weightedEvents());
+    columns.sortTof();
+    double sum(0), error(0);
+    columns.integrate(0, 0, true, sum, error);
+    TS_ASSERT_DELTA(sum, 100.0, 1e-6);
+    TS_ASSERT_DELTA(error, std::sqrt(10.0), 1e-6);
+    columns.integrate(1.5, 3.0, false, sum, error);
+    TS_ASSERT_DELTA(sum, 50.0, 1e-6);
+  }
+
+private:
+  std::vector<TofEvent> tofEvents() {
+    return {{4.0, 400}, {2.0, 200}, {7.0, 700}, {3.0, 300}};
+  }
+
+  std::vector<WeightedEvent> weightedEvents() {
+    return {{4.0, 400, 40.0f, 4.0f},
+            {2.0, 200, 20.0f, 2.0f},
+            {1.0, 100, 10.0f, 1.0f},
+            {3.0, 300, 30.0f, 3.0f}};
+  }
+};
+
+#endif /* MANTID_DATAOBJECTS_EVENTCOLUMNSTEST_H_ */
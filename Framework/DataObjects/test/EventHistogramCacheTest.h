@@ -0,0 +1,219 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_EVENTHISTOGRAMCACHETEST_H_
+#define MANTID_DATAOBJECTS_EVENTHISTOGRAMCACHETEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidDataObjects/EventHistogramCache.h"
+#include "MantidKernel/MultiThreaded.h"
+#include "MantidKernel/make_cow.h"
+
+using Mantid::DataObjects::EventHistogramCache;
+using Mantid::DataObjects::EventList;
+using Mantid::HistogramData::HistogramE;
+using Mantid::HistogramData::HistogramY;
+using Mantid::Kernel::make_cow;
+
+class EventHistogramCacheTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static EventHistogramCacheTest *createSuite() {
+    return new EventHistogramCacheTest();
+  }
+  static void destroySuite(EventHistogramCacheTest *suite) { delete suite; }
+
+  EventHistogramCacheTest() : m_lists(10000) {}
+
+  void test_empty_cache() {
+    EventHistogramCache cache(1024 * 1024);
+    TS_ASSERT_EQUALS(cache.size(), 0);
+    TS_ASSERT_EQUALS(cache.getMemoryLimit(), 1024 * 1024);
+    EventHistogramCache::YType y;
+    EventHistogramCache::EType e;
+    TS_ASSERT(!cache.find(list(0), 1, y, e));
+    TS_ASSERT_EQUALS(cache.statistics().misses, 1);
+  }
+
+  void test_generations_are_unique() {
+    const auto first = EventHistogramCache::newGeneration();
+    const auto second = EventHistogramCache::newGeneration();
+    TS_ASSERT_DIFFERS(first, second);
+    TS_ASSERT_DIFFERS(first, 0);
+  }
+
+  void test_insert_and_find() {
+    EventHistogramCache cache(1024 * 1024);
+    insert(cache, 0, 5, 10);
+    EventHistogramCache::YType y;
+    EventHistogramCache::EType e;
+    TS_ASSERT(cache.find(list(0), 5, y, e));
+    TS_ASSERT_EQUALS(y->size(), 10);
+    TS_ASSERT_EQUALS(e->size(), 10);
+    TS_ASSERT_EQUALS((*y)[0], 0.);
+    TS_ASSERT(!cache.find(list(1), 5, y, e));
+
+    const auto statistics = cache.statistics();
+    TS_ASSERT_EQUALS(statistics.hits, 1);
+    TS_ASSERT_EQUALS(statistics.misses, 1);
+    TS_ASSERT_EQUALS(statistics.evictions, 0);
+    TS_ASSERT_EQUALS(statistics.entries, 1);
+    TS_ASSERT_LESS_THAN(20 * sizeof(double), statistics.memoryUsed);
+  }
+
+  void test_other_generation_is_a_miss_and_is_dropped() {
+    EventHistogramCache cache(1024 * 1024);
+    insert(cache, 0, 5, 10);
+    EventHistogramCache::YType y;
+    EventHistogramCache::EType e;
+    TS_ASSERT(!cache.find(list(0), 6, y, e));
+    TS_ASSERT_EQUALS(cache.size(), 0);
+    TS_ASSERT(!cache.find(list(0), 5, y, e));
+  }
+
+  void test_insert_replaces_previous_histograms() {
+    EventHistogramCache cache(1024 * 1024);
+    insert(cache, 0, 5, 10);
+    insert(cache, 0, 6, 20);
+    TS_ASSERT_EQUALS(cache.size(), 1);
+    EventHistogramCache::YType y;
+    EventHistogramCache::EType e;
+    TS_ASSERT(cache.find(list(0), 6, y, e));
+    TS_ASSERT_EQUALS(y->size(), 20);
+  }
+
+  void test_erase_and_clear() {
+    EventHistogramCache cache(1024 * 1024);
+    for (size_t i = 0; i < 10; ++i)
+      insert(cache, i, 1, 10);
+    TS_ASSERT_EQUALS(cache.size(), 10);
+    cache.erase(list(3));
+    TS_ASSERT_EQUALS(cache.size(), 9);
+    cache.clear();
+    TS_ASSERT_EQUALS(cache.size(), 0);
+    TS_ASSERT_EQUALS(cache.statistics().memoryUsed, 0);
+  }
+
+  void test_memory_limit_evicts_least_recently_used() {
+    // 10 bins of Y and E take a bit more than 160 bytes
+    EventHistogramCache cache(64 * 1024);
+    for (size_t i = 0; i < m_lists.size(); ++i)
+      insert(cache, i, 1, 10);
+    const auto statistics = cache.statistics();
+    TS_ASSERT_LESS_THAN_EQUALS(statistics.memoryUsed, 64 * 1024);
+    TS_ASSERT_LESS_THAN(statistics.entries, m_lists.size());
+    TS_ASSERT_EQUALS(statistics.entries + statistics.evictions,
+                     m_lists.size());
+    // The last list inserted is always kept
+    EventHistogramCache::YType y;
+    EventHistogramCache::EType e;
+    TS_ASSERT(cache.find(list(m_lists.size() - 1), 1, y, e));
+    TS_ASSERT(!cache.find(list(0), 1, y, e));
+  }
+
+  void test_recently_found_histograms_are_kept() {
+    EventHistogramCache cache(1024 * 1024);
+    insert(cache, 0, 1, 10);
+    for (size_t i = 1; i < m_lists.size(); ++i) {
+      EventHistogramCache::YType y;
+      EventHistogramCache::EType e;
+      TS_ASSERT(cache.find(list(0), 1, y, e));
+      insert(cache, i, 1, 100);
+    }
+    TS_ASSERT_LESS_THAN(0, cache.statistics().evictions);
+    EventHistogramCache::YType y;
+    EventHistogramCache::EType e;
+    TS_ASSERT(cache.find(list(0), 1, y, e));
+  }
+
+  void test_setMemoryLimit_evicts() {
+    EventHistogramCache cache(1024 * 1024);
+    for (size_t i = 0; i < 1000; ++i)
+      insert(cache, i, 1, 10);
+    TS_ASSERT_EQUALS(cache.size(), 1000);
+    cache.setMemoryLimit(0);
+    // Only the most recent histogram of each shard is kept
+    TS_ASSERT_LESS_THAN_EQUALS(cache.size(), 64);
+    TS_ASSERT_EQUALS(cache.statistics().evictions, 1000 - cache.size());
+  }
+
+  void test_resetStatistics() {
+    EventHistogramCache cache(1024 * 1024);
+    insert(cache, 0, 1, 10);
+    EventHistogramCache::YType y;
+    EventHistogramCache::EType e;
+    cache.find(list(0), 1, y, e);
+    cache.find(list(1), 1, y, e);
+    cache.resetStatistics();
+    const auto statistics = cache.statistics();
+    TS_ASSERT_EQUALS(statistics.hits, 0);
+    TS_ASSERT_EQUALS(statistics.misses, 0);
+    TS_ASSERT_EQUALS(statistics.entries, 1);
+  }
+
+  void test_pinned_histograms_outlive_eviction() {
+    EventHistogramCache cache(1024 * 1024);
+    auto y = make_cow<HistogramY>(10, 3.);
+    auto e = make_cow<HistogramE>(10, 1.);
+    cache.insert(list(0), 1, y, e);
+    EventHistogramCache::pin(y, e);
+    // Pinning the same histograms again does not use another pin
+    EventHistogramCache::pin(y, e);
+    cache.clear();
+    // Held by this test and the pins of this thread
+    TS_ASSERT_EQUALS(y.use_count(), 2);
+
+    for (size_t i = 1; i < EventHistogramCache::PINNED_PER_THREAD; ++i)
+      EventHistogramCache::pin(make_cow<HistogramY>(1, 0.),
+                               make_cow<HistogramE>(1, 0.));
+    TS_ASSERT_EQUALS(y.use_count(), 2);
+    EventHistogramCache::pin(make_cow<HistogramY>(1, 0.),
+                             make_cow<HistogramE>(1, 0.));
+    TS_ASSERT_EQUALS(y.use_count(), 1);
+    TS_ASSERT_EQUALS(e.use_count(), 1);
+  }
+
+  void test_threaded_access() {
+    EventHistogramCache cache(64 * 1024 * 1024);
+    const int numLists = static_cast<int>(m_lists.size());
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int i = 0; i < numLists; ++i) {
+      EventHistogramCache::YType y;
+      EventHistogramCache::EType e;
+      if (!cache.find(list(i), 1, y, e))
+        insert(cache, i, 1, 10);
+    }
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int i = 0; i < numLists; ++i) {
+      EventHistogramCache::YType y;
+      EventHistogramCache::EType e;
+      cache.find(list(i), 1, y, e);
+    }
+    const auto statistics = cache.statistics();
+    TS_ASSERT_EQUALS(statistics.entries, m_lists.size());
+    TS_ASSERT_EQUALS(statistics.hits, m_lists.size());
+    TS_ASSERT_EQUALS(statistics.misses, m_lists.size());
+  }
+
+private:
+  /// The cache only uses the address of the event lists, as a key
+  const EventList *list(const size_t i) const {
+    return reinterpret_cast<const EventList *>(&m_lists[i]);
+  }
+
+  void insert(EventHistogramCache &cache, const size_t i,
+              const uint64_t generation, const size_t numBins) {
+    cache.insert(list(i), generation,
+                 make_cow<HistogramY>(numBins, static_cast<double>(i)),
+                 make_cow<HistogramE>(numBins, 1.));
+  }
+
+  std::vector<double> m_lists;
+};
+
+#endif /* MANTID_DATAOBJECTS_EVENTHISTOGRAMCACHETEST_H_ */
@@ -0,0 +1,265 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_EVENTHISTOGRAMMERTEST_H_
+#define MANTID_DATAOBJECTS_EVENTHISTOGRAMMERTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidDataObjects/EventHistogrammer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using Mantid::MantidVec;
+using Mantid::DataObjects::EventHistogrammer;
+using Mantid::DataObjects::WeightedEvent;
+using Mantid::DataObjects::WeightedEventNoTime;
+using Mantid::Types::Event::TofEvent;
+using BinningType = Mantid::DataObjects::EventHistogrammer::BinningType;
+
+namespace {
+/// Bins as created by Rebin with the parameters start, step, end
+MantidVec rebinEdges(const double start, const double step, const double end) {
+  MantidVec X{start};
+  while (X.back() < end) {
+    const double next = step > 0. ? X.back() + step : X.back() * (1. - step);
+    X.push_back(std::min(next, end));
+  }
+  return X;
+}
+
+/// Bin index found by searching the edges
+size_t searchBin(const MantidVec &X, const double x) {
+  if (!(x >= X.front() && x < X.back()))
+    return X.size() - 1;
+  return std::upper_bound(X.cbegin(), X.cend(), x) - X.cbegin() - 1;
+}
+
+std::vector<TofEvent> randomEvents(const size_t numEvents, const double min,
+                                   const double max) {
+  std::mt19937 generator(1234);
+  std::uniform_real_distribution<double> tof(min, max);
+  std::vector<TofEvent> events;
+  events.reserve(numEvents);
+  for (size_t i = 0; i < numEvents; ++i)
+    events.emplace_back(tof(generator));
+  return events;
+}
+} // namespace
+
+class EventHistogrammerTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static EventHistogrammerTest *createSuite() {
+    return new EventHistogrammerTest();
+  }
+  static void destroySuite(EventHistogrammerTest *suite) { delete suite; }
+
+  void test_detects_linear_binning() {
+    EventHistogrammer histogrammer(rebinEdges(100., 10., 1000.));
+    TS_ASSERT_EQUALS(histogrammer.binningType(), BinningType::Linear);
+    TS_ASSERT(histogrammer.isRegular());
+  }
+
+  void test_detects_linear_binning_with_short_last_bin() {
+    EventHistogrammer histogrammer(rebinEdges(100., 10., 995.));
+    TS_ASSERT_EQUALS(histogrammer.binningType(), BinningType::Linear);
+  }
+
+  void test_detects_logarithmic_binning() {
+    EventHistogrammer histogrammer(rebinEdges(100., -0.01, 20000.));
+    TS_ASSERT_EQUALS(histogrammer.binningType(), BinningType::Logarithmic);
+  }
+
+  void test_irregular_binning() {
+    MantidVec X = rebinEdges(100., 10., 1000.);
+    X[40] += 5.;
+    EventHistogrammer histogrammer(X);
+    TS_ASSERT_EQUALS(histogrammer.binningType(), BinningType::Irregular);
+    TS_ASSERT(!histogrammer.isRegular());
+  }
+
+  void test_unsorted_edges_are_irregular() {
+    const MantidVec X{0., 2., 1., 3.};
+    EventHistogrammer histogrammer(X);
+    TS_ASSERT_EQUALS(histogrammer.binningType(), BinningType::Irregular);
+  }
+
+  void test_no_bins() {
+    const MantidVec X{1.};
+    EventHistogrammer histogrammer(X);
+    TS_ASSERT(!histogrammer.isRegular());
+    TS_ASSERT_EQUALS(histogrammer.findBin(1.), 0);
+  }
+
+  void test_forEdges_reuses_the_detection_for_the_same_edges() {
+    MantidVec X = rebinEdges(100., -0.01, 20000.);
+    const EventHistogrammer *first = &EventHistogrammer::forEdges(X);
+    TS_ASSERT_EQUALS(first->binningType(), BinningType::Logarithmic);
+    const MantidVec copy(X);
+    TS_ASSERT_EQUALS(&EventHistogrammer::forEdges(copy), first);
+
+    X[40] = 0.5 * (X[39] + X[40]);
+    const auto &changed = EventHistogrammer::forEdges(X);
+    TS_ASSERT_EQUALS(changed.binningType(), BinningType::Irregular);
+    TS_ASSERT_EQUALS(changed.findBin(X[40]), 40);
+  }
+
+  void test_findBin_matches_search_linear() {
+    do_test_findBin(rebinEdges(-50., 0.1, 995.55));
+  }
+
+  void test_findBin_matches_search_logarithmic() {
+    do_test_findBin(rebinEdges(10., -0.003, 20000.));
+  }
+
+  void test_findBin_matches_search_irregular() {
+    MantidVec X = rebinEdges(100., 10., 1000.);
+    X[40] += 5.;
+    do_test_findBin(X);
+  }
+
+  void test_findBin_on_edges() {
+    const MantidVec X = rebinEdges(0., 0.1, 100.);
+    EventHistogrammer histogrammer(X);
+    for (size_t i = 0; i + 1 < X.size(); ++i)
+      TS_ASSERT_EQUALS(histogrammer.findBin(X[i]), i);
+    TS_ASSERT_EQUALS(histogrammer.findBin(X.back()), X.size() - 1);
+  }
+
+  void test_countEvents() {
+    const MantidVec X = rebinEdges(10., -0.01, 20000.);
+    const auto events = randomEvents(100000, 0., 25000.);
+    MantidVec Y(X.size() - 1, 0.);
+    EventHistogrammer(X).countEvents(events, Y);
+
+    MantidVec expected(X.size(), 0.);
+    for (const auto &event : events)
+      expected[searchBin(X, event.tof())] += 1.;
+    expected.pop_back();
+    TS_ASSERT_EQUALS(Y, expected);
+  }
+
+  void test_countEvents_adds_to_histogram() {
+    const MantidVec X = rebinEdges(0., 1., 10.);
+    const std::vector<TofEvent> events{{0.5}, {0.7}, {9.5}, {10.}, {-1.}};
+    MantidVec Y(X.size() - 1, 1.);
+    EventHistogrammer(X).countEvents(events, Y);
+    TS_ASSERT_EQUALS(Y, MantidVec({3., 1., 1., 1., 1., 1., 1., 1., 1., 2.}));
+  }
+
+  void test_countEvents_throws_for_irregular_binning() {
+    const MantidVec X{0., 1., 3.};
+    MantidVec Y(2, 0.);
+    TS_ASSERT_THROWS(EventHistogrammer(X).countEvents({}, Y),
+                     const std::runtime_error &);
+  }
+
+  void test_countEvents_throws_for_wrong_size() {
+    const MantidVec X{0., 1., 2.};
+    MantidVec Y(3, 0.);
+    TS_ASSERT_THROWS(EventHistogrammer(X).countEvents({}, Y),
+                     const std::invalid_argument &);
+  }
+
+  void test_sumWeights() {
+    const MantidVec X = rebinEdges(0., 2., 10.);
+    const std::vector<WeightedEvent> events{
+        {1., 0, 2., 4.}, {1.5, 0, 3., 9.}, {9.99, 0, 0.5, 0.25}, {11., 0, 1., 1.}};
+    MantidVec Y(X.size() - 1, 0.);
+    MantidVec E(X.size() - 1, 0.);
+    EventHistogrammer(X).sumWeights(events, Y, E);
+    TS_ASSERT_EQUALS(Y, MantidVec({5., 0., 0., 0., 0.5}));
+    TS_ASSERT_EQUALS(E, MantidVec({13., 0., 0., 0., 0.25}));
+  }
+
+  void test_sumWeights_no_time() {
+    const MantidVec X = rebinEdges(1., -1., 16.);
+    const std::vector<WeightedEventNoTime> events{
+        {1., 2., 4.}, {3., 3., 9.}, {15., 0.5, 0.25}};
+    MantidVec Y(X.size() - 1, 0.);
+    MantidVec E(X.size() - 1, 0.);
+    EventHistogrammer(X).sumWeights(events, Y, E);
+    TS_ASSERT_EQUALS(Y, MantidVec({2., 3., 0., 0.5}));
+    TS_ASSERT_EQUALS(E, MantidVec({4., 9., 0., 0.25}));
+  }
+
+  void test_threaded_counts_match_serial() {
+    // Large enough to be split between threads where available
+    const MantidVec X = rebinEdges(0., 10., 1000.);
+    const auto events = randomEvents(2000000, -10., 1010.);
+    MantidVec Y(X.size() - 1, 0.);
+    EventHistogrammer(X).countEvents(events, Y);
+
+    MantidVec expected(X.size(), 0.);
+    for (const auto &event : events)
+      expected[searchBin(X, event.tof())] += 1.;
+    expected.pop_back();
+    TS_ASSERT_EQUALS(Y, expected);
+  }
+
+private:
+  void do_test_findBin(const MantidVec &X) {
+    EventHistogrammer histogrammer(X);
+    const auto events = randomEvents(20000, X.front() - 10., X.back() + 10.);
+    for (const auto &event : events)
+      TS_ASSERT_EQUALS(histogrammer.findBin(event.tof()),
+                       searchBin(X, event.tof()));
+  }
+};
+
+class EventHistogrammerTestPerformance : public CxxTest::TestSuite {
+public:
+  static EventHistogrammerTestPerformance *createSuite() {
+    return new EventHistogrammerTestPerformance();
+  }
+  static void destroySuite(EventHistogrammerTestPerformance *suite) {
+    delete suite;
+  }
+
+  EventHistogrammerTestPerformance()
+      : m_linearX(rebinEdges(0., 1., 100000.)),
+        m_logX(rebinEdges(10., -0.0001, 100000.)),
+        m_events(randomEvents(20000000, 0., 100000.)) {
+    // Moving a single edge forces the search of the edges
+    m_irregularX = m_linearX;
+    m_irregularX[1] = 0.5;
+  }
+
+  void test_linear_bins() {
+    MantidVec Y(m_linearX.size() - 1, 0.);
+    EventHistogrammer(m_linearX).countEvents(m_events, Y);
+  }
+
+  void test_logarithmic_bins() {
+    MantidVec Y(m_logX.size() - 1, 0.);
+    EventHistogrammer(m_logX).countEvents(m_events, Y);
+  }
+
+  void test_search_linear_bins() {
+    // The search of the edges used for irregular bins, for comparison
+    MantidVec Y(m_linearX.size(), 0.);
+    for (const auto &event : m_events)
+      Y[searchBin(m_linearX, event.tof())] += 1.;
+  }
+
+  void test_search_irregular_bins() {
+    MantidVec Y(m_irregularX.size(), 0.);
+    for (const auto &event : m_events)
+      Y[searchBin(m_irregularX, event.tof())] += 1.;
+  }
+
+private:
+  const MantidVec m_linearX;
+  const MantidVec m_logX;
+  MantidVec m_irregularX;
+  const std::vector<TofEvent> m_events;
+};
+
+#endif /* MANTID_DATAOBJECTS_EVENTHISTOGRAMMERTEST_H_ */
@@ -12,6 +12,7 @@
 #include "MantidDataObjects/EventWorkspace.h"
 #include "MantidDataObjects/Histogram1D.h"
 #include "MantidKernel/CPUTimer.h"
+#include "MantidKernel/ConfigService.h"
 #include "MantidKernel/Timer.h"
 #include "MantidKernel/Unit.h"
 #include "MantidKernel/make_unique.h"
@@ -1314,6 +1315,270 @@ public:
     }
   }
 
+  //-----------------------------------------------------------------------------------------------
+  void test_histogram_log_bins_all_types() {
+    // Logarithmic bins are found arithmetically, check against a search
+    MantidVec X;
+    for (double x = 1000.; x < MAX_TOF; x *= 1.05)
+      X.push_back(x);
+    X.push_back(MAX_TOF);
+    for (int this_type = 0; this_type < 3; this_type++) {
+      this->fake_uniform_data();
+      el.switchTo(static_cast<EventType>(this_type));
+      MantidVec expected(X.size() - 1, 0.0);
+      for (const double tof : el.getTofs()) {
+        if (tof >= X.front() && tof < X.back())
+          expected[std::upper_bound(X.begin(), X.end(), tof) - X.begin() - 1] +=
+              1.0;
+      }
+      MantidVec Y, E;
+      el.generateHistogram(X, Y, E);
+      TS_ASSERT_EQUALS(Y, expected);
+    }
+  }
+
+  //-----------------------------------------------------------------------------------------------
+  void test_columnLayout_histogram_all_types() {
+    for (int this_type = 0; this_type < 3; this_type++) {
+      this->fake_uniform_data();
+      el.switchTo(static_cast<EventType>(this_type));
+      this->test_setX();
+      MantidVec rowY, rowE;
+      el.generateHistogram(el.readX(), rowY, rowE);
+
+      this->fake_uniform_data();
+      el.switchTo(static_cast<EventType>(this_type));
+      this->test_setX();
+      el.setStorageLayout(COLUMN_LAYOUT);
+      TS_ASSERT_EQUALS(el.getStorageLayout(), COLUMN_LAYOUT);
+      MantidVec Y, E;
+      el.generateHistogram(el.readX(), Y, E);
+      TS_ASSERT_EQUALS(Y, rowY);
+      TS_ASSERT_EQUALS(E, rowE);
+      // Histogramming works on the columns directly
+      TS_ASSERT_EQUALS(el.getStorageLayout(), COLUMN_LAYOUT);
+      TS_ASSERT_EQUALS(el.getSortType(), TOF_SORT);
+    }
+  }
+
+  void test_columnLayout_maskTof_and_convertTof_allTypes() {
+    for (int this_type = 0; this_type < 3; this_type++) {
+      this->fake_uniform_data();
+      el.switchTo(static_cast<EventType>(this_type));
+      el.setStorageLayout(COLUMN_LAYOUT);
+      const double min = MAX_TOF * 0.25;
+      const double max = MAX_TOF * 0.5;
+      el.maskTof(min, max);
+      TS_ASSERT_EQUALS(el.getNumberEvents(), 0.75 * 2 * MAX_TOF / BIN_DELTA);
+      el.convertTof(2.0, 1.0);
+      TS_ASSERT_EQUALS(el.getStorageLayout(), COLUMN_LAYOUT);
+      TS_ASSERT_DELTA(el.getTofMin(), 2.0 * 100 + 1.0, 1e-9);
+      double sum(0), error(0);
+      el.integrate(0, 0, true, sum, error);
+      TS_ASSERT_DELTA(sum, 0.75 * 2 * MAX_TOF / BIN_DELTA, 1e-6);
+
+      for (std::size_t i = 0; i < el.getNumberEvents(); i++) {
+        const double tof = (el.getEvent(i).tof() - 1.0) / 2.0;
+        TS_ASSERT((tof < min) || (tof > max));
+      }
+      // getEvent() has no columnar implementation
+      TS_ASSERT_EQUALS(el.getStorageLayout(), ROW_LAYOUT);
+    }
+  }
+
+  void test_columnLayout_round_trip_keeps_events() {
+    this->fake_uniform_data_weights();
+    const std::vector<WeightedEvent> original = el.getWeightedEvents();
+    el.setStorageLayout(COLUMN_LAYOUT);
+    TS_ASSERT_EQUALS(el.getNumberEvents(), original.size());
+    TS_ASSERT_EQUALS(el.getEventType(), WEIGHTED);
+    EventList copy(el);
+    TS_ASSERT_EQUALS(copy.getStorageLayout(), COLUMN_LAYOUT);
+    TS_ASSERT_EQUALS(copy.getWeightedEvents(), original);
+    el.setStorageLayout(ROW_LAYOUT);
+    TS_ASSERT_EQUALS(el.getWeightedEvents(), original);
+  }
+
+  void test_columnLayout_appending_switches_back_to_rows() {
+    this->fake_uniform_data();
+    const size_t numEvents = el.getNumberEvents();
+    el.setStorageLayout(COLUMN_LAYOUT);
+    el += TofEvent(12.5, 34);
+    TS_ASSERT_EQUALS(el.getStorageLayout(), ROW_LAYOUT);
+    TS_ASSERT_EQUALS(el.getNumberEvents(), numEvents + 1);
+    TS_ASSERT_EQUALS(el.getEvents().back(), TofEvent(12.5, 34));
+  }
+
+  void test_columns_are_read_safely_while_another_thread_converts_them() {
+    for (const auto layout : {COLUMN_LAYOUT, COMPACT_LAYOUT}) {
+      this->fake_uniform_data();
+      this->test_setX();
+      MantidVec rowY, rowE;
+      el.generateHistogram(el.readX(), rowY, rowE);
+      const size_t numEvents = el.getNumberEvents();
+      el.setStorageLayout(layout);
+      const EventList &constList = el;
+      std::vector<MantidVec> Ys(8);
+      PARALLEL_FOR_NO_WSP_CHECK()
+      for (int i = 0; i < 8; ++i) {
+        // A const accessor without a columnar path moves the events back to
+        // rows while the other threads are histogramming the columns
+        if (i == 4)
+          TS_ASSERT_EQUALS(constList.getEvents().size(), numEvents);
+        MantidVec E;
+        constList.generateHistogram(constList.readX(), Ys[i], E);
+      }
+      for (const auto &Y : Ys)
+        TS_ASSERT_EQUALS(Y, rowY);
+      TS_ASSERT_EQUALS(el.getStorageLayout(), ROW_LAYOUT);
+    }
+  }
+
+  void test_compactLayout_histogram_all_types() {
+    for (int this_type = 0; this_type < 3; this_type++) {
+      this->fake_uniform_data();
+      el.switchTo(static_cast<EventType>(this_type));
+      this->test_setX();
+      MantidVec rowY, rowE;
+      el.generateHistogram(el.readX(), rowY, rowE);
+      double rowSum, rowError;
+      el.integrate(1000., 5000., false, rowSum, rowError);
+
+      this->fake_uniform_data();
+      el.switchTo(static_cast<EventType>(this_type));
+      this->test_setX();
+      el.setStorageLayout(COMPACT_LAYOUT);
+      TS_ASSERT_EQUALS(el.getStorageLayout(), COMPACT_LAYOUT);
+      MantidVec Y, E;
+      el.generateHistogram(el.readX(), Y, E);
+      TS_ASSERT_EQUALS(Y, rowY);
+      TS_ASSERT_EQUALS(E, rowE);
+      double sum, error;
+      el.integrate(1000., 5000., false, sum, error);
+      TS_ASSERT_EQUALS(sum, rowSum);
+      TS_ASSERT_DELTA(error, rowError, 1e-12);
+      TS_ASSERT_EQUALS(el.getTofMin(), 100.);
+      // The events are decoded on the fly
+      TS_ASSERT_EQUALS(el.getStorageLayout(), COMPACT_LAYOUT);
+      TS_ASSERT_EQUALS(el.getSortType(), TOF_SORT);
+    }
+  }
+
+  void test_compactLayout_round_trip_keeps_events() {
+    this->fake_uniform_data_weights();
+    const std::vector<WeightedEvent> original = el.getWeightedEvents();
+    const size_t rowMemory = el.getMemorySize();
+    el.setStorageLayout(COMPACT_LAYOUT);
+    TS_ASSERT_LESS_THAN(el.getMemorySize(), rowMemory);
+    TS_ASSERT_EQUALS(el.getNumberEvents(), original.size());
+    TS_ASSERT_EQUALS(el.getEventType(), WEIGHTED);
+    EventList copy(el);
+    TS_ASSERT_EQUALS(copy.getStorageLayout(), COMPACT_LAYOUT);
+    TS_ASSERT_EQUALS(copy.getWeightedEvents(), original);
+    TS_ASSERT_EQUALS(copy.getStorageLayout(), ROW_LAYOUT);
+    el.setStorageLayout(COLUMN_LAYOUT);
+    el.setStorageLayout(COMPACT_LAYOUT);
+    el.setStorageLayout(ROW_LAYOUT);
+    TS_ASSERT_EQUALS(el.getWeightedEvents(), original);
+  }
+
+  void test_compactLayout_filterByPulseTime() {
+    for (int this_type = 0; this_type < 2; this_type++) {
+      this->fake_data();
+      el.switchTo(static_cast<EventType>(this_type));
+      EventList rowOut;
+      el.filterByPulseTime(100, 200, rowOut);
+
+      el.setStorageLayout(COMPACT_LAYOUT);
+      EventList out;
+      el.filterByPulseTime(100, 200, out);
+      TS_ASSERT_EQUALS(el.getStorageLayout(), COMPACT_LAYOUT);
+      TS_ASSERT_EQUALS(out.getEventType(), rowOut.getEventType());
+      TS_ASSERT_EQUALS(out.getSortType(), PULSETIME_SORT);
+      TS_ASSERT_EQUALS(out.getNumberEvents(), rowOut.getNumberEvents());
+      TS_ASSERT_EQUALS(out.getPulseTimeMin(), rowOut.getPulseTimeMin());
+      TS_ASSERT_EQUALS(out.getPulseTimeMax(), rowOut.getPulseTimeMax());
+      auto tofs = out.getTofs();
+      auto rowTofs = rowOut.getTofs();
+      std::sort(tofs.begin(), tofs.end());
+      std::sort(rowTofs.begin(), rowTofs.end());
+      TS_ASSERT_EQUALS(tofs, rowTofs);
+    }
+  }
+
+  void test_singlePrecisionLayout_convertTof() {
+    for (int this_type = 0; this_type < 3; this_type++) {
+      this->fake_uniform_data();
+      el.switchTo(static_cast<EventType>(this_type));
+      const size_t rowMemory = el.getMemorySize();
+      EventList rows(el);
+      rows.convertTof(2.5, 6.78);
+
+      el.setStorageLayout(SINGLE_PRECISION_LAYOUT);
+      TS_ASSERT_LESS_THAN(el.getMemorySize(), rowMemory);
+      el.convertTof(2.5, 6.78);
+      TS_ASSERT_EQUALS(el.getStorageLayout(), SINGLE_PRECISION_LAYOUT);
+      TS_ASSERT_EQUALS(el.getNumberEvents(), rows.getNumberEvents());
+      const auto tofs = el.getTofs();
+      const auto rowTofs = rows.getTofs();
+      for (size_t i = 0; i < tofs.size(); ++i)
+        TS_ASSERT_EQUALS(tofs[i],
+                         static_cast<double>(static_cast<float>(rowTofs[i])));
+    }
+  }
+
+  void test_singlePrecisionLayout_convertUnitsQuickly_and_reverse() {
+    this->fake_uniform_data();
+    el.sortTof();
+    el.setStorageLayout(SINGLE_PRECISION_LAYOUT);
+    el.convertUnitsQuickly(1., -1.);
+    el.reverse();
+    TS_ASSERT_EQUALS(el.getStorageLayout(), SINGLE_PRECISION_LAYOUT);
+    TS_ASSERT_EQUALS(el.getSortType(), TOF_SORT);
+    const auto tofs = el.getTofs();
+    TS_ASSERT(std::is_sorted(tofs.cbegin(), tofs.cend()));
+    TS_ASSERT_EQUALS(el.getTofMax(),
+                     static_cast<double>(static_cast<float>(1. / 100.)));
+  }
+
+  void test_singlePrecisionLayout_expands_to_rows_to_scale_shift_and_split() {
+    // These operations have no columnar path: the events are moved back to
+    // rows first, and the results are those of the rounded events
+    this->fake_uniform_time_data();
+    el.setStorageLayout(SINGLE_PRECISION_LAYOUT);
+    EventList rows(el);
+    rows.setStorageLayout(ROW_LAYOUT);
+
+    EventList scaled(el);
+    EventList rowsScaled(rows);
+    scaled *= 3.;
+    rowsScaled *= 3.;
+    scaled /= 2.;
+    rowsScaled /= 2.;
+    TS_ASSERT_EQUALS(scaled.getStorageLayout(), ROW_LAYOUT);
+    TS_ASSERT_EQUALS(scaled.getWeightedEvents(),
+                     rowsScaled.getWeightedEvents());
+
+    EventList shifted(el);
+    EventList rowsShifted(rows);
+    shifted.addPulsetime(10.);
+    rowsShifted.addPulsetime(10.);
+    TS_ASSERT_EQUALS(shifted.getStorageLayout(), ROW_LAYOUT);
+    TS_ASSERT_EQUALS(shifted.getEvents(), rowsShifted.getEvents());
+
+    TimeSplitterType split;
+    split.push_back(SplittingInterval(100, 200, 0));
+    split.push_back(SplittingInterval(300, 350, 1));
+    EventList first, second, rowsFirst, rowsSecond;
+    el.splitByTime(split, {&first, &second});
+    rows.splitByTime(split, {&rowsFirst, &rowsSecond});
+    TS_ASSERT_EQUALS(el.getStorageLayout(), ROW_LAYOUT);
+    TS_ASSERT_EQUALS(first.getNumberEvents(), 100);
+    TS_ASSERT_EQUALS(first.getEvents(), rowsFirst.getEvents());
+    TS_ASSERT_EQUALS(second.getNumberEvents(), 50);
+    TS_ASSERT_EQUALS(second.getEvents(), rowsSecond.getEvents());
+  }
+
   //-----------------------------------------------------------------------------------------------
   void test_maskCondition_allTypes() {
     // Go through each possible EventType as the input
@@ -1641,6 +1906,45 @@ public:
     }
   }
 
+  void test_radix_sort_matches_comparison_sort() {
+    // Large enough for the radix sort to be used when selected
+    EventList source;
+    for (size_t i = 0; i < 200000; i++)
+      source += WeightedEvent((rand() % 200000) * 0.05, rand() % 1000,
+                              static_cast<double>(i), 1.0);
+
+    auto &config = ConfigService::Instance();
+    const std::string algorithm = config.getString("EventList.SortAlgorithm");
+    for (int this_type = 0; this_type < 3; this_type++) {
+      EventType curType = static_cast<EventType>(this_type);
+      EventList comparison(source);
+      comparison.switchTo(curType);
+      EventList radix(comparison);
+
+      config.setString("EventList.SortAlgorithm", "Comparison");
+      comparison.sortTof();
+      config.setString("EventList.SortAlgorithm", "Radix");
+      radix.sortTof();
+      TS_ASSERT_EQUALS(radix.getTofs(), comparison.getTofs());
+      TS_ASSERT(radix.isSortedByTof());
+
+      if (curType != WEIGHTED_NOTIME) {
+        radix.sortPulseTimeTOF();
+        for (size_t i = 1; i < radix.getNumberEvents(); i++) {
+          const auto previous = radix.getEvent(i - 1);
+          const auto current = radix.getEvent(i);
+          TS_ASSERT_LESS_THAN_EQUALS(previous.pulseTime(), current.pulseTime());
+          if (previous.pulseTime() == current.pulseTime())
+            TS_ASSERT_LESS_THAN_EQUALS(previous.tof(), current.tof());
+        }
+        radix.sortPulseTime();
+        const auto pulseTimes = radix.getPulseTimes();
+        TS_ASSERT(std::is_sorted(pulseTimes.begin(), pulseTimes.end()));
+      }
+    }
+    config.setString("EventList.SortAlgorithm", algorithm);
+  }
+
   //-----------------------------------------------------------------------------------------------
   void test_filterByPulseTime() {
     // Go through each possible EventType (except the no-time one) as the input
@@ -1921,6 +2225,29 @@ public:
     return;
   }
 
+  void test_splitByIndex() {
+    fake_uniform_time_sns_data();
+    el.switchTo(WEIGHTED);
+
+    EventList out2, out4;
+    EventSplitter splitter({1000000, 2000000, 3000000, 4000000, 5000000},
+                           {-1, 2, -1, 4});
+    // Events of target -1 are dropped
+    std::vector<EventList *> outputs{nullptr, &out2, &out4};
+    el.splitByIndex(splitter, outputs, EventSplitter::EventTime());
+
+    TS_ASSERT_EQUALS(out2.getEventType(), WEIGHTED);
+    TS_ASSERT_EQUALS(out2.getNumberEvents(), 1);
+    TS_ASSERT_EQUALS(out4.getNumberEvents(), 1);
+    TS_ASSERT_EQUALS(out2.getDetectorIDs(), el.getDetectorIDs());
+    TS_ASSERT_EQUALS(out2.getWeightedEvents()[0].pulseTime(),
+                     el.getWeightedEvents()[2].pulseTime());
+
+    TS_ASSERT_THROWS(
+        el.splitByIndex(splitter, {&out2}, EventSplitter::EventTime()),
+        std::invalid_argument);
+  }
+
   //-----------------------------------------------------------------------------------------------
   void test_splitByTime_allTypes() {
     // Go through each possible EventType as the input
@@ -2869,6 +3196,12 @@ public:
     // Coarse vector, 1000 bins.
     for (double i = 0; i < 100000; i += 100)
       coarseX.push_back(i);
+    // Logarithmic bins, 1% steps
+    for (double i = 1; i < 100000; i *= 1.01)
+      logX.push_back(i);
+    // The fine bins with one edge moved: the bins have to be searched
+    irregularX = fineX;
+    irregularX[1] = 0.5;
 
     // Create FrameworkManager such that the effect of config option
     // `MultiThreaded.MaxCores` is visible: The FrameworkManager sets the TBB
@@ -2881,6 +3214,8 @@ public:
       el_sorted_weighted, el4, el5;
   MantidVec fineX;
   MantidVec coarseX;
+  MantidVec logX;
+  MantidVec irregularX;
 
   void setUp() override {
     // Reset the random event list
@@ -2896,6 +3231,24 @@ public:
 
   void test_sort_tof() { el_random.sortTof(); }
 
+  void test_sort_tof_radix() {
+    auto &config = ConfigService::Instance();
+    const std::string algorithm = config.getString("EventList.SortAlgorithm");
+    config.setString("EventList.SortAlgorithm", "Radix");
+    el_random.sortTof();
+    config.setString("EventList.SortAlgorithm", algorithm);
+  }
+
+  void test_sort_pulse_time_tof() { el_random.sortPulseTimeTOF(); }
+
+  void test_sort_pulse_time_tof_radix() {
+    auto &config = ConfigService::Instance();
+    const std::string algorithm = config.getString("EventList.SortAlgorithm");
+    config.setString("EventList.SortAlgorithm", "Radix");
+    el_random.sortPulseTimeTOF();
+    config.setString("EventList.SortAlgorithm", algorithm);
+  }
+
   void test_compressEvents() {
     EventList out_el;
     el_sorted.compressEvents(10.0, &out_el);
@@ -2929,6 +3282,43 @@ public:
     el_sorted_weighted.generateHistogram(coarseX, Y, E);
   }
 
+  void test_histogram_log() {
+    MantidVec Y, E;
+    el_sorted.generateHistogram(logX, Y, E);
+  }
+
+  void test_histogram_fine_irregular() {
+    MantidVec Y, E;
+    el_sorted.generateHistogram(irregularX, Y, E);
+  }
+
+  void test_histogram_weighted_fine() {
+    MantidVec Y, E;
+    el_sorted_weighted.generateHistogram(fineX, Y, E);
+  }
+
+  void test_histogram_weighted_fine_irregular() {
+    MantidVec Y, E;
+    el_sorted_weighted.generateHistogram(irregularX, Y, E);
+  }
+
+  void test_histogram_fine_columns() {
+    MantidVec Y, E;
+    el_sorted.setStorageLayout(COLUMN_LAYOUT);
+    el_sorted.generateHistogram(fineX, Y, E);
+  }
+
+  void test_histogram_fine_compact() {
+    MantidVec Y, E;
+    el_sorted.setStorageLayout(COMPACT_LAYOUT);
+    el_sorted.generateHistogram(fineX, Y, E);
+  }
+
+  void test_convertTof_columns() {
+    el_sorted.setStorageLayout(COLUMN_LAYOUT);
+    el_sorted.convertTof(2.5, 6.78);
+  }
+
   void test_maskTof() {
     TS_ASSERT_EQUALS(el_sorted.getNumberEvents(), 10000000);
     el_sorted.maskTof(25e3, 75e3);
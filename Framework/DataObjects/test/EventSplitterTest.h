@@ -0,0 +1,272 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_EVENTSPLITTERTEST_H_
+#define MANTID_DATAOBJECTS_EVENTSPLITTERTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidDataObjects/EventSplitter.h"
+#include "MantidKernel/MultiThreaded.h"
+
+#include <algorithm>
+#include <memory>
+
+using Mantid::DataObjects::EventSplitter;
+using Mantid::Kernel::SplittingInterval;
+using Mantid::Kernel::TimeSplitterType;
+using Mantid::Types::Core::DateAndTime;
+using Mantid::Types::Event::TofEvent;
+
+namespace {
+/// Events at pulse times 0, 1, ... microseconds with tof 0
+std::vector<TofEvent> eventsAtPulses(const size_t numEvents) {
+  std::vector<TofEvent> events;
+  events.reserve(numEvents);
+  for (size_t i = 0; i < numEvents; ++i)
+    events.emplace_back(0., DateAndTime(static_cast<int64_t>(i) * 1000));
+  return events;
+}
+
+std::vector<std::vector<TofEvent> *>
+outputPointers(std::vector<std::vector<TofEvent>> &outputs) {
+  std::vector<std::vector<TofEvent> *> pointers;
+  for (auto &output : outputs)
+    pointers.push_back(&output);
+  return pointers;
+}
+} // namespace
+
+class EventSplitterTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static EventSplitterTest *createSuite() { return new EventSplitterTest(); }
+  static void destroySuite(EventSplitterTest *suite) { delete suite; }
+
+  void test_vector_constructor_numbers_targets() {
+    EventSplitter splitter({0, 10, 20, 30, 40}, {3, -1, 3, 1});
+    TS_ASSERT_EQUALS(splitter.numberOfIntervals(), 4);
+    TS_ASSERT_EQUALS(splitter.numberOfTargets(), 3);
+    TS_ASSERT_EQUALS(splitter.targets(), std::vector<int>({-1, 1, 3}));
+    TS_ASSERT_EQUALS(splitter.slotOf(-1), 0);
+    TS_ASSERT_EQUALS(splitter.slotOf(3), 2);
+    TS_ASSERT_EQUALS(splitter.slotOf(2), EventSplitter::NO_SLOT);
+  }
+
+  void test_vector_constructor_throws_on_bad_input() {
+    TS_ASSERT_THROWS(EventSplitter({0, 10}, {1, 2}), std::invalid_argument);
+    TS_ASSERT_THROWS(EventSplitter({0, 20, 10}, {1, 2}),
+                     std::invalid_argument);
+  }
+
+  void test_findSlot() {
+    EventSplitter splitter({0, 10, 20, 30}, {5, 6, 5});
+    TS_ASSERT_EQUALS(splitter.findSlot(-1), EventSplitter::NO_SLOT);
+    TS_ASSERT_EQUALS(splitter.findSlot(0), 0);
+    TS_ASSERT_EQUALS(splitter.findSlot(9), 0);
+    TS_ASSERT_EQUALS(splitter.findSlot(10), 1);
+    TS_ASSERT_EQUALS(splitter.findSlot(29), 0);
+    TS_ASSERT_EQUALS(splitter.findSlot(30), EventSplitter::NO_SLOT);
+  }
+
+  void test_no_targets_sends_everything_to_minus_one() {
+    EventSplitter splitter({}, {});
+    TS_ASSERT_EQUALS(splitter.targets(), std::vector<int>({-1}));
+    TS_ASSERT_EQUALS(splitter.findSlot(std::numeric_limits<int64_t>::min()),
+                     0);
+    TS_ASSERT_EQUALS(splitter.findSlot(123456789), 0);
+  }
+
+  void test_TimeSplitterType_fills_gaps_with_minus_one() {
+    TimeSplitterType splitters;
+    splitters.emplace_back(DateAndTime(int64_t(200)), DateAndTime(int64_t(300)),
+                           2);
+    splitters.emplace_back(DateAndTime(int64_t(100)), DateAndTime(int64_t(150)),
+                           1);
+    EventSplitter splitter(splitters);
+    TS_ASSERT_EQUALS(splitter.targets(), std::vector<int>({-1, 1, 2}));
+    TS_ASSERT_EQUALS(splitter.findSlot(50), splitter.slotOf(-1));
+    TS_ASSERT_EQUALS(splitter.findSlot(100), splitter.slotOf(1));
+    TS_ASSERT_EQUALS(splitter.findSlot(170), splitter.slotOf(-1));
+    TS_ASSERT_EQUALS(splitter.findSlot(299), splitter.slotOf(2));
+    TS_ASSERT_EQUALS(splitter.findSlot(300), EventSplitter::NO_SLOT);
+  }
+
+  void test_TimeSplitterType_trims_overlaps() {
+    TimeSplitterType splitters;
+    splitters.emplace_back(DateAndTime(int64_t(100)), DateAndTime(int64_t(300)),
+                           1);
+    splitters.emplace_back(DateAndTime(int64_t(200)), DateAndTime(int64_t(400)),
+                           2);
+    EventSplitter splitter(splitters);
+    TS_ASSERT_EQUALS(splitter.findSlot(250), splitter.slotOf(1));
+    TS_ASSERT_EQUALS(splitter.findSlot(300), splitter.slotOf(2));
+  }
+
+  void test_split() {
+    const auto events = eventsAtPulses(100);
+    // Intervals in nanoseconds: events every 1000 ns
+    EventSplitter splitter({10000, 20000, 30000, 50000}, {7, 8, 7});
+    std::vector<std::vector<TofEvent>> outputs(2);
+    splitter.split(events, EventSplitter::EventTime(), outputPointers(outputs));
+    TS_ASSERT_EQUALS(outputs[0].size(), 30);
+    TS_ASSERT_EQUALS(outputs[1].size(), 10);
+    TS_ASSERT_EQUALS(outputs[0].capacity(), 30);
+    TS_ASSERT_EQUALS(outputs[0][0].pulseTime(), DateAndTime(int64_t(10000)));
+    TS_ASSERT_EQUALS(outputs[0][10].pulseTime(), DateAndTime(int64_t(30000)));
+    TS_ASSERT_EQUALS(outputs[1][9].pulseTime(), DateAndTime(int64_t(29000)));
+  }
+
+  void test_split_drops_slots_without_output() {
+    const auto events = eventsAtPulses(100);
+    EventSplitter splitter({0, 50000, 100000}, {0, 1});
+    std::vector<TofEvent> output;
+    splitter.split(events, EventSplitter::EventTime(), {nullptr, &output});
+    TS_ASSERT_EQUALS(output.size(), 50);
+    TS_ASSERT_THROWS(
+        splitter.split(events, EventSplitter::EventTime(), {&output}),
+        std::invalid_argument);
+  }
+
+  void test_split_uses_tof_and_correction() {
+    // One event at pulse 0 with tof 15 microseconds
+    std::vector<TofEvent> events{TofEvent(15., DateAndTime(int64_t(0)))};
+    EventSplitter splitter({0, 10000, 20000}, {0, 1});
+    std::vector<std::vector<TofEvent>> outputs(2);
+
+    EventSplitter::EventTime eventTime;
+    splitter.split(events, eventTime, outputPointers(outputs));
+    TS_ASSERT_EQUALS(outputs[1].size(), 1);
+
+    eventTime.pulseTimeOnly = true;
+    splitter.split(events, eventTime, outputPointers(outputs));
+    TS_ASSERT_EQUALS(outputs[0].size(), 1);
+    TS_ASSERT_EQUALS(outputs[1].size(), 0);
+
+    eventTime.pulseTimeOnly = false;
+    eventTime.correctTof = true;
+    eventTime.tofFactor = 0.5;
+    eventTime.tofShift = 0.;
+    splitter.split(events, eventTime, outputPointers(outputs));
+    TS_ASSERT_EQUALS(outputs[0].size(), 1);
+
+    eventTime.tofShift = 1.E-5;
+    splitter.split(events, eventTime, outputPointers(outputs));
+    TS_ASSERT_EQUALS(outputs[1].size(), 1);
+  }
+
+  void test_split_unsorted_events() {
+    auto events = eventsAtPulses(100);
+    std::reverse(events.begin(), events.end());
+    EventSplitter splitter({0, 25000, 50000, 75000, 100000}, {0, 1, 0, 1});
+    std::vector<std::vector<TofEvent>> outputs(2);
+    splitter.split(events, EventSplitter::EventTime(), outputPointers(outputs));
+    TS_ASSERT_EQUALS(outputs[0].size(), 50);
+    TS_ASSERT_EQUALS(outputs[1].size(), 50);
+    // The original order is kept
+    TS_ASSERT_EQUALS(outputs[1][0].pulseTime(), DateAndTime(int64_t(99000)));
+  }
+
+  void test_partition() {
+    const auto events = eventsAtPulses(100);
+    EventSplitter splitter({10000, 20000, 30000, 50000}, {7, 8, 7});
+    std::vector<TofEvent> grouped;
+    std::vector<size_t> offsets;
+    splitter.partition(events, EventSplitter::EventTime(), grouped, offsets);
+    TS_ASSERT_EQUALS(grouped.size(), 40);
+    TS_ASSERT_EQUALS(offsets, std::vector<size_t>({0, 30, 40}));
+    TS_ASSERT_EQUALS(grouped[0].pulseTime(), DateAndTime(int64_t(10000)));
+    TS_ASSERT_EQUALS(grouped[30].pulseTime(), DateAndTime(int64_t(20000)));
+  }
+
+  void test_large_list_is_split_like_a_small_one() {
+    // Large enough to be split by several threads
+    const size_t numEvents = 2000000;
+    const auto events = eventsAtPulses(numEvents);
+    std::vector<int64_t> times;
+    std::vector<int> targets;
+    for (int64_t i = 0; i <= 1000; ++i)
+      times.push_back(i * 2000000);
+    for (int i = 0; i < 1000; ++i)
+      targets.push_back(i % 7);
+    EventSplitter splitter(times, targets);
+
+    std::vector<std::vector<TofEvent>> outputs(7);
+    splitter.split(events, EventSplitter::EventTime(), outputPointers(outputs));
+    size_t total = 0;
+    for (size_t slot = 0; slot < outputs.size(); ++slot) {
+      const auto &output = outputs[slot];
+      total += output.size();
+      TS_ASSERT(std::is_sorted(output.cbegin(), output.cend(),
+                               [](const TofEvent &a, const TofEvent &b) {
+                                 return a.pulseTime() < b.pulseTime();
+                               }));
+      for (const auto &event : output)
+        TS_ASSERT_EQUALS(
+            splitter.findSlot(event.pulseTime().totalNanoseconds()), slot);
+    }
+    TS_ASSERT_EQUALS(total, numEvents);
+  }
+
+  void test_large_list_with_fewer_threads_than_blocks() {
+    const size_t numEvents = 2000000;
+    const auto events = eventsAtPulses(numEvents);
+    EventSplitter splitter({0, 1000000000, 3000000000}, {1, 2});
+    std::vector<std::vector<TofEvent>> outputs(2);
+#ifdef _OPENMP
+    // Parallel regions get a single thread, whatever the number of blocks
+    const int maxActiveLevels = omp_get_max_active_levels();
+    omp_set_max_active_levels(0);
+#endif
+    splitter.split(events, EventSplitter::EventTime(), outputPointers(outputs));
+#ifdef _OPENMP
+    omp_set_max_active_levels(maxActiveLevels);
+#endif
+    TS_ASSERT_EQUALS(outputs[0].size(), 1000000);
+    TS_ASSERT_EQUALS(outputs[1].size(), 1000000);
+  }
+};
+
+class EventSplitterTestPerformance : public CxxTest::TestSuite {
+public:
+  static EventSplitterTestPerformance *createSuite() {
+    return new EventSplitterTestPerformance();
+  }
+  static void destroySuite(EventSplitterTestPerformance *suite) {
+    delete suite;
+  }
+
+  EventSplitterTestPerformance() : m_events(eventsAtPulses(20000000)) {
+    // Thousands of targets, each with many short intervals
+    std::vector<int64_t> times;
+    std::vector<int> targets;
+    for (int64_t i = 0; i <= 200000; ++i)
+      times.push_back(i * 100000);
+    for (int i = 0; i < 200000; ++i)
+      targets.push_back(i % 5000);
+    m_splitter = std::make_unique<EventSplitter>(times, targets);
+  }
+
+  void test_split_many_targets() {
+    std::vector<std::vector<TofEvent>> outputs(5000);
+    m_splitter->split(m_events, EventSplitter::EventTime(),
+                      outputPointers(outputs));
+  }
+
+  void test_partition_many_targets() {
+    std::vector<TofEvent> grouped;
+    std::vector<size_t> offsets;
+    m_splitter->partition(m_events, EventSplitter::EventTime(), grouped,
+                          offsets);
+  }
+
+private:
+  std::vector<TofEvent> m_events;
+  std::unique_ptr<EventSplitter> m_splitter;
+};
+
+#endif /* MANTID_DATAOBJECTS_EVENTSPLITTERTEST_H_ */
@@ -7,20 +7,78 @@
 #ifndef MANTID_DATAOBJECTS_EVENTWORKSPACEMRUTEST_H_
 #define MANTID_DATAOBJECTS_EVENTWORKSPACEMRUTEST_H_
 
-#include "MantidKernel/System.h"
-#include "MantidKernel/Timer.h"
+#include "MantidDataObjects/EventHistogramCache.h"
+#include "MantidDataObjects/EventWorkspace.h"
+#include "MantidKernel/MultiThreaded.h"
+#include "MantidTestHelpers/WorkspaceCreationHelper.h"
 #include <cxxtest/TestSuite.h>
 
-#include "MantidDataObjects/EventWorkspaceMRU.h"
+#include <cmath>
 
 using namespace Mantid::DataObjects;
 
+/** Checks that the histograms returned by reference from an EventWorkspace
+ * stay valid while the histogram cache evicts them.
+ */
 class EventWorkspaceMRUTest : public CxxTest::TestSuite {
 public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static EventWorkspaceMRUTest *createSuite() {
+    return new EventWorkspaceMRUTest();
+  }
+  static void destroySuite(EventWorkspaceMRUTest *suite) { delete suite; }
+
   void test_emptyList() {
-    EventWorkspaceMRU mru;
-    TS_ASSERT_THROWS_NOTHING(mru.MRUSize());
-    TS_ASSERT_EQUALS(mru.MRUSize(), 0);
+    EventHistogramCache cache;
+    TS_ASSERT_EQUALS(cache.size(), 0);
+  }
+
+  void test_reference_outlives_eviction() {
+    // 2 events in each of the 100 bins
+    EventWorkspace_const_sptr ws =
+        WorkspaceCreationHelper::createEventWorkspace2(200, 100);
+    ws->histogramCache().setMemoryLimit(0);
+
+    const auto &y = ws->readY(0);
+    const auto &e = ws->readE(0);
+    for (size_t i = 1; i < EventHistogramCache::PINNED_PER_THREAD; ++i)
+      ws->readY(i);
+    TS_ASSERT_LESS_THAN(0, ws->histogramCache().statistics().evictions);
+
+    TS_ASSERT_EQUALS(y.size(), 100);
+    TS_ASSERT_EQUALS(e.size(), 100);
+    TS_ASSERT_DELTA(y[99], 2.0, 1e-5);
+    TS_ASSERT_DELTA(e[99], M_SQRT2, 1e-5);
+  }
+
+  void test_concurrent_readers() {
+    const int numPixels = 2000;
+    const int numRead = 20;
+    EventWorkspace_const_sptr ws =
+        WorkspaceCreationHelper::createEventWorkspace2(numPixels, 100);
+    // Every histogram is evicted as soon as another one of its shard is read
+    ws->histogramCache().setMemoryLimit(0);
+
+    int failures(0);
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int i = 0; i < numPixels; ++i) {
+      const auto &y = ws->readY(i);
+      const auto &e = ws->readE(i);
+      // Evict histograms from the shards used by the other threads too
+      for (int j = 1; j < numRead; ++j)
+        ws->readY((i + j * 97) % numPixels);
+      bool valid = y.size() == 100 && e.size() == 100;
+      for (size_t bin = 0; valid && bin < y.size(); ++bin)
+        valid = std::abs(y[bin] - 2.0) < 1e-5 &&
+                std::abs(e[bin] - M_SQRT2) < 1e-5;
+      if (!valid) {
+        PARALLEL_ATOMIC
+        ++failures;
+      }
+    }
+    TS_ASSERT_EQUALS(failures, 0);
+    TS_ASSERT_LESS_THAN(0, ws->histogramCache().statistics().evictions);
   }
 };
 
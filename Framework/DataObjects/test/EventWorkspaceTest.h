@@ -23,6 +23,7 @@
 
 #include "MantidAPI/Axis.h"
 #include "MantidAPI/SpectrumInfo.h"
+#include "MantidDataObjects/EventHistogramCache.h"
 #include "MantidDataObjects/EventList.h"
 #include "MantidDataObjects/EventWorkspace.h"
 #include "MantidHistogramData/LinearGenerator.h"
@@ -348,27 +349,24 @@ public:
     data1 = ew2->dataY(0);
     TS_ASSERT_DELTA(ew2->dataY(0)[1], 2.0, 1e-6);
     TS_ASSERT_DELTA(data1[1], 2.0, 1e-6);
-    // Cache should now be full
-    TS_ASSERT_EQUALS(ew2->MRUSize(), 50);
+    // All of them fit in the cache
+    TS_ASSERT_EQUALS(ew2->MRUSize(), 100);
 
-    int last = 100;
-    // Read more;
-    for (int i = last; i < last + 100; i++)
+    // Reading them again is served from the cache
+    auto &cache = ew2->histogramCache();
+    cache.resetStatistics();
+    for (int i = 0; i < 100; i++)
       data1 = ew2->dataY(i);
+    TS_ASSERT_EQUALS(cache.statistics().hits, 100);
+    TS_ASSERT_EQUALS(cache.statistics().misses, 0);
 
-    // Cache should now be full still
-    TS_ASSERT_EQUALS(ew2->MRUSize(), 50);
-
-    // Do it some more
-    last = 200;
-    for (int i = last; i < last + 100; i++)
+    // Read more;
+    for (int i = 100; i < 300; i++)
       data1 = ew2->dataY(i);
+    TS_ASSERT_EQUALS(cache.statistics().misses, 200);
+    TS_ASSERT_EQUALS(ew2->MRUSize(), 300);
 
     //----- Now we test that setAllX clears the memory ----
-
-    // Yes, our eventworkspace MRU is full
-    TS_ASSERT_EQUALS(ew->MRUSize(), 50);
-    TS_ASSERT_EQUALS(ew2->MRUSize(), 50);
     ew->setAllX(BinEdges(10, LinearGenerator(0.0, BIN_DELTA)));
 
     // MRU should have been cleared now
@@ -529,28 +527,36 @@ public:
   }
 
   void test_droppingOffMRU() {
-    // Try caching and most-recently-used MRU list.
+    // Try caching with a memory limit too small for all the histograms
     EventWorkspace_const_sptr ew2 =
         boost::dynamic_pointer_cast<const EventWorkspace>(ew);
+    auto &cache = ew2->histogramCache();
+    cache.setMemoryLimit(0);
 
-    // OK, we grab data0 from the MRU.
-    const auto &inSpec = ew2->getSpectrum(0);
-    const auto &inSpec300 = ew2->getSpectrum(300);
-
-    const MantidVec &data0 = inSpec.readY();
-    const MantidVec &e300 = inSpec300.readE();
+    const MantidVec &data0 = ew2->getSpectrum(0).readY();
     TS_ASSERT_EQUALS(data0.size(), NUMBINS - 1);
 
-    // Fill up the MRU to make data0 drop off
-    for (size_t i = 0; i < 200; i++)
+    // Fill up the cache to make most histograms drop off
+    for (int i = 0; i < NUMPIXELS; i++)
       MantidVec otherData = ew2->readY(i);
 
-    // data0 and e300 are now invalid references!
-    TS_ASSERT_DIFFERS(&data0, &inSpec.readY());
-    TS_ASSERT_DIFFERS(&e300, &inSpec.readE());
+    // Only the most recent histogram of each shard is kept
+    TS_ASSERT_LESS_THAN_EQUALS(ew2->MRUSize(), 64);
+    TS_ASSERT_LESS_THAN(0, cache.statistics().evictions);
+  }
 
-    // MRU is full
-    TS_ASSERT_EQUALS(ew2->MRUSize(), 50);
+  void test_histogram_cache_invalidated_by_setX() {
+    EventWorkspace_const_sptr ew2 =
+        boost::dynamic_pointer_cast<const EventWorkspace>(ew);
+    auto &cache = ew2->histogramCache();
+    const auto before = ew2->readY(1);
+    TS_ASSERT_EQUALS(before.size(), NUMBINS - 1);
+
+    ew->getSpectrum(1).setHistogram(BinEdges(10, LinearGenerator(0.0, 1.0)));
+    cache.resetStatistics();
+    TS_ASSERT_EQUALS(ew2->readY(1).size(), 9);
+    TS_ASSERT_EQUALS(cache.statistics().misses, 1);
+    TS_ASSERT_EQUALS(cache.statistics().hits, 0);
   }
 
   void test_sortAll_TOF() {
@@ -0,0 +1,215 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_DATAOBJECTS_LAZYWORKSPACE2DTEST_H_
+#define MANTID_DATAOBJECTS_LAZYWORKSPACE2DTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidDataObjects/LazyHistogram1D.h"
+#include "MantidDataObjects/LazyWorkspace2D.h"
+#include "MantidHistogramData/LinearGenerator.h"
+#include "MantidKernel/MultiThreaded.h"
+#include "MantidKernel/make_unique.h"
+
+using namespace Mantid;
+using namespace Mantid::DataObjects;
+using namespace Mantid::HistogramData;
+
+namespace {
+/// Histogram i has all its counts equal to i
+class FakeSource : public HistogramSource {
+public:
+  FakeSource(const size_t size, const size_t blocksize)
+      : m_size(size), m_blocksize(blocksize) {}
+  size_t size() const override { return m_size; }
+  size_t blocksize() const override { return m_blocksize; }
+  size_t xLength() const override { return m_blocksize + 1; }
+  Histogram::YMode yMode() const override { return Histogram::YMode::Counts; }
+  Histogram histogram(const size_t index) override {
+    return Histogram(BinEdges(m_blocksize + 1, LinearGenerator(0., 1.)),
+                     Counts(m_blocksize, static_cast<double>(index)),
+                     CountStandardDeviations(m_blocksize, 1.));
+  }
+
+private:
+  size_t m_size;
+  size_t m_blocksize;
+};
+
+/// Memory used by one histogram of FakeSource
+size_t histogramBytes(const size_t blocksize) {
+  return (3 * blocksize + 1) * sizeof(double);
+}
+
+boost::shared_ptr<LazyWorkspace2D> createWorkspace(const size_t size,
+                                                   const size_t blocksize,
+                                                   const size_t budget) {
+  auto ws = boost::make_shared<LazyWorkspace2D>(
+      Kernel::make_unique<FakeSource>(size, blocksize), budget);
+  ws->initialize(size, blocksize + 1, blocksize);
+  return ws;
+}
+
+const LazyHistogram1D &lazySpectrum(const LazyWorkspace2D &ws,
+                                    const size_t index) {
+  return dynamic_cast<const LazyHistogram1D &>(ws.getSpectrum(index));
+}
+} // namespace
+
+class LazyWorkspace2DTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static LazyWorkspace2DTest *createSuite() { return new LazyWorkspace2DTest(); }
+  static void destroySuite(LazyWorkspace2DTest *suite) { delete suite; }
+
+  void test_nothing_is_read_on_creation() {
+    auto ws = createWorkspace(10, 3, 1024 * 1024);
+    TS_ASSERT_EQUALS(ws->id(), "Workspace2D");
+    TS_ASSERT_EQUALS(ws->getNumberHistograms(), 10);
+    TS_ASSERT_EQUALS(ws->blocksize(), 3);
+    TS_ASSERT_EQUALS(ws->size(), 30);
+    TS_ASSERT_EQUALS(ws->getSpectrum(4).getSpectrumNo(), 5);
+    TS_ASSERT_EQUALS(ws->pager().numberLoaded(), 0);
+    TS_ASSERT(!lazySpectrum(*ws, 0).isResident());
+  }
+
+  void test_spectra_are_read_on_first_access() {
+    auto ws = createWorkspace(10, 3, 1024 * 1024);
+    const auto &cws = *ws;
+    TS_ASSERT_EQUALS(cws.y(2)[0], 2.);
+    TS_ASSERT_EQUALS(cws.e(2)[1], 1.);
+    TS_ASSERT_EQUALS(cws.x(2)[3], 3.);
+    TS_ASSERT_EQUALS(cws.readY(7)[2], 7.);
+    TS_ASSERT_EQUALS(ws->pager().numberLoaded(), 2);
+    TS_ASSERT_EQUALS(ws->pager().residentMemory(), 2 * histogramBytes(3));
+    TS_ASSERT(lazySpectrum(*ws, 2).isResident());
+    TS_ASSERT(!lazySpectrum(*ws, 3).isResident());
+  }
+
+  void test_memory_budget_is_respected() {
+    const size_t budget = 100 * histogramBytes(5);
+    auto ws = createWorkspace(1000, 5, budget);
+    const auto &cws = *ws;
+    for (size_t i = 0; i < cws.getNumberHistograms(); ++i)
+      TS_ASSERT_EQUALS(cws.y(i)[4], static_cast<double>(i));
+    TS_ASSERT_EQUALS(ws->pager().numberResident(), 100);
+    TS_ASSERT_LESS_THAN_EQUALS(ws->pager().residentMemory(), budget);
+    TS_ASSERT(!lazySpectrum(*ws, 0).isResident());
+    TS_ASSERT(lazySpectrum(*ws, 999).isResident());
+
+    // Evicted spectra are read again
+    TS_ASSERT_EQUALS(cws.y(0)[0], 0.);
+    TS_ASSERT_EQUALS(ws->pager().numberLoaded(), 1001);
+  }
+
+  void test_minimum_number_of_spectra_is_kept() {
+    auto ws = createWorkspace(200, 5, 0);
+    const auto &cws = *ws;
+    for (size_t i = 0; i < cws.getNumberHistograms(); ++i)
+      cws.y(i);
+    TS_ASSERT_EQUALS(ws->pager().numberResident(),
+                     HistogramPager::MIN_RESIDENT);
+  }
+
+  void test_recently_used_spectra_get_a_second_chance() {
+    auto ws = createWorkspace(1000, 5, 10 * histogramBytes(5));
+    const auto &cws = *ws;
+    for (size_t i = 0; i < 1000; ++i) {
+      cws.y(i);
+      // Spectrum 0 is accessed all the time
+      cws.y(0);
+    }
+    TS_ASSERT(lazySpectrum(*ws, 0).isResident());
+  }
+
+  void test_reference_outlives_eviction() {
+    auto ws = createWorkspace(200, 5, 0);
+    const auto &cws = *ws;
+    const auto &y = cws.y(0);
+    const auto &x = cws.x(0);
+    for (size_t i = 1; i < LazyHistogram1D::PINNED_PER_THREAD; ++i)
+      cws.y(i);
+    TS_ASSERT(!lazySpectrum(*ws, 0).isResident());
+
+    TS_ASSERT_EQUALS(y.size(), 5);
+    TS_ASSERT_EQUALS(y[4], 0.);
+    TS_ASSERT_EQUALS(x[5], 5.);
+  }
+
+  void test_concurrent_readers() {
+    const int numSpectra = 1000;
+    const int numRead = 20;
+    auto ws = createWorkspace(numSpectra, 5, 0);
+    const auto &cws = *ws;
+
+    int failures(0);
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int i = 0; i < numSpectra; ++i) {
+      const auto &y = cws.y(i);
+      const auto &e = cws.e(i);
+      // Evict spectra read by the other threads too
+      for (int j = 1; j < numRead; ++j)
+        cws.y((i + j * 97) % numSpectra);
+      bool valid = y.size() == 5 && e.size() == 5;
+      for (size_t bin = 0; valid && bin < y.size(); ++bin)
+        valid = y[bin] == static_cast<double>(i) && e[bin] == 1.;
+      if (!valid) {
+        PARALLEL_ATOMIC
+        ++failures;
+      }
+    }
+    TS_ASSERT_EQUALS(failures, 0);
+    TS_ASSERT_EQUALS(ws->pager().numberResident(),
+                     HistogramPager::MIN_RESIDENT);
+  }
+
+  void test_modified_spectra_are_pinned() {
+    auto ws = createWorkspace(200, 5, 0);
+    ws->mutableY(3)[1] = 42.;
+    ws->setCounts(4, 5, 7.);
+    TS_ASSERT(lazySpectrum(*ws, 3).isPinned());
+    TS_ASSERT(lazySpectrum(*ws, 4).isPinned());
+    TS_ASSERT_EQUALS(ws->pager().residentMemory(), 0);
+
+    const auto &cws = *ws;
+    for (size_t i = 0; i < cws.getNumberHistograms(); ++i)
+      cws.y(i);
+    TS_ASSERT_EQUALS(cws.y(3)[0], 3.);
+    TS_ASSERT_EQUALS(cws.y(3)[1], 42.);
+    TS_ASSERT_EQUALS(cws.y(4)[0], 7.);
+    TS_ASSERT_EQUALS(cws.e(4)[0], 1.);
+  }
+
+  void test_clone() {
+    auto ws = createWorkspace(200, 5, 0);
+    ws->mutableY(3)[1] = 42.;
+    auto clone = ws->clone();
+    TS_ASSERT_EQUALS(&clone->pager(), &ws->pager());
+    TS_ASSERT(lazySpectrum(*clone, 3).isPinned());
+    TS_ASSERT(!lazySpectrum(*clone, 5).isResident());
+
+    clone->mutableY(3)[1] = 43.;
+    clone->mutableY(5)[1] = 44.;
+    const auto &cws = *ws;
+    TS_ASSERT_EQUALS(cws.y(3)[1], 42.);
+    TS_ASSERT_EQUALS(cws.y(5)[1], 5.);
+    TS_ASSERT_EQUALS(clone->y(3)[1], 43.);
+    TS_ASSERT_EQUALS(clone->y(5)[1], 44.);
+
+    ws.reset();
+    TS_ASSERT_EQUALS(clone->y(100)[0], 100.);
+  }
+
+  void test_size_must_match_the_source() {
+    LazyWorkspace2D ws(Kernel::make_unique<FakeSource>(10, 3), 0);
+    TS_ASSERT_THROWS(ws.initialize(10, 3, 3), const std::invalid_argument &);
+    TS_ASSERT_THROWS(ws.initialize(9, 4, 3), const std::invalid_argument &);
+  }
+};
+
+#endif /* MANTID_DATAOBJECTS_LAZYWORKSPACE2DTEST_H_ */
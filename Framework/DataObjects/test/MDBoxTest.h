@@ -19,6 +19,7 @@
 #include "MantidKernel/MultiThreaded.h"
 #include "MantidTestHelpers/MDEventsTestHelper.h"
 #include <Poco/File.h>
+#include <boost/make_shared.hpp>
 #include <cxxtest/TestSuite.h>
 #include <map>
 #include <memory>
@@ -642,6 +643,62 @@ public:
     b.reserveMemoryForLoad(3);
     TS_ASSERT_EQUALS(b.getEvents().capacity(), 3);
   }
+
+  void test_flat_event_store() {
+    BoxController_sptr sc(new BoxController(1));
+    std::vector<MDDimensionExtents<coord_t>> extents(1);
+    extents[0].setExtents(0, 10);
+    auto store = boost::make_shared<std::vector<MDLeanEvent<1>>>();
+    for (size_t i = 0; i < 10; i++)
+      store->emplace_back(static_cast<float>(i), 1.0f);
+    // The box holds the events 2 to 5 of the store
+    MDBox<MDLeanEvent<1>, 1> box(sc.get(), 1, extents, store,
+                                 store->cbegin() + 2, store->cbegin() + 6);
+    TS_ASSERT(box.hasFlatEvents());
+    TS_ASSERT_EQUALS(box.getNPoints(), 4);
+    TS_ASSERT_EQUALS(box.getDataInMemorySize(), 4);
+    TS_ASSERT_DELTA(box.getSignal(), 2 + 3 + 4 + 5, 1e-5);
+    TS_ASSERT_DELTA(box.getErrorSquared(), 4, 1e-5);
+
+    // The range points into the store: nothing is copied
+    const auto events = box.getConstEventRange();
+    TS_ASSERT_EQUALS(events.size(), 4);
+    TS_ASSERT_EQUALS(events.begin(), store->data() + 2);
+    box.releaseEvents();
+    TS_ASSERT(box.hasFlatEvents());
+
+    std::unique_ptr<std::vector<MDLeanEvent<1>>> copy(box.getEventsCopy());
+    TS_ASSERT_EQUALS(copy->size(), 4);
+    TS_ASSERT_DELTA((*copy)[3].getSignal(), 5.0, 1e-5);
+  }
+
+  void test_flat_event_store_is_copied_when_events_are_added() {
+    BoxController_sptr sc(new BoxController(1));
+    std::vector<MDDimensionExtents<coord_t>> extents(1);
+    extents[0].setExtents(0, 10);
+    auto store = boost::make_shared<std::vector<MDLeanEvent<1>>>(
+        3, MDLeanEvent<1>(2.0f, 1.0f));
+    MDBox<MDLeanEvent<1>, 1> box(sc.get(), 1, extents, store, store->cbegin(),
+                                 store->cend());
+    // A copy of the box shares the store
+    MDBox<MDLeanEvent<1>, 1> boxCopy(box, sc.get());
+    TS_ASSERT(boxCopy.hasFlatEvents());
+    TS_ASSERT_EQUALS(boxCopy.getNPoints(), 3);
+
+    box.addEvent(MDLeanEvent<1>(4.0f, 1.0f));
+    TS_ASSERT(!box.hasFlatEvents());
+    TS_ASSERT_EQUALS(box.getNPoints(), 4);
+    box.refreshCache();
+    TS_ASSERT_DELTA(box.getSignal(), 10.0, 1e-5);
+    // The store and the other box are unchanged
+    TS_ASSERT_EQUALS(store->size(), 3);
+    TS_ASSERT_EQUALS(boxCopy.getNPoints(), 3);
+
+    // Getting the events as a vector copies them out of the store
+    TS_ASSERT_EQUALS(boxCopy.getConstEvents().size(), 3);
+    TS_ASSERT(!boxCopy.hasFlatEvents());
+    boxCopy.releaseEvents();
+  }
 };
 
 #endif
@@ -1104,6 +1104,85 @@ public:
     delete bcc;
   }
 
+  //------------------------------------------------------------------------------------------------
+  /** Adding a batch of events splits the boxes in the same way as adding them
+   * one by one and then splitting, and rejects the events out of bounds.
+   */
+  void test_addEventsAndSplit() {
+    using gbox_t = MDGridBox<MDLeanEvent<2>, 2>;
+    using ibox_t = MDBoxBase<MDLeanEvent<2>, 2>;
+
+    gbox_t *b = MDEventsTestHelper::makeMDGridBox<2>();
+    b->getBoxController()->setSplitThreshold(100);
+    b->getBoxController()->setMaxDepth(4);
+
+    // 1000 events in the middle of each sub-box
+    const size_t num_repeat = 1000;
+    std::vector<MDLeanEvent<2>> events;
+    for (size_t i = 0; i < 10; i++) {
+      for (size_t j = 0; j < 10; j++) {
+        const coord_t centers[2] = {static_cast<coord_t>(i) + 0.5f,
+                                    static_cast<coord_t>(j) + 0.5f};
+        for (size_t k = 0; k < num_repeat; k++)
+          events.emplace_back(2.0f, 2.0f, centers);
+      }
+    }
+    // and a few outside of the box
+    const coord_t outside[2] = {-1.0f, 5.0f};
+    events.emplace_back(2.0f, 2.0f, outside);
+    const coord_t upperEdge[2] = {5.0f, 10.0f};
+    events.emplace_back(2.0f, 2.0f, upperEdge);
+
+    size_t numRejected(0);
+    TS_ASSERT_THROWS_NOTHING(numRejected = b->addEventsAndSplit(events));
+    TS_ASSERT_EQUALS(numRejected, 2);
+    b->refreshCache();
+    TS_ASSERT_EQUALS(b->getNPoints(), 100 * num_repeat);
+    TS_ASSERT_DELTA(b->getSignal(), 2.0 * 100 * num_repeat, 1e-3);
+
+    std::vector<ibox_t *> boxes = b->getBoxes();
+    TS_ASSERT_EQUALS(boxes.size(), 100);
+    for (auto box : boxes) {
+      TS_ASSERT_EQUALS(box->getNPoints(), num_repeat);
+      TS_ASSERT(dynamic_cast<gbox_t *>(box));
+    }
+
+    BoxController *const bcc = b->getBoxController();
+    delete b;
+    delete bcc;
+  }
+
+  /** Events which cannot be separated are split down to the maximum depth */
+  void test_addEventsAndSplit_stops_at_max_depth() {
+    using gbox_t = MDGridBox<MDLeanEvent<2>, 2>;
+    using ibox_t = MDBoxBase<MDLeanEvent<2>, 2>;
+
+    gbox_t *b0 = MDEventsTestHelper::makeMDGridBox<2>();
+    b0->getBoxController()->setSplitThreshold(100);
+    b0->getBoxController()->setMaxDepth(4);
+
+    const size_t num_repeat = 1000;
+    const coord_t centers[2] = {1e-10f, 1e-10f};
+    std::vector<MDLeanEvent<2>> events(num_repeat,
+                                       MDLeanEvent<2>(2.0f, 2.0f, centers));
+    TS_ASSERT_EQUALS(b0->addEventsAndSplit(events), 0);
+    b0->refreshCache();
+
+    size_t depth = 0;
+    ibox_t *box = b0;
+    while (auto gridBox = dynamic_cast<gbox_t *>(box)) {
+      ++depth;
+      box = gridBox->getBoxes()[0];
+      TS_ASSERT_EQUALS(box->getNPoints(), num_repeat);
+    }
+    TS_ASSERT_EQUALS(depth, 4);
+    TS_ASSERT_EQUALS(box->getDepth(), 4);
+
+    BoxController *const bcc = b0->getBoxController();
+    delete b0;
+    delete bcc;
+  }
+
   //------------------------------------------------------------------------------------------------
   /** Helper to make a 2D MDBin */
   MDBin<MDLeanEvent<2>, 2> makeMDBin2(double minX, double maxX, double minY,
@@ -0,0 +1,61 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_KERNEL_CHARCONV_H_
+#define MANTID_KERNEL_CHARCONV_H_
+
+#include "MantidKernel/DllConfig.h"
+
+#include <cstdint>
+#include <string>
+
+namespace Mantid {
+namespace Kernel {
+
+/** Conversions between numbers and text for the ASCII file formats, in the
+  spirit of std::from_chars and std::to_chars. They work on character ranges
+  without streams, locales or allocations, and are safe to call from several
+  threads.
+
+  The numbers are written exactly as an std::ostream would write them with
+  the same precision, width and floatfield flags, so the files do not change.
+*/
+namespace CharConv {
+
+/// How a floating point number is written, as the std::ios floatfield flags
+enum class FloatFormat {
+  General,   ///< Neither std::fixed nor std::scientific
+  Fixed,     ///< std::fixed
+  Scientific ///< std::scientific
+};
+
+/// Parse a floating point number at the start of [first, last)
+MANTID_KERNEL_DLL const char *fromChars(const char *first, const char *last,
+                                        double &value);
+/// Parse a decimal integer at the start of [first, last)
+MANTID_KERNEL_DLL const char *fromChars(const char *first, const char *last,
+                                        int64_t &value);
+
+/// Write a floating point number to [first, last)
+MANTID_KERNEL_DLL char *toChars(char *first, char *last, double value,
+                                FloatFormat format, int precision,
+                                int width = 0);
+/// Write a decimal integer to [first, last)
+MANTID_KERNEL_DLL char *toChars(char *first, char *last, int64_t value,
+                                int width = 0);
+
+/// Append a floating point number to a string
+MANTID_KERNEL_DLL void append(std::string &out, double value,
+                              FloatFormat format, int precision,
+                              int width = 0);
+/// Append a decimal integer to a string
+MANTID_KERNEL_DLL void append(std::string &out, int64_t value, int width = 0);
+
+} // namespace CharConv
+} // namespace Kernel
+} // namespace Mantid
+
+#endif /* MANTID_KERNEL_CHARCONV_H_ */
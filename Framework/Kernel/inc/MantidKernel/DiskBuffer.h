@@ -58,6 +58,23 @@ public:
   /// A way to index the free space by their size
   using freeSpace_bySize_t = freeSpace_t::nth_index<1>::type;
 
+  /** Counts of the disk operations made through the buffer. Data amounts are
+   * in the units of the buffer (events for MD boxes). */
+  struct IOStatistics {
+    /// Number of objects written to the file
+    uint64_t objectsWritten = 0;
+    /// Amount of data written to the file
+    uint64_t dataWritten = 0;
+    /// Number of unchanged objects dropped from memory without writing
+    uint64_t objectsDiscarded = 0;
+    /// Number of objects loaded ahead of their use by a DiskPrefetcher
+    uint64_t objectsPrefetched = 0;
+    /// Amount of data loaded ahead of its use by a DiskPrefetcher
+    uint64_t dataPrefetched = 0;
+    /// Number of times a consumer had to wait for an object to be prefetched
+    uint64_t prefetchWaits = 0;
+  };
+
   DiskBuffer();
   DiskBuffer(uint64_t m_writeBufferSize);
   DiskBuffer(const DiskBuffer &) = delete;
@@ -81,6 +98,8 @@ public:
   void getFreeSpaceVector(std::vector<uint64_t> &free) const;
   void setFreeSpaceVector(std::vector<uint64_t> &free);
   std::string getMemoryStr() const;
+  IOStatistics getIOStatistics() const;
+  void resetIOStatistics();
 
   //-------------------------------------------------------------------------------------------
   /** Set the size of the to-write buffer, in number of events
@@ -118,6 +137,7 @@ public:
 
 protected:
   inline void writeOldObjects();
+  void recordWrite(uint64_t size);
 
   // ----------------------- To-write buffer
   // --------------------------------------
@@ -135,7 +155,10 @@ protected:
   std::list<ISaveable *> m_toWriteBuffer;
 
   /// Mutex for modifying the the toWrite buffer.
-  std::mutex m_mutex;
+  mutable std::mutex m_mutex;
+
+  /// Counts of the disk operations, guarded by m_mutex
+  IOStatistics m_statistics;
 
   // ----------------------- Free space map
   // --------------------------------------
@@ -153,6 +176,8 @@ protected:
   mutable uint64_t m_fileLength;
 
 private:
+  /// the prefetcher marks the objects it loads busy under m_mutex
+  friend class DiskPrefetcher;
 };
 
 } // namespace Kernel
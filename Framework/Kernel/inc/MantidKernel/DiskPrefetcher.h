@@ -0,0 +1,86 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_KERNEL_DISKPREFETCHER_H_
+#define MANTID_KERNEL_DISKPREFETCHER_H_
+
+#include "MantidKernel/System.h"
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Mantid {
+namespace Kernel {
+
+class DiskBuffer;
+class ISaveable;
+
+/** Loads file-backed objects on a background thread ahead of their use.
+
+  The objects are given in the order in which a consumer will use them.
+  A background thread loads them in that order, keeping at most a given
+  amount of data loaded but not yet used, so that reading the file overlaps
+  with the work done on the objects already in memory.
+
+  The consumer calls waitFor() before it uses an object and release() once it
+  has finished with it. A prefetched object is marked busy until it is
+  released, so that the DiskBuffer does not write it out or drop it from
+  memory in the meantime; on release it is handed to the DiskBuffer which may
+  then evict it as usual.
+
+  The amounts of data prefetched are recorded in the IOStatistics of the
+  DiskBuffer.
+*/
+class DLLExport DiskPrefetcher {
+public:
+  DiskPrefetcher(DiskBuffer &buffer, std::vector<ISaveable *> items,
+                 uint64_t maxDataAhead);
+  DiskPrefetcher(const DiskPrefetcher &) = delete;
+  DiskPrefetcher &operator=(const DiskPrefetcher &) = delete;
+  ~DiskPrefetcher();
+
+  void waitFor(size_t index);
+  void release(size_t index);
+
+private:
+  void run();
+  void handBack(ISaveable *item);
+
+  /// The buffer tracking the objects in memory
+  DiskBuffer &m_buffer;
+  /// The objects to load, in order of use. May contain nullptr.
+  const std::vector<ISaveable *> m_items;
+  /// Amount of data which may be loaded but not yet released
+  const uint64_t m_maxDataAhead;
+
+  /// Protects the members below
+  std::mutex m_mutex;
+  /// Signalled when an object has been loaded
+  std::condition_variable m_loaded;
+  /// Signalled when an object has been released or the loading should stop
+  std::condition_variable m_released;
+  /// Index of the first object not yet processed by the loading thread
+  size_t m_nextToLoad;
+  /// Amount of data loaded by the thread and not yet released
+  uint64_t m_dataAhead;
+  /// Size of each object loaded by the thread, 0 when not prefetched
+  std::vector<uint64_t> m_prefetchedSize;
+  /// Set to stop the loading thread
+  bool m_stop;
+  /// An exception thrown by the loading thread, rethrown by waitFor()
+  std::exception_ptr m_error;
+
+  /// The loading thread. Declared last so it starts with the state above.
+  std::thread m_thread;
+};
+
+} // namespace Kernel
+} // namespace Mantid
+
+#endif /* MANTID_KERNEL_DISKPREFETCHER_H_ */
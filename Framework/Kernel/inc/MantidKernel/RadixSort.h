@@ -0,0 +1,179 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_KERNEL_RADIXSORT_H_
+#define MANTID_KERNEL_RADIXSORT_H_
+
+#include "MantidKernel/MultiThreaded.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Mantid {
+namespace Kernel {
+
+/** @file RadixSort.h
+
+  A parallel least-significant-digit radix sort for large vectors whose sort
+  key can be mapped to an unsigned 64-bit integer, such as time-of-flight
+  (double or float) and pulse time (int64 nanoseconds) of events.
+
+  The keys are processed 11 bits at a time. Digits that are identical for all
+  keys (e.g. the high bits of pulse times within one run) are detected up
+  front and skipped, as is the whole sort if the vector is already sorted.
+  Each pass splits the vector into chunks that are counted and scattered by
+  separate threads, so a single large vector is sorted on all cores. The
+  sort is stable, which allows sorting by several keys by sorting by the
+  least significant key first.
+
+  The sort needs a temporary buffer of the same size as the input.
+*/
+
+namespace RadixSortDetail {
+/// Bit that is set for the sign of a 64-bit value
+constexpr uint64_t SIGN_BIT_64 = uint64_t(1) << 63;
+/// Bit that is set for the sign of a 32-bit value
+constexpr uint32_t SIGN_BIT_32 = uint32_t(1) << 31;
+/// Number of bits sorted in one pass
+constexpr int BITS_PER_PASS = 11;
+/// Number of buckets in one pass
+constexpr size_t NUM_BUCKETS = size_t(1) << BITS_PER_PASS;
+/// Minimum number of values handled by one thread
+constexpr size_t MIN_VALUES_PER_CHUNK = 65536;
+} // namespace RadixSortDetail
+
+/** Map a double onto an unsigned integer with the same ordering. NaN values
+ * are placed after +infinity (or before -infinity for negative NaN).
+ * @param value :: the value to map
+ * @return the radix sort key
+ */
+inline uint64_t radixSortKey(const double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (bits & RadixSortDetail::SIGN_BIT_64)
+             ? ~bits
+             : (bits | RadixSortDetail::SIGN_BIT_64);
+}
+
+/** Map a float onto an unsigned integer with the same ordering.
+ * @param value :: the value to map
+ * @return the radix sort key
+ */
+inline uint64_t radixSortKey(const float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (bits & RadixSortDetail::SIGN_BIT_32)
+             ? ~bits
+             : (bits | RadixSortDetail::SIGN_BIT_32);
+}
+
+/** Map a signed integer onto an unsigned integer with the same ordering.
+ * @param value :: the value to map
+ * @return the radix sort key
+ */
+inline uint64_t radixSortKey(const int64_t value) {
+  return static_cast<uint64_t>(value) ^ RadixSortDetail::SIGN_BIT_64;
+}
+
+/** Sort a vector in increasing order of a key, keeping the relative order of
+ * values with equal keys.
+ *
+ * @param values :: the vector to sort in place
+ * @param key :: function returning the unsigned key of a value, usually by
+ * calling radixSortKey()
+ */
+template <class T, class KeyFunction>
+void radixSort(std::vector<T> &values, KeyFunction key) {
+  using namespace RadixSortDetail;
+  const size_t numValues = values.size();
+  if (numValues < 2)
+    return;
+
+  const int numChunks = static_cast<int>(std::max(
+      size_t(1), std::min(static_cast<size_t>(PARALLEL_GET_MAX_THREADS),
+                          numValues / MIN_VALUES_PER_CHUNK)));
+  const auto chunkStart = [numValues, numChunks](const int chunk) {
+    return numValues * static_cast<size_t>(chunk) /
+           static_cast<size_t>(numChunks);
+  };
+
+  // Find the bits that differ between keys: the other digits need no pass.
+  // Check at the same time whether the values are already sorted.
+  std::vector<uint64_t> chunkBits(numChunks, 0);
+  std::vector<char> chunkSorted(numChunks, 1);
+  const uint64_t firstKey = key(values.front());
+  PARALLEL_FOR_IF(numChunks > 1)
+  for (int chunk = 0; chunk < numChunks; ++chunk) {
+    uint64_t bits = 0;
+    bool sorted = true;
+    const size_t start = chunkStart(chunk);
+    uint64_t previous = key(values[start > 0 ? start - 1 : 0]);
+    for (size_t i = start; i < chunkStart(chunk + 1); ++i) {
+      const uint64_t current = key(values[i]);
+      bits |= current ^ firstKey;
+      sorted &= previous <= current;
+      previous = current;
+    }
+    chunkBits[chunk] = bits;
+    chunkSorted[chunk] = sorted;
+  }
+  uint64_t differingBits = 0;
+  for (const auto bits : chunkBits)
+    differingBits |= bits;
+  if (std::all_of(chunkSorted.cbegin(), chunkSorted.cend(),
+                  [](const char sorted) { return sorted != 0; }))
+    return;
+
+  std::vector<T> buffer(numValues);
+  T *source = values.data();
+  T *destination = buffer.data();
+  // Counts, then write positions, of each bucket for each chunk
+  std::vector<size_t> offsets(numChunks * NUM_BUCKETS);
+
+  for (int shift = 0; shift < 64; shift += BITS_PER_PASS) {
+    if (((differingBits >> shift) & (NUM_BUCKETS - 1)) == 0)
+      continue;
+
+    PARALLEL_FOR_IF(numChunks > 1)
+    for (int chunk = 0; chunk < numChunks; ++chunk) {
+      size_t *counts = offsets.data() + chunk * NUM_BUCKETS;
+      std::fill(counts, counts + NUM_BUCKETS, size_t(0));
+      for (size_t i = chunkStart(chunk); i < chunkStart(chunk + 1); ++i)
+        ++counts[(key(source[i]) >> shift) & (NUM_BUCKETS - 1)];
+    }
+
+    // Each chunk writes its values of a bucket after those of the previous
+    // chunks, which keeps the sort stable.
+    size_t position = 0;
+    for (size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+      for (int chunk = 0; chunk < numChunks; ++chunk) {
+        size_t &offset = offsets[chunk * NUM_BUCKETS + bucket];
+        const size_t count = offset;
+        offset = position;
+        position += count;
+      }
+    }
+
+    PARALLEL_FOR_IF(numChunks > 1)
+    for (int chunk = 0; chunk < numChunks; ++chunk) {
+      size_t *positions = offsets.data() + chunk * NUM_BUCKETS;
+      for (size_t i = chunkStart(chunk); i < chunkStart(chunk + 1); ++i)
+        destination[positions[(key(source[i]) >> shift) &
+                              (NUM_BUCKETS - 1)]++] = source[i];
+    }
+    std::swap(source, destination);
+  }
+
+  if (source != values.data())
+    values.swap(buffer);
+}
+
+} // namespace Kernel
+} // namespace Mantid
+
+#endif /* MANTID_KERNEL_RADIXSORT_H_ */
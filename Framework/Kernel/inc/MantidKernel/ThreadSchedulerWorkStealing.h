@@ -0,0 +1,170 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_KERNEL_THREADSCHEDULERWORKSTEALING_H_
+#define MANTID_KERNEL_THREADSCHEDULERWORKSTEALING_H_
+
+#include "MantidKernel/DllConfig.h"
+#include "MantidKernel/ThreadScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Mantid {
+namespace Kernel {
+
+/** ThreadSchedulerWorkStealing : A scheduler with one queue of tasks per
+ * thread. The tasks are pushed to the queues in turn. A thread runs the
+ * tasks of its own queue, last in first out, and when it runs out of tasks
+ * it steals the oldest task of the queue holding the largest cost.
+ *
+ * Tasks may push new tasks while they run, e.g. to split their work or to
+ * merge the results of several tasks. For this reason the scheduler is only
+ * empty once no task is queued and none is running: the threads of a
+ * ThreadPool wait for the running tasks instead of exiting.
+ *
+ * Each queue has its own lock, so threads that run their own tasks do not
+ * contend with each other.
+ */
+class DLLExport ThreadSchedulerWorkStealing : public ThreadScheduler {
+public:
+  /// @param numThreads :: the number of threads popping tasks
+  explicit ThreadSchedulerWorkStealing(const size_t numThreads) {
+    for (size_t i = 0; i < std::max(numThreads, size_t{1}); ++i)
+      m_queues.emplace_back(new Queue);
+  }
+
+  ~ThreadSchedulerWorkStealing() override { clear(); }
+
+  //-------------------------------------------------------------------------------
+  void push(Task *newTask) override {
+    {
+      std::lock_guard<std::mutex> lock(m_queueLock);
+      m_cost += newTask->cost();
+    }
+    auto &queue = *m_queues[m_next++ % m_queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(newTask);
+    queue.cost += newTask->cost();
+    ++m_numQueued;
+  }
+
+  //-------------------------------------------------------------------------------
+  Task *pop(size_t threadnum) override {
+    const size_t own = threadnum % m_queues.size();
+    Task *task = popBack(*m_queues[own]);
+    if (!task) {
+      // Steal from the queue with the most work left
+      size_t victim = own;
+      double largest = 0.;
+      for (size_t i = 0; i < m_queues.size(); ++i) {
+        std::lock_guard<std::mutex> lock(m_queues[i]->mutex);
+        if (!m_queues[i]->tasks.empty() && m_queues[i]->cost >= largest) {
+          largest = m_queues[i]->cost;
+          victim = i;
+        }
+      }
+      if (victim != own)
+        task = popFront(*m_queues[victim]);
+    }
+    return task;
+  }
+
+  //-----------------------------------------------------------------------------------
+  /** Signal to the scheduler that a task is complete.
+   *
+   * @param task :: the Task that was completed.
+   * @param threadnum :: unused argument
+   */
+  void finished(Task *task, size_t threadnum) override {
+    UNUSED_ARG(threadnum);
+    {
+      std::lock_guard<std::mutex> lock(m_queueLock);
+      m_costExecuted += task->cost();
+    }
+    --m_numRunning;
+  }
+
+  //-------------------------------------------------------------------------------
+  /// @return the number of tasks waiting in the queues
+  size_t size() override { return m_numQueued; }
+
+  //-------------------------------------------------------------------------------
+  /// @return true if no task is queued or running
+  bool empty() override { return m_numQueued == 0 && m_numRunning == 0; }
+
+  //-------------------------------------------------------------------------------
+  void clear() override {
+    for (auto &queue : m_queues) {
+      std::lock_guard<std::mutex> lock(queue->mutex);
+      for (auto task : queue->tasks)
+        delete task;
+      m_numQueued -= queue->tasks.size();
+      queue->tasks.clear();
+      queue->cost = 0.;
+    }
+    std::lock_guard<std::mutex> lock(m_queueLock);
+    m_cost = 0;
+    m_costExecuted = 0;
+  }
+
+protected:
+  /// The tasks of one thread
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task *> tasks;
+    /// Total cost of the tasks
+    double cost{0.};
+  };
+
+  /// Take the newest task of a queue, or nullptr
+  Task *popBack(Queue &queue) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+      return nullptr;
+    Task *task = queue.tasks.back();
+    queue.tasks.pop_back();
+    taken(queue, *task);
+    return task;
+  }
+
+  /// Take the oldest task of a queue, or nullptr
+  Task *popFront(Queue &queue) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+      return nullptr;
+    Task *task = queue.tasks.front();
+    queue.tasks.pop_front();
+    taken(queue, *task);
+    return task;
+  }
+
+  /// Account for a task taken out of a queue, with the lock of the queue held
+  void taken(Queue &queue, Task &task) {
+    queue.cost = queue.tasks.empty() ? 0. : queue.cost - task.cost();
+    // Counted as running before it stops being queued, so that empty() is
+    // never true in between
+    ++m_numRunning;
+    --m_numQueued;
+  }
+
+  /// One queue per thread
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  /// Queue the next task is pushed to
+  std::atomic<size_t> m_next{0};
+  /// Number of tasks in the queues
+  std::atomic<size_t> m_numQueued{0};
+  /// Number of tasks popped but not finished
+  std::atomic<size_t> m_numRunning{0};
+};
+
+} // namespace Kernel
+} // namespace Mantid
+
+#endif /* MANTID_KERNEL_THREADSCHEDULERWORKSTEALING_H_ */
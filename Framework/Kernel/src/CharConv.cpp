@@ -0,0 +1,466 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidKernel/CharConv.h"
+#include "MantidKernel/System.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+// The numeric locale is set to "C" by the FrameworkManager, so strtod and
+// snprintf use '.' as the decimal point, as the streams do.
+
+namespace Mantid {
+namespace Kernel {
+namespace CharConv {
+
+namespace {
+/// The powers of ten that are exactly representable as a double
+constexpr double EXACT_POWERS_OF_TEN[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+constexpr int MAX_EXACT_POWER = 22;
+/// The largest integer below which all integers are exact doubles
+constexpr uint64_t MAX_EXACT_MANTISSA = uint64_t{1} << 53;
+/// Significant digits that always fit in the 64 bit mantissa
+constexpr int MAX_MANTISSA_DIGITS = 19;
+
+inline bool isDigit(const char c) { return c >= '0' && c <= '9'; }
+
+/// @return true if [first, last) starts with word, ignoring the case
+bool startsWith(const char *first, const char *last, const char *word) {
+  for (; *word; ++first, ++word) {
+    if (first == last || (*first | 0x20) != *word)
+      return false;
+  }
+  return true;
+}
+
+/// Parse "inf", "infinity" or "nan", in any case
+const char *parseSpecial(const char *first, const char *last, double &value) {
+  if (startsWith(first, last, "infinity")) {
+    value = std::numeric_limits<double>::infinity();
+    return first + 8;
+  }
+  if (startsWith(first, last, "inf")) {
+    value = std::numeric_limits<double>::infinity();
+    return first + 3;
+  }
+  if (startsWith(first, last, "nan")) {
+    value = std::numeric_limits<double>::quiet_NaN();
+    return first + 3;
+  }
+  return first;
+}
+
+/// Correctly rounded conversion of the characters of a number by the C library
+double slowConversion(const char *first, const char *last) {
+  const std::string text(first, last);
+  return std::strtod(text.c_str(), nullptr);
+}
+
+/// Format a double with snprintf, @return the length it needs
+int printDouble(char *buffer, const size_t size, const double value,
+                const FloatFormat format, const int precision,
+                const int width) {
+  switch (format) {
+  case FloatFormat::Fixed:
+    return std::snprintf(buffer, size, "%*.*f", width, precision, value);
+  case FloatFormat::Scientific:
+    return std::snprintf(buffer, size, "%*.*e", width, precision, value);
+  default:
+    return std::snprintf(buffer, size, "%*.*g", width, precision, value);
+  }
+}
+
+#ifdef __SIZEOF_INT128__
+using uint128 = unsigned __int128;
+
+/// Decimals for which 5^decimals times a 53 bit mantissa fits in 128 bits
+constexpr int MAX_EXACT_DECIMALS = 27;
+/// Significant digits for which 10^digits fits in 128 bits
+constexpr int MAX_EXACT_SIGNIFICANT = 38;
+
+/// @return 10^n
+uint128 powerOfTen(const int n) {
+  uint128 power = 1;
+  for (int i = 0; i < n; ++i)
+    power *= 10;
+  return power;
+}
+
+/**
+ * Round magnitude * 10^decimals to the nearest integer, ties to even, from
+ * the exact binary value of magnitude, as printf does.
+ * @return false if the result does not fit in 128 bits
+ */
+bool scaleExactly(const double magnitude, const int decimals,
+                  uint128 &result) {
+  int exponent;
+  const double fraction = std::frexp(magnitude, &exponent);
+  uint128 scaled = static_cast<uint64_t>(std::ldexp(fraction, 53));
+  for (int i = 0; i < decimals; ++i)
+    scaled *= 5;
+  // magnitude * 10^decimals = scaled * 2^shift
+  int shift = exponent - 53 + decimals;
+  if (shift >= 0) {
+    if (shift >= 128 || (shift > 0 && (scaled >> (128 - shift)) != 0))
+      return false;
+    result = scaled << shift;
+    return true;
+  }
+  shift = -shift;
+  if (shift >= 128) {
+    // scaled is below 2^116, far less than half of 2^shift
+    result = 0;
+    return true;
+  }
+  const uint128 quotient = scaled >> shift;
+  const uint128 remainder = scaled - (quotient << shift);
+  const uint128 half = uint128{1} << (shift - 1);
+  const bool roundUp =
+      remainder > half || (remainder == half && (quotient & 1) != 0);
+  result = quotient + (roundUp ? 1 : 0);
+  return true;
+}
+
+/// Write a number as its sign, its integer part and decimals digits
+size_t writeFixed(char *buffer, const bool negative, uint128 scaled,
+                  const int decimals) {
+  char digits[40];
+  char *const digitsEnd = digits + sizeof(digits);
+  char *d = digitsEnd;
+  while (scaled > std::numeric_limits<uint64_t>::max()) {
+    *--d = static_cast<char>('0' + static_cast<int>(scaled % 10));
+    scaled /= 10;
+  }
+  auto small = static_cast<uint64_t>(scaled);
+  do {
+    *--d = static_cast<char>('0' + small % 10);
+    small /= 10;
+  } while (small != 0);
+  const auto numDigits = static_cast<int>(digitsEnd - d);
+
+  char *p = buffer;
+  if (negative)
+    *p++ = '-';
+  if (numDigits <= decimals) {
+    *p++ = '0';
+  } else {
+    for (int i = 0; i < numDigits - decimals; ++i)
+      *p++ = *d++;
+  }
+  if (decimals > 0) {
+    *p++ = '.';
+    for (int i = numDigits; i < decimals; ++i)
+      *p++ = '0';
+    while (d != digitsEnd)
+      *p++ = *d++;
+  }
+  return static_cast<size_t>(p - buffer);
+}
+#endif
+
+/**
+ * Format the numbers printf writes in fixed notation, which are nearly all
+ * of them in the ASCII formats, with integer arithmetic.
+ * @param buffer :: at least 80 characters
+ * @return the length of the number, 0 if it is left to printf
+ */
+size_t formatExactly(char *buffer, const double value,
+                     const FloatFormat format, const int precision) {
+#ifdef __SIZEOF_INT128__
+  if (!std::isfinite(value) || precision < 0)
+    return 0;
+  const bool negative = std::signbit(value);
+  const double magnitude = std::fabs(value);
+  uint128 scaled;
+  if (format == FloatFormat::Fixed) {
+    if (precision > MAX_EXACT_DECIMALS ||
+        !scaleExactly(magnitude, precision, scaled))
+      return 0;
+    return writeFixed(buffer, negative, scaled, precision);
+  }
+  const int significant = std::max(precision, 1);
+  if (format != FloatFormat::General || significant > MAX_EXACT_SIGNIFICANT)
+    return 0;
+  if (magnitude == 0.)
+    return writeFixed(buffer, negative, 0, 0);
+  // The exponent is that of the number rounded to the significant digits,
+  // which can be one more than that of the number itself
+  auto exponent = static_cast<int>(std::floor(std::log10(magnitude)));
+  int decimals = 0;
+  for (int attempt = 0;; ++attempt) {
+    decimals = significant - 1 - exponent;
+    if (attempt == 3 || decimals < 0 || decimals > MAX_EXACT_DECIMALS ||
+        !scaleExactly(magnitude, decimals, scaled))
+      return 0;
+    if (scaled >= powerOfTen(significant))
+      ++exponent;
+    else if (scaled < powerOfTen(significant - 1))
+      --exponent;
+    else
+      break;
+  }
+  if (exponent < -4 || exponent >= significant)
+    return 0;
+  size_t length = writeFixed(buffer, negative, scaled, decimals);
+  // Without std::showpoint the trailing zeros are removed
+  if (decimals > 0) {
+    while (buffer[length - 1] == '0')
+      --length;
+    if (buffer[length - 1] == '.')
+      --length;
+  }
+  return length;
+#else
+  UNUSED_ARG(buffer);
+  UNUSED_ARG(value);
+  UNUSED_ARG(format);
+  UNUSED_ARG(precision);
+  return 0;
+#endif
+}
+} // namespace
+
+/**
+ * Parse a floating point number at the start of a range of characters, with
+ * an optional sign, optional decimal point and optional exponent, or one of
+ * inf, infinity and nan. Leading whitespace is not skipped.
+ *
+ * Numbers with up to 15 significant digits and a small exponent, which are
+ * nearly all the numbers in the ASCII formats, are converted with a single
+ * exact multiplication or division. Other ones are handed to strtod. The
+ * result is always the correctly rounded value.
+ * @param first :: the first character
+ * @param last :: one past the last character
+ * @param value :: set to the number, unchanged if there is none
+ * @return one past the last character of the number, or first if the range
+ * does not start with a number
+ */
+const char *fromChars(const char *first, const char *last, double &value) {
+  const char *p = first;
+  const bool negative = (p != last && *p == '-');
+  if (p != last && (*p == '-' || *p == '+'))
+    ++p;
+  if (p != last && !isDigit(*p) && *p != '.') {
+    double special;
+    const char *end = parseSpecial(p, last, special);
+    if (end == p)
+      return first;
+    value = negative ? -special : special;
+    return end;
+  }
+
+  uint64_t mantissa = 0;
+  int numDigits = 0;
+  int exponent = 0;
+  bool anyDigit = false;
+  bool truncated = false;
+  for (; p != last && isDigit(*p); ++p) {
+    anyDigit = true;
+    if (numDigits < MAX_MANTISSA_DIGITS) {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+      numDigits += (mantissa != 0);
+    } else {
+      ++exponent;
+      truncated |= (*p != '0');
+    }
+  }
+  if (p != last && *p == '.') {
+    for (++p; p != last && isDigit(*p); ++p) {
+      anyDigit = true;
+      if (numDigits < MAX_MANTISSA_DIGITS) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        numDigits += (mantissa != 0);
+        --exponent;
+      } else {
+        truncated |= (*p != '0');
+      }
+    }
+  }
+  if (!anyDigit)
+    return first;
+
+  // An exponent without digits is not part of the number
+  if (p != last && (*p == 'e' || *p == 'E')) {
+    const char *q = p + 1;
+    const bool negativeExponent = (q != last && *q == '-');
+    if (q != last && (*q == '-' || *q == '+'))
+      ++q;
+    if (q != last && isDigit(*q)) {
+      int explicitExponent = 0;
+      for (; q != last && isDigit(*q); ++q) {
+        if (explicitExponent < 100000)
+          explicitExponent = explicitExponent * 10 + (*q - '0');
+      }
+      exponent += negativeExponent ? -explicitExponent : explicitExponent;
+      p = q;
+    }
+  }
+
+  if (mantissa == 0 && !truncated) {
+    value = negative ? -0. : 0.;
+  } else if (!truncated && mantissa <= MAX_EXACT_MANTISSA &&
+             exponent >= -MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER) {
+    // Both operands are exact, so the result is correctly rounded
+    const auto exact = static_cast<double>(mantissa);
+    value = exponent < 0 ? exact / EXACT_POWERS_OF_TEN[-exponent]
+                         : exact * EXACT_POWERS_OF_TEN[exponent];
+    if (negative)
+      value = -value;
+  } else {
+    value = slowConversion(first, p);
+  }
+  return p;
+}
+
+/**
+ * Parse a decimal integer, with an optional sign, at the start of a range of
+ * characters. Leading whitespace is not skipped.
+ * @param first :: the first character
+ * @param last :: one past the last character
+ * @param value :: set to the number, unchanged if there is none
+ * @return one past the last digit, or first if the range does not start with
+ * an integer or it does not fit in 64 bits
+ */
+const char *fromChars(const char *first, const char *last, int64_t &value) {
+  const char *p = first;
+  const bool negative = (p != last && *p == '-');
+  if (p != last && (*p == '-' || *p == '+'))
+    ++p;
+  if (p == last || !isDigit(*p))
+    return first;
+  // Accumulate the magnitude, one more than the maximum for negative numbers
+  const uint64_t limit =
+      static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + negative;
+  uint64_t magnitude = 0;
+  for (; p != last && isDigit(*p); ++p) {
+    const auto digit = static_cast<uint64_t>(*p - '0');
+    if (magnitude > (limit - digit) / 10)
+      return first;
+    magnitude = magnitude * 10 + digit;
+  }
+  value = negative ? static_cast<int64_t>(0 - magnitude)
+                   : static_cast<int64_t>(magnitude);
+  return p;
+}
+
+/**
+ * Write a floating point number as an std::ostream with the same precision,
+ * width and floatfield flags, right aligned, would write it. Numbers written
+ * in fixed notation are rounded exactly with integer arithmetic where the
+ * compiler has 128 bit integers, the others are written by snprintf.
+ * @param first :: the first character of the output
+ * @param last :: one past the last character of the output
+ * @param value :: the number
+ * @param format :: the floatfield flags
+ * @param precision :: the precision of the stream
+ * @param width :: the minimum number of characters, padded with spaces
+ * @return one past the last character written, or nullptr if the range is too
+ * small
+ */
+char *toChars(char *first, char *last, const double value,
+              const FloatFormat format, const int precision, const int width) {
+  const auto size = static_cast<size_t>(last - first);
+  char buffer[80];
+  if (const size_t length = formatExactly(buffer, value, format, precision)) {
+    const size_t numSpaces =
+        width > static_cast<int>(length) ? static_cast<size_t>(width) - length
+                                          : 0;
+    if (size < numSpaces + length)
+      return nullptr;
+    first = std::fill_n(first, numSpaces, ' ');
+    return std::copy(buffer, buffer + length, first);
+  }
+  // snprintf also writes the terminating null character
+  const int length =
+      printDouble(first, size, value, format, precision, width);
+  if (length < 0 || static_cast<size_t>(length) >= size)
+    return nullptr;
+  return first + length;
+}
+
+/**
+ * Write a decimal integer, right aligned.
+ * @param first :: the first character of the output
+ * @param last :: one past the last character of the output
+ * @param value :: the number
+ * @param width :: the minimum number of characters, padded with spaces
+ * @return one past the last character written, or nullptr if the range is too
+ * small
+ */
+char *toChars(char *first, char *last, const int64_t value, const int width) {
+  char digits[20];
+  char *end = digits + sizeof(digits);
+  char *p = end;
+  auto magnitude = value < 0 ? 0 - static_cast<uint64_t>(value)
+                             : static_cast<uint64_t>(value);
+  do {
+    *--p = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+  const auto numDigits = static_cast<int>(end - p) + (value < 0);
+  const int numSpaces = width > numDigits ? width - numDigits : 0;
+  if (last - first < numSpaces + numDigits)
+    return nullptr;
+  for (int i = 0; i < numSpaces; ++i)
+    *first++ = ' ';
+  if (value < 0)
+    *first++ = '-';
+  while (p != end)
+    *first++ = *p++;
+  return first;
+}
+
+/**
+ * Append a floating point number to a string, as an std::ostream with the
+ * same precision, width and floatfield flags would write it.
+ * @param out :: the string
+ * @param value :: the number
+ * @param format :: the floatfield flags
+ * @param precision :: the precision of the stream
+ * @param width :: the minimum number of characters, padded with spaces
+ */
+void append(std::string &out, const double value, const FloatFormat format,
+            const int precision, const int width) {
+  char buffer[64];
+  if (char *end = toChars(buffer, buffer + sizeof(buffer), value,
+                                format, precision, width)) {
+    out.append(buffer, end);
+    return;
+  }
+  // Very large numbers in fixed format, or a very high precision
+  const int length = printDouble(nullptr, 0, value, format, precision, width);
+  const size_t start = out.size();
+  out.resize(start + static_cast<size_t>(length) + 1);
+  printDouble(&out[start], static_cast<size_t>(length) + 1, value, format,
+              precision, width);
+  out.resize(start + static_cast<size_t>(length));
+}
+
+/**
+ * Append a decimal integer to a string, right aligned
+ * @param out :: the string
+ * @param value :: the number
+ * @param width :: the minimum number of characters, padded with spaces
+ */
+void append(std::string &out, const int64_t value, const int width) {
+  char buffer[32];
+  if (width < static_cast<int>(sizeof(buffer))) {
+    out.append(buffer, toChars(buffer, buffer + sizeof(buffer), value, width));
+    return;
+  }
+  out.append(static_cast<size_t>(width) - 20, ' ');
+  out.append(buffer, toChars(buffer, buffer + sizeof(buffer), value, 20));
+}
+
+} // namespace CharConv
+} // namespace Kernel
+} // namespace Mantid
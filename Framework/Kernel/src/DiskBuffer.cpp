@@ -132,6 +132,7 @@ void DiskBuffer::writeOldObjects() {
         // Write to the disk; this will call the object specific save function;
         // Prevent simultaneous file access (e.g. write while loading)
         obj->saveAt(fileIndexStart, NumObjEvents);
+        recordWrite(NumObjEvents);
       } else {
         uint64_t NumFileEvents = obj->getFileSize();
         if (NumObjEvents != NumFileEvents) {
@@ -142,6 +143,7 @@ void DiskBuffer::writeOldObjects() {
           // Write to the disk; this will call the object specific save
           // function;
           obj->saveAt(fileIndexStart, NumObjEvents);
+          recordWrite(NumObjEvents);
         } else // despite object size have not been changed, it can be modified
                // other way. In this case, the method which changed the data
                // should set dataChanged ID
@@ -151,12 +153,15 @@ void DiskBuffer::writeOldObjects() {
             // Write to the disk; this will call the object specific save
             // function;
             obj->saveAt(fileIndexStart, NumObjEvents);
+            recordWrite(NumObjEvents);
             // this is questionable operation, which adjust file size in case
             // when the file postions were allocated externaly
             if (fileIndexStart + NumObjEvents > m_fileLength)
               m_fileLength = fileIndexStart + NumObjEvents;
-          } else // just clean the object up -- it just occupies memory
+          } else { // just clean the object up -- it just occupies memory
             obj->clearDataFromMemory();
+            ++m_statistics.objectsDiscarded;
+          }
         }
       }
       // tell the object that it has been removed from the buffer
@@ -190,6 +195,14 @@ void DiskBuffer::writeOldObjects() {
   m_nObjectsToWrite = objectsNotWritten;
 }
 
+/** Count an object written out by writeOldObjects(). Must be called with
+ * m_mutex held.
+ * @param size :: amount of data written */
+void DiskBuffer::recordWrite(uint64_t size) {
+  ++m_statistics.objectsWritten;
+  m_statistics.dataWritten += size;
+}
+
 //---------------------------------------------------------------------------------------------
 /** Flush out all the data in the memory; and writes out everything in the
  * to-write cache. */
@@ -389,8 +402,25 @@ std::string DiskBuffer::getMemoryStr() const {
   std::ostringstream mess;
   mess << "Buffer: " << m_writeBufferUsed << " in " << m_nObjectsToWrite
        << " objects. ";
+  const auto statistics = getIOStatistics();
+  mess << "Written: " << statistics.dataWritten << " in "
+       << statistics.objectsWritten << " objects. Prefetched: "
+       << statistics.dataPrefetched << " in " << statistics.objectsPrefetched
+       << " objects, " << statistics.prefetchWaits << " waits. ";
   return mess.str();
 }
 
+/// @return a copy of the counts of the disk operations made so far
+DiskBuffer::IOStatistics DiskBuffer::getIOStatistics() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_statistics;
+}
+
+/// Reset the counts of the disk operations, e.g. before timing an algorithm
+void DiskBuffer::resetIOStatistics() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_statistics = IOStatistics();
+}
+
 } // namespace Kernel
 } // namespace Mantid
@@ -0,0 +1,176 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidKernel/DiskPrefetcher.h"
+#include "MantidKernel/DiskBuffer.h"
+#include "MantidKernel/ISaveable.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace Mantid {
+namespace Kernel {
+
+//----------------------------------------------------------------------------------------------
+/** Constructor. Starts loading the objects on a background thread.
+ *
+ * @param buffer :: the DiskBuffer tracking the objects in memory
+ * @param items :: the objects in the order in which they will be used.
+ *        Entries may be nullptr, these are skipped.
+ * @param maxDataAhead :: amount of data, in the units of the buffer, which
+ *        may be loaded but not yet released. At least one object is always
+ *        loaded ahead of the consumer.
+ */
+DiskPrefetcher::DiskPrefetcher(DiskBuffer &buffer,
+                               std::vector<ISaveable *> items,
+                               uint64_t maxDataAhead)
+    : m_buffer(buffer), m_items(std::move(items)),
+      m_maxDataAhead(maxDataAhead), m_nextToLoad(0), m_dataAhead(0),
+      m_prefetchedSize(m_items.size(), 0), m_stop(false),
+      m_thread(&DiskPrefetcher::run, this) {}
+
+/** Destructor. Stops the loading thread and hands the objects which were
+ * loaded but never released back to the DiskBuffer.
+ */
+DiskPrefetcher::~DiskPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_released.notify_all();
+  m_thread.join();
+  for (size_t i = 0; i < m_items.size(); ++i) {
+    if (m_prefetchedSize[i] == 0)
+      continue;
+    try {
+      handBack(m_items[i]);
+    } catch (...) {
+      // Failed writes of other objects are retried by the next flush of the
+      // buffer; a destructor must not throw.
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------------
+/** Wait until the object at the given index has been processed by the
+ * loading thread. Call this before using the object.
+ *
+ * @param index :: index of the object in the list given to the constructor
+ * @throw std::out_of_range if the index is not in the list
+ * @throw any exception raised while loading the objects up to this one
+ */
+void DiskPrefetcher::waitFor(size_t index) {
+  if (index >= m_items.size())
+    throw std::out_of_range("DiskPrefetcher::waitFor() index out of range");
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  const bool mustWait = m_nextToLoad <= index && !m_error;
+  m_loaded.wait(lock,
+                [this, index] { return m_nextToLoad > index || m_error; });
+  if (m_nextToLoad <= index)
+    std::rethrow_exception(m_error);
+  lock.unlock();
+
+  if (mustWait) {
+    std::lock_guard<std::mutex> bufferLock(m_buffer.m_mutex);
+    ++m_buffer.m_statistics.prefetchWaits;
+  }
+}
+
+/** Signal that the consumer has finished with the object at the given index.
+ * A prefetched object is no longer marked busy and is handed to the
+ * DiskBuffer, which may then drop it from memory.
+ *
+ * @param index :: index of the object in the list given to the constructor
+ */
+void DiskPrefetcher::release(size_t index) {
+  uint64_t size(0);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (index >= m_nextToLoad)
+      return;
+    size = m_prefetchedSize[index];
+    m_prefetchedSize[index] = 0;
+    m_dataAhead -= size;
+  }
+  m_released.notify_all();
+  if (size > 0)
+    handBack(m_items[index]);
+}
+
+//----------------------------------------------------------------------------------------------
+/** Body of the loading thread. Loads the objects in order, waiting whenever
+ * the consumer is more than the maximum amount of data behind.
+ */
+void DiskPrefetcher::run() {
+  for (size_t i = 0; i < m_items.size(); ++i) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_released.wait(lock, [this] {
+        return m_stop || m_dataAhead < m_maxDataAhead || m_dataAhead == 0;
+      });
+      if (m_stop)
+        return;
+    }
+
+    // Only objects on file and not in memory need loading. Marking them busy
+    // under the buffer lock stops a concurrent writeOldObjects() from saving
+    // or clearing them while they are loaded.
+    ISaveable *item = m_items[i];
+    uint64_t size(0);
+    if (item) {
+      std::lock_guard<std::mutex> bufferLock(m_buffer.m_mutex);
+      if (item->wasSaved() && !item->isLoaded() && !item->isBusy() &&
+          item->getFileSize() > 0) {
+        item->setBusy(true);
+        size = item->getFileSize();
+      }
+    }
+
+    if (size > 0) {
+      try {
+        item->load();
+      } catch (...) {
+        {
+          std::lock_guard<std::mutex> bufferLock(m_buffer.m_mutex);
+          item->setBusy(false);
+        }
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_error = std::current_exception();
+        }
+        m_loaded.notify_all();
+        return;
+      }
+      std::lock_guard<std::mutex> bufferLock(m_buffer.m_mutex);
+      ++m_buffer.m_statistics.objectsPrefetched;
+      m_buffer.m_statistics.dataPrefetched += size;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_prefetchedSize[i] = size;
+      m_dataAhead += size;
+      m_nextToLoad = i + 1;
+    }
+    m_loaded.notify_all();
+  }
+}
+
+/** Clear the busy flag set by the loading thread and put the object in the
+ * to-write buffer, so that its memory is managed by the DiskBuffer again.
+ * @param item :: a prefetched object
+ */
+void DiskPrefetcher::handBack(ISaveable *item) {
+  {
+    std::lock_guard<std::mutex> bufferLock(m_buffer.m_mutex);
+    item->setBusy(false);
+  }
+  m_buffer.toWrite(item);
+}
+
+} // namespace Kernel
+} // namespace Mantid
@@ -0,0 +1,273 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_KERNEL_CHARCONVTEST_H_
+#define MANTID_KERNEL_CHARCONVTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidKernel/CharConv.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+using namespace Mantid::Kernel;
+using CharConv::FloatFormat;
+
+namespace {
+double parse(const std::string &text, size_t &length) {
+  double value = -1.;
+  const char *end =
+      CharConv::fromChars(text.data(), text.data() + text.size(), value);
+  length = static_cast<size_t>(end - text.data());
+  return value;
+}
+
+double parse(const std::string &text) {
+  size_t length;
+  const double value = parse(text, length);
+  TSM_ASSERT_EQUALS(text, length, text.size());
+  return value;
+}
+
+/// Write a number with a stream using the given flags
+std::string stream(const double value, const FloatFormat format,
+                   const int precision, const int width) {
+  std::ostringstream out;
+  if (format == FloatFormat::Fixed)
+    out << std::fixed;
+  else if (format == FloatFormat::Scientific)
+    out << std::scientific;
+  out << std::setprecision(precision) << std::setw(width) << value;
+  return out.str();
+}
+} // namespace
+
+class CharConvTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static CharConvTest *createSuite() { return new CharConvTest(); }
+  static void destroySuite(CharConvTest *suite) { delete suite; }
+
+  void test_parse_doubles_matches_strtod() {
+    const std::string numbers[] = {"0",
+                                   "-0",
+                                   "1",
+                                   "+1",
+                                   "-1.5",
+                                   "0.1",
+                                   ".5",
+                                   "5.",
+                                   "123.456",
+                                   "1e3",
+                                   "1E-3",
+                                   "-2.5e+10",
+                                   "0.0001",
+                                   "3.14159265358979",
+                                   "1e22",
+                                   "1e23",
+                                   "1e-300",
+                                   "4.9e-324",
+                                   "1.7976931348623157e308",
+                                   "12345678901234567890123",
+                                   "0.30000000000000004",
+                                   "9007199254740993",
+                                   "1.00000000000000011102230246251565404"};
+    for (const auto &number : numbers) {
+      TSM_ASSERT_EQUALS(number, parse(number),
+                        std::strtod(number.c_str(), nullptr));
+    }
+  }
+
+  void test_parse_doubles_of_many_digits_is_exact() {
+    for (int i = 1; i < 100000; i += 7) {
+      std::ostringstream out;
+      out << std::setprecision(17) << 1. / i;
+      TS_ASSERT_EQUALS(parse(out.str()), 1. / i);
+    }
+  }
+
+  void test_parse_stops_at_the_end_of_the_number() {
+    size_t length;
+    TS_ASSERT_EQUALS(parse("1.5,2.5", length), 1.5);
+    TS_ASSERT_EQUALS(length, 3);
+    TS_ASSERT_EQUALS(parse("2e", length), 2.);
+    TS_ASSERT_EQUALS(length, 1);
+    TS_ASSERT_EQUALS(parse("2e+x", length), 2.);
+    TS_ASSERT_EQUALS(length, 1);
+    TS_ASSERT_EQUALS(parse("3 4", length), 3.);
+    TS_ASSERT_EQUALS(length, 1);
+  }
+
+  void test_parse_special_values() {
+    TS_ASSERT(std::isnan(parse("nan")));
+    TS_ASSERT(std::isnan(parse("NaN")));
+    TS_ASSERT_EQUALS(parse("inf"), std::numeric_limits<double>::infinity());
+    TS_ASSERT_EQUALS(parse("-Infinity"),
+                     -std::numeric_limits<double>::infinity());
+  }
+
+  void test_parse_fails_without_a_number() {
+    for (const std::string text : {"", "-", "+", ".", "e5", "x1", " 1"}) {
+      size_t length;
+      TSM_ASSERT_EQUALS(text, parse(text, length), -1.);
+      TSM_ASSERT_EQUALS(text, length, 0);
+    }
+  }
+
+  void test_parse_integers() {
+    const std::string text = "-9223372036854775808 42 9223372036854775808";
+    const char *first = text.data();
+    const char *last = first + text.size();
+    int64_t value = 0;
+    first = CharConv::fromChars(first, last, value);
+    TS_ASSERT_EQUALS(value, std::numeric_limits<int64_t>::min());
+    first = CharConv::fromChars(first + 1, last, value);
+    TS_ASSERT_EQUALS(value, 42);
+    // Too large, nothing is parsed
+    TS_ASSERT_EQUALS(CharConv::fromChars(first + 1, last, value), first + 1);
+    TS_ASSERT_EQUALS(value, 42);
+  }
+
+  void test_doubles_are_written_as_by_a_stream() {
+    const double values[] = {0.,     -0.,     1.,      -1.5,   0.1,
+                             1. / 3, 123.456, 1e-7,    2.5e12, 1e300,
+                             -2e-300, 0.125,  1234567.891};
+    for (const auto value : values) {
+      for (const auto format : {FloatFormat::General, FloatFormat::Fixed,
+                                FloatFormat::Scientific}) {
+        for (const int precision : {0, 1, 5, 8, 17}) {
+          for (const int width : {0, 15, 18}) {
+            std::string out;
+            CharConv::append(out, value, format, precision, width);
+            TS_ASSERT_EQUALS(out, stream(value, format, precision, width));
+          }
+        }
+      }
+    }
+  }
+
+  void test_rounding_matches_the_stream() {
+    // Ties, values near a power of ten and a wide range of magnitudes
+    std::vector<double> values{0.5,    1.5,     2.5,     0.125, 0.375,
+                               9.9995, 99.9995, 0.99999, 1e-5,  0.00015};
+    for (int i = 1; i < 2000; ++i)
+      values.push_back(std::sin(i) * std::pow(10., i % 24 - 12));
+    for (const auto value : values) {
+      for (int precision = 0; precision <= 17; ++precision) {
+        for (const auto format : {FloatFormat::General, FloatFormat::Fixed}) {
+          std::string out;
+          CharConv::append(out, value, format, precision);
+          TS_ASSERT_EQUALS(out, stream(value, format, precision, 0));
+        }
+      }
+    }
+  }
+
+  void test_written_doubles_are_read_back() {
+    std::string out;
+    CharConv::append(out, 1. / 3, FloatFormat::General, 17);
+    TS_ASSERT_EQUALS(parse(out), 1. / 3);
+  }
+
+  void test_integers_are_written_right_aligned() {
+    std::string out;
+    CharConv::append(out, int64_t{0});
+    CharConv::append(out, int64_t{-42}, 5);
+    CharConv::append(out, std::numeric_limits<int64_t>::min());
+    TS_ASSERT_EQUALS(out, "0  -42-9223372036854775808");
+    out.clear();
+    CharConv::append(out, int64_t{7}, 40);
+    TS_ASSERT_EQUALS(out, std::string(39, ' ') + "7");
+  }
+
+  void test_toChars_fails_if_the_range_is_too_small() {
+    char buffer[4];
+    TS_ASSERT(!CharConv::toChars(buffer, buffer + 4, int64_t{12345}));
+    TS_ASSERT(!CharConv::toChars(buffer, buffer + 4, 1.5, FloatFormat::Fixed,
+                                 3));
+    TS_ASSERT_EQUALS(CharConv::toChars(buffer, buffer + 4, int64_t{1234}),
+                     buffer + 4);
+  }
+};
+
+class CharConvTestPerformance : public CxxTest::TestSuite {
+public:
+  static CharConvTestPerformance *createSuite() {
+    return new CharConvTestPerformance();
+  }
+  static void destroySuite(CharConvTestPerformance *suite) { delete suite; }
+
+  CharConvTestPerformance() {
+    for (size_t i = 0; i < m_values.size(); ++i)
+      m_values[i] = 1000. * std::sin(static_cast<double>(i));
+    for (const auto value : m_values) {
+      CharConv::append(m_text, value, FloatFormat::Fixed, 8, 18);
+      m_text += '\n';
+    }
+  }
+
+  void test_format_doubles() {
+    std::string out;
+    out.reserve(m_text.size());
+    for (const auto value : m_values) {
+      CharConv::append(out, value, FloatFormat::Fixed, 8, 18);
+      out += '\n';
+    }
+    TS_ASSERT_EQUALS(out.size(), m_text.size());
+  }
+
+  void test_format_doubles_with_a_stream() {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(8);
+    for (const auto value : m_values)
+      out << std::setw(18) << value << '\n';
+    TS_ASSERT_EQUALS(out.str().size(), m_text.size());
+  }
+
+  void test_parse_doubles() {
+    const char *first = m_text.data();
+    const char *last = first + m_text.size();
+    double sum = 0.;
+    while (first != last) {
+      while (*first == ' ' || *first == '\n')
+        ++first;
+      double value = 0.;
+      first = CharConv::fromChars(first, last, value);
+      sum += value;
+      while (first != last && *first == '\n')
+        ++first;
+    }
+    TS_ASSERT_DELTA(sum, expectedSum(), 1e-3);
+  }
+
+  void test_parse_doubles_with_a_stream() {
+    std::istringstream in(m_text);
+    double sum = 0.;
+    double value;
+    while (in >> value)
+      sum += value;
+    TS_ASSERT_DELTA(sum, expectedSum(), 1e-3);
+  }
+
+private:
+  double expectedSum() const {
+    double sum = 0.;
+    for (const auto value : m_values)
+      sum += std::round(value * 1e8) / 1e8;
+    return sum;
+  }
+
+  std::vector<double> m_values = std::vector<double>(5000000);
+  std::string m_text;
+};
+
+#endif /* MANTID_KERNEL_CHARCONVTEST_H_ */
@@ -203,6 +203,27 @@ public:
     TS_ASSERT_EQUALS(SaveableTesterWithFile::fakeFile, "  BBCCDDEEFF      JJ");
   }
 
+  /** The buffer counts the objects it writes and the ones it only drops */
+  void test_ioStatistics() {
+    DiskBuffer dbuf(2 * 2);
+    data[1]->setDataChanged();
+    data[5]->setDataChanged();
+    dbuf.toWrite(data[1]);
+    dbuf.toWrite(data[3]);
+    dbuf.toWrite(data[5]);
+    auto statistics = dbuf.getIOStatistics();
+    TS_ASSERT_EQUALS(statistics.objectsWritten, 2);
+    TS_ASSERT_EQUALS(statistics.dataWritten, 4);
+    TS_ASSERT_EQUALS(statistics.objectsDiscarded, 1);
+    TS_ASSERT_EQUALS(statistics.objectsPrefetched, 0);
+
+    dbuf.resetIOStatistics();
+    statistics = dbuf.getIOStatistics();
+    TS_ASSERT_EQUALS(statistics.objectsWritten, 0);
+    TS_ASSERT_EQUALS(statistics.dataWritten, 0);
+    TS_ASSERT_EQUALS(statistics.objectsDiscarded, 0);
+  }
+
   //--------------------------------------------------------------------------------
   /** If a block will get deleted it needs to be taken
    * out of the caches */
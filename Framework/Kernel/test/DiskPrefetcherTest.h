@@ -0,0 +1,182 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_KERNEL_DISKPREFETCHERTEST_H_
+#define MANTID_KERNEL_DISKPREFETCHERTEST_H_
+
+#include "MantidKernel/DiskBuffer.h"
+#include "MantidKernel/DiskPrefetcher.h"
+#include "MantidKernel/ISaveable.h"
+#include <cxxtest/TestSuite.h>
+
+#include <memory>
+#include <stdexcept>
+
+using namespace Mantid::Kernel;
+
+namespace {
+/** An ISaveable that is on file and not in memory until loaded */
+class PrefetchTester : public ISaveable {
+public:
+  PrefetchTester(uint64_t pos, uint64_t size, bool failToLoad = false)
+      : ISaveable(), m_memory(0), m_failToLoad(failToLoad) {
+    this->setFilePosition(pos, size, true);
+    this->setLoaded(false);
+  }
+  void save() const override {}
+  void load() override {
+    if (m_failToLoad)
+      throw std::runtime_error("Cannot read the file");
+    if (!this->isLoaded())
+      m_memory += this->getFileSize();
+    this->setLoaded(true);
+  }
+  void flushData() const override {}
+  void clearDataFromMemory() override {
+    m_memory = 0;
+    this->setLoaded(false);
+  }
+  uint64_t getTotalDataSize() const override {
+    return this->isLoaded() ? m_memory : m_memory + this->getFileSize();
+  }
+  size_t getDataMemorySize() const override { return size_t(m_memory); }
+
+private:
+  uint64_t m_memory;
+  bool m_failToLoad;
+};
+} // namespace
+
+class DiskPrefetcherTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static DiskPrefetcherTest *createSuite() { return new DiskPrefetcherTest(); }
+  static void destroySuite(DiskPrefetcherTest *suite) { delete suite; }
+
+  void setUp() override {
+    m_data.clear();
+    for (uint64_t i = 0; i < 10; ++i)
+      m_data.push_back(std::make_unique<PrefetchTester>(2 * i, 2));
+  }
+
+  void test_loads_the_objects_in_order() {
+    DiskBuffer dbuf(1000);
+    {
+      DiskPrefetcher prefetcher(dbuf, items(), 1000);
+      for (size_t i = 0; i < m_data.size(); ++i) {
+        prefetcher.waitFor(i);
+        TS_ASSERT(m_data[i]->isLoaded());
+        TS_ASSERT(m_data[i]->isBusy());
+        prefetcher.release(i);
+        TS_ASSERT(!m_data[i]->isBusy());
+      }
+    }
+    const auto statistics = dbuf.getIOStatistics();
+    TS_ASSERT_EQUALS(statistics.objectsPrefetched, 10);
+    TS_ASSERT_EQUALS(statistics.dataPrefetched, 20);
+    // The released objects are tracked by the buffer
+    TS_ASSERT_EQUALS(dbuf.getWriteBufferUsed(), 20);
+  }
+
+  void test_does_not_load_more_than_allowed_ahead() {
+    DiskBuffer dbuf(1000);
+    // Room for two objects
+    DiskPrefetcher prefetcher(dbuf, items(), 4);
+    prefetcher.waitFor(1);
+    TS_ASSERT(m_data[1]->isLoaded());
+    TS_ASSERT(!m_data[2]->isLoaded());
+    prefetcher.release(0);
+    prefetcher.waitFor(2);
+    TS_ASSERT(m_data[2]->isLoaded());
+    TS_ASSERT(!m_data[3]->isLoaded());
+  }
+
+  void test_always_loads_one_object_ahead() {
+    DiskBuffer dbuf(1000);
+    DiskPrefetcher prefetcher(dbuf, items(), 0);
+    for (size_t i = 0; i < m_data.size(); ++i) {
+      prefetcher.waitFor(i);
+      TS_ASSERT(m_data[i]->isLoaded());
+      prefetcher.release(i);
+    }
+  }
+
+  void test_skips_objects_in_memory_and_null_entries() {
+    DiskBuffer dbuf(1000);
+    m_data[0]->load();
+    auto list = items();
+    list[1] = nullptr;
+    {
+      DiskPrefetcher prefetcher(dbuf, list, 1000);
+      prefetcher.waitFor(2);
+      TS_ASSERT(!m_data[0]->isBusy());
+      TS_ASSERT(!m_data[1]->isLoaded());
+      TS_ASSERT(m_data[2]->isBusy());
+      prefetcher.release(0);
+      prefetcher.release(1);
+      prefetcher.release(2);
+      prefetcher.waitFor(9);
+    }
+    TS_ASSERT_EQUALS(dbuf.getIOStatistics().objectsPrefetched, 8);
+  }
+
+  void test_unreleased_objects_are_handed_back_when_destroyed() {
+    DiskBuffer dbuf(1000);
+    {
+      DiskPrefetcher prefetcher(dbuf, items(), 1000);
+      prefetcher.waitFor(9);
+    }
+    for (const auto &item : m_data)
+      TS_ASSERT(!item->isBusy());
+    TS_ASSERT_EQUALS(dbuf.getWriteBufferUsed(), 20);
+    // Flushing drops the unchanged objects from memory
+    dbuf.flushCache();
+    TS_ASSERT_EQUALS(dbuf.getWriteBufferUsed(), 0);
+    TS_ASSERT(!m_data[0]->isLoaded());
+    TS_ASSERT_EQUALS(dbuf.getIOStatistics().objectsDiscarded, 10);
+    TS_ASSERT_EQUALS(dbuf.getIOStatistics().objectsWritten, 0);
+  }
+
+  void test_load_errors_are_rethrown_to_the_consumer() {
+    DiskBuffer dbuf(1000);
+    m_data[3] = std::make_unique<PrefetchTester>(6, 2, true);
+    DiskPrefetcher prefetcher(dbuf, items(), 1000);
+    TS_ASSERT_THROWS_NOTHING(prefetcher.waitFor(2));
+    TS_ASSERT_THROWS(prefetcher.waitFor(3), const std::runtime_error &);
+    TS_ASSERT(!m_data[3]->isBusy());
+  }
+
+  void test_waitFor_throws_for_an_index_out_of_range() {
+    DiskBuffer dbuf(1000);
+    DiskPrefetcher prefetcher(dbuf, items(), 1000);
+    TS_ASSERT_THROWS(prefetcher.waitFor(10), const std::out_of_range &);
+  }
+
+  void test_statistics_can_be_reset() {
+    DiskBuffer dbuf(1000);
+    {
+      DiskPrefetcher prefetcher(dbuf, items(), 1000);
+      prefetcher.waitFor(9);
+    }
+    TS_ASSERT_EQUALS(dbuf.getIOStatistics().objectsPrefetched, 10);
+    dbuf.resetIOStatistics();
+    TS_ASSERT_EQUALS(dbuf.getIOStatistics().objectsPrefetched, 0);
+    TS_ASSERT_EQUALS(dbuf.getIOStatistics().dataPrefetched, 0);
+  }
+
+private:
+  std::vector<ISaveable *> items() const {
+    std::vector<ISaveable *> list;
+    for (const auto &item : m_data)
+      list.push_back(item.get());
+    return list;
+  }
+
+  std::vector<std::unique_ptr<PrefetchTester>> m_data;
+};
+
+#endif /* MANTID_KERNEL_DISKPREFETCHERTEST_H_ */
@@ -0,0 +1,196 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_KERNEL_RADIXSORTTEST_H_
+#define MANTID_KERNEL_RADIXSORTTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidKernel/RadixSort.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <utility>
+
+using Mantid::Kernel::radixSort;
+using Mantid::Kernel::radixSortKey;
+
+namespace {
+std::vector<double> randomDoubles(const size_t size, const double min,
+                                  const double max) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distribution(min, max);
+  std::vector<double> values(size);
+  for (auto &value : values)
+    value = distribution(generator);
+  return values;
+}
+
+std::vector<int64_t> randomIntegers(const size_t size, const int64_t min,
+                                    const int64_t max) {
+  std::mt19937_64 generator(42);
+  std::uniform_int_distribution<int64_t> distribution(min, max);
+  std::vector<int64_t> values(size);
+  for (auto &value : values)
+    value = distribution(generator);
+  return values;
+}
+
+/// A (pulse time, time-of-flight) pair, like an event
+using TimePair = std::pair<int64_t, double>;
+
+std::vector<TimePair> randomPairs(const size_t size) {
+  const auto pulses = randomIntegers(size, 1000000000000, 1000000001000);
+  const auto tofs = randomDoubles(size, 0., 1000.);
+  std::vector<TimePair> pairs(size);
+  for (size_t i = 0; i < size; ++i)
+    pairs[i] = TimePair(pulses[i], tofs[i]);
+  return pairs;
+}
+} // namespace
+
+class RadixSortTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static RadixSortTest *createSuite() { return new RadixSortTest(); }
+  static void destroySuite(RadixSortTest *suite) { delete suite; }
+
+  void test_keys_preserve_double_ordering() {
+    const std::vector<double> values{-std::numeric_limits<double>::infinity(),
+                                     -1e300,
+                                     -2.5,
+                                     -1e-300,
+                                     0.,
+                                     1e-300,
+                                     2.5,
+                                     1e300,
+                                     std::numeric_limits<double>::infinity()};
+    for (size_t i = 1; i < values.size(); ++i)
+      TS_ASSERT_LESS_THAN(radixSortKey(values[i - 1]), radixSortKey(values[i]));
+  }
+
+  void test_keys_preserve_float_ordering() {
+    const std::vector<float> values{-1e30f, -2.5f, -1e-30f, 0.f,
+                                    1e-30f, 2.5f,  1e30f};
+    for (size_t i = 1; i < values.size(); ++i)
+      TS_ASSERT_LESS_THAN(radixSortKey(values[i - 1]), radixSortKey(values[i]));
+  }
+
+  void test_keys_preserve_integer_ordering() {
+    const std::vector<int64_t> values{std::numeric_limits<int64_t>::min(), -5,
+                                      0, 5,
+                                      std::numeric_limits<int64_t>::max()};
+    for (size_t i = 1; i < values.size(); ++i)
+      TS_ASSERT_LESS_THAN(radixSortKey(values[i - 1]), radixSortKey(values[i]));
+  }
+
+  void test_empty_and_single_value() {
+    std::vector<double> values;
+    TS_ASSERT_THROWS_NOTHING(radixSort(values, keyOfDouble));
+    values.push_back(3.);
+    radixSort(values, keyOfDouble);
+    TS_ASSERT_EQUALS(values, std::vector<double>{3.});
+  }
+
+  void test_sort_doubles() {
+    auto values = randomDoubles(10000, -1000., 1000.);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    radixSort(values, keyOfDouble);
+    TS_ASSERT_EQUALS(values, expected);
+  }
+
+  void test_sort_integers() {
+    auto values = randomIntegers(10000, -1000000, 1000000);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    radixSort(values, [](const int64_t value) { return radixSortKey(value); });
+    TS_ASSERT_EQUALS(values, expected);
+  }
+
+  void test_identical_keys_keep_order() {
+    std::vector<TimePair> pairs{{5, 3.}, {5, 1.}, {5, 2.}};
+    const auto expected = pairs;
+    radixSort(pairs, keyOfPulse);
+    TS_ASSERT_EQUALS(pairs, expected);
+  }
+
+  void test_sort_is_stable() {
+    std::vector<TimePair> pairs{{7, 1.}, {5, 3.}, {7, 0.}, {5, 1.}, {6, 2.}};
+    radixSort(pairs, keyOfPulse);
+    const std::vector<TimePair> expected{
+        {5, 3.}, {5, 1.}, {6, 2.}, {7, 1.}, {7, 0.}};
+    TS_ASSERT_EQUALS(pairs, expected);
+  }
+
+  void test_sort_by_two_keys() {
+    // Large enough to be split between threads where available
+    auto pairs = randomPairs(500000);
+    auto expected = pairs;
+    std::sort(expected.begin(), expected.end());
+    radixSort(pairs, keyOfTof);
+    radixSort(pairs, keyOfPulse);
+    TS_ASSERT_EQUALS(pairs, expected);
+  }
+
+private:
+  static uint64_t keyOfDouble(const double value) {
+    return radixSortKey(value);
+  }
+  static uint64_t keyOfPulse(const TimePair &pair) {
+    return radixSortKey(pair.first);
+  }
+  static uint64_t keyOfTof(const TimePair &pair) {
+    return radixSortKey(pair.second);
+  }
+};
+
+class RadixSortTestPerformance : public CxxTest::TestSuite {
+public:
+  static RadixSortTestPerformance *createSuite() {
+    return new RadixSortTestPerformance();
+  }
+  static void destroySuite(RadixSortTestPerformance *suite) { delete suite; }
+
+  RadixSortTestPerformance()
+      : m_doubleSource(randomDoubles(10000000, 0., 100000.)),
+        m_pairSource(randomPairs(10000000)) {}
+
+  void setUp() override {
+    m_doubles = m_doubleSource;
+    m_pairs = m_pairSource;
+  }
+
+  void test_radix_sort_doubles() {
+    radixSort(m_doubles,
+              [](const double value) { return radixSortKey(value); });
+  }
+
+  void test_std_sort_doubles() {
+    std::sort(m_doubles.begin(), m_doubles.end());
+  }
+
+  void test_radix_sort_pulse_time_tof() {
+    radixSort(m_pairs,
+              [](const TimePair &pair) { return radixSortKey(pair.second); });
+    radixSort(m_pairs,
+              [](const TimePair &pair) { return radixSortKey(pair.first); });
+  }
+
+  void test_std_sort_pulse_time_tof() {
+    std::sort(m_pairs.begin(), m_pairs.end());
+  }
+
+private:
+  const std::vector<double> m_doubleSource;
+  const std::vector<TimePair> m_pairSource;
+  std::vector<double> m_doubles;
+  std::vector<TimePair> m_pairs;
+};
+
+#endif /* MANTID_KERNEL_RADIXSORTTEST_H_ */
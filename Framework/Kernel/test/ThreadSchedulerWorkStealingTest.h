@@ -0,0 +1,144 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_KERNEL_THREADSCHEDULERWORKSTEALINGTEST_H_
+#define MANTID_KERNEL_THREADSCHEDULERWORKSTEALINGTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidKernel/ThreadPool.h"
+#include "MantidKernel/ThreadSchedulerWorkStealing.h"
+
+#include <atomic>
+
+using namespace Mantid::Kernel;
+
+namespace {
+int ThreadSchedulerWorkStealingTest_numDestructed;
+
+class CostTask : public Task {
+public:
+  explicit CostTask(double cost) { m_cost = cost; }
+  ~CostTask() override { ThreadSchedulerWorkStealingTest_numDestructed++; }
+  void run() override {}
+};
+
+/// Counts up, and pushes the given number of children when it runs
+class SplittingTask : public Task {
+public:
+  SplittingTask(ThreadScheduler &scheduler, std::atomic<int> &counter,
+                int children)
+      : m_scheduler(scheduler), m_counter(counter), m_children(children) {}
+  void run() override {
+    ++m_counter;
+    for (int i = 0; i < m_children; ++i)
+      m_scheduler.push(new SplittingTask(m_scheduler, m_counter, 0));
+  }
+
+private:
+  ThreadScheduler &m_scheduler;
+  std::atomic<int> &m_counter;
+  int m_children;
+};
+} // namespace
+
+class ThreadSchedulerWorkStealingTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static ThreadSchedulerWorkStealingTest *createSuite() {
+    return new ThreadSchedulerWorkStealingTest();
+  }
+  static void destroySuite(ThreadSchedulerWorkStealingTest *suite) {
+    delete suite;
+  }
+
+  void test_push_and_clear() {
+    ThreadSchedulerWorkStealingTest_numDestructed = 0;
+    ThreadSchedulerWorkStealing sc(2);
+    TS_ASSERT(sc.empty());
+    sc.push(new CostTask(1.));
+    sc.push(new CostTask(2.));
+    sc.push(new CostTask(3.));
+    TS_ASSERT_EQUALS(sc.size(), 3);
+    TS_ASSERT(!sc.empty());
+    TS_ASSERT_EQUALS(sc.totalCost(), 6.);
+    sc.clear();
+    TS_ASSERT_EQUALS(sc.size(), 0);
+    TS_ASSERT(sc.empty());
+    TS_ASSERT_EQUALS(ThreadSchedulerWorkStealingTest_numDestructed, 3);
+  }
+
+  void test_own_queue_is_last_in_first_out() {
+    ThreadSchedulerWorkStealing sc(2);
+    Task *tasks[4];
+    for (auto &task : tasks) {
+      task = new CostTask(1.);
+      sc.push(task);
+    }
+    // Queue 0 has tasks 0 and 2, queue 1 has tasks 1 and 3
+    popAndCheck(sc, 0, tasks[2]);
+    popAndCheck(sc, 0, tasks[0]);
+    popAndCheck(sc, 1, tasks[3]);
+    popAndCheck(sc, 1, tasks[1]);
+    TS_ASSERT(sc.empty());
+  }
+
+  void test_steals_oldest_task_of_largest_queue() {
+    ThreadSchedulerWorkStealing sc(3);
+    Task *tasks[6];
+    const double costs[6] = {1., 5., 1., 1., 5., 1.};
+    for (size_t i = 0; i < 6; ++i) {
+      tasks[i] = new CostTask(costs[i]);
+      sc.push(tasks[i]);
+    }
+    // Queues: 0 = {0, 3}, 1 = {1, 4}, 2 = {2, 5}
+    popAndCheck(sc, 0, tasks[3]);
+    popAndCheck(sc, 0, tasks[0]);
+    // Thread 0 steals the oldest task of queue 1, which has most work left
+    popAndCheck(sc, 0, tasks[1]);
+    popAndCheck(sc, 2, tasks[5]);
+    popAndCheck(sc, 1, tasks[4]);
+    popAndCheck(sc, 1, tasks[2]);
+    TS_ASSERT(!sc.pop(0));
+    TS_ASSERT(sc.empty());
+  }
+
+  void test_not_empty_while_a_task_runs() {
+    ThreadSchedulerWorkStealing sc(1);
+    sc.push(new CostTask(1.));
+    Task *task = sc.pop(0);
+    TS_ASSERT_EQUALS(sc.size(), 0);
+    TS_ASSERT(!sc.empty());
+    sc.finished(task, 0);
+    TS_ASSERT(sc.empty());
+    TS_ASSERT_EQUALS(sc.totalCostExecuted(), 1.);
+    delete task;
+  }
+
+  void test_tasks_pushed_by_running_tasks_are_run() {
+    auto sc = new ThreadSchedulerWorkStealing(4);
+    ThreadPool pool(sc, 4);
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 10; ++i)
+      pool.schedule(new SplittingTask(*sc, counter, 10));
+    pool.joinAll();
+    TS_ASSERT_EQUALS(counter.load(), 110);
+  }
+
+private:
+  void popAndCheck(ThreadSchedulerWorkStealing &sc, size_t thread,
+                   Task *expected) {
+    Task *task = sc.pop(thread);
+    TS_ASSERT_EQUALS(task, expected);
+    if (task) {
+      sc.finished(task, thread);
+      delete task;
+    }
+  }
+};
+
+#endif /* MANTID_KERNEL_THREADSCHEDULERWORKSTEALINGTEST_H_ */
@@ -72,10 +72,39 @@ private:
   template <typename MDE, size_t nd>
   void binByIterating(typename DataObjects::MDEventWorkspace<MDE, nd>::sptr ws);
 
+  /// Helper method binning all the boxes in one pass
+  template <typename MDE, size_t nd>
+  void binByStreaming(typename DataObjects::MDEventWorkspace<MDE, nd>::sptr ws,
+                      const int numThreads);
+
+  /// The arrays the events are summed into
+  struct BinTarget {
+    signal_t *signals;
+    signal_t *errors;
+    signal_t *numEvents;
+  };
+
   /// Method to bin a single MDBox
   template <typename MDE, size_t nd>
   void binMDBox(DataObjects::MDBox<MDE, nd> *box, const size_t *const chunkMin,
-                const size_t *const chunkMax);
+                const size_t *const chunkMax, const BinTarget &target);
+
+  /// Whether an entire MDBox is in a single bin, from its vertexes
+  template <typename MDE, size_t nd>
+  bool isInSingleBin(const DataObjects::MDBox<MDE, nd> *box,
+                     const size_t *const chunkMin, const size_t *const chunkMax,
+                     size_t &linearIndex) const;
+
+  /// Add the signal of an entire MDBox to a single bin
+  template <typename MDE, size_t nd>
+  void binWholeMDBox(const DataObjects::MDBox<MDE, nd> *box,
+                     const size_t linearIndex, const BinTarget &target);
+
+  /// Bin the events of a MDBox one by one
+  template <typename MDE, size_t nd>
+  void binMDBoxEvents(DataObjects::MDBox<MDE, nd> *box,
+                      const size_t *const chunkMin,
+                      const size_t *const chunkMax, const BinTarget &target);
 
   /// The output MDHistoWorkspace
   Mantid::DataObjects::MDHistoWorkspace_sptr outWS;
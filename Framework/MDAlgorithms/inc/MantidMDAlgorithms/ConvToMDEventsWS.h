@@ -46,14 +46,30 @@ public:
 protected:
   DataObjects::EventWorkspace_const_sptr m_EventWS;
 
+  /// Buffers for the data of the MD events converted from event lists
+  struct MDEventsData {
+    std::vector<float> sigErr;        // signal and error squared of each event
+    std::vector<uint16_t> runIndex;   // run index of each event
+    std::vector<uint32_t> detIds;     // detector id of each event
+    std::vector<coord_t> coordinates; // nd coordinates of each event
+    size_t size() const { return runIndex.size(); }
+    void clear();
+  };
+  // converts the events of a spectrum and appends them to the buffers
+  size_t convertEvents(size_t workspaceIndex, MDTransfInterface &qConverter,
+                       MDEventsData &mdEvents) const;
+
 private:
   // function runs the conversion on
   size_t conversionChunk(size_t workspaceIndex) override;
   // the pointer to the source event workspace as event ws does not work through
   // the public Matrix WS interface
-  /**function converts particular type of events into MD space and add these
-   * events to the workspace itself    */
-  template <class T> size_t convertEventList(size_t workspaceIndex);
+  /**function converts particular type of events into MD space and appends
+   * these events to the buffers */
+  template <class T>
+  size_t convertEventList(size_t workspaceIndex,
+                          MDTransfInterface &qConverter,
+                          MDEventsData &mdEvents) const;
 
   virtual void appendEventsFromInputWS(API::Progress *pProgress,
                                        const API::BoxController_sptr &bc);
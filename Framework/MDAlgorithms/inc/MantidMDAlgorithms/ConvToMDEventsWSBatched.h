@@ -0,0 +1,53 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_MDALGORITHMS_CONVTOMDEVENTSWSBATCHED_H_
+#define MANTID_MDALGORITHMS_CONVTOMDEVENTSWSBATCHED_H_
+
+#include "MantidMDAlgorithms/ConvToMDEventsWS.h"
+
+namespace Mantid {
+namespace API {
+class Progress;
+}
+namespace MDAlgorithms {
+/**
+ * This class creates the MDWorkspace from the collection of
+ * ToF events in batches of spectra. The spectra of a batch are
+ * converted in parallel, every thread into its own buffers. The
+ * events of the batch are then sorted into the boxes of the
+ * workspace in parallel, and every box is filled and split by a
+ * single task, so that no box has to be locked. The difference
+ * with the ConvToMDEventsWS is that it converts the events in
+ * parallel and adds them without locks.
+ */
+class ConvToMDEventsWSBatched : public ConvToMDEventsWS {
+  // Interface function
+  void appendEventsFromInputWS(API::Progress *pProgress,
+                               const API::BoxController_sptr &bc) override;
+
+private:
+  // Returns number of workers for parallel parts
+  int numWorkers() const {
+    return this->m_NumThreads < 0 ? PARALLEL_GET_MAX_THREADS
+                                  : std::max(1, this->m_NumThreads);
+  }
+
+  //-----------  For Parallelization -----------------------------------------
+  /// Name given to the errors of the parallel regions
+  std::string name() const { return "ConvertToMD"; }
+  /// The conversion is cancelled when progress is reported
+  void interruption_point() const {}
+  /// Never set: the parallel regions are not cancelled on their own
+  bool m_cancel{false};
+  /// Set if an exception is thrown, and not caught, within a parallel region
+  bool m_parallelException{false};
+};
+
+} // namespace MDAlgorithms
+} // namespace Mantid
+
+#endif /* MANTID_MDALGORITHMS_CONVTOMDEVENTSWSBATCHED_H_ */
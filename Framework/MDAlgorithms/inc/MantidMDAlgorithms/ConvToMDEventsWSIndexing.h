@@ -9,6 +9,7 @@
 
 #include "MantidMDAlgorithms/ConvToMDEventsWS.h"
 #include "MantidMDAlgorithms/MDEventTreeBuilder.h"
+#include <boost/make_shared.hpp>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -182,8 +183,9 @@ void ConvToMDEventsWSIndexing::appendEvents(API::Progress *pProgress,
   bc->clearGridBoxesCounter(0);
   pProgress->resetNumSteps(2, 0, 1);
 
-  std::vector<MDEventType<ND>> mdEvents =
-      convertEvents<EventType, ND, MDEventType>();
+  // The boxes keep ranges of the sorted events rather than copies of them
+  auto mdEvents = boost::make_shared<std::vector<MDEventType<ND>>>(
+      convertEvents<EventType, ND, MDEventType>());
 
   morton_index::MDSpaceBounds<ND> space;
   const auto &pws = m_OutWSWrapper->pWorkspace();
@@ -198,7 +200,7 @@ void ConvToMDEventsWSIndexing::appendEvents(API::Progress *pProgress,
   using EventDistributor =
       MDEventTreeBuilder<ND, MDEventType,
                          typename std::vector<MDEventType<ND>>::iterator>;
-  EventDistributor distributor(nThreads, mdEvents.size() / nThreads / 10, bc,
+  EventDistributor distributor(nThreads, mdEvents->size() / nThreads / 10, bc,
                                space);
 
   auto rootAndErr = distributor.distribute(mdEvents);
@@ -25,10 +25,10 @@ namespace MDAlgorithms {
 
 class DLLExport ConvToMDSelector {
 public:
-  enum ConverterType { DEFAULT, INDEXED };
+  enum ConverterType { DEFAULT, INDEXED, BATCHED };
   /**
    *
-   * @param tp :: type of converter (indexed or default)
+   * @param tp :: type of converter (indexed, batched or default)
    */
   ConvToMDSelector(ConverterType tp = DEFAULT);
   /// function which selects the convertor depending on workspace type and
@@ -7,6 +7,7 @@
 #ifndef MANTID_MDALGORITHMS_MDEVENTTREEBUILDER_H_
 #define MANTID_MDALGORITHMS_MDEVENTTREEBUILDER_H_
 
+#include <boost/shared_ptr.hpp>
 #include <queue>
 #include <tbb/parallel_sort.h>
 #include <tbb/task_scheduler_init.h>
@@ -70,6 +71,14 @@ public:
    * @return :: pointer to the root node and error
    */
   TreeWithIndexError distribute(std::vector<MDEventType<ND>> &mdEvents);
+  /**
+   * Distributes the events without copying them into the boxes: the boxes
+   * keep ranges of the sorted events, which are shared as a flat event store.
+   * @param mdEvents :: events to distribute around the tree
+   * @return :: pointer to the root node and error
+   */
+  TreeWithIndexError
+  distribute(const boost::shared_ptr<std::vector<MDEventType<ND>>> &mdEvents);
 
 private:
   morton_index::MDCoordinate<ND>
@@ -77,6 +86,11 @@ private:
                  const morton_index::MDSpaceBounds<ND> &space);
   void sortEvents(std::vector<MDEventType<ND>> &mdEvents);
   BoxBase *doDistributeEvents(std::vector<MDEventType<ND>> &mdEvents);
+  Box *
+  createBox(unsigned level,
+            const std::vector<Mantid::Geometry::MDDimensionExtents<coord_t>>
+                &extents,
+            EventIterator begin, EventIterator end);
   void distributeEvents(Task &tsk, const WORKER_TYPE &wtp);
   void pushTask(Task &&tsk);
   std::unique_ptr<Task> popTask();
@@ -92,6 +106,8 @@ private:
   const morton_index::MDSpaceBounds<ND> &m_space;
   std::vector<Mantid::Geometry::MDDimensionExtents<coord_t>> m_extents;
   const API::BoxController_sptr &m_bc;
+  /// The events shared by the boxes, if distributed as a flat event store
+  boost::shared_ptr<const std::vector<MDEvent>> m_flatEvents;
 
   const MortonT m_mortonMin;
   const MortonT m_mortonMax;
@@ -126,15 +142,43 @@ MDEventTreeBuilder<ND, MDEventType, EventIterator>::distribute(
   return {root, err};
 }
 
+template <size_t ND, template <size_t> class MDEventType,
+          typename EventIterator>
+typename MDEventTreeBuilder<ND, MDEventType, EventIterator>::TreeWithIndexError
+MDEventTreeBuilder<ND, MDEventType, EventIterator>::distribute(
+    const boost::shared_ptr<std::vector<MDEvent>> &mdEvents) {
+  m_flatEvents = mdEvents;
+  auto rootAndErr = distribute(*mdEvents);
+  m_flatEvents.reset();
+  return rootAndErr;
+}
+
+/**
+ * Creates a leaf box holding the given range of events, whose coordinates
+ * have already been converted back from the Morton index.
+ */
+template <size_t ND, template <size_t> class MDEventType,
+          typename EventIterator>
+DataObjects::MDBox<MDEventType<ND>, ND> *
+MDEventTreeBuilder<ND, MDEventType, EventIterator>::createBox(
+    unsigned level,
+    const std::vector<Mantid::Geometry::MDDimensionExtents<coord_t>> &extents,
+    EventIterator begin, EventIterator end) {
+  if (m_flatEvents)
+    return new Box(m_bc.get(), level, extents, m_flatEvents, begin, end);
+  return new Box(m_bc.get(), level, extents, begin, end);
+}
+
 template <size_t ND, template <size_t> class MDEventType,
           typename EventIterator>
 DataObjects::MDBoxBase<MDEventType<ND>, ND> *
 MDEventTreeBuilder<ND, MDEventType, EventIterator>::doDistributeEvents(
     std::vector<MDEventType<ND>> &mdEvents) {
   if (mdEvents.size() <= m_bc->getSplitThreshold()) {
+    for (auto &event : mdEvents)
+      IndexCoordinateSwitcher::convertToCoordinates(event, m_space);
     m_bc->incBoxesCounter(0);
-    return new DataObjects::MDBox<MDEvent, ND>(
-        m_bc.get(), 0, m_extents, mdEvents.begin(), mdEvents.end());
+    return createBox(0, m_extents, mdEvents.begin(), mdEvents.end());
   } else {
     auto root =
         new DataObjects::MDGridBox<MDEvent, ND>(m_bc.get(), 0, m_extents);
@@ -316,7 +360,7 @@ void MDEventTreeBuilder<ND, MDEventType, EventIterator>::distributeEvents(
       for (auto it = boxEventStart; it < eventIt; ++it)
         IndexCoordinateSwitcher::convertToCoordinates(*it, m_space);
       m_bc->incBoxesCounter(tsk.level);
-      newBox = new Box(m_bc.get(), tsk.level, extents, boxEventStart, eventIt);
+      newBox = createBox(tsk.level, extents, boxEventStart, eventIt);
     } else {
       m_bc->incGridBoxesCounter(tsk.level);
       newBox = new GridBox(m_bc.get(), tsk.level, extents);
@@ -59,6 +59,12 @@ public:
   void addMDData(std::vector<float> &sigErr, std::vector<uint16_t> &runIndex,
                  std::vector<uint32_t> &detId, std::vector<coord_t> &Coord,
                  size_t dataSize) const;
+  /// add the data to the internal workspace, splitting its boxes in parallel
+  /// where needed. The workspace has to exist and be initiated
+  void addAndSplitMDData(std::vector<float> &sigErr,
+                         std::vector<uint16_t> &runIndex,
+                         std::vector<uint32_t> &detId,
+                         std::vector<coord_t> &Coord, size_t dataSize) const;
   /// releases the shared pointer to the MD workspace, stored by the class and
   /// makes the class instance undefined;
   void releaseWorkspace();
@@ -93,6 +99,9 @@ private:
   /// vector holding function pointers to the code, which adds diffrent
   /// dimension number events to the workspace
   std::vector<fpAddData> mdEvAddAndForget;
+  /// vector holding function pointers to the code, which adds diffrent
+  /// dimension number events to the workspace and splits its boxes
+  std::vector<fpAddData> mdEvAddAndSplit;
   /// vector holding function pointers to the code, which refreshes centroid
   /// (could it be moved to IMD?)
   std::vector<fpVoidMethod> mdCalCentroid;
@@ -109,6 +118,9 @@ private:
   void addMDDataND(float *sigErr, uint16_t *runIndex, uint32_t *detId,
                    coord_t *Coord, size_t dataSize) const;
   template <size_t nd>
+  void addAndSplitMDDataND(float *sigErr, uint16_t *runIndex, uint32_t *detId,
+                           coord_t *Coord, size_t dataSize) const;
+  template <size_t nd>
   void addAndTraceMDDataND(float *sig_err, uint16_t *run_index,
                            uint32_t *det_id, coord_t *Coord,
                            size_t data_size) const;
@@ -8,6 +8,7 @@
 #define MANTID_MDALGORITHMS_MDNORM_H_
 
 #include "MantidAPI/Algorithm.h"
+#include "MantidAPI/SpectraDetectorTypes.h"
 #include "MantidGeometry/Crystal/SymmetryOperationFactory.h"
 #include "MantidMDAlgorithms/DllConfig.h"
 #include "MantidMDAlgorithms/SlicingAlgorithm.h"
@@ -43,13 +44,14 @@ private:
   getValuesFromOtherDimensions(bool &skipNormalization,
                                uint16_t expInfoIndex = 0) const;
   void cacheDimensionXValues();
-  void calculateNormalization(const std::vector<coord_t> &otherValues,
-                              Geometry::SymmetryOperation so,
-                              uint16_t expInfoIndex, size_t soIndex);
+  void calculateNormalization(
+      const std::vector<coord_t> &otherValues,
+      const std::vector<Geometry::SymmetryOperation> &symmetryOps,
+      uint16_t expInfoIndex);
   void calculateIntersections(std::vector<std::array<double, 4>> &intersections,
                               const double theta, const double phi,
-                              Kernel::DblMatrix transform, double lowvalue,
-                              double highvalue);
+                              const Kernel::DblMatrix &transform,
+                              double lowvalue, double highvalue);
   void calcIntegralsForIntersections(const std::vector<double> &xValues,
                                      const API::MatrixWorkspace &integrFlux,
                                      size_t sp, std::vector<double> &yValues);
@@ -86,6 +88,10 @@ private:
   bool m_accumulate;
   /// Flag to indicate that the energy dimension is integrated
   bool m_dEIntegrated;
+  /// Workspace indices of the detectors in the solid angle workspace
+  detid2index_map m_solidAngDetToIdx;
+  /// Workspace indices of the detectors in the flux workspace
+  detid2index_map m_fluxDetToIdx;
   /// Sample position
   Kernel::V3D m_samplePos;
   /// Beam direction
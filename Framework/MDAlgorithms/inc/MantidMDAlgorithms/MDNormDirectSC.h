@@ -8,6 +8,7 @@
 #define MANTID_MDALGORITHMS_MDNORMDIRECTSC_H_
 
 #include "MantidAPI/Algorithm.h"
+#include "MantidAPI/SpectraDetectorTypes.h"
 #include "MantidMDAlgorithms/SlicingAlgorithm.h"
 
 namespace Mantid {
@@ -69,6 +70,8 @@ private:
   size_t m_hIdx, m_kIdx, m_lIdx, m_eIdx;
   /// cached X values along dimensions h,k,l. dE
   std::vector<double> m_hX, m_kX, m_lX, m_eX;
+  /// Workspace indices of the detectors in the solid angle workspace
+  detid2index_map m_solidAngDetToIdx;
   /// Sample position
   Kernel::V3D m_samplePos;
   /// Beam direction
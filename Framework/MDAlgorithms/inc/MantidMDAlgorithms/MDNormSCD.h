@@ -8,6 +8,7 @@
 #define MANTID_MDALGORITHMS_MDNORMSCD_H_
 
 #include "MantidAPI/Algorithm.h"
+#include "MantidAPI/SpectraDetectorTypes.h"
 #include "MantidMDAlgorithms/SlicingAlgorithm.h"
 
 namespace Mantid {
@@ -72,6 +73,10 @@ private:
   size_t m_hIdx, m_kIdx, m_lIdx;
   /// cached X values along dimensions h,k,l
   std::vector<double> m_hX, m_kX, m_lX;
+  /// Workspace indices of the detectors in the flux workspace
+  detid2index_map m_fluxDetToIdx;
+  /// Workspace indices of the detectors in the solid angle workspace
+  detid2index_map m_solidAngDetToIdx;
   /// Sample position
   Kernel::V3D m_samplePos;
   /// Beam direction
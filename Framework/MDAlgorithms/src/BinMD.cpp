@@ -17,6 +17,7 @@
 #include "MantidGeometry/MDGeometry/MDBoxImplicitFunction.h"
 #include "MantidGeometry/MDGeometry/MDHistoDimension.h"
 #include "MantidKernel/CPUTimer.h"
+#include "MantidKernel/DiskPrefetcher.h"
 #include "MantidKernel/EnabledWhenProperty.h"
 #include "MantidKernel/Strings.h"
 #include "MantidKernel/System.h"
@@ -29,6 +30,15 @@ namespace MDAlgorithms {
 // Register the algorithm into the AlgorithmFactory
 DECLARE_ALGORITHM(BinMD)
 
+namespace {
+/// The number of events transformed in one call to the coordinate transform
+constexpr size_t EVENTS_PER_BATCH = 512;
+/// The largest number of bins in the private histograms of the threads
+constexpr size_t MAX_PRIVATE_BINS = 1 << 23;
+/// The number of events of a file-backed workspace read ahead of the binning
+constexpr uint64_t PREFETCH_EVENTS = 1 << 22;
+} // namespace
+
 using namespace Mantid::Kernel;
 using namespace Mantid::API;
 using namespace Mantid::Geometry;
@@ -89,6 +99,85 @@ void BinMD::init() {
                   "A name for the output MDHistoWorkspace.");
 }
 
+//----------------------------------------------------------------------------------------------
+/** Find whether the entire box is in a single bin, from its vertexes. This
+ * needs none of its events, so not reading them from disk either. Only done
+ * for boxes with enough events for it to make sense.
+ *
+ * @param box :: pointer to the MDBox
+ * @param chunkMin :: the minimum index in each dimension to consider "valid"
+ *(inclusive)
+ * @param chunkMax :: the maximum index in each dimension to consider "valid"
+ *(exclusive)
+ * @param linearIndex :: set to the linear index of the bin, if there is one
+ * @return true if all the vertexes of the box are in the same bin
+ */
+template <typename MDE, size_t nd>
+bool BinMD::isInSingleBin(const MDBox<MDE, nd> *box,
+                          const size_t *const chunkMin,
+                          const size_t *const chunkMax,
+                          size_t &linearIndex) const {
+  // There is a check that the number of events is enough for it to make sense
+  // to do all this processing.
+  if (box->getNPoints() <= (1 << nd) * 2)
+    return false;
+  // An array to hold the rotated/transformed coordinates
+  std::vector<coord_t> outCenter(m_outD);
+  size_t numVertexes = 0;
+  auto vertexes = box->getVertexesArray(numVertexes);
+
+  // All vertexes have to be within THE SAME BIN = have the same linear index.
+  for (size_t i = 0; i < numVertexes; i++) {
+    // Cache the center of the event (again for speed)
+    const coord_t *inCenter = vertexes.get() + i * nd;
+
+    // Now transform to the output dimensions
+    m_transform->apply(inCenter, outCenter.data());
+
+    // To build up the linear index
+    size_t vertexIndex = 0;
+    /// Loop through the dimensions on which we bin
+    for (size_t bd = 0; bd < m_outD; bd++) {
+      // What is the bin index in that dimension
+      coord_t x = outCenter[bd];
+      size_t ix = size_t(x);
+      // Within range (for this chunk)?
+      if ((x >= 0) && (ix >= chunkMin[bd]) && (ix < chunkMax[bd])) {
+        // Build up the linear index
+        vertexIndex += indexMultiplier[bd] * ix;
+      } else {
+        // The vertex is outside the range
+        return false;
+      }
+    } // (for each dim in MDHisto)
+
+    // Is the vertex at the same place as the last one?
+    if ((i > 0) && (vertexIndex != linearIndex))
+      return false;
+    linearIndex = vertexIndex;
+  } // (for each vertex)
+  return numVertexes > 0;
+}
+
+//----------------------------------------------------------------------------------------------
+/** Add the CACHED signal of an entire box to a single bin, without looking
+ * at each event.
+ *
+ * @param box :: pointer to the MDBox
+ * @param linearIndex :: the bin found by isInSingleBin()
+ * @param target :: the arrays to add the signal, errors and events to
+ */
+template <typename MDE, size_t nd>
+inline void BinMD::binWholeMDBox(const MDBox<MDE, nd> *box,
+                                 const size_t linearIndex,
+                                 const BinTarget &target) {
+  target.signals[linearIndex] += box->getSignal();
+  target.errors[linearIndex] += box->getErrorSquared();
+  // TODO: If DataObjects get a weight, this would need to get the summed
+  // weight.
+  target.numEvents[linearIndex] += static_cast<signal_t>(box->getNPoints());
+}
+
 //----------------------------------------------------------------------------------------------
 /** Bin the contents of a MDBox
  *
@@ -97,42 +186,64 @@ void BinMD::init() {
  *(inclusive)
  * @param chunkMax :: the maximum index in each dimension to consider "valid"
  *(exclusive)
+ * @param target :: the arrays to add the signal, errors and events to
  */
 template <typename MDE, size_t nd>
 inline void BinMD::binMDBox(MDBox<MDE, nd> *box, const size_t *const chunkMin,
-                            const size_t *const chunkMax) {
-  // An array to hold the rotated/transformed coordinates
-  auto outCenter = new coord_t[m_outD];
-
+                            const size_t *const chunkMax,
+                            const BinTarget &target) {
   // Evaluate whether the entire box is in the same bin
-  if (box->getNPoints() > (1 << nd) * 2) {
-    // There is a check that the number of events is enough for it to make sense
-    // to do all this processing.
-    size_t numVertexes = 0;
-    auto vertexes = box->getVertexesArray(numVertexes);
-
-    // All vertexes have to be within THE SAME BIN = have the same linear index.
-    size_t lastLinearIndex = 0;
-    bool badOne = false;
+  size_t linearIndex = 0;
+  if (isInSingleBin(box, chunkMin, chunkMax, linearIndex)) {
+    // And don't bother looking at each event. This may save lots of time
+    // loading from disk.
+    binWholeMDBox(box, linearIndex, target);
+    return;
+  }
+  binMDBoxEvents(box, chunkMin, chunkMax, target);
+}
 
-    for (size_t i = 0; i < numVertexes; i++) {
-      // Cache the center of the event (again for speed)
-      const coord_t *inCenter = vertexes.get() + i * nd;
+//----------------------------------------------------------------------------------------------
+/** Bin the events of a MDBox one by one
+ *
+ * @param box :: pointer to the MDBox to bin
+ * @param chunkMin :: the minimum index in each dimension to consider "valid"
+ *(inclusive)
+ * @param chunkMax :: the maximum index in each dimension to consider "valid"
+ *(exclusive)
+ * @param target :: the arrays to add the signal, errors and events to
+ */
+template <typename MDE, size_t nd>
+void BinMD::binMDBoxEvents(MDBox<MDE, nd> *box, const size_t *const chunkMin,
+                           const size_t *const chunkMax,
+                           const BinTarget &target) {
+  // The events are transformed in batches, with one call to the transform
+  // for every batch.
+  const auto events = box->getConstEventRange();
+  const size_t batchSize = std::min(events.size(), EVENTS_PER_BATCH);
+  std::vector<coord_t> inCenters(batchSize * nd);
+  std::vector<coord_t> outCenters(batchSize * m_outD);
+  for (const MDE *batch = events.begin(); batch != events.end();) {
+    const size_t count =
+        std::min(batchSize, static_cast<size_t>(events.end() - batch));
+    // Cache the centers of the events (again for speed)
+    for (size_t i = 0; i < count; ++i)
+      std::copy_n(batch[i].getCenter(), nd, inCenters.begin() + i * nd);
 
-      // Now transform to the output dimensions
-      m_transform->apply(inCenter, outCenter);
-      // std::cout << "Input coord " << VMD(nd,inCenter) << " transformed to "
-      // <<  VMD(nd,outCenter) << '\n';
+    // Now transform to the output dimensions
+    m_transform->applyToBatch(inCenters.data(), outCenters.data(), count);
 
+    for (size_t i = 0; i < count; ++i) {
+      const coord_t *eventCenter = outCenters.data() + i * m_outD;
       // To build up the linear index
       size_t linearIndex = 0;
-      // To mark VERTEXES outside range
-      badOne = false;
+      // To mark events outside range
+      bool badOne = false;
 
       /// Loop through the dimensions on which we bin
       for (size_t bd = 0; bd < m_outD; bd++) {
         // What is the bin index in that dimension
-        coord_t x = outCenter[bd];
+        coord_t x = eventCenter[bd];
         size_t ix = size_t(x);
         // Within range (for this chunk)?
         if ((x >= 0) && (ix >= chunkMin[bd]) && (ix < chunkMax[bd])) {
@@ -145,84 +256,21 @@ inline void BinMD::binMDBox(MDBox<MDE, nd> *box, const size_t *const chunkMin,
         }
       } // (for each dim in MDHisto)
 
-      // Is the vertex at the same place as the last one?
       if (!badOne) {
-        if ((i > 0) && (linearIndex != lastLinearIndex)) {
-          // Change of index
-          badOne = true;
-          break;
-        }
-        lastLinearIndex = linearIndex;
-      }
-
-      // Was the vertex completely outside the range?
-      if (badOne)
-        break;
-    } // (for each vertex)
-
-    if (!badOne) {
-      // Yes, the entire box is within a single bin
-      //        std::cout << "Box at " << box->getExtentsStr() << " is within a
-      //        single bin.\n";
-      // Add the CACHED signal from the entire box
-      signals[lastLinearIndex] += box->getSignal();
-      errors[lastLinearIndex] += box->getErrorSquared();
-      // TODO: If DataObjects get a weight, this would need to get the summed
-      // weight.
-      numEvents[lastLinearIndex] += static_cast<signal_t>(box->getNPoints());
-
-      // And don't bother looking at each event. This may save lots of time
-      // loading from disk.
-      delete[] outCenter;
-      return;
-    }
-  }
-
-  // If you get here, you could not determine that the entire box was in the
-  // same bin.
-  // So you need to iterate through events.
-  const std::vector<MDE> &events = box->getConstEvents();
-  for (auto it = events.begin(); it != events.end(); ++it) {
-    // Cache the center of the event (again for speed)
-    const coord_t *inCenter = it->getCenter();
-
-    // Now transform to the output dimensions
-    m_transform->apply(inCenter, outCenter);
-
-    // To build up the linear index
-    size_t linearIndex = 0;
-    // To mark events outside range
-    bool badOne = false;
-
-    /// Loop through the dimensions on which we bin
-    for (size_t bd = 0; bd < m_outD; bd++) {
-      // What is the bin index in that dimension
-      coord_t x = outCenter[bd];
-      size_t ix = size_t(x);
-      // Within range (for this chunk)?
-      if ((x >= 0) && (ix >= chunkMin[bd]) && (ix < chunkMax[bd])) {
-        // Build up the linear index
-        linearIndex += indexMultiplier[bd] * ix;
-      } else {
-        // Outside the range
-        badOne = true;
-        break;
+        // Sum the signals as doubles to preserve precision
+        target.signals[linearIndex] +=
+            static_cast<signal_t>(batch[i].getSignal());
+        target.errors[linearIndex] +=
+            static_cast<signal_t>(batch[i].getErrorSquared());
+        // TODO: If DataObjects get a weight, this would need to get the summed
+        // weight.
+        target.numEvents[linearIndex] += 1.0;
       }
-    } // (for each dim in MDHisto)
-
-    if (!badOne) {
-      // Sum the signals as doubles to preserve precision
-      signals[linearIndex] += static_cast<signal_t>(it->getSignal());
-      errors[linearIndex] += static_cast<signal_t>(it->getErrorSquared());
-      // TODO: If DataObjects get a weight, this would need to get the summed
-      // weight.
-      numEvents[linearIndex] += 1.0;
     }
+    batch += count;
   }
   // Done with the events list
   box->releaseEvents();
-
-  delete[] outCenter;
 }
 
 //----------------------------------------------------------------------------------------------
@@ -257,36 +305,43 @@ void BinMD::binByIterating(typename MDEventWorkspace<MDE, nd>::sptr ws) {
     outWS->setTo(0.0, 0.0, 0.0);
   }
 
-  // The dimension (in the output workspace) along which we chunk for parallel
-  // processing
-  // TODO: Find the smartest dimension to chunk against
-  size_t chunkDimension = 0;
-
-  // How many bins (in that dimension) per chunk.
-  // Try to split it so each core will get 2 tasks:
-  int chunkNumBins = int(m_binDimensions[chunkDimension]->getNBins() /
-                         (PARALLEL_GET_MAX_THREADS * 2));
-  if (chunkNumBins < 1)
-    chunkNumBins = 1;
-
   // Do we actually do it in parallel?
   bool doParallel = getProperty("Parallel");
   // Not if file-backed!
   if (bc->isFileBacked())
     doParallel = false;
-  if (!doParallel)
-    chunkNumBins = int(m_binDimensions[chunkDimension]->getNBins());
 
-  // Total number of steps
-  size_t progNumSteps = 0;
   if (prog) {
     prog->setNotifyStep(0.1);
     prog->resetNumSteps(100, 0.00, 1.0);
   }
 
-  // Run the chunks in parallel. There is no overlap in the output workspace so
-  // it is thread safe to write to it..
-  // cppcheck-suppress syntaxError
+  // Stream through all the boxes once if every thread can have its own copy
+  // of the histogram. Otherwise every thread bins a chunk of the histogram.
+  const int numThreads = doParallel ? PARALLEL_GET_MAX_THREADS : 1;
+  if (outWS->getNPoints() * static_cast<size_t>(numThreads - 1) <=
+      MAX_PRIVATE_BINS) {
+    this->binByStreaming<MDE, nd>(ws, numThreads);
+  } else {
+    // The dimension (in the output workspace) along which we chunk for
+    // parallel processing
+    // TODO: Find the smartest dimension to chunk against
+    size_t chunkDimension = 0;
+
+    // How many bins (in that dimension) per chunk.
+    // Try to split it so each core will get 2 tasks:
+    int chunkNumBins = int(m_binDimensions[chunkDimension]->getNBins() /
+                           (PARALLEL_GET_MAX_THREADS * 2));
+    if (chunkNumBins < 1)
+      chunkNumBins = 1;
+
+    // Total number of steps
+    size_t progNumSteps = 0;
+    const BinTarget target = {signals, errors, numEvents};
+
+    // Run the chunks in parallel. There is no overlap in the output workspace
+    // so it is thread safe to write to it..
+    // cppcheck-suppress syntaxError
     PRAGMA_OMP( parallel for schedule(dynamic,1) if (doParallel) )
     for (int chunk = 0;
          chunk < int(m_binDimensions[chunkDimension]->getNBins());
@@ -338,7 +393,7 @@ void BinMD::binByIterating(typename MDEventWorkspace<MDE, nd>::sptr ws) {
         MDBox<MDE, nd> *box = dynamic_cast<MDBox<MDE, nd> *>(boxe);
         // Perform the binning in this separate method.
         if (box && !box->getIsMasked())
-          this->binMDBox(box, chunkMin.data(), chunkMax.data());
+          this->binMDBox(box, chunkMin.data(), chunkMax.data(), target);
 
         // Progress reporting
         if (prog)
@@ -350,6 +405,7 @@ void BinMD::binByIterating(typename MDEventWorkspace<MDE, nd>::sptr ws) {
       PARALLEL_END_INTERUPT_REGION
     } // for each chunk in parallel
     PARALLEL_CHECK_INTERUPT_REGION
+  }
 
     // Now the implicit function
     if (implicitFunction) {
@@ -363,6 +419,121 @@ void BinMD::binByIterating(typename MDEventWorkspace<MDE, nd>::sptr ws) {
     // bc->setCacheParameters(sizeof(MDE),writeBufSize);
 }
 
+//----------------------------------------------------------------------------------------------
+/** Bin the events by streaming through every box in a single pass. The first
+ * thread adds to the output workspace and every other thread to its own
+ * private histogram. The private histograms are summed at the end.
+ *
+ * @param ws :: MDEventWorkspace of the given type.
+ * @param numThreads :: the number of threads to bin with
+ */
+template <typename MDE, size_t nd>
+void BinMD::binByStreaming(typename MDEventWorkspace<MDE, nd>::sptr ws,
+                           const int numThreads) {
+  // Every box of the workspace which can contribute to the output
+  std::vector<size_t> chunkMin(m_outD, 0);
+  std::vector<size_t> chunkMax(m_outD);
+  for (size_t bd = 0; bd < m_outD; bd++)
+    chunkMax[bd] = m_binDimensions[bd]->getNBins();
+  std::unique_ptr<MDImplicitFunction> function(
+      this->getImplicitFunctionForChunk(chunkMin.data(), chunkMax.data()));
+  std::vector<API::IMDNode *> boxes;
+  // Leaf-only; no depth limit; with the implicit function passed to it.
+  ws->getBox()->getBoxes(boxes, 1000, true, function.get());
+
+  // Sort boxes by file position IF file backed. This reduces seeking time,
+  // hopefully.
+  auto bc = ws->getBoxController();
+  if (bc->isFileBacked())
+    API::IMDNode::sortObjByID(boxes);
+  if (prog)
+    prog->setNumSteps(boxes.size());
+
+  // The boxes entirely in a single bin are binned without their events
+  const size_t noSingleBin = std::numeric_limits<size_t>::max();
+  std::vector<size_t> singleBins(boxes.size(), noSingleBin);
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < static_cast<int64_t>(boxes.size()); ++i) {
+    auto box = dynamic_cast<MDBox<MDE, nd> *>(boxes[i]);
+    size_t linearIndex = 0;
+    if (box && !box->getIsMasked() &&
+        isInSingleBin(box, chunkMin.data(), chunkMax.data(), linearIndex))
+      singleBins[i] = linearIndex;
+  }
+
+  // Read the events of a file-backed workspace on a background thread, in the
+  // order of the boxes, while the boxes before them are binned
+  std::unique_ptr<DiskPrefetcher> prefetcher;
+  if (bc->isFileBacked()) {
+    std::vector<ISaveable *> items(boxes.size(), nullptr);
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      auto box = dynamic_cast<MDBox<MDE, nd> *>(boxes[i]);
+      if (box && !box->getIsMasked() && singleBins[i] == noSingleBin)
+        items[i] = box->getISaveable();
+    }
+    bc->getFileIO()->resetIOStatistics();
+    prefetcher = make_unique<DiskPrefetcher>(
+        *bc->getFileIO(), std::move(items), PREFETCH_EVENTS);
+  }
+
+  // The signal, errors and events of every thread but the first one
+  const size_t numBins = outWS->getNPoints();
+  std::vector<std::vector<signal_t>> privateBins(numThreads - 1);
+
+  PRAGMA_OMP(parallel for schedule(dynamic, 16) num_threads(numThreads))
+  for (int64_t i = 0; i < static_cast<int64_t>(boxes.size()); ++i) {
+    PARALLEL_START_INTERUPT_REGION
+    const int thread = PARALLEL_THREAD_NUMBER;
+    BinTarget target = {signals, errors, numEvents};
+    if (thread > 0) {
+      auto &bins = privateBins[thread - 1];
+      if (bins.empty())
+        bins.resize(3 * numBins, 0.0);
+      target = {bins.data(), bins.data() + numBins, bins.data() + 2 * numBins};
+    }
+
+    if (prefetcher)
+      prefetcher->waitFor(i);
+    auto box = dynamic_cast<MDBox<MDE, nd> *>(boxes[i]);
+    // Perform the binning in these separate methods.
+    if (singleBins[i] != noSingleBin)
+      this->binWholeMDBox(box, singleBins[i], target);
+    else if (box && !box->getIsMasked())
+      this->binMDBoxEvents(box, chunkMin.data(), chunkMax.data(), target);
+    if (prefetcher)
+      prefetcher->release(i);
+
+    // Progress reporting
+    if (prog)
+      prog->report();
+    PARALLEL_END_INTERUPT_REGION
+  }
+  PARALLEL_CHECK_INTERUPT_REGION
+
+  if (prefetcher) {
+    prefetcher.reset();
+    const auto statistics = bc->getFileIO()->getIOStatistics();
+    g_log.information() << "Read " << statistics.dataPrefetched
+                        << " events of " << statistics.objectsPrefetched
+                        << " boxes ahead of binning, waited "
+                        << statistics.prefetchWaits << " times. Wrote "
+                        << statistics.dataWritten << " events of "
+                        << statistics.objectsWritten << " boxes.\n";
+  }
+
+  // Sum the private histograms into the output
+  for (const auto &bins : privateBins) {
+    if (bins.empty())
+      continue;
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int64_t j = 0; j < static_cast<int64_t>(numBins); ++j) {
+      signals[j] += bins[j];
+      errors[j] += bins[numBins + j];
+      numEvents[j] += bins[2 * numBins + j];
+    }
+  }
+}
+
 //----------------------------------------------------------------------------------------------
 /** Execute the algorithm.
  */
@@ -11,10 +11,18 @@
 
 namespace Mantid {
 namespace MDAlgorithms {
-/**function converts particular list of events of type T into MD workspace and
- * adds these events to the workspace itself  */
+/**function converts particular list of events of type T into MD events and
+ * appends them to the buffers
+ * @param workspaceIndex -- the workspace index of the event list
+ * @param qConverter -- the transformation to use. It is modified, so every
+ * thread needs its own one
+ * @param mdEvents -- the buffers to append the MD events to
+ * @return the number of MD events appended
+ */
 template <class T>
-size_t ConvToMDEventsWS::convertEventList(size_t workspaceIndex) {
+size_t ConvToMDEventsWS::convertEventList(size_t workspaceIndex,
+                                          MDTransfInterface &qConverter,
+                                          MDEventsData &mdEvents) const {
 
   const Mantid::DataObjects::EventList &el =
       m_EventWS->getSpectrum(workspaceIndex);
@@ -31,21 +39,23 @@ size_t ConvToMDEventsWS::convertEventList(size_t workspaceIndex) {
   std::vector<coord_t> locCoord(m_Coord);
   // set up unit conversion and calculate up all coordinates, which depend on
   // spectra index only
-  if (!m_QConverter->calcYDepCoordinates(locCoord, workspaceIndex))
+  if (!qConverter.calcYDepCoordinates(locCoord, workspaceIndex))
     return 0; // skip if any y outsize of the range of interest;
   localUnitConv.updateConversion(workspaceIndex);
   //
-  // allocate temporary buffers for MD Events data
-  // MD events coordinates buffer
-  std::vector<coord_t> allCoord;
-  std::vector<float> sig_err;      // array for signal and error.
-  std::vector<uint16_t> run_index; // Buffer for run index for each event
-  std::vector<uint32_t> det_ids;   // Buffer of det Id-s for each event
-
-  allCoord.reserve(this->m_NDims * numEvents);
-  sig_err.reserve(2 * numEvents);
-  run_index.reserve(numEvents);
-  det_ids.reserve(numEvents);
+  // buffers for MD Events data
+  std::vector<coord_t> &allCoord = mdEvents.coordinates;
+  std::vector<float> &sig_err = mdEvents.sigErr;
+  std::vector<uint16_t> &run_index = mdEvents.runIndex;
+  std::vector<uint32_t> &det_ids = mdEvents.detIds;
+  const size_t nExisting = run_index.size();
+  // buffers which accumulate several spectra grow as usual
+  if (nExisting == 0) {
+    allCoord.reserve(this->m_NDims * numEvents);
+    sig_err.reserve(2 * numEvents);
+    run_index.reserve(numEvents);
+    det_ids.reserve(numEvents);
+  }
 
   // This little dance makes the getting vector of events more general (since
   // you can't overload by return type).
@@ -58,7 +68,7 @@ size_t ConvToMDEventsWS::convertEventList(size_t workspaceIndex) {
     double val = localUnitConv.convertUnits(it->tof());
     double signal = it->weight();
     double errorSq = it->errorSquared();
-    if (!m_QConverter->calcMatrixCoord(val, locCoord, signal, errorSq))
+    if (!qConverter.calcMatrixCoord(val, locCoord, signal, errorSq))
       continue; // skip ND outside the range
 
     sig_err.push_back(static_cast<float>(signal));
@@ -68,32 +78,50 @@ size_t ConvToMDEventsWS::convertEventList(size_t workspaceIndex) {
     allCoord.insert(allCoord.end(), locCoord.begin(), locCoord.end());
   }
 
-  // Add them to the MDEW
-  size_t n_added_events = run_index.size();
-  m_OutWSWrapper->addMDData(sig_err, run_index, det_ids, allCoord,
-                            n_added_events);
-  return n_added_events;
+  return run_index.size() - nExisting;
 }
 
-/** The method runs conversion for a single event list, corresponding to a
- * particular workspace index */
-size_t ConvToMDEventsWS::conversionChunk(size_t workspaceIndex) {
+/// Empties the buffers, keeping their memory
+void ConvToMDEventsWS::MDEventsData::clear() {
+  sigErr.clear();
+  runIndex.clear();
+  detIds.clear();
+  coordinates.clear();
+}
 
+/** The method converts the event list corresponding to a particular workspace
+ * index into MD events and appends them to the buffers */
+size_t ConvToMDEventsWS::convertEvents(size_t workspaceIndex,
+                                       MDTransfInterface &qConverter,
+                                       MDEventsData &mdEvents) const {
   switch (m_EventWS->getSpectrum(workspaceIndex).getEventType()) {
   case Mantid::API::TOF:
     return this->convertEventList<Mantid::Types::Event::TofEvent>(
-        workspaceIndex);
+        workspaceIndex, qConverter, mdEvents);
   case Mantid::API::WEIGHTED:
     return this->convertEventList<Mantid::DataObjects::WeightedEvent>(
-        workspaceIndex);
+        workspaceIndex, qConverter, mdEvents);
   case Mantid::API::WEIGHTED_NOTIME:
     return this->convertEventList<Mantid::DataObjects::WeightedEventNoTime>(
-        workspaceIndex);
+        workspaceIndex, qConverter, mdEvents);
   default:
     throw std::runtime_error("EventList had an unexpected data type!");
   }
 }
 
+/** The method runs conversion for a single event list, corresponding to a
+ * particular workspace index */
+size_t ConvToMDEventsWS::conversionChunk(size_t workspaceIndex) {
+  MDEventsData mdEvents;
+  const size_t n_added_events =
+      convertEvents(workspaceIndex, *m_QConverter, mdEvents);
+  // Add them to the MDEW
+  m_OutWSWrapper->addMDData(mdEvents.sigErr, mdEvents.runIndex,
+                            mdEvents.detIds, mdEvents.coordinates,
+                            n_added_events);
+  return n_added_events;
+}
+
 /** method sets up all internal variables necessary to convert from Event
 Workspace to MDEvent workspace
 @param WSD         -- the class describing the target MD workspace, sorurce
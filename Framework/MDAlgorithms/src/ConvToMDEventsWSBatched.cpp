@@ -0,0 +1,81 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidMDAlgorithms/ConvToMDEventsWSBatched.h"
+#include "MantidAPI/Progress.h"
+
+#include <atomic>
+
+namespace Mantid {
+namespace MDAlgorithms {
+
+namespace {
+/// The number of events converted before they are added to the workspace
+constexpr size_t EVENTS_PER_BATCH = 1 << 22;
+
+Kernel::Logger g_log("ConvToMDEventsWSBatched");
+} // namespace
+
+void ConvToMDEventsWSBatched::appendEventsFromInputWS(
+    API::Progress *pProgress, const API::BoxController_sptr & /*bc*/) {
+  const int nThreads = numWorkers();
+  // Every thread has its own transformation and buffers
+  std::vector<MDTransf_sptr> qConverters;
+  for (int i = 0; i < nThreads; ++i)
+    qConverters.emplace_back(m_QConverter->clone());
+  std::vector<MDEventsData> buffers(nThreads);
+  MDEventsData batch;
+
+  pProgress->resetNumSteps(m_NSpectra, 0, 1);
+  m_parallelException = false;
+  size_t batchBegin = 0;
+  while (batchBegin < m_NSpectra) {
+    // Take the spectra until the batch has enough events
+    size_t batchEnd = batchBegin;
+    size_t nEvents = 0;
+    while (batchEnd < m_NSpectra && nEvents < EVENTS_PER_BATCH)
+      nEvents += m_EventWS->getSpectrum(batchEnd++).getNumberEvents();
+
+    // Every worker takes the next spectrum until the batch is done, so the
+    // work is balanced and at most nThreads spectra are converted at once
+    std::atomic<size_t> nextSpectrum(batchBegin);
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int worker = 0; worker < nThreads; ++worker) {
+      PARALLEL_START_INTERUPT_REGION
+      for (size_t wi = nextSpectrum++; wi < batchEnd; wi = nextSpectrum++)
+        convertEvents(wi, *qConverters[worker], buffers[worker]);
+      PARALLEL_END_INTERUPT_REGION
+    }
+    PARALLEL_CHECK_INTERUPT_REGION
+
+    // Gather the events of all threads and add them to the workspace at once
+    for (auto &buffer : buffers) {
+      batch.sigErr.insert(batch.sigErr.end(), buffer.sigErr.cbegin(),
+                          buffer.sigErr.cend());
+      batch.runIndex.insert(batch.runIndex.end(), buffer.runIndex.cbegin(),
+                            buffer.runIndex.cend());
+      batch.detIds.insert(batch.detIds.end(), buffer.detIds.cbegin(),
+                          buffer.detIds.cend());
+      batch.coordinates.insert(batch.coordinates.end(),
+                               buffer.coordinates.cbegin(),
+                               buffer.coordinates.cend());
+      buffer.clear();
+    }
+    m_OutWSWrapper->addAndSplitMDData(batch.sigErr, batch.runIndex,
+                                      batch.detIds, batch.coordinates,
+                                      batch.size());
+    batch.clear();
+
+    batchBegin = batchEnd;
+    pProgress->report(batchEnd);
+  }
+
+  // Recount totals at the end.
+  m_OutWSWrapper->pWorkspace()->refreshCache();
+}
+
+} // namespace MDAlgorithms
+} // namespace Mantid
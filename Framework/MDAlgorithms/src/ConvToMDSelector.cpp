@@ -9,6 +9,7 @@
 #include "MantidAPI/MatrixWorkspace.h"
 #include "MantidDataObjects/EventWorkspace.h"
 #include "MantidDataObjects/Workspace2D.h"
+#include "MantidMDAlgorithms/ConvToMDEventsWSBatched.h"
 #include "MantidMDAlgorithms/ConvToMDEventsWSIndexing.h"
 #include "MantidMDAlgorithms/ConvToMDHistoWS.h"
 
@@ -21,6 +22,19 @@ enum wsType {
   Undefined   //< unknown initial state
 };
 
+/// creates the converter of event workspaces of the requested type
+boost::shared_ptr<ConvToMDBase>
+makeEventsConverter(ConvToMDSelector::ConverterType converterType) {
+  switch (converterType) {
+  case ConvToMDSelector::INDEXED:
+    return boost::make_shared<ConvToMDEventsWSIndexing>();
+  case ConvToMDSelector::BATCHED:
+    return boost::make_shared<ConvToMDEventsWSBatched>();
+  default:
+    return boost::make_shared<ConvToMDEventsWS>();
+  }
+}
+
 ConvToMDSelector::ConvToMDSelector(ConvToMDSelector::ConverterType tp)
     : converterType(tp) {}
 
@@ -64,11 +78,8 @@ boost::shared_ptr<ConvToMDBase> ConvToMDSelector::convSelector(
       (existingWsConvType != inputWSType)) {
     switch (inputWSType) {
     case (EventWS):
-      // check if user set a property to use indexing
-      if (converterType == ConvToMDSelector::DEFAULT)
-        res = boost::make_shared<ConvToMDEventsWS>();
-      else
-        res = boost::make_shared<ConvToMDEventsWSIndexing>();
+      // check if user set a property to use indexing or batching
+      res = makeEventsConverter(converterType);
       break;
     case (Matrix2DWS):
       res = boost::make_shared<ConvToMDHistoWS>();
@@ -81,10 +92,7 @@ boost::shared_ptr<ConvToMDBase> ConvToMDSelector::convSelector(
     // existing converter is suitable for the workspace
     // in case of Event workspace check if user set a property to use indexing
     if (inputWSType == EventWS) {
-      if (converterType == ConvToMDSelector::DEFAULT)
-        res = boost::make_shared<ConvToMDEventsWS>();
-      else
-        res = boost::make_shared<ConvToMDEventsWSIndexing>();
+      res = makeEventsConverter(converterType);
     } else {
       res = boost::make_shared<ConvToMDHistoWS>();
     }
@@ -120,14 +120,16 @@ void ConvertToMD::init() {
                   "workspace. The workspace will load data from the file on "
                   "demand in order to reduce memory use.");
 
-  std::vector<std::string> converterType{"Default", "Indexed"};
+  std::vector<std::string> converterType{"Default", "Indexed", "Batched"};
 
   auto loadTypeValidator =
       boost::make_shared<StringListValidator>(converterType);
   declareProperty("ConverterType", "Default", loadTypeValidator,
-                  "[Default, Indexed], indexed is the experimental type that "
-                  "can speedup the conversion process"
-                  "for the big files using the indexing.");
+                  "[Default, Indexed, Batched], indexed is the experimental "
+                  "type that can speedup the conversion process "
+                  "for the big files using the indexing. Batched converts "
+                  "the events in parallel and splits the boxes without "
+                  "locking them.");
 }
 //----------------------------------------------------------------------------------------------
 
@@ -166,6 +168,10 @@ std::map<std::string, std::string> ConvertToMD::validateInputs() {
           " (2 ,4, 8, 16,..) for indexed version of algorithm. ";
   }
 
+  if (treeBuilderType == "Batched" && fileBackEnd)
+    result["ConverterType"] += "No file back end implemented "
+                               "for batched version of algorithm. ";
+
   std::vector<double> minVals = this->getProperty("MinValues");
   std::vector<double> maxVals = this->getProperty("MaxValues");
 
@@ -281,10 +287,12 @@ void ConvertToMD::exec() {
   // get pointer to appropriate  ConverttToMD plugin from the CovertToMD plugins
   // factory, (will throw if logic is wrong and ChildAlgorithm is not found
   // among existing)
-  ConvToMDSelector::ConverterType convType =
-      getPropertyValue("ConverterType") == "Indexed"
-          ? ConvToMDSelector::INDEXED
-          : ConvToMDSelector::DEFAULT;
+  const std::string converterTypeName = getPropertyValue("ConverterType");
+  ConvToMDSelector::ConverterType convType = ConvToMDSelector::DEFAULT;
+  if (converterTypeName == "Indexed")
+    convType = ConvToMDSelector::INDEXED;
+  else if (converterTypeName == "Batched")
+    convType = ConvToMDSelector::BATCHED;
   ConvToMDSelector AlgoSelector(convType);
   this->m_Convertor = AlgoSelector.convSelector(m_InWS2D, this->m_Convertor);
 
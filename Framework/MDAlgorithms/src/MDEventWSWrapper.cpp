@@ -129,6 +129,66 @@ void MDEventWSWrapper::addMDDataND<0>(float * /*unused*/, uint16_t * /*unused*/,
                               "to 0-dimensional workspace"));
 }
 
+/** templated by number of dimensions function to add multidimensional data to
+the workspace and split the boxes which get too many events, in parallel. The
+events outside of the workspace are rejected.
+
+   tempate parameter:
+     * nd -- number of dimensions
+
+*@param sigErr   -- pointer to the beginning of 2*data_size array containing
+signal and squared error
+*@param runIndex -- pointer to the beginning of data_size  containing run index
+*@param detId    -- pointer to the beginning of dataSize array containing
+detector id-s
+*@param Coord    -- pointer to the beginning of dataSize*nd array containing the
+coordinates of nd-dimensional events
+*
+*@param dataSize -- the length of the vector of MD events
+*/
+template <size_t nd>
+void MDEventWSWrapper::addAndSplitMDDataND(float *sigErr, uint16_t *runIndex,
+                                           uint32_t *detId, coord_t *Coord,
+                                           size_t dataSize) const {
+  auto *const pWs = dynamic_cast<
+      DataObjects::MDEventWorkspace<DataObjects::MDEvent<nd>, nd> *>(
+      m_Workspace.get());
+  if (pWs) {
+    std::vector<DataObjects::MDEvent<nd>> events;
+    events.reserve(dataSize);
+    for (size_t i = 0; i < dataSize; i++)
+      events.emplace_back(*(sigErr + 2 * i), *(sigErr + 2 * i + 1),
+                          *(runIndex + i), *(detId + i), (Coord + i * nd));
+    pWs->addEventsAndSplit(events);
+  } else {
+    auto *const pLWs = dynamic_cast<
+        DataObjects::MDEventWorkspace<DataObjects::MDLeanEvent<nd>, nd> *>(
+        m_Workspace.get());
+    if (!pLWs)
+      throw std::runtime_error("Bad Cast: Target MD workspace to add events "
+                               "does not correspond to type of events you try "
+                               "to add to it");
+
+    std::vector<DataObjects::MDLeanEvent<nd>> events;
+    events.reserve(dataSize);
+    for (size_t i = 0; i < dataSize; i++)
+      events.emplace_back(*(sigErr + 2 * i), *(sigErr + 2 * i + 1),
+                          (Coord + i * nd));
+    pLWs->addEventsAndSplit(events);
+  }
+}
+
+/// terminator for the templated addAndSplitMDDataND, will throw.
+template <>
+void MDEventWSWrapper::addAndSplitMDDataND<0>(float * /*unused*/,
+                                              uint16_t * /*unused*/,
+                                              uint32_t * /*unused*/,
+                                              coord_t * /*unused*/,
+                                              size_t /*unused*/) const {
+  throw(std::invalid_argument(" class has not been initiated, can not add data "
+                              "to 0-dimensional workspace"));
+}
+
 /***/
 template <size_t nd> void MDEventWSWrapper::splitBoxList() {
   DataObjects::MDEventWorkspace<DataObjects::MDEvent<nd>, nd> *const pWs =
@@ -235,6 +295,27 @@ void MDEventWSWrapper::addMDData(std::vector<float> &sigErr,
                                              &detId[0], &Coord[0], dataSize);
 }
 
+/** method adds the data to the workspace which was initiated before, and splits
+ *the boxes of the workspace which get too many events. Boxes are filled and
+ *split in parallel; the events outside of the workspace are rejected.
+ *@param sigErr   -- signal and squared error of the events
+ *@param runIndex -- run index of the events
+ *@param detId    -- detector id-s of the events
+ *@param Coord    -- coordinates of the nd-dimensional events
+ *
+ *@param dataSize -- the number of MD events
+ */
+void MDEventWSWrapper::addAndSplitMDData(std::vector<float> &sigErr,
+                                         std::vector<uint16_t> &runIndex,
+                                         std::vector<uint32_t> &detId,
+                                         std::vector<coord_t> &Coord,
+                                         size_t dataSize) const {
+  if (dataSize == 0)
+    return;
+  (this->*(mdEvAddAndSplit[m_NDimensions]))(&sigErr[0], &runIndex[0],
+                                            &detId[0], &Coord[0], dataSize);
+}
+
 /** method should be called at the end of the algorithm, to let the workspace
 manager know that it has whole responsibility for the workspace
 (As the algorithm is static, it will hold the pointer to the workspace
@@ -256,6 +337,7 @@ public:
     LOOP<i - 1>::EXEC(pH);
     pH->wsCreator[i] = &MDEventWSWrapper::createEmptyEventWS<i>;
     pH->mdEvAddAndForget[i] = &MDEventWSWrapper::addMDDataND<i>;
+    pH->mdEvAddAndSplit[i] = &MDEventWSWrapper::addAndSplitMDDataND<i>;
     pH->mdCalCentroid[i] = &MDEventWSWrapper::calcCentroidND<i>;
     pH->mdBoxListSplitter[i] = &MDEventWSWrapper::splitBoxList<i>;
   }
@@ -267,6 +349,7 @@ public:
   static inline void EXEC(MDEventWSWrapper *pH) {
     pH->wsCreator[0] = &MDEventWSWrapper::createEmptyEventWS<0>;
     pH->mdEvAddAndForget[0] = &MDEventWSWrapper::addMDDataND<0>;
+    pH->mdEvAddAndSplit[0] = &MDEventWSWrapper::addAndSplitMDDataND<0>;
     pH->mdCalCentroid[0] = &MDEventWSWrapper::calcCentroidND<0>;
     pH->mdBoxListSplitter[0] = &MDEventWSWrapper::splitBoxList<0>;
   }
@@ -277,6 +360,7 @@ MDEventWSWrapper::MDEventWSWrapper()
     : m_NDimensions(0), m_needSplitting(false) {
   wsCreator.resize(MAX_N_DIM + 1);
   mdEvAddAndForget.resize(MAX_N_DIM + 1);
+  mdEvAddAndSplit.resize(MAX_N_DIM + 1);
   mdCalCentroid.resize(MAX_N_DIM + 1);
   mdBoxListSplitter.resize(MAX_N_DIM + 1);
   LOOP<MAX_N_DIM>::EXEC(this);
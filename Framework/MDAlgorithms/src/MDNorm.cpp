@@ -56,6 +56,20 @@ constexpr double energyToK = 8.0 * M_PI * M_PI *
 static bool abs_compare(double a, double b) {
   return (std::fabs(a) < std::fabs(b));
 }
+
+// The parts of a trajectory which depend only on the detector, shared by
+// all the symmetry operations
+struct DetectorTrajectory {
+  double theta;
+  double phi;
+  // solid angle times proton charge
+  double solid;
+  // workspace index of the detector in the flux workspace
+  size_t fluxIndex;
+  double lowValue;
+  double highValue;
+  bool valid;
+};
 } // namespace
 
 // Register the algorithm into the AlgorithmFactory
@@ -433,6 +447,15 @@ void MDNorm::exec() {
   this->setProperty("OutputDataWorkspace", outputDataWS);
 
   m_numExptInfos = outputDataWS->getNumExperimentInfo();
+  // The detector mappings are the same for all the experiment infos
+  API::MatrixWorkspace_const_sptr solidAngleWS =
+      getProperty("SolidAngleWorkspace");
+  if (solidAngleWS)
+    m_solidAngDetToIdx = solidAngleWS->getDetectorIDToWorkspaceIndexMap();
+  if (m_diffraction) {
+    API::MatrixWorkspace_const_sptr integrFlux = getProperty("FluxWorkspace");
+    m_fluxDetToIdx = integrFlux->getDetectorIDToWorkspaceIndexMap();
+  }
   // loop over all experiment infos
   for (uint16_t expInfoIndex = 0; expInfoIndex < m_numExptInfos;
        expInfoIndex++) {
@@ -445,12 +468,7 @@ void MDNorm::exec() {
     cacheDimensionXValues();
 
     if (!skipNormalization) {
-      size_t symmOpsIndex = 0;
-      for (const auto &so : symmetryOps) {
-        calculateNormalization(otherValues, so, expInfoIndex, symmOpsIndex);
-        symmOpsIndex++;
-      }
-
+      calculateNormalization(otherValues, symmetryOps, expInfoIndex);
     } else {
       g_log.warning("Binning limits are outside the limits of the MDWorkspace. "
                     "Not applying normalization.");
@@ -891,15 +909,18 @@ void MDNorm::cacheDimensionXValues() {
 
 /**
  * Computed the normalization for the input workspace. Results are stored in
- * m_normWS
+ * m_normWS. The trajectories of all the detectors and all the symmetry
+ * operations are computed in a single parallel loop over the
+ * (detector, symmetry operation) pairs, and summed into the normalization
+ * with atomic additions.
  * @param otherValues - values for dimensions other than Q or DeltaE
- * @param so - symmetry operation
+ * @param symmetryOps - the symmetry operations
  * @param expInfoIndex - current experiment info index
- * @param soIndex - the index of symmetry operation (for progress purposes)
  */
-void MDNorm::calculateNormalization(const std::vector<coord_t> &otherValues,
-                                    Geometry::SymmetryOperation so,
-                                    uint16_t expInfoIndex, size_t soIndex) {
+void MDNorm::calculateNormalization(
+    const std::vector<coord_t> &otherValues,
+    const std::vector<Geometry::SymmetryOperation> &symmetryOps,
+    uint16_t expInfoIndex) {
   const auto &currentExptInfo = *(m_inputWS->getExperimentInfo(expInfoIndex));
   std::vector<double> lowValues, highValues;
   auto *lowValuesLog = dynamic_cast<VectorDoubleProperty *>(
@@ -910,34 +931,63 @@ void MDNorm::calculateNormalization(const std::vector<coord_t> &otherValues,
   highValues = (*highValuesLog)();
 
   DblMatrix R = currentExptInfo.run().getGoniometerMatrix();
-  DblMatrix soMatrix(3, 3);
-  auto v = so.transformHKL(V3D(1, 0, 0));
-  soMatrix.setColumn(0, v);
-  v = so.transformHKL(V3D(0, 1, 0));
-  soMatrix.setColumn(1, v);
-  v = so.transformHKL(V3D(0, 0, 1));
-  soMatrix.setColumn(2, v);
-  soMatrix.Invert();
-  DblMatrix Qtransform = R * m_UB * soMatrix * m_W;
-  Qtransform.Invert();
+  // The transformation from Q_lab to HKL for every symmetry operation
+  std::vector<DblMatrix> Qtransforms;
+  Qtransforms.reserve(symmetryOps.size());
+  for (const auto &so : symmetryOps) {
+    DblMatrix soMatrix(3, 3);
+    auto v = so.transformHKL(V3D(1, 0, 0));
+    soMatrix.setColumn(0, v);
+    v = so.transformHKL(V3D(0, 1, 0));
+    soMatrix.setColumn(1, v);
+    v = so.transformHKL(V3D(0, 0, 1));
+    soMatrix.setColumn(2, v);
+    soMatrix.Invert();
+    DblMatrix Qtransform = R * m_UB * soMatrix * m_W;
+    Qtransform.Invert();
+    Qtransforms.push_back(Qtransform);
+  }
   const double protonCharge = currentExptInfo.run().getProtonCharge();
   const auto &spectrumInfo = currentExptInfo.spectrumInfo();
 
-  // Mappings
   const int64_t ndets = static_cast<int64_t>(spectrumInfo.size());
-  detid2index_map fluxDetToIdx;
-  detid2index_map solidAngDetToIdx;
-  bool haveSA = false;
   API::MatrixWorkspace_const_sptr solidAngleWS =
       getProperty("SolidAngleWorkspace");
   API::MatrixWorkspace_const_sptr integrFlux = getProperty("FluxWorkspace");
-  if (solidAngleWS != nullptr) {
-    haveSA = true;
-    solidAngDetToIdx = solidAngleWS->getDetectorIDToWorkspaceIndexMap();
-  }
-  if (m_diffraction) {
-    fluxDetToIdx = integrFlux->getDetectorIDToWorkspaceIndexMap();
+
+  // The detector parts of the trajectories, computed once for all the
+  // symmetry operations
+  std::vector<DetectorTrajectory> trajectories(ndets);
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < ndets; i++) {
+    auto &trajectory = trajectories[i];
+    trajectory.valid = spectrumInfo.hasDetectors(i) &&
+                       !spectrumInfo.isMonitor(i) && !spectrumInfo.isMasked(i);
+    if (!trajectory.valid)
+      continue;
+    const auto &detector = spectrumInfo.detector(i);
+    trajectory.theta = detector.getTwoTheta(m_samplePos, m_beamDir);
+    trajectory.phi = detector.getPhi();
+    // If the dtefctor is a group, this should be the ID of the first detector
+    const auto detID = detector.getID();
+    // Get solid angle for this contribution
+    trajectory.solid = protonCharge;
+    if (solidAngleWS) {
+      trajectory.solid =
+          solidAngleWS->y(m_solidAngDetToIdx.find(detID)->second)[0] *
+          protonCharge;
+    }
+    // get the flux spetrum number
+    trajectory.fluxIndex =
+        m_diffraction ? m_fluxDetToIdx.find(detID)->second : 0;
+    trajectory.lowValue = lowValues[i];
+    trajectory.highValue = highValues[i];
   }
+  trajectories.erase(std::remove_if(trajectories.begin(), trajectories.end(),
+                                    [](const DetectorTrajectory &trajectory) {
+                                      return !trajectory.valid;
+                                    }),
+                     trajectories.end());
 
   const size_t vmdDims = (m_diffraction) ? 3 : 4;
   std::vector<std::atomic<signal_t>> signalArray(m_normWS->getNPoints());
@@ -945,43 +995,32 @@ void MDNorm::calculateNormalization(const std::vector<coord_t> &otherValues,
   std::vector<double> xValues, yValues;
   std::vector<coord_t> pos, posNew;
 
-  double progStep = 0.7 / static_cast<double>(m_numExptInfos * m_numSymmOps);
-  double progIndex = static_cast<double>(soIndex + expInfoIndex * m_numSymmOps);
-  auto prog =
-      make_unique<API::Progress>(this, 0.3 + progStep * progIndex,
-                                 0.3 + progStep * (1. + progIndex), ndets);
+  const int64_t nSymmOps = static_cast<int64_t>(Qtransforms.size());
+  const int64_t nPairs = static_cast<int64_t>(trajectories.size()) * nSymmOps;
+  double progStep = 0.7 / static_cast<double>(m_numExptInfos);
+  auto prog = make_unique<API::Progress>(
+      this, 0.3 + progStep * expInfoIndex, 0.3 + progStep * (1. + expInfoIndex),
+      static_cast<size_t>(nPairs));
 
   bool safe = true;
   if (m_diffraction) {
     safe = Kernel::threadSafe(*integrFlux);
   }
   // cppcheck-suppress syntaxError
-PRAGMA_OMP(parallel for private(intersections, xValues, yValues, pos, posNew) if (safe))
-for (int64_t i = 0; i < ndets; i++) {
+PRAGMA_OMP(parallel for schedule(dynamic, 64) private(intersections, xValues, yValues, pos, posNew) if (safe))
+for (int64_t pair = 0; pair < nPairs; pair++) {
   PARALLEL_START_INTERUPT_REGION
 
-  if (!spectrumInfo.hasDetectors(i) || spectrumInfo.isMonitor(i) ||
-      spectrumInfo.isMasked(i)) {
-    continue;
-  }
-
-  const auto &detector = spectrumInfo.detector(i);
-  double theta = detector.getTwoTheta(m_samplePos, m_beamDir);
-  double phi = detector.getPhi();
-  // If the dtefctor is a group, this should be the ID of the first detector
-  const auto detID = detector.getID();
+  const auto &trajectory = trajectories[pair / nSymmOps];
+  const auto &Qtransform = Qtransforms[pair % nSymmOps];
 
   // Intersections
-  this->calculateIntersections(intersections, theta, phi, Qtransform,
-                               lowValues[i], highValues[i]);
+  this->calculateIntersections(intersections, trajectory.theta,
+                               trajectory.phi, Qtransform, trajectory.lowValue,
+                               trajectory.highValue);
   if (intersections.empty())
     continue;
-  // Get solid angle for this contribution
-  double solid = protonCharge;
-  if (haveSA) {
-    solid =
-        solidAngleWS->y(solidAngDetToIdx.find(detID)->second)[0] * protonCharge;
-  }
+  const double solid = trajectory.solid;
 
   if (m_diffraction) {
     // -- calculate integrals for the intersection --
@@ -994,12 +1033,11 @@ for (int64_t i = 0; i < ndets; i++) {
     for (auto it = intersectionsBegin; it != intersections.end(); ++it, ++x) {
       *x = (*it)[3];
     }
-    // get the flux spetrum number
-    size_t wsIdx = fluxDetToIdx.find(detID)->second;
     // calculate integrals at momenta from xValues by interpolating between
     // points in spectrum sp
     // of workspace integrFlux. The result is stored in yValues
-    calcIntegralsForIntersections(xValues, *integrFlux, wsIdx, yValues);
+    calcIntegralsForIntersections(xValues, *integrFlux, trajectory.fluxIndex,
+                                  yValues);
   }
 
   // Compute final position in HKL
@@ -1079,7 +1117,7 @@ m_accumulate = true;
  */
 void MDNorm::calculateIntersections(
     std::vector<std::array<double, 4>> &intersections, const double theta,
-    const double phi, Kernel::DblMatrix transform, double lowvalue,
+    const double phi, const Kernel::DblMatrix &transform, double lowvalue,
     double highvalue) {
   V3D qout(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta)),
       qin(0., 0., 1);
@@ -149,6 +149,11 @@ void MDNormDirectSC::exec() {
   setProperty("OutputNormalizationWorkspace", m_normWS);
 
   m_numExptInfos = outputWS->getNumExperimentInfo();
+  // The detector mapping is the same for all the experiment infos
+  API::MatrixWorkspace_const_sptr solidAngleWS =
+      getProperty("SolidAngleWorkspace");
+  if (solidAngleWS != nullptr)
+    m_solidAngDetToIdx = solidAngleWS->getDetectorIDToWorkspaceIndexMap();
   // loop over all experiment infos
   for (uint16_t expInfoIndex = 0; expInfoIndex < m_numExptInfos;
        expInfoIndex++) {
@@ -484,16 +489,10 @@ void MDNormDirectSC::calculateNormalization(
 
   const auto &spectrumInfo = currentExptInfo.spectrumInfo();
 
-  // Mapping
   const int64_t ndets = static_cast<int64_t>(spectrumInfo.size());
-  bool haveSA = false;
   API::MatrixWorkspace_const_sptr solidAngleWS =
       getProperty("SolidAngleWorkspace");
-  detid2index_map solidAngDetToIdx;
-  if (solidAngleWS != nullptr) {
-    haveSA = true;
-    solidAngDetToIdx = solidAngleWS->getDetectorIDToWorkspaceIndexMap();
-  }
+  const bool haveSA = solidAngleWS != nullptr;
 
   const size_t vmdDims = 4;
   std::vector<std::atomic<signal_t>> signalArray(m_normWS->getNPoints());
@@ -504,7 +503,7 @@ void MDNormDirectSC::calculateNormalization(
       make_unique<API::Progress>(this, 0.3 + progStep * expInfoIndex,
                                  0.3 + progStep * (expInfoIndex + 1.), ndets);
   // cppcheck-suppress syntaxError
-PRAGMA_OMP(parallel for private(intersections, pos, posNew))
+PRAGMA_OMP(parallel for schedule(dynamic, 64) private(intersections, pos, posNew))
 for (int64_t i = 0; i < ndets; i++) {
   PARALLEL_START_INTERUPT_REGION
 
@@ -526,8 +525,8 @@ for (int64_t i = 0; i < ndets; i++) {
   // Get solid angle for this contribution
   double solid = protonCharge;
   if (haveSA) {
-    solid =
-        solidAngleWS->y(solidAngDetToIdx.find(detID)->second)[0] * protonCharge;
+    solid = solidAngleWS->y(m_solidAngDetToIdx.find(detID)->second)[0] *
+            protonCharge;
   }
   // Compute final position in HKL
   // pre-allocate for efficiency and copy non-hkl dim values into place
@@ -151,6 +151,12 @@ void MDNormSCD::exec() {
   setProperty("OutputNormalizationWorkspace", m_normWS);
 
   m_numExptInfos = outputWS->getNumExperimentInfo();
+  // The detector mappings are the same for all the experiment infos
+  API::MatrixWorkspace_const_sptr integrFlux = getProperty("FluxWorkspace");
+  m_fluxDetToIdx = integrFlux->getDetectorIDToWorkspaceIndexMap();
+  API::MatrixWorkspace_const_sptr solidAngleWS =
+      getProperty("SolidAngleWorkspace");
+  m_solidAngDetToIdx = solidAngleWS->getDetectorIDToWorkspaceIndexMap();
   // loop over all experiment infos
   for (uint16_t expInfoIndex = 0; expInfoIndex < m_numExptInfos;
        expInfoIndex++) {
@@ -435,12 +441,7 @@ void MDNormSCD::calculateNormalization(
 
   const auto &spectrumInfo = currentExptInfo.spectrumInfo();
 
-  // Mappings
   const int64_t ndets = static_cast<int64_t>(spectrumInfo.size());
-  const detid2index_map fluxDetToIdx =
-      integrFlux->getDetectorIDToWorkspaceIndexMap();
-  const detid2index_map solidAngDetToIdx =
-      solidAngleWS->getDetectorIDToWorkspaceIndexMap();
 
   const size_t vmdDims = 4;
   std::vector<std::atomic<signal_t>> signalArray(m_normWS->getNPoints());
@@ -452,7 +453,7 @@ void MDNormSCD::calculateNormalization(
       make_unique<API::Progress>(this, 0.3 + progStep * expInfoIndex,
                                  0.3 + progStep * (expInfoIndex + 1.), ndets);
   // cppcheck-suppress syntaxError
-PRAGMA_OMP(parallel for private(intersections, xValues, yValues, pos, posNew) if (Kernel::threadSafe(*integrFlux)))
+PRAGMA_OMP(parallel for schedule(dynamic, 64) private(intersections, xValues, yValues, pos, posNew) if (Kernel::threadSafe(*integrFlux)))
 for (int64_t i = 0; i < ndets; i++) {
   PARALLEL_START_INTERUPT_REGION
 
@@ -472,10 +473,10 @@ for (int64_t i = 0; i < ndets; i++) {
     continue;
 
   // get the flux spetrum number
-  size_t wsIdx = fluxDetToIdx.find(detID)->second;
+  size_t wsIdx = m_fluxDetToIdx.find(detID)->second;
   // Get solid angle for this contribution
-  double solid =
-      solidAngleWS->y(solidAngDetToIdx.find(detID)->second)[0] * protonCharge;
+  double solid = solidAngleWS->y(m_solidAngDetToIdx.find(detID)->second)[0] *
+                 protonCharge;
 
   // -- calculate integrals for the intersection --
   // momentum values at intersections
@@ -241,10 +241,10 @@ void MergeMD::doPlus(typename MDEventWorkspace<MDE, nd>::sptr ws2) {
       MDBox<MDE, nd> *box = dynamic_cast<MDBox<MDE, nd> *>(boxes[i]);
       if (box && !box->getIsMasked()) {
         // Copy the events from WS2 and add them into WS1
-        const std::vector<MDE> &events = box->getConstEvents();
+        const auto events = box->getConstEventRange();
         // Add events, with bounds checking
 
-        for (auto it = events.cbegin(); it != events.cend(); ++it) {
+        for (auto it = events.begin(); it != events.end(); ++it) {
           // Create the event
           MDE newEvent(it->getSignal(), it->getErrorSquared(), it->getCenter());
           // Copy extra data, if any
@@ -298,6 +298,44 @@ public:
                  true /*IterateEvents*/, 20 /*numEventsPerBox*/, VMD(0, 0, 1));
   }
 
+  void test_exec_parallel_gives_the_same_as_serial() {
+    Mantid::Geometry::QSample frame;
+    IMDEventWorkspace_sptr in_ws =
+        MDEventsTestHelper::makeAnyMDEWWithFrames<MDLeanEvent<3>, 3>(
+            10, 0.0, 10.0, frame, 7);
+    auto bin = [&in_ws](bool parallel) {
+      BinMD alg;
+      alg.initialize();
+      alg.setChild(true);
+      alg.setProperty("InputWorkspace", in_ws);
+      alg.setProperty("AxisAligned", false);
+      alg.setPropertyValue("BasisVector0", "a,unit,0.8,0.6,0");
+      alg.setPropertyValue("BasisVector1", "b,unit,-0.6,0.8,0");
+      alg.setPropertyValue("OutputExtents", "-1,15,-6,8");
+      alg.setPropertyValue("OutputBins", "33,17");
+      alg.setProperty("Parallel", parallel);
+      alg.setPropertyValue("OutputWorkspace", "BinMDTest_ws");
+      alg.execute();
+      IMDHistoWorkspace_sptr out = alg.getProperty("OutputWorkspace");
+      return boost::dynamic_pointer_cast<MDHistoWorkspace>(out);
+    };
+    auto serial = bin(false);
+    auto parallel = bin(true);
+    TS_ASSERT(serial);
+    TS_ASSERT(parallel);
+    TS_ASSERT_EQUALS(serial->getNPoints(), 33 * 17);
+    TS_ASSERT_EQUALS(parallel->getNPoints(), serial->getNPoints());
+    double totalEvents = 0.0;
+    for (size_t i = 0; i < serial->getNPoints(); ++i) {
+      TS_ASSERT_DELTA(parallel->getSignalAt(i), serial->getSignalAt(i), 1e-5);
+      TS_ASSERT_DELTA(parallel->getErrorAt(i), serial->getErrorAt(i), 1e-5);
+      TS_ASSERT_EQUALS(parallel->getNumEventsAt(i), serial->getNumEventsAt(i));
+      totalEvents += serial->getNumEventsAt(i);
+    }
+    // The rotated slice covers the whole workspace
+    TS_ASSERT_DELTA(totalEvents, 7000.0, 1e-5);
+  }
+
   bool etta(int x, int base) {
     int ii = x - base / 2;
     if (ii < 0)
@@ -1038,6 +1076,93 @@ public:
     runBinMDOnFileBackWorkspace(outWSName);
   }
 
+  void test_filebackend_gives_the_same_as_in_memory() {
+    Mantid::Geometry::QSample frame;
+    IMDEventWorkspace_sptr in_ws =
+        MDEventsTestHelper::makeAnyMDEWWithFrames<MDLeanEvent<3>, 3>(
+            10, 0.0, 10.0, frame, 10);
+    auto filename = saveWorkspace(in_ws);
+    auto fileBackName = loadFileBackWorkspace(filename);
+    auto fileBackWS =
+        AnalysisDataService::Instance().retrieveWS<IMDEventWorkspace>(
+            fileBackName);
+
+    auto binned = [](IMDEventWorkspace_sptr ws) {
+      BinMD alg;
+      alg.setChild(true);
+      alg.setRethrows(true);
+      alg.initialize();
+      alg.setProperty("InputWorkspace", ws);
+      alg.setPropertyValue("AlignedDim0", "Axis0,0.0,10.0, 7");
+      alg.setPropertyValue("AlignedDim1", "Axis1,0.0,10.0, 5");
+      alg.setPropertyValue("AlignedDim2", "Axis2,0.0,10.0, 3");
+      alg.setProperty("IterateEvents", true);
+      alg.setPropertyValue("OutputWorkspace", "unused");
+      alg.execute();
+      TS_ASSERT(alg.isExecuted());
+      IMDHistoWorkspace_sptr out = alg.getProperty("OutputWorkspace");
+      return out;
+    };
+    auto expected = binned(in_ws);
+    auto actual = binned(fileBackWS);
+    TS_ASSERT_EQUALS(actual->getNPoints(), expected->getNPoints());
+    for (size_t i = 0; i < expected->getNPoints(); ++i) {
+      TS_ASSERT_DELTA(actual->getSignalAt(i), expected->getSignalAt(i), 1e-8);
+      TS_ASSERT_DELTA(actual->getErrorAt(i), expected->getErrorAt(i), 1e-8);
+    }
+    // The events were read from the file ahead of the binning
+    const auto statistics =
+        fileBackWS->getBoxController()->getFileIO()->getIOStatistics();
+    TS_ASSERT_LESS_THAN(0, statistics.objectsPrefetched);
+    TS_ASSERT_LESS_THAN(0, statistics.dataPrefetched);
+
+    AnalysisDataService::Instance().remove(fileBackName);
+  }
+
+  void test_filebackend_boxes_in_a_single_bin_are_not_read() {
+    Mantid::Geometry::QSample frame;
+    // 1000 boxes of width 1 with enough events for the vertexes to be checked
+    IMDEventWorkspace_sptr in_ws =
+        MDEventsTestHelper::makeAnyMDEWWithFrames<MDLeanEvent<3>, 3>(
+            10, 0.0, 10.0, frame, 20);
+    auto filename = saveWorkspace(in_ws);
+    auto fileBackName = loadFileBackWorkspace(filename);
+    auto fileBackWS =
+        AnalysisDataService::Instance().retrieveWS<IMDEventWorkspace>(
+            fileBackName);
+
+    auto binned = [](IMDEventWorkspace_sptr ws) {
+      BinMD alg;
+      alg.setChild(true);
+      alg.setRethrows(true);
+      alg.initialize();
+      alg.setProperty("InputWorkspace", ws);
+      alg.setPropertyValue("AlignedDim0", "Axis0,0.0,10.0, 5");
+      alg.setPropertyValue("AlignedDim1", "Axis1,0.0,10.0, 5");
+      alg.setPropertyValue("AlignedDim2", "Axis2,0.0,10.0, 5");
+      alg.setProperty("IterateEvents", true);
+      alg.setPropertyValue("OutputWorkspace", "unused");
+      alg.execute();
+      TS_ASSERT(alg.isExecuted());
+      IMDHistoWorkspace_sptr out = alg.getProperty("OutputWorkspace");
+      return out;
+    };
+    auto expected = binned(in_ws);
+    auto actual = binned(fileBackWS);
+    for (size_t i = 0; i < expected->getNPoints(); ++i) {
+      TS_ASSERT_DELTA(actual->getSignalAt(i), expected->getSignalAt(i), 1e-8);
+      TS_ASSERT_DELTA(actual->getErrorAt(i), expected->getErrorAt(i), 1e-8);
+    }
+    // The 5^3 boxes starting on an even coordinate are in a single bin of
+    // width 2; only the events of the others are read
+    const auto statistics =
+        fileBackWS->getBoxController()->getFileIO()->getIOStatistics();
+    TS_ASSERT_LESS_THAN(0, statistics.objectsPrefetched);
+    TS_ASSERT_LESS_THAN_EQUALS(statistics.objectsPrefetched, uint64_t{875});
+
+    AnalysisDataService::Instance().remove(fileBackName);
+  }
+
   void runBinMDOnFileBackWorkspace(const std::string &outWSName) {
     BinMD alg;
     alg.setChild(true);
@@ -1131,7 +1256,8 @@ public:
     AnalysisDataService::Instance().remove("BinMDTest_ws");
   }
 
-  void do_test(std::string binParams, bool IterateEvents) {
+  void do_test(std::string binParams, bool IterateEvents,
+               bool parallel = false) {
     BinMD alg;
     TS_ASSERT_THROWS_NOTHING(alg.initialize())
     TS_ASSERT(alg.isInitialized())
@@ -1145,6 +1271,7 @@ public:
         alg.setPropertyValue("AlignedDim2", "Axis2," + binParams));
     TS_ASSERT_THROWS_NOTHING(alg.setPropertyValue("AlignedDim3", ""));
     TS_ASSERT_THROWS_NOTHING(alg.setProperty("IterateEvents", IterateEvents));
+    TS_ASSERT_THROWS_NOTHING(alg.setProperty("Parallel", parallel));
     TS_ASSERT_THROWS_NOTHING(
         alg.setPropertyValue("OutputWorkspace", "BinMDTest_ws_histo"));
     TS_ASSERT_THROWS_NOTHING(alg.execute();)
@@ -1156,6 +1283,11 @@ public:
       do_test("2.0,8.0, 60", true);
   }
 
+  void test_3D_60cube_IterateEvents_Parallel() {
+    for (size_t i = 0; i < 1; i++)
+      do_test("2.0,8.0, 60", true, true);
+  }
+
   void test_3D_tinyRegion_60cube_IterateEvents() {
     for (size_t i = 0; i < 1; i++)
       do_test("5.3,5.4, 60", true);
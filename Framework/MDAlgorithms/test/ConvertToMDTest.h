@@ -536,6 +536,73 @@ public:
     }
   }
 
+  void test_batched_converter_gives_the_same_events_as_default() {
+    auto create_alg = AlgorithmManager::Instance().createUnmanaged(
+        "CreateSampleWorkspace");
+    create_alg->initialize();
+    create_alg->setChild(true);
+    create_alg->setProperty("WorkspaceType", "Event");
+    create_alg->setProperty("NumEvents", 1000);
+    create_alg->setProperty("BankPixelWidth", 5);
+    create_alg->setPropertyValue("OutputWorkspace", "dummy");
+    create_alg->execute();
+    MatrixWorkspace_sptr inputWS = create_alg->getProperty("OutputWorkspace");
+
+    auto convert = [&inputWS](const std::string &converterType) {
+      auto convert_alg =
+          AlgorithmManager::Instance().createUnmanaged("ConvertToMD");
+      convert_alg->initialize();
+      convert_alg->setChild(true);
+      convert_alg->setProperty("InputWorkspace", inputWS);
+      convert_alg->setProperty("QDimensions", "Q3D");
+      convert_alg->setProperty("dEAnalysisMode", "Elastic");
+      convert_alg->setProperty("Q3DFrames", "Q_lab");
+      convert_alg->setPropertyValue("MinValues", "-10,-10,-10");
+      convert_alg->setPropertyValue("MaxValues", "10,10,10");
+      convert_alg->setProperty("SplitInto", std::vector<int>(3, 2));
+      convert_alg->setProperty("SplitThreshold", 10);
+      convert_alg->setProperty("ConverterType", converterType);
+      convert_alg->setPropertyValue("OutputWorkspace", "blank");
+      convert_alg->execute();
+      IMDEventWorkspace_sptr outputWS =
+          convert_alg->getProperty("OutputWorkspace");
+      return outputWS;
+    };
+    auto defaultWS = convert("Default");
+    auto batchedWS = convert("Batched");
+    TS_ASSERT(defaultWS);
+    TS_ASSERT(batchedWS);
+
+    auto compare_alg =
+        AlgorithmManager::Instance().createUnmanaged("CompareMDWorkspaces");
+    compare_alg->initialize();
+    compare_alg->setChild(true);
+    compare_alg->setProperty("Workspace1", defaultWS);
+    compare_alg->setProperty("Workspace2", batchedWS);
+    compare_alg->setProperty("Tolerance", 0.00001);
+    compare_alg->setProperty("CheckEvents", true);
+    compare_alg->setProperty("IgnoreBoxID", true);
+    TS_ASSERT_THROWS_NOTHING(compare_alg->execute());
+    bool is_equal = compare_alg->getProperty("Equals");
+    TS_ASSERT(is_equal);
+  }
+
+  void test_batched_converter_does_not_accept_file_back_end() {
+    ConvertToMD alg;
+    alg.initialize();
+    alg.setChild(true);
+    alg.setRethrows(true);
+    alg.setProperty("InputWorkspace", createTestWorkspaces());
+    alg.setProperty("QDimensions", "Q3D");
+    alg.setProperty("dEAnalysisMode", "Direct");
+    alg.setPropertyValue("OutputWorkspace", "blank");
+    alg.setPropertyValue("Filename", "convert_to_md_test_file.nxs");
+    alg.setProperty("FileBackEnd", true);
+    alg.setProperty("ConverterType", "Batched");
+    TS_ASSERT_THROWS(alg.execute(), const std::runtime_error &);
+    TS_ASSERT(!alg.isExecuted());
+  }
+
 private:
   void checkHistogramsHaveBeenStored(const std::string &wsName,
                                      double val = 0.34, double bin_min = 0.3,
@@ -574,6 +641,7 @@ class ConvertToMDTestPerformance : public CxxTest::TestSuite {
 
   Mantid::MDAlgorithms::ConvertToMD convertAlgDefault;
   Mantid::MDAlgorithms::ConvertToMD convertAlgIndexed;
+  Mantid::MDAlgorithms::ConvertToMD convertAlgBatched;
 
   WorkspaceCreationHelper::MockAlgorithm reporter;
 
@@ -748,6 +816,8 @@ public:
 
   void test_EventFromTOFConvBuildTreeIndexed() { convertAlgIndexed.execute(); }
 
+  void test_EventFromTOFConvBuildTreeBatched() { convertAlgBatched.execute(); }
+
   static void setUpConvAlg(Mantid::MDAlgorithms::ConvertToMD &convAlg,
                            const std::string &type, const std::string &inName) {
     static uint32_t cnt = 0;
@@ -839,6 +909,7 @@ public:
 
     setUpConvAlg(convertAlgDefault, "Default", inWsSampleName);
     setUpConvAlg(convertAlgIndexed, "Indexed", inWsSampleName);
+    setUpConvAlg(convertAlgBatched, "Batched", inWsSampleName);
   }
 };
 
@@ -0,0 +1,134 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTIDNEXUSGEOMETRY_NEXUSGEOMETRYCACHE_H
+#define MANTIDNEXUSGEOMETRY_NEXUSGEOMETRYCACHE_H
+
+#include "MantidGeometry/IDTypes.h"
+#include "MantidGeometry/Objects/IObject.h"
+#include "MantidNexusGeometry/DllConfig.h"
+#include "MantidNexusGeometry/TubeBuilder.h"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Mantid {
+namespace Geometry {
+class Instrument;
+}
+namespace NexusGeometry {
+
+/** NexusGeometryCache : The geometry of an instrument read from a NeXus file,
+  recorded in the order it is given to the InstrumentBuilder. The components
+  and the definitions of their shapes can be saved to a binary file, such that
+  a later load of the same file builds the instrument without parsing the
+  geometry groups again.
+*/
+class MANTID_NEXUSGEOMETRY_DLL NexusGeometryCache {
+public:
+  /// Index of the shape of a component which has none
+  static const uint32_t NO_SHAPE;
+
+  explicit NexusGeometryCache(std::string instrumentName = "");
+
+  /// Name of the instrument
+  const std::string &instrumentName() const { return m_instrumentName; }
+
+  /// Adds the definition of a cylinder and returns its index
+  uint32_t addCylinder(const Eigen::Matrix<double, 3, 3> &pointsDef);
+  /// Adds the definition of an OFF mesh and returns its index
+  uint32_t addMesh(std::vector<uint32_t> faceIndices,
+                   std::vector<uint32_t> windingOrder,
+                   std::vector<Eigen::Vector3d> vertices);
+  /// Returns the shape of the given index
+  boost::shared_ptr<const Geometry::IObject> shape(uint32_t index) const;
+
+  /// Adds a bank
+  void addBank(const std::string &localName, const Eigen::Vector3d &position,
+               const Eigen::Quaterniond &rotation);
+  /// Adds a detector to the last bank
+  void addDetectorToLastBank(const std::string &detName, detid_t detId,
+                             const Eigen::Vector3d &relativeOffset,
+                             uint32_t shapeIndex);
+  /// Adds tubes to the last bank
+  void addTubes(const std::string &bankName,
+                const std::vector<detail::TubeBuilder> &tubes,
+                uint32_t pixelShapeIndex);
+  /// Adds a monitor
+  void addMonitor(const std::string &detName, detid_t detId,
+                  const Eigen::Vector3d &position, uint32_t shapeIndex);
+  /// Adds the sample
+  void addSample(const std::string &sampleName,
+                 const Eigen::Vector3d &position);
+  /// Adds the source
+  void addSource(const std::string &sourceName,
+                 const Eigen::Vector3d &position);
+
+  /// Builds the instrument from the recorded components
+  std::unique_ptr<const Geometry::Instrument> createInstrument() const;
+
+  /// Writes the geometry to a binary file
+  void saveToFile(const std::string &fileName) const;
+  /// Reads the geometry from a file written by saveToFile
+  static NexusGeometryCache loadFromFile(const std::string &fileName);
+
+private:
+  enum class ShapeType : uint8_t { Cylinder, Mesh };
+  /// Definition of a shape, as given to the NexusShapeFactory
+  struct ShapeDefinition {
+    ShapeType type;
+    std::vector<uint32_t> faceIndices;
+    std::vector<uint32_t> windingOrder;
+    /// The points defining a cylinder, or the vertices of a mesh
+    std::vector<Eigen::Vector3d> vertices;
+  };
+
+  enum class ComponentType : uint8_t {
+    Bank,
+    Detector,
+    Tubes,
+    Monitor,
+    Sample,
+    Source
+  };
+  /// A component, in the order it is added to the InstrumentBuilder
+  struct Component {
+    ComponentType type;
+    std::string name;
+    /// Detector ID, or the number of tubes of a Tubes entry
+    int32_t id;
+    uint32_t shape;
+    Eigen::Vector3d position;
+    /// Unaligned, such that the components can be held in an std::vector
+    Eigen::Quaternion<double, Eigen::DontAlign> rotation;
+  };
+  /// The pixels of a tube
+  struct Tube {
+    std::vector<Eigen::Vector3d> positions;
+    std::vector<detid_t> ids;
+  };
+
+  uint32_t addShape(ShapeDefinition definition);
+  void addComponent(ComponentType type, const std::string &name, int32_t id,
+                    uint32_t shape, const Eigen::Vector3d &position,
+                    const Eigen::Quaterniond &rotation =
+                        Eigen::Quaterniond::Identity());
+
+  std::string m_instrumentName;
+  std::vector<ShapeDefinition> m_shapeDefinitions;
+  /// Shapes created from the definitions, shared by all their components
+  mutable std::vector<boost::shared_ptr<const Geometry::IObject>> m_shapes;
+  std::vector<Component> m_components;
+  std::vector<Tube> m_tubes;
+};
+
+} // namespace NexusGeometry
+} // namespace Mantid
+
+#endif // MANTIDNEXUSGEOMETRY_NEXUSGEOMETRYCACHE_H
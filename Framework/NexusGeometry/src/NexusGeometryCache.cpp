@@ -0,0 +1,384 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidNexusGeometry/NexusGeometryCache.h"
+#include "MantidGeometry/Instrument.h"
+#include "MantidNexusGeometry/InstrumentBuilder.h"
+#include "MantidNexusGeometry/NexusShapeFactory.h"
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <Poco/TemporaryFile.h>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace Mantid {
+namespace NexusGeometry {
+
+namespace {
+/// Identifies the cache files, followed by the version of the format
+const std::string MAGIC = "MantidNexusGeometryCache";
+const uint32_t VERSION = 1;
+
+static_assert(sizeof(Eigen::Vector3d) == 3 * sizeof(double),
+              "Eigen::Vector3d is expected to be three packed doubles");
+
+/// Writes plain values and vectors of them to a binary file
+class Writer {
+public:
+  explicit Writer(const std::string &fileName)
+      : m_out(fileName, std::ios::binary | std::ios::trunc) {
+    if (!m_out)
+      throw std::runtime_error("Cannot open the geometry cache file " +
+                               fileName + " for writing");
+  }
+  template <typename T> void write(const T &value) {
+    m_out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+  template <typename T> void writeVector(const std::vector<T> &values) {
+    write(static_cast<uint64_t>(values.size()));
+    m_out.write(reinterpret_cast<const char *>(values.data()),
+                static_cast<std::streamsize>(values.size() * sizeof(T)));
+  }
+  void writeString(const std::string &value) {
+    write(static_cast<uint64_t>(value.size()));
+    m_out.write(value.data(), static_cast<std::streamsize>(value.size()));
+  }
+  void close() {
+    m_out.close();
+    if (!m_out)
+      throw std::runtime_error("Failed to write the geometry cache file");
+  }
+
+private:
+  std::ofstream m_out;
+};
+
+/// Reads the values written by a Writer, checking they are within the file
+class Reader {
+public:
+  explicit Reader(const std::string &fileName)
+      : m_in(fileName, std::ios::binary) {
+    if (!m_in)
+      throw std::runtime_error("Cannot open the geometry cache file " +
+                               fileName);
+    m_in.seekg(0, std::ios::end);
+    m_remaining = static_cast<size_t>(m_in.tellg());
+    m_in.seekg(0, std::ios::beg);
+  }
+  template <typename T> T read() {
+    T value;
+    readBytes(&value, sizeof(T));
+    return value;
+  }
+  template <typename T> std::vector<T> readVector() {
+    const auto size = read<uint64_t>();
+    if (size > m_remaining / sizeof(T))
+      throw std::runtime_error("The geometry cache file is truncated");
+    std::vector<T> values(static_cast<size_t>(size));
+    readBytes(values.data(), values.size() * sizeof(T));
+    return values;
+  }
+  std::string readString() {
+    const auto chars = readVector<char>();
+    return std::string(chars.cbegin(), chars.cend());
+  }
+
+private:
+  void readBytes(void *data, const size_t size) {
+    if (size > m_remaining ||
+        !m_in.read(static_cast<char *>(data),
+                   static_cast<std::streamsize>(size)))
+      throw std::runtime_error("The geometry cache file is truncated");
+    m_remaining -= size;
+  }
+
+  std::ifstream m_in;
+  size_t m_remaining;
+};
+} // namespace
+
+const uint32_t NexusGeometryCache::NO_SHAPE =
+    std::numeric_limits<uint32_t>::max();
+
+/// Constructor
+NexusGeometryCache::NexusGeometryCache(std::string instrumentName)
+    : m_instrumentName(std::move(instrumentName)) {}
+
+/** Add the definition of a cylindrical shape
+@param pointsDef The points defining the cylinder, as given to
+NexusShapeFactory::createCylinder
+@return The index of the shape
+*/
+uint32_t
+NexusGeometryCache::addCylinder(const Eigen::Matrix<double, 3, 3> &pointsDef) {
+  ShapeDefinition definition{ShapeType::Cylinder, {}, {}, {}};
+  for (int i = 0; i < 3; ++i)
+    definition.vertices.emplace_back(pointsDef.col(i));
+  return addShape(std::move(definition));
+}
+
+/** Add the definition of an OFF mesh shape
+@param faceIndices Index of the first vertex of each face in the winding order
+@param windingOrder Order of the vertices of the faces
+@param vertices Vertices of the mesh
+@return The index of the shape
+*/
+uint32_t NexusGeometryCache::addMesh(std::vector<uint32_t> faceIndices,
+                                     std::vector<uint32_t> windingOrder,
+                                     std::vector<Eigen::Vector3d> vertices) {
+  return addShape({ShapeType::Mesh, std::move(faceIndices),
+                   std::move(windingOrder), std::move(vertices)});
+}
+
+uint32_t NexusGeometryCache::addShape(ShapeDefinition definition) {
+  m_shapeDefinitions.push_back(std::move(definition));
+  m_shapes.emplace_back();
+  return static_cast<uint32_t>(m_shapeDefinitions.size() - 1);
+}
+
+/** Get a shape, which is created from its definition the first time it is
+requested. This is not thread safe.
+@param index The index of the shape, or NO_SHAPE
+@return The shape, or a null pointer for NO_SHAPE
+*/
+boost::shared_ptr<const Geometry::IObject>
+NexusGeometryCache::shape(const uint32_t index) const {
+  if (index == NO_SHAPE)
+    return boost::shared_ptr<const Geometry::IObject>(nullptr);
+  auto &shape = m_shapes.at(index);
+  if (!shape) {
+    const auto &definition = m_shapeDefinitions[index];
+    if (definition.type == ShapeType::Cylinder) {
+      Eigen::Matrix<double, 3, 3> pointsDef;
+      for (int i = 0; i < 3; ++i)
+        pointsDef.col(i) = definition.vertices[i];
+      shape = NexusShapeFactory::createCylinder(pointsDef);
+    } else {
+      shape = NexusShapeFactory::createFromOFFMesh(definition.faceIndices,
+                                                   definition.windingOrder,
+                                                   definition.vertices);
+    }
+  }
+  return shape;
+}
+
+void NexusGeometryCache::addComponent(const ComponentType type,
+                                      const std::string &name,
+                                      const int32_t id, const uint32_t shape,
+                                      const Eigen::Vector3d &position,
+                                      const Eigen::Quaterniond &rotation) {
+  m_components.push_back({type, name, id, shape, position, rotation});
+}
+
+void NexusGeometryCache::addBank(const std::string &localName,
+                                 const Eigen::Vector3d &position,
+                                 const Eigen::Quaterniond &rotation) {
+  addComponent(ComponentType::Bank, localName, 0, NO_SHAPE, position,
+               rotation);
+}
+
+void NexusGeometryCache::addDetectorToLastBank(
+    const std::string &detName, const detid_t detId,
+    const Eigen::Vector3d &relativeOffset, const uint32_t shapeIndex) {
+  addComponent(ComponentType::Detector, detName, detId, shapeIndex,
+               relativeOffset);
+}
+
+/** Add tubes to the last bank. Only the positions and IDs of their pixels are
+recorded, the tubes are built again from them by createInstrument.
+@param bankName Bank name
+@param tubes Tubes to be added to the bank
+@param pixelShapeIndex Index of the shape of each detector within the tubes
+*/
+void NexusGeometryCache::addTubes(const std::string &bankName,
+                                  const std::vector<detail::TubeBuilder> &tubes,
+                                  const uint32_t pixelShapeIndex) {
+  addComponent(ComponentType::Tubes, bankName,
+               static_cast<int32_t>(tubes.size()), pixelShapeIndex,
+               Eigen::Vector3d::Zero());
+  for (const auto &tube : tubes)
+    m_tubes.push_back({tube.detPositions(), tube.detIDs()});
+}
+
+void NexusGeometryCache::addMonitor(const std::string &detName,
+                                    const detid_t detId,
+                                    const Eigen::Vector3d &position,
+                                    const uint32_t shapeIndex) {
+  addComponent(ComponentType::Monitor, detName, detId, shapeIndex, position);
+}
+
+void NexusGeometryCache::addSample(const std::string &sampleName,
+                                   const Eigen::Vector3d &position) {
+  addComponent(ComponentType::Sample, sampleName, 0, NO_SHAPE, position);
+}
+
+void NexusGeometryCache::addSource(const std::string &sourceName,
+                                   const Eigen::Vector3d &position) {
+  addComponent(ComponentType::Source, sourceName, 0, NO_SHAPE, position);
+}
+
+/** Build the instrument by replaying the recorded components, in order, on an
+InstrumentBuilder
+@return The instrument
+*/
+std::unique_ptr<const Geometry::Instrument>
+NexusGeometryCache::createInstrument() const {
+  InstrumentBuilder builder(m_instrumentName);
+  auto nextTube = m_tubes.cbegin();
+  for (const auto &component : m_components) {
+    switch (component.type) {
+    case ComponentType::Bank:
+      builder.addBank(component.name, component.position,
+                      Eigen::Quaterniond(component.rotation));
+      break;
+    case ComponentType::Detector:
+      builder.addDetectorToLastBank(component.name, component.id,
+                                    component.position,
+                                    shape(component.shape));
+      break;
+    case ComponentType::Tubes: {
+      const auto pixelShape = shape(component.shape);
+      std::vector<detail::TubeBuilder> tubes;
+      tubes.reserve(static_cast<size_t>(component.id));
+      for (int32_t i = 0; i < component.id; ++i, ++nextTube) {
+        tubes.emplace_back(*pixelShape, nextTube->positions.front(),
+                           nextTube->ids.front());
+        for (size_t j = 1; j < nextTube->ids.size(); ++j) {
+          if (!tubes.back().addDetectorIfCoLinear(nextTube->positions[j],
+                                                  nextTube->ids[j]))
+            throw std::runtime_error(
+                "The pixels of a tube in the geometry cache are not colinear");
+        }
+      }
+      builder.addTubes(component.name, tubes, pixelShape);
+      break;
+    }
+    case ComponentType::Monitor: {
+      auto monitorShape = shape(component.shape);
+      builder.addMonitor(component.name, component.id, component.position,
+                         monitorShape);
+      break;
+    }
+    case ComponentType::Sample:
+      builder.addSample(component.name, component.position);
+      break;
+    case ComponentType::Source:
+      builder.addSource(component.name, component.position);
+      break;
+    }
+  }
+  return builder.createInstrument();
+}
+
+/** Write the geometry to a binary file. It is written to a temporary file
+of a unique name in the same directory first, which is then renamed, such
+that a partially written cache is never read and concurrent writers do not
+write to the same file.
+@param fileName The path of the file
+*/
+void NexusGeometryCache::saveToFile(const std::string &fileName) const {
+  const std::string tempName = Poco::TemporaryFile::tempName(
+      Poco::Path(fileName).makeAbsolute().parent().toString());
+  try {
+    Writer writer(tempName);
+    writer.writeString(MAGIC);
+    writer.write(VERSION);
+    writer.writeString(m_instrumentName);
+    writer.write(static_cast<uint64_t>(m_shapeDefinitions.size()));
+    for (const auto &definition : m_shapeDefinitions) {
+      writer.write(definition.type);
+      writer.writeVector(definition.faceIndices);
+      writer.writeVector(definition.windingOrder);
+      writer.writeVector(definition.vertices);
+    }
+    writer.write(static_cast<uint64_t>(m_components.size()));
+    for (const auto &component : m_components) {
+      writer.write(component.type);
+      writer.writeString(component.name);
+      writer.write(component.id);
+      writer.write(component.shape);
+      writer.write(component.position);
+      writer.write(component.rotation.coeffs().eval());
+    }
+    writer.write(static_cast<uint64_t>(m_tubes.size()));
+    for (const auto &tube : m_tubes) {
+      writer.writeVector(tube.positions);
+      writer.writeVector(tube.ids);
+    }
+    writer.close();
+    Poco::File(tempName).renameTo(fileName);
+  } catch (...) {
+    if (Poco::File(tempName).exists())
+      Poco::File(tempName).remove();
+    throw;
+  }
+}
+
+/** Read the geometry from a file written by saveToFile
+@param fileName The path of the file
+@return The geometry
+@throws std::runtime_error if the file is not a valid geometry cache of the
+current version
+*/
+NexusGeometryCache
+NexusGeometryCache::loadFromFile(const std::string &fileName) {
+  Reader reader(fileName);
+  if (reader.readString() != MAGIC || reader.read<uint32_t>() != VERSION)
+    throw std::runtime_error(fileName +
+                             " is not a geometry cache of this version");
+  NexusGeometryCache cache(reader.readString());
+
+  const auto numShapes = reader.read<uint64_t>();
+  for (uint64_t i = 0; i < numShapes; ++i) {
+    ShapeDefinition definition;
+    definition.type = reader.read<ShapeType>();
+    definition.faceIndices = reader.readVector<uint32_t>();
+    definition.windingOrder = reader.readVector<uint32_t>();
+    definition.vertices = reader.readVector<Eigen::Vector3d>();
+    if (definition.type != ShapeType::Mesh &&
+        (definition.type != ShapeType::Cylinder ||
+         definition.vertices.size() != 3))
+      throw std::runtime_error("Invalid shape in the geometry cache file");
+    cache.addShape(std::move(definition));
+  }
+
+  size_t numTubes = 0;
+  const auto numComponents = reader.read<uint64_t>();
+  for (uint64_t i = 0; i < numComponents; ++i) {
+    Component component;
+    component.type = reader.read<ComponentType>();
+    component.name = reader.readString();
+    component.id = reader.read<int32_t>();
+    component.shape = reader.read<uint32_t>();
+    component.position = reader.read<Eigen::Vector3d>();
+    component.rotation.coeffs() = reader.read<Eigen::Vector4d>();
+    if (component.type > ComponentType::Source ||
+        (component.shape != NO_SHAPE && component.shape >= numShapes))
+      throw std::runtime_error("Invalid component in the geometry cache file");
+    if (component.type == ComponentType::Tubes) {
+      if (component.id < 0 || component.shape == NO_SHAPE)
+        throw std::runtime_error("Invalid tubes in the geometry cache file");
+      numTubes += static_cast<size_t>(component.id);
+    }
+    cache.m_components.push_back(std::move(component));
+  }
+
+  if (reader.read<uint64_t>() != numTubes)
+    throw std::runtime_error("Invalid tubes in the geometry cache file");
+  for (size_t i = 0; i < numTubes; ++i) {
+    Tube tube;
+    tube.positions = reader.readVector<Eigen::Vector3d>();
+    tube.ids = reader.readVector<detid_t>();
+    if (tube.ids.empty() || tube.ids.size() != tube.positions.size())
+      throw std::runtime_error("Invalid tube in the geometry cache file");
+    cache.m_tubes.push_back(std::move(tube));
+  }
+  return cache;
+}
+
+} // namespace NexusGeometry
+} // namespace Mantid
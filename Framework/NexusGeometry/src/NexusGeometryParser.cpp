@@ -11,15 +11,18 @@
 #include "MantidGeometry/Rendering/GeometryHandler.h"
 #include "MantidGeometry/Rendering/ShapeInfo.h"
 #include "MantidKernel/ChecksumHelper.h"
+#include "MantidKernel/ConfigService.h"
 #include "MantidKernel/EigenConversionHelpers.h"
+#include "MantidKernel/Logger.h"
 #include "MantidKernel/make_unique.h"
 #include "MantidNexusGeometry/Hdf5Version.h"
-#include "MantidNexusGeometry/InstrumentBuilder.h"
-#include "MantidNexusGeometry/NexusShapeFactory.h"
+#include "MantidNexusGeometry/NexusGeometryCache.h"
 #include "MantidNexusGeometry/TubeHelpers.h"
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 #include <H5Cpp.h>
+#include <Poco/File.h>
+#include <Poco/Path.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/optional.hpp>
 #include <boost/regex.hpp>
@@ -34,6 +37,8 @@ using namespace H5;
 
 // Anonymous namespace
 namespace {
+Kernel::Logger g_log("NexusGeometryParser");
+
 const H5G_obj_t GROUP_TYPE = static_cast<H5G_obj_t>(0);
 const H5G_obj_t DATASET_TYPE = static_cast<H5G_obj_t>(1);
 const H5std_string NX_CLASS = "NX_class";
@@ -91,6 +96,14 @@ std::vector<R> convertVector(const std::vector<T> &toConvert) {
   return target;
 }
 
+std::vector<Eigen::Vector3d> toVector3d(const std::vector<float> &values) {
+  std::vector<Eigen::Vector3d> vectors;
+  vectors.reserve(values.size() / 3);
+  for (size_t i = 0; i + 2 < values.size(); i += 3)
+    vectors.emplace_back(values[i], values[i + 1], values[i + 2]);
+  return vectors;
+}
+
 template <typename ExpectedT> void validateStorageType(const DataSet &data) {
 
   const auto typeClass = data.getTypeClass();
@@ -478,8 +491,8 @@ std::vector<Mantid::detid_t> getDetectorIds(const Group &detectorGroup) {
 }
 
 // Parse cylinder nexus geometry
-boost::shared_ptr<const Geometry::IObject>
-parseNexusCylinder(const Group &shapeGroup) {
+uint32_t parseNexusCylinder(const Group &shapeGroup,
+                            NexusGeometryCache &geometry) {
   H5std_string pointsToVertices = "cylinders";
   std::vector<int> cPoints = get1DDataset<int>(pointsToVertices, shapeGroup);
 
@@ -492,19 +505,18 @@ parseNexusCylinder(const Group &shapeGroup) {
   for (int i = 0; i < 3; ++i) {
     vSorted.col(cPoints[i]) = vertices.col(i);
   }
-  return NexusShapeFactory::createCylinder(vSorted);
+  return geometry.addCylinder(vSorted);
 }
 
 // Parse OFF (mesh) nexus geometry
-boost::shared_ptr<const Geometry::IObject>
-parseNexusMesh(const Group &shapeGroup) {
-  const std::vector<uint32_t> faceIndices = convertVector<int32_t, uint32_t>(
+uint32_t parseNexusMesh(const Group &shapeGroup, NexusGeometryCache &geometry) {
+  std::vector<uint32_t> faceIndices = convertVector<int32_t, uint32_t>(
       get1DDataset<int32_t>("faces", shapeGroup));
-  const std::vector<uint32_t> windingOrder = convertVector<int32_t, uint32_t>(
+  std::vector<uint32_t> windingOrder = convertVector<int32_t, uint32_t>(
       get1DDataset<int32_t>("winding_order", shapeGroup));
   const auto vertices = get1DDataset<float>("vertices", shapeGroup);
-  return NexusShapeFactory::createFromOFFMesh(faceIndices, windingOrder,
-                                              vertices);
+  return geometry.addMesh(std::move(faceIndices), std::move(windingOrder),
+                          toVector3d(vertices));
 }
 
 void extractFacesAndIDs(const std::vector<uint32_t> &detFaces,
@@ -548,7 +560,7 @@ void parseNexusMeshAndAddDetectors(
     const std::vector<uint32_t> &windingOrder,
     const std::vector<float> &vertices, const size_t numDets,
     const std::unordered_map<int, uint32_t> &detIdToIndex,
-    const std::string &name, InstrumentBuilder &builder) {
+    const std::string &name, NexusGeometryCache &geometry) {
   auto vertsPerFace = windingOrder.size() / faceIndices.size();
   std::vector<std::vector<Eigen::Vector3d>> detFaceVerts(numDets);
   std::vector<std::vector<uint32_t>> detFaceIndices(numDets);
@@ -572,14 +584,14 @@ void parseNexusMeshAndAddDetectors(
     std::for_each(detVerts.begin(), detVerts.end(),
                   [&centre](Eigen::Vector3d &val) { val -= centre; });
 
-    auto shape =
-        NexusShapeFactory::createFromOFFMesh(detIndices, detWinding, detVerts);
-    builder.addDetectorToLastBank(name + "_" + std::to_string(i), detIds[i],
-                                  centre, std::move(shape));
+    const auto shape =
+        geometry.addMesh(detIndices, detWinding, std::move(detVerts));
+    geometry.addDetectorToLastBank(name + "_" + std::to_string(i), detIds[i],
+                                   centre, shape);
   }
 }
 
-void parseAndAddBank(const Group &shapeGroup, InstrumentBuilder &builder,
+void parseAndAddBank(const Group &shapeGroup, NexusGeometryCache &geometry,
                      const std::vector<int> &detectorIds,
                      const std::string &bankName) {
   // Load mapping between detector IDs and faces, winding order of vertices for
@@ -601,12 +613,12 @@ void parseAndAddBank(const Group &shapeGroup, InstrumentBuilder &builder,
 
   parseNexusMeshAndAddDetectors(detFaces, faceIndices, windingOrder, vertices,
                                 detectorIds.size(), detIdToIndex, bankName,
-                                builder);
+                                geometry);
 }
 
 /// Choose what shape type to parse
-boost::shared_ptr<const Geometry::IObject>
-parseNexusShape(const Group &detectorGroup, bool &searchTubes) {
+uint32_t parseNexusShape(const Group &detectorGroup,
+                         NexusGeometryCache &geometry, bool &searchTubes) {
   bool isGroup = false;
   Group shapeGroup;
   try {
@@ -618,7 +630,7 @@ parseNexusShape(const Group &detectorGroup, bool &searchTubes) {
     try {
       shapeGroup = detectorGroup.openGroup(SHAPE);
     } catch (H5::Exception &) {
-      return boost::shared_ptr<const Geometry::IObject>(nullptr);
+      return NexusGeometryCache::NO_SHAPE;
     }
   }
 
@@ -634,9 +646,9 @@ parseNexusShape(const Group &detectorGroup, bool &searchTubes) {
   // Give shape group to correct shape parser
   if (shapeType == NX_CYLINDER) {
     searchTubes = isGroup;
-    return parseNexusCylinder(shapeGroup);
+    return parseNexusCylinder(shapeGroup, geometry);
   } else if (shapeType == NX_OFF) {
-    return parseNexusMesh(shapeGroup);
+    return parseNexusMesh(shapeGroup, geometry);
   } else {
     throw std::runtime_error(
         "Shape type not recognised by NexusGeometryParser");
@@ -645,7 +657,7 @@ parseNexusShape(const Group &detectorGroup, bool &searchTubes) {
 
 // Parse source and add to instrument
 void parseAndAddSource(const H5File &file, const Group &root,
-                       InstrumentBuilder &builder) {
+                       NexusGeometryCache &geometry) {
   Group entryGroup = *findGroup(root, NX_ENTRY);
   Group instrumentGroup = *findGroup(entryGroup, NX_INSTRUMENT);
   Group sourceGroup = *findGroup(instrumentGroup, NX_SOURCE);
@@ -654,12 +666,12 @@ void parseAndAddSource(const H5File &file, const Group &root,
     sourceName = get1DStringDataset("name", sourceGroup);
   auto sourceTransformations = getTransformations(file, sourceGroup);
   auto defaultPos = Eigen::Vector3d(0.0, 0.0, 0.0);
-  builder.addSource(sourceName, sourceTransformations * defaultPos);
+  geometry.addSource(sourceName, sourceTransformations * defaultPos);
 }
 
 // Parse sample and add to instrument
 void parseAndAddSample(const H5File &file, const Group &root,
-                       InstrumentBuilder &builder) {
+                       NexusGeometryCache &geometry) {
   Group entryGroup = *findGroup(root, NX_ENTRY);
   Group sampleGroup = *findGroup(entryGroup, NX_SAMPLE);
   auto sampleTransforms = getTransformations(file, sampleGroup);
@@ -667,11 +679,11 @@ void parseAndAddSample(const H5File &file, const Group &root,
   std::string sampleName = "Unspecified";
   if (findDataset(sampleGroup, "name"))
     sampleName = get1DStringDataset("name", sampleGroup);
-  builder.addSample(sampleName, samplePos);
+  geometry.addSample(sampleName, samplePos);
 }
 
 void parseMonitors(const H5File &file, const H5::Group &root,
-                   InstrumentBuilder &builder) {
+                   NexusGeometryCache &geometry) {
   std::vector<Group> rawDataGroupPaths = openSubGroups(root, NX_ENTRY);
 
   // Open all instrument groups within rawDataGroups
@@ -685,9 +697,9 @@ void parseMonitors(const H5File &file, const H5::Group &root,
           throw std::invalid_argument("NXmonitors must have " + DETECTOR_ID);
         auto detectorId = get1DDataset<int64_t>(DETECTOR_ID, monitor)[0];
         bool proxy = false;
-        auto monitorShape = parseNexusShape(monitor, proxy);
+        auto monitorShape = parseNexusShape(monitor, geometry, proxy);
         auto monitorTransforms = getTransformations(file, monitor);
-        builder.addMonitor(
+        geometry.addMonitor(
             std::to_string(detectorId), static_cast<int32_t>(detectorId),
             monitorTransforms * Eigen::Vector3d{0, 0, 0}, monitorShape);
       }
@@ -695,9 +707,8 @@ void parseMonitors(const H5File &file, const H5::Group &root,
   }
 }
 
-std::unique_ptr<const Mantid::Geometry::Instrument>
-extractInstrument(const H5File &file, const Group &root) {
-  InstrumentBuilder builder(instrumentName(root));
+NexusGeometryCache extractGeometry(const H5File &file, const Group &root) {
+  NexusGeometryCache geometry(instrumentName(root));
   // Get path to all detector groups
   const std::vector<Group> detectorGroups = openDetectorGroups(root);
   for (auto &detectorGroup : detectorGroups) {
@@ -713,13 +724,13 @@ extractInstrument(const H5File &file, const Group &root) {
     if (findDataset(detectorGroup, BANK_NAME))
       bankName = get1DStringDataset(BANK_NAME,
                                     detectorGroup); // local_name is optional
-    builder.addBank(bankName, bankPos, bankRotation);
+    geometry.addBank(bankName, bankPos, bankRotation);
     // Get the pixel detIds
     auto detectorIds = getDetectorIds(detectorGroup);
 
     try {
       auto shapeGroup = detectorGroup.openGroup(DETECTOR_SHAPE);
-      parseAndAddBank(shapeGroup, builder, detectorIds, bankName);
+      parseAndAddBank(shapeGroup, geometry, detectorIds, bankName);
       continue;
     } catch (H5::Exception &) { // No detector_shape group
     }
@@ -730,38 +741,208 @@ extractInstrument(const H5File &file, const Group &root) {
     Pixels detectorPixels = Eigen::Affine3d::Identity() * pixelOffsets;
     bool searchTubes = false;
     // Extract shape
-    auto detShape = parseNexusShape(detectorGroup, searchTubes);
+    auto detShape = parseNexusShape(detectorGroup, geometry, searchTubes);
 
     if (searchTubes) {
-      auto tubes =
-          TubeHelpers::findAndSortTubes(*detShape, detectorPixels, detectorIds);
-      builder.addTubes(bankName, tubes, detShape);
+      auto tubes = TubeHelpers::findAndSortTubes(
+          *geometry.shape(detShape), detectorPixels, detectorIds);
+      geometry.addTubes(bankName, tubes, detShape);
     } else {
       for (size_t i = 0; i < detectorIds.size(); ++i) {
         auto index = static_cast<int>(i);
         std::string name = bankName + "_" + std::to_string(index);
 
         Eigen::Vector3d relativePos = detectorPixels.col(index);
-        builder.addDetectorToLastBank(name, detectorIds[index], relativePos,
-                                      detShape);
+        geometry.addDetectorToLastBank(name, detectorIds[index], relativePos,
+                                       detShape);
       }
     }
   }
   // Sort the detectors
   // Parse source and sample and add to instrument
-  parseAndAddSample(file, root, builder);
-  parseAndAddSource(file, root, builder);
-  parseMonitors(file, root, builder);
-  return builder.createInstrument();
+  parseAndAddSample(file, root, geometry);
+  parseAndAddSource(file, root, geometry);
+  parseMonitors(file, root, geometry);
+  return geometry;
+}
+
+// DataSet and Attribute take their read() arguments in different orders
+void readValues(const DataSet &data, const DataType &type, void *buffer) {
+  data.read(buffer, type);
+}
+void readValues(const DataSet &data, const DataType &type, H5std_string &text) {
+  data.read(text, type);
+}
+void readValues(const Attribute &attribute, const DataType &type,
+                void *buffer) {
+  attribute.read(type, buffer);
+}
+void readValues(const Attribute &attribute, const DataType &type,
+                H5std_string &text) {
+  attribute.read(type, text);
+}
+
+/// Append the values of a dataset or attribute, as stored, to a key
+template <typename T> void appendValues(const T &data, std::string &key) {
+  const auto dataType = data.getDataType();
+  if (dataType.isVariableStr()) {
+    H5std_string text;
+    readValues(data, dataType, text);
+    key += text;
+  } else {
+    std::string bytes(
+        data.getSpace().getSelectNpoints() * dataType.getSize(), '\0');
+    readValues(data, dataType, static_cast<void *>(&bytes[0]));
+    key += bytes;
+  }
+  key += '\0';
+}
+
+/// Append the values of a dataset to a key, if the group has it
+void appendDataset(const Group &group, const H5std_string &name,
+                   std::string &key) {
+  if (const auto data = findDataset(group, name)) {
+    key += name + '\0';
+    appendValues(*data, key);
+  }
+}
+
+/// Append all the datasets of a group and of its subgroups to a key
+void appendGroup(const Group &group, std::string &key) {
+  for (hsize_t i = 0; i < group.getNumObjs(); ++i) {
+    const H5std_string name = group.getObjnameByIdx(i);
+    key += name + '\0';
+    if (group.getObjTypeByIdx(i) == GROUP_TYPE)
+      appendGroup(group.openGroup(name), key);
+    else if (group.getObjTypeByIdx(i) == DATASET_TYPE)
+      appendValues(group.openDataSet(name), key);
+  }
+}
+
+/// Append the chain of transformations of a component to a key, as read by
+/// getTransformations()
+void appendTransformations(const H5File &file, const Group &group,
+                           std::string &key) {
+  if (H5Lexists(group.getId(), DEPENDS_ON.c_str(), H5P_DEFAULT) <= 0)
+    return;
+  H5std_string dependency = get1DStringDataset(DEPENDS_ON, group);
+  while (dependency != NO_DEPENDENCY) {
+    key += dependency + '\0';
+    const DataSet transformation = file.openDataSet(dependency);
+    appendValues(transformation, key);
+    dependency = NO_DEPENDENCY;
+    for (int i = 0; i < transformation.getNumAttrs(); ++i) {
+      const Attribute attribute =
+          transformation.openAttribute(static_cast<unsigned>(i));
+      key += attribute.getName() + '\0';
+      appendValues(attribute, key);
+      if (attribute.getName() == DEPENDS_ON)
+        attribute.read(attribute.getDataType(), dependency);
+    }
+  }
+}
+
+/// Append what the parser reads of a component to a key
+void appendComponent(const H5File &file, const Group &group,
+                     std::string &key) {
+  for (const auto &name :
+       {DETECTOR_IDS, DETECTOR_ID, X_PIXEL_OFFSET, Y_PIXEL_OFFSET,
+        Z_PIXEL_OFFSET, BANK_NAME, H5std_string("name")})
+    appendDataset(group, name, key);
+  for (const auto &name : {PIXEL_SHAPE, DETECTOR_SHAPE, SHAPE}) {
+    if (H5Lexists(group.getId(), name.c_str(), H5P_DEFAULT) > 0) {
+      key += name + '\0';
+      appendGroup(group.openGroup(name), key);
+    }
+  }
+  appendTransformations(file, group, key);
+}
+
+/** A digest of the geometry of a NeXus file: the instrument name and the
+ * datasets of its detectors, monitors, source and sample which the parser
+ * reads. Unlike the events and logs of the run, these are the same in all
+ * the files of an instrument with the same geometry.
+ */
+std::string geometryDigest(const H5File &file, const Group &root) {
+  std::string key = instrumentName(root) + '\0';
+  for (const auto &detector : openDetectorGroups(root))
+    appendComponent(file, detector, key);
+  for (const auto &entry : openSubGroups(root, NX_ENTRY)) {
+    for (const auto &instrument : openSubGroups(entry, NX_INSTRUMENT)) {
+      for (const auto &monitor : openSubGroups(instrument, NX_MONITOR))
+        appendComponent(file, monitor, key);
+      if (const auto source = findGroup(instrument, NX_SOURCE))
+        appendComponent(file, *source, key);
+    }
+    if (const auto sample = findGroup(entry, NX_SAMPLE))
+      appendComponent(file, *sample, key);
+  }
+  return Kernel::ChecksumHelper::sha1FromString(key);
+}
+
+/** The path of the geometry cache file of a NeXus file, in a cache
+ * directory. The name is the digest of its geometry, such that the files of
+ * all the runs of an instrument share the cache until its geometry changes.
+ * Empty if there is no cache directory.
+ */
+std::string geometryCacheFileName(const H5File &file, const Group &root,
+                                  const std::string &cacheDirectory) {
+  if (cacheDirectory.empty())
+    return "";
+  Poco::Path path(cacheDirectory);
+  path.makeDirectory();
+  if (!Poco::File(path).exists())
+    return "";
+  path.append(geometryDigest(file, root) + ".nxgeom");
+  return path.toString();
 }
 } // namespace
 
+/** Create the instrument described by the NeXus geometry of a file. The
+ * geometry read from the file is saved in the local geometry cache, from which
+ * later calls for files with the same geometry build the instrument without
+ * parsing it.
+ * @param fileName The path of the NeXus file
+ * @return The instrument
+ */
 std::unique_ptr<const Geometry::Instrument>
 NexusGeometryParser::createInstrument(const std::string &fileName) {
+  return createInstrument(
+      fileName, Kernel::ConfigService::Instance().getVTPFileDirectory());
+}
 
+/** Create the instrument described by the NeXus geometry of a file, using the
+ * geometry cache of the given directory.
+ * @param fileName The path of the NeXus file
+ * @param cacheDirectory The directory of the geometry cache. If it is empty
+ * the file is always parsed and no cache is written.
+ * @return The instrument
+ */
+std::unique_ptr<const Geometry::Instrument>
+NexusGeometryParser::createInstrument(const std::string &fileName,
+                                      const std::string &cacheDirectory) {
   const H5File file(fileName, H5F_ACC_RDONLY);
   auto rootGroup = file.openGroup("/");
-  return extractInstrument(file, rootGroup);
+  const auto cacheFile = geometryCacheFileName(file, rootGroup, cacheDirectory);
+  if (!cacheFile.empty() && Poco::File(cacheFile).exists()) {
+    try {
+      return NexusGeometryCache::loadFromFile(cacheFile).createInstrument();
+    } catch (std::exception &e) {
+      g_log.warning() << "Ignoring the geometry cache file " << cacheFile
+                      << ": " << e.what() << '\n';
+    }
+  }
+
+  const auto geometry = extractGeometry(file, rootGroup);
+  if (!cacheFile.empty()) {
+    try {
+      geometry.saveToFile(cacheFile);
+    } catch (std::exception &e) {
+      g_log.warning() << "Failed to write the geometry cache file "
+                      << cacheFile << ": " << e.what() << '\n';
+    }
+  }
+  return geometry.createInstrument();
 }
 
 // Create a unique instrument name from Nexus file
@@ -0,0 +1,156 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTIDNEXUSGEOMETRY_NEXUSGEOMETRYCACHETEST_H
+#define MANTIDNEXUSGEOMETRY_NEXUSGEOMETRYCACHETEST_H
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidGeometry/Instrument.h"
+#include "MantidGeometry/Instrument/ComponentInfo.h"
+#include "MantidGeometry/Instrument/DetectorInfo.h"
+#include "MantidNexusGeometry/NexusGeometryCache.h"
+#include "MantidNexusGeometry/TubeHelpers.h"
+#include "MantidTestHelpers/NexusGeometryTestHelpers.h"
+
+#include <Poco/TemporaryFile.h>
+#include <fstream>
+
+using namespace Mantid;
+using namespace NexusGeometry;
+
+namespace {
+NexusGeometryCache makeGeometry() {
+  NexusGeometryCache geometry("testInstrument");
+  Eigen::Matrix<double, 3, 3> pointsDef;
+  pointsDef.col(0) = Eigen::Vector3d(-0.00101, 0.0, 0.0);
+  pointsDef.col(1) = Eigen::Vector3d(-0.00101, 0.00405, 0.0);
+  pointsDef.col(2) = Eigen::Vector3d(0.00101, 0.0, 0.0);
+  const auto cylinder = geometry.addCylinder(pointsDef);
+
+  geometry.addBank("bank0", {0, 0, 1},
+                   Eigen::Quaterniond(
+                       Eigen::AngleAxisd(M_PI / 2, Eigen::Vector3d::UnitY())));
+  geometry.addDetectorToLastBank("bank0_0", 1, {0, 0.01, 0}, cylinder);
+  geometry.addDetectorToLastBank("bank0_1", 2, {0, 0.02, 0}, cylinder);
+
+  geometry.addBank("bank1", {0, 1, 1}, Eigen::Quaterniond::Identity());
+  const auto tubes = TubeHelpers::findAndSortTubes(
+      *geometry.shape(cylinder),
+      NexusGeometryTestHelpers::generateCoLinearPixels(),
+      NexusGeometryTestHelpers::getFakeDetIDs());
+  geometry.addTubes("bank1", tubes, cylinder);
+
+  geometry.addBank("bank2", {1, 0, 1}, Eigen::Quaterniond::Identity());
+  const auto square =
+      geometry.addMesh({0}, {0, 1, 2, 3},
+                       {{-0.1, -0.1, 0}, {0.1, -0.1, 0}, {0.1, 0.1, 0},
+                        {-0.1, 0.1, 0}});
+  geometry.addDetectorToLastBank("bank2_0", 10, {0, 0, 0}, square);
+
+  geometry.addSample("sample", {0, 0, 0});
+  geometry.addSource("source", {0, 0, -10});
+  geometry.addMonitor("20", 20, {0, 0, -1}, NexusGeometryCache::NO_SHAPE);
+  return geometry;
+}
+
+std::pair<std::unique_ptr<Geometry::ComponentInfo>,
+          std::unique_ptr<Geometry::DetectorInfo>>
+extractBeamline(const Geometry::Instrument &instrument) {
+  Geometry::ParameterMap pmap;
+  auto beamline = instrument.makeBeamline(pmap);
+  return {std::move(std::get<0>(beamline)), std::move(std::get<1>(beamline))};
+}
+} // namespace
+
+class NexusGeometryCacheTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static NexusGeometryCacheTest *createSuite() {
+    return new NexusGeometryCacheTest();
+  }
+  static void destroySuite(NexusGeometryCacheTest *suite) { delete suite; }
+
+  void test_create_instrument() {
+    const auto instrument = makeGeometry().createInstrument();
+    TS_ASSERT_EQUALS(instrument->getName(), "testInstrument");
+    auto beamline = extractBeamline(*instrument);
+    const auto &detectorInfo = *beamline.second;
+    // Two pixels, four in two tubes, one mesh pixel and the monitor
+    TS_ASSERT_EQUALS(detectorInfo.size(), 8);
+    TS_ASSERT_EQUALS(detectorInfo.detectorIDs(),
+                     std::vector<detid_t>({1, 2, 4, 5, 6, 7, 10, 20}));
+    TS_ASSERT(detectorInfo.isMonitor(detectorInfo.indexOf(20)));
+    TS_ASSERT(!detectorInfo.isMonitor(detectorInfo.indexOf(10)));
+    // The pixel offsets are relative to their bank
+    TS_ASSERT_EQUALS(detectorInfo.position(0), Kernel::V3D(0, 0.01, 1));
+    const auto &componentInfo = *beamline.first;
+    TS_ASSERT(componentInfo.hasSample());
+    TS_ASSERT_EQUALS(componentInfo.sourcePosition(), Kernel::V3D(0, 0, -10));
+  }
+
+  void test_save_and_load_give_the_same_instrument() {
+    const auto geometry = makeGeometry();
+    Poco::TemporaryFile file;
+    geometry.saveToFile(file.path());
+    const auto loaded = NexusGeometryCache::loadFromFile(file.path());
+    TS_ASSERT_EQUALS(loaded.instrumentName(), geometry.instrumentName());
+
+    const auto expected = extractBeamline(*geometry.createInstrument());
+    const auto actual = extractBeamline(*loaded.createInstrument());
+    const auto &expectedComponents = *expected.first;
+    const auto &actualComponents = *actual.first;
+    TS_ASSERT_EQUALS(actualComponents.size(), expectedComponents.size());
+    for (size_t i = 0; i < expectedComponents.size(); ++i) {
+      TS_ASSERT_EQUALS(actualComponents.name(i), expectedComponents.name(i));
+      TS_ASSERT_EQUALS(actualComponents.position(i),
+                       expectedComponents.position(i));
+      TS_ASSERT_EQUALS(actualComponents.rotation(i),
+                       expectedComponents.rotation(i));
+      TS_ASSERT_EQUALS(actualComponents.hasValidShape(i),
+                       expectedComponents.hasValidShape(i));
+    }
+    TS_ASSERT_EQUALS(actual.second->detectorIDs(),
+                     expected.second->detectorIDs());
+  }
+
+  void test_shapes_are_shared() {
+    const auto geometry = makeGeometry();
+    TS_ASSERT_EQUALS(geometry.shape(0), geometry.shape(0));
+    TS_ASSERT(!geometry.shape(NexusGeometryCache::NO_SHAPE));
+  }
+
+  void test_load_throws_for_a_file_which_is_not_a_cache() {
+    Poco::TemporaryFile file;
+    {
+      std::ofstream out(file.path());
+      out << "not a geometry cache";
+    }
+    TS_ASSERT_THROWS(NexusGeometryCache::loadFromFile(file.path()),
+                     const std::runtime_error &);
+  }
+
+  void test_load_throws_for_a_truncated_file() {
+    Poco::TemporaryFile file;
+    makeGeometry().saveToFile(file.path());
+    std::string content;
+    {
+      std::ifstream in(file.path(), std::ios::binary);
+      content.assign(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+    }
+    {
+      std::ofstream out(file.path(), std::ios::binary | std::ios::trunc);
+      out.write(content.data(),
+                static_cast<std::streamsize>(content.size() - 10));
+    }
+    TS_ASSERT_THROWS(NexusGeometryCache::loadFromFile(file.path()),
+                     const std::runtime_error &);
+  }
+};
+
+#endif // MANTIDNEXUSGEOMETRY_NEXUSGEOMETRYCACHETEST_H
@@ -21,7 +21,10 @@
 #include "MantidNexusGeometry/NexusGeometryParser.h"
 
 #include <H5Cpp.h>
+#include <Poco/File.h>
 #include <Poco/Glob.h>
+#include <Poco/Path.h>
+#include <Poco/TemporaryFile.h>
 #include <chrono>
 #include <string>
 
@@ -51,12 +54,17 @@ public:
   }
   static void destroySuite(NexusGeometryParserTest *suite) { delete suite; }
 
-  std::unique_ptr<const Mantid::Geometry::Instrument> makeTestInstrument() {
+  std::string testFilePath() {
     H5std_string nexusFilename = "unit_testing/SMALLFAKE_example_geometry.hdf5";
-    const auto fullpath = Kernel::ConfigService::Instance().getFullPath(
+    return Kernel::ConfigService::Instance().getFullPath(
         nexusFilename, true, Poco::Glob::GLOB_DEFAULT);
+  }
 
-    return NexusGeometryParser::createInstrument(fullpath);
+  /// The geometry cache is bypassed unless a cache directory is given
+  std::unique_ptr<const Mantid::Geometry::Instrument>
+  makeTestInstrument(const std::string &cacheDirectory = "") {
+    return NexusGeometryParser::createInstrument(testFilePath(),
+                                                 cacheDirectory);
   }
 
   void test_basic_instrument_information() {
@@ -96,6 +104,76 @@ public:
         0, 0, -34.281))); // Check against fixed position in file
   }
 
+  void test_repeated_load_from_the_geometry_cache() {
+    Poco::TemporaryFile cacheDirectory;
+    cacheDirectory.createDirectories();
+    // The second instrument is built from the geometry cache written by the
+    // first load
+    auto parsed = extractBeamline(*makeTestInstrument(cacheDirectory.path()));
+    std::vector<std::string> cacheFiles;
+    cacheDirectory.list(cacheFiles);
+    TS_ASSERT_EQUALS(cacheFiles.size(), 1);
+    auto cached = extractBeamline(*makeTestInstrument(cacheDirectory.path()));
+    TS_ASSERT_EQUALS(cached.first->size(), parsed.first->size());
+    TS_ASSERT_EQUALS(cached.second->detectorIDs(),
+                     parsed.second->detectorIDs());
+    for (size_t i = 0; i < parsed.first->size(); ++i) {
+      TS_ASSERT_EQUALS(cached.first->name(i), parsed.first->name(i));
+      TS_ASSERT_EQUALS(cached.first->position(i), parsed.first->position(i));
+    }
+  }
+
+  void test_runs_with_the_same_geometry_share_the_geometry_cache() {
+    Poco::TemporaryFile dataDirectory;
+    dataDirectory.createDirectories();
+    const auto copy = [&](const std::string &name) {
+      const std::string path =
+          Poco::Path(dataDirectory.path(), name).toString();
+      Poco::File(testFilePath()).copyTo(path);
+      return path;
+    };
+    // A run with other data, and one with the source moved
+    const auto original = copy("original.hdf5");
+    const auto otherRun = copy("other_run.hdf5");
+    {
+      H5::H5File file(otherRun, H5F_ACC_RDWR);
+      const int runNumber = 7;
+      file.openGroup("/raw_data_1")
+          .createDataSet("run_number", H5::PredType::NATIVE_INT,
+                         H5::DataSpace())
+          .write(&runNumber, H5::PredType::NATIVE_INT);
+    }
+    const auto moved = copy("moved_source.hdf5");
+    {
+      H5::H5File file(moved, H5F_ACC_RDWR);
+      auto location =
+          file.openDataSet("/raw_data_1/instrument/source/transformations/"
+                           "location");
+      double distance;
+      location.read(&distance, H5::PredType::NATIVE_DOUBLE);
+      distance += 1.;
+      location.write(&distance, H5::PredType::NATIVE_DOUBLE);
+    }
+
+    Poco::TemporaryFile cacheDirectory;
+    cacheDirectory.createDirectories();
+    std::vector<std::string> cacheFiles;
+    NexusGeometryParser::createInstrument(original, cacheDirectory.path());
+    NexusGeometryParser::createInstrument(otherRun, cacheDirectory.path());
+    cacheDirectory.list(cacheFiles);
+    TS_ASSERT_EQUALS(cacheFiles.size(), 1);
+
+    auto instrument =
+        NexusGeometryParser::createInstrument(moved, cacheDirectory.path());
+    cacheFiles.clear();
+    cacheDirectory.list(cacheFiles);
+    TS_ASSERT_EQUALS(cacheFiles.size(), 2);
+    auto componentInfo = std::move(extractBeamline(*instrument).first);
+    const auto sourcePosition =
+        Kernel::toVector3d(componentInfo->position(componentInfo->source()));
+    TS_ASSERT(sourcePosition.isApprox(Eigen::Vector3d(0, 0, -35.281)));
+  }
+
   void test_simple_translation() {
     auto instrument = makeTestInstrument();
     auto detectorInfo = extractDetectorInfo(*instrument);
@@ -228,7 +306,7 @@ public:
   void test_load_wish() {
     auto start = std::chrono::high_resolution_clock::now();
     auto wishInstrument =
-        NexusGeometryParser::createInstrument(m_wishHDF5DefinitionPath);
+        NexusGeometryParser::createInstrument(m_wishHDF5DefinitionPath, "");
     auto stop = std::chrono::high_resolution_clock::now();
     std::cout << "Creating WISH instrument took: "
               << std::chrono::duration_cast<std::chrono::milliseconds>(stop -
@@ -242,7 +320,7 @@ public:
   void test_load_sans2d() {
     auto start = std::chrono::high_resolution_clock::now();
     auto sansInstrument =
-        NexusGeometryParser::createInstrument(m_sans2dHDF5DefinitionPath);
+        NexusGeometryParser::createInstrument(m_sans2dHDF5DefinitionPath, "");
     auto stop = std::chrono::high_resolution_clock::now();
     std::cout << "Creating SANS2D instrument took: "
               << std::chrono::duration_cast<std::chrono::milliseconds>(stop -
@@ -256,7 +334,7 @@ public:
   void test_load_loki() {
     auto start = std::chrono::high_resolution_clock::now();
     auto sansInstrument =
-        NexusGeometryParser::createInstrument(m_lokiHDF5DefinitionPath);
+        NexusGeometryParser::createInstrument(m_lokiHDF5DefinitionPath, "");
     auto stop = std::chrono::high_resolution_clock::now();
     std::cout << "Creating LOKI instrument took: "
               << std::chrono::duration_cast<std::chrono::milliseconds>(stop -
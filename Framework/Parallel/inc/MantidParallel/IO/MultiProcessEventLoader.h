@@ -21,6 +21,10 @@
 
 #include "MantidParallel/DllConfig.h"
 
+namespace Poco {
+class ProcessHandle;
+}
+
 namespace Mantid {
 namespace Parallel {
 namespace IO {
@@ -42,15 +46,32 @@ namespace IO {
  *
  * There 3 main time consuming parts: reading from file, pushing to shared
  * memory, collecting from shared memory, the cost of sorting is small.
+ *
+ * The events of every process are split into segments of limited size (see
+ * segmentRanges()), each one loaded to its own shared memory segment. The
+ * parent collects every segment as soon as it is complete, while the others
+ * are still loading, and removes it. A pair of named semaphores per process
+ * provides the hand-off and the back-pressure: a process may only have
+ * SEGMENTS_IN_FLIGHT segments waiting to be collected, so the shared memory
+ * used at any time is bounded by the shared memory budget instead of growing
+ * to the size of the whole file.
 
   @author Igor Gudich
   @date 2018
 */
 class MANTID_PARALLEL_DLL MultiProcessEventLoader {
 public:
+  /// Default budget of shared memory for the segments in flight, in bytes
+  static constexpr std::size_t DEFAULT_SHARED_MEMORY{std::size_t{1} << 30};
+  /// Number of segments a process may have waiting to be collected
+  static constexpr unsigned SEGMENTS_IN_FLIGHT{2};
+  /// Lower limit for the number of events in a segment
+  static constexpr std::size_t MIN_SEGMENT_EVENTS{std::size_t{1} << 20};
+
   MultiProcessEventLoader(uint32_t numPixels, uint32_t numProcesses,
                           uint32_t numThreads, const std::string &binary,
-                          bool precalc = true);
+                          bool precalc = true,
+                          std::size_t sharedMemory = DEFAULT_SHARED_MEMORY);
   void
   load(const std::string &filename, const std::string &groupname,
        const std::vector<std::string> &bankNames,
@@ -64,10 +85,19 @@ public:
                            const std::vector<int32_t> &bankOffsets,
                            std::size_t from, std::size_t to, bool precalc);
 
+  static std::vector<std::pair<std::size_t, std::size_t>>
+  segmentRanges(std::size_t from, std::size_t to, std::size_t segmentEvents);
+  static std::string segmentName(const std::string &prefix, unsigned procId,
+                                 std::size_t segment);
+  static std::string filledSemaphoreName(const std::string &prefix,
+                                         unsigned procId);
+  static std::string freeSemaphoreName(const std::string &prefix,
+                                       unsigned procId);
+
   enum struct LoadType { preCalcEvents, producerConsumer };
 
 private:
-  static std::vector<std::string> generateSegmentsName(uint32_t procNum);
+  static std::string generateSegmentsPrefix();
   static std::string generateStoragename();
   static std::string generateTimeBasedPrefix();
 
@@ -89,9 +119,15 @@ private:
                                      std::size_t from, std::size_t to);
   };
 
-  void assembleFromShared(
+  void collectSegments(
+      std::vector<Poco::ProcessHandle> &children,
+      const std::vector<std::size_t> &segmentCounts,
+      std::vector<std::vector<Mantid::Types::Event::TofEvent> *> &result) const;
+  void collectSegment(
+      const std::string &name,
       std::vector<std::vector<Mantid::Types::Event::TofEvent> *> &result) const;
 
+  std::size_t eventsPerSegment(std::size_t eventCount) const;
   size_t estimateShmemAmount(size_t eventCount) const;
 
 private:
@@ -100,7 +136,8 @@ private:
   uint32_t m_numProcesses;
   uint32_t m_numThreads;
   std::string m_binaryToLaunch;
-  std::vector<std::string> m_segmentNames;
+  std::size_t m_sharedMemory;
+  std::string m_segmentsPrefix;
   std::string m_storageName;
 };
 
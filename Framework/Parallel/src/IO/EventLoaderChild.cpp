@@ -8,35 +8,56 @@
 #include "MantidParallel/IO/MultiProcessEventLoader.h"
 #include "MantidTypes/Event/TofEvent.h"
 
+#include <boost/interprocess/sync/named_semaphore.hpp>
+
 using namespace Mantid::Parallel::IO;
 using namespace Mantid::Types;
 
 int main(int argc, char **argv) {
-  const std::string segmentName(argv[1]);
+  const std::string segmentsPrefix(argv[1]);
   const std::string storageName(argv[2]);
-  //  unsigned procId = std::atoi(argv[3]);
-  unsigned firstEvent = std::atoi(argv[4]);
-  unsigned upperEvent = std::atoi(argv[5]);
+  unsigned procId = std::atoi(argv[3]);
+  std::size_t firstEvent = std::atoll(argv[4]);
+  std::size_t upperEvent = std::atoll(argv[5]);
   unsigned numPixels = std::atoi(argv[6]);
   std::size_t size = std::atoll(argv[7]);
   const std::string fileName(argv[8]);
   const std::string groupName(argv[9]);
   const bool precalcEvents = std::atoi(argv[10]);
+  std::size_t segmentEvents = std::atoll(argv[11]);
 
   std::vector<std::string> bankNames;
   std::vector<int32_t> bankOffsets;
-  for (int i = 11; i < argc; i += 2) {
+  for (int i = 12; i < argc; i += 2) {
     bankNames.emplace_back(argv[i]);
     bankOffsets.emplace_back(std::atoi(argv[i + 1]));
   }
 
-  EventsListsShmemStorage storage(segmentName, storageName, size, 1, numPixels);
   try {
-    MultiProcessEventLoader::fillFromFile(storage, fileName, groupName,
-                                          bankNames, bankOffsets, firstEvent,
-                                          upperEvent, precalcEvents);
+    ip::named_semaphore free(
+        ip::open_only,
+        MultiProcessEventLoader::freeSemaphoreName(segmentsPrefix, procId)
+            .c_str());
+    ip::named_semaphore filled(
+        ip::open_only,
+        MultiProcessEventLoader::filledSemaphoreName(segmentsPrefix, procId)
+            .c_str());
+    std::size_t segment{0};
+    for (const auto &range : MultiProcessEventLoader::segmentRanges(
+             firstEvent, upperEvent, segmentEvents)) {
+      // Wait until the parent has collected enough of the previous segments
+      free.wait();
+      EventsListsShmemStorage storage(
+          MultiProcessEventLoader::segmentName(segmentsPrefix, procId,
+                                               segment++),
+          storageName, size, 1, numPixels);
+      MultiProcessEventLoader::fillFromFile(storage, fileName, groupName,
+                                            bankNames, bankOffsets, range.first,
+                                            range.second, precalcEvents);
+      filled.post();
+    }
   } catch (...) {
     return 1;
   }
   return 0;
-}
\ No newline at end of file
+}
@@ -7,7 +7,10 @@
 #include <MantidParallel/IO/MultiProcessEventLoader.h>
 //#include <boost/process/child.hpp>
 #include <Poco/Process.h>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/interprocess/sync/named_semaphore.hpp>
 #include <chrono>
+#include <condition_variable>
 #include <fstream>
 #include <iomanip>
 #include <numeric>
@@ -23,28 +26,34 @@ namespace Mantid {
 namespace Parallel {
 namespace IO {
 
+namespace {
+/// Stops a child process that may already have finished
+void stopChild(Poco::ProcessHandle &child) {
+  try {
+    Poco::Process::kill(child.id());
+  } catch (...) {
+    // The process is gone already
+  }
+}
+} // namespace
+
+constexpr std::size_t MultiProcessEventLoader::DEFAULT_SHARED_MEMORY;
+constexpr unsigned MultiProcessEventLoader::SEGMENTS_IN_FLIGHT;
+constexpr std::size_t MultiProcessEventLoader::MIN_SEGMENT_EVENTS;
+
 /// Constructor
-MultiProcessEventLoader::MultiProcessEventLoader(uint32_t numPixels,
-                                                 uint32_t numProcesses,
-                                                 uint32_t numThreads,
-                                                 const std::string &binary,
-                                                 bool precalc)
+MultiProcessEventLoader::MultiProcessEventLoader(
+    uint32_t numPixels, uint32_t numProcesses, uint32_t numThreads,
+    const std::string &binary, bool precalc, std::size_t sharedMemory)
     : m_precalculateEvents(precalc), m_numPixels(numPixels),
       m_numProcesses(numProcesses), m_numThreads(numThreads),
-      m_binaryToLaunch(binary),
-      m_segmentNames(generateSegmentsName(numProcesses)),
+      m_binaryToLaunch(binary), m_sharedMemory(sharedMemory),
+      m_segmentsPrefix(generateSegmentsPrefix()),
       m_storageName(generateStoragename()) {}
 
-/// Generates "unique" shared memory segment name
-std::vector<std::string>
-MultiProcessEventLoader::generateSegmentsName(uint32_t procNum) {
-  std::vector<std::string> res(procNum,
-                               generateTimeBasedPrefix() +
-                                   "_mantid_multiprocess_NXloader_segment_");
-  unsigned short i{0};
-  for (auto &name : res)
-    name += std::to_string(i++);
-  return res;
+/// Generates "unique" prefix of the shared memory segment names
+std::string MultiProcessEventLoader::generateSegmentsPrefix() {
+  return generateTimeBasedPrefix() + "_mantid_multiprocess_NXloader_segment_";
 }
 
 /// Generates "unique" shared memory storage structure name
@@ -62,6 +71,43 @@ std::string MultiProcessEventLoader::generateTimeBasedPrefix() {
   return ss.str();
 }
 
+/**Splits the events [from, to) of a process into consecutive segments of at
+ * most segmentEvents events. The parent and the child processes use it to
+ * agree on the number of segments of each process.*/
+std::vector<std::pair<std::size_t, std::size_t>>
+MultiProcessEventLoader::segmentRanges(const std::size_t from,
+                                       const std::size_t to,
+                                       const std::size_t segmentEvents) {
+  if (segmentEvents == 0)
+    throw std::invalid_argument("MultiProcessEventLoader::segmentRanges(): "
+                                "segments must not be empty.");
+  std::vector<std::pair<std::size_t, std::size_t>> ranges;
+  for (auto start = from; start < to; start += segmentEvents)
+    ranges.emplace_back(start, std::min(start + segmentEvents, to));
+  return ranges;
+}
+
+/// Name of the shared memory segment number "segment" of process procId
+std::string MultiProcessEventLoader::segmentName(const std::string &prefix,
+                                                 unsigned procId,
+                                                 std::size_t segment) {
+  return prefix + std::to_string(procId) + "_" + std::to_string(segment);
+}
+
+/// Name of the semaphore counting the segments of procId ready to collect
+std::string
+MultiProcessEventLoader::filledSemaphoreName(const std::string &prefix,
+                                             unsigned procId) {
+  return prefix + std::to_string(procId) + "_filled";
+}
+
+/// Name of the semaphore counting the segments procId may still create
+std::string
+MultiProcessEventLoader::freeSemaphoreName(const std::string &prefix,
+                                           unsigned procId) {
+  return prefix + std::to_string(procId) + "_free";
+}
+
 /**Main API function for loading data from given file, group list of banks,
  * launches child processes for hdf5 parallel reading*/
 void MultiProcessEventLoader::load(
@@ -77,58 +123,45 @@ void MultiProcessEventLoader::load(
     auto bkSz = EventLoader::readBankSizes(instrument, bankNames);
     auto numEvents = std::accumulate(bkSz.begin(), bkSz.end(), std::size_t{0});
 
-    std::size_t storageSize = estimateShmemAmount(numEvents);
+    const std::size_t segmentEvents = eventsPerSegment(numEvents);
+    std::size_t storageSize = estimateShmemAmount(segmentEvents);
 
     std::size_t evPerPr = numEvents / m_numProcesses;
+    std::vector<std::size_t> segmentCounts;
+    for (unsigned i = 0; i < m_numProcesses; ++i) {
+      std::size_t upperBound =
+          i < m_numProcesses - 1 ? evPerPr * (i + 1) : numEvents;
+      segmentCounts.push_back(
+          segmentRanges(evPerPr * i, upperBound, segmentEvents).size());
+    }
 
-    /*  boost::process implementation can be used
-     * with proper boost version instead of Poco*/
-    /*
-        std::vector<bp::child> vChilds;
-
-        // prepare command for launching of parallel processes
-        for (unsigned i = 0; i < m_numProcesses; ++i) {
-          std::size_t upperBound =
-              i < m_numProcesses - 1 ? evPerPr * (i + 1) : numEvents;
-
-          std::string command;
-          command += m_binaryToLaunch + " ";
-          command += m_segmentNames[i] + " ";           // segment name
-          command += m_storageName + " ";               // storage name
-          command += std::to_string(i) + " ";           // proc id
-          command += std::to_string(evPerPr * i) + " "; // first event to load
-          command += std::to_string(upperBound) + " ";  // upper bound to load
-          command += std::to_string(m_numPixels) + " "; // pixel count
-          command += std::to_string(storageSize) + " "; // memory size
-          command += filename + " ";                    // nexus file name
-          command += groupname + " ";                   // instrument group name
-          command += m_precalculateEvents
-                         ? "1 "
-                         : "0 "; // variant of algorithm used for loading
-          for (unsigned j = 0; j < bankNames.size(); ++j) {
-            command += bankNames[j] + " ";                   // bank name
-            command += std::to_string(bankOffsets[j]) + " "; // bank size
-          }
-
-          try {
-            // launch child processes
-            vChilds.emplace_back(command.c_str());
-          } catch (std::exception const &ex) {
-            std::rethrow_if_nested(ex);
-          }
-        }
-    */
-
-    // to cleanup shared memory in this function
+    // to cleanup shared memory and semaphores in this function
     struct SharedMemoryDestroyer {
-      const std::vector<std::string> &segments;
-      explicit SharedMemoryDestroyer(const std::vector<std::string> &sm)
-          : segments(sm) {}
+      const std::string &prefix;
+      const std::vector<std::size_t> &segmentCounts;
+      SharedMemoryDestroyer(const std::string &pr,
+                            const std::vector<std::size_t> &counts)
+          : prefix(pr), segmentCounts(counts) {}
       ~SharedMemoryDestroyer() {
-        for (const auto &name : segments)
-          ip::shared_memory_object::remove(name.c_str());
+        for (unsigned i = 0; i < segmentCounts.size(); ++i) {
+          ip::named_semaphore::remove(filledSemaphoreName(prefix, i).c_str());
+          ip::named_semaphore::remove(freeSemaphoreName(prefix, i).c_str());
+          for (std::size_t k = 0; k < segmentCounts[i]; ++k)
+            ip::shared_memory_object::remove(
+                segmentName(prefix, i, k).c_str());
+        }
       }
-    } shared_memory_destroyer(m_segmentNames);
+    } shared_memory_destroyer(m_segmentsPrefix, segmentCounts);
+
+    // The children open the semaphores, they must exist before the launch
+    for (unsigned i = 0; i < m_numProcesses; ++i) {
+      const auto filled = filledSemaphoreName(m_segmentsPrefix, i);
+      const auto free = freeSemaphoreName(m_segmentsPrefix, i);
+      ip::named_semaphore::remove(filled.c_str());
+      ip::named_semaphore::remove(free.c_str());
+      ip::named_semaphore(ip::create_only, filled.c_str(), 0);
+      ip::named_semaphore(ip::create_only, free.c_str(), SEGMENTS_IN_FLIGHT);
+    }
 
     std::vector<Poco::ProcessHandle> vChilds;
     for (unsigned i = 0; i < m_numProcesses; ++i) {
@@ -136,7 +169,7 @@ void MultiProcessEventLoader::load(
           i < m_numProcesses - 1 ? evPerPr * (i + 1) : numEvents;
       std::vector<std::string> processArgs;
 
-      processArgs.push_back(m_segmentNames[i]);           // segment name
+      processArgs.push_back(m_segmentsPrefix);            // segment prefix
       processArgs.push_back(m_storageName);               // storage name
       processArgs.push_back(std::to_string(i));           // proc id
       processArgs.push_back(std::to_string(evPerPr * i)); // first event to load
@@ -148,6 +181,7 @@ void MultiProcessEventLoader::load(
       processArgs.push_back(
           m_precalculateEvents ? "1 "
                                : "0 "); // variant of algorithm used for loading
+      processArgs.push_back(std::to_string(segmentEvents)); // segment events
       for (unsigned j = 0; j < bankNames.size(); ++j) {
         processArgs.push_back(bankNames[j]);                   // bank name
         processArgs.push_back(std::to_string(bankOffsets[j])); // bank size
@@ -158,79 +192,149 @@ void MultiProcessEventLoader::load(
         vChilds.emplace_back(
             Poco::Process::launch(m_binaryToLaunch, processArgs));
       } catch (...) {
+        for (auto &c : vChilds)
+          stopChild(c);
         std::throw_with_nested(
             std::runtime_error("MultiProcessEventLoader::load()"));
       }
     }
 
-    /*  boost::process implementation can be used
-     * with proper boost version instead of Poco*/
-    /*
-        // waiting for child processes
-        for (auto &c : vChilds)
-          c.wait();
-
-        // check if oll childs are finished correctly
-        for (auto &c : vChilds)
-          if (c.exit_code())
-            throw std::runtime_error("Error while multiprocess loading\n");
-    */
-
-    // waiting for child processes
-    for (auto &c : vChilds)
-      if (c.wait())
-        throw std::runtime_error(
-            "Error while waiting processes in  multiprocess loading.");
-
-    // Assemble multiprocess data from shared memory
-    assembleFromShared(eventLists);
+    // Collect the segments while the children are loading the next ones
+    collectSegments(vChilds, segmentCounts, eventLists);
   } catch (...) {
     std::throw_with_nested(std::runtime_error("Something wrong in "
                                               "MultiprocessLoader."));
   }
 }
 
-/**Collects data from the chunks in shared memory to the final structure*/
-void MultiProcessEventLoader::assembleFromShared(
+/**Collects the segments of all the processes to the final structure, in the
+ * order in which they are completed. Every collected segment is removed and
+ * its process is allowed to create the next one. Stops the children and
+ * throws if one of them fails.*/
+void MultiProcessEventLoader::collectSegments(
+    std::vector<Poco::ProcessHandle> &children,
+    const std::vector<std::size_t> &segmentCounts,
     std::vector<std::vector<Mantid::Types::Event::TofEvent> *> &result) const {
-  std::vector<std::thread> workers;
+  struct Ready {
+    unsigned procId;
+    std::size_t segment;
+    bool failed;
+  };
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::queue<Ready> ready;
+  std::atomic<bool> abort{false};
+  auto notify = [&](const Ready &item) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ready.push(item);
+    }
+    condition.notify_one();
+  };
+
+  std::vector<std::thread> watchers;
+  for (unsigned i = 0; i < m_numProcesses; ++i) {
+    // Announces the segments of the child as they are filled
+    watchers.emplace_back([&, i]() {
+      ip::named_semaphore filled(
+          ip::open_only, filledSemaphoreName(m_segmentsPrefix, i).c_str());
+      for (std::size_t k = 0; k < segmentCounts[i]; ++k) {
+        while (!filled.timed_wait(boost::posix_time::microsec_clock::
+                                      universal_time() +
+                                  boost::posix_time::milliseconds(100)))
+          if (abort)
+            return;
+        notify({i, k, false});
+      }
+    });
+    // Reports the child if it fails, at any point
+    watchers.emplace_back([&, i]() {
+      if (children[i].wait() != 0)
+        notify({i, 0, true});
+    });
+  }
 
-  std::vector<std::atomic<uint32_t>> cnts(m_segmentNames.size());
-  std::fill(cnts.begin(), cnts.end(), 0);
-  std::vector<std::atomic<uint32_t>> processCounter(m_segmentNames.size());
-  std::fill(processCounter.begin(), processCounter.end(), 0);
+  std::vector<std::unique_ptr<ip::named_semaphore>> free;
+  for (unsigned i = 0; i < m_numProcesses; ++i)
+    free.emplace_back(new ip::named_semaphore(
+        ip::open_only, freeSemaphoreName(m_segmentsPrefix, i).c_str()));
+
+  std::exception_ptr error;
+  auto remaining = std::accumulate(segmentCounts.begin(), segmentCounts.end(),
+                                   std::size_t{0});
+  while (remaining > 0) {
+    Ready item;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [&]() { return !ready.empty(); });
+      item = ready.front();
+      ready.pop();
+    }
+    if (item.failed) {
+      error = std::make_exception_ptr(std::runtime_error(
+          "Error while waiting processes in  multiprocess loading."));
+      break;
+    }
+    try {
+      const auto name =
+          segmentName(m_segmentsPrefix, item.procId, item.segment);
+      collectSegment(name, result);
+      ip::shared_memory_object::remove(name.c_str());
+    } catch (...) {
+      error = std::current_exception();
+      break;
+    }
+    free[item.procId]->post();
+    --remaining;
+  }
 
-  const unsigned portion{std::max<unsigned>(m_numPixels / m_numThreads / 3, 1)};
+  if (error) {
+    abort = true;
+    for (auto &c : children)
+      stopChild(c);
+  }
+  for (auto &watcher : watchers)
+    watcher.join();
+  // A child may still fail after its last segment was collected
+  for (; !error && !ready.empty(); ready.pop())
+    if (ready.front().failed)
+      error = std::make_exception_ptr(std::runtime_error(
+          "Error while waiting processes in  multiprocess loading."));
+  if (error)
+    std::rethrow_exception(error);
+}
 
-  for (unsigned i = 0; i < m_numThreads; ++i) {
-    workers.emplace_back([&]() {
-      for (std::size_t segId = 0; segId < m_segmentNames.size(); ++segId) {
-        ip::managed_shared_memory segment{ip::open_read_only,
-                                          m_segmentNames[segId].c_str()};
-        auto chunks =
-            segment.find<Mantid::Parallel::IO::Chunks>(m_storageName.c_str())
-                .first;
-        auto &cnt = cnts[segId];
-        for (uint32_t startPixel = cnt.fetch_add(portion);
-             startPixel < m_numPixels; startPixel = cnt.fetch_add(portion)) {
-          auto toPixel = std::min(startPixel + portion, m_numPixels);
-          for (uint32_t pixel = startPixel; pixel < toPixel; ++pixel) {
-            auto &res = result[pixel];
-            for (auto &ch : *chunks) {
-              res->insert(res->end(), ch[pixel].begin(), ch[pixel].end());
-            }
-          }
-        }
-        ++processCounter[segId];
-        if (processCounter[segId] == m_numThreads)
-          ip::shared_memory_object::remove(m_segmentNames[segId].c_str());
+/**Appends the events of a shared memory segment to the final structure,
+ * splitting the pixels between the threads*/
+void MultiProcessEventLoader::collectSegment(
+    const std::string &name,
+    std::vector<std::vector<Mantid::Types::Event::TofEvent> *> &result) const {
+  ip::managed_shared_memory segment{ip::open_read_only, name.c_str()};
+  auto chunks =
+      segment.find<Mantid::Parallel::IO::Chunks>(m_storageName.c_str()).first;
+  if (!chunks)
+    throw std::runtime_error("No events found in shared memory segment " +
+                             name);
 
-        while (processCounter[segId] != m_numThreads)
-          ;
+  const unsigned portion{std::max<unsigned>(m_numPixels / m_numThreads / 3, 1)};
+  std::atomic<uint32_t> cnt{0};
+  auto collect = [&]() {
+    for (uint32_t startPixel = cnt.fetch_add(portion); startPixel < m_numPixels;
+         startPixel = cnt.fetch_add(portion)) {
+      auto toPixel = std::min(startPixel + portion, m_numPixels);
+      for (uint32_t pixel = startPixel; pixel < toPixel; ++pixel) {
+        auto &res = result[pixel];
+        for (auto &ch : *chunks) {
+          res->insert(res->end(), ch[pixel].begin(), ch[pixel].end());
+        }
       }
-    });
-  }
+    }
+  };
 
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; i < m_numThreads; ++i)
+    workers.emplace_back(collect);
+  collect();
   for (auto &worker : workers)
     worker.join();
 }
@@ -256,14 +360,26 @@ void MultiProcessEventLoader::fillFromFile(
         type, storage, instrument, bankNames, bankOffsets, from, to);
 }
 
-// Estimates the memory amount for shared memory segments
-// vector representing each pixel allocated only once, so we have allocationFee
-// bytes extra overhead
+// Number of events of a segment, so that all the segments that may be in
+// flight at the same time fit into the shared memory budget
+std::size_t
+MultiProcessEventLoader::eventsPerSegment(const std::size_t eventCount) const {
+  const std::size_t inFlight{std::size_t{m_numProcesses} * SEGMENTS_IN_FLIGHT};
+  const std::size_t budgetEvents{m_sharedMemory / inFlight / sizeof(TofEvent)};
+  // There is no point in segments larger than the events of a process
+  const std::size_t processEvents{eventCount / m_numProcesses +
+                                  eventCount % m_numProcesses};
+  return std::max<std::size_t>(
+      std::min(std::max(budgetEvents, MIN_SEGMENT_EVENTS), processEvents), 1);
+}
+
+// Estimates the memory amount for a shared memory segment of eventCount
+// events. vector representing each pixel allocated only once, so we have
+// allocationFee bytes extra overhead
 size_t MultiProcessEventLoader::estimateShmemAmount(size_t eventCount) const {
   // 8 bytes pointer to allocator + 8 bytes pointer to metadata
   auto allocationFee = 8 + 8 + generateStoragename().length();
-  std::size_t len{(eventCount / m_numProcesses + eventCount % m_numProcesses) *
-                      sizeof(TofEvent) +
+  std::size_t len{eventCount * sizeof(TofEvent) +
                   m_numPixels * (sizeof(EventLists) + allocationFee) +
                   sizeof(Chunks) + allocationFee};
   return len;
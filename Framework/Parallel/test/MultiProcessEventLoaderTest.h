@@ -0,0 +1,72 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_PARALLEL_MULTIPROCESSEVENTLOADERTEST_H_
+#define MANTID_PARALLEL_MULTIPROCESSEVENTLOADERTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidParallel/IO/MultiProcessEventLoader.h"
+
+using namespace Mantid::Parallel::IO;
+
+class MultiProcessEventLoaderTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static MultiProcessEventLoaderTest *createSuite() {
+    return new MultiProcessEventLoaderTest();
+  }
+  static void destroySuite(MultiProcessEventLoaderTest *suite) {
+    delete suite;
+  }
+
+  void test_segmentRanges_covers_range() {
+    const auto ranges = MultiProcessEventLoader::segmentRanges(10, 35, 10);
+    TS_ASSERT_EQUALS(ranges.size(), 3);
+    TS_ASSERT_EQUALS(ranges[0].first, 10);
+    TS_ASSERT_EQUALS(ranges[0].second, 20);
+    TS_ASSERT_EQUALS(ranges[1].first, 20);
+    TS_ASSERT_EQUALS(ranges[1].second, 30);
+    TS_ASSERT_EQUALS(ranges[2].first, 30);
+    TS_ASSERT_EQUALS(ranges[2].second, 35);
+  }
+
+  void test_segmentRanges_exact_multiple() {
+    const auto ranges = MultiProcessEventLoader::segmentRanges(0, 20, 10);
+    TS_ASSERT_EQUALS(ranges.size(), 2);
+    TS_ASSERT_EQUALS(ranges[1].first, 10);
+    TS_ASSERT_EQUALS(ranges[1].second, 20);
+  }
+
+  void test_segmentRanges_single_segment() {
+    const auto ranges = MultiProcessEventLoader::segmentRanges(5, 8, 100);
+    TS_ASSERT_EQUALS(ranges.size(), 1);
+    TS_ASSERT_EQUALS(ranges[0].first, 5);
+    TS_ASSERT_EQUALS(ranges[0].second, 8);
+  }
+
+  void test_segmentRanges_empty_range() {
+    TS_ASSERT(MultiProcessEventLoader::segmentRanges(7, 7, 10).empty());
+  }
+
+  void test_segmentRanges_throws_for_empty_segments() {
+    TS_ASSERT_THROWS(MultiProcessEventLoader::segmentRanges(0, 10, 0),
+                     const std::invalid_argument &);
+  }
+
+  void test_names_are_unique_per_process_and_segment() {
+    const std::string prefix("prefix_");
+    TS_ASSERT_DIFFERS(MultiProcessEventLoader::segmentName(prefix, 1, 11),
+                      MultiProcessEventLoader::segmentName(prefix, 11, 1));
+    TS_ASSERT_DIFFERS(MultiProcessEventLoader::filledSemaphoreName(prefix, 0),
+                      MultiProcessEventLoader::freeSemaphoreName(prefix, 0));
+    TS_ASSERT_DIFFERS(MultiProcessEventLoader::freeSemaphoreName(prefix, 0),
+                      MultiProcessEventLoader::freeSemaphoreName(prefix, 1));
+  }
+};
+
+#endif /* MANTID_PARALLEL_MULTIPROCESSEVENTLOADERTEST_H_ */
@@ -93,6 +93,15 @@ private:
                                            std::vector<specnum_t> specids,
                                            std::vector<double> l2s,
                                            std::vector<double> phis);
+  /// Edit the instrument geometry of the focussed workspaces
+  void editFocussedInstrument();
+
+  /// Check whether the fused reduction can be used
+  std::string checkFusedReduction();
+
+  /// Align, mask, focus and histogram the events in a single pass
+  API::MatrixWorkspace_sptr fusedAlignAndFocus();
+
   void convertOffsetsToCal(DataObjects::OffsetsWorkspace_sptr &offsetsWS);
   double getVecPropertyFromPmOrSelf(const std::string &name,
                                     std::vector<double> &avec);
@@ -6,25 +6,34 @@
 // SPDX - License - Identifier: GPL - 3.0 +
 #include "MantidWorkflowAlgorithms/AlignAndFocusPowder.h"
 #include "MantidAPI/AnalysisDataService.h"
+#include "MantidAPI/Axis.h"
 #include "MantidAPI/FileFinder.h"
 #include "MantidAPI/FileProperty.h"
 #include "MantidAPI/MatrixWorkspace.h"
+#include "MantidAPI/SpectrumInfo.h"
 #include "MantidAPI/WorkspaceFactory.h"
+#include "MantidDataObjects/EventHistogrammer.h"
 #include "MantidDataObjects/GroupingWorkspace.h"
 #include "MantidDataObjects/MaskWorkspace.h"
 #include "MantidDataObjects/OffsetsWorkspace.h"
 #include "MantidDataObjects/TableWorkspace.h"
 #include "MantidDataObjects/Workspace2D.h"
+#include "MantidGeometry/Instrument.h"
 #include "MantidKernel/ArrayProperty.h"
 #include "MantidKernel/BoundedValidator.h"
 #include "MantidKernel/ConfigService.h"
 #include "MantidKernel/DateTimeValidator.h"
+#include "MantidKernel/Diffraction.h"
 #include "MantidKernel/EnabledWhenProperty.h"
 #include "MantidKernel/InstrumentInfo.h"
 #include "MantidKernel/PropertyManager.h"
 #include "MantidKernel/PropertyManagerDataService.h"
 #include "MantidKernel/RebinParamsValidator.h"
 #include "MantidKernel/System.h"
+#include "MantidKernel/UnitFactory.h"
+#include "MantidKernel/VectorHelper.h"
+
+#include <unordered_map>
 
 using Mantid::Geometry::Instrument_const_sptr;
 using namespace Mantid::Kernel;
@@ -125,6 +134,13 @@ void AlignAndFocusPowder::init() {
                   "EventWorkspace, this will preserve "
                   "the full event list (warning: this "
                   "will use much more memory!).");
+  declareProperty("FusedReduction", false,
+                  "If the InputWorkspace is an EventWorkspace binned in "
+                  "d-spacing, apply the calibration, masking, focussing and "
+                  "histogramming in a single pass over the events without "
+                  "creating intermediate event workspaces. The output is "
+                  "then always a histogram workspace. Options that need the "
+                  "intermediate workspaces use the usual child algorithms.");
   declareProperty("RemovePromptPulseWidth", 0.,
                   "Width of events (in "
                   "microseconds) near the prompt "
@@ -375,6 +391,20 @@ void AlignAndFocusPowder::exec() {
 
   loadCalFile(calFilename, groupFilename);
 
+  const bool useFusedReduction = getProperty("FusedReduction");
+  if (useFusedReduction) {
+    const std::string reason = checkFusedReduction();
+    if (reason.empty()) {
+      m_outputW = fusedAlignAndFocus();
+      editFocussedInstrument();
+      m_outputW = convertUnits(m_outputW, "TOF");
+      setProperty("OutputWorkspace", m_outputW);
+      return;
+    }
+    g_log.information() << "Not using the fused reduction: " << reason
+                        << "\n";
+  }
+
   // Now setup the output workspace
   m_outputW = getProperty("OutputWorkspace");
   if (m_inputEW) {
@@ -681,30 +711,7 @@ void AlignAndFocusPowder::exec() {
   m_progress->report();
 
   // edit the instrument geometry
-  if (m_groupWS &&
-      (m_l1 > 0 || !tths.empty() || !l2s.empty() || !phis.empty())) {
-    size_t numreg = m_outputW->getNumberHistograms();
-
-    try {
-      // set up the vectors for doing everything
-      auto specidsSplit = splitVectors(specids, numreg, "specids");
-      auto tthsSplit = splitVectors(tths, numreg, "two-theta");
-      auto l2sSplit = splitVectors(l2s, numreg, "L2");
-      auto phisSplit = splitVectors(phis, numreg, "phi");
-
-      // Edit instrument
-      m_outputW = editInstrument(m_outputW, tthsSplit.reg, specidsSplit.reg,
-                                 l2sSplit.reg, phisSplit.reg);
-
-      if (m_processLowResTOF) {
-        m_lowResW = editInstrument(m_lowResW, tthsSplit.low, specidsSplit.low,
-                                   l2sSplit.low, phisSplit.low);
-      }
-    } catch (std::runtime_error &e) {
-      g_log.warning("Not editing instrument geometry:");
-      g_log.warning(e.what());
-    }
-  }
+  editFocussedInstrument();
   m_progress->report();
 
   // Conjoin 2 workspaces if there is low resolution
@@ -774,6 +781,368 @@ API::MatrixWorkspace_sptr AlignAndFocusPowder::editInstrument(
   return ws;
 }
 
+//----------------------------------------------------------------------------------------------
+/** Edit the instrument geometry of the focussed workspaces if new flight
+ * paths or angles were given.
+ */
+void AlignAndFocusPowder::editFocussedInstrument() {
+  if (m_groupWS &&
+      (m_l1 > 0 || !tths.empty() || !l2s.empty() || !phis.empty())) {
+    size_t numreg = m_outputW->getNumberHistograms();
+
+    try {
+      // set up the vectors for doing everything
+      auto specidsSplit = splitVectors(specids, numreg, "specids");
+      auto tthsSplit = splitVectors(tths, numreg, "two-theta");
+      auto l2sSplit = splitVectors(l2s, numreg, "L2");
+      auto phisSplit = splitVectors(phis, numreg, "phi");
+
+      // Edit instrument
+      m_outputW = editInstrument(m_outputW, tthsSplit.reg, specidsSplit.reg,
+                                 l2sSplit.reg, phisSplit.reg);
+
+      if (m_processLowResTOF) {
+        m_lowResW = editInstrument(m_lowResW, tthsSplit.low, specidsSplit.low,
+                                   l2sSplit.low, phisSplit.low);
+      }
+    } catch (std::runtime_error &e) {
+      g_log.warning("Not editing instrument geometry:");
+      g_log.warning(e.what());
+    }
+  }
+}
+
+namespace {
+/// Conversion factors of the calibration table, looked up by detector ID
+class CalibrationLookup {
+public:
+  explicit CalibrationLookup(const ITableWorkspace &table)
+      : m_difcCol(table.getColumn("difc")), m_difaCol(table.getColumn("difa")),
+        m_tzeroCol(table.getColumn("tzero")) {
+    ConstColumnVector<int> detIDs = table.getVector("detid");
+    for (size_t row = 0; row < detIDs.size(); ++row)
+      m_detidToRow[static_cast<detid_t>(detIDs[row])] = row;
+  }
+
+  /** Get the conversion of a spectrum, averaging the factors of its detectors
+   * as AlignDetectors does.
+   * @param detIDs :: the detectors of the spectrum
+   * @param difc :: set to the average DIFC
+   * @param difa :: set to the average DIFA
+   * @param tzero :: set to the average TZERO
+   */
+  void getFactors(const std::set<detid_t> &detIDs, double &difc, double &difa,
+                  double &tzero) const {
+    difc = 0.;
+    difa = 0.;
+    tzero = 0.;
+    size_t numRows = 0;
+    for (const auto detID : detIDs) {
+      const auto found = m_detidToRow.find(detID);
+      if (found == m_detidToRow.end())
+        continue;
+      difc += m_difcCol->toDouble(found->second);
+      difa += m_difaCol->toDouble(found->second);
+      tzero += m_tzeroCol->toDouble(found->second);
+      ++numRows;
+    }
+    if (numRows > 1) {
+      const double norm = 1. / static_cast<double>(numRows);
+      difc *= norm;
+      difa *= norm;
+      tzero *= norm;
+    }
+  }
+
+private:
+  std::unordered_map<detid_t, size_t> m_detidToRow;
+  Column_const_sptr m_difcCol;
+  Column_const_sptr m_difaCol;
+  Column_const_sptr m_tzeroCol;
+};
+
+/** Find the group of a spectrum, as DiffractionFocussing does
+ * @param detIDs :: the detectors of the spectrum
+ * @param detIDToGroup :: the group of each detector ID
+ * @return the group, or -1 if the detectors are not all in the same valid
+ * group
+ */
+int findGroup(const std::set<detid_t> &detIDs,
+              const std::vector<int> &detIDToGroup) {
+  int group = -1;
+  for (const auto detID : detIDs) {
+    if (detID < 0 || static_cast<size_t>(detID) >= detIDToGroup.size())
+      return -1;
+    const int detGroup = detIDToGroup[detID];
+    if (detGroup <= 0 || (group != -1 && detGroup != group))
+      return -1;
+    group = detGroup;
+  }
+  return group;
+}
+
+/// Per-thread buffers of the fused reduction
+struct FusedBuffers {
+  /// Partial sums of the weights of all output spectra, if needed
+  MantidVec y;
+  /// Partial sums of the squared errors of all output spectra, if needed
+  MantidVec e;
+  std::vector<double> tofs;
+  std::vector<double> weights;
+  std::vector<double> errors;
+};
+
+/// Square root of the summed squared errors of an output spectrum
+void sqrtErrors(HistogramData::HistogramE &E) {
+  std::transform(E.begin(), E.end(), E.begin(),
+                 static_cast<double (*)(double)>(sqrt));
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------------
+/** Check whether the fused reduction can replace the child algorithms for the
+ * requested processing.
+ * @return the reason why it cannot be used, or an empty string if it can
+ */
+std::string AlignAndFocusPowder::checkFusedReduction() {
+  if (!m_inputEW)
+    return "the input is not an EventWorkspace";
+  if (!dspace || m_resampleX != 0 || m_params.empty())
+    return "the binning is not given by Params in d-spacing";
+  if (m_processLowResTOF || LRef > 0. || DIFCref > 0. || minwl > 0. ||
+      !isEmpty(maxwl))
+    return "unwrapping, wavelength cropping and low resolution removal are "
+           "not supported";
+  if (!isDefault("MaskBinTable"))
+    return "MaskBinTable is not supported";
+  if (!isDefault("UnfocussedWorkspace"))
+    return "UnfocussedWorkspace needs the intermediate workspace";
+  const double removePromptPulseWidth = getProperty("RemovePromptPulseWidth");
+  if (removePromptPulseWidth > 0.)
+    return "RemovePromptPulseWidth is not supported";
+  const double wallClockTolerance = getProperty("CompressWallClockTolerance");
+  if (!isEmpty(wallClockTolerance))
+    return "CompressWallClockTolerance is not supported";
+  return "";
+}
+
+//----------------------------------------------------------------------------------------------
+/** Align, mask, focus and histogram the input events in a single pass.
+ *
+ * The time-of-flight of each event is converted to d-spacing with the DIFC,
+ * DIFA and TZERO of its spectrum, from the calibration workspace or from the
+ * instrument geometry, and added to the histogram of the group of the
+ * spectrum. Masked spectra and events outside the TMin/TMax range are skipped.
+ * With at least as many output spectra as threads, each output spectrum is
+ * filled directly by one thread. Otherwise each thread fills its own partial
+ * histograms which are summed at the end. No intermediate event workspace is
+ * created and the input is unchanged.
+ * CompressEvents is not run since it does not change the histograms.
+ *
+ * @return the focussed histograms in d-spacing
+ */
+API::MatrixWorkspace_sptr AlignAndFocusPowder::fusedAlignAndFocus() {
+  g_log.information() << "running fused AlignAndFocus started at "
+                      << Types::Core::DateAndTime::getCurrentTime() << "\n";
+
+  const EventWorkspace &inputWS = *m_inputEW;
+  const auto numHist = static_cast<int>(inputWS.getNumberHistograms());
+  const auto &spectrumInfo = inputWS.spectrumInfo();
+
+  MantidVec edges;
+  VectorHelper::createAxisFromRebinParams(m_params, edges);
+  if (edges.size() < 2)
+    throw std::runtime_error("The binning parameters give no bins");
+  const size_t numBins = edges.size() - 1;
+  const EventHistogrammer histogrammer(edges);
+
+  std::vector<int> detIDToGroup;
+  if (m_groupWS) {
+    int64_t numGroups = 0;
+    m_groupWS->makeDetectorIDToGroupVector(detIDToGroup, numGroups);
+  }
+  std::set<detid_t> maskedDetectors;
+  if (m_maskWS)
+    maskedDetectors = m_maskWS->getMaskedDetectors();
+  std::unique_ptr<CalibrationLookup> calibration;
+  if (m_calibrationWS)
+    calibration = make_unique<CalibrationLookup>(*m_calibrationWS);
+
+  // Find the output spectrum and the conversion of each input spectrum. Without
+  // grouping every input spectrum has its own output spectrum.
+  std::vector<int> groupOfSpectrum(numHist, -1);
+  std::vector<double> difcs(numHist, 0.);
+  std::vector<double> difas(numHist, 0.);
+  std::vector<double> tzeros(numHist, 0.);
+  std::map<int, std::set<detid_t>> groupDetIDs;
+  for (int wi = 0; wi < numHist; ++wi) {
+    if (!spectrumInfo.hasDetectors(wi) || spectrumInfo.isMonitor(wi) ||
+        spectrumInfo.isMasked(wi))
+      continue;
+    const auto &detIDs = inputWS.getSpectrum(wi).getDetectorIDs();
+    if (!maskedDetectors.empty() &&
+        std::all_of(detIDs.begin(), detIDs.end(), [&](const detid_t detID) {
+          return maskedDetectors.count(detID) > 0;
+        }))
+      continue;
+    const int group = m_groupWS ? findGroup(detIDs, detIDToGroup) : wi;
+    if (group < 0)
+      continue;
+
+    if (calibration) {
+      calibration->getFactors(detIDs, difcs[wi], difas[wi], tzeros[wi]);
+    } else {
+      const double factor = Geometry::Conversion::tofToDSpacingFactor(
+          spectrumInfo.l1(), spectrumInfo.l2(wi), spectrumInfo.twoTheta(wi),
+          0.);
+      difcs[wi] = 1. / factor;
+    }
+    if (!(difcs[wi] > 0.))
+      continue;
+    groupOfSpectrum[wi] = group;
+    if (m_groupWS)
+      groupDetIDs[group].insert(detIDs.begin(), detIDs.end());
+  }
+
+  // The output spectra are the groups in increasing order
+  const size_t numOutput =
+      m_groupWS ? groupDetIDs.size() : static_cast<size_t>(numHist);
+  if (numOutput == 0)
+    throw std::runtime_error("No spectra are left to focus after masking "
+                             "and grouping");
+  std::map<int, size_t> outputIndexOfGroup;
+  for (const auto &item : groupDetIDs)
+    outputIndexOfGroup.emplace(item.first, outputIndexOfGroup.size());
+  std::vector<int> outputIndex(numHist, -1);
+  for (int wi = 0; wi < numHist; ++wi) {
+    if (groupOfSpectrum[wi] >= 0)
+      outputIndex[wi] = m_groupWS ? static_cast<int>(outputIndexOfGroup.at(
+                                        groupOfSpectrum[wi]))
+                                  : wi;
+  }
+
+  const double tofMin =
+      xmin > 0. ? xmin : std::numeric_limits<double>::lowest();
+  const double tofMax = xmax > 0. ? xmax : std::numeric_limits<double>::max();
+
+  MatrixWorkspace_sptr outputWS = WorkspaceFactory::Instance().create(
+      m_inputW, numOutput, numBins + 1, numBins);
+  outputWS->getAxis(0)->unit() = UnitFactory::Instance().create("dSpacing");
+  const HistogramData::BinEdges binEdges(edges);
+  for (size_t index = 0; index < numOutput; ++index) {
+    outputWS->setBinEdges(index, binEdges);
+    auto &spectrum = outputWS->getSpectrum(index);
+    if (!m_groupWS) {
+      const auto &inputSpectrum = inputWS.getSpectrum(index);
+      spectrum.setSpectrumNo(inputSpectrum.getSpectrumNo());
+      spectrum.setDetectorIDs(inputSpectrum.getDetectorIDs());
+    }
+  }
+  for (auto &item : groupDetIDs) {
+    auto &spectrum = outputWS->getSpectrum(outputIndexOfGroup.at(item.first));
+    spectrum.setSpectrumNo(item.first);
+    spectrum.setDetectorIDs(std::move(item.second));
+  }
+
+  // Add the events of an input spectrum to the histogram Y, E
+  const auto addEvents = [&](const int wi, double *Y, double *E,
+                             FusedBuffers &buffer) {
+    const auto &events = inputWS.getSpectrum(wi);
+    events.getTofs(buffer.tofs);
+    const bool weighted = events.getEventType() != API::TOF;
+    if (weighted) {
+      events.getWeights(buffer.weights);
+      events.getWeightErrors(buffer.errors);
+    }
+    const auto tofToD = Kernel::Diffraction::getTofToDConversionFunc(
+        difcs[wi], difas[wi], tzeros[wi]);
+    const size_t numEvents = buffer.tofs.size();
+    for (size_t i = 0; i < numEvents; ++i) {
+      const double tof = buffer.tofs[i];
+      if (tof < tofMin || tof > tofMax)
+        continue;
+      const size_t bin = histogrammer.findBin(tofToD(tof));
+      if (bin >= numBins)
+        continue;
+      if (weighted) {
+        Y[bin] += buffer.weights[i];
+        E[bin] += buffer.errors[i] * buffer.errors[i];
+      } else {
+        Y[bin] += 1.;
+        E[bin] += 1.;
+      }
+    }
+  };
+
+  Progress progress(this, 0., 1., numHist);
+  const int numThreads = PARALLEL_GET_MAX_THREADS;
+  std::vector<FusedBuffers> buffers(numThreads);
+  if (numOutput >= static_cast<size_t>(numThreads)) {
+    // Enough output spectra for all threads: each one is filled directly by
+    // a single thread, from its only input spectrum when there is no grouping
+    std::vector<std::vector<int>> inputsOfOutput(numOutput);
+    for (int wi = 0; wi < numHist; ++wi) {
+      if (outputIndex[wi] >= 0)
+        inputsOfOutput[outputIndex[wi]].push_back(wi);
+    }
+
+    PARALLEL_FOR_IF(Kernel::threadSafe(inputWS, *outputWS))
+    for (int index = 0; index < static_cast<int>(numOutput); ++index) {
+      PARALLEL_START_INTERUPT_REGION
+      auto &buffer = buffers[PARALLEL_THREAD_NUMBER];
+      auto &Y = outputWS->mutableY(index);
+      auto &E = outputWS->mutableE(index);
+      for (const int wi : inputsOfOutput[index]) {
+        addEvents(wi, &Y[0], &E[0], buffer);
+        progress.report();
+      }
+      sqrtErrors(E);
+      PARALLEL_END_INTERUPT_REGION
+    }
+    PARALLEL_CHECK_INTERUPT_REGION
+    return outputWS;
+  }
+
+  // Fewer output spectra than threads: each thread fills partial histograms
+  // of all of them, using at most numThreads^2 histograms in total
+  const size_t histogramsSize = numOutput * numBins;
+  PARALLEL_FOR_IF(Kernel::threadSafe(inputWS))
+  for (int wi = 0; wi < numHist; ++wi) {
+    PARALLEL_START_INTERUPT_REGION
+    if (outputIndex[wi] >= 0) {
+      auto &buffer = buffers[PARALLEL_THREAD_NUMBER];
+      if (buffer.y.empty()) {
+        buffer.y.resize(histogramsSize, 0.);
+        buffer.e.resize(histogramsSize, 0.);
+      }
+      const auto offset = static_cast<size_t>(outputIndex[wi]) * numBins;
+      addEvents(wi, buffer.y.data() + offset, buffer.e.data() + offset,
+                buffer);
+    }
+    progress.report();
+    PARALLEL_END_INTERUPT_REGION
+  }
+  PARALLEL_CHECK_INTERUPT_REGION
+
+  // Sum the partial histograms of the threads into the output workspace
+  PARALLEL_FOR_IF(Kernel::threadSafe(*outputWS))
+  for (int index = 0; index < static_cast<int>(numOutput); ++index) {
+    auto &Y = outputWS->mutableY(index);
+    auto &E = outputWS->mutableE(index);
+    const auto offset = static_cast<size_t>(index) * numBins;
+    for (const auto &buffer : buffers) {
+      if (buffer.y.empty())
+        continue;
+      std::transform(Y.begin(), Y.end(), buffer.y.begin() + offset, Y.begin(),
+                     std::plus<double>());
+      std::transform(E.begin(), E.end(), buffer.e.begin() + offset, E.begin(),
+                     std::plus<double>());
+    }
+    sqrtErrors(E);
+  }
+  return outputWS;
+}
+
 //----------------------------------------------------------------------------------------------
 /** Call diffraction focus to a matrix workspace.
  */
@@ -10,6 +10,13 @@
 #include "MantidTestHelpers/WorkspaceCreationHelper.h"
 #include <cxxtest/TestSuite.h>
 
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <numeric>
+#include <sstream>
+
 #include "MantidAPI/Axis.h"
 #include "MantidAlgorithms/AddSampleLog.h"
 #include "MantidAlgorithms/AddTimeSeriesLog.h"
@@ -451,6 +458,81 @@ public:
     TS_ASSERT_EQUALS(m_outWS->y(0)[581], 197);
   }
 
+  void testEventWksp_fusedReduction_useGroupAll() {
+    setUp_EventWorkspace();
+    m_useGroupAll = true;
+    auto expected = runDspacingReduction(false);
+    auto fused = runDspacingReduction(true);
+    m_useGroupAll = false;
+
+    TS_ASSERT_EQUALS(fused->id(), "Workspace2D");
+    TS_ASSERT_EQUALS(fused->getAxis(0)->unit()->unitID(), "TOF");
+    TS_ASSERT_EQUALS(fused->getNumberHistograms(), 1);
+    TS_ASSERT_EQUALS(fused->blocksize(), expected->blocksize());
+    TS_ASSERT_EQUALS(fused->getSpectrum(0).getDetectorIDs(),
+                     expected->getSpectrum(0).getDetectorIDs());
+    // The bin edges of DiffractionFocussing can differ slightly
+    const auto &y = fused->y(0);
+    const auto &yExpected = expected->y(0);
+    const double total = std::accumulate(y.begin(), y.end(), 0.);
+    const double totalExpected =
+        std::accumulate(yExpected.begin(), yExpected.end(), 0.);
+    TS_ASSERT_LESS_THAN(0., total);
+    TS_ASSERT_DELTA(total, totalExpected, 0.01 * totalExpected);
+    // The input events are untouched
+    docheckEventInputWksp();
+  }
+
+  void testEventWksp_fusedReduction_noGrouping() {
+    setUp_EventWorkspace();
+    auto expected = runDspacingReduction(false);
+    auto fused = runDspacingReduction(true);
+
+    TS_ASSERT_EQUALS(fused->getAxis(0)->unit()->unitID(), "TOF");
+    TS_ASSERT_EQUALS(fused->getNumberHistograms(),
+                     expected->getNumberHistograms());
+    TS_ASSERT_EQUALS(fused->blocksize(), expected->blocksize());
+    // Same bin edges: the histograms match bin by bin
+    for (size_t i = 0; i < fused->getNumberHistograms(); ++i) {
+      TS_ASSERT_EQUALS(fused->getSpectrum(i).getSpectrumNo(),
+                       expected->getSpectrum(i).getSpectrumNo());
+      TS_ASSERT_EQUALS(fused->getSpectrum(i).getDetectorIDs(),
+                       expected->getSpectrum(i).getDetectorIDs());
+      TS_ASSERT_LESS_THAN(maxDifference(fused->x(i), expected->x(i)), 1e-6);
+      TS_ASSERT_LESS_THAN(maxDifference(fused->y(i), expected->y(i)), 1e-6);
+      TS_ASSERT_LESS_THAN(maxDifference(fused->e(i), expected->e(i)), 1e-6);
+    }
+  }
+
+  void testEventWksp_fusedReduction_fewGroups() {
+    // Fewer groups than threads: partial histograms per thread
+    doTestFusedReductionGrouped(3);
+  }
+
+  void testEventWksp_fusedReduction_manyGroups() {
+    // A group per thread or more: the groups are filled directly
+    doTestFusedReductionGrouped(72);
+  }
+
+  void testEventWksp_fusedReduction_fallsBackWithResampleX() {
+    setUp_EventWorkspace();
+    AlignAndFocusPowder align_and_focus;
+    align_and_focus.initialize();
+    align_and_focus.setPropertyValue("InputWorkspace", m_inputWS);
+    align_and_focus.setPropertyValue("OutputWorkspace", m_outputWS);
+    align_and_focus.setProperty("Dspacing", true);
+    align_and_focus.setProperty("ResampleX", 100);
+    align_and_focus.setProperty("FusedReduction", true);
+    TS_ASSERT_THROWS_NOTHING(align_and_focus.execute());
+    TS_ASSERT(align_and_focus.isExecuted());
+
+    m_outWS =
+        AnalysisDataService::Instance().retrieveWS<MatrixWorkspace>(m_outputWS);
+    // PreserveEvents is honoured by the usual child algorithms
+    TS_ASSERT_EQUALS(m_outWS->id(), "EventWorkspace");
+    TS_ASSERT_EQUALS(m_outWS->blocksize(), 100);
+  }
+
   /** Setup for testing HRPD NeXus data */
   void setUp_HRP38692() {
 
@@ -693,6 +775,103 @@ public:
   }
 
   /* Utility functions */
+  template <typename T>
+  double maxDifference(const T &values, const T &expected) {
+    TS_ASSERT_EQUALS(values.size(), expected.size());
+    double difference = 0.;
+    for (size_t i = 0; i < std::min(values.size(), expected.size()); ++i)
+      difference = std::max(difference, std::abs(values[i] - expected[i]));
+    return difference;
+  }
+
+  /** Check the fused reduction with a grouping of the bank bin by bin against
+   * the child algorithms, and against the sums of the fused histograms without
+   * grouping. The last bin edge is put on the logarithmic grid so that
+   * DiffractionFocussing, which spreads the bins evenly over the range, keeps
+   * the bin edges of Rebin.
+   */
+  void doTestFusedReductionGrouped(const int numGroups) {
+    std::ostringstream params;
+    params << std::setprecision(17) << "0.2,-0.002,"
+           << 0.2 * std::pow(1.002, 1611);
+    setUp_EventWorkspace();
+    auto ungrouped = runDspacingReduction(true, 0, params.str());
+    auto expected = runDspacingReduction(false, numGroups, params.str());
+    auto fused = runDspacingReduction(true, numGroups, params.str());
+    auto groupWS =
+        AnalysisDataService::Instance().retrieveWS<GroupingWorkspace>(
+            m_groupWS);
+
+    std::map<int, std::vector<double>> ySums;
+    std::map<int, std::vector<double>> e2Sums;
+    for (size_t i = 0; i < ungrouped->getNumberHistograms(); ++i) {
+      const auto &detIDs = ungrouped->getSpectrum(i).getDetectorIDs();
+      if (detIDs.empty())
+        continue;
+      const auto group = static_cast<int>(groupWS->getValue(*detIDs.begin()));
+      auto &ySum = ySums[group];
+      auto &e2Sum = e2Sums[group];
+      ySum.resize(ungrouped->blocksize(), 0.);
+      e2Sum.resize(ungrouped->blocksize(), 0.);
+      const auto &y = ungrouped->y(i);
+      const auto &e = ungrouped->e(i);
+      for (size_t bin = 0; bin < y.size(); ++bin) {
+        ySum[bin] += y[bin];
+        e2Sum[bin] += e[bin] * e[bin];
+      }
+    }
+
+    TS_ASSERT_EQUALS(fused->getNumberHistograms(), numGroups);
+    TS_ASSERT_EQUALS(fused->getNumberHistograms(),
+                     expected->getNumberHistograms());
+    TS_ASSERT_EQUALS(fused->blocksize(), ungrouped->blocksize());
+    for (size_t i = 0; i < fused->getNumberHistograms(); ++i) {
+      const auto group = fused->getSpectrum(i).getSpectrumNo();
+      TS_ASSERT_EQUALS(group, expected->getSpectrum(i).getSpectrumNo());
+      TS_ASSERT_EQUALS(fused->getSpectrum(i).getDetectorIDs(),
+                       expected->getSpectrum(i).getDetectorIDs());
+      if (ySums.count(group) == 0) {
+        TS_FAIL("No ungrouped spectra found for a group");
+        continue;
+      }
+      const auto &y = fused->y(i);
+      TS_ASSERT_LESS_THAN(0., std::accumulate(y.begin(), y.end(), 0.));
+      TS_ASSERT_LESS_THAN(maxDifference(y.rawData(), ySums.at(group)), 1e-6);
+      auto e2 = fused->e(i).rawData();
+      for (auto &value : e2)
+        value *= value;
+      TS_ASSERT_LESS_THAN(maxDifference(e2, e2Sums.at(group)), 1e-6);
+
+      TS_ASSERT_LESS_THAN(maxDifference(fused->x(i), expected->x(i)), 1e-6);
+      TS_ASSERT_LESS_THAN(maxDifference(fused->y(i), expected->y(i)), 1e-6);
+      TS_ASSERT_LESS_THAN(maxDifference(fused->e(i), expected->e(i)), 1e-6);
+    }
+  }
+
+  MatrixWorkspace_sptr
+  runDspacingReduction(bool fused, int numGroups = 0,
+                       const std::string &params = "0.2,-0.002,5.") {
+    AlignAndFocusPowder align_and_focus;
+    align_and_focus.initialize();
+    align_and_focus.setPropertyValue("InputWorkspace", m_inputWS);
+    align_and_focus.setPropertyValue("OutputWorkspace", m_outputWS);
+    align_and_focus.setProperty("Dspacing", true);
+    align_and_focus.setPropertyValue("Params", params);
+    align_and_focus.setProperty("PreserveEvents", false);
+    align_and_focus.setProperty("FusedReduction", fused);
+    if (m_useGroupAll) {
+      groupAllBanks(m_inputWS);
+      align_and_focus.setPropertyValue("GroupingWorkspace", m_groupWS);
+    } else if (numGroups > 0) {
+      groupBank(m_inputWS, numGroups);
+      align_and_focus.setPropertyValue("GroupingWorkspace", m_groupWS);
+    }
+    TS_ASSERT_THROWS_NOTHING(align_and_focus.execute());
+    TS_ASSERT(align_and_focus.isExecuted());
+    return AnalysisDataService::Instance().retrieveWS<MatrixWorkspace>(
+        m_outputWS);
+  }
+
   void loadDiffCal(std::string calfilename, bool group, bool cal, bool mask) {
     LoadDiffCal loadDiffAlg;
     loadDiffAlg.initialize();
@@ -714,6 +893,16 @@ public:
     groupAlg.execute();
   }
 
+  void groupBank(std::string m_inputWS, int numGroups) {
+    CreateGroupingWorkspace groupAlg;
+    groupAlg.initialize();
+    groupAlg.setPropertyValue("InputWorkspace", m_inputWS);
+    groupAlg.setPropertyValue("ComponentName", "bank1");
+    groupAlg.setProperty("FixedGroupCount", numGroups);
+    groupAlg.setPropertyValue("OutputWorkspace", m_groupWS);
+    groupAlg.execute();
+  }
+
   void rebin(std::string params, bool preserveEvents = true) {
     Rebin rebin;
     rebin.initialize();